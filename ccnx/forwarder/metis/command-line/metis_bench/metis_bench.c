@@ -0,0 +1,747 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @header Metis Bench
+ * @abstract Microbenchmarks for the forwarding tables and TLV parsing
+ * @discussion
+ *     Times the per-packet operations of the forwarder outside of any I/O: TLV skeleton parsing,
+ *     FIB longest-prefix match, PIT insert/aggregate/satisfy, and LRU content store put/match/evict.
+ *     Each benchmark prints nanoseconds per operation and parcMemory allocations per operation.
+ *     The cs_hits benchmarks also print the hit ratio of each content store policy on the same
+ *     mix of popular and one-time names.
+ *
+ *     Synthetic packets are made from the V1 templates in metis_TestDataV1.h by replacing the name
+ *     with lci:/bench/<prefix>/<suffix>.  Random choices use a fixed seed, so two runs with the same
+ *     arguments do the same operations.
+ *
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_StdlibMemory.h>
+#include <parc/logging/parc_LogReporterTextStdout.h>
+
+#include <ccnx/api/control/cpi_RouteEntry.h>
+#include <ccnx/common/ccnx_Name.h>
+
+#include <ccnx/forwarder/metis/core/metis_Forwarder.h>
+#include <ccnx/forwarder/metis/core/metis_Message.h>
+#include <ccnx/forwarder/metis/core/metis_NumberSet.h>
+#include <ccnx/forwarder/metis/core/metis_Slab.h>
+#include <ccnx/forwarder/metis/tlv/metis_TlvSkeleton.h>
+#include <ccnx/forwarder/metis/tlv/metis_TlvHash.h>
+#include <ccnx/forwarder/metis/processor/metis_FIB.h>
+#include <ccnx/forwarder/metis/processor/metis_HashFIB.h>
+#include <ccnx/forwarder/metis/processor/metis_TrieFIB.h>
+#include <ccnx/forwarder/metis/processor/metis_PIT.h>
+#include <ccnx/forwarder/metis/processor/metis_StandardPIT.h>
+#include <ccnx/forwarder/metis/content_store/metis_LRUContentStore.h>
+#include <ccnx/forwarder/metis/content_store/metis_TinyLFUContentStore.h>
+
+#include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
+#include <ccnx/forwarder/metis/testdata/metis_TestDataV1.h>
+
+// default number of operations per benchmark
+#define METIS_BENCH_ITERATIONS 100000
+
+// number of distinct interests looked up in the FIB benchmarks
+#define METIS_BENCH_LOOKUP_POOL 4096
+
+// capacity of the content store in the eviction benchmark
+#define METIS_BENCH_EVICT_CAPACITY 1024
+
+#define METIS_BENCH_MAX_PACKET 1500
+
+typedef struct metis_bench {
+    const char *filter;
+    size_t iterations;
+    size_t maxRoutes;
+    MetisLogger *logger;
+
+    // state of the lcg, see _benchRandom()
+    uint64_t random;
+
+    // the timed section, see _benchStart() and _benchStop()
+    uint64_t startNanos;
+    uint64_t startAllocations;
+} MetisBench;
+
+// ==========================================================================
+// Allocation counting
+//
+// parcMemory is pointed at these wrappers around the stdlib allocator so each
+// benchmark can report how many allocations one operation makes.
+
+static uint64_t _allocationCount = 0;
+
+static void *
+_countingAllocate(size_t size)
+{
+    _allocationCount++;
+    return parcStdlibMemory_Allocate(size);
+}
+
+static void *
+_countingAllocateAndClear(size_t size)
+{
+    _allocationCount++;
+    return parcStdlibMemory_AllocateAndClear(size);
+}
+
+static int
+_countingMemAlign(void **pointer, size_t alignment, size_t size)
+{
+    _allocationCount++;
+    return parcStdlibMemory_MemAlign(pointer, alignment, size);
+}
+
+static void *
+_countingReallocate(void *pointer, size_t newSize)
+{
+    _allocationCount++;
+    return parcStdlibMemory_Reallocate(pointer, newSize);
+}
+
+static char *
+_countingStringDuplicate(const char *string, size_t length)
+{
+    _allocationCount++;
+    return parcStdlibMemory_StringDuplicate(string, length);
+}
+
+static PARCMemoryInterface _countingMemory = {
+    .Allocate         = (uintptr_t) _countingAllocate,
+    .AllocateAndClear = (uintptr_t) _countingAllocateAndClear,
+    .MemAlign         = (uintptr_t) _countingMemAlign,
+    .Deallocate       = (uintptr_t) parcStdlibMemory_Deallocate,
+    .Reallocate       = (uintptr_t) _countingReallocate,
+    .StringDuplicate  = (uintptr_t) _countingStringDuplicate,
+    .Outstanding      = (uintptr_t) parcStdlibMemory_Outstanding
+};
+
+// ==========================================================================
+// Timing and reporting
+
+static uint64_t
+_nowNanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static bool
+_benchSelected(const MetisBench *bench, const char *name)
+{
+    return bench->filter == NULL || strstr(name, bench->filter) != NULL;
+}
+
+static void
+_benchStart(MetisBench *bench)
+{
+    bench->startAllocations = _allocationCount;
+    bench->startNanos = _nowNanos();
+}
+
+static void
+_benchStop(MetisBench *bench, const char *name, size_t ops)
+{
+    uint64_t elapsed = _nowNanos() - bench->startNanos;
+    uint64_t allocations = _allocationCount - bench->startAllocations;
+
+    printf("%-28s %10zu ops %12.1f ns/op %10.2f allocs/op\n",
+           name, ops,
+           ops > 0 ? (double) elapsed / (double) ops : 0.0,
+           ops > 0 ? (double) allocations / (double) ops : 0.0);
+    fflush(stdout);
+}
+
+/**
+ * A 64-bit LCG (Knuth MMIX constants), so the sequence is the same on every platform
+ */
+static uint32_t
+_benchRandom(MetisBench *bench)
+{
+    bench->random = bench->random * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (uint32_t) (bench->random >> 33);
+}
+
+// ==========================================================================
+// Synthetic packets
+
+static size_t
+_appendSegment(uint8_t *buffer, size_t offset, const char *value)
+{
+    size_t length = strlen(value);
+    buffer[offset++] = 0x00;
+    buffer[offset++] = 0x01;    // T_NAMESEGMENT
+    buffer[offset++] = (uint8_t) (length >> 8);
+    buffer[offset++] = (uint8_t) length;
+    memcpy(buffer + offset, value, length);
+    return offset + length;
+}
+
+/**
+ * Build a V1 packet from a template with its name replaced by lci:/bench/<prefix>/<suffix>
+ *
+ * The template must be a V1 Interest or ContentObject whose message body starts with the name,
+ * as the ones in metis_TestDataV1.h do.  The fixed header, the rest of the message body, and the
+ * validation TLVs are copied as is.  Metis does not check the CRC, so it is not recomputed.
+ */
+static MetisMessage *
+_benchMessage_Create(MetisBench *bench, const uint8_t *template, size_t templateLength, unsigned prefix, unsigned suffix, unsigned ingressId)
+{
+    uint8_t packet[METIS_BENCH_MAX_PACKET];
+
+    size_t headerLength = template[7];
+    size_t bodyLength = ((size_t) template[headerLength + 2] << 8) | template[headerLength + 3];
+    const uint8_t *oldName = template + headerLength + 4;
+    size_t oldNameLength = ((size_t) oldName[2] << 8) | oldName[3];
+    const uint8_t *rest = oldName + 4 + oldNameLength;
+    size_t restLength = bodyLength - 4 - oldNameLength;
+    const uint8_t *tail = template + headerLength + 4 + bodyLength;
+    size_t tailLength = templateLength - (headerLength + 4 + bodyLength);
+
+    char prefixString[16];
+    char suffixString[16];
+    snprintf(prefixString, sizeof(prefixString), "%u", prefix);
+    snprintf(suffixString, sizeof(suffixString), "%u", suffix);
+
+    // name value first, then go back and fill in the TLV headers
+    size_t nameOffset = headerLength + 8;
+    size_t offset = nameOffset;
+    offset = _appendSegment(packet, offset, "bench");
+    offset = _appendSegment(packet, offset, prefixString);
+    offset = _appendSegment(packet, offset, suffixString);
+    size_t nameLength = offset - nameOffset;
+
+    memcpy(packet + offset, rest, restLength);
+    offset += restLength;
+    memcpy(packet + offset, tail, tailLength);
+    offset += tailLength;
+
+    size_t newBodyLength = 4 + nameLength + restLength;
+
+    memcpy(packet, template, headerLength);
+    packet[2] = (uint8_t) (offset >> 8);
+    packet[3] = (uint8_t) offset;
+
+    packet[headerLength + 0] = template[headerLength + 0];
+    packet[headerLength + 1] = template[headerLength + 1];
+    packet[headerLength + 2] = (uint8_t) (newBodyLength >> 8);
+    packet[headerLength + 3] = (uint8_t) newBodyLength;
+
+    packet[headerLength + 4] = oldName[0];
+    packet[headerLength + 5] = oldName[1];
+    packet[headerLength + 6] = (uint8_t) (nameLength >> 8);
+    packet[headerLength + 7] = (uint8_t) nameLength;
+
+    return metisMessage_CreateFromArray(packet, offset, ingressId, 0, bench->logger);
+}
+
+static MetisMessage *
+_benchInterest_Create(MetisBench *bench, unsigned prefix, unsigned suffix, unsigned ingressId)
+{
+    return _benchMessage_Create(bench, metisTestDataV1_Interest_NameA_Crc32c, sizeof(metisTestDataV1_Interest_NameA_Crc32c), prefix, suffix, ingressId);
+}
+
+static MetisMessage *
+_benchContentObject_Create(MetisBench *bench, unsigned prefix, unsigned suffix, unsigned ingressId)
+{
+    return _benchMessage_Create(bench, metisTestDataV1_ContentObject_NameA_Crc32c, sizeof(metisTestDataV1_ContentObject_NameA_Crc32c), prefix, suffix, ingressId);
+}
+
+static MetisMessage **
+_benchPool_Create(MetisBench *bench, size_t count, bool interests, unsigned ingressId)
+{
+    MetisMessage **pool = parcMemory_Allocate(count * sizeof(MetisMessage *));
+    for (size_t i = 0; i < count; i++) {
+        if (interests) {
+            pool[i] = _benchInterest_Create(bench, (unsigned) (i / 1000), (unsigned) i, ingressId);
+        } else {
+            pool[i] = _benchContentObject_Create(bench, (unsigned) (i / 1000), (unsigned) i, ingressId);
+        }
+    }
+    return pool;
+}
+
+static void
+_benchPool_Destroy(MetisMessage ***poolPtr, size_t count)
+{
+    MetisMessage **pool = *poolPtr;
+    for (size_t i = 0; i < count; i++) {
+        metisMessage_Release(&pool[i]);
+    }
+    parcMemory_Deallocate((void **) poolPtr);
+}
+
+// ==========================================================================
+// TLV
+
+static void
+_benchTlvParse(MetisBench *bench, const char *name, uint8_t *packet)
+{
+    if (!_benchSelected(bench, name)) {
+        return;
+    }
+
+    MetisTlvSkeleton skeleton;
+    size_t parsed = 0;
+
+    _benchStart(bench);
+    for (size_t i = 0; i < bench->iterations; i++) {
+        if (metisTlvSkeleton_Parse(&skeleton, packet, bench->logger)) {
+            parsed++;
+        }
+    }
+    _benchStop(bench, name, bench->iterations);
+
+    if (parsed != bench->iterations) {
+        fprintf(stderr, "%s: only parsed %zu of %zu packets\n", name, parsed, bench->iterations);
+    }
+}
+
+/**
+ * The ContentObjectHash of a V1 object, batchSize objects per call (1 uses the single hash API)
+ */
+static void
+_benchTlvHash(MetisBench *bench, const char *name, size_t batchSize)
+{
+    if (!_benchSelected(bench, name)) {
+        return;
+    }
+
+    MetisTlvSkeleton skeleton;
+    metisTlvSkeleton_Parse(&skeleton, metisTestDataV1_ContentObject_NameA_KeyId1_RsaSha256, bench->logger);
+
+    const MetisTlvSkeleton *skeletons[METIS_TLV_HASH_BATCH_WIDTH];
+    PARCCryptoHash *hashes[METIS_TLV_HASH_BATCH_WIDTH];
+    for (size_t i = 0; i < batchSize; i++) {
+        skeletons[i] = &skeleton;
+    }
+
+    size_t ops = bench->iterations - (bench->iterations % batchSize);
+
+    _benchStart(bench);
+    for (size_t i = 0; i < ops; i += batchSize) {
+        if (batchSize == 1) {
+            hashes[0] = metisTlvSkeleton_ComputeContentObjectHash(&skeleton);
+        } else {
+            metisTlvSkeleton_ComputeContentObjectHashBatch(batchSize, skeletons, hashes);
+        }
+        for (size_t j = 0; j < batchSize; j++) {
+            parcCryptoHash_Release(&hashes[j]);
+        }
+    }
+    _benchStop(bench, name, ops);
+}
+
+static void
+_benchTlv(MetisBench *bench)
+{
+    _benchTlvParse(bench, "tlv_parse_v0_interest", metisTestDataV0_InterestWithName);
+    _benchTlvParse(bench, "tlv_parse_v0_object", metisTestDataV0_EncodedObject);
+    _benchTlvParse(bench, "tlv_parse_v1_interest", metisTestDataV1_Interest_AllFields);
+    _benchTlvParse(bench, "tlv_parse_v1_object", metisTestDataV1_ContentObject_NameA_KeyId1_RsaSha256);
+
+    if (_benchSelected(bench, "tlv_hash_v1_object") || _benchSelected(bench, "tlv_hash_v1_object_batch")) {
+        printf("tlv_hash backend: %s\n", metisTlvHash_BackendName(metisTlvHash_GetBackend()));
+    }
+    _benchTlvHash(bench, "tlv_hash_v1_object", 1);
+    _benchTlvHash(bench, "tlv_hash_v1_object_batch", METIS_TLV_HASH_BATCH_WIDTH);
+}
+
+// ==========================================================================
+// FIB
+
+static void
+_benchFibAddRoutes(MetisFIB *fib, size_t routeCount)
+{
+    char uri[64];
+    for (size_t i = 0; i < routeCount; i++) {
+        snprintf(uri, sizeof(uri), "lci:/bench/%zu", i);
+        CCNxName *prefix = ccnxName_CreateFromCString(uri);
+        CPIRouteEntry *route = cpiRouteEntry_Create(prefix, (unsigned) (i % 16) + 1, NULL,
+                                                    cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, NULL, 1);
+        metisFIB_AddOrUpdate(fib, route);
+        cpiRouteEntry_Destroy(&route);
+    }
+}
+
+static void
+_benchFibMatch(MetisBench *bench, const char *type, size_t routeCount)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "fib_match_%s_%zu", type, routeCount);
+    if (!_benchSelected(bench, name) || routeCount > bench->maxRoutes) {
+        return;
+    }
+
+    MetisFIB *fib = (strcmp(type, "trie") == 0) ? metisTrieFIB_Create(bench->logger) : metisHashFIB_Create(bench->logger);
+    _benchFibAddRoutes(fib, routeCount);
+
+    // interests one segment longer than the routes, for routes spread over the whole table
+    MetisMessage *pool[METIS_BENCH_LOOKUP_POOL];
+    for (size_t i = 0; i < METIS_BENCH_LOOKUP_POOL; i++) {
+        unsigned route = _benchRandom(bench) % (unsigned) routeCount;
+        pool[i] = _benchInterest_Create(bench, route, (unsigned) i, 1);
+    }
+
+    size_t matched = 0;
+    _benchStart(bench);
+    for (size_t i = 0; i < bench->iterations; i++) {
+        if (metisFIB_Match(fib, pool[i % METIS_BENCH_LOOKUP_POOL]) != NULL) {
+            matched++;
+        }
+    }
+    _benchStop(bench, name, bench->iterations);
+
+    if (matched != bench->iterations) {
+        fprintf(stderr, "%s: only matched %zu of %zu interests\n", name, matched, bench->iterations);
+    }
+
+    for (size_t i = 0; i < METIS_BENCH_LOOKUP_POOL; i++) {
+        metisMessage_Release(&pool[i]);
+    }
+    metisFIB_Destroy(&fib);
+}
+
+static void
+_benchFib(MetisBench *bench)
+{
+    const size_t routeCounts[] = { 1000, 100000, 1000000 };
+    const char *types[] = { "hash", "trie" };
+
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        for (size_t r = 0; r < sizeof(routeCounts) / sizeof(routeCounts[0]); r++) {
+            _benchFibMatch(bench, types[t], routeCounts[r]);
+        }
+    }
+}
+
+// ==========================================================================
+// PIT
+
+static void
+_benchPit(MetisBench *bench)
+{
+    if (!_benchSelected(bench, "pit_insert") && !_benchSelected(bench, "pit_aggregate") && !_benchSelected(bench, "pit_satisfy")) {
+        return;
+    }
+
+    size_t count = bench->iterations;
+    MetisForwarder *metis = metisForwarder_Create(bench->logger);
+    MetisPIT *pit = metisStandardPIT_Create(metis);
+
+    MetisMessage **interests = _benchPool_Create(bench, count, true, 1);
+    MetisMessage **aggregates = _benchPool_Create(bench, count, true, 2);
+    MetisMessage **objects = _benchPool_Create(bench, count, false, 3);
+
+    // every later step needs the entries, so insert always runs but only reports if selected
+    _benchStart(bench);
+    for (size_t i = 0; i < count; i++) {
+        metisPIT_ReceiveInterest(pit, interests[i]);
+    }
+    if (_benchSelected(bench, "pit_insert")) {
+        _benchStop(bench, "pit_insert", count);
+    }
+
+    if (_benchSelected(bench, "pit_aggregate")) {
+        _benchStart(bench);
+        for (size_t i = 0; i < count; i++) {
+            metisPIT_ReceiveInterest(pit, aggregates[i]);
+        }
+        _benchStop(bench, "pit_aggregate", count);
+    }
+
+    if (_benchSelected(bench, "pit_satisfy")) {
+        size_t satisfied = 0;
+        _benchStart(bench);
+        for (size_t i = 0; i < count; i++) {
+            MetisNumberSet ingressSet;
+            metisNumberSet_Initialize(&ingressSet);
+            metisPIT_SatisfyInterest(pit, objects[i], &ingressSet);
+            satisfied += (metisNumberSet_Length(&ingressSet) > 0) ? 1 : 0;
+            metisNumberSet_Finalize(&ingressSet);
+        }
+        _benchStop(bench, "pit_satisfy", count);
+
+        if (satisfied != count) {
+            fprintf(stderr, "pit_satisfy: only satisfied %zu of %zu interests\n", satisfied, count);
+        }
+    }
+
+    metisPIT_Release(&pit);
+    _benchPool_Destroy(&objects, count);
+    _benchPool_Destroy(&aggregates, count);
+    _benchPool_Destroy(&interests, count);
+    metisForwarder_Destroy(&metis);
+}
+
+// ==========================================================================
+// Content store
+
+static void
+_benchContentStore(MetisBench *bench)
+{
+    if (!_benchSelected(bench, "cs_put") && !_benchSelected(bench, "cs_match") && !_benchSelected(bench, "cs_evict")) {
+        return;
+    }
+
+    size_t count = bench->iterations;
+    MetisMessage **objects = _benchPool_Create(bench, count, false, 1);
+    MetisMessage **interests = _benchPool_Create(bench, count, true, 2);
+
+    MetisContentStoreConfig config = {
+        .objectCapacity = count,
+    };
+    MetisContentStoreInterface *store = metisLRUContentStore_Create(&config, bench->logger);
+
+    // match needs the objects, so put always runs but only reports if selected
+    _benchStart(bench);
+    for (size_t i = 0; i < count; i++) {
+        metisContentStoreInterface_PutContent(store, objects[i], 0);
+    }
+    if (_benchSelected(bench, "cs_put")) {
+        _benchStop(bench, "cs_put", count);
+    }
+
+    if (_benchSelected(bench, "cs_match")) {
+        size_t matched = 0;
+        _benchStart(bench);
+        for (size_t i = 0; i < count; i++) {
+            if (metisContentStoreInterface_MatchInterest(store, interests[i]) != NULL) {
+                matched++;
+            }
+        }
+        _benchStop(bench, "cs_match", count);
+
+        if (matched != count) {
+            fprintf(stderr, "cs_match: only matched %zu of %zu interests\n", matched, count);
+        }
+    }
+    metisContentStoreInterface_Release(&store);
+
+    if (_benchSelected(bench, "cs_evict")) {
+        // a small store, so after it fills every put evicts the least recently used object
+        config.objectCapacity = METIS_BENCH_EVICT_CAPACITY;
+        store = metisLRUContentStore_Create(&config, bench->logger);
+
+        for (size_t i = 0; i < METIS_BENCH_EVICT_CAPACITY && i < count; i++) {
+            metisContentStoreInterface_PutContent(store, objects[i], 0);
+        }
+
+        size_t evictions = 0;
+        _benchStart(bench);
+        for (size_t i = METIS_BENCH_EVICT_CAPACITY; i < count; i++) {
+            metisContentStoreInterface_PutContent(store, objects[i], 0);
+            evictions++;
+        }
+        _benchStop(bench, "cs_evict", evictions);
+
+        metisContentStoreInterface_Release(&store);
+    }
+
+    _benchPool_Destroy(&interests, count);
+    _benchPool_Destroy(&objects, count);
+}
+
+/**
+ * Replays a trace where half the interests ask for one of a popular set of names and half ask for
+ * a name never seen before.  As a forwarder would, a miss stores the object.  The popular set is
+ * half the store, so a policy that keeps it wins about half the lookups.
+ */
+static void
+_benchContentStoreHits(MetisBench *bench, const char *name, MetisContentStoreInterface *(*create)(MetisContentStoreConfig *config, MetisLogger *logger))
+{
+    if (!_benchSelected(bench, name)) {
+        return;
+    }
+
+    size_t count = bench->iterations;
+    MetisMessage **objects = _benchPool_Create(bench, count, false, 1);
+    MetisMessage **interests = _benchPool_Create(bench, count, true, 2);
+
+    MetisContentStoreConfig config = {
+        .objectCapacity = METIS_BENCH_EVICT_CAPACITY,
+    };
+    MetisContentStoreInterface *store = create(&config, bench->logger);
+
+    const size_t popular = METIS_BENCH_EVICT_CAPACITY / 2;
+    size_t nextOneTime = popular;
+    size_t hits = 0;
+
+    // the same seed for every policy, so they all see the same trace
+    bench->random = 1;
+
+    _benchStart(bench);
+    for (size_t op = 0; op < count; op++) {
+        size_t i;
+        if (_benchRandom(bench) % 2 == 0) {
+            i = _benchRandom(bench) % popular;
+        } else {
+            i = nextOneTime;
+            nextOneTime = (nextOneTime + 1 < count) ? nextOneTime + 1 : popular;
+        }
+
+        if (metisContentStoreInterface_MatchInterest(store, interests[i]) != NULL) {
+            hits++;
+        } else {
+            metisContentStoreInterface_PutContent(store, objects[i], 0);
+        }
+    }
+    _benchStop(bench, name, count);
+
+    printf("%-28s %10.4f hit ratio\n", name, (double) hits / (double) count);
+    fflush(stdout);
+
+    metisContentStoreInterface_Release(&store);
+    _benchPool_Destroy(&interests, count);
+    _benchPool_Destroy(&objects, count);
+}
+
+// ==========================================================================
+
+static void
+_usage(int exitCode)
+{
+    printf("Usage: metis_bench [--iterations count] [--max-routes count] [--no-slab] [filter]\n");
+    printf("\n");
+    printf("Runs microbenchmarks of the Metis forwarding tables and TLV parsing and prints ns/op and\n");
+    printf("allocations/op for each.  Runs are reproducible: the synthetic names use a fixed seed.\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("--iterations = operations per benchmark (default %d)\n", METIS_BENCH_ITERATIONS);
+    printf("--max-routes = skip FIB benchmarks with more routes than this (default 1000000)\n");
+    printf("--no-slab    = do not use the per-thread slab caches that metis_daemon uses\n");
+    printf("filter       = only run benchmarks whose name contains this string, e.g. fib_match_trie\n");
+    printf("\n");
+    printf("Benchmarks: tlv_parse_{v0,v1}_{interest,object}, tlv_hash_v1_object[_batch],\n");
+    printf("            fib_match_{hash,trie}_{1000,100000,1000000},\n");
+    printf("            pit_{insert,aggregate,satisfy}, cs_{put,match,evict}, cs_hits_{lru,tinylfu}\n");
+    exit(exitCode);
+}
+
+int
+main(int argc, const char *argv[])
+{
+    MetisBench bench = {
+        .filter     = NULL,
+        .iterations = METIS_BENCH_ITERATIONS,
+        .maxRoutes  = 1000000,
+        .random     = 1,
+    };
+    bool slab = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            _usage(EXIT_SUCCESS);
+        } else if (strcmp(argv[i], "--iterations") == 0) {
+            long long iterations = (i + 1 < argc) ? atoll(argv[i + 1]) : 0;
+            if (iterations < METIS_BENCH_EVICT_CAPACITY) {
+                fprintf(stderr, "Invalid iteration count, must be at least %d\n", METIS_BENCH_EVICT_CAPACITY);
+                _usage(EXIT_FAILURE);
+            }
+            bench.iterations = (size_t) iterations;
+            i++;
+        } else if (strcmp(argv[i], "--max-routes") == 0) {
+            long long maxRoutes = (i + 1 < argc) ? atoll(argv[i + 1]) : -1;
+            if (maxRoutes < 0) {
+                fprintf(stderr, "Invalid route count\n");
+                _usage(EXIT_FAILURE);
+            }
+            bench.maxRoutes = (size_t) maxRoutes;
+            i++;
+        } else if (strcmp(argv[i], "--no-slab") == 0) {
+            slab = false;
+        } else if (argv[i][0] == '-') {
+            _usage(EXIT_FAILURE);
+        } else {
+            bench.filter = argv[i];
+        }
+    }
+
+    parcMemory_SetInterface(&_countingMemory);
+    metisSlab_SetEnabled(slab);
+
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    PARCClock *clock = parcClock_Monotonic();
+    bench.logger = metisLogger_Create(reporter, clock);
+    parcClock_Release(&clock);
+    parcLogReporter_Release(&reporter);
+
+    _benchTlv(&bench);
+    _benchFib(&bench);
+    _benchPit(&bench);
+    _benchContentStore(&bench);
+    _benchContentStoreHits(&bench, "cs_hits_lru", metisLRUContentStore_Create);
+    _benchContentStoreHits(&bench, "cs_hits_tinylfu", metisTinyLFUContentStore_Create);
+
+    metisLogger_Release(&bench.logger);
+    metisSlab_Drain();
+
+    return EXIT_SUCCESS;
+}
@@ -69,6 +69,7 @@
 #include <stdlib.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <limits.h>
 #include <sys/stat.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -82,6 +83,8 @@
 
 #include <ccnx/forwarder/metis/core/metis_Forwarder.h>
 #include <ccnx/forwarder/metis/core/metis_Dispatcher.h>
+#include <ccnx/forwarder/metis/core/metis_Slab.h>
+#include <ccnx/forwarder/metis/core/metis_Latency.h>
 #include <ccnx/forwarder/metis/metis_About.h>
 
 static void
@@ -101,7 +104,7 @@ header(void)
 static void
 _usage(int exitCode)
 {
-    printf("Usage: metis_daemon [--port port] [--daemon] [--capacity objectStoreSize] [--log facility=level] [--log-file filename] [--config file]\n");
+    printf("Usage: metis_daemon [--port port] [--daemon] [--capacity objectStoreSize] [--capacity-bytes bytes[K|M|G]] [--disk-cache directory] [--disk-cache-bytes bytes[K|M|G]] [--fib hash|trie] [--cache-policy lru|tinylfu] [--workers count] [--udp-sockets count] [--latency-sample n] [--log facility=level] [--log-file filename] [--config file]\n");
     printf("\n");
     printf("Metis is the CCNx 1.0 forwarder, which runs on each end system and as a software forwarder\n");
     printf("on intermediate systems.  metis_daemon is the program to launch Metis, either as a console program\n");
@@ -120,6 +123,21 @@ _usage(int exitCode)
     printf("--port            = tcp port for in-bound connections\n");
     printf("--daemon          = start as daemon process\n");
     printf("--objectStoreSize = maximum number of content objects to cache\n");
+    printf("--capacity-bytes  = maximum bytes of content objects to cache, with optional K, M, or G suffix.\n");
+    printf("                    Applies in addition to the object count limit.  0 means no byte limit.\n");
+    printf("--disk-cache      = directory for a persistent content store behind the in-memory one.  Objects evicted\n");
+    printf("                    from memory are kept there, and are still there after a restart.\n");
+    printf("--disk-cache-bytes = size of the disk cache, with optional K, M, or G suffix (default 1G)\n");
+    printf("--fib             = FIB implementation: hash (default) or trie\n");
+    printf("--cache-policy    = content store policy: lru (default) caches every object, tinylfu only caches an\n");
+    printf("                    object once it is asked for more often than the object it would evict.\n");
+    printf("                    Compare them with contentStore.hitRatio in 'metis_control stats'.\n");
+    printf("--workers         = number of threads that process packets (default 1).  Each worker owns a share of\n");
+    printf("                    the PIT and content store, and packets are steered to a worker by name.\n");
+    printf("--udp-sockets     = number of SO_REUSEPORT sockets per UDP listener (default 1).  The kernel spreads\n");
+    printf("                    peers across them and each extra socket is read by its own thread.\n");
+    printf("--latency-sample  = time one in every n forwarding stages (parse, pit, contentStore, fib, send) in to\n");
+    printf("                    latency histograms (default 0, off).  See 'metis_control latency' or send SIGUSR1.\n");
     printf("--log             = sets a facility to a given log level.  You can have multiple of these.\n");
     printf("                    facilities: all, config, core, io, message, processor\n");
     printf("                    levels: debug, info, notice, warning, error, critical, alert, off\n");
@@ -130,6 +148,60 @@ _usage(int exitCode)
     exit(exitCode);
 }
 
+/**
+ * Parses a byte count with an optional K, M, or G (binary) suffix
+ *
+ * @return -1 on a parse error
+ */
+static long long
+_parseByteCount(const char *string)
+{
+    if (string == NULL) {
+        return -1;
+    }
+
+    char *end = NULL;
+    errno = 0;
+    long long value = strtoll(string, &end, 10);
+    if (end == string || errno == ERANGE || value < 0) {
+        return -1;
+    }
+
+    unsigned shift = 0;
+    switch (*end) {
+        case '\0':
+            break;
+        case 'k':
+        case 'K':
+            shift = 10;
+            end++;
+            break;
+        case 'm':
+        case 'M':
+            shift = 20;
+            end++;
+            break;
+        case 'g':
+        case 'G':
+            shift = 30;
+            end++;
+            break;
+        default:
+            return -1;
+    }
+
+    // Shifting a larger value would overflow
+    if (value > (LLONG_MAX >> shift)) {
+        return -1;
+    }
+    value <<= shift;
+
+    if (*end != '\0') {
+        return -1;
+    }
+    return value;
+}
+
 static void
 _setLogLevelToLevel(int logLevelArray[MetisLoggerFacility_END], MetisLoggerFacility facility, const char *levelString)
 {
@@ -258,6 +330,14 @@ main(int argc, const char *argv[])
     uint16_t configurationPort = 2001;
     bool daemon = false;
     int capacity = -1;
+    long long capacityBytes = -1;
+    const char *diskCacheDirectory = NULL;
+    long long diskCacheBytes = 0;
+    MetisFIBType fibType = MetisFIBType_Hash;
+    MetisContentStoreType contentStoreType = MetisContentStoreType_LRU;
+    int workers = 1;
+    int udpSockets = 1;
+    int latencySample = 0;
     const char *configFileName = NULL;
 
     char *logfile = NULL;
@@ -284,6 +364,64 @@ main(int argc, const char *argv[])
             } else if (strcmp(argv[i], "--capacity") == 0 || strcmp(argv[i], "-c") == 0) {
                 capacity = atoi(argv[i + 1]);
                 i++;
+            } else if (strcmp(argv[i], "--capacity-bytes") == 0) {
+                capacityBytes = _parseByteCount(argv[i + 1]);
+                if (capacityBytes < 0) {
+                    fprintf(stderr, "Invalid byte capacity, must be a number with optional K, M, or G suffix\n");
+                    _usage(EXIT_FAILURE);
+                }
+                i++;
+            } else if (strcmp(argv[i], "--disk-cache") == 0) {
+                diskCacheDirectory = argv[i + 1];
+                i++;
+            } else if (strcmp(argv[i], "--disk-cache-bytes") == 0) {
+                diskCacheBytes = _parseByteCount(argv[i + 1]);
+                if (diskCacheBytes < 0) {
+                    fprintf(stderr, "Invalid disk cache size, must be a number with optional K, M, or G suffix\n");
+                    _usage(EXIT_FAILURE);
+                }
+                i++;
+            } else if (strcmp(argv[i], "--fib") == 0) {
+                if (argv[i + 1] != NULL && strcasecmp(argv[i + 1], "hash") == 0) {
+                    fibType = MetisFIBType_Hash;
+                } else if (argv[i + 1] != NULL && strcasecmp(argv[i + 1], "trie") == 0) {
+                    fibType = MetisFIBType_Trie;
+                } else {
+                    fprintf(stderr, "Unknown FIB type, must be hash or trie\n");
+                    _usage(EXIT_FAILURE);
+                }
+                i++;
+            } else if (strcmp(argv[i], "--cache-policy") == 0) {
+                if (argv[i + 1] != NULL && strcasecmp(argv[i + 1], "lru") == 0) {
+                    contentStoreType = MetisContentStoreType_LRU;
+                } else if (argv[i + 1] != NULL && strcasecmp(argv[i + 1], "tinylfu") == 0) {
+                    contentStoreType = MetisContentStoreType_TinyLFU;
+                } else {
+                    fprintf(stderr, "Unknown cache policy, must be lru or tinylfu\n");
+                    _usage(EXIT_FAILURE);
+                }
+                i++;
+            } else if (strcmp(argv[i], "--workers") == 0) {
+                workers = (argv[i + 1] != NULL) ? atoi(argv[i + 1]) : 0;
+                if (workers < 1) {
+                    fprintf(stderr, "Invalid worker count, must be at least 1\n");
+                    _usage(EXIT_FAILURE);
+                }
+                i++;
+            } else if (strcmp(argv[i], "--udp-sockets") == 0) {
+                udpSockets = (argv[i + 1] != NULL) ? atoi(argv[i + 1]) : 0;
+                if (udpSockets < 1) {
+                    fprintf(stderr, "Invalid UDP socket count, must be at least 1\n");
+                    _usage(EXIT_FAILURE);
+                }
+                i++;
+            } else if (strcmp(argv[i], "--latency-sample") == 0) {
+                latencySample = (argv[i + 1] != NULL) ? atoi(argv[i + 1]) : -1;
+                if (latencySample < 0) {
+                    fprintf(stderr, "Invalid latency sample interval, must be 0 or more\n");
+                    _usage(EXIT_FAILURE);
+                }
+                i++;
             } else if (strcmp(argv[i], "--log") == 0) {
                 _setLogLevel(logLevelArray, argv[i + 1]);
                 i++;
@@ -332,15 +470,40 @@ main(int argc, const char *argv[])
     }
 
 
+    // cache freed messages, names and PIT entries per thread, before any threads start
+    metisSlab_SetEnabled(true);
+
+    if (latencySample > 0) {
+        metisLatency_SetSampleInterval((unsigned) latencySample);
+    }
+
     // this will update the clock to the tick clock
     MetisForwarder *metis = metisForwarder_Create(logger);
 
+    // must be done before any routes are added from the configuration file
+    metisForwarder_SetFIBType(metis, fibType);
+    metisForwarder_SetContentStoreType(metis, contentStoreType);
+    if (workers > 1) {
+        metisForwarder_SetWorkerCount(metis, (unsigned) workers);
+    }
+
     MetisConfiguration *configuration = metisForwarder_GetConfiguration(metis);
 
     if (capacity > -1) {
         metisConfiguration_SetObjectStoreSize(configuration, capacity);
     }
 
+    if (capacityBytes > -1) {
+        metisConfiguration_SetObjectStoreBytes(configuration, (size_t) capacityBytes);
+    }
+
+    if (diskCacheDirectory != NULL) {
+        metisConfiguration_SetObjectStoreDisk(configuration, diskCacheDirectory, (size_t) diskCacheBytes);
+    }
+
+    // must be done before any listeners are setup
+    metisConfiguration_SetUdpSocketsPerListener(configuration, (unsigned) udpSockets);
+
     metisConfiguration_StartCLI(configuration, configurationPort);
 
     if (configFileName) {
@@ -359,6 +522,7 @@ main(int argc, const char *argv[])
     metisLogger_Log(logger, MetisLoggerFacility_Core, PARCLogLevel_Alert, "daemon", "metis exiting port %d", port);
 
     metisForwarder_Destroy(&metis);
+    metisSlab_Drain();
 
     sleep(2);
 
@@ -0,0 +1,1204 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @header Metis Load
+ * @abstract Loopback load generator for a running metis_daemon
+ * @discussion
+ *     metis_load is a consumer, a producer, or both, that drive a running metis_daemon over
+ *     loopback UDP, TCP, or a local (unix domain) socket.  The consumer keeps a window of
+ *     interests outstanding, drawing names from a catalog with Zipf popularity, and measures
+ *     the round trip of each one.  The producer answers every interest with a content object of
+ *     the same name.  At the end the consumer prints packets per second, p50/p99/p999 latency,
+ *     and CPU time per packet, for itself and optionally for the daemon.
+ *
+ *     The daemon needs a route for the producer.  For a UDP producer on port 9700:
+ *
+ *         add connection udp producer 127.0.0.1 9700
+ *         add route producer lci:/load 1
+ *
+ *     or "add connection tcp ..." for a TCP producer.  Catalog names are lci:/load/<n>, names
+ *     that are meant to miss the content store are lci:/load/miss/<n>.
+ *
+ *     Random choices use a fixed seed (see --seed), so runs with the same arguments ask for
+ *     the same names in the same order.
+ *
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+#include <config.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/resource.h>
+
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/forwarder/metis/core/metis_Forwarder.h>
+
+#include <LongBow/runtime.h>
+
+#define METIS_LOAD_PRODUCER_PORT 9700
+#define METIS_LOAD_MAX_PACKET    8192
+#define METIS_LOAD_MAX_CLIENTS   16
+
+// V1 packet types and TLV types, see metis_TlvSchemaV1.c
+#define METIS_LOAD_PACKET_INTEREST 0
+#define METIS_LOAD_PACKET_CONTENT  1
+#define METIS_LOAD_T_INTEREST      0x0001
+#define METIS_LOAD_T_OBJECT        0x0002
+#define METIS_LOAD_T_NAME          0x0000
+#define METIS_LOAD_T_NAMESEGMENT   0x0001
+#define METIS_LOAD_T_PAYLOAD       0x0001
+#define METIS_LOAD_FIXED_HEADER    8
+
+// ids at and above this are the cache misses lci:/load/miss/<n>
+#define METIS_LOAD_MISS_BASE (UINT64_C(1) << 62)
+
+typedef enum {
+    MetisLoadTransport_Udp,
+    MetisLoadTransport_Tcp,
+    MetisLoadTransport_Local,
+} MetisLoadTransport;
+
+typedef struct metis_load_options {
+    bool consumer;
+    bool producer;
+
+    MetisLoadTransport transport;
+    MetisLoadTransport producerTransport;
+    uint16_t port;
+    uint16_t producerPort;
+    const char *localPath;
+
+    unsigned duration;
+    unsigned warmup;
+    unsigned window;
+    uint64_t catalog;
+    double zipf;
+    double hitRatio;
+    size_t payload;
+    unsigned lifetime;
+    uint64_t seed;
+    pid_t daemonPid;
+} MetisLoadOptions;
+
+static volatile sig_atomic_t _stopRequested = 0;
+
+static void
+_signalStop(int signum)
+{
+    _stopRequested = 1;
+}
+
+static uint64_t
+_nowNanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static uint64_t
+_cpuNanos(const struct rusage *usage)
+{
+    return (uint64_t) usage->ru_utime.tv_sec * 1000000000ULL + (uint64_t) usage->ru_utime.tv_usec * 1000ULL
+           + (uint64_t) usage->ru_stime.tv_sec * 1000000000ULL + (uint64_t) usage->ru_stime.tv_usec * 1000ULL;
+}
+
+/**
+ * CPU time used by another process from /proc/<pid>/stat, or 0 if not available
+ */
+static uint64_t
+_processCpuNanos(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int) pid);
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+
+    char line[1024];
+    uint64_t result = 0;
+    if (fgets(line, sizeof(line), file) != NULL) {
+        // the command name may contain spaces, so skip past its closing parenthesis
+        char *fields = strrchr(line, ')');
+        unsigned long utime = 0;
+        unsigned long stime = 0;
+        if (fields != NULL && sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu", &utime, &stime) == 2) {
+            result = (uint64_t) (utime + stime) * 1000000000ULL / (uint64_t) sysconf(_SC_CLK_TCK);
+        }
+    }
+    fclose(file);
+    return result;
+}
+
+// ==========================================================================
+// Packets
+
+static size_t
+_appendSegment(uint8_t *buffer, size_t offset, const char *value)
+{
+    size_t length = strlen(value);
+    buffer[offset++] = 0;
+    buffer[offset++] = METIS_LOAD_T_NAMESEGMENT;
+    buffer[offset++] = (uint8_t) (length >> 8);
+    buffer[offset++] = (uint8_t) length;
+    memcpy(buffer + offset, value, length);
+    return offset + length;
+}
+
+static void
+_writeTlvHeader(uint8_t *buffer, uint16_t type, size_t length)
+{
+    buffer[0] = (uint8_t) (type >> 8);
+    buffer[1] = (uint8_t) type;
+    buffer[2] = (uint8_t) (length >> 8);
+    buffer[3] = (uint8_t) length;
+}
+
+static uint16_t
+_readUint16(const uint8_t *buffer)
+{
+    return (uint16_t) ((buffer[0] << 8) | buffer[1]);
+}
+
+/**
+ * Encode a V1 interest for lci:/load/<id> or lci:/load/miss/<n>
+ *
+ * @return The packet length
+ */
+static size_t
+_encodeInterest(uint8_t *packet, uint64_t id, unsigned lifetime)
+{
+    char number[24];
+    size_t offset = METIS_LOAD_FIXED_HEADER;
+
+    // optional interest lifetime hop-by-hop header
+    if (lifetime > 0) {
+        _writeTlvHeader(packet + offset, 0x0001, 4);
+        packet[offset + 4] = (uint8_t) (lifetime >> 24);
+        packet[offset + 5] = (uint8_t) (lifetime >> 16);
+        packet[offset + 6] = (uint8_t) (lifetime >> 8);
+        packet[offset + 7] = (uint8_t) lifetime;
+        offset += 8;
+    }
+    size_t headerLength = offset;
+
+    size_t interestOffset = offset;
+    size_t nameOffset = interestOffset + 4;
+    offset = nameOffset + 4;
+    offset = _appendSegment(packet, offset, "load");
+    if (id >= METIS_LOAD_MISS_BASE) {
+        offset = _appendSegment(packet, offset, "miss");
+        snprintf(number, sizeof(number), "%" PRIu64, id - METIS_LOAD_MISS_BASE);
+    } else {
+        snprintf(number, sizeof(number), "%" PRIu64, id);
+    }
+    offset = _appendSegment(packet, offset, number);
+
+    _writeTlvHeader(packet + nameOffset, METIS_LOAD_T_NAME, offset - nameOffset - 4);
+    _writeTlvHeader(packet + interestOffset, METIS_LOAD_T_INTEREST, offset - interestOffset - 4);
+
+    packet[0] = 1;
+    packet[1] = METIS_LOAD_PACKET_INTEREST;
+    packet[2] = (uint8_t) (offset >> 8);
+    packet[3] = (uint8_t) offset;
+    packet[4] = 32;     // hop limit
+    packet[5] = 0;
+    packet[6] = 0;
+    packet[7] = (uint8_t) headerLength;
+    return offset;
+}
+
+/**
+ * Find the name TLV (header included) inside the message of a V1 packet
+ *
+ * @return The offset of the name TLV, or 0 if the packet is not the expected type
+ */
+static size_t
+_findName(const uint8_t *packet, size_t packetLength, uint8_t packetType, uint16_t messageType, size_t *nameLengthOutput)
+{
+    if (packetLength < METIS_LOAD_FIXED_HEADER || packet[0] != 1 || packet[1] != packetType) {
+        return 0;
+    }
+
+    size_t offset = packet[7];
+    if (offset + 8 > packetLength || _readUint16(packet + offset) != messageType) {
+        return 0;
+    }
+
+    offset += 4;
+    if (_readUint16(packet + offset) != METIS_LOAD_T_NAME) {
+        return 0;
+    }
+
+    size_t nameLength = 4 + _readUint16(packet + offset + 2);
+    if (offset + nameLength > packetLength) {
+        return 0;
+    }
+
+    *nameLengthOutput = nameLength;
+    return offset;
+}
+
+/**
+ * Decode the id from the name of a content object made by _encodeContentObject()
+ *
+ * @return true if the packet is a content object with a name from _encodeInterest()
+ */
+static bool
+_decodeContentObjectId(const uint8_t *packet, size_t packetLength, uint64_t *idOutput)
+{
+    size_t nameLength;
+    size_t nameOffset = _findName(packet, packetLength, METIS_LOAD_PACKET_CONTENT, METIS_LOAD_T_OBJECT, &nameLength);
+    if (nameOffset == 0) {
+        return false;
+    }
+
+    // walk to the last segment, noting if there is a "miss" segment
+    size_t offset = nameOffset + 4;
+    size_t end = nameOffset + nameLength;
+    bool miss = false;
+    const uint8_t *value = NULL;
+    size_t valueLength = 0;
+    while (offset + 4 <= end) {
+        valueLength = _readUint16(packet + offset + 2);
+        value = packet + offset + 4;
+        if (valueLength == 4 && memcmp(value, "miss", 4) == 0) {
+            miss = true;
+        }
+        offset += 4 + valueLength;
+    }
+
+    if (value == NULL || offset != end) {
+        return false;
+    }
+
+    uint64_t id = 0;
+    for (size_t i = 0; i < valueLength; i++) {
+        if (value[i] < '0' || value[i] > '9') {
+            return false;
+        }
+        id = id * 10 + (value[i] - '0');
+    }
+
+    *idOutput = miss ? id + METIS_LOAD_MISS_BASE : id;
+    return true;
+}
+
+/**
+ * Encode the content object that answers an interest, with the same name and `payload` bytes
+ *
+ * @return The packet length, or 0 if the interest could not be parsed
+ */
+static size_t
+_encodeContentObject(uint8_t *packet, const uint8_t *interest, size_t interestLength, size_t payload)
+{
+    size_t nameLength;
+    size_t nameOffset = _findName(interest, interestLength, METIS_LOAD_PACKET_INTEREST, METIS_LOAD_T_INTEREST, &nameLength);
+    if (nameOffset == 0) {
+        return 0;
+    }
+
+    size_t offset = METIS_LOAD_FIXED_HEADER;
+    size_t objectOffset = offset;
+    offset += 4;
+
+    memcpy(packet + offset, interest + nameOffset, nameLength);
+    offset += nameLength;
+
+    _writeTlvHeader(packet + offset, METIS_LOAD_T_PAYLOAD, payload);
+    offset += 4;
+    memset(packet + offset, 0x55, payload);
+    offset += payload;
+
+    _writeTlvHeader(packet + objectOffset, METIS_LOAD_T_OBJECT, offset - objectOffset - 4);
+
+    packet[0] = 1;
+    packet[1] = METIS_LOAD_PACKET_CONTENT;
+    packet[2] = (uint8_t) (offset >> 8);
+    packet[3] = (uint8_t) offset;
+    packet[4] = 0;
+    packet[5] = 0;
+    packet[6] = 0;
+    packet[7] = METIS_LOAD_FIXED_HEADER;
+    return offset;
+}
+
+// ==========================================================================
+// Stream framing for TCP and local sockets
+
+typedef struct metis_load_stream {
+    int fd;
+    size_t length;
+    uint8_t buffer[4 * METIS_LOAD_MAX_PACKET];
+} MetisLoadStream;
+
+typedef void (MetisLoadPacketHandler)(void *context, int fd, const uint8_t *packet, size_t length);
+
+/**
+ * Read what is available and call the handler for each complete packet
+ *
+ * @return false if the peer closed the connection or there was an error
+ */
+static bool
+_stream_Read(MetisLoadStream *stream, MetisLoadPacketHandler *handler, void *context)
+{
+    ssize_t nread = recv(stream->fd, stream->buffer + stream->length, sizeof(stream->buffer) - stream->length, MSG_DONTWAIT);
+    if (nread == 0) {
+        return false;
+    }
+    if (nread < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    stream->length += (size_t) nread;
+
+    size_t offset = 0;
+    while (stream->length - offset >= METIS_LOAD_FIXED_HEADER) {
+        size_t packetLength = _readUint16(stream->buffer + offset + 2);
+        if (packetLength < METIS_LOAD_FIXED_HEADER || packetLength > METIS_LOAD_MAX_PACKET) {
+            fprintf(stderr, "Bad packet length %zu on fd %d\n", packetLength, stream->fd);
+            return false;
+        }
+        if (stream->length - offset < packetLength) {
+            break;
+        }
+        handler(context, stream->fd, stream->buffer + offset, packetLength);
+        offset += packetLength;
+    }
+
+    memmove(stream->buffer, stream->buffer + offset, stream->length - offset);
+    stream->length -= offset;
+    return true;
+}
+
+static bool
+_sendAll(int fd, const uint8_t *packet, size_t length)
+{
+    while (length > 0) {
+        ssize_t nwritten = send(fd, packet, length, MSG_NOSIGNAL);
+        if (nwritten < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        packet += nwritten;
+        length -= (size_t) nwritten;
+    }
+    return true;
+}
+
+static void
+_setBuffers(int fd)
+{
+    int size = 4 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+}
+
+static struct sockaddr_in
+_loopback(uint16_t port)
+{
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return addr;
+}
+
+// ==========================================================================
+// Producer
+
+typedef struct metis_load_producer {
+    const MetisLoadOptions *options;
+    volatile bool stop;
+    uint64_t served;
+    uint8_t reply[METIS_LOAD_MAX_PACKET];
+} MetisLoadProducer;
+
+static void
+_producer_Answer(void *context, int fd, const uint8_t *packet, size_t length)
+{
+    MetisLoadProducer *producer = (MetisLoadProducer *) context;
+    size_t replyLength = _encodeContentObject(producer->reply, packet, length, producer->options->payload);
+    if (replyLength > 0 && _sendAll(fd, producer->reply, replyLength)) {
+        __atomic_add_fetch(&producer->served, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void
+_producer_RunUdp(MetisLoadProducer *producer, int fd)
+{
+    uint8_t packet[METIS_LOAD_MAX_PACKET];
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+
+    while (!producer->stop && !_stopRequested) {
+        if (poll(&pfd, 1, 100) <= 0) {
+            continue;
+        }
+
+        while (true) {
+            struct sockaddr_storage peer;
+            socklen_t peerLength = sizeof(peer);
+            ssize_t nread = recvfrom(fd, packet, sizeof(packet), MSG_DONTWAIT, (struct sockaddr *) &peer, &peerLength);
+            if (nread <= 0) {
+                break;
+            }
+
+            size_t replyLength = _encodeContentObject(producer->reply, packet, (size_t) nread, producer->options->payload);
+            if (replyLength > 0 && sendto(fd, producer->reply, replyLength, 0, (struct sockaddr *) &peer, peerLength) > 0) {
+                __atomic_add_fetch(&producer->served, 1, __ATOMIC_RELAXED);
+            }
+        }
+    }
+}
+
+static void
+_producer_RunTcp(MetisLoadProducer *producer, int listenFd)
+{
+    // slot 0 is the listener, the rest are the connections the daemon opened
+    struct pollfd pfds[METIS_LOAD_MAX_CLIENTS + 1];
+    MetisLoadStream *streams[METIS_LOAD_MAX_CLIENTS + 1];
+    nfds_t count = 1;
+
+    pfds[0].fd = listenFd;
+    pfds[0].events = POLLIN;
+    streams[0] = NULL;
+
+    while (!producer->stop && !_stopRequested) {
+        if (poll(pfds, count, 100) <= 0) {
+            continue;
+        }
+
+        if ((pfds[0].revents & POLLIN) && count <= METIS_LOAD_MAX_CLIENTS) {
+            int fd = accept(listenFd, NULL, NULL);
+            if (fd >= 0) {
+                int on = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+                _setBuffers(fd);
+                streams[count] = parcMemory_AllocateAndClear(sizeof(MetisLoadStream));
+                assertNotNull(streams[count], "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisLoadStream));
+                streams[count]->fd = fd;
+                pfds[count].fd = fd;
+                pfds[count].events = POLLIN;
+                pfds[count].revents = 0;
+                count++;
+            }
+        }
+
+        for (nfds_t i = 1; i < count; i++) {
+            if (pfds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                if (!_stream_Read(streams[i], _producer_Answer, producer)) {
+                    close(pfds[i].fd);
+                    parcMemory_Deallocate((void **) &streams[i]);
+                    count--;
+                    pfds[i] = pfds[count];
+                    streams[i] = streams[count];
+                    i--;
+                }
+            }
+        }
+    }
+
+    for (nfds_t i = 1; i < count; i++) {
+        close(pfds[i].fd);
+        parcMemory_Deallocate((void **) &streams[i]);
+    }
+}
+
+static void *
+_producer_Run(void *arg)
+{
+    MetisLoadProducer *producer = (MetisLoadProducer *) arg;
+    const MetisLoadOptions *options = producer->options;
+    bool udp = (options->producerTransport == MetisLoadTransport_Udp);
+
+    int fd = socket(AF_INET, udp ? SOCK_DGRAM : SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("producer socket");
+        exit(EXIT_FAILURE);
+    }
+
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    _setBuffers(fd);
+
+    struct sockaddr_in addr = _loopback(options->producerPort);
+    if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+        perror("producer bind");
+        exit(EXIT_FAILURE);
+    }
+
+    if (udp) {
+        _producer_RunUdp(producer, fd);
+    } else {
+        if (listen(fd, METIS_LOAD_MAX_CLIENTS) < 0) {
+            perror("producer listen");
+            exit(EXIT_FAILURE);
+        }
+        _producer_RunTcp(producer, fd);
+    }
+
+    close(fd);
+    return NULL;
+}
+
+// ==========================================================================
+// Outstanding interests, an open addressed hash table from id to send time
+
+typedef struct metis_load_pending {
+    uint64_t id;
+    uint64_t sendTime;      // 0 means the slot is empty
+} MetisLoadPending;
+
+typedef struct metis_load_pending_table {
+    MetisLoadPending *slots;
+    size_t mask;
+    size_t count;
+} MetisLoadPendingTable;
+
+static size_t
+_pending_Hash(uint64_t id)
+{
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdULL;
+    id ^= id >> 33;
+    return (size_t) id;
+}
+
+static void
+_pending_Init(MetisLoadPendingTable *table, size_t capacity)
+{
+    size_t size = 16;
+    while (size < 4 * capacity) {
+        size <<= 1;
+    }
+    table->slots = parcMemory_AllocateAndClear(size * sizeof(MetisLoadPending));
+    assertNotNull(table->slots, "parcMemory_AllocateAndClear(%zu) returned NULL", size * sizeof(MetisLoadPending));
+    table->mask = size - 1;
+    table->count = 0;
+}
+
+static MetisLoadPending *
+_pending_Find(MetisLoadPendingTable *table, uint64_t id)
+{
+    for (size_t i = _pending_Hash(id) & table->mask; table->slots[i].sendTime != 0; i = (i + 1) & table->mask) {
+        if (table->slots[i].id == id) {
+            return &table->slots[i];
+        }
+    }
+    return NULL;
+}
+
+static void
+_pending_Add(MetisLoadPendingTable *table, uint64_t id, uint64_t sendTime)
+{
+    size_t i = _pending_Hash(id) & table->mask;
+    while (table->slots[i].sendTime != 0) {
+        i = (i + 1) & table->mask;
+    }
+    table->slots[i].id = id;
+    table->slots[i].sendTime = sendTime;
+    table->count++;
+}
+
+/**
+ * Remove a slot, moving later entries of the probe sequence back so lookups need no tombstones
+ */
+static void
+_pending_Remove(MetisLoadPendingTable *table, MetisLoadPending *slot)
+{
+    size_t hole = (size_t) (slot - table->slots);
+    size_t i = hole;
+    while (true) {
+        i = (i + 1) & table->mask;
+        if (table->slots[i].sendTime == 0) {
+            break;
+        }
+        size_t home = _pending_Hash(table->slots[i].id) & table->mask;
+        // can the entry at i move to the hole?  Only if its home is not cyclically in (hole, i]
+        bool between = (hole <= i) ? (home > hole && home <= i) : (home > hole || home <= i);
+        if (!between) {
+            table->slots[hole] = table->slots[i];
+            hole = i;
+        }
+    }
+    table->slots[hole].sendTime = 0;
+    table->count--;
+}
+
+// ==========================================================================
+// Consumer
+
+typedef struct metis_load_consumer {
+    const MetisLoadOptions *options;
+
+    int fd;
+    MetisLoadStream *stream;
+
+    uint64_t random;
+    double *zipfCdf;
+    uint64_t nextMiss;
+
+    MetisLoadPendingTable pending;
+
+    bool recording;
+    uint64_t sent;
+    uint64_t received;
+    uint64_t lost;
+    uint64_t unexpected;
+
+    uint64_t *latencies;
+    size_t latencyCount;
+    size_t latencyCapacity;
+} MetisLoadConsumer;
+
+/**
+ * A 64-bit LCG (Knuth MMIX constants), so runs are reproducible
+ *
+ * @return A uniform double in [0, 1)
+ */
+static double
+_consumer_Random(MetisLoadConsumer *consumer)
+{
+    consumer->random = consumer->random * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (double) (consumer->random >> 11) / (double) (UINT64_C(1) << 53);
+}
+
+static void
+_consumer_BuildZipf(MetisLoadConsumer *consumer)
+{
+    uint64_t n = consumer->options->catalog;
+    consumer->zipfCdf = parcMemory_Allocate(n * sizeof(double));
+    assertNotNull(consumer->zipfCdf, "parcMemory_Allocate(%zu) returned NULL", (size_t) (n * sizeof(double)));
+
+    double sum = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        sum += 1.0 / pow((double) (i + 1), consumer->options->zipf);
+        consumer->zipfCdf[i] = sum;
+    }
+    for (uint64_t i = 0; i < n; i++) {
+        consumer->zipfCdf[i] /= sum;
+    }
+}
+
+static uint64_t
+_consumer_NextId(MetisLoadConsumer *consumer)
+{
+    const MetisLoadOptions *options = consumer->options;
+
+    if (options->hitRatio >= 0 && _consumer_Random(consumer) >= options->hitRatio) {
+        return METIS_LOAD_MISS_BASE + consumer->nextMiss++;
+    }
+
+    // binary search the cdf for the first rank at or above u
+    double u = _consumer_Random(consumer);
+    uint64_t low = 0;
+    uint64_t high = options->catalog - 1;
+    while (low < high) {
+        uint64_t middle = low + (high - low) / 2;
+        if (consumer->zipfCdf[middle] < u) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+static void
+_consumer_RecordLatency(MetisLoadConsumer *consumer, uint64_t latency)
+{
+    if (consumer->latencyCount == consumer->latencyCapacity) {
+        consumer->latencyCapacity = (consumer->latencyCapacity == 0) ? 65536 : 2 * consumer->latencyCapacity;
+        size_t bytes = consumer->latencyCapacity * sizeof(uint64_t);
+        if (consumer->latencies == NULL) {
+            consumer->latencies = parcMemory_Allocate(bytes);
+        } else {
+            consumer->latencies = parcMemory_Reallocate(consumer->latencies, bytes);
+        }
+        assertNotNull(consumer->latencies, "Could not allocate %zu bytes of latencies", bytes);
+    }
+    consumer->latencies[consumer->latencyCount++] = latency;
+}
+
+static void
+_consumer_Receive(void *context, int fd, const uint8_t *packet, size_t length)
+{
+    MetisLoadConsumer *consumer = (MetisLoadConsumer *) context;
+    uint64_t id;
+
+    MetisLoadPending *slot = NULL;
+    if (_decodeContentObjectId(packet, length, &id)) {
+        slot = _pending_Find(&consumer->pending, id);
+    }
+
+    if (slot == NULL) {
+        // late, after we gave up on it, or not ours
+        consumer->unexpected++;
+        return;
+    }
+
+    if (consumer->recording) {
+        consumer->received++;
+        _consumer_RecordLatency(consumer, _nowNanos() - slot->sendTime);
+    }
+    _pending_Remove(&consumer->pending, slot);
+}
+
+static void
+_consumer_Connect(MetisLoadConsumer *consumer)
+{
+    const MetisLoadOptions *options = consumer->options;
+    int fd;
+    int result;
+
+    if (options->transport == MetisLoadTransport_Local) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, options->localPath, sizeof(addr.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        result = (fd < 0) ? -1 : connect(fd, (struct sockaddr *) &addr, sizeof(addr));
+    } else {
+        bool udp = (options->transport == MetisLoadTransport_Udp);
+        struct sockaddr_in addr = _loopback(options->port);
+        fd = socket(AF_INET, udp ? SOCK_DGRAM : SOCK_STREAM, 0);
+        result = (fd < 0) ? -1 : connect(fd, (struct sockaddr *) &addr, sizeof(addr));
+        if (result == 0 && !udp) {
+            int on = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        }
+    }
+
+    if (result < 0) {
+        perror("consumer connect");
+        exit(EXIT_FAILURE);
+    }
+
+    _setBuffers(fd);
+    consumer->fd = fd;
+
+    if (options->transport != MetisLoadTransport_Udp) {
+        consumer->stream = parcMemory_AllocateAndClear(sizeof(MetisLoadStream));
+        assertNotNull(consumer->stream, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisLoadStream));
+        consumer->stream->fd = fd;
+    }
+}
+
+static bool
+_consumer_ReadAll(MetisLoadConsumer *consumer)
+{
+    if (consumer->stream != NULL) {
+        return _stream_Read(consumer->stream, _consumer_Receive, consumer);
+    }
+
+    uint8_t packet[METIS_LOAD_MAX_PACKET];
+    ssize_t nread;
+    while ((nread = recv(consumer->fd, packet, sizeof(packet), MSG_DONTWAIT)) > 0) {
+        _consumer_Receive(consumer, consumer->fd, packet, (size_t) nread);
+    }
+    return true;
+}
+
+static void
+_consumer_ExpireLost(MetisLoadConsumer *consumer, uint64_t now)
+{
+    uint64_t timeout = (uint64_t) consumer->options->lifetime * 1000000ULL;
+    for (size_t i = 0; i <= consumer->pending.mask; i++) {
+        MetisLoadPending *slot = &consumer->pending.slots[i];
+        // removal can move a later entry into this slot, so check it again
+        while (slot->sendTime != 0 && slot->sendTime + timeout < now) {
+            if (consumer->recording) {
+                consumer->lost++;
+            }
+            _pending_Remove(&consumer->pending, slot);
+        }
+    }
+}
+
+static void
+_consumer_Run(MetisLoadConsumer *consumer, uint64_t recordStart, uint64_t end)
+{
+    const MetisLoadOptions *options = consumer->options;
+    uint8_t packet[METIS_LOAD_MAX_PACKET];
+    uint64_t nextExpiry = _nowNanos() + 100000000ULL;
+
+    while (!_stopRequested) {
+        uint64_t now = _nowNanos();
+        if (now >= end) {
+            break;
+        }
+
+        if (!consumer->recording && now >= recordStart) {
+            consumer->recording = true;
+        }
+
+        // fill the window.  Names already outstanding are skipped, they would aggregate in the PIT.
+        for (unsigned attempts = 0; consumer->pending.count < options->window && attempts < options->window; attempts++) {
+            uint64_t id = _consumer_NextId(consumer);
+            if (_pending_Find(&consumer->pending, id) != NULL) {
+                continue;
+            }
+
+            size_t length = _encodeInterest(packet, id, options->lifetime);
+            bool sent = (consumer->stream != NULL) ? _sendAll(consumer->fd, packet, length) : (send(consumer->fd, packet, length, 0) > 0);
+            if (!sent) {
+                break;
+            }
+
+            _pending_Add(&consumer->pending, id, _nowNanos());
+            if (consumer->recording) {
+                consumer->sent++;
+            }
+        }
+
+        struct pollfd pfd = { .fd = consumer->fd, .events = POLLIN };
+        if (poll(&pfd, 1, 1) > 0) {
+            if (!_consumer_ReadAll(consumer)) {
+                fprintf(stderr, "Connection to metis closed\n");
+                break;
+            }
+        }
+
+        if (now >= nextExpiry) {
+            _consumer_ExpireLost(consumer, now);
+            nextExpiry = now + 100000000ULL;
+        }
+    }
+}
+
+static int
+_compareUint64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+static double
+_percentileMicros(const uint64_t *sorted, size_t count, double percentile)
+{
+    if (count == 0) {
+        return 0.0;
+    }
+    size_t index = (size_t) (percentile * (double) (count - 1));
+    return (double) sorted[index] / 1000.0;
+}
+
+static void
+_report(const MetisLoadOptions *options, MetisLoadConsumer *consumer, const MetisLoadProducer *producer,
+        uint64_t producerServedAtStart, double seconds, uint64_t toolCpu, uint64_t daemonCpu)
+{
+    qsort(consumer->latencies, consumer->latencyCount, sizeof(uint64_t), _compareUint64);
+
+    double packets = (double) consumer->received;
+    printf("\n");
+    printf("duration         %10.2f s\n", seconds);
+    printf("interests sent   %10" PRIu64 "\n", consumer->sent);
+    printf("objects received %10" PRIu64 "\n", consumer->received);
+    printf("lost             %10" PRIu64 "\n", consumer->lost);
+    printf("unexpected       %10" PRIu64 "\n", consumer->unexpected);
+    printf("throughput       %10.4f Mpps\n", seconds > 0 ? packets / seconds / 1e6 : 0.0);
+    printf("latency p50      %10.1f usec\n", _percentileMicros(consumer->latencies, consumer->latencyCount, 0.50));
+    printf("latency p99      %10.1f usec\n", _percentileMicros(consumer->latencies, consumer->latencyCount, 0.99));
+    printf("latency p999     %10.1f usec\n", _percentileMicros(consumer->latencies, consumer->latencyCount, 0.999));
+    printf("load cpu/packet  %10.1f nsec\n", packets > 0 ? (double) toolCpu / packets : 0.0);
+    if (options->daemonPid > 0) {
+        printf("metis cpu/packet %10.1f nsec\n", packets > 0 ? (double) daemonCpu / packets : 0.0);
+    }
+    if (producer != NULL && packets > 0) {
+        // every object the producer did not make came from the content store
+        uint64_t served = __atomic_load_n(&producer->served, __ATOMIC_RELAXED) - producerServedAtStart;
+        double hitRatio = 1.0 - (double) served / packets;
+        printf("cs hit ratio     %10.4f\n", hitRatio < 0 ? 0.0 : hitRatio);
+    }
+}
+
+// ==========================================================================
+
+static void
+_usage(int exitCode)
+{
+    printf("Usage: metis_load [--consumer] [--producer] [--transport udp|tcp|local] [--port port] [--local path]\n");
+    printf("                  [--producer-transport udp|tcp] [--producer-port port] [--duration sec] [--warmup sec]\n");
+    printf("                  [--window count] [--catalog count] [--zipf s] [--hit-ratio r] [--payload bytes]\n");
+    printf("                  [--lifetime msec] [--seed n] [--metis-pid pid]\n");
+    printf("\n");
+    printf("Generates load on a running metis_daemon over loopback.  With neither --consumer nor --producer, runs both.\n");
+    printf("The daemon needs a connection and route to the producer, e.g. for the default UDP producer:\n");
+    printf("    add connection udp producer 127.0.0.1 %d\n", METIS_LOAD_PRODUCER_PORT);
+    printf("    add route producer lci:/load 1\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("--consumer           = send interests and measure the replies\n");
+    printf("--producer           = answer interests for lci:/load (runs until interrupted without --consumer)\n");
+    printf("--transport          = how the consumer talks to metis (default udp)\n");
+    printf("--port               = metis UDP/TCP port (default %d)\n", PORT_NUMBER);
+    printf("--local              = path of a metis local listener, for --transport local\n");
+    printf("--producer-transport = how metis talks to the producer (default udp)\n");
+    printf("--producer-port      = port the producer listens on (default %d)\n", METIS_LOAD_PRODUCER_PORT);
+    printf("--duration           = seconds to measure (default 10)\n");
+    printf("--warmup             = seconds to run before measuring, to fill the content store (default 2)\n");
+    printf("--window             = interests outstanding at once (default 64)\n");
+    printf("--catalog            = number of distinct names, lci:/load/0 through lci:/load/<count-1> (default 100000)\n");
+    printf("--zipf               = Zipf exponent of name popularity, 0 is uniform (default 1.0)\n");
+    printf("--hit-ratio          = fraction of interests for catalog names, the rest are for names never asked\n");
+    printf("                       before, which always miss the content store (default: all catalog names)\n");
+    printf("--payload            = content object payload bytes (default 1024)\n");
+    printf("--lifetime           = interest lifetime, after which an interest is counted as lost (default 4000)\n");
+    printf("--seed               = seed for the name choices (default 1)\n");
+    printf("--metis-pid          = also report the CPU time metis_daemon used per packet\n");
+    exit(exitCode);
+}
+
+static MetisLoadTransport
+_parseTransport(const char *string, bool allowLocal)
+{
+    if (string != NULL && strcasecmp(string, "udp") == 0) {
+        return MetisLoadTransport_Udp;
+    }
+    if (string != NULL && strcasecmp(string, "tcp") == 0) {
+        return MetisLoadTransport_Tcp;
+    }
+    if (allowLocal && string != NULL && strcasecmp(string, "local") == 0) {
+        return MetisLoadTransport_Local;
+    }
+    fprintf(stderr, "Unknown transport %s\n", string ? string : "(null)");
+    _usage(EXIT_FAILURE);
+    return MetisLoadTransport_Udp;
+}
+
+int
+main(int argc, const char *argv[])
+{
+    MetisLoadOptions options = {
+        .consumer          = false,
+        .producer          = false,
+        .transport         = MetisLoadTransport_Udp,
+        .producerTransport = MetisLoadTransport_Udp,
+        .port              = PORT_NUMBER,
+        .producerPort      = METIS_LOAD_PRODUCER_PORT,
+        .localPath         = NULL,
+        .duration          = 10,
+        .warmup            = 2,
+        .window            = 64,
+        .catalog           = 100000,
+        .zipf              = 1.0,
+        .hitRatio          = -1,
+        .payload           = 1024,
+        .lifetime          = 4000,
+        .seed              = 1,
+        .daemonPid         = 0,
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            _usage(EXIT_SUCCESS);
+        } else if (strcmp(argv[i], "--consumer") == 0) {
+            options.consumer = true;
+        } else if (strcmp(argv[i], "--producer") == 0) {
+            options.producer = true;
+        } else if (value == NULL) {
+            _usage(EXIT_FAILURE);
+        } else {
+            if (strcmp(argv[i], "--transport") == 0) {
+                options.transport = _parseTransport(value, true);
+            } else if (strcmp(argv[i], "--producer-transport") == 0) {
+                options.producerTransport = _parseTransport(value, false);
+            } else if (strcmp(argv[i], "--port") == 0) {
+                options.port = (uint16_t) atoi(value);
+            } else if (strcmp(argv[i], "--producer-port") == 0) {
+                options.producerPort = (uint16_t) atoi(value);
+            } else if (strcmp(argv[i], "--local") == 0) {
+                options.localPath = value;
+            } else if (strcmp(argv[i], "--duration") == 0) {
+                options.duration = (unsigned) atoi(value);
+            } else if (strcmp(argv[i], "--warmup") == 0) {
+                options.warmup = (unsigned) atoi(value);
+            } else if (strcmp(argv[i], "--window") == 0) {
+                options.window = (unsigned) atoi(value);
+            } else if (strcmp(argv[i], "--catalog") == 0) {
+                options.catalog = strtoull(value, NULL, 10);
+            } else if (strcmp(argv[i], "--zipf") == 0) {
+                options.zipf = atof(value);
+            } else if (strcmp(argv[i], "--hit-ratio") == 0) {
+                options.hitRatio = atof(value);
+            } else if (strcmp(argv[i], "--payload") == 0) {
+                options.payload = (size_t) atoi(value);
+            } else if (strcmp(argv[i], "--lifetime") == 0) {
+                options.lifetime = (unsigned) atoi(value);
+            } else if (strcmp(argv[i], "--seed") == 0) {
+                options.seed = strtoull(value, NULL, 10);
+            } else if (strcmp(argv[i], "--metis-pid") == 0) {
+                options.daemonPid = (pid_t) atoi(value);
+            } else {
+                _usage(EXIT_FAILURE);
+            }
+            i++;
+        }
+    }
+
+    if (!options.consumer && !options.producer) {
+        options.consumer = true;
+        options.producer = true;
+    }
+
+    if (options.window == 0 || options.catalog == 0 || options.zipf < 0 || options.hitRatio > 1.0 || options.lifetime == 0) {
+        fprintf(stderr, "Invalid window, catalog, zipf, hit ratio, or lifetime\n");
+        _usage(EXIT_FAILURE);
+    }
+    if (options.payload + 64 > METIS_LOAD_MAX_PACKET) {
+        fprintf(stderr, "Payload must be at most %d bytes\n", METIS_LOAD_MAX_PACKET - 64);
+        _usage(EXIT_FAILURE);
+    }
+    if (options.transport == MetisLoadTransport_Local && options.localPath == NULL) {
+        fprintf(stderr, "--transport local needs --local path\n");
+        _usage(EXIT_FAILURE);
+    }
+
+    signal(SIGINT, _signalStop);
+    signal(SIGTERM, _signalStop);
+    signal(SIGPIPE, SIG_IGN);
+
+    MetisLoadProducer producer = { .options = &options, .stop = false, .served = 0 };
+    pthread_t producerThread;
+    if (options.producer) {
+        pthread_create(&producerThread, NULL, _producer_Run, &producer);
+    }
+
+    if (options.consumer) {
+        MetisLoadConsumer consumer;
+        memset(&consumer, 0, sizeof(consumer));
+        consumer.options = &options;
+        consumer.random = options.seed;
+        _consumer_BuildZipf(&consumer);
+        _pending_Init(&consumer.pending, options.window);
+        _consumer_Connect(&consumer);
+
+        uint64_t start = _nowNanos();
+        uint64_t recordStart = start + (uint64_t) options.warmup * 1000000000ULL;
+        uint64_t end = recordStart + (uint64_t) options.duration * 1000000000ULL;
+
+        // the warmup is run separately so the CPU and producer counters can be read when it ends
+        _consumer_Run(&consumer, recordStart, recordStart);
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        uint64_t toolCpu = _cpuNanos(&usage);
+        uint64_t daemonCpu = (options.daemonPid > 0) ? _processCpuNanos(options.daemonPid) : 0;
+        uint64_t producerServedAtStart = __atomic_load_n(&producer.served, __ATOMIC_RELAXED);
+        uint64_t measureStart = _nowNanos();
+
+        _consumer_Run(&consumer, recordStart, end);
+
+        double seconds = (double) (_nowNanos() - measureStart) / 1e9;
+        getrusage(RUSAGE_SELF, &usage);
+        toolCpu = _cpuNanos(&usage) - toolCpu;
+        if (options.daemonPid > 0) {
+            daemonCpu = _processCpuNanos(options.daemonPid) - daemonCpu;
+        }
+
+        _report(&options, &consumer, options.producer ? &producer : NULL, producerServedAtStart, seconds, toolCpu, daemonCpu);
+
+        close(consumer.fd);
+        if (consumer.stream) {
+            parcMemory_Deallocate((void **) &consumer.stream);
+        }
+        if (consumer.pending.slots) {
+            parcMemory_Deallocate((void **) &consumer.pending.slots);
+        }
+        if (consumer.latencies) {
+            parcMemory_Deallocate((void **) &consumer.latencies);
+        }
+        if (consumer.zipfCdf) {
+            parcMemory_Deallocate((void **) &consumer.zipfCdf);
+        }
+
+        producer.stop = true;
+    }
+
+    if (options.producer) {
+        pthread_join(producerThread, NULL);
+        printf("producer served  %10" PRIu64 "\n", producer.served);
+    }
+
+    return EXIT_SUCCESS;
+}
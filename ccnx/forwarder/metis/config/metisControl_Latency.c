@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/forwarder/metis/config/metisControl_Latency.h>
+#include <ccnx/forwarder/metis/core/metis_Latency.h>
+
+static MetisCommandReturn _metisControlLatency_Execute(MetisCommandParser *parser, MetisCommandOps *ops, PARCList *args);
+static MetisCommandReturn _metisControlLatency_HelpExecute(MetisCommandParser *parser, MetisCommandOps *ops, PARCList *args);
+
+static const char *_commandLatency = "latency";
+static const char *_commandLatencyHelp = "help latency";
+
+// ====================================================
+
+MetisCommandOps *
+metisControlLatency_Create(MetisControlState *state)
+{
+    return metisCommandOps_Create(state, _commandLatency, NULL, _metisControlLatency_Execute, metisCommandOps_Destroy);
+}
+
+MetisCommandOps *
+metisControlLatency_HelpCreate(MetisControlState *state)
+{
+    return metisCommandOps_Create(state, _commandLatencyHelp, NULL, _metisControlLatency_HelpExecute, metisCommandOps_Destroy);
+}
+
+// ====================================================
+
+static MetisCommandReturn
+_metisControlLatency_HelpExecute(MetisCommandParser *parser, MetisCommandOps *ops, PARCList *args)
+{
+    printf("latency [<sample interval>]\n");
+    printf("\n");
+    printf("   Prints the latency of each forwarding stage (parse, pit, contentStore, fib, send) in\n");
+    printf("   nanoseconds, summed over all the forwarder's threads.\n");
+    printf("   With a sample interval, first times one in every <sample interval> stages on each\n");
+    printf("   thread.  0 turns the timing off.\n");
+    printf("\n");
+
+    return MetisCommandReturn_Success;
+}
+
+static int64_t
+_getInteger(PARCJSON *json, const char *name)
+{
+    PARCJSONValue *value = parcJSON_GetValueByName(json, name);
+    if (value != NULL && parcJSONValue_IsNumber(value)) {
+        return parcJSONValue_GetInteger(value);
+    }
+    return 0;
+}
+
+static MetisCommandReturn
+_metisControlLatency_Execute(MetisCommandParser *parser, MetisCommandOps *ops, PARCList *args)
+{
+    if (parcList_Size(args) != 1 && parcList_Size(args) != 2) {
+        _metisControlLatency_HelpExecute(parser, ops, args);
+        return MetisCommandReturn_Failure;
+    }
+
+    bool setInterval = false;
+    unsigned interval = 0;
+    if (parcList_Size(args) == 2) {
+        const char *intervalString = parcList_GetAtIndex(args, 1);
+        char *end;
+        unsigned long value = strtoul(intervalString, &end, 10);
+        if (*intervalString == '\0' || *end != '\0' || value > UINT32_MAX) {
+            printf("Error: the sample interval must be a non-negative integer: %s\n", intervalString);
+            return MetisCommandReturn_Failure;
+        }
+        setInterval = true;
+        interval = (unsigned) value;
+    }
+
+    MetisControlState *state = ops->closure;
+    CCNxControl *latencyRequest = metisLatency_CreateCPIRequest(setInterval, interval);
+
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromControl(latencyRequest);
+    CCNxMetaMessage *rawResponse = metisControlState_WriteRead(state, message);
+    ccnxMetaMessage_Release(&message);
+    ccnxControl_Release(&latencyRequest);
+
+    CCNxControl *response = ccnxMetaMessage_GetControl(rawResponse);
+
+    if (metisControlState_GetDebug(state)) {
+        char *str = parcJSON_ToString(ccnxControl_GetJson(response));
+        printf("reponse:\n%s\n", str);
+        parcMemory_Deallocate((void **) &str);
+    }
+
+    PARCJSON *summary = metisLatency_GetCPIResponse(response);
+    if (summary == NULL) {
+        ccnxMetaMessage_Release(&rawResponse);
+        printf("Error: the forwarder did not return its latencies\n");
+        return MetisCommandReturn_Failure;
+    }
+
+    printf("sample interval %" PRId64 "\n", _getInteger(summary, "SAMPLE_INTERVAL"));
+    printf("%-14s %12s %10s %10s %10s %10s %10s %10s\n", "stage", "count", "mean", "p50", "p90", "p99", "p99.9", "max");
+    for (MetisLatencyStage stage = 0; stage < MetisLatencyStage_END; stage++) {
+        PARCJSONValue *value = parcJSON_GetValueByName(summary, metisLatency_StageName(stage));
+        if (value == NULL || !parcJSONValue_IsJSON(value)) {
+            continue;
+        }
+
+        PARCJSON *histogram = parcJSONValue_GetJSON(value);
+        printf("%-14s %12" PRId64 " %10" PRId64 " %10" PRId64 " %10" PRId64 " %10" PRId64 " %10" PRId64 " %10" PRId64 "\n",
+               metisLatency_StageName(stage),
+               _getInteger(histogram, "count"),
+               _getInteger(histogram, "meanNs"),
+               _getInteger(histogram, "p50Ns"),
+               _getInteger(histogram, "p90Ns"),
+               _getInteger(histogram, "p99Ns"),
+               _getInteger(histogram, "p999Ns"),
+               _getInteger(histogram, "maxNs"));
+    }
+    printf("(nanoseconds)\n");
+
+    ccnxMetaMessage_Release(&rawResponse);
+    return MetisCommandReturn_Success;
+}
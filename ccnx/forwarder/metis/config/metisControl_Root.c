@@ -69,10 +69,12 @@
 
 #include <ccnx/forwarder/metis/config/metisControl_Root.h>
 #include <ccnx/forwarder/metis/config/metisControl_Add.h>
+#include <ccnx/forwarder/metis/config/metisControl_Latency.h>
 #include <ccnx/forwarder/metis/config/metisControl_List.h>
 #include <ccnx/forwarder/metis/config/metisControl_Quit.h>
 #include <ccnx/forwarder/metis/config/metisControl_Remove.h>
 #include <ccnx/forwarder/metis/config/metisControl_Set.h>
+#include <ccnx/forwarder/metis/config/metisControl_Stats.h>
 #include <ccnx/forwarder/metis/config/metisControl_Unset.h>
 
 static void _metisControlRoot_Init(MetisCommandParser *parser, MetisCommandOps *ops);
@@ -112,26 +114,32 @@ _metisControlRoot_HelpExecute(MetisCommandParser *parser, MetisCommandOps *ops,
     printf("\n");
 
     MetisCommandOps *ops_help_add = metisControlAdd_CreateHelp(NULL);
+    MetisCommandOps *ops_help_latency = metisControlLatency_HelpCreate(NULL);
     MetisCommandOps *ops_help_list = metisControlList_HelpCreate(NULL);
     MetisCommandOps *ops_help_quit = metisControlQuit_HelpCreate(NULL);
     MetisCommandOps *ops_help_remove = metisControlRemove_HelpCreate(NULL);
     MetisCommandOps *ops_help_set = metisControlSet_HelpCreate(NULL);
+    MetisCommandOps *ops_help_stats = metisControlStats_HelpCreate(NULL);
     MetisCommandOps *ops_help_unset = metisControlUnset_HelpCreate(NULL);
 
     printf("Available commands:\n");
     printf("   %s\n", ops_help_add->command);
+    printf("   %s\n", ops_help_latency->command);
     printf("   %s\n", ops_help_list->command);
     printf("   %s\n", ops_help_quit->command);
     printf("   %s\n", ops_help_remove->command);
     printf("   %s\n", ops_help_set->command);
+    printf("   %s\n", ops_help_stats->command);
     printf("   %s\n", ops_help_unset->command);
     printf("\n");
 
     metisCommandOps_Destroy(&ops_help_add);
+    metisCommandOps_Destroy(&ops_help_latency);
     metisCommandOps_Destroy(&ops_help_list);
     metisCommandOps_Destroy(&ops_help_quit);
     metisCommandOps_Destroy(&ops_help_remove);
     metisCommandOps_Destroy(&ops_help_set);
+    metisCommandOps_Destroy(&ops_help_stats);
     metisCommandOps_Destroy(&ops_help_unset);
 
     return MetisCommandReturn_Success;
@@ -143,17 +151,21 @@ _metisControlRoot_Init(MetisCommandParser *parser, MetisCommandOps *ops)
     MetisControlState *state = ops->closure;
 
     metisControlState_RegisterCommand(state, metisControlAdd_CreateHelp(state));
+    metisControlState_RegisterCommand(state, metisControlLatency_HelpCreate(state));
     metisControlState_RegisterCommand(state, metisControlList_HelpCreate(state));
     metisControlState_RegisterCommand(state, metisControlQuit_HelpCreate(state));
     metisControlState_RegisterCommand(state, metisControlRemove_HelpCreate(state));
     metisControlState_RegisterCommand(state, metisControlSet_HelpCreate(state));
+    metisControlState_RegisterCommand(state, metisControlStats_HelpCreate(state));
     metisControlState_RegisterCommand(state, metisControlUnset_HelpCreate(state));
 
     metisControlState_RegisterCommand(state, metisControlAdd_Create(state));
+    metisControlState_RegisterCommand(state, metisControlLatency_Create(state));
     metisControlState_RegisterCommand(state, metisControlList_Create(state));
     metisControlState_RegisterCommand(state, metisControlQuit_Create(state));
     metisControlState_RegisterCommand(state, metisControlRemove_Create(state));
     metisControlState_RegisterCommand(state, metisControlSet_Create(state));
+    metisControlState_RegisterCommand(state, metisControlStats_Create(state));
     metisControlState_RegisterCommand(state, metisControlUnset_Create(state));
 }
 
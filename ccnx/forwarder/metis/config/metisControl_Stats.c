@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <LongBow/runtime.h>
+
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/forwarder/metis/config/metisControl_Stats.h>
+#include <ccnx/forwarder/metis/core/metis_Stats.h>
+
+static MetisCommandReturn _metisControlStats_Execute(MetisCommandParser *parser, MetisCommandOps *ops, PARCList *args);
+static MetisCommandReturn _metisControlStats_HelpExecute(MetisCommandParser *parser, MetisCommandOps *ops, PARCList *args);
+
+static const char *_commandStats = "stats";
+static const char *_commandStatsHelp = "help stats";
+
+// ====================================================
+
+MetisCommandOps *
+metisControlStats_Create(MetisControlState *state)
+{
+    return metisCommandOps_Create(state, _commandStats, NULL, _metisControlStats_Execute, metisCommandOps_Destroy);
+}
+
+MetisCommandOps *
+metisControlStats_HelpCreate(MetisControlState *state)
+{
+    return metisCommandOps_Create(state, _commandStatsHelp, NULL, _metisControlStats_HelpExecute, metisCommandOps_Destroy);
+}
+
+// ====================================================
+
+static MetisCommandReturn
+_metisControlStats_HelpExecute(MetisCommandParser *parser, MetisCommandOps *ops, PARCList *args)
+{
+    printf("stats\n");
+    printf("\n");
+    printf("   Prints the forwarder's counters, summed over all its threads, one per line.\n");
+    printf("   The counters are 64-bit and count from when the forwarder started.\n");
+    printf("\n");
+
+    return MetisCommandReturn_Success;
+}
+
+static MetisCommandReturn
+_metisControlStats_Execute(MetisCommandParser *parser, MetisCommandOps *ops, PARCList *args)
+{
+    if (parcList_Size(args) != 1) {
+        _metisControlStats_HelpExecute(parser, ops, args);
+        return MetisCommandReturn_Failure;
+    }
+
+    MetisControlState *state = ops->closure;
+    CCNxControl *statsRequest = metisStats_CreateCPIRequest();
+
+    CCNxMetaMessage *message = ccnxMetaMessage_CreateFromControl(statsRequest);
+    CCNxMetaMessage *rawResponse = metisControlState_WriteRead(state, message);
+    ccnxMetaMessage_Release(&message);
+    ccnxControl_Release(&statsRequest);
+
+    CCNxControl *response = ccnxMetaMessage_GetControl(rawResponse);
+
+    if (metisControlState_GetDebug(state)) {
+        char *str = parcJSON_ToString(ccnxControl_GetJson(response));
+        printf("reponse:\n%s\n", str);
+        parcMemory_Deallocate((void **) &str);
+    }
+
+    MetisStats stats;
+    bool success = metisStats_FromCPIResponse(&stats, response);
+    ccnxMetaMessage_Release(&rawResponse);
+
+    if (!success) {
+        printf("Error: the forwarder did not return its counters\n");
+        return MetisCommandReturn_Failure;
+    }
+
+    for (MetisStat stat = 0; stat < MetisStat_END; stat++) {
+        printf("%-40s %20" PRIu64 "\n", metisStats_Name(stat), stats.values[stat]);
+    }
+    printf("%-40s %20.4f\n", "contentStore.hitRatio", metisStats_ContentStoreHitRatio(&stats));
+
+    return MetisCommandReturn_Success;
+}
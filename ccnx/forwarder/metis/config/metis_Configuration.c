@@ -86,6 +86,7 @@
 #include <ccnx/forwarder/metis/core/metis_Forwarder.h>
 #include <ccnx/forwarder/metis/core/metis_System.h>
 #include <ccnx/forwarder/metis/core/metis_ConnectionTable.h>
+#include <ccnx/forwarder/metis/core/metis_Latency.h>
 
 #include <ccnx/forwarder/metis/io/metis_TcpTunnel.h>
 #include <ccnx/forwarder/metis/io/metis_UdpTunnel.h>
@@ -104,6 +105,16 @@ struct metis_configuration {
 
     size_t maximumContentObjectStoreSize;
 
+    // 0 means the content store is only limited by object count
+    size_t maximumContentObjectStoreBytes;
+
+    // NULL means no disk tier behind the content store
+    char *contentObjectStoreDiskDirectory;
+    size_t maximumContentObjectStoreDiskBytes;
+
+    // SO_REUSEPORT sockets per UDP listener
+    unsigned udpSocketsPerListener;
+
     // translates between a symblic name and a connection id
     MetisSymbolicNameTable *symbolicNameTable;
 };
@@ -121,6 +132,8 @@ metisConfiguration_Create(MetisForwarder *metis)
     config->logger = metisLogger_Acquire(metisForwarder_GetLogger(metis));
     config->cli = NULL;
     config->maximumContentObjectStoreSize = 100000;
+    config->maximumContentObjectStoreBytes = 0;
+    config->udpSocketsPerListener = 1;
     config->symbolicNameTable = metisSymbolicNameTable_Create();
 
     return config;
@@ -139,6 +152,9 @@ metisConfiguration_Destroy(MetisConfiguration **configPtr)
     }
 
     metisSymbolicNameTable_Destroy(&config->symbolicNameTable);
+    if (config->contentObjectStoreDiskDirectory != NULL) {
+        parcMemory_Deallocate((void **) &config->contentObjectStoreDiskDirectory);
+    }
     parcMemory_Deallocate((void **) &config);
     *configPtr = NULL;
 }
@@ -599,6 +615,60 @@ metisConfiguration_SetObjectStoreSize(MetisConfiguration *config, size_t maximum
     metisForwarder_SetContentObjectStoreSize(config->metis, config->maximumContentObjectStoreSize);
 }
 
+size_t
+metisConfiguration_GetObjectStoreBytes(MetisConfiguration *config)
+{
+    return config->maximumContentObjectStoreBytes;
+}
+
+void
+metisConfiguration_SetObjectStoreBytes(MetisConfiguration *config, size_t maximumContentObjectBytes)
+{
+    config->maximumContentObjectStoreBytes = maximumContentObjectBytes;
+
+    metisForwarder_SetContentObjectStoreBytes(config->metis, config->maximumContentObjectStoreBytes);
+}
+
+const char *
+metisConfiguration_GetObjectStoreDiskDirectory(MetisConfiguration *config)
+{
+    return config->contentObjectStoreDiskDirectory;
+}
+
+size_t
+metisConfiguration_GetObjectStoreDiskBytes(MetisConfiguration *config)
+{
+    return config->maximumContentObjectStoreDiskBytes;
+}
+
+void
+metisConfiguration_SetObjectStoreDisk(MetisConfiguration *config, const char *directory, size_t maximumDiskBytes)
+{
+    if (config->contentObjectStoreDiskDirectory != NULL) {
+        parcMemory_Deallocate((void **) &config->contentObjectStoreDiskDirectory);
+    }
+
+    if (directory != NULL) {
+        config->contentObjectStoreDiskDirectory = parcMemory_StringDuplicate(directory, strlen(directory));
+    }
+    config->maximumContentObjectStoreDiskBytes = maximumDiskBytes;
+
+    metisForwarder_SetContentObjectStoreDisk(config->metis, config->contentObjectStoreDiskDirectory, config->maximumContentObjectStoreDiskBytes);
+}
+
+unsigned
+metisConfiguration_GetUdpSocketsPerListener(MetisConfiguration *config)
+{
+    return config->udpSocketsPerListener;
+}
+
+void
+metisConfiguration_SetUdpSocketsPerListener(MetisConfiguration *config, unsigned socketCount)
+{
+    assertTrue(socketCount > 0, "Parameter socketCount must be positive");
+    config->udpSocketsPerListener = socketCount;
+}
+
 MetisForwarder *
 metisConfiguration_GetForwarder(const MetisConfiguration *config)
 {
@@ -662,6 +732,20 @@ metisConfiguration_DispatchCommandOldStyle(MetisConfiguration *config, CCNxContr
     return response;
 }
 
+static CCNxControl *
+metisConfiguration_ProcessStats(MetisConfiguration *config, CCNxControl *request, unsigned ingressId)
+{
+    MetisStats stats;
+    metisForwarder_GetStats(config->metis, &stats);
+    return metisStats_CreateCPIResponse(request, &stats);
+}
+
+static CCNxControl *
+metisConfiguration_ProcessLatency(MetisConfiguration *config, CCNxControl *request, unsigned ingressId)
+{
+    return metisLatency_ProcessCPIRequest(request);
+}
+
 static CCNxControl *
 _processControl(MetisConfiguration *config, CCNxControl *request, unsigned ingressId)
 {
@@ -669,7 +753,11 @@ _processControl(MetisConfiguration *config, CCNxControl *request, unsigned ingre
 
     switch (cpi_GetMessageType(request)) {
         case CPI_REQUEST: {
-            if (cpiConnectionEthernet_IsAddMessage(request)) {
+            if (metisStats_IsCPIRequest(request)) {
+                response = metisConfiguration_ProcessStats(config, request, ingressId);
+            } else if (metisLatency_IsCPIRequest(request)) {
+                response = metisConfiguration_ProcessLatency(config, request, ingressId);
+            } else if (cpiConnectionEthernet_IsAddMessage(request)) {
                 response = metisConfiguration_ProcessAddConnectionEthernet(config, request, ingressId);
             } else if (cpiConnectionEthernet_IsRemoveMessage(request)) {
                 response = metisConfiguration_ProcessRemoveConnectionEthernet(config, request, ingressId);
@@ -204,6 +204,133 @@ size_t metisConfiguration_GetObjectStoreSize(MetisConfiguration *config);
  */
 void   metisConfiguration_SetObjectStoreSize(MetisConfiguration *config, size_t maximumContentObjectCount);
 
+/**
+ * The maximum number of bytes of content objects in the content store
+ *
+ * 0 (the default) means the content store is only limited by object count.
+ *
+ * @param [in] config An allocated MetisConfiguration
+ *
+ * @return The byte capacity of the content store, or 0
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t bytes = metisConfiguration_GetObjectStoreBytes(config);
+ * }
+ * @endcode
+ */
+size_t metisConfiguration_GetObjectStoreBytes(MetisConfiguration *config);
+
+/**
+ * Sets the size of the content store in bytes of content objects
+ *
+ * The byte limit applies in addition to the object count limit, whichever is reached first.
+ * Must be set before starting the forwarder
+ *
+ * @param [in] config An allocated MetisConfiguration
+ * @param [in] maximumContentObjectBytes The most bytes to cache, or 0 for no byte limit
+ *
+ * Example:
+ * @code
+ * {
+ *     metisConfiguration_SetObjectStoreBytes(config, 512 * 1024 * 1024);
+ * }
+ * @endcode
+ */
+void   metisConfiguration_SetObjectStoreBytes(MetisConfiguration *config, size_t maximumContentObjectBytes);
+
+/**
+ * The directory of the disk tier behind the content store
+ *
+ * @param [in] config An allocated MetisConfiguration
+ *
+ * @return The directory, or NULL if there is no disk tier
+ *
+ * Example:
+ * @code
+ * {
+ *     const char *directory = metisConfiguration_GetObjectStoreDiskDirectory(config);
+ * }
+ * @endcode
+ */
+const char *metisConfiguration_GetObjectStoreDiskDirectory(MetisConfiguration *config);
+
+/**
+ * The byte budget of the disk tier behind the content store
+ *
+ * @param [in] config An allocated MetisConfiguration
+ *
+ * @return The disk budget, 0 meaning the disk store's default
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t bytes = metisConfiguration_GetObjectStoreDiskBytes(config);
+ * }
+ * @endcode
+ */
+size_t metisConfiguration_GetObjectStoreDiskBytes(MetisConfiguration *config);
+
+/**
+ * Puts a persistent disk tier behind the content store
+ *
+ * Objects evicted from the content store are kept in memory-mapped segment files in `directory`.
+ * Segments left by an earlier run are recovered, so the cache survives a restart.
+ * Must be set before starting the forwarder
+ *
+ * @param [in] config An allocated MetisConfiguration
+ * @param [in] directory The segment directory, or NULL for no disk tier
+ * @param [in] maximumDiskBytes The disk budget, or 0 for the default
+ *
+ * Example:
+ * @code
+ * {
+ *     metisConfiguration_SetObjectStoreDisk(config, "/var/cache/metis", 4ULL * 1024 * 1024 * 1024);
+ * }
+ * @endcode
+ */
+void   metisConfiguration_SetObjectStoreDisk(MetisConfiguration *config, const char *directory, size_t maximumDiskBytes);
+
+/**
+ * The number of UDP sockets opened for each UDP listener
+ *
+ * 1 (the default) means one socket served by the forwarder's dispatcher.
+ *
+ * @param [in] config An allocated MetisConfiguration
+ *
+ * @return The number of sockets per UDP listener, at least 1
+ *
+ * Example:
+ * @code
+ * {
+ *     unsigned sockets = metisConfiguration_GetUdpSocketsPerListener(config);
+ * }
+ * @endcode
+ */
+unsigned metisConfiguration_GetUdpSocketsPerListener(MetisConfiguration *config);
+
+/**
+ * Sets the number of UDP sockets opened for each UDP listener
+ *
+ * With more than one, every UDP listener opens that many SO_REUSEPORT sockets on its address and the
+ * kernel spreads peers across them.  The first socket is served by the forwarder's dispatcher and
+ * each of the others by its own ingress thread.  Only listeners created afterwards are affected,
+ * so set it before setting up listeners.  On systems without SO_REUSEPORT the listener opens one socket.
+ *
+ * @param [in] config An allocated MetisConfiguration
+ * @param [in] socketCount The number of sockets per UDP listener, at least 1
+ *
+ * Example:
+ * @code
+ * {
+ *     metisConfiguration_SetUdpSocketsPerListener(config, 4);
+ *     metisForwarder_SetupAllListeners(metis, PORT_NUMBER, NULL);
+ * }
+ * @endcode
+ */
+void metisConfiguration_SetUdpSocketsPerListener(MetisConfiguration *config, unsigned socketCount);
+
 /**
  * Returns the MetisForwarder that owns the MetisConfiguration
  *
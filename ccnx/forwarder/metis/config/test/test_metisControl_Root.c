@@ -153,8 +153,8 @@ LONGBOW_TEST_CASE(Local, metisControl_Root_Init)
 {
     testInit(testCase, &metisControlRoot_Create, __func__,
              (const char *[]) {
-        "add", "list", "quit", "remove", "set", "unset",
-        "help add", "help list", "help quit", "help remove", "help set", "help unset",
+        "add", "latency", "list", "quit", "remove", "set", "stats", "unset",
+        "help add", "help latency", "help list", "help quit", "help remove", "help set", "help stats", "help unset",
         NULL
     });
 }
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metisControl_Stats.c"
+#include "testrig_MetisControl.c"
+#include <parc/algol/parc_SafeMemory.h>
+#include <LongBow/unit-test.h>
+
+LONGBOW_TEST_RUNNER(metisControl_Stats)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metisControl_Stats)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metisControl_Stats)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisControlStats_HelpCreate);
+    LONGBOW_RUN_TEST_CASE(Global, metisControlStats_Create);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    testrigMetisControl_commonSetup(testCase);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    testrigMetisControl_CommonTeardown(testCase);
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, metisControlStats_HelpCreate)
+{
+    testCommandCreate(testCase, &metisControlStats_HelpCreate, __func__);
+}
+
+LONGBOW_TEST_CASE(Global, metisControlStats_Create)
+{
+    testCommandCreate(testCase, &metisControlStats_Create, __func__);
+}
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, metisControl_Help_Stats_Execute);
+    LONGBOW_RUN_TEST_CASE(Local, metisControl_Stats_Execute_WrongArgCount);
+    LONGBOW_RUN_TEST_CASE(Local, metisControl_Stats_Execute_Good);
+    LONGBOW_RUN_TEST_CASE(Local, metisControl_Stats_Execute_Nack);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    testrigMetisControl_commonSetup(testCase);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    testrigMetisControl_CommonTeardown(testCase);
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Local, metisControl_Help_Stats_Execute)
+{
+    testHelpExecute(testCase, &metisControlStats_HelpCreate, __func__, MetisCommandReturn_Success);
+}
+
+static CCNxControl *
+customWriteReadResponse(void *userdata, CCNxMetaMessage *messageToWrite)
+{
+    CCNxControl *inboundControlMessage = ccnxMetaMessage_GetControl(messageToWrite);
+    assertTrue(metisStats_IsCPIRequest(inboundControlMessage), "metis_control did not send a stats request");
+
+    MetisStats stats;
+    metisStats_Init(&stats);
+    stats.values[MetisStat_InterestsReceived] = (uint64_t) UINT32_MAX + 1;
+
+    return metisStats_CreateCPIResponse(inboundControlMessage, &stats);
+}
+
+static MetisCommandReturn
+testStats(const LongBowTestCase *testCase, int argc, CCNxControl *(*writeReadReply)(void *userdata, CCNxMetaMessage *messageToWrite))
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    metisControlState_SetDebug(data->state, true);
+    data->customWriteReadReply = writeReadReply;
+
+    const char *argv[] = { "stats", "extra" };
+    PARCList *args = parcList(parcArrayList_Create(NULL), PARCArrayListAsPARCList);
+    parcList_AddAll(args, argc, (void **) &argv[0]);
+
+    MetisCommandOps *ops = metisControlStats_Create(data->state);
+
+    MetisCommandReturn result = ops->execute(data->state->parser, ops, args);
+    metisCommandOps_Destroy(&ops);
+    parcList_Release(&args);
+    return result;
+}
+
+LONGBOW_TEST_CASE(Local, metisControl_Stats_Execute_WrongArgCount)
+{
+    // argc is wrong, needs to be 1.
+    MetisCommandReturn result = testStats(testCase, 2, &customWriteReadResponse);
+
+    assertTrue(result == MetisCommandReturn_Failure,
+               "metisControl_Stats with wrong argc should return %d, got %d", MetisCommandReturn_Failure, result);
+}
+
+LONGBOW_TEST_CASE(Local, metisControl_Stats_Execute_Good)
+{
+    MetisCommandReturn result = testStats(testCase, 1, &customWriteReadResponse);
+
+    assertTrue(result == MetisCommandReturn_Success,
+               "metisControl_Stats should return %d, got %d", MetisCommandReturn_Success, result);
+}
+
+LONGBOW_TEST_CASE(Local, metisControl_Stats_Execute_Nack)
+{
+    // The testrig ACKs the request when there is no custom reply, as a forwarder without the command would NACK it
+    MetisCommandReturn result = testStats(testCase, 1, NULL);
+
+    assertTrue(result == MetisCommandReturn_Failure,
+               "metisControl_Stats without counters in the response should return %d, got %d", MetisCommandReturn_Failure, result);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metisControl_Stats);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
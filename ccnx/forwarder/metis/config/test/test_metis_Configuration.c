@@ -72,6 +72,8 @@
 #include <parc/algol/parc_SafeMemory.h>
 
 #include <signal.h>
+#include <inttypes.h>
+#include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
 
 // so we can mock up an interface
 #include "../../core/test/testrig_MetisIoOperations.h"
@@ -200,6 +202,8 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisConfiguration_SetupAllListeners);
     LONGBOW_RUN_TEST_CASE(Global, metisConfiguration_Receive);
     LONGBOW_RUN_TEST_CASE(Global, metisConfiguration_SetObjectStoreSize);
+    LONGBOW_RUN_TEST_CASE(Global, metisConfiguration_SetObjectStoreBytes);
+    LONGBOW_RUN_TEST_CASE(Global, metisConfiguration_SetUdpSocketsPerListener);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -285,6 +289,40 @@ LONGBOW_TEST_CASE(Global, metisConfiguration_SetObjectStoreSize)
     metisForwarder_Destroy(&metis);
 }
 
+LONGBOW_TEST_CASE(Global, metisConfiguration_SetObjectStoreBytes)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    metisLogger_SetLogLevel(metisForwarder_GetLogger(metis), MetisLoggerFacility_Config, PARCLogLevel_Debug);
+
+    MetisConfiguration *config = metisForwarder_GetConfiguration(metis);
+    assertTrue(metisConfiguration_GetObjectStoreBytes(config) == 0, "Default byte capacity should be 0 (unlimited)");
+
+    size_t new_bytes = 1024 * 1024;
+    metisConfiguration_SetObjectStoreBytes(config, new_bytes);
+    assertTrue(metisConfiguration_GetObjectStoreBytes(config) == new_bytes, "Configuration did not save the byte capacity");
+
+    // Get the store pointer again, as it may have changed.
+    MetisContentStoreInterface *store = metis->processor->contentStore;
+    assertTrue(new_bytes == metisContentStoreInterface_GetByteCapacity(store),
+               "Object Store is wrong byte capacity, got %zu expected %zu",
+               metisContentStoreInterface_GetByteCapacity(store), new_bytes);
+
+    metisForwarder_Destroy(&metis);
+}
+
+LONGBOW_TEST_CASE(Global, metisConfiguration_SetUdpSocketsPerListener)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisConfiguration *config = metisForwarder_GetConfiguration(metis);
+    assertTrue(metisConfiguration_GetUdpSocketsPerListener(config) == 1, "Default should be 1 socket per listener");
+
+    metisConfiguration_SetUdpSocketsPerListener(config, 4);
+    assertTrue(metisConfiguration_GetUdpSocketsPerListener(config) == 4,
+               "Wrong sockets per listener, expected 4 got %u", metisConfiguration_GetUdpSocketsPerListener(config));
+
+    metisForwarder_Destroy(&metis);
+}
+
 // ==============================================================================
 
 LONGBOW_TEST_FIXTURE(Local)
@@ -302,6 +340,8 @@ LONGBOW_TEST_FIXTURE(Local)
     LONGBOW_RUN_TEST_CASE(Local, metisConfiguration_ProcessCreateTunnel_TCP);
     LONGBOW_RUN_TEST_CASE(Local, metisConfiguration_ProcessCreateTunnel_UDP);
     LONGBOW_RUN_TEST_CASE(Local, metisConfiguration_ProcessConnectionList);
+    LONGBOW_RUN_TEST_CASE(Local, metisConfiguration_ProcessStats);
+    LONGBOW_RUN_TEST_CASE(Local, metisConfiguration_ProcessLatency);
 
     LONGBOW_RUN_TEST_CASE(Local, metisConfiguration_ProcessAddConnectionEthernet);
     LONGBOW_RUN_TEST_CASE(Local, metisConfiguration_ProcessRemoveConnectionEthernet);
@@ -642,6 +682,76 @@ LONGBOW_TEST_CASE(Local, metisConfiguration_ProcessConnectionList)
 }
 
 
+LONGBOW_TEST_CASE(Local, metisConfiguration_ProcessStats)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+
+    // an interest with no route is counted as received and dropped
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger);
+    metisForwarder_Receive(metis, interest);
+
+    CCNxControl *request = metisStats_CreateCPIRequest();
+    CCNxControl *response = metisConfiguration_ReceiveControl(metisForwarder_GetConfiguration(metis), request, 7);
+
+    MetisStats stats;
+    bool success = metisStats_FromCPIResponse(&stats, response);
+    CPIMessageType type = cpi_GetMessageType(response);
+
+    ccnxControl_Release(&response);
+    ccnxControl_Release(&request);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(type == CPI_RESPONSE, "Wrong message type, expected CPI_RESPONSE got %d", type);
+    assertTrue(success, "Response did not carry the stats");
+    assertTrue(stats.values[MetisStat_InterestsReceived] == 1,
+               "Wrong interestsReceived, expected 1 got %" PRIu64, stats.values[MetisStat_InterestsReceived]);
+    assertTrue(stats.values[MetisStat_DroppedNoRoute] == 1,
+               "Wrong droppedNoRoute, expected 1 got %" PRIu64, stats.values[MetisStat_DroppedNoRoute]);
+}
+
+LONGBOW_TEST_CASE(Local, metisConfiguration_ProcessLatency)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+    MetisConfiguration *config = metisForwarder_GetConfiguration(metis);
+
+    // turn on sampling of every stage
+    CCNxControl *request = metisLatency_CreateCPIRequest(true, 1);
+    CCNxControl *response = metisConfiguration_ReceiveControl(config, request, 7);
+    ccnxControl_Release(&response);
+    ccnxControl_Release(&request);
+
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger);
+    metisForwarder_Receive(metis, interest);
+
+    request = metisLatency_CreateCPIRequest(false, 0);
+    response = metisConfiguration_ReceiveControl(config, request, 7);
+
+    CPIMessageType type = cpi_GetMessageType(response);
+    PARCJSON *summary = metisLatency_GetCPIResponse(response);
+    assertNotNull(summary, "Response did not carry the latency summary");
+
+    int64_t interval = parcJSONValue_GetInteger(parcJSON_GetValueByName(summary, "SAMPLE_INTERVAL"));
+    PARCJSON *pit = parcJSONValue_GetJSON(parcJSON_GetValueByName(summary, "pit"));
+    int64_t pitCount = parcJSONValue_GetInteger(parcJSON_GetValueByName(pit, "count"));
+    PARCJSON *parse = parcJSONValue_GetJSON(parcJSON_GetValueByName(summary, "parse"));
+    int64_t parseCount = parcJSONValue_GetInteger(parcJSON_GetValueByName(parse, "count"));
+
+    ccnxControl_Release(&response);
+    ccnxControl_Release(&request);
+    metisForwarder_Destroy(&metis);
+
+    metisLatency_SetSampleInterval(0);
+    metisLatency_Reset();
+    metisLatency_Drain();
+
+    assertTrue(type == CPI_RESPONSE, "Wrong message type, expected CPI_RESPONSE got %d", type);
+    assertTrue(interval == 1, "Wrong sample interval, expected 1 got %" PRId64, interval);
+    assertTrue(pitCount == 1, "Wrong pit count, expected 1 got %" PRId64, pitCount);
+    assertTrue(parseCount == 1, "Wrong parse count, expected 1 got %" PRId64, parseCount);
+}
+
 LONGBOW_TEST_CASE(Local, metisConfiguration_ProcessAddConnectionEthernet)
 {
     MetisForwarder *metis = metisForwarder_Create(NULL);
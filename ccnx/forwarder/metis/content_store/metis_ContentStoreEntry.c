@@ -78,6 +78,13 @@ struct metis_contentstore_entry {
 
     bool hasExpiryTimeTicks;
     uint64_t expiryTimeTicks;
+
+    // metisMessage_Length() when the entry was created, so we account the same bytes on removal
+    size_t byteCount;
+
+    // set by the store that holds the entry
+    uint64_t sequence;
+    struct metis_contentstore_entry *nextWithSameName;
 };
 
 MetisContentStoreEntry *
@@ -89,6 +96,7 @@ metisContentStoreEntry_Create(MetisMessage *contentMessage, MetisLruList *lruLis
     assertNotNull(entry, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisContentStoreEntry));
     entry->message = metisMessage_Acquire(contentMessage);
     entry->refcount = 1;
+    entry->byteCount = metisMessage_Length(contentMessage);
     if (lruList != NULL) {
         entry->lruEntry = metisLruList_NewHeadEntry(lruList, entry);
     }
@@ -142,6 +150,13 @@ metisContentStoreEntry_GetMessage(const MetisContentStoreEntry *storeEntry)
     return storeEntry->message;
 }
 
+size_t
+metisContentStoreEntry_GetByteCount(const MetisContentStoreEntry *storeEntry)
+{
+    assertNotNull(storeEntry, "Parameter must be non-null");
+    return storeEntry->byteCount;
+}
+
 bool
 metisContentStoreEntry_HasExpiryTimeTicks(const MetisContentStoreEntry *storeEntry)
 {
@@ -233,3 +248,49 @@ metisContentStoreEntry_MoveToHead(MetisContentStoreEntry *storeEntry)
         metisLruList_EntryMoveToHead(storeEntry->lruEntry);
     }
 }
+
+void
+metisContentStoreEntry_MoveToHeadOf(MetisContentStoreEntry *storeEntry, MetisLruList *lruList)
+{
+    assertNotNull(storeEntry, "Parameter must be non-null");
+    assertNotNull(storeEntry->lruEntry, "MetisContentStoreEntry is not attached to an LRUList");
+    metisLruList_EntryMoveToHeadOf(storeEntry->lruEntry, lruList);
+}
+
+MetisLruList *
+metisContentStoreEntry_GetLruList(const MetisContentStoreEntry *storeEntry)
+{
+    assertNotNull(storeEntry, "Parameter must be non-null");
+    if (storeEntry->lruEntry == NULL) {
+        return NULL;
+    }
+    return metisLruList_EntryGetList(storeEntry->lruEntry);
+}
+
+void
+metisContentStoreEntry_SetSequence(MetisContentStoreEntry *storeEntry, uint64_t sequence)
+{
+    assertNotNull(storeEntry, "Parameter must be non-null");
+    storeEntry->sequence = sequence;
+}
+
+uint64_t
+metisContentStoreEntry_GetSequence(const MetisContentStoreEntry *storeEntry)
+{
+    assertNotNull(storeEntry, "Parameter must be non-null");
+    return storeEntry->sequence;
+}
+
+void
+metisContentStoreEntry_SetNextWithSameName(MetisContentStoreEntry *storeEntry, MetisContentStoreEntry *next)
+{
+    assertNotNull(storeEntry, "Parameter must be non-null");
+    storeEntry->nextWithSameName = next;
+}
+
+MetisContentStoreEntry *
+metisContentStoreEntry_GetNextWithSameName(const MetisContentStoreEntry *storeEntry)
+{
+    assertNotNull(storeEntry, "Parameter must be non-null");
+    return storeEntry->nextWithSameName;
+}
@@ -122,6 +122,16 @@ void metisContentStoreEntry_Release(MetisContentStoreEntry **entryPtr);
  */
 MetisMessage *metisContentStoreEntry_GetMessage(const MetisContentStoreEntry *storeEntry);
 
+/**
+ * Return the number of bytes the stored message takes, as used for the ContentStore byte budget.
+ *
+ * This is the metisMessage_Length() of the message when the entry was created.
+ *
+ * @param storeEntry the MetisContentStoreEntry containing the message.
+ * @return the length of the stored message in bytes.
+ */
+size_t metisContentStoreEntry_GetByteCount(const MetisContentStoreEntry *storeEntry);
+
 /**
  * Return true if the message stored in this `MetisContentStoreEntry` has an ExpiryTime.
  *
@@ -253,4 +263,89 @@ int metisContentStoreEntry_CompareExpiryTime(const MetisContentStoreEntry *store
  * @endcode
  */
 void metisContentStoreEntry_MoveToHead(MetisContentStoreEntry *storeEntry);
+
+/**
+ * Moves the entry to the head of another LRU list, which it is bound to from then on
+ *
+ * @param [in] storeEntry An allocated MetisContentStoreEntry attached to an LRU list
+ * @param [in] lruList The list to move it to
+ *
+ * Example:
+ * @code
+ * {
+ *     metisContentStoreEntry_MoveToHeadOf(storeEntry, protected);
+ * }
+ * @endcode
+ */
+void metisContentStoreEntry_MoveToHeadOf(MetisContentStoreEntry *storeEntry, MetisLruList *lruList);
+
+/**
+ * Returns the LRU list the entry is in
+ *
+ * @param [in] storeEntry An allocated MetisContentStoreEntry
+ *
+ * @return null The entry was created without a list
+ * @return non-null The list it was created with or last moved to
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+MetisLruList *metisContentStoreEntry_GetLruList(const MetisContentStoreEntry *storeEntry);
+
+/**
+ * Sets the sequence number a store gave this entry when it stored it
+ *
+ * @param [in] storeEntry An allocated MetisContentStoreEntry
+ * @param [in] sequence A number unique within the store
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+void metisContentStoreEntry_SetSequence(MetisContentStoreEntry *storeEntry, uint64_t sequence);
+
+/**
+ * Returns the sequence number set with metisContentStoreEntry_SetSequence(), 0 if none
+ *
+ * @param [in] storeEntry An allocated MetisContentStoreEntry
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+uint64_t metisContentStoreEntry_GetSequence(const MetisContentStoreEntry *storeEntry);
+
+/**
+ * Links the entry to the next stored entry with the same name
+ *
+ * A store indexes only the first entry with a name.  Objects with the same name but different
+ * contents are chained behind it.  The chain does not hold references.
+ *
+ * @param [in] storeEntry An allocated MetisContentStoreEntry
+ * @param [in] next The next entry with the same name, or NULL
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+void metisContentStoreEntry_SetNextWithSameName(MetisContentStoreEntry *storeEntry, MetisContentStoreEntry *next);
+
+/**
+ * Returns the next entry with the same name, see metisContentStoreEntry_SetNextWithSameName()
+ *
+ * @param [in] storeEntry An allocated MetisContentStoreEntry
+ *
+ * @return null There are no more entries with the name
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+MetisContentStoreEntry *metisContentStoreEntry_GetNextWithSameName(const MetisContentStoreEntry *storeEntry);
 #endif // Metis_metis_ContentStoreEntry_h
@@ -0,0 +1,625 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * The tables the LRU and TinyLFU stores share.  Each store keeps its own LRU lists and eviction
+ * order and calls in to here for everything else.
+ *
+ * @author Marc Mosko, Alan Walendowski, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <ccnx/forwarder/metis/content_store/metis_ContentStoreIndex.h>
+
+#include <ccnx/forwarder/metis/processor/metis_HashTableFunction.h>
+
+#include <LongBow/runtime.h>
+
+static void
+_hashTableFunction_ContentStoreEntryDestroyer(void **dataPtr)
+{
+    metisContentStoreEntry_Release((MetisContentStoreEntry **) dataPtr);
+}
+
+static bool
+_hashTableFunction_ContentStoreEntrySequenceEquals(const void *entryA, const void *entryB)
+{
+    return metisContentStoreEntry_GetSequence(entryA) == metisContentStoreEntry_GetSequence(entryB);
+}
+
+static HashCodeType
+_hashTableFunction_ContentStoreEntryNameHashAndSequence(const void *entryVoid)
+{
+    const MetisContentStoreEntry *entry = entryVoid;
+    HashCodeType nameHash = metisHashTableFunction_MessageNameHashCode(metisContentStoreEntry_GetMessage(entry));
+
+    // spread the sequence number over the word, so objects with the same name land in different buckets
+    return nameHash ^ (HashCodeType) (metisContentStoreEntry_GetSequence(entry) * 0x9E3779B97F4A7C15ULL);
+}
+
+bool
+metisContentStoreIndex_Init(MetisContentStoreIndex *index, const char *name, MetisContentStoreConfig *config, MetisLogger *logger)
+{
+    assertNotNull(index, "Parameter index must be non-null");
+    assertNotNull(config, "Parameter config must be non-null");
+    assertNotNull(logger, "Parameter logger must be non-null");
+
+    memset(index, 0, sizeof(MetisContentStoreIndex));
+
+    index->name = name;
+    index->logger = metisLogger_Acquire(logger);
+
+    index->objectCapacity = config->objectCapacity;
+    index->byteCapacity = config->byteCapacity;
+
+    if (config->secondTier) {
+        index->secondTier = metisContentStoreInterface_Aquire(config->secondTier);
+    }
+
+    // initial size must be at least 1 or else the data structures break.
+    size_t initialSize = config->objectCapacity * 2;
+    initialSize = (initialSize == 0) ? 1 : initialSize;
+
+    index->indexByExpirationTime =
+        metisTimeOrderedList_Create((MetisTimeOrderList_KeyCompare *) metisContentStoreEntry_CompareExpiryTime);
+
+    index->indexByRecommendedCacheTime =
+        metisTimeOrderedList_Create((MetisTimeOrderList_KeyCompare *) metisContentStoreEntry_CompareRecommendedCacheTime);
+
+    index->indexByNameHash = parcHashCodeTable_Create_Size(metisHashTableFunction_MessageNameEquals,
+                                                           metisHashTableFunction_MessageNameHashCode,
+                                                           NULL,
+                                                           NULL,
+                                                           initialSize);
+
+    index->indexByNameAndKeyIdHash = parcHashCodeTable_Create_Size(metisHashTableFunction_MessageNameAndKeyIdEquals,
+                                                                   metisHashTableFunction_MessageNameAndKeyIdHashCode,
+                                                                   NULL,
+                                                                   NULL,
+                                                                   initialSize);
+
+    index->storageByNameHashAndSequence = parcHashCodeTable_Create_Size(_hashTableFunction_ContentStoreEntrySequenceEquals,
+                                                                        _hashTableFunction_ContentStoreEntryNameHashAndSequence,
+                                                                        NULL,
+                                                                        _hashTableFunction_ContentStoreEntryDestroyer,
+                                                                        initialSize);
+    index->nextSequence = 1;
+
+    // If any of the index tables couldn't be allocated, we can't continue.
+    if ((index->indexByExpirationTime == NULL)
+        || (index->indexByNameAndKeyIdHash == NULL)
+        || (index->indexByNameHash == NULL)
+        || (index->indexByRecommendedCacheTime == NULL)
+        || (index->storageByNameHashAndSequence == NULL)) {
+        if (metisLogger_IsLoggable(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error)) {
+            metisLogger_Log(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error, __func__,
+                            "%s %p could not be created. Could not allocate all index tables.",
+                            index->name, (void *) index);
+        }
+
+        metisContentStoreIndex_Destroy(index);
+        return false;
+    }
+    return true;
+}
+
+void
+metisContentStoreIndex_Destroy(MetisContentStoreIndex *index)
+{
+    assertNotNull(index, "Parameter index must be non-null");
+
+    if (index->indexByNameHash != NULL) {
+        parcHashCodeTable_Destroy(&(index->indexByNameHash));
+    }
+
+    if (index->indexByNameAndKeyIdHash != NULL) {
+        parcHashCodeTable_Destroy(&(index->indexByNameAndKeyIdHash));
+    }
+
+    if (index->indexByRecommendedCacheTime != NULL) {
+        metisTimeOrderedList_Release(&(index->indexByRecommendedCacheTime));
+    }
+
+    if (index->indexByExpirationTime != NULL) {
+        metisTimeOrderedList_Release(&(index->indexByExpirationTime));
+    }
+
+    // This table must go last. It holds the references to the entries.
+    if (index->storageByNameHashAndSequence != NULL) {
+        parcHashCodeTable_Destroy(&(index->storageByNameHashAndSequence));
+    }
+
+    index->objectCount = 0;
+    index->byteCount = 0;
+
+    if (index->secondTier != NULL) {
+        metisContentStoreInterface_Release(&index->secondTier);
+    }
+
+    if (index->logger != NULL) {
+        metisLogger_Release(&index->logger);
+    }
+}
+
+bool
+metisContentStoreIndex_CanStore(MetisContentStoreIndex *index, MetisMessage *content, uint64_t currentTimeTicks)
+{
+    assertNotNull(index, "Parameter index must be non-null");
+    assertNotNull(content, "Parameter objectMessage must be non-null");
+
+    assertTrue(metisMessage_GetType(content) == MetisMessagePacketType_ContentObject,
+               "Parameter objectMessage must be a Content Object");
+
+    if (index->objectCapacity == 0) {
+        return false;
+    }
+
+    // An object bigger than the whole byte budget would only empty the store
+    if (index->byteCapacity > 0 && metisMessage_Length(content) > index->byteCapacity) {
+        return false;
+    }
+
+    uint64_t expiryTimeTicks = metisContentStoreEntry_MaxExpiryTime;
+    uint64_t recommendedCacheTimeTicks = metisContentStoreEntry_MaxRecommendedCacheTime;
+
+    if (metisMessage_HasExpiryTime(content)) {
+        expiryTimeTicks = metisMessage_GetExpiryTimeTicks(content);
+    }
+
+    if (metisMessage_HasRecommendedCacheTime(content)) {
+        recommendedCacheTimeTicks = metisMessage_GetRecommendedCacheTimeTicks(content);
+    }
+
+    // Don't add anything that's already expired or has exceeded RCT.
+    if (currentTimeTicks >= expiryTimeTicks || currentTimeTicks >= recommendedCacheTimeTicks) {
+        return false;
+    }
+
+    if (metisContentStoreIndex_FindObject(index, content) != NULL) {
+        if (metisLogger_IsLoggable(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+            metisLogger_Log(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                            "%s %p already has message %p",
+                            index->name, (void *) index, (void *) content);
+        }
+        return false;
+    }
+
+    return true;
+}
+
+bool
+metisContentStoreIndex_NeedsRoom(const MetisContentStoreIndex *index, size_t contentBytes)
+{
+    if (index->objectCount == 0) {
+        return false;
+    }
+
+    if (index->objectCount >= index->objectCapacity) {
+        return true;
+    }
+
+    return index->byteCapacity > 0 && index->byteCount + contentBytes > index->byteCapacity;
+}
+
+bool
+metisContentStoreIndex_IsOverCapacity(const MetisContentStoreIndex *index)
+{
+    return index->objectCount > index->objectCapacity
+           || (index->byteCapacity > 0 && index->byteCount > index->byteCapacity);
+}
+
+/**
+ * Adds an entry to the name index.  If there is already an entry with the name, the new one is chained
+ * behind it, so a lookup by name keeps finding the first object.
+ */
+static void
+_metisContentStoreIndex_AddToNameIndex(MetisContentStoreIndex *index, MetisContentStoreEntry *entry)
+{
+    MetisMessage *content = metisContentStoreEntry_GetMessage(entry);
+    MetisContentStoreEntry *first = parcHashCodeTable_Get(index->indexByNameHash, content);
+    if (first == NULL) {
+        parcHashCodeTable_Add(index->indexByNameHash, content, entry);
+    } else {
+        metisContentStoreEntry_SetNextWithSameName(entry, metisContentStoreEntry_GetNextWithSameName(first));
+        metisContentStoreEntry_SetNextWithSameName(first, entry);
+    }
+}
+
+static void
+_metisContentStoreIndex_RemoveFromNameIndex(MetisContentStoreIndex *index, MetisContentStoreEntry *entry)
+{
+    MetisMessage *content = metisContentStoreEntry_GetMessage(entry);
+    MetisContentStoreEntry *first = parcHashCodeTable_Get(index->indexByNameHash, content);
+    MetisContentStoreEntry *next = metisContentStoreEntry_GetNextWithSameName(entry);
+
+    if (first == entry) {
+        parcHashCodeTable_Del(index->indexByNameHash, content);
+        if (next != NULL) {
+            parcHashCodeTable_Add(index->indexByNameHash, metisContentStoreEntry_GetMessage(next), next);
+        }
+    } else {
+        MetisContentStoreEntry *previous = first;
+        while (previous != NULL && metisContentStoreEntry_GetNextWithSameName(previous) != entry) {
+            previous = metisContentStoreEntry_GetNextWithSameName(previous);
+        }
+        if (previous != NULL) {
+            metisContentStoreEntry_SetNextWithSameName(previous, next);
+        }
+    }
+    metisContentStoreEntry_SetNextWithSameName(entry, NULL);
+}
+
+/**
+ * Removes an entry from the name and KeyId index.  Call after removing it from the name index.
+ *
+ * Only the first entry with a name and KeyId is in the index, so if that is the one going away,
+ * the next entry on the name chain with the same KeyId takes its place.
+ */
+static void
+_metisContentStoreIndex_RemoveFromKeyIdIndex(MetisContentStoreIndex *index, MetisContentStoreEntry *entry)
+{
+    MetisMessage *content = metisContentStoreEntry_GetMessage(entry);
+    if (!metisMessage_HasKeyId(content) || parcHashCodeTable_Get(index->indexByNameAndKeyIdHash, content) != entry) {
+        return;
+    }
+
+    parcHashCodeTable_Del(index->indexByNameAndKeyIdHash, content);
+
+    MetisContentStoreEntry *other = parcHashCodeTable_Get(index->indexByNameHash, content);
+    while (other != NULL) {
+        MetisMessage *otherContent = metisContentStoreEntry_GetMessage(other);
+        if (metisHashTableFunction_MessageNameAndKeyIdEquals(content, otherContent)) {
+            parcHashCodeTable_Add(index->indexByNameAndKeyIdHash, otherContent, other);
+            return;
+        }
+        other = metisContentStoreEntry_GetNextWithSameName(other);
+    }
+}
+
+MetisContentStoreEntry *
+metisContentStoreIndex_Add(MetisContentStoreIndex *index, MetisMessage *content, MetisLruList *lruList)
+{
+    assertNotNull(index, "Parameter index must be non-null");
+    assertNotNull(content, "Parameter content must be non-null");
+
+    MetisContentStoreEntry *entry = metisContentStoreEntry_Create(content, lruList);
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    metisContentStoreEntry_SetSequence(entry, index->nextSequence++);
+
+    if (!parcHashCodeTable_Add(index->storageByNameHashAndSequence, entry, entry)) {
+        // Free what we just created, but did not add.  The entry releases its reference to content.
+        metisContentStoreEntry_Release(&entry);
+
+        if (metisLogger_IsLoggable(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Warning)) {
+            metisLogger_Log(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Warning, __func__,
+                            "%s %p failed to add message %p to hash table",
+                            index->name, (void *) index, (void *) content);
+        }
+        return NULL;
+    }
+
+    _metisContentStoreIndex_AddToNameIndex(index, entry);
+
+    // Only the first entry with a name and KeyId goes in, a later one fails to add
+    if (metisMessage_HasKeyId(content)) {
+        parcHashCodeTable_Add(index->indexByNameAndKeyIdHash, content, entry);
+    }
+
+    if (metisContentStoreEntry_HasExpiryTimeTicks(entry)) {
+        metisTimeOrderedList_Add(index->indexByExpirationTime, entry);
+    }
+
+    if (metisContentStoreEntry_HasRecommendedCacheTimeTicks(entry)) {
+        metisTimeOrderedList_Add(index->indexByRecommendedCacheTime, entry);
+    }
+
+    index->objectCount++;
+    index->byteCount += metisContentStoreEntry_GetByteCount(entry);
+    metisStats_Increment(index->stats.countAdds);
+
+    if (metisLogger_IsLoggable(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+        metisLogger_Log(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                        "%s %p saved message %p (object count %zu, byte count %zu)",
+                        index->name, (void *) index, (void *) content, index->objectCount, index->byteCount);
+    }
+
+    return entry;
+}
+
+/**
+ * Finds the entry whose ContentObjectHash matches the message's, among the entries with its name
+ *
+ * `message` is an interest with a ContentObjectHash restriction or a content object.  This is the
+ * only place the store computes a stored object's hash, and the object keeps it for next time.
+ */
+static MetisContentStoreEntry *
+_metisContentStoreIndex_FindByObjectHash(MetisContentStoreIndex *index, MetisMessage *message)
+{
+    MetisContentStoreEntry *entry = parcHashCodeTable_Get(index->indexByNameHash, message);
+    while (entry != NULL && !metisMessage_ObjectHashEquals(metisContentStoreEntry_GetMessage(entry), message)) {
+        entry = metisContentStoreEntry_GetNextWithSameName(entry);
+    }
+    return entry;
+}
+
+/**
+ * True if the two content objects have the same bytes, which means they have the same ContentObjectHash
+ */
+static bool
+_metisContentStoreIndex_SameBytes(const MetisMessage *a, const MetisMessage *b)
+{
+    if (a == b) {
+        return true;
+    }
+    size_t length = metisMessage_Length(a);
+    return length == metisMessage_Length(b)
+           && memcmp(metisMessage_FixedHeader(a), metisMessage_FixedHeader(b), length) == 0;
+}
+
+MetisContentStoreEntry *
+metisContentStoreIndex_FindObject(MetisContentStoreIndex *index, MetisMessage *content)
+{
+    MetisContentStoreEntry *first = parcHashCodeTable_Get(index->indexByNameHash, content);
+    if (first == NULL) {
+        return NULL;
+    }
+
+    for (MetisContentStoreEntry *entry = first; entry != NULL; entry = metisContentStoreEntry_GetNextWithSameName(entry)) {
+        if (_metisContentStoreIndex_SameBytes(metisContentStoreEntry_GetMessage(entry), content)) {
+            return entry;
+        }
+    }
+
+    return _metisContentStoreIndex_FindByObjectHash(index, content);
+}
+
+MetisContentStoreEntry *
+metisContentStoreIndex_MatchInterest(MetisContentStoreIndex *index, MetisMessage *interest)
+{
+    assertNotNull(index, "Parameter index must be non-null");
+    assertNotNull(interest, "Parameter interestMessage must be non-null");
+    assertTrue(metisMessage_GetType(interest) == MetisMessagePacketType_Interest,
+               "Parameter interestMessage must be an Interest");
+
+    if (metisMessage_HasContentObjectHash(interest)) {
+        return _metisContentStoreIndex_FindByObjectHash(index, interest);
+    }
+    if (metisMessage_HasKeyId(interest)) {
+        return parcHashCodeTable_Get(index->indexByNameAndKeyIdHash, interest);
+    }
+    return parcHashCodeTable_Get(index->indexByNameHash, interest);
+}
+
+void
+metisContentStoreIndex_Purge(MetisContentStoreIndex *index, MetisContentStoreEntry *entry)
+{
+    if (metisContentStoreEntry_HasExpiryTimeTicks(entry)) {
+        metisTimeOrderedList_Remove(index->indexByExpirationTime, entry);
+    }
+
+    if (metisContentStoreEntry_HasRecommendedCacheTimeTicks(entry)) {
+        metisTimeOrderedList_Remove(index->indexByRecommendedCacheTime, entry);
+    }
+
+    // read it now, the entry may be destroyed below
+    size_t byteCount = metisContentStoreEntry_GetByteCount(entry);
+
+    _metisContentStoreIndex_RemoveFromNameIndex(index, entry);
+    _metisContentStoreIndex_RemoveFromKeyIdIndex(index, entry);
+
+    // This _Del call will call the Release/Destroy on the ContentStoreEntry,
+    // which will remove it from its LRU list as well.
+    parcHashCodeTable_Del(index->storageByNameHashAndSequence, entry);
+
+    index->objectCount--;
+    index->byteCount -= byteCount;
+}
+
+bool
+metisContentStoreIndex_Remove(MetisContentStoreIndex *index, MetisMessage *content)
+{
+    MetisContentStoreEntry *entry = metisContentStoreIndex_FindObject(index, content);
+    if (entry != NULL) {
+        metisContentStoreIndex_Purge(index, entry);
+        return true;
+    }
+
+    if (index->secondTier) {
+        return metisContentStoreInterface_RemoveContent(index->secondTier, content);
+    }
+    return false;
+}
+
+bool
+metisContentStoreIndex_EvictStale(MetisContentStoreIndex *index, uint64_t currentTimeTicks)
+{
+    MetisContentStoreEntry *entry = metisTimeOrderedList_GetOldest(index->indexByExpirationTime);
+    if (entry
+        && metisContentStoreEntry_HasExpiryTimeTicks(entry)
+        && (currentTimeTicks > metisContentStoreEntry_GetExpiryTimeTicks(entry))) {
+        metisStats_Increment(index->stats.countExpiryEvictions);
+        if (metisLogger_IsLoggable(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+            metisLogger_Log(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                            "ContentStore %p evict message %p by ExpiryTime (ExpiryTime evictions %" PRIu64 ")",
+                            (void *) index, (void *) metisContentStoreEntry_GetMessage(entry),
+                            index->stats.countExpiryEvictions);
+        }
+        metisContentStoreIndex_Purge(index, entry);
+        return true;
+    }
+
+    entry = metisTimeOrderedList_GetOldest(index->indexByRecommendedCacheTime);
+    if (entry
+        && metisContentStoreEntry_HasRecommendedCacheTimeTicks(entry)
+        && (currentTimeTicks > metisContentStoreEntry_GetRecommendedCacheTimeTicks(entry))) {
+        metisStats_Increment(index->stats.countRCTEvictions);
+        if (metisLogger_IsLoggable(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+            metisLogger_Log(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                            "ContentStore %p evict message %p by RCT (RCT evictions %" PRIu64 ")",
+                            (void *) index, (void *) metisContentStoreEntry_GetMessage(entry),
+                            index->stats.countRCTEvictions);
+        }
+        metisContentStoreIndex_Purge(index, entry);
+        return true;
+    }
+
+    return false;
+}
+
+void
+metisContentStoreIndex_Evict(MetisContentStoreIndex *index, MetisContentStoreEntry *entry, uint64_t currentTimeTicks)
+{
+    assertNotNull(entry, "Parameter entry must be non-null");
+
+    if (metisLogger_IsLoggable(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+        metisLogger_Log(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                        "ContentStore %p evict message %p by LRU (LRU evictions %" PRIu64 ")",
+                        (void *) index, (void *) metisContentStoreEntry_GetMessage(entry),
+                        index->stats.countLruEvictions);
+    }
+
+    if (index->secondTier) {
+        if (metisContentStoreInterface_PutContent(index->secondTier, metisContentStoreEntry_GetMessage(entry), currentTimeTicks)) {
+            metisStats_Increment(index->stats.countDemotions);
+        }
+    }
+
+    metisContentStoreIndex_Purge(index, entry);
+}
+
+MetisMessage *
+metisContentStoreIndex_Promote(MetisContentStoreIndex *index, MetisMessage *interest,
+                               MetisContentStoreIndex_PutFunction *put, void *context)
+{
+    assertNotNull(index->secondTier, "Promote requires a second tier");
+
+    MetisMessage *content = metisContentStoreInterface_MatchInterest(index->secondTier, interest);
+    if (content == NULL) {
+        return NULL;
+    }
+
+    // Hold the match while the put demotes objects to the second tier.  Only take it out of the second
+    // tier once this store has it, a put that fails leaves it where it was.
+    content = metisMessage_Acquire(content);
+    if (put(context, content, metisMessage_GetReceiveTime(interest))) {
+        metisContentStoreInterface_RemoveContent(index->secondTier, content);
+        metisStats_Increment(index->stats.countPromotions);
+    }
+
+    // Either our store entry or the second tier still holds a reference
+    MetisMessage *result = content;
+    metisMessage_Release(&content);
+
+    return result;
+}
+
+void
+metisContentStoreIndex_CountLookup(MetisContentStoreIndex *index, MetisMessage *interest, MetisMessage *result)
+{
+    if (result) {
+        metisStats_Increment(index->stats.countHits);
+
+        if (metisLogger_IsLoggable(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+            metisLogger_Log(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                            "%s %p matched interest %p (hits %" PRIu64 ", misses %" PRIu64 ")",
+                            index->name, (void *) index, (void *) interest, index->stats.countHits, index->stats.countMisses);
+        }
+    } else {
+        metisStats_Increment(index->stats.countMisses);
+
+        if (metisLogger_IsLoggable(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+            metisLogger_Log(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                            "%s %p missed interest %p (hits %" PRIu64 ", misses %" PRIu64 ")",
+                            index->name, (void *) index, (void *) interest, index->stats.countHits, index->stats.countMisses);
+        }
+    }
+}
+
+void
+metisContentStoreIndex_AccumulateStats(const MetisContentStoreIndex *index, MetisStats *stats)
+{
+    stats->values[MetisStat_ContentStoreAdds] += metisStats_Read(index->stats.countAdds);
+    stats->values[MetisStat_ContentStoreHits] += metisStats_Read(index->stats.countHits);
+    stats->values[MetisStat_ContentStoreMisses] += metisStats_Read(index->stats.countMisses);
+    stats->values[MetisStat_ContentStoreLruEvictions] += metisStats_Read(index->stats.countLruEvictions);
+    stats->values[MetisStat_ContentStoreExpiryEvictions] += metisStats_Read(index->stats.countExpiryEvictions);
+    stats->values[MetisStat_ContentStoreRctEvictions] += metisStats_Read(index->stats.countRCTEvictions);
+    stats->values[MetisStat_ContentStoreDemotions] += metisStats_Read(index->stats.countDemotions);
+    stats->values[MetisStat_ContentStorePromotions] += metisStats_Read(index->stats.countPromotions);
+
+    if (index->secondTier) {
+        metisContentStoreInterface_AccumulateStats(index->secondTier, stats);
+    }
+}
+
+void
+metisContentStoreIndex_SetCapacity(MetisContentStoreIndex *index, size_t objectCapacity, size_t byteCapacity)
+{
+    index->objectCapacity = objectCapacity;
+    index->byteCapacity = byteCapacity;
+
+    if (metisLogger_IsLoggable(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Info)) {
+        metisLogger_Log(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_Info, __func__,
+                        "%s %p capacity %zu, byte capacity %zu (object count %zu, byte count %zu)",
+                        index->name, (void *) index, index->objectCapacity, index->byteCapacity, index->objectCount, index->byteCount);
+    }
+}
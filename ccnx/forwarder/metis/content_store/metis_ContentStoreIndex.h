@@ -0,0 +1,461 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_ContentStoreIndex.h
+ * @brief The tables and bookkeeping shared by the in-memory content stores
+ *
+ * The LRU and TinyLFU stores keep their objects the same way and differ only in which object they
+ * evict and whether they take a new one.  A MetisContentStoreIndex holds the common part:
+ *
+ * - storageByNameHashAndSequence owns the MetisContentStoreEntries.  It is keyed by name hash and a
+ *   sequence number, so storing an object does not compute its ContentObjectHash.
+ * - indexByNameHash holds the first entry with a name.  The others are chained behind it with
+ *   metisContentStoreEntry_SetNextWithSameName().
+ * - indexByNameAndKeyIdHash holds the first entry with a name and KeyId.
+ * - indexByExpirationTime and indexByRecommendedCacheTime keep the entries in time order.
+ * - The object and byte counts and limits, the optional second tier, and the counters the stores
+ *   have in common.
+ *
+ * The store owns the LRU lists.  Each entry is created on one of them and releasing the entry takes
+ * it off, so the lists must outlive the index.
+ *
+ * Like MetisTlvSkeleton, the struct is in the header so a store can embed it.  Only the stores
+ * in this directory should use it, and they may read the fields directly.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_ContentStoreIndex_h
+#define Metis_metis_ContentStoreIndex_h
+
+#include <parc/algol/parc_HashCodeTable.h>
+
+#include <ccnx/forwarder/metis/core/metis_Logger.h>
+#include <ccnx/forwarder/metis/core/metis_Message.h>
+#include <ccnx/forwarder/metis/core/metis_Stats.h>
+#include <ccnx/forwarder/metis/content_store/metis_ContentStoreInterface.h>
+#include <ccnx/forwarder/metis/content_store/metis_ContentStoreEntry.h>
+#include <ccnx/forwarder/metis/content_store/metis_LruList.h>
+#include <ccnx/forwarder/metis/content_store/metis_TimeOrderedList.h>
+
+/**
+ * The counters every in-memory store keeps.  Written only by the thread that owns the store.
+ */
+typedef struct metis_contentstore_index_stats {
+    uint64_t countExpiryEvictions;
+    uint64_t countRCTEvictions;
+    uint64_t countLruEvictions;
+    uint64_t countAdds;
+    uint64_t countHits;
+    uint64_t countMisses;
+    uint64_t countDemotions;
+    uint64_t countPromotions;
+} MetisContentStoreIndexStats;
+
+typedef struct metis_contentstore_index {
+    // The store's name in log messages, e.g. "LRUContentStore"
+    const char *name;
+
+    size_t objectCapacity;
+    size_t objectCount;
+
+    // 0 means no byte limit
+    size_t byteCapacity;
+    size_t byteCount;
+
+    MetisLogger *logger;
+
+    // May be NULL
+    MetisContentStoreInterface *secondTier;
+
+    PARCHashCodeTable *indexByNameHash;
+    PARCHashCodeTable *indexByNameAndKeyIdHash;
+
+    MetisTimeOrderedList *indexByRecommendedCacheTime;
+    MetisTimeOrderedList *indexByExpirationTime;
+
+    PARCHashCodeTable *storageByNameHashAndSequence;
+    uint64_t nextSequence;
+
+    MetisContentStoreIndexStats stats;
+} MetisContentStoreIndex;
+
+/**
+ * Stores an object promoted from the second tier, see metisContentStoreIndex_Promote()
+ *
+ * @param [in] context The store passed to metisContentStoreIndex_Promote()
+ * @param [in] content The object to store
+ * @param [in] currentTimeTicks The current time
+ *
+ * @return true if the store now holds `content`
+ */
+typedef bool (MetisContentStoreIndex_PutFunction)(void *context, MetisMessage *content, uint64_t currentTimeTicks);
+
+/**
+ * Creates the tables, sized for the configured object capacity
+ *
+ * On failure the index is left as after metisContentStoreIndex_Destroy().
+ *
+ * @param [in] index The index to initialize, usually part of a store
+ * @param [in] name The store's name in log messages, must stay allocated
+ * @param [in] config The capacities and optional second tier, which the index acquires
+ * @param [in] logger The logger, which the index acquires
+ *
+ * @return true The index is ready
+ * @return false A table could not be allocated
+ *
+ * Example:
+ * @code
+ * {
+ *     if (!metisContentStoreIndex_Init(&store->index, "LRUContentStore", config, logger)) {
+ *         return false;
+ *     }
+ * }
+ * @endcode
+ */
+bool metisContentStoreIndex_Init(MetisContentStoreIndex *index, const char *name, MetisContentStoreConfig *config, MetisLogger *logger);
+
+/**
+ * Releases every entry, the tables, the second tier and the logger
+ *
+ * Objects are not demoted, a store that wants to keep them in the second tier must evict them first.
+ * May be called more than once.
+ *
+ * @param [in] index An initialized index
+ *
+ * Example:
+ * @code
+ * {
+ *     while (store->index.objectCount > 0) {
+ *         myStore_EvictOne(store, 0);
+ *     }
+ *     metisContentStoreIndex_Destroy(&store->index);
+ *     metisLruList_Destroy(&store->lru);
+ * }
+ * @endcode
+ */
+void metisContentStoreIndex_Destroy(MetisContentStoreIndex *index);
+
+/**
+ * The checks every put makes before it looks for room
+ *
+ * @param [in] index An initialized index
+ * @param [in] content A content object
+ * @param [in] currentTimeTicks The current time
+ *
+ * @return false The store has no capacity, the object is larger than the byte capacity, it has
+ *               expired or passed its RCT, or the store already has it
+ * @return true The object may be stored
+ *
+ * Example:
+ * @code
+ * {
+ *     if (!metisContentStoreIndex_CanStore(&store->index, content, currentTimeTicks)) {
+ *         return false;
+ *     }
+ * }
+ * @endcode
+ */
+bool metisContentStoreIndex_CanStore(MetisContentStoreIndex *index, MetisMessage *content, uint64_t currentTimeTicks);
+
+/**
+ * True if something must be evicted before storing an object of `contentBytes`
+ *
+ * @param [in] index An initialized index
+ * @param [in] contentBytes The metisMessage_Length() of the new object
+ *
+ * Example:
+ * @code
+ * {
+ *     while (metisContentStoreIndex_NeedsRoom(&store->index, metisMessage_Length(content))) {
+ *         myStore_EvictOne(store, currentTimeTicks);
+ *     }
+ * }
+ * @endcode
+ */
+bool metisContentStoreIndex_NeedsRoom(const MetisContentStoreIndex *index, size_t contentBytes);
+
+/**
+ * True if the store holds more objects or bytes than its limits, as after shrinking it
+ *
+ * @param [in] index An initialized index
+ *
+ * Example:
+ * @code
+ * {
+ *     for (size_t i = 0; i < maximumEvictions && metisContentStoreIndex_IsOverCapacity(&store->index); i++) {
+ *         myStore_EvictOne(store, currentTimeTicks);
+ *     }
+ * }
+ * @endcode
+ */
+bool metisContentStoreIndex_IsOverCapacity(const MetisContentStoreIndex *index);
+
+/**
+ * Stores an object at the head of `lruList` and adds it to every table
+ *
+ * Does not check the limits, call metisContentStoreIndex_CanStore() and make room first.
+ *
+ * @param [in] index An initialized index
+ * @param [in] content The content object, the entry acquires a reference
+ * @param [in] lruList The store's list to put the entry on
+ *
+ * @return non-null The new entry, owned by the index
+ * @return null The object could not be stored
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisContentStoreEntry *entry = metisContentStoreIndex_Add(&store->index, content, store->lru);
+ * }
+ * @endcode
+ */
+MetisContentStoreEntry *metisContentStoreIndex_Add(MetisContentStoreIndex *index, MetisMessage *content, MetisLruList *lruList);
+
+/**
+ * Finds the entry holding the same object as `content`
+ *
+ * Only an object with the same name can be the same object, so an object with a new name is never
+ * hashed.  With the same name, a byte comparison catches a retransmission before we fall back to
+ * comparing ContentObjectHashes.
+ *
+ * @param [in] index An initialized index
+ * @param [in] content A content object
+ *
+ * @return non-null The entry
+ * @return null The store does not have the object
+ *
+ * Example:
+ * @code
+ * {
+ *     if (metisContentStoreIndex_FindObject(&store->index, content) != NULL) {
+ *         // already stored
+ *     }
+ * }
+ * @endcode
+ */
+MetisContentStoreEntry *metisContentStoreIndex_FindObject(MetisContentStoreIndex *index, MetisMessage *content);
+
+/**
+ * Finds the entry that answers an interest, with the most restrictive lookup
+ *
+ * An interest with a ContentObjectHash restriction only matches the object with that hash among
+ * the objects with its name.  One with a KeyId only looks in the name and KeyId table.  Any
+ * other only looks in the name table.  This does not count a hit or a miss.
+ *
+ * @param [in] index An initialized index
+ * @param [in] interest An interest
+ *
+ * @return non-null The matching entry
+ * @return null No object in this store matches
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisContentStoreEntry *entry = metisContentStoreIndex_MatchInterest(&store->index, interest);
+ *     if (entry) {
+ *         metisContentStoreEntry_MoveToHead(entry);
+ *     }
+ * }
+ * @endcode
+ */
+MetisContentStoreEntry *metisContentStoreIndex_MatchInterest(MetisContentStoreIndex *index, MetisMessage *interest);
+
+/**
+ * Removes an entry from every table and releases it, which also takes it off its LRU list
+ *
+ * @param [in] index An initialized index
+ * @param [in] entry An entry in the index, invalid after the call
+ *
+ * Example:
+ * @code
+ * {
+ *     metisContentStoreIndex_Purge(&store->index, entry);
+ * }
+ * @endcode
+ */
+void metisContentStoreIndex_Purge(MetisContentStoreIndex *index, MetisContentStoreEntry *entry);
+
+/**
+ * Removes an object from the store, or from the second tier if the store does not have it
+ *
+ * @param [in] index An initialized index
+ * @param [in] content A content object
+ *
+ * @return true The object was removed
+ *
+ * Example:
+ * @code
+ * {
+ *     bool removed = metisContentStoreIndex_Remove(&store->index, content);
+ * }
+ * @endcode
+ */
+bool metisContentStoreIndex_Remove(MetisContentStoreIndex *index, MetisMessage *content);
+
+/**
+ * Evicts the object that expired first, or failing that the one that passed its RCT first, if it
+ * is past that time
+ *
+ * Stale objects are not demoted to the second tier.
+ *
+ * @param [in] index An initialized index
+ * @param [in] currentTimeTicks The current time
+ *
+ * @return true An object was evicted
+ *
+ * Example:
+ * @code
+ * {
+ *     if (!metisContentStoreIndex_EvictStale(&store->index, currentTimeTicks)) {
+ *         myStore_EvictLeastUsed(store, currentTimeTicks);
+ *     }
+ * }
+ * @endcode
+ */
+bool metisContentStoreIndex_EvictStale(MetisContentStoreIndex *index, uint64_t currentTimeTicks);
+
+/**
+ * Evicts the entry the store's policy picked, demoting it to the second tier if there is one
+ *
+ * Does not count an LRU eviction, the store counts those it makes to find room.
+ *
+ * @param [in] index An initialized index
+ * @param [in] entry The victim, invalid after the call
+ * @param [in] currentTimeTicks The current time, given to the second tier
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisLruListEntry *tail = metisLruList_PeekTail(store->lru);
+ *     metisContentStoreIndex_Evict(&store->index, metisLruList_EntryGetData(tail), currentTimeTicks);
+ * }
+ * @endcode
+ */
+void metisContentStoreIndex_Evict(MetisContentStoreIndex *index, MetisContentStoreEntry *entry, uint64_t currentTimeTicks);
+
+/**
+ * Looks for an interest in the second tier and moves a hit in to the store
+ *
+ * The object only leaves the second tier once `put` has stored it.  If `put` fails, the object is
+ * still returned, owned by the second tier, so the interest is answered either way.
+ *
+ * @param [in] index An initialized index with a second tier
+ * @param [in] interest The interest this store missed
+ * @param [in] put Stores the object in this store
+ * @param [in] context Passed to `put`
+ *
+ * @return non-null The matching object, owned by this store or the second tier
+ * @return null The second tier missed too
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisMessage *content = metisContentStoreIndex_Promote(&store->index, interest, _myStore_Promoted, store);
+ * }
+ * @endcode
+ */
+MetisMessage *metisContentStoreIndex_Promote(MetisContentStoreIndex *index, MetisMessage *interest,
+                                             MetisContentStoreIndex_PutFunction *put, void *context);
+
+/**
+ * Counts a hit or a miss for an interest
+ *
+ * @param [in] index An initialized index
+ * @param [in] interest The interest
+ * @param [in] result The object that answers it, or NULL
+ *
+ * Example:
+ * @code
+ * {
+ *     metisContentStoreIndex_CountLookup(&store->index, interest, result);
+ *     return result;
+ * }
+ * @endcode
+ */
+void metisContentStoreIndex_CountLookup(MetisContentStoreIndex *index, MetisMessage *interest, MetisMessage *result);
+
+/**
+ * Adds the common counters, and the second tier's, in to `stats`
+ *
+ * @param [in] index An initialized index
+ * @param [in] stats The snapshot to add to
+ *
+ * Example:
+ * @code
+ * {
+ *     metisContentStoreIndex_AccumulateStats(&store->index, stats);
+ * }
+ * @endcode
+ */
+void metisContentStoreIndex_AccumulateStats(const MetisContentStoreIndex *index, MetisStats *stats);
+
+/**
+ * Changes the limits in place.  A store over its new limits is trimmed by the store's trim.
+ *
+ * @param [in] index An initialized index
+ * @param [in] objectCapacity The most objects to hold
+ * @param [in] byteCapacity The most bytes to hold, 0 for no limit
+ *
+ * Example:
+ * @code
+ * {
+ *     metisContentStoreIndex_SetCapacity(&store->index, objectCapacity, byteCapacity);
+ * }
+ * @endcode
+ */
+void metisContentStoreIndex_SetCapacity(MetisContentStoreIndex *index, size_t objectCapacity, size_t byteCapacity);
+#endif // Metis_metis_ContentStoreIndex_h
@@ -62,6 +62,12 @@
 
 #include <ccnx/forwarder/metis/content_store/metis_ContentStoreInterface.h>
 
+MetisContentStoreInterface *
+metisContentStoreInterface_Aquire(const MetisContentStoreInterface *storeImpl)
+{
+    return storeImpl->acquire(storeImpl);
+}
+
 void
 metisContentStoreInterface_Release(MetisContentStoreInterface **storeImplPtr)
 {
@@ -98,12 +104,51 @@ metisContentStoreInterface_GetObjectCount(MetisContentStoreInterface *storeImpl)
     return storeImpl->getObjectCount(storeImpl);
 }
 
+size_t
+metisContentStoreInterface_GetByteCapacity(MetisContentStoreInterface *storeImpl)
+{
+    return storeImpl->getByteCapacity(storeImpl);
+}
+
+size_t
+metisContentStoreInterface_GetByteCount(MetisContentStoreInterface *storeImpl)
+{
+    return storeImpl->getByteCount(storeImpl);
+}
+
 void
 metisContentStoreInterface_Log(MetisContentStoreInterface *storeImpl)
 {
     storeImpl->log(storeImpl);
 }
 
+void
+metisContentStoreInterface_AccumulateStats(MetisContentStoreInterface *storeImpl, MetisStats *stats)
+{
+    if (storeImpl->accumulateStats != NULL) {
+        storeImpl->accumulateStats(storeImpl, stats);
+    }
+}
+
+bool
+metisContentStoreInterface_SetCapacity(MetisContentStoreInterface *storeImpl, size_t objectCapacity, size_t byteCapacity)
+{
+    if (storeImpl->setCapacity == NULL) {
+        return false;
+    }
+    storeImpl->setCapacity(storeImpl, objectCapacity, byteCapacity);
+    return true;
+}
+
+bool
+metisContentStoreInterface_Trim(MetisContentStoreInterface *storeImpl, size_t maximumEvictions, uint64_t currentTimeTicks)
+{
+    if (storeImpl->trim == NULL) {
+        return true;
+    }
+    return storeImpl->trim(storeImpl, maximumEvictions, currentTimeTicks);
+}
+
 void *
 metisContentStoreInterface_GetPrivateData(MetisContentStoreInterface *storeImpl)
 {
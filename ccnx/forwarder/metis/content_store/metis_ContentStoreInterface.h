@@ -63,12 +63,32 @@
 #include <stdio.h>
 
 #include <ccnx/forwarder/metis/core/metis_Message.h>
+#include <ccnx/forwarder/metis/core/metis_Stats.h>
+
+typedef struct metis_contentstore_interface MetisContentStoreInterface;
+
+/**
+ * @typedef MetisContentStoreType
+ * @abstract The available in-memory content store policies
+ * @constant MetisContentStoreType_LRU Admits every object and evicts the least recently used (metis_LRUContentStore.h)
+ * @constant MetisContentStoreType_TinyLFU Admits an object only if it is asked for more often than what it would
+ *           evict, and evicts from a segmented LRU (metis_TinyLFUContentStore.h)
+ */
+typedef enum {
+    MetisContentStoreType_LRU,
+    MetisContentStoreType_TinyLFU
+} MetisContentStoreType;
 
 typedef struct metis_contentstore_config {
     size_t objectCapacity;
-} MetisContentStoreConfig;
 
-typedef struct metis_contentstore_interface MetisContentStoreInterface;
+    // The most bytes of ContentObjects (by metisMessage_Length) to store. 0 means no byte limit.
+    size_t byteCapacity;
+
+    // Optional slower store behind this one, may be NULL.  Objects evicted by LRU are demoted to it,
+    // and a hit in it promotes the object back.  The store takes its own reference.
+    MetisContentStoreInterface *secondTier;
+} MetisContentStoreConfig;
 
 struct metis_contentstore_interface {
     /**
@@ -125,6 +145,24 @@ struct metis_contentstore_interface {
      */
     size_t (*getObjectCount)(MetisContentStoreInterface *storeImpl);
 
+    /**
+     * Return the maximum number of bytes of ContentObjects that can be stored in this ContentStore.
+     *
+     * @param storeImpl - a pointer to this MetisContentStoreInterface instance.
+     *
+     * @return the byte capacity, or 0 if the ContentStore is only limited by object count
+     */
+    size_t (*getByteCapacity)(MetisContentStoreInterface *storeImpl);
+
+    /**
+     * Return the number of bytes of ContentObjects currently stored in the ContentStore.
+     *
+     * @param storeImpl - a pointer to this MetisContentStoreInterface instance.
+     *
+     * @return the sum of metisMessage_Length() of the stored ContentObjects
+     */
+    size_t (*getByteCount)(MetisContentStoreInterface *storeImpl);
+
     /**
      * Loga ContentStore implementation specific version of store-related information.
      *
@@ -132,6 +170,43 @@ struct metis_contentstore_interface {
      */
     void (*log)(MetisContentStoreInterface *storeImpl);
 
+    /**
+     * Add the ContentStore's counters, and those of any store behind it, in to `stats`.  May be called
+     * from a thread other than the one using the store.
+     *
+     * This operation is optional, it is NULL for a store that keeps no counters.
+     *
+     * @param storeImpl - a pointer to this MetisContentStoreInterface instance.
+     * @param stats - the snapshot to add to.
+     */
+    void (*accumulateStats)(MetisContentStoreInterface *storeImpl, MetisStats *stats);
+
+    /**
+     * Change the ContentStore's limits without losing its contents.  The store evicts nothing here.
+     * If it is now over its limits, each put only makes room for itself, and trim evicts the rest.
+     *
+     * This operation is optional, it is NULL for a store that must be re-created to change its limits.
+     *
+     * @param storeImpl - a pointer to this MetisContentStoreInterface instance.
+     * @param objectCapacity - the new maximum number of objects.
+     * @param byteCapacity - the new maximum bytes of objects, 0 means no byte limit.
+     */
+    void (*setCapacity)(MetisContentStoreInterface *storeImpl, size_t objectCapacity, size_t byteCapacity);
+
+    /**
+     * Evict objects from a ContentStore that is over its limits, by its usual eviction policy, but no
+     * more than `maximumEvictions` of them.
+     *
+     * This operation is optional, it is NULL for a store that is never over its limits.
+     *
+     * @param storeImpl - a pointer to this MetisContentStoreInterface instance.
+     * @param maximumEvictions - the most objects to evict.
+     * @param currentTimeTicks - the current time, in metis ticks, since the UTC epoch.
+     *
+     * @return true if the store is within its limits
+     */
+    bool (*trim)(MetisContentStoreInterface *storeImpl, size_t maximumEvictions, uint64_t currentTimeTicks);
+
     /**
      * Acquire a new reference to the specified ContentStore instance. This reference will eventually need
      * to be released by calling {@link metisContentStoreInterface_Release}.
@@ -209,6 +284,24 @@ size_t metisContentStoreInterface_GetObjectCapacity(MetisContentStoreInterface *
  */
 size_t metisContentStoreInterface_GetObjectCount(MetisContentStoreInterface *storeImpl);
 
+/**
+ * Return the maximum number of bytes of ContentObjects that can be stored in this ContentStore.
+ *
+ * @param storeImpl - a pointer to this MetisContentStoreInterface instance.
+ *
+ * @return the byte capacity, or 0 if the ContentStore is only limited by object count
+ */
+size_t metisContentStoreInterface_GetByteCapacity(MetisContentStoreInterface *storeImpl);
+
+/**
+ * Return the number of bytes of ContentObjects currently stored in the ContentStore.
+ *
+ * @param storeImpl - a pointer to this MetisContentStoreInterface instance.
+ *
+ * @return the sum of metisMessage_Length() of the stored ContentObjects
+ */
+size_t metisContentStoreInterface_GetByteCount(MetisContentStoreInterface *storeImpl);
+
 /**
  * Loga ContentStore implementation specific version of store-related information.
  *
@@ -216,6 +309,39 @@ size_t metisContentStoreInterface_GetObjectCount(MetisContentStoreInterface *sto
  */
 void metisContentStoreInterface_Log(MetisContentStoreInterface *storeImpl);
 
+/**
+ * Add the ContentStore's counters, and those of any store behind it, in to `stats`.  Does nothing
+ * if the ContentStore implementation keeps no counters.
+ *
+ * @param storeImpl - a pointer to this MetisContentStoreInterface instance.
+ * @param stats - the snapshot to add to.
+ */
+void metisContentStoreInterface_AccumulateStats(MetisContentStoreInterface *storeImpl, MetisStats *stats);
+
+/**
+ * Change the ContentStore's limits without losing its contents.  See metisContentStoreInterface_Trim().
+ *
+ * @param storeImpl - a pointer to this MetisContentStoreInterface instance.
+ * @param objectCapacity - the new maximum number of objects.
+ * @param byteCapacity - the new maximum bytes of objects, 0 means no byte limit.
+ *
+ * @return true if the limits were changed
+ * @return false The store cannot be resized, it must be re-created
+ */
+bool metisContentStoreInterface_SetCapacity(MetisContentStoreInterface *storeImpl, size_t objectCapacity, size_t byteCapacity);
+
+/**
+ * Evict at most `maximumEvictions` objects from a ContentStore that is over its limits, for example
+ * after metisContentStoreInterface_SetCapacity() made it smaller.  Call it again while it returns false.
+ *
+ * @param storeImpl - a pointer to this MetisContentStoreInterface instance.
+ * @param maximumEvictions - the most objects to evict.
+ * @param currentTimeTicks - the current time, in metis ticks, since the UTC epoch.
+ *
+ * @return true if the store is within its limits
+ */
+bool metisContentStoreInterface_Trim(MetisContentStoreInterface *storeImpl, size_t maximumEvictions, uint64_t currentTimeTicks);
+
 /**
  * Acquire a new reference to the specified ContentStore instance. This reference will eventually need
  * to be released by calling {@link metisContentStoreInterface_Release}.
@@ -0,0 +1,1059 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+/*
+ * - Appends ContentObjects to memory-mapped segment files, each `segmentBytes` long.
+ * - Each record is a _MetisDiskRecordHeader followed by the wire format message, padded to 8 bytes.
+ *   The record magic is written last, so a torn record at the end of a segment is ignored on recovery.
+ * - The index is a chained hash table by name hash.  Chains are newest first.  Matching an interest
+ *   first compares the name bytes in the mapped record with the interest's name, then materializes only
+ *   a candidate with the same name and checks it with the metisHashTableFunction equality functions,
+ *   the same as the LRU store's tables.
+ * - Removing an object sets a tombstone flag in its record so it stays removed after a restart.
+ * - When the store is full, the oldest segment is unmapped and deleted.
+ * - Segments are synced to disk with msync() when the store is destroyed, so they survive a crash of
+ *   the host after the forwarder exits.  Records written since the last sync may be lost in a crash.
+ * - Expiry and RCT ticks are saved in the record header.  They are only valid in the process that wrote
+ *   them, so for recovered segments the times are recomputed from the message's own fields.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#include <parc/algol/parc_Object.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <ccnx/forwarder/metis/core/metis_Logger.h>
+
+#include <ccnx/forwarder/metis/content_store/metis_DiskContentStore.h>
+#include <ccnx/forwarder/metis/content_store/metis_ContentStoreInterface.h>
+
+#include <ccnx/forwarder/metis/processor/metis_HashTableFunction.h>
+#include <ccnx/forwarder/metis/tlv/metis_TlvName.h>
+#include <ccnx/forwarder/metis/tlv/metis_TlvSkeleton.h>
+
+#include <LongBow/runtime.h>
+
+#define METIS_DISK_SEGMENT_MAGIC     0x4D435331
+#define METIS_DISK_RECORD_MAGIC      0x4D435252
+
+#define METIS_DISK_MIN_SEGMENT_BYTES (64 * 1024)
+#define METIS_DISK_MAX_SEGMENT_BYTES (16 * 1024 * 1024)
+#define METIS_DISK_MIN_SEGMENTS      2
+
+#define METIS_DISK_INITIAL_BUCKETS   1024
+
+#define METIS_DISK_SEGMENT_PREFIX    "metis-cs-"
+#define METIS_DISK_SEGMENT_SUFFIX    ".seg"
+
+#define METIS_DISK_RECORD_TOMBSTONE  0x01
+#define METIS_DISK_RECORD_EXPIRY     0x02
+#define METIS_DISK_RECORD_RCT        0x04
+
+typedef struct metis_disk_segment_header {
+    uint32_t magic;
+    uint32_t segmentId;
+    uint64_t segmentBytes;
+} _MetisDiskSegmentHeader;
+
+typedef struct metis_disk_record_header {
+    uint32_t magic;
+    uint32_t length;
+    uint32_t nameHash;
+    uint32_t flags;
+    uint64_t expiryTimeTicks;
+    uint64_t recommendedCacheTimeTicks;
+} _MetisDiskRecordHeader;
+
+typedef struct metis_disk_segment {
+    uint32_t segmentId;
+    uint8_t *base;
+    size_t segmentBytes;
+    size_t writeOffset;
+
+    // written by an earlier process, so the tick values in its records are meaningless
+    bool recovered;
+} _MetisDiskSegment;
+
+typedef struct metis_disk_index_entry {
+    struct metis_disk_index_entry *next;
+    _MetisDiskSegment *segment;
+    uint32_t nameHash;
+    uint32_t offset;
+} _MetisDiskIndexEntry;
+
+typedef struct metis_disk_contentstore_stats {
+    uint64_t countAdds;
+    uint64_t countHits;
+    uint64_t countMisses;
+    uint64_t countRecovered;
+    uint64_t countSegmentEvictions;
+} _MetisDiskContentStoreStats;
+
+typedef struct metis_disk_contentstore_data {
+    char *directory;
+
+    // 0 means no object limit
+    size_t objectCapacity;
+    size_t objectCount;
+
+    size_t byteCapacity;
+    size_t byteCount;
+
+    size_t segmentBytes;
+    uint32_t nextSegmentId;
+
+    // oldest first, the last one is where we append
+    _MetisDiskSegment **segments;
+    size_t segmentCount;
+    size_t maxSegments;
+
+    _MetisDiskIndexEntry **buckets;
+    size_t bucketCount;
+
+    // The message returned by the last matchInterest
+    MetisMessage *lastMatch;
+
+    MetisLogger *logger;
+
+    _MetisDiskContentStoreStats stats;
+} _MetisDiskContentStore;
+
+// The interface descriptor is already declared for MetisContentStoreInterface by the LRU store
+typedef MetisContentStoreInterface _MetisDiskContentStoreInterface;
+
+static inline size_t
+_metisDiskContentStore_RecordBytes(size_t messageLength)
+{
+    return (sizeof(_MetisDiskRecordHeader) + messageLength + 7) & ~((size_t) 7);
+}
+
+static inline _MetisDiskRecordHeader *
+_metisDiskContentStore_Record(const _MetisDiskSegment *segment, uint32_t offset)
+{
+    return (_MetisDiskRecordHeader *) (segment->base + offset);
+}
+
+static inline uint8_t *
+_metisDiskContentStore_RecordPayload(_MetisDiskRecordHeader *record)
+{
+    return (uint8_t *) record + sizeof(_MetisDiskRecordHeader);
+}
+
+// ======================================================================
+// Index
+
+static void
+_metisDiskContentStore_IndexGrow(_MetisDiskContentStore *store)
+{
+    size_t newCount = store->bucketCount * 2;
+    _MetisDiskIndexEntry **newBuckets = parcMemory_AllocateAndClear(newCount * sizeof(_MetisDiskIndexEntry *));
+    assertNotNull(newBuckets, "parcMemory_AllocateAndClear(%zu) returned NULL", newCount * sizeof(_MetisDiskIndexEntry *));
+
+    // Walk each old chain from its tail so the new chains stay newest first
+    for (size_t i = 0; i < store->bucketCount; i++) {
+        _MetisDiskIndexEntry *reversed = NULL;
+        _MetisDiskIndexEntry *entry = store->buckets[i];
+        while (entry) {
+            _MetisDiskIndexEntry *next = entry->next;
+            entry->next = reversed;
+            reversed = entry;
+            entry = next;
+        }
+
+        while (reversed) {
+            _MetisDiskIndexEntry *next = reversed->next;
+            size_t bucket = reversed->nameHash & (newCount - 1);
+            reversed->next = newBuckets[bucket];
+            newBuckets[bucket] = reversed;
+            reversed = next;
+        }
+    }
+
+    parcMemory_Deallocate((void **) &store->buckets);
+    store->buckets = newBuckets;
+    store->bucketCount = newCount;
+}
+
+static void
+_metisDiskContentStore_IndexInsert(_MetisDiskContentStore *store, _MetisDiskSegment *segment, uint32_t offset)
+{
+    if (store->objectCount >= store->bucketCount) {
+        _metisDiskContentStore_IndexGrow(store);
+    }
+
+    _MetisDiskRecordHeader *record = _metisDiskContentStore_Record(segment, offset);
+
+    _MetisDiskIndexEntry *entry = parcMemory_Allocate(sizeof(_MetisDiskIndexEntry));
+    assertNotNull(entry, "parcMemory_Allocate(%zu) returned NULL", sizeof(_MetisDiskIndexEntry));
+    entry->segment = segment;
+    entry->offset = offset;
+    entry->nameHash = record->nameHash;
+
+    size_t bucket = entry->nameHash & (store->bucketCount - 1);
+    entry->next = store->buckets[bucket];
+    store->buckets[bucket] = entry;
+
+    store->objectCount++;
+    store->byteCount += record->length;
+}
+
+/**
+ * Unlink the entry that `link` points to and free it.  Does not touch the record.
+ */
+static void
+_metisDiskContentStore_IndexRemove(_MetisDiskContentStore *store, _MetisDiskIndexEntry **link)
+{
+    _MetisDiskIndexEntry *entry = *link;
+    _MetisDiskRecordHeader *record = _metisDiskContentStore_Record(entry->segment, entry->offset);
+
+    *link = entry->next;
+
+    store->objectCount--;
+    store->byteCount -= record->length;
+
+    parcMemory_Deallocate((void **) &entry);
+}
+
+/**
+ * Find the record holding exactly the bytes of `content`
+ *
+ * @return The link pointing to the index entry, or NULL
+ */
+static _MetisDiskIndexEntry **
+_metisDiskContentStore_FindExact(_MetisDiskContentStore *store, const MetisMessage *content, uint32_t nameHash)
+{
+    struct iovec vector;
+    metisMessage_GetIovec(content, &vector);
+
+    _MetisDiskIndexEntry **link = &store->buckets[nameHash & (store->bucketCount - 1)];
+    while (*link) {
+        _MetisDiskIndexEntry *entry = *link;
+        if (entry->nameHash == nameHash) {
+            _MetisDiskRecordHeader *record = _metisDiskContentStore_Record(entry->segment, entry->offset);
+            if (record->length == vector.iov_len
+                && memcmp(_metisDiskContentStore_RecordPayload(record), vector.iov_base, vector.iov_len) == 0) {
+                return link;
+            }
+        }
+        link = &entry->next;
+    }
+    return NULL;
+}
+
+// ======================================================================
+// Segments
+
+static void
+_metisDiskContentStore_SegmentPath(const _MetisDiskContentStore *store, uint32_t segmentId, char *path, size_t pathLength)
+{
+    snprintf(path, pathLength, "%s/" METIS_DISK_SEGMENT_PREFIX "%08" PRIu32 METIS_DISK_SEGMENT_SUFFIX, store->directory, segmentId);
+}
+
+/**
+ * Reserve the blocks of a new segment file
+ *
+ * The records are written through a shared mapping.  A write to a page with no block behind it
+ * raises SIGBUS when the filesystem is full, so the blocks are allocated here, where running out
+ * of space is an error we can return instead of a signal.
+ *
+ * @return 0 on success, otherwise an errno value
+ */
+static int
+_metisDiskContentStore_ReserveSegment(int fd, size_t segmentBytes)
+{
+#if defined(__APPLE__)
+    // Darwin has no posix_fallocate
+    fstore_t reserve = {
+        .fst_flags = F_ALLOCATEALL,
+        .fst_posmode = F_PEOFPOSMODE,
+        .fst_offset = 0,
+        .fst_length = (off_t) segmentBytes,
+    };
+    if (fcntl(fd, F_PREALLOCATE, &reserve) != 0 || ftruncate(fd, (off_t) segmentBytes) != 0) {
+        return errno;
+    }
+    return 0;
+#else
+    return posix_fallocate(fd, 0, (off_t) segmentBytes);
+#endif
+}
+
+/**
+ * Map a segment file.  If `create` is true, the file is created (or truncated) and segmentBytes
+ * of disk are reserved for it.
+ *
+ * @return NULL if the file could not be created, mapped or is not a segment
+ */
+static _MetisDiskSegment *
+_metisDiskContentStore_OpenSegment(_MetisDiskContentStore *store, uint32_t segmentId, bool create)
+{
+    char path[PATH_MAX];
+    _metisDiskContentStore_SegmentPath(store, segmentId, path, sizeof(path));
+
+    int fd = open(path, create ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR, 0600);
+    if (fd < 0) {
+        if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error)) {
+            metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error, __func__,
+                            "DiskContentStore %p could not open %s: (%d) %s",
+                            (void *) store, path, errno, strerror(errno));
+        }
+        return NULL;
+    }
+
+    size_t segmentBytes = store->segmentBytes;
+    bool ok = true;
+    if (create) {
+        int error = _metisDiskContentStore_ReserveSegment(fd, segmentBytes);
+        if (error != 0) {
+            if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error)) {
+                metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error, __func__,
+                                "DiskContentStore %p could not reserve %zu bytes for %s: (%d) %s",
+                                (void *) store, segmentBytes, path, error, strerror(error));
+            }
+            close(fd);
+            unlink(path);
+            return NULL;
+        }
+    } else {
+        struct stat statbuf;
+        ok = (fstat(fd, &statbuf) == 0) && (statbuf.st_size >= (off_t) sizeof(_MetisDiskSegmentHeader));
+        segmentBytes = ok ? (size_t) statbuf.st_size : 0;
+    }
+
+    uint8_t *base = MAP_FAILED;
+    if (ok) {
+        base = mmap(NULL, segmentBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (base == MAP_FAILED) {
+        if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error)) {
+            metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error, __func__,
+                            "DiskContentStore %p could not map %s: (%d) %s",
+                            (void *) store, path, errno, strerror(errno));
+        }
+        return NULL;
+    }
+
+    _MetisDiskSegmentHeader *header = (_MetisDiskSegmentHeader *) base;
+    if (create) {
+        header->segmentId = segmentId;
+        header->segmentBytes = segmentBytes;
+        header->magic = METIS_DISK_SEGMENT_MAGIC;
+    } else if (header->magic != METIS_DISK_SEGMENT_MAGIC || header->segmentId != segmentId) {
+        if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Warning)) {
+            metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Warning, __func__,
+                            "DiskContentStore %p ignoring %s, not a segment file",
+                            (void *) store, path);
+        }
+        munmap(base, segmentBytes);
+        return NULL;
+    }
+
+    _MetisDiskSegment *segment = parcMemory_AllocateAndClear(sizeof(_MetisDiskSegment));
+    assertNotNull(segment, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_MetisDiskSegment));
+    segment->segmentId = segmentId;
+    segment->base = base;
+    segment->segmentBytes = segmentBytes;
+    segment->writeOffset = sizeof(_MetisDiskSegmentHeader);
+    segment->recovered = !create;
+    return segment;
+}
+
+static void
+_metisDiskContentStore_CloseSegment(_MetisDiskContentStore *store, _MetisDiskSegment **segmentPtr, bool removeFile)
+{
+    _MetisDiskSegment *segment = *segmentPtr;
+
+    if (!removeFile) {
+        // Flush the records so the next store can recover them
+        if (msync(segment->base, segment->segmentBytes, MS_SYNC) != 0) {
+            if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Warning)) {
+                metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Warning, __func__,
+                                "DiskContentStore %p msync of segment %" PRIu32 " failed: (%d) %s",
+                                (void *) store, segment->segmentId, errno, strerror(errno));
+            }
+        }
+    }
+
+    munmap(segment->base, segment->segmentBytes);
+
+    if (removeFile) {
+        char path[PATH_MAX];
+        _metisDiskContentStore_SegmentPath(store, segment->segmentId, path, sizeof(path));
+        unlink(path);
+    }
+
+    parcMemory_Deallocate((void **) segmentPtr);
+}
+
+/**
+ * Calls `visitor` for each complete record in a segment, in log order
+ */
+static void
+_metisDiskContentStore_ForEachRecord(_MetisDiskContentStore *store, _MetisDiskSegment *segment,
+                                     void (*visitor)(_MetisDiskContentStore *store, _MetisDiskSegment *segment, uint32_t offset))
+{
+    size_t offset = sizeof(_MetisDiskSegmentHeader);
+    while (offset + sizeof(_MetisDiskRecordHeader) <= segment->segmentBytes) {
+        _MetisDiskRecordHeader *record = _metisDiskContentStore_Record(segment, (uint32_t) offset);
+        if (record->magic != METIS_DISK_RECORD_MAGIC) {
+            break;
+        }
+
+        size_t recordBytes = _metisDiskContentStore_RecordBytes(record->length);
+        if (offset + recordBytes > segment->segmentBytes) {
+            break;
+        }
+
+        if (visitor) {
+            visitor(store, segment, (uint32_t) offset);
+        }
+        offset += recordBytes;
+    }
+    segment->writeOffset = offset;
+}
+
+static void
+_metisDiskContentStore_UnindexRecord(_MetisDiskContentStore *store, _MetisDiskSegment *segment, uint32_t offset)
+{
+    _MetisDiskRecordHeader *record = _metisDiskContentStore_Record(segment, offset);
+    if (record->flags & METIS_DISK_RECORD_TOMBSTONE) {
+        return;
+    }
+
+    _MetisDiskIndexEntry **link = &store->buckets[record->nameHash & (store->bucketCount - 1)];
+    while (*link) {
+        if ((*link)->segment == segment && (*link)->offset == offset) {
+            _metisDiskContentStore_IndexRemove(store, link);
+            return;
+        }
+        link = &(*link)->next;
+    }
+}
+
+static void
+_metisDiskContentStore_IndexRecord(_MetisDiskContentStore *store, _MetisDiskSegment *segment, uint32_t offset)
+{
+    _MetisDiskRecordHeader *record = _metisDiskContentStore_Record(segment, offset);
+    if ((record->flags & METIS_DISK_RECORD_TOMBSTONE) == 0) {
+        _metisDiskContentStore_IndexInsert(store, segment, offset);
+        metisStats_Increment(store->stats.countRecovered);
+    }
+}
+
+/**
+ * Remove the oldest segment from the index and delete its file
+ */
+static void
+_metisDiskContentStore_DropOldestSegment(_MetisDiskContentStore *store)
+{
+    assertTrue(store->segmentCount > 0, "Dropping a segment from an empty store");
+
+    _MetisDiskSegment *segment = store->segments[0];
+    _metisDiskContentStore_ForEachRecord(store, segment, _metisDiskContentStore_UnindexRecord);
+
+    store->segmentCount--;
+    memmove(&store->segments[0], &store->segments[1], store->segmentCount * sizeof(_MetisDiskSegment *));
+
+    metisStats_Increment(store->stats.countSegmentEvictions);
+
+    if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+        metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                        "DiskContentStore %p evict segment %" PRIu32 " (segment evictions %" PRIu64 ")",
+                        (void *) store, segment->segmentId, store->stats.countSegmentEvictions);
+    }
+
+    _metisDiskContentStore_CloseSegment(store, &segment, true);
+}
+
+/**
+ * Make sure the newest segment has room for recordBytes, starting a new segment if needed
+ *
+ * @return The segment to append to, or NULL if no segment could be created
+ */
+static _MetisDiskSegment *
+_metisDiskContentStore_SegmentForAppend(_MetisDiskContentStore *store, size_t recordBytes)
+{
+    if (store->segmentCount > 0) {
+        _MetisDiskSegment *active = store->segments[store->segmentCount - 1];
+        if (!active->recovered && active->writeOffset + recordBytes <= active->segmentBytes) {
+            return active;
+        }
+    }
+
+    while (store->segmentCount >= store->maxSegments) {
+        _metisDiskContentStore_DropOldestSegment(store);
+    }
+
+    _MetisDiskSegment *segment = _metisDiskContentStore_OpenSegment(store, store->nextSegmentId, true);
+    if (segment) {
+        store->nextSegmentId++;
+        store->segments[store->segmentCount++] = segment;
+    }
+    return segment;
+}
+
+// ======================================================================
+// MetisContentStoreInterface
+
+static void
+_metisDiskContentStore_ReleaseLastMatch(_MetisDiskContentStore *store)
+{
+    if (store->lastMatch) {
+        metisMessage_Release(&store->lastMatch);
+    }
+}
+
+/**
+ * Compare the name in a mapped record with `name` without materializing the record
+ *
+ * @return true if the record's name bytes are exactly `name`
+ */
+static bool
+_metisDiskContentStore_RecordNameEquals(_MetisDiskContentStore *store, const _MetisDiskIndexEntry *entry, const uint8_t *name, size_t nameLength)
+{
+    _MetisDiskRecordHeader *record = _metisDiskContentStore_Record(entry->segment, entry->offset);
+    uint8_t *payload = _metisDiskContentStore_RecordPayload(record);
+
+    MetisTlvSkeleton skeleton;
+    if (!metisTlvSkeleton_Parse(&skeleton, payload, store->logger)) {
+        return false;
+    }
+
+    MetisTlvExtent extent = metisTlvSkeleton_GetName(&skeleton);
+    return extent.length == nameLength
+           && extent.offset + extent.length <= record->length
+           && memcmp(&payload[extent.offset], name, nameLength) == 0;
+}
+
+static MetisMessage *
+_metisDiskContentStore_Materialize(_MetisDiskContentStore *store, const _MetisDiskIndexEntry *entry)
+{
+    _MetisDiskRecordHeader *record = _metisDiskContentStore_Record(entry->segment, entry->offset);
+
+    MetisMessage *message = metisMessage_CreateFromArray(_metisDiskContentStore_RecordPayload(record), record->length,
+                                                         0, 0, store->logger);
+    if (message && !entry->segment->recovered) {
+        if (record->flags & METIS_DISK_RECORD_EXPIRY) {
+            metisMessage_SetExpiryTimeTicks(message, record->expiryTimeTicks);
+        }
+        if (record->flags & METIS_DISK_RECORD_RCT) {
+            metisMessage_SetRecommendedCacheTimeTicks(message, record->recommendedCacheTimeTicks);
+        }
+    }
+    return message;
+}
+
+static bool
+_metisDiskContentStore_PutContent(MetisContentStoreInterface *storeImpl, MetisMessage *content, uint64_t currentTimeTicks)
+{
+    _MetisDiskContentStore *store = (_MetisDiskContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    assertNotNull(store, "Parameter store must be non-null");
+    assertNotNull(content, "Parameter objectMessage must be non-null");
+    assertTrue(metisMessage_GetType(content) == MetisMessagePacketType_ContentObject,
+               "Parameter objectMessage must be a Content Object");
+
+    if (!metisMessage_HasName(content)) {
+        return false;
+    }
+
+    if (metisMessage_HasExpiryTime(content) && currentTimeTicks > metisMessage_GetExpiryTimeTicks(content)) {
+        return false;
+    }
+
+    struct iovec vector;
+    metisMessage_GetIovec(content, &vector);
+
+    size_t recordBytes = _metisDiskContentStore_RecordBytes(vector.iov_len);
+    if (recordBytes > store->segmentBytes - sizeof(_MetisDiskSegmentHeader)) {
+        return false;
+    }
+
+    uint32_t nameHash = metisTlvName_HashCode(metisMessage_GetName(content));
+    if (_metisDiskContentStore_FindExact(store, content, nameHash) != NULL) {
+        return false;
+    }
+
+    while (store->objectCapacity > 0 && store->objectCount >= store->objectCapacity && store->segmentCount > 0) {
+        _metisDiskContentStore_DropOldestSegment(store);
+    }
+
+    _MetisDiskSegment *segment = _metisDiskContentStore_SegmentForAppend(store, recordBytes);
+    if (segment == NULL) {
+        return false;
+    }
+
+    uint32_t offset = (uint32_t) segment->writeOffset;
+    _MetisDiskRecordHeader *record = _metisDiskContentStore_Record(segment, offset);
+    memcpy(_metisDiskContentStore_RecordPayload(record), vector.iov_base, vector.iov_len);
+
+    record->length = (uint32_t) vector.iov_len;
+    record->nameHash = nameHash;
+    record->flags = 0;
+    record->expiryTimeTicks = 0;
+    record->recommendedCacheTimeTicks = 0;
+    if (metisMessage_HasExpiryTime(content)) {
+        record->flags |= METIS_DISK_RECORD_EXPIRY;
+        record->expiryTimeTicks = metisMessage_GetExpiryTimeTicks(content);
+    }
+    if (metisMessage_HasRecommendedCacheTime(content)) {
+        record->flags |= METIS_DISK_RECORD_RCT;
+        record->recommendedCacheTimeTicks = metisMessage_GetRecommendedCacheTimeTicks(content);
+    }
+
+    // last, so a partially written record is never recovered
+    record->magic = METIS_DISK_RECORD_MAGIC;
+    segment->writeOffset += recordBytes;
+
+    _metisDiskContentStore_IndexInsert(store, segment, offset);
+    metisStats_Increment(store->stats.countAdds);
+
+    if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+        metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                        "DiskContentStore %p saved message %p in segment %" PRIu32 " offset %" PRIu32 " (object count %zu)",
+                        (void *) store, (void *) content, segment->segmentId, offset, store->objectCount);
+    }
+
+    return true;
+}
+
+static MetisMessage *
+_metisDiskContentStore_MatchInterest(MetisContentStoreInterface *storeImpl, MetisMessage *interest)
+{
+    _MetisDiskContentStore *store = (_MetisDiskContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+
+    assertNotNull(store, "Parameter store must be non-null");
+    assertNotNull(interest, "Parameter interestMessage must be non-null");
+    assertTrue(metisMessage_GetType(interest) == MetisMessagePacketType_Interest,
+               "Parameter interestMessage must be an Interest");
+
+    _metisDiskContentStore_ReleaseLastMatch(store);
+
+    if (!metisMessage_HasName(interest)) {
+        metisStats_Increment(store->stats.countMisses);
+        return NULL;
+    }
+
+    // Same most restrictive match as the LRU store
+    bool (*equals)(const void *, const void *);
+    if (metisMessage_HasContentObjectHash(interest)) {
+        equals = metisHashTableFunction_MessageNameAndObjectHashEquals;
+    } else if (metisMessage_HasKeyId(interest)) {
+        equals = metisHashTableFunction_MessageNameAndKeyIdEquals;
+    } else {
+        equals = metisHashTableFunction_MessageNameEquals;
+    }
+
+    // The interest's name bytes, to check candidates in place before materializing them
+    MetisTlvSkeleton interestSkeleton;
+    uint8_t *interestPacket = (uint8_t *) metisMessage_FixedHeader(interest);
+    bool goodSkeleton = metisTlvSkeleton_Parse(&interestSkeleton, interestPacket, store->logger);
+    assertTrue(goodSkeleton, "Interest %p with a name did not parse", (void *) interest);
+    MetisTlvExtent nameExtent = metisTlvSkeleton_GetName(&interestSkeleton);
+    const uint8_t *name = &interestPacket[nameExtent.offset];
+
+    uint32_t nameHash = metisTlvName_HashCode(metisMessage_GetName(interest));
+    _MetisDiskIndexEntry *entry = store->buckets[nameHash & (store->bucketCount - 1)];
+    while (entry) {
+        if (entry->nameHash == nameHash && _metisDiskContentStore_RecordNameEquals(store, entry, name, nameExtent.length)) {
+            MetisMessage *candidate = _metisDiskContentStore_Materialize(store, entry);
+            if (candidate) {
+                if (equals(interest, candidate)) {
+                    store->lastMatch = candidate;
+                    metisStats_Increment(store->stats.countHits);
+
+                    if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+                        metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                                        "DiskContentStore %p matched interest %p (hits %" PRIu64 ", misses %" PRIu64 ")",
+                                        (void *) store, (void *) interest, store->stats.countHits, store->stats.countMisses);
+                    }
+                    return candidate;
+                }
+                metisMessage_Release(&candidate);
+            }
+        }
+        entry = entry->next;
+    }
+
+    metisStats_Increment(store->stats.countMisses);
+    return NULL;
+}
+
+static bool
+_metisDiskContentStore_RemoveContent(MetisContentStoreInterface *storeImpl, MetisMessage *content)
+{
+    _MetisDiskContentStore *store = (_MetisDiskContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+
+    if (!metisMessage_HasName(content)) {
+        return false;
+    }
+
+    uint32_t nameHash = metisTlvName_HashCode(metisMessage_GetName(content));
+    _MetisDiskIndexEntry **link = _metisDiskContentStore_FindExact(store, content, nameHash);
+    if (link == NULL) {
+        return false;
+    }
+
+    // The tombstone keeps the record from coming back on recovery
+    _MetisDiskRecordHeader *record = _metisDiskContentStore_Record((*link)->segment, (*link)->offset);
+    record->flags |= METIS_DISK_RECORD_TOMBSTONE;
+
+    _metisDiskContentStore_IndexRemove(store, link);
+    return true;
+}
+
+static void
+_metisDiskContentStore_Log(MetisContentStoreInterface *storeImpl)
+{
+    _MetisDiskContentStore *store = (_MetisDiskContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+
+    metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_All, __func__,
+                    "MetisDiskContentStore @%p {directory = %s, count = %zu, capacity = %zu, bytes = %zu, byteCapacity = %zu, "
+                    "segments = %zu of %zu x %zu bytes {"
+                    "stats = @%p {adds = %" PRIu64 ", hits = %" PRIu64 ", misses = %" PRIu64 ", recovered = %" PRIu64
+                    ", SegmentEvictions = %" PRIu64 "} }",
+                    store,
+                    store->directory,
+                    store->objectCount,
+                    store->objectCapacity,
+                    store->byteCount,
+                    store->byteCapacity,
+                    store->segmentCount,
+                    store->maxSegments,
+                    store->segmentBytes,
+                    &store->stats,
+                    store->stats.countAdds,
+                    store->stats.countHits,
+                    store->stats.countMisses,
+                    store->stats.countRecovered,
+                    store->stats.countSegmentEvictions);
+}
+
+static void
+_metisDiskContentStore_AccumulateStats(MetisContentStoreInterface *storeImpl, MetisStats *stats)
+{
+    _MetisDiskContentStore *store = (_MetisDiskContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+
+    stats->values[MetisStat_DiskStoreAdds] += metisStats_Read(store->stats.countAdds);
+    stats->values[MetisStat_DiskStoreHits] += metisStats_Read(store->stats.countHits);
+    stats->values[MetisStat_DiskStoreMisses] += metisStats_Read(store->stats.countMisses);
+    stats->values[MetisStat_DiskStoreRecovered] += metisStats_Read(store->stats.countRecovered);
+    stats->values[MetisStat_DiskStoreSegmentEvictions] += metisStats_Read(store->stats.countSegmentEvictions);
+}
+
+static size_t
+_metisDiskContentStore_GetObjectCapacity(MetisContentStoreInterface *storeImpl)
+{
+    _MetisDiskContentStore *store = (_MetisDiskContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    return store->objectCapacity;
+}
+
+static size_t
+_metisDiskContentStore_GetObjectCount(MetisContentStoreInterface *storeImpl)
+{
+    _MetisDiskContentStore *store = (_MetisDiskContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    return store->objectCount;
+}
+
+static size_t
+_metisDiskContentStore_GetByteCapacity(MetisContentStoreInterface *storeImpl)
+{
+    _MetisDiskContentStore *store = (_MetisDiskContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    return store->byteCapacity;
+}
+
+static size_t
+_metisDiskContentStore_GetByteCount(MetisContentStoreInterface *storeImpl)
+{
+    _MetisDiskContentStore *store = (_MetisDiskContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    return store->byteCount;
+}
+
+// ======================================================================
+// Lifecycle
+
+static void
+_MetisContentStoreInterface_Destroy(MetisContentStoreInterface **storeImplPtr)
+{
+    _MetisDiskContentStore *store = metisContentStoreInterface_GetPrivateData(*storeImplPtr);
+
+    parcObject_Release((PARCObject **) &store);
+}
+
+static bool
+_MetisDiskContentStore_Destructor(_MetisDiskContentStore **storePtr)
+{
+    _MetisDiskContentStore *store = *storePtr;
+
+    _metisDiskContentStore_ReleaseLastMatch(store);
+
+    if (store->buckets) {
+        for (size_t i = 0; i < store->bucketCount; i++) {
+            while (store->buckets[i]) {
+                _metisDiskContentStore_IndexRemove(store, &store->buckets[i]);
+            }
+        }
+        parcMemory_Deallocate((void **) &store->buckets);
+    }
+
+    // The segments stay on disk for the next store to recover
+    if (store->segments) {
+        for (size_t i = 0; i < store->segmentCount; i++) {
+            _metisDiskContentStore_CloseSegment(store, &store->segments[i], false);
+        }
+        parcMemory_Deallocate((void **) &store->segments);
+    }
+
+    parcMemory_Deallocate((void **) &store->directory);
+    metisLogger_Release(&store->logger);
+
+    return true;
+}
+
+parcObject_Override(_MetisDiskContentStore, PARCObject,
+                    .destructor = (PARCObjectDestructor *) _MetisDiskContentStore_Destructor
+                    );
+
+parcObject_ExtendPARCObject(_MetisDiskContentStoreInterface,
+                            _MetisContentStoreInterface_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static parcObject_ImplementAcquire(_metisDiskContentStore, MetisContentStoreInterface);
+static parcObject_ImplementRelease(_metisDiskContentStore, MetisContentStoreInterface);
+
+static int
+_metisDiskContentStore_CompareSegmentId(const void *a, const void *b)
+{
+    uint32_t idA = *(const uint32_t *) a;
+    uint32_t idB = *(const uint32_t *) b;
+    return (idA < idB) ? -1 : (idA > idB) ? 1 : 0;
+}
+
+/**
+ * Map the segment files already in the directory and index their live records
+ */
+static void
+_metisDiskContentStore_Recover(_MetisDiskContentStore *store)
+{
+    DIR *dir = opendir(store->directory);
+    if (dir == NULL) {
+        return;
+    }
+
+    size_t idCapacity = 16;
+    size_t idCount = 0;
+    uint32_t *ids = parcMemory_Allocate(idCapacity * sizeof(uint32_t));
+    assertNotNull(ids, "parcMemory_Allocate(%zu) returned NULL", idCapacity * sizeof(uint32_t));
+
+    struct dirent *dirent;
+    while ((dirent = readdir(dir)) != NULL) {
+        uint32_t segmentId;
+        char suffix[8];
+        if (sscanf(dirent->d_name, METIS_DISK_SEGMENT_PREFIX "%8" SCNu32 "%7s", &segmentId, suffix) == 2
+            && strcmp(suffix, METIS_DISK_SEGMENT_SUFFIX) == 0) {
+            if (idCount == idCapacity) {
+                idCapacity *= 2;
+                ids = parcMemory_Reallocate(ids, idCapacity * sizeof(uint32_t));
+                assertNotNull(ids, "parcMemory_Reallocate(%zu) returned NULL", idCapacity * sizeof(uint32_t));
+            }
+            ids[idCount++] = segmentId;
+        }
+    }
+    closedir(dir);
+
+    qsort(ids, idCount, sizeof(uint32_t), _metisDiskContentStore_CompareSegmentId);
+
+    for (size_t i = 0; i < idCount; i++) {
+        if (ids[i] >= store->nextSegmentId) {
+            store->nextSegmentId = ids[i] + 1;
+        }
+
+        // Keep the newest maxSegments, the first append will drop the oldest of them
+        if (idCount - i > store->maxSegments) {
+            char path[PATH_MAX];
+            _metisDiskContentStore_SegmentPath(store, ids[i], path, sizeof(path));
+            unlink(path);
+            continue;
+        }
+
+        _MetisDiskSegment *segment = _metisDiskContentStore_OpenSegment(store, ids[i], false);
+        if (segment) {
+            store->segments[store->segmentCount++] = segment;
+            _metisDiskContentStore_ForEachRecord(store, segment, _metisDiskContentStore_IndexRecord);
+        }
+    }
+
+    parcMemory_Deallocate((void **) &ids);
+
+    while (store->objectCapacity > 0 && store->objectCount > store->objectCapacity) {
+        _metisDiskContentStore_DropOldestSegment(store);
+    }
+
+    if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Info)) {
+        metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Info, __func__,
+                        "DiskContentStore %p recovered %zu objects (%zu bytes) from %zu segments in %s",
+                        (void *) store, store->objectCount, store->byteCount, store->segmentCount, store->directory);
+    }
+}
+
+static bool
+_metisDiskContentStore_Init(_MetisDiskContentStore *store, MetisContentStoreConfig *config, const char *directory, MetisLogger *logger)
+{
+    store->logger = metisLogger_Acquire(logger);
+    store->directory = parcMemory_StringDuplicate(directory, strlen(directory));
+
+    store->objectCapacity = config->objectCapacity;
+    store->byteCapacity = (config->byteCapacity > 0) ? config->byteCapacity : METIS_DISK_CONTENT_STORE_DEFAULT_BYTES;
+
+    // About 8 segments per store, so dropping one loses an eighth of the cache
+    size_t segmentBytes = store->byteCapacity / 8;
+    if (segmentBytes < METIS_DISK_MIN_SEGMENT_BYTES) {
+        segmentBytes = METIS_DISK_MIN_SEGMENT_BYTES;
+    } else if (segmentBytes > METIS_DISK_MAX_SEGMENT_BYTES) {
+        segmentBytes = METIS_DISK_MAX_SEGMENT_BYTES;
+    }
+    store->segmentBytes = (segmentBytes + 4095) & ~((size_t) 4095);
+
+    store->maxSegments = store->byteCapacity / store->segmentBytes;
+    if (store->maxSegments < METIS_DISK_MIN_SEGMENTS) {
+        store->maxSegments = METIS_DISK_MIN_SEGMENTS;
+    }
+
+    store->segments = parcMemory_AllocateAndClear(store->maxSegments * sizeof(_MetisDiskSegment *));
+    assertNotNull(store->segments, "parcMemory_AllocateAndClear(%zu) returned NULL", store->maxSegments * sizeof(_MetisDiskSegment *));
+
+    store->bucketCount = METIS_DISK_INITIAL_BUCKETS;
+    store->buckets = parcMemory_AllocateAndClear(store->bucketCount * sizeof(_MetisDiskIndexEntry *));
+    assertNotNull(store->buckets, "parcMemory_AllocateAndClear(%zu) returned NULL", store->bucketCount * sizeof(_MetisDiskIndexEntry *));
+
+    if (mkdir(directory, 0700) != 0 && errno != EEXIST) {
+        if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error)) {
+            metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error, __func__,
+                            "DiskContentStore could not create directory %s: (%d) %s",
+                            directory, errno, strerror(errno));
+        }
+        return false;
+    }
+
+    _metisDiskContentStore_Recover(store);
+    return true;
+}
+
+MetisContentStoreInterface *
+metisDiskContentStore_Create(MetisContentStoreConfig *config, const char *directory, MetisLogger *logger)
+{
+    assertNotNull(config, "Parameter config must be non-null");
+    assertNotNull(directory, "Parameter directory must be non-null");
+    assertNotNull(logger, "MetisDiskContentStore requires a non-NULL logger");
+
+    MetisContentStoreInterface *storeImpl = parcObject_CreateAndClearInstance(_MetisDiskContentStoreInterface);
+    assertNotNull(storeImpl, "parcObject_CreateAndClearInstance returned NULL");
+
+    storeImpl->_privateData = parcObject_CreateAndClearInstance(_MetisDiskContentStore);
+
+    storeImpl->putContent = &_metisDiskContentStore_PutContent;
+    storeImpl->removeContent = &_metisDiskContentStore_RemoveContent;
+
+    storeImpl->matchInterest = &_metisDiskContentStore_MatchInterest;
+
+    storeImpl->getObjectCount = &_metisDiskContentStore_GetObjectCount;
+    storeImpl->getObjectCapacity = &_metisDiskContentStore_GetObjectCapacity;
+    storeImpl->getByteCount = &_metisDiskContentStore_GetByteCount;
+    storeImpl->getByteCapacity = &_metisDiskContentStore_GetByteCapacity;
+
+    storeImpl->log = &_metisDiskContentStore_Log;
+    storeImpl->accumulateStats = &_metisDiskContentStore_AccumulateStats;
+
+    storeImpl->acquire = &_metisDiskContentStore_Acquire;
+    storeImpl->release = &_metisDiskContentStore_Release;
+
+    if (!_metisDiskContentStore_Init(storeImpl->_privateData, config, directory, logger)) {
+        metisContentStoreInterface_Release(&storeImpl);
+        return NULL;
+    }
+
+    if (metisLogger_IsLoggable(logger, MetisLoggerFacility_Processor, PARCLogLevel_Info)) {
+        metisLogger_Log(logger, MetisLoggerFacility_Processor, PARCLogLevel_Info, __func__,
+                        "DiskContentStore %p created in %s with byte capacity %zu (%zu segments of %zu bytes)",
+                        (void *) storeImpl, directory, metisContentStoreInterface_GetByteCapacity(storeImpl),
+                        ((_MetisDiskContentStore *) storeImpl->_privateData)->maxSegments,
+                        ((_MetisDiskContentStore *) storeImpl->_privateData)->segmentBytes);
+    }
+
+    return storeImpl;
+}
+
+size_t
+metisDiskContentStore_GetSegmentCount(MetisContentStoreInterface *storeImpl)
+{
+    _MetisDiskContentStore *store = (_MetisDiskContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    return store->segmentCount;
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_DiskContentStore.h
+ * @brief A persistent content store kept in memory-mapped segment files
+ *
+ * The disk content store is an append-only log of ContentObjects.  The log is split in to fixed size
+ * segment files in a directory, each mapped in to memory.  An in-memory index by name hash points
+ * at the records.  When the store is full, the oldest segment is dropped as a whole, so eviction is
+ * FIFO at segment granularity and never rewrites data.
+ *
+ * The store is meant as the second tier behind a {@link metisLRUContentStore_Create} store (see
+ * `MetisContentStoreConfig.secondTier`), but it implements the full MetisContentStoreInterface.
+ *
+ * Because the segments are files, a new store created on the same directory recovers the index
+ * from the existing segments.  A forwarder restart therefore comes up with a warm cache.
+ *
+ * The message returned by matchInterest is materialized from the mapped segment.  It is owned by
+ * the store and is only valid until the next call to matchInterest or until the store is released.
+ * Acquire it to keep it longer.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_DiskContentStore_h
+#define Metis_metis_DiskContentStore_h
+
+#include <stdio.h>
+#include <ccnx/forwarder/metis/content_store/metis_ContentStoreInterface.h>
+#include <ccnx/forwarder/metis/core/metis_Logger.h>
+
+/**
+ * The disk budget used when `MetisContentStoreConfig.byteCapacity` is 0
+ */
+#define METIS_DISK_CONTENT_STORE_DEFAULT_BYTES (1024ULL * 1024 * 1024)
+
+/**
+ * Create a disk content store in a directory
+ *
+ * The directory is created if it does not exist.  Any segment files already in it are recovered.
+ *
+ * `config->byteCapacity` is the disk budget; 0 uses METIS_DISK_CONTENT_STORE_DEFAULT_BYTES.
+ * `config->objectCapacity` limits the number of indexed objects; 0 means the store is only limited by bytes.
+ * The budget is rounded to whole segments and is always at least two segments.
+ *
+ * @param [in] config The capacities of the store
+ * @param [in] directory The directory holding the segment files
+ * @param [in] logger An instance of a {@link MetisLogger} to use for logging content store events.
+ *
+ * @return non-null A new store, release with {@link metisContentStoreInterface_Release}
+ * @return null The directory could not be created or opened
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisContentStoreConfig config = {
+ *         .byteCapacity = 256 * 1024 * 1024
+ *     };
+ *
+ *     MetisContentStoreInterface *store = metisDiskContentStore_Create(&config, "/var/cache/metis", logger);
+ *     metisContentStoreInterface_Release(&store);
+ * }
+ * @endcode
+ */
+MetisContentStoreInterface *metisDiskContentStore_Create(MetisContentStoreConfig *config, const char *directory, MetisLogger *logger);
+
+/**
+ * The number of segment files currently used by the store
+ *
+ * @param [in] storeImpl A store created by metisDiskContentStore_Create
+ *
+ * @return The number of mapped segments
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t segments = metisDiskContentStore_GetSegmentCount(store);
+ * }
+ * @endcode
+ */
+size_t metisDiskContentStore_GetSegmentCount(MetisContentStoreInterface *storeImpl);
+#endif // Metis_metis_DiskContentStore_h
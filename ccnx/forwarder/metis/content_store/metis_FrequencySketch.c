@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * The table is METIS_FREQUENCY_SKETCH_DEPTH rows of `width` 4-bit counters, packed 16 to a word.
+ * The key's hash is mixed once, then multiplied by a different odd constant for each row and the
+ * top bits of the product pick the counter in that row.
+ *
+ * Increments are conservative: only the key's smallest counters go up, as the others already
+ * count more than the key's accesses.  This keeps a scan of many new keys from inflating the
+ * counts of keys it collides with.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+
+#include <ccnx/forwarder/metis/content_store/metis_FrequencySketch.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <LongBow/runtime.h>
+
+#define METIS_FREQUENCY_SKETCH_DEPTH          4
+#define METIS_FREQUENCY_SKETCH_MIN_WIDTH      16
+#define METIS_FREQUENCY_SKETCH_MAX_WIDTH      (((size_t) 1) << 30)
+#define METIS_FREQUENCY_SKETCH_COUNTER_BITS   4
+#define METIS_FREQUENCY_SKETCH_COUNTER_MAX    15
+#define METIS_FREQUENCY_SKETCH_COUNTERS_PER_WORD 16
+
+// Counters per row for each object in the cache, and accesses counted per cached object
+// before the counters are halved
+#define METIS_FREQUENCY_SKETCH_WIDTH_FACTOR   4
+#define METIS_FREQUENCY_SKETCH_SAMPLE_FACTOR  10
+
+// Clears the bit each counter shifts in from its neighbour when the word is halved
+#define METIS_FREQUENCY_SKETCH_HALF_MASK      0x7777777777777777ULL
+
+static const uint64_t _metisFrequencySketch_Seeds[METIS_FREQUENCY_SKETCH_DEPTH] = {
+    0x9E3779B97F4A7C15ULL,
+    0xC2B2AE3D27D4EB4FULL,
+    0x165667B19E3779F9ULL,
+    0xD6E8FEB86659FD93ULL,
+};
+
+struct metis_frequency_sketch {
+    uint64_t *table;
+
+    // counters per row, a power of two
+    size_t width;
+    unsigned widthBits;
+    size_t wordsPerRow;
+
+    size_t additions;
+    size_t sampleSize;
+};
+
+MetisFrequencySketch *
+metisFrequencySketch_Create(size_t capacity)
+{
+    size_t width = METIS_FREQUENCY_SKETCH_MIN_WIDTH;
+    unsigned widthBits = 4;
+    while (width / METIS_FREQUENCY_SKETCH_WIDTH_FACTOR < capacity && width < METIS_FREQUENCY_SKETCH_MAX_WIDTH) {
+        width <<= 1;
+        widthBits++;
+    }
+
+    MetisFrequencySketch *sketch = parcMemory_AllocateAndClear(sizeof(MetisFrequencySketch));
+    assertNotNull(sketch, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisFrequencySketch));
+
+    sketch->width = width;
+    sketch->widthBits = widthBits;
+    sketch->wordsPerRow = width / METIS_FREQUENCY_SKETCH_COUNTERS_PER_WORD;
+    sketch->sampleSize = (width / METIS_FREQUENCY_SKETCH_WIDTH_FACTOR) * METIS_FREQUENCY_SKETCH_SAMPLE_FACTOR;
+
+    size_t length = sizeof(uint64_t) * sketch->wordsPerRow * METIS_FREQUENCY_SKETCH_DEPTH;
+    sketch->table = parcMemory_AllocateAndClear(length);
+    assertNotNull(sketch->table, "parcMemory_AllocateAndClear(%zu) returned NULL", length);
+
+    return sketch;
+}
+
+void
+metisFrequencySketch_Destroy(MetisFrequencySketch **sketchPtr)
+{
+    assertNotNull(sketchPtr, "Parameter must be non-null double pointer");
+    assertNotNull(*sketchPtr, "Parameter must dereference to non-null pointer");
+
+    MetisFrequencySketch *sketch = *sketchPtr;
+    parcMemory_Deallocate((void **) &sketch->table);
+    parcMemory_Deallocate((void **) sketchPtr);
+}
+
+/**
+ * The name hashes are not well mixed in their high bits, which pick the counters, so mix them first
+ */
+static uint64_t
+_metisFrequencySketch_Mix(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * Returns the word holding the key's counter in `row`, and sets `shift` to the counter's bit offset
+ */
+static uint64_t *
+_metisFrequencySketch_Counter(const MetisFrequencySketch *sketch, uint64_t mixed, unsigned row, unsigned *shift)
+{
+    size_t index = (size_t) ((mixed * _metisFrequencySketch_Seeds[row]) >> (64 - sketch->widthBits));
+    *shift = (unsigned) (index % METIS_FREQUENCY_SKETCH_COUNTERS_PER_WORD) * METIS_FREQUENCY_SKETCH_COUNTER_BITS;
+    return &sketch->table[row * sketch->wordsPerRow + index / METIS_FREQUENCY_SKETCH_COUNTERS_PER_WORD];
+}
+
+static void
+_metisFrequencySketch_Halve(MetisFrequencySketch *sketch)
+{
+    size_t words = sketch->wordsPerRow * METIS_FREQUENCY_SKETCH_DEPTH;
+    for (size_t i = 0; i < words; i++) {
+        sketch->table[i] = (sketch->table[i] >> 1) & METIS_FREQUENCY_SKETCH_HALF_MASK;
+    }
+    sketch->additions /= 2;
+}
+
+void
+metisFrequencySketch_Increment(MetisFrequencySketch *sketch, uint64_t hash)
+{
+    assertNotNull(sketch, "Parameter sketch must be non-null");
+
+    uint64_t mixed = _metisFrequencySketch_Mix(hash);
+    uint64_t *words[METIS_FREQUENCY_SKETCH_DEPTH];
+    unsigned shifts[METIS_FREQUENCY_SKETCH_DEPTH];
+    unsigned counts[METIS_FREQUENCY_SKETCH_DEPTH];
+    unsigned minimum = METIS_FREQUENCY_SKETCH_COUNTER_MAX;
+
+    for (unsigned row = 0; row < METIS_FREQUENCY_SKETCH_DEPTH; row++) {
+        words[row] = _metisFrequencySketch_Counter(sketch, mixed, row, &shifts[row]);
+        counts[row] = (unsigned) ((*words[row] >> shifts[row]) & METIS_FREQUENCY_SKETCH_COUNTER_MAX);
+        if (counts[row] < minimum) {
+            minimum = counts[row];
+        }
+    }
+
+    if (minimum == METIS_FREQUENCY_SKETCH_COUNTER_MAX) {
+        return;
+    }
+
+    for (unsigned row = 0; row < METIS_FREQUENCY_SKETCH_DEPTH; row++) {
+        if (counts[row] == minimum) {
+            *words[row] += ((uint64_t) 1) << shifts[row];
+        }
+    }
+
+    if (++sketch->additions >= sketch->sampleSize) {
+        _metisFrequencySketch_Halve(sketch);
+    }
+}
+
+unsigned
+metisFrequencySketch_Estimate(const MetisFrequencySketch *sketch, uint64_t hash)
+{
+    assertNotNull(sketch, "Parameter sketch must be non-null");
+
+    uint64_t mixed = _metisFrequencySketch_Mix(hash);
+    unsigned estimate = METIS_FREQUENCY_SKETCH_COUNTER_MAX;
+    for (unsigned row = 0; row < METIS_FREQUENCY_SKETCH_DEPTH; row++) {
+        unsigned shift;
+        uint64_t *word = _metisFrequencySketch_Counter(sketch, mixed, row, &shift);
+        unsigned count = (unsigned) ((*word >> shift) & METIS_FREQUENCY_SKETCH_COUNTER_MAX);
+        if (count < estimate) {
+            estimate = count;
+        }
+    }
+    return estimate;
+}
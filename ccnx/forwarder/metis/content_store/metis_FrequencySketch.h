@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_FrequencySketch.h
+ * @brief Approximate access counts for the content store's admission policy
+ *
+ * A count-min sketch of 4-bit counters.  Each key is counted in one counter of each of four rows
+ * and its estimate is the smallest of the four, so a collision can only make a key look more
+ * popular than it is.  Counters saturate at 15.
+ *
+ * To follow changes in popularity, every counter is halved once the sketch has counted ten
+ * accesses for each object in the cache.  A key that stops being asked for fades out.
+ *
+ * The sketch takes a 64-bit hash of the key, not the key.  The content store uses the name hash,
+ * so an interest and the object that answers it count as the same key.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_FrequencySketch_h
+#define Metis_metis_FrequencySketch_h
+
+#include <stdint.h>
+#include <stdlib.h>
+
+struct metis_frequency_sketch;
+typedef struct metis_frequency_sketch MetisFrequencySketch;
+
+/**
+ * Creates a sketch sized for a cache of `capacity` objects
+ *
+ * Each row has the next power of two at or above 4 * `capacity` counters, so the sketch takes
+ * about 8 bytes per cached object.  The counters are halved after 10 * `capacity` accesses.
+ *
+ * @param [in] capacity The number of objects the cache holds
+ *
+ * @return non-null An allocated sketch with every count at 0
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisFrequencySketch *sketch = metisFrequencySketch_Create(100000);
+ *     metisFrequencySketch_Destroy(&sketch);
+ * }
+ * @endcode
+ */
+MetisFrequencySketch *metisFrequencySketch_Create(size_t capacity);
+
+/**
+ * Destroys the sketch
+ *
+ * @param [in,out] sketchPtr Pointer to the sketch, will be NULL'd
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisFrequencySketch *sketch = metisFrequencySketch_Create(100000);
+ *     metisFrequencySketch_Destroy(&sketch);
+ * }
+ * @endcode
+ */
+void metisFrequencySketch_Destroy(MetisFrequencySketch **sketchPtr);
+
+/**
+ * Counts one access to a key
+ *
+ * @param [in] sketch An allocated sketch
+ * @param [in] hash A hash of the key
+ *
+ * Example:
+ * @code
+ * {
+ *     metisFrequencySketch_Increment(sketch, metisHashTableFunction_MessageNameHashCode(interest));
+ * }
+ * @endcode
+ */
+void metisFrequencySketch_Increment(MetisFrequencySketch *sketch, uint64_t hash);
+
+/**
+ * Returns the approximate number of recent accesses to a key
+ *
+ * @param [in] sketch An allocated sketch
+ * @param [in] hash A hash of the key
+ *
+ * @return A count from 0 to 15, never less than the accesses counted since the last halving
+ *
+ * Example:
+ * @code
+ * {
+ *     bool admit = metisFrequencySketch_Estimate(sketch, candidateHash) > metisFrequencySketch_Estimate(sketch, victimHash);
+ * }
+ * @endcode
+ */
+unsigned metisFrequencySketch_Estimate(const MetisFrequencySketch *sketch, uint64_t hash);
+#endif // Metis_metis_FrequencySketch_h
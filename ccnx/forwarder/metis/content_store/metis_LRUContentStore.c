@@ -59,92 +59,46 @@
 
 /*
  * - Uses an LRU to manage evictions.
+ * - Limits the number of objects and, if byteCapacity is set, the sum of their metisMessage_Length().
+ *   A large object may evict several small ones to fit the byte budget.
+ * - With a second tier, LRU evictions are demoted to it (expired and RCT evictions are not), a miss
+ *   that hits the second tier promotes the object back, and the store demotes everything it holds
+ *   when it is destroyed, so a persistent second tier keeps the whole cache across a restart.
+ * - The tables are a MetisContentStoreIndex.  Objects are stored by name hash and a sequence number,
+ *   so storing an object does not compute its SHA-256 ContentObjectHash.  The hash is computed (and
+ *   kept by the message) only when an interest with a ContentObjectHash restriction asks for the
+ *   name, or when a second object with the same name arrives and its bytes differ from the first.
+ * - The limits may be changed in place.  Growing just raises them, the hash tables grow as objects
+ *   arrive.  Shrinking leaves the store over its limits: a put then evicts only enough to make room
+ *   for itself, and metisContentStoreInterface_Trim() evicts the excess in bounded batches.
  * - Does not implement content object cache directives (case 739).
  */
 
 #include <config.h>
 #include <stdio.h>
-#include <sys/queue.h>
+#include <string.h>
+#include <inttypes.h>
 
 #include <parc/algol/parc_Object.h>
-#include <parc/algol/parc_HashCodeTable.h>
-#include <parc/algol/parc_DisplayIndented.h>
 
 #include <ccnx/forwarder/metis/core/metis_Logger.h>
 
 #include <ccnx/forwarder/metis/content_store/metis_LRUContentStore.h>
 
 #include <ccnx/forwarder/metis/content_store/metis_ContentStoreInterface.h>
+#include <ccnx/forwarder/metis/content_store/metis_ContentStoreIndex.h>
 #include <ccnx/forwarder/metis/content_store/metis_ContentStoreEntry.h>
 #include <ccnx/forwarder/metis/content_store/metis_LruList.h>
-#include <ccnx/forwarder/metis/content_store/metis_TimeOrderedList.h>
-
-#include <ccnx/forwarder/metis/processor/metis_HashTableFunction.h>
-
-typedef struct metis_lru_contentstore_stats {
-    uint64_t countExpiryEvictions;
-    uint64_t countRCTEvictions;
-    uint64_t countLruEvictions;
-    uint64_t countAdds;
-    uint64_t countHits;
-    uint64_t countMisses;
-} _MetisLRUContentStoreStats;
 
+#include <LongBow/runtime.h>
 
 typedef struct metis_lru_contentstore_data {
-    size_t objectCapacity;
-    size_t objectCount;
-
-    MetisLogger *logger;
+    MetisContentStoreIndex index;
 
     // This LRU is just for keeping track of insertion and access order.
     MetisLruList *lru;
-
-    // These are indexes by name and key ID hash
-    PARCHashCodeTable *indexByNameHash;
-    PARCHashCodeTable *indexByNameAndKeyIdHash;
-
-    // These are indexes by time.
-    MetisTimeOrderedList *indexByRecommendedCacheTime;
-    MetisTimeOrderedList *indexByExpirationTime;
-
-    // This table is responsible for Releasing our ContentStoreEntries.
-    PARCHashCodeTable *storageByNameAndObjectHashHash;
-
-    _MetisLRUContentStoreStats stats;
 } _MetisLRUContentStore;
 
-
-
-static void
-_destroyIndexes(_MetisLRUContentStore *store)
-{
-    if (store->indexByNameHash != NULL) {
-        parcHashCodeTable_Destroy(&(store->indexByNameHash));
-    }
-
-    if (store->indexByNameAndKeyIdHash != NULL) {
-        parcHashCodeTable_Destroy(&(store->indexByNameAndKeyIdHash));
-    }
-
-    if (store->indexByRecommendedCacheTime != NULL) {
-        metisTimeOrderedList_Release(&(store->indexByRecommendedCacheTime));
-    }
-
-    if (store->indexByExpirationTime != NULL) {
-        metisTimeOrderedList_Release(&(store->indexByExpirationTime));
-    }
-
-    // This tables must go last. It holds the references to the MetisMessage.
-    if (store->storageByNameAndObjectHashHash != NULL) {
-        parcHashCodeTable_Destroy(&(store->storageByNameAndObjectHashHash));
-    }
-
-    if (store->lru != NULL) {
-        metisLruList_Destroy(&(store->lru));
-    }
-}
-
 static void
 _MetisContentStoreInterface_Destroy(MetisContentStoreInterface **storeImplPtr)
 {
@@ -153,14 +107,28 @@ _MetisContentStoreInterface_Destroy(MetisContentStoreInterface **storeImplPtr)
     parcObject_Release((PARCObject **) &store);
 }
 
+static bool _metisLRUContentStore_RemoveLeastUsed(_MetisLRUContentStore *store, uint64_t currentTimeTicks);
+
 static bool
 _MetisLRUContentStore_Destructor(_MetisLRUContentStore **storePtr)
 {
     _MetisLRUContentStore *store = *storePtr;
-   
-    _destroyIndexes(store);
-    metisLogger_Release(&store->logger);
-   
+
+    if (store->index.secondTier) {
+        // Demote from the tail, so the most recently used objects are the newest in the second tier.
+        // We do not know the time here; 0 keeps the second tier from rejecting anything as expired.
+        while (store->index.objectCount > 0) {
+            _metisLRUContentStore_RemoveLeastUsed(store, 0);
+        }
+    }
+
+    // The index releases the entries, which takes them off the LRU, so it goes first
+    metisContentStoreIndex_Destroy(&store->index);
+
+    if (store->lru != NULL) {
+        metisLruList_Destroy(&(store->lru));
+    }
+
     return true;
 }
 
@@ -174,125 +142,37 @@ parcObject_ExtendPARCObject(MetisContentStoreInterface,
 static parcObject_ImplementAcquire(_metisLRUContentStore, MetisContentStoreInterface);
 static parcObject_ImplementRelease(_metisLRUContentStore, MetisContentStoreInterface);
 
-static void
-_hashTableFunction_ContentStoreEntryDestroyer(void **dataPtr)
-{
-    metisContentStoreEntry_Release((MetisContentStoreEntry **) dataPtr);
-}
-
 static bool
 _metisLRUContentStore_Init(_MetisLRUContentStore *store, MetisContentStoreConfig *config, MetisLogger *logger)
 {
-    bool result = false;
-
-    store->logger = metisLogger_Acquire(logger);
-
-    size_t initialSize = config->objectCapacity * 2;
-    memset(&store->stats, 0, sizeof(_MetisLRUContentStoreStats));
-
-    store->objectCapacity = config->objectCapacity;
-    store->objectCount = 0;
-
-    // initial size must be at least 1 or else the data structures break.
-    initialSize = (initialSize == 0) ? 1 : initialSize;
-
-    store->indexByExpirationTime =
-        metisTimeOrderedList_Create((MetisTimeOrderList_KeyCompare *) metisContentStoreEntry_CompareExpiryTime);
-
-    store->indexByRecommendedCacheTime =
-        metisTimeOrderedList_Create((MetisTimeOrderList_KeyCompare *) metisContentStoreEntry_CompareRecommendedCacheTime);
-
-    store->indexByNameHash = parcHashCodeTable_Create_Size(metisHashTableFunction_MessageNameEquals,
-                                                           metisHashTableFunction_MessageNameHashCode,
-                                                           NULL,
-                                                           NULL,
-                                                           initialSize);
-
-    store->indexByNameAndKeyIdHash = parcHashCodeTable_Create_Size(metisHashTableFunction_MessageNameAndKeyIdEquals,
-                                                                   metisHashTableFunction_MessageNameAndKeyIdHashCode,
-                                                                   NULL,
-                                                                   NULL,
-                                                                   initialSize);
-
-    store->storageByNameAndObjectHashHash = parcHashCodeTable_Create_Size(metisHashTableFunction_MessageNameAndObjectHashEquals,
-                                                                          metisHashTableFunction_MessageNameAndObjectHashHashCode,
-                                                                          NULL,
-                                                                          _hashTableFunction_ContentStoreEntryDestroyer,
-                                                                          initialSize);
+    if (!metisContentStoreIndex_Init(&store->index, "LRUContentStore", config, logger)) {
+        return false;
+    }
 
     store->lru = metisLruList_Create();
-
-    // If any of the index tables couldn't be allocated, we can't continue.
-    if ((store->indexByExpirationTime == NULL)
-        || (store->indexByNameAndKeyIdHash == NULL)
-        || (store->indexByNameHash == NULL)
-        || (store->indexByRecommendedCacheTime == NULL)
-        || (store->storageByNameAndObjectHashHash == NULL)
-        || (store->lru == NULL)) {
-        if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error)) {
-            metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error, __func__,
-                            "LRUContentStore could not be created. Could not allocate all index tables.",
-                            (void *) store, store->objectCapacity);
+    if (store->lru == NULL) {
+        if (metisLogger_IsLoggable(logger, MetisLoggerFacility_Processor, PARCLogLevel_Error)) {
+            metisLogger_Log(logger, MetisLoggerFacility_Processor, PARCLogLevel_Error, __func__,
+                            "LRUContentStore %p could not be created. Could not allocate the LRU.",
+                            (void *) store);
         }
 
-        _destroyIndexes(store);
-        result = false;
-    } else {
-        result = true;
-    }
-    return result;
-}
-
-/**
- * Remove a MetisContentStoreEntry from all tables and indices.
- */
-static void
-_metisLRUContentStore_PurgeStoreEntry(_MetisLRUContentStore *store, MetisContentStoreEntry *entryToPurge)
-{
-    if (metisContentStoreEntry_HasExpiryTimeTicks(entryToPurge)) {
-        metisTimeOrderedList_Remove(store->indexByExpirationTime, entryToPurge);
-    }
-
-    if (metisContentStoreEntry_HasRecommendedCacheTimeTicks(entryToPurge)) {
-        metisTimeOrderedList_Remove(store->indexByRecommendedCacheTime, entryToPurge);
-    }
-
-    MetisMessage *content = metisContentStoreEntry_GetMessage(entryToPurge);
-    parcHashCodeTable_Del(store->indexByNameHash, content);
-
-    if (metisMessage_HasKeyId(content)) {
-        parcHashCodeTable_Del(store->indexByNameAndKeyIdHash, content);
+        metisContentStoreIndex_Destroy(&store->index);
+        return false;
     }
-
-    // This _Del call will call the Release/Destroy on the ContentStoreEntry,
-    // which will remove it from the LRU as well.
-    parcHashCodeTable_Del(store->storageByNameAndObjectHashHash, content);
-
-    store->objectCount--;
+    return true;
 }
 
 static bool
-_metisLRUContentStore_RemoveLeastUsed(_MetisLRUContentStore *store)
+_metisLRUContentStore_RemoveLeastUsed(_MetisLRUContentStore *store, uint64_t currentTimeTicks)
 {
-    bool result = false;
-
-    if (store->objectCount > 0) {
-        MetisLruListEntry *lruEntry = metisLruList_PopTail(store->lru);
-        MetisContentStoreEntry *storeEntry =
-            (MetisContentStoreEntry *) metisLruList_EntryGetData(lruEntry);
-
-        if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
-            metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                            "ContentStore %p evict message %p by LRU (LRU evictions %" PRIu64 ")",
-                            (void *) store, (void *) metisContentStoreEntry_GetMessage(storeEntry),
-                            store->stats.countLruEvictions);
-        }
-
-        _metisLRUContentStore_PurgeStoreEntry(store, storeEntry);
-
-        result = true;
+    MetisLruListEntry *tail = metisLruList_PeekTail(store->lru);
+    if (tail == NULL) {
+        return false;
     }
-    return result;
+
+    metisContentStoreIndex_Evict(&store->index, metisLruList_EntryGetData(tail), currentTimeTicks);
+    return true;
 }
 
 static void
@@ -303,126 +183,45 @@ _evictByStorePolicy(_MetisLRUContentStore *store, uint64_t currentTimeInMetisTic
     //  2) Check to see if anything has exceeded it's recommended cache time. If so, remove it and we're done. If not,
     //  3) Remove the least recently used item.
 
-    MetisContentStoreEntry *entry = metisTimeOrderedList_GetOldest(store->indexByExpirationTime);
-    if (entry
-        && metisContentStoreEntry_HasExpiryTimeTicks(entry)
-        && (currentTimeInMetisTicks > metisContentStoreEntry_GetExpiryTimeTicks(entry))) {
-        // Found an expired entry. Remove it, and we're done.
-
-        store->stats.countExpiryEvictions++;
-        if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
-            metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                            "ContentStore %p evict message %p by ExpiryTime (ExpiryTime evictions %" PRIu64 ")",
-                            (void *) store, (void *) metisContentStoreEntry_GetMessage(entry),
-                            store->stats.countExpiryEvictions);
-        }
-
-        _metisLRUContentStore_PurgeStoreEntry(store, entry);
-    } else {
-        // Check for entries that have exceeded RCT
-        entry = metisTimeOrderedList_GetOldest(store->indexByRecommendedCacheTime);
-        if (entry
-            && metisContentStoreEntry_HasRecommendedCacheTimeTicks(entry)
-            && (currentTimeInMetisTicks > metisContentStoreEntry_GetRecommendedCacheTimeTicks(entry))) {
-            // Found an entry passed it's RCT. Remove it, and we're done.
-
-            store->stats.countRCTEvictions++;
-            if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
-                metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                                "ContentStore %p evict message %p by RCT (RCT evictions %" PRIu64 ")",
-                                (void *) store, (void *) metisContentStoreEntry_GetMessage(entry),
-                                store->stats.countRCTEvictions);
-            }
-
-            _metisLRUContentStore_PurgeStoreEntry(store, entry);
-        } else {
-            store->stats.countLruEvictions++;
-            _metisLRUContentStore_RemoveLeastUsed(store);
-        }
+    if (!metisContentStoreIndex_EvictStale(&store->index, currentTimeInMetisTicks)) {
+        metisStats_Increment(store->index.stats.countLruEvictions);
+        _metisLRUContentStore_RemoveLeastUsed(store, currentTimeInMetisTicks);
     }
 }
 
 static bool
-_metisLRUContentStore_PutContent(MetisContentStoreInterface *storeImpl, MetisMessage *content, uint64_t currentTimeTicks)
-
+_metisLRUContentStore_Put(void *context, MetisMessage *content, uint64_t currentTimeTicks)
 {
-    bool result = false;
-    _MetisLRUContentStore *store = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    _MetisLRUContentStore *store = (_MetisLRUContentStore *) context;
     assertNotNull(store, "Parameter store must be non-null");
-    assertNotNull(content, "Parameter objectMessage must be non-null");
-
-    assertTrue(metisMessage_GetType(content) == MetisMessagePacketType_ContentObject,
-               "Parameter objectMessage must be a Content Object");
 
-    if (store->objectCapacity == 0) {
+    if (!metisContentStoreIndex_CanStore(&store->index, content, currentTimeTicks)) {
         return false;
     }
 
-    uint64_t expiryTimeTicks = metisContentStoreEntry_MaxExpiryTime;
-    uint64_t recommendedCacheTimeTicks = metisContentStoreEntry_MaxRecommendedCacheTime;
-
-    if (metisMessage_HasExpiryTime(content)) {
-        expiryTimeTicks = metisMessage_GetExpiryTimeTicks(content);
-    }
-
-    if (metisMessage_HasRecommendedCacheTime(content)) {
-        recommendedCacheTimeTicks = metisMessage_GetRecommendedCacheTimeTicks(content);
-    }
-
-    // Don't add anything that's already expired or has exceeded RCT.
-    if (currentTimeTicks >= expiryTimeTicks || currentTimeTicks >= recommendedCacheTimeTicks) {
-        return false;
-    }
+    // A store that was shrunk is still over its limits.  Evicting all of the excess here would stall
+    // this put, so only make room for this object and leave the rest to trim.  This only stops the
+    // loop early when the store started over its limits.
+    size_t contentBytes = metisMessage_Length(content);
+    size_t startCount = store->index.objectCount;
+    size_t startBytes = store->index.byteCount;
+    while (metisContentStoreIndex_NeedsRoom(&store->index, contentBytes)) {
+        if (store->index.objectCount < startCount && store->index.byteCount + contentBytes <= startBytes) {
+            break;
+        }
 
-    if (store->objectCount >= store->objectCapacity) {
         // Store is full. Need to make room.
         _evictByStorePolicy(store, currentTimeTicks);
     }
 
     // And now add a new entry to the head of the LRU.
+    return metisContentStoreIndex_Add(&store->index, content, store->lru) != NULL;
+}
 
-    MetisContentStoreEntry *entry = metisContentStoreEntry_Create(content, store->lru);
-
-    if (entry != NULL) {
-        if (parcHashCodeTable_Add(store->storageByNameAndObjectHashHash, content, entry)) {
-            parcHashCodeTable_Add(store->indexByNameHash, content, entry);
-
-            if (metisMessage_HasKeyId(content)) {
-                parcHashCodeTable_Add(store->indexByNameAndKeyIdHash, content, entry);
-            }
-
-            if (metisContentStoreEntry_HasExpiryTimeTicks(entry)) {
-                metisTimeOrderedList_Add(store->indexByExpirationTime, entry);
-            }
-
-            if (metisContentStoreEntry_HasRecommendedCacheTimeTicks(entry)) {
-                metisTimeOrderedList_Add(store->indexByRecommendedCacheTime, entry);
-            }
-
-            store->objectCount++;
-            store->stats.countAdds++;
-
-            if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
-                metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                                "LRUContentStore %p saved message %p (object count %" PRIu64 ")",
-                                (void *) store, (void *) content, store->objectCount);
-            }
-
-            result = true;
-        } else {
-            // Free what we just created, but did not add. 'entry' has ownership of 'copy', and so will
-            // call _Release() on it
-            metisContentStoreEntry_Release(&entry);
-
-            if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Warning)) {
-                metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Warning, __func__,
-                                "LRUContentStore %p failed to add message %p to hash table",
-                                (void *) store, (void *) content);
-            }
-        }
-    }
-
-    return result;
+static bool
+_metisLRUContentStore_PutContent(MetisContentStoreInterface *storeImpl, MetisMessage *content, uint64_t currentTimeTicks)
+{
+    return _metisLRUContentStore_Put(metisContentStoreInterface_GetPrivateData(storeImpl), content, currentTimeTicks);
 }
 
 static MetisMessage *
@@ -431,108 +230,111 @@ _metisLRUContentStore_MatchInterest(MetisContentStoreInterface *storeImpl, Metis
     MetisMessage *result = NULL;
 
     _MetisLRUContentStore *store = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
-
     assertNotNull(store, "Parameter store must be non-null");
-    assertNotNull(interest, "Parameter interestMessage must be non-null");
-    assertTrue(metisMessage_GetType(interest) == MetisMessagePacketType_Interest,
-               "Parameter interestMessage must be an Interest");
-
-    // This will do the most restrictive lookup.
-    // a) If the interest has a ContentObjectHash restriction, it will look only in the ByNameAndObjectHash table.
-    // b) If it has a KeyId, it will look only in the ByNameAndKeyId table.
-    // c) otherwise, it looks only in the ByName table.
-
-    PARCHashCodeTable *table;
-    if (metisMessage_HasContentObjectHash(interest)) {
-        table = store->storageByNameAndObjectHashHash;
-    } else if (metisMessage_HasKeyId(interest)) {
-        table = store->indexByNameAndKeyIdHash;
-    } else {
-        table = store->indexByNameHash;
-    }
-
-    MetisContentStoreEntry *storeEntry = parcHashCodeTable_Get(table, interest);
 
+    MetisContentStoreEntry *storeEntry = metisContentStoreIndex_MatchInterest(&store->index, interest);
     if (storeEntry) {
         metisContentStoreEntry_MoveToHead(storeEntry);
         result = metisContentStoreEntry_GetMessage(storeEntry);
-
-        store->stats.countHits++;
-
-        if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
-            metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                            "LRUContentStore %p matched interest %p (hits %" PRIu64 ", misses %" PRIu64 ")",
-                            (void *) store, (void *) interest, store->stats.countHits, store->stats.countMisses);
-        }
-    } else {
-        store->stats.countMisses++;
-
-        if (metisLogger_IsLoggable(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
-            metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                            "LRUContentStore %p missed interest %p (hits %" PRIu64 ", misses %" PRIu64 ")",
-                            (void *) store, (void *) interest, store->stats.countHits, store->stats.countMisses);
-        }
+    } else if (store->index.secondTier) {
+        // A hit in the second tier is moved back in to this store if it fits
+        result = metisContentStoreIndex_Promote(&store->index, interest, _metisLRUContentStore_Put, store);
     }
 
+    metisContentStoreIndex_CountLookup(&store->index, interest, result);
     return result;
 }
 
 static bool
 _metisLRUContentStore_RemoveContent(MetisContentStoreInterface *storeImpl, MetisMessage *content)
 {
-    bool result = false;
     _MetisLRUContentStore *store = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
-
-    MetisContentStoreEntry *storeEntry = parcHashCodeTable_Get(store->storageByNameAndObjectHashHash, content);
-
-    if (storeEntry != NULL) {
-        _metisLRUContentStore_PurgeStoreEntry(store, storeEntry);
-        result = true;
-    }
-
-    return result;
+    return metisContentStoreIndex_Remove(&store->index, content);
 }
 
 static void
 _metisLRUContentStore_Log(MetisContentStoreInterface *storeImpl)
 {
     _MetisLRUContentStore *store = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    MetisContentStoreIndex *index = &store->index;
 
-    metisLogger_Log(store->logger, MetisLoggerFacility_Processor, PARCLogLevel_All, __func__,
-                    "MetisLRUContentStore @%p {count = %zu, capacity = %zu {"
+    metisLogger_Log(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_All, __func__,
+                    "MetisLRUContentStore @%p {count = %zu, capacity = %zu, bytes = %zu, byteCapacity = %zu {"
                     "stats = @%p {adds = %" PRIu64 ", hits = %" PRIu64 ", misses = %" PRIu64 ", LRUEvictons = %" PRIu64
-                    ", ExpiryEvictions = %" PRIu64 ", RCTEvictions = %" PRIu64 "} }",
+                    ", ExpiryEvictions = %" PRIu64 ", RCTEvictions = %" PRIu64
+                    ", Demotions = %" PRIu64 ", Promotions = %" PRIu64 "} }",
                     store,
-                    store->objectCount,
-                    store->objectCapacity,
-                    &store->stats,
-                    store->stats.countAdds,
-                    store->stats.countHits,
-                    store->stats.countMisses,
-                    store->stats.countLruEvictions,
-                    store->stats.countExpiryEvictions,
-                    store->stats.countRCTEvictions);
+                    index->objectCount,
+                    index->objectCapacity,
+                    index->byteCount,
+                    index->byteCapacity,
+                    &index->stats,
+                    index->stats.countAdds,
+                    index->stats.countHits,
+                    index->stats.countMisses,
+                    index->stats.countLruEvictions,
+                    index->stats.countExpiryEvictions,
+                    index->stats.countRCTEvictions,
+                    index->stats.countDemotions,
+                    index->stats.countPromotions);
+
+    if (index->secondTier) {
+        metisContentStoreInterface_Log(index->secondTier);
+    }
+}
+
+static void
+_metisLRUContentStore_AccumulateStats(MetisContentStoreInterface *storeImpl, MetisStats *stats)
+{
+    _MetisLRUContentStore *store = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    metisContentStoreIndex_AccumulateStats(&store->index, stats);
 }
 
 static size_t
 _metisLRUContentStore_GetObjectCapacity(MetisContentStoreInterface *storeImpl)
 {
     _MetisLRUContentStore *store = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
-    return store->objectCapacity;
+    return store->index.objectCapacity;
 }
 
 static size_t
 _metisLRUContentStore_GetObjectCount(MetisContentStoreInterface *storeImpl)
 {
     _MetisLRUContentStore *store = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
-    return store->objectCount;
+    return store->index.objectCount;
 }
 
 static size_t
-_metisLRUContentStore_SetObjectCapacity(MetisContentStoreInterface *storeImpl, size_t newCapacity)
+_metisLRUContentStore_GetByteCapacity(MetisContentStoreInterface *storeImpl)
 {
     _MetisLRUContentStore *store = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
-    return store->objectCapacity = newCapacity;
+    return store->index.byteCapacity;
+}
+
+static size_t
+_metisLRUContentStore_GetByteCount(MetisContentStoreInterface *storeImpl)
+{
+    _MetisLRUContentStore *store = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    return store->index.byteCount;
+}
+
+static void
+_metisLRUContentStore_SetCapacity(MetisContentStoreInterface *storeImpl, size_t objectCapacity, size_t byteCapacity)
+{
+    _MetisLRUContentStore *store = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    metisContentStoreIndex_SetCapacity(&store->index, objectCapacity, byteCapacity);
+}
+
+static bool
+_metisLRUContentStore_Trim(MetisContentStoreInterface *storeImpl, size_t maximumEvictions, uint64_t currentTimeTicks)
+{
+    _MetisLRUContentStore *store = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+
+    for (size_t i = 0; i < maximumEvictions && metisContentStoreIndex_IsOverCapacity(&store->index); i++) {
+        _evictByStorePolicy(store, currentTimeTicks);
+    }
+
+    return !metisContentStoreIndex_IsOverCapacity(&store->index);
 }
 
 MetisContentStoreInterface *
@@ -555,19 +357,22 @@ metisLRUContentStore_Create(MetisContentStoreConfig *config, MetisLogger *logger
 
             storeImpl->getObjectCount = &_metisLRUContentStore_GetObjectCount;
             storeImpl->getObjectCapacity = &_metisLRUContentStore_GetObjectCapacity;
+            storeImpl->getByteCount = &_metisLRUContentStore_GetByteCount;
+            storeImpl->getByteCapacity = &_metisLRUContentStore_GetByteCapacity;
 
             storeImpl->log = &_metisLRUContentStore_Log;
+            storeImpl->accumulateStats = &_metisLRUContentStore_AccumulateStats;
+            storeImpl->setCapacity = &_metisLRUContentStore_SetCapacity;
+            storeImpl->trim = &_metisLRUContentStore_Trim;
 
             storeImpl->acquire = &_metisLRUContentStore_Acquire;
             storeImpl->release = &_metisLRUContentStore_Release;
 
-            // Initialize from the config passed to us.
-            _metisLRUContentStore_SetObjectCapacity(storeImpl, config->objectCapacity);
-
             if (metisLogger_IsLoggable(logger, MetisLoggerFacility_Processor, PARCLogLevel_Info)) {
                 metisLogger_Log(logger, MetisLoggerFacility_Processor, PARCLogLevel_Info, __func__,
-                                "LRUContentStore %p created with capacity %zu",
-                                (void *) storeImpl, metisContentStoreInterface_GetObjectCapacity(storeImpl));
+                                "LRUContentStore %p created with capacity %zu, byte capacity %zu",
+                                (void *) storeImpl, metisContentStoreInterface_GetObjectCapacity(storeImpl),
+                                metisContentStoreInterface_GetByteCapacity(storeImpl));
             }
         }
     } else {
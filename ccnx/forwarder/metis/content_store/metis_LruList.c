@@ -106,6 +106,28 @@ metisLruList_EntryMoveToHead(MetisLruListEntry *entry)
     TAILQ_INSERT_HEAD(&entry->parentList->head, entry, list);
 }
 
+void
+metisLruList_EntryMoveToHeadOf(MetisLruListEntry *entry, MetisLruList *list)
+{
+    assertNotNull(entry, "Parameter entry must be non-null");
+    assertNotNull(list, "Parameter list must be non-null");
+    assertTrue(entry->inList, "Entry is not in a list");
+
+    TAILQ_REMOVE(&entry->parentList->head, entry, list);
+    entry->parentList->itemsInList--;
+
+    entry->parentList = list;
+    TAILQ_INSERT_HEAD(&list->head, entry, list);
+    list->itemsInList++;
+}
+
+MetisLruList *
+metisLruList_EntryGetList(const MetisLruListEntry *entry)
+{
+    assertNotNull(entry, "Parameter entry must be non-null");
+    return entry->parentList;
+}
+
 void *
 metisLruList_EntryGetData(MetisLruListEntry *entry)
 {
@@ -175,6 +197,13 @@ metisLruList_PopTail(MetisLruList *lru)
     return entry;
 }
 
+MetisLruListEntry *
+metisLruList_PeekTail(const MetisLruList *lru)
+{
+    assertNotNull(lru, "Parameter lru must be non-null");
+    return TAILQ_LAST(&lru->head, metis_lru_s);
+}
+
 size_t
 metisLruList_Length(const MetisLruList *lru)
 {
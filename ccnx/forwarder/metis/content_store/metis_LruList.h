@@ -151,6 +151,39 @@ void metisLruList_EntryDestroy(MetisLruListEntry **entryPtr);
  */
 void metisLruList_EntryMoveToHead(MetisLruListEntry *entry);
 
+/**
+ * Moves the entry to the head of another list
+ *
+ * The entry leaves the list it is in and is bound to `list` from then on.  A segmented LRU uses
+ * this to move an entry between its segments.
+ *
+ * @param [in] entry An entry that is in a list
+ * @param [in] list The list to move it to, may be the list it is in
+ *
+ * Example:
+ * @code
+ * {
+ *     // promote a probation entry that was used again
+ *     metisLruList_EntryMoveToHeadOf(entry, protected);
+ * }
+ * @endcode
+ */
+void metisLruList_EntryMoveToHeadOf(MetisLruListEntry *entry, MetisLruList *list);
+
+/**
+ * Returns the list the entry is bound to
+ *
+ * @param [in] entry An allocated MetisLruListEntry
+ *
+ * @return non-null The list the entry was created in or last moved to
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+MetisLruList *metisLruList_EntryGetList(const MetisLruListEntry *entry);
+
 /**
  * @function metisLruEntry_GetData
  * @abstract Returns the user-supplied opaque data when the entry was created
@@ -222,4 +255,24 @@ MetisLruListEntry *metisLruList_NewHeadEntry(MetisLruList *lru, void *data);
  * @return The tail element, or NULL for an empty list
  */
 MetisLruListEntry *metisLruList_PopTail(MetisLruList *list);
+
+/**
+ * Returns the tail element, without removing it from the list
+ *
+ * @param [in] list An allocated MetisLruList
+ *
+ * @return null The list is empty
+ * @return non-null The least recently used entry
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisLruListEntry *tail = metisLruList_PeekTail(lru);
+ *     if (tail != NULL && _shouldEvict(metisLruList_EntryGetData(tail))) {
+ *         tail = metisLruList_PopTail(lru);
+ *     }
+ * }
+ * @endcode
+ */
+MetisLruListEntry *metisLruList_PeekTail(const MetisLruList *list);
 #endif // Metis_metis_LruList_h
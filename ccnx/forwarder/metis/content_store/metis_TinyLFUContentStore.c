@@ -0,0 +1,513 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+/*
+ * - The tables are a MetisContentStoreIndex, the same as the LRU store's.  This file only adds the
+ *   frequency sketch, the admission check and the probation and protected segments.
+ * - The LRU is two lists, probation and protected.  Each entry is in exactly one of them, and
+ *   metisContentStoreEntry_GetLruList() tells which.
+ * - Frequencies are counted per interest in matchInterest, not per put.  An object arriving for a
+ *   missed interest was already counted when the interest missed, so the candidate and the victim
+ *   are compared on the same terms.
+ * - The admission check compares the new object with the first object it would evict.  An object
+ *   that needs several evictions to fit the byte budget is admitted or rejected on that one check.
+ * - There is no admission window in front of probation, so a brand new name is only admitted to a
+ *   full store once it has been asked for more than the probation tail.
+ * - Promotions from the second tier skip the admission check, the object is already known to be wanted.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <parc/algol/parc_Object.h>
+
+#include <ccnx/forwarder/metis/core/metis_Logger.h>
+
+#include <ccnx/forwarder/metis/content_store/metis_TinyLFUContentStore.h>
+
+#include <ccnx/forwarder/metis/content_store/metis_ContentStoreInterface.h>
+#include <ccnx/forwarder/metis/content_store/metis_ContentStoreIndex.h>
+#include <ccnx/forwarder/metis/content_store/metis_ContentStoreEntry.h>
+#include <ccnx/forwarder/metis/content_store/metis_FrequencySketch.h>
+#include <ccnx/forwarder/metis/content_store/metis_LruList.h>
+
+#include <ccnx/forwarder/metis/processor/metis_HashTableFunction.h>
+
+#include <LongBow/runtime.h>
+
+/**
+ * The share of the object capacity, in percent, that the protected segment may hold
+ */
+#define METIS_TINYLFU_PROTECTED_PERCENT 80
+
+typedef struct metis_tinylfu_contentstore_data {
+    MetisContentStoreIndex index;
+
+    // Recent interest counts by name hash, sized for objectCapacity
+    MetisFrequencySketch *sketch;
+
+    // New objects go to the head of probation.  A hit moves an object to the head of protected, and
+    // when protected holds more than protectedCapacity its tail goes back to the head of probation.
+    MetisLruList *probation;
+    MetisLruList *protected;
+    size_t protectedCapacity;
+
+    // Written only by the thread that owns the store, like the index's counters
+    uint64_t countAdmissionRejects;
+} _MetisTinyLFUContentStore;
+
+static void
+_MetisContentStoreInterface_Destroy(MetisContentStoreInterface **storeImplPtr)
+{
+    _MetisTinyLFUContentStore *store = metisContentStoreInterface_GetPrivateData(*storeImplPtr);
+
+    parcObject_Release((PARCObject **) &store);
+}
+
+static bool _metisTinyLFUContentStore_EvictVictim(_MetisTinyLFUContentStore *store, uint64_t currentTimeTicks);
+
+static bool
+_MetisTinyLFUContentStore_Destructor(_MetisTinyLFUContentStore **storePtr)
+{
+    _MetisTinyLFUContentStore *store = *storePtr;
+
+    if (store->index.secondTier) {
+        // Demote the least valuable objects first, so the most valuable are the newest in the second tier.
+        // We do not know the time here; 0 keeps the second tier from rejecting anything as expired.
+        while (store->index.objectCount > 0) {
+            _metisTinyLFUContentStore_EvictVictim(store, 0);
+        }
+    }
+
+    // The index releases the entries, which takes them off the segments, so it goes first
+    metisContentStoreIndex_Destroy(&store->index);
+
+    if (store->probation != NULL) {
+        metisLruList_Destroy(&(store->probation));
+    }
+
+    if (store->protected != NULL) {
+        metisLruList_Destroy(&(store->protected));
+    }
+
+    if (store->sketch != NULL) {
+        metisFrequencySketch_Destroy(&(store->sketch));
+    }
+
+    return true;
+}
+
+parcObject_Override(_MetisTinyLFUContentStore, PARCObject,
+                    .destructor = (PARCObjectDestructor *) _MetisTinyLFUContentStore_Destructor
+                    );
+
+parcObject_ExtendPARCObject(_MetisTinyLFUContentStoreInterface,
+                            _MetisContentStoreInterface_Destroy, NULL, NULL, NULL, NULL, NULL, NULL);
+
+static parcObject_ImplementAcquire(_metisTinyLFUContentStore, MetisContentStoreInterface);
+static parcObject_ImplementRelease(_metisTinyLFUContentStore, MetisContentStoreInterface);
+
+static size_t
+_metisTinyLFUContentStore_ProtectedCapacity(size_t objectCapacity)
+{
+    return objectCapacity * METIS_TINYLFU_PROTECTED_PERCENT / 100;
+}
+
+static bool
+_metisTinyLFUContentStore_Init(_MetisTinyLFUContentStore *store, MetisContentStoreConfig *config, MetisLogger *logger)
+{
+    if (!metisContentStoreIndex_Init(&store->index, "TinyLFUContentStore", config, logger)) {
+        return false;
+    }
+
+    store->protectedCapacity = _metisTinyLFUContentStore_ProtectedCapacity(config->objectCapacity);
+    store->sketch = metisFrequencySketch_Create(config->objectCapacity);
+    store->probation = metisLruList_Create();
+    store->protected = metisLruList_Create();
+
+    if ((store->probation == NULL) || (store->protected == NULL)) {
+        if (metisLogger_IsLoggable(logger, MetisLoggerFacility_Processor, PARCLogLevel_Error)) {
+            metisLogger_Log(logger, MetisLoggerFacility_Processor, PARCLogLevel_Error, __func__,
+                            "TinyLFUContentStore %p could not be created. Could not allocate the segments.",
+                            (void *) store);
+        }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * The sketch key for an interest or a content object.  An interest and the object that answers it
+ * have the same name hash.
+ */
+static uint64_t
+_metisTinyLFUContentStore_FrequencyKey(const MetisMessage *message)
+{
+    return (uint64_t) metisHashTableFunction_MessageNameHashCode(message);
+}
+
+/**
+ * The entry the segmented LRU would evict next: the tail of probation, or of protected if probation is empty
+ */
+static MetisContentStoreEntry *
+_metisTinyLFUContentStore_Victim(const _MetisTinyLFUContentStore *store)
+{
+    MetisLruListEntry *tail = metisLruList_PeekTail(store->probation);
+    if (tail == NULL) {
+        tail = metisLruList_PeekTail(store->protected);
+    }
+    return (tail != NULL) ? metisLruList_EntryGetData(tail) : NULL;
+}
+
+/**
+ * Evicts the segmented LRU victim, demoting it to the second tier if there is one
+ */
+static bool
+_metisTinyLFUContentStore_EvictVictim(_MetisTinyLFUContentStore *store, uint64_t currentTimeTicks)
+{
+    MetisContentStoreEntry *victim = _metisTinyLFUContentStore_Victim(store);
+    if (victim == NULL) {
+        return false;
+    }
+
+    metisContentStoreIndex_Evict(&store->index, victim, currentTimeTicks);
+    return true;
+}
+
+/**
+ * Moves the tail of protected back to the head of probation until protected fits its capacity
+ */
+static void
+_metisTinyLFUContentStore_TrimProtected(_MetisTinyLFUContentStore *store)
+{
+    while (metisLruList_Length(store->protected) > store->protectedCapacity) {
+        MetisContentStoreEntry *demoted = metisLruList_EntryGetData(metisLruList_PeekTail(store->protected));
+        metisContentStoreEntry_MoveToHeadOf(demoted, store->probation);
+    }
+}
+
+/**
+ * Moves a hit to the head of protected.  If that overfills protected, its tail goes back to probation.
+ */
+static void
+_metisTinyLFUContentStore_Touch(_MetisTinyLFUContentStore *store, MetisContentStoreEntry *entry)
+{
+    if (metisContentStoreEntry_GetLruList(entry) == store->protected) {
+        metisContentStoreEntry_MoveToHead(entry);
+        return;
+    }
+
+    metisContentStoreEntry_MoveToHeadOf(entry, store->protected);
+    _metisTinyLFUContentStore_TrimProtected(store);
+}
+
+/**
+ * Stores `content` in probation, making room for it if needed
+ *
+ * @param [in] admit If false, a full store only takes the object if its name is asked for more
+ *                   often than the victim's.  If true, the object is always taken.
+ */
+static bool
+_metisTinyLFUContentStore_Put(_MetisTinyLFUContentStore *store, MetisMessage *content, uint64_t currentTimeTicks, bool admit)
+{
+    assertNotNull(store, "Parameter store must be non-null");
+
+    if (!metisContentStoreIndex_CanStore(&store->index, content, currentTimeTicks)) {
+        return false;
+    }
+
+    // As in the LRU store, a store that was shrunk only makes room for this object and leaves the
+    // rest of the excess to trim.
+    size_t contentBytes = metisMessage_Length(content);
+    size_t startCount = store->index.objectCount;
+    size_t startBytes = store->index.byteCount;
+    while (metisContentStoreIndex_NeedsRoom(&store->index, contentBytes)) {
+        if (store->index.objectCount < startCount && store->index.byteCount + contentBytes <= startBytes) {
+            break;
+        }
+
+        // Stale objects go first and cost the candidate nothing
+        if (metisContentStoreIndex_EvictStale(&store->index, currentTimeTicks)) {
+            continue;
+        }
+
+        if (!admit) {
+            MetisContentStoreEntry *victim = _metisTinyLFUContentStore_Victim(store);
+            unsigned candidateFrequency = metisFrequencySketch_Estimate(store->sketch, _metisTinyLFUContentStore_FrequencyKey(content));
+            unsigned victimFrequency = metisFrequencySketch_Estimate(store->sketch,
+                                                                     _metisTinyLFUContentStore_FrequencyKey(metisContentStoreEntry_GetMessage(victim)));
+            if (candidateFrequency <= victimFrequency) {
+                metisStats_Increment(store->countAdmissionRejects);
+                if (metisLogger_IsLoggable(store->index.logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+                    metisLogger_Log(store->index.logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                                    "TinyLFUContentStore %p rejected message %p, frequency %u not above victim %p frequency %u",
+                                    (void *) store, (void *) content, candidateFrequency,
+                                    (void *) metisContentStoreEntry_GetMessage(victim), victimFrequency);
+                }
+                return false;
+            }
+            admit = true;
+        }
+
+        metisStats_Increment(store->index.stats.countLruEvictions);
+        _metisTinyLFUContentStore_EvictVictim(store, currentTimeTicks);
+    }
+
+    return metisContentStoreIndex_Add(&store->index, content, store->probation) != NULL;
+}
+
+static bool
+_metisTinyLFUContentStore_PutContent(MetisContentStoreInterface *storeImpl, MetisMessage *content, uint64_t currentTimeTicks)
+{
+    _MetisTinyLFUContentStore *store = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    return _metisTinyLFUContentStore_Put(store, content, currentTimeTicks, false);
+}
+
+/**
+ * Promotions from the second tier skip the admission check, the object is already known to be wanted
+ */
+static bool
+_metisTinyLFUContentStore_PutPromoted(void *context, MetisMessage *content, uint64_t currentTimeTicks)
+{
+    return _metisTinyLFUContentStore_Put((_MetisTinyLFUContentStore *) context, content, currentTimeTicks, true);
+}
+
+static MetisMessage *
+_metisTinyLFUContentStore_MatchInterest(MetisContentStoreInterface *storeImpl, MetisMessage *interest)
+{
+    MetisMessage *result = NULL;
+
+    _MetisTinyLFUContentStore *store = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    assertNotNull(store, "Parameter store must be non-null");
+
+    MetisContentStoreEntry *storeEntry = metisContentStoreIndex_MatchInterest(&store->index, interest);
+    metisFrequencySketch_Increment(store->sketch, _metisTinyLFUContentStore_FrequencyKey(interest));
+
+    if (storeEntry) {
+        _metisTinyLFUContentStore_Touch(store, storeEntry);
+        result = metisContentStoreEntry_GetMessage(storeEntry);
+    } else if (store->index.secondTier) {
+        result = metisContentStoreIndex_Promote(&store->index, interest, _metisTinyLFUContentStore_PutPromoted, store);
+    }
+
+    metisContentStoreIndex_CountLookup(&store->index, interest, result);
+    return result;
+}
+
+static bool
+_metisTinyLFUContentStore_RemoveContent(MetisContentStoreInterface *storeImpl, MetisMessage *content)
+{
+    _MetisTinyLFUContentStore *store = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    return metisContentStoreIndex_Remove(&store->index, content);
+}
+
+static void
+_metisTinyLFUContentStore_Log(MetisContentStoreInterface *storeImpl)
+{
+    _MetisTinyLFUContentStore *store = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    MetisContentStoreIndex *index = &store->index;
+
+    metisLogger_Log(index->logger, MetisLoggerFacility_Processor, PARCLogLevel_All, __func__,
+                    "MetisTinyLFUContentStore @%p {count = %zu, capacity = %zu, bytes = %zu, byteCapacity = %zu, "
+                    "probation = %zu, protected = %zu, protectedCapacity = %zu {"
+                    "stats = @%p {adds = %" PRIu64 ", hits = %" PRIu64 ", misses = %" PRIu64 ", admissionRejects = %" PRIu64
+                    ", LRUEvictons = %" PRIu64 ", ExpiryEvictions = %" PRIu64 ", RCTEvictions = %" PRIu64
+                    ", Demotions = %" PRIu64 ", Promotions = %" PRIu64 "} }",
+                    store,
+                    index->objectCount,
+                    index->objectCapacity,
+                    index->byteCount,
+                    index->byteCapacity,
+                    metisLruList_Length(store->probation),
+                    metisLruList_Length(store->protected),
+                    store->protectedCapacity,
+                    &index->stats,
+                    index->stats.countAdds,
+                    index->stats.countHits,
+                    index->stats.countMisses,
+                    store->countAdmissionRejects,
+                    index->stats.countLruEvictions,
+                    index->stats.countExpiryEvictions,
+                    index->stats.countRCTEvictions,
+                    index->stats.countDemotions,
+                    index->stats.countPromotions);
+
+    if (index->secondTier) {
+        metisContentStoreInterface_Log(index->secondTier);
+    }
+}
+
+static void
+_metisTinyLFUContentStore_AccumulateStats(MetisContentStoreInterface *storeImpl, MetisStats *stats)
+{
+    _MetisTinyLFUContentStore *store = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+
+    metisContentStoreIndex_AccumulateStats(&store->index, stats);
+    stats->values[MetisStat_ContentStoreAdmissionRejects] += metisStats_Read(store->countAdmissionRejects);
+}
+
+static size_t
+_metisTinyLFUContentStore_GetObjectCapacity(MetisContentStoreInterface *storeImpl)
+{
+    _MetisTinyLFUContentStore *store = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    return store->index.objectCapacity;
+}
+
+static size_t
+_metisTinyLFUContentStore_GetObjectCount(MetisContentStoreInterface *storeImpl)
+{
+    _MetisTinyLFUContentStore *store = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    return store->index.objectCount;
+}
+
+static size_t
+_metisTinyLFUContentStore_GetByteCapacity(MetisContentStoreInterface *storeImpl)
+{
+    _MetisTinyLFUContentStore *store = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    return store->index.byteCapacity;
+}
+
+static size_t
+_metisTinyLFUContentStore_GetByteCount(MetisContentStoreInterface *storeImpl)
+{
+    _MetisTinyLFUContentStore *store = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+    return store->index.byteCount;
+}
+
+/**
+ * The sketch is re-created for the new capacity, so the frequency history starts over.  A smaller
+ * protected segment gives its least recent objects back to probation right away, the objects over
+ * the new object capacity are evicted by trim.
+ */
+static void
+_metisTinyLFUContentStore_SetCapacity(MetisContentStoreInterface *storeImpl, size_t objectCapacity, size_t byteCapacity)
+{
+    _MetisTinyLFUContentStore *store = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+
+    if (objectCapacity != store->index.objectCapacity) {
+        metisFrequencySketch_Destroy(&store->sketch);
+        store->sketch = metisFrequencySketch_Create(objectCapacity);
+    }
+
+    store->protectedCapacity = _metisTinyLFUContentStore_ProtectedCapacity(objectCapacity);
+    _metisTinyLFUContentStore_TrimProtected(store);
+
+    metisContentStoreIndex_SetCapacity(&store->index, objectCapacity, byteCapacity);
+}
+
+static bool
+_metisTinyLFUContentStore_Trim(MetisContentStoreInterface *storeImpl, size_t maximumEvictions, uint64_t currentTimeTicks)
+{
+    _MetisTinyLFUContentStore *store = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(storeImpl);
+
+    for (size_t i = 0; i < maximumEvictions && metisContentStoreIndex_IsOverCapacity(&store->index); i++) {
+        if (!metisContentStoreIndex_EvictStale(&store->index, currentTimeTicks)) {
+            metisStats_Increment(store->index.stats.countLruEvictions);
+            _metisTinyLFUContentStore_EvictVictim(store, currentTimeTicks);
+        }
+    }
+
+    return !metisContentStoreIndex_IsOverCapacity(&store->index);
+}
+
+MetisContentStoreInterface *
+metisTinyLFUContentStore_Create(MetisContentStoreConfig *config, MetisLogger *logger)
+{
+    assertNotNull(config, "Parameter config must be non-null");
+    assertNotNull(logger, "MetisTinyLFUContentStore requires a non-NULL logger");
+
+    MetisContentStoreInterface *storeImpl = parcObject_CreateAndClearInstance(_MetisTinyLFUContentStoreInterface);
+    assertNotNull(storeImpl, "parcObject_CreateAndClearInstance returned NULL");
+
+    storeImpl->_privateData = parcObject_CreateAndClearInstance(_MetisTinyLFUContentStore);
+
+    storeImpl->putContent = &_metisTinyLFUContentStore_PutContent;
+    storeImpl->removeContent = &_metisTinyLFUContentStore_RemoveContent;
+
+    storeImpl->matchInterest = &_metisTinyLFUContentStore_MatchInterest;
+
+    storeImpl->getObjectCount = &_metisTinyLFUContentStore_GetObjectCount;
+    storeImpl->getObjectCapacity = &_metisTinyLFUContentStore_GetObjectCapacity;
+    storeImpl->getByteCount = &_metisTinyLFUContentStore_GetByteCount;
+    storeImpl->getByteCapacity = &_metisTinyLFUContentStore_GetByteCapacity;
+
+    storeImpl->log = &_metisTinyLFUContentStore_Log;
+    storeImpl->accumulateStats = &_metisTinyLFUContentStore_AccumulateStats;
+    storeImpl->setCapacity = &_metisTinyLFUContentStore_SetCapacity;
+    storeImpl->trim = &_metisTinyLFUContentStore_Trim;
+
+    storeImpl->acquire = &_metisTinyLFUContentStore_Acquire;
+    storeImpl->release = &_metisTinyLFUContentStore_Release;
+
+    if (!_metisTinyLFUContentStore_Init(storeImpl->_privateData, config, logger)) {
+        metisContentStoreInterface_Release(&storeImpl);
+        return NULL;
+    }
+
+    if (metisLogger_IsLoggable(logger, MetisLoggerFacility_Processor, PARCLogLevel_Info)) {
+        metisLogger_Log(logger, MetisLoggerFacility_Processor, PARCLogLevel_Info, __func__,
+                        "TinyLFUContentStore %p created with capacity %zu, byte capacity %zu",
+                        (void *) storeImpl, metisContentStoreInterface_GetObjectCapacity(storeImpl),
+                        metisContentStoreInterface_GetByteCapacity(storeImpl));
+    }
+
+    return storeImpl;
+}
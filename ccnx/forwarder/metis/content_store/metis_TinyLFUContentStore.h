@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_TinyLFUContentStore.h
+ * @brief A scan-resistant in-memory content store
+ *
+ * The LRU store admits every object and evicts the least recently used one, so a consumer walking a
+ * large namespace once replaces the whole cache with objects nobody asks for again.  This store puts
+ * a TinyLFU admission filter in front of a segmented LRU:
+ *
+ * - Every interest the store sees is counted by name in a {@link MetisFrequencySketch}.
+ * - While the store has room, every object is admitted.  Once it is full, a new object is only
+ *   admitted if its name has been asked for more often than the object it would evict.  A rejected
+ *   object is not stored and nothing is evicted.
+ * - New objects enter a probation segment.  A hit moves an object to the protected segment, which
+ *   holds up to 80% of the objects.  Victims come from the tail of probation, so an object that was
+ *   only used once is evicted before one that was used again.
+ *
+ * Expired and RCT-exceeded objects are still evicted first, without a frequency check.  The store
+ * supports the same limits, second tier and in-place resize as metisLRUContentStore_Create().
+ *
+ * The store reports the same counters as the LRU store, plus
+ * `MetisStat_ContentStoreAdmissionRejects`, so the two can be compared on the same traffic.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_TinyLFUContentStore_h
+#define Metis_metis_TinyLFUContentStore_h
+
+#include <stdio.h>
+#include <ccnx/forwarder/metis/content_store/metis_ContentStoreInterface.h>
+#include <ccnx/forwarder/metis/core/metis_Logger.h>
+
+/**
+ * Create a content store with a TinyLFU admission filter in front of a segmented LRU
+ *
+ * @param [in] config The limits and optional second tier, as for metisLRUContentStore_Create()
+ * @param [in] logger An instance of a {@link MetisLogger} to use for logging content store events.
+ *
+ * @return non-null A new store, release with {@link metisContentStoreInterface_Release}
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisContentStoreConfig config = {
+ *         .objectCapacity = 100000
+ *     };
+ *
+ *     MetisContentStoreInterface *store = metisTinyLFUContentStore_Create(&config, logger);
+ *     metisContentStoreInterface_Release(&store);
+ * }
+ * @endcode
+ * @see MetisContentStoreInterface
+ * @see metisContentStoreInterface_Release
+ */
+MetisContentStoreInterface *metisTinyLFUContentStore_Create(MetisContentStoreConfig *config, MetisLogger *logger);
+#endif // Metis_metis_TinyLFUContentStore_h
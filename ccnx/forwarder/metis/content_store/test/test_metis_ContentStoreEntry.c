@@ -57,6 +57,7 @@
 
 #include "../metis_ContentStoreEntry.c"
 #include <LongBow/unit-test.h>
+#include <inttypes.h>
 
 #include <parc/algol/parc_SafeMemory.h>
 #include <parc/logging/parc_LogReporterTextStdout.h>
@@ -94,7 +95,11 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisContentStoreEntry_Create_Destroy_State);
     LONGBOW_RUN_TEST_CASE(Global, metisContentStoreEntry_Acquire);
     LONGBOW_RUN_TEST_CASE(Global, metisContentStoreEntry_GetMessage);
+    LONGBOW_RUN_TEST_CASE(Global, metisContentStoreEntry_GetByteCount);
     LONGBOW_RUN_TEST_CASE(Global, metisContentStoreEntry_MoveToHead);
+    LONGBOW_RUN_TEST_CASE(Global, metisContentStoreEntry_MoveToHeadOf);
+    LONGBOW_RUN_TEST_CASE(Global, metisContentStoreEntry_Sequence);
+    LONGBOW_RUN_TEST_CASE(Global, metisContentStoreEntry_NextWithSameName);
 
     LONGBOW_RUN_TEST_CASE(Global, metisContentStoreEntry_GetExpiryTimeInTicks);
     LONGBOW_RUN_TEST_CASE(Global, metisContentStoreEntry_GetRecommendedCacheTimeInTicks);
@@ -200,6 +205,61 @@ LONGBOW_TEST_CASE(Global, metisContentStoreEntry_GetMessage)
     metisLogger_Release(&logger);
 }
 
+LONGBOW_TEST_CASE(Global, metisContentStoreEntry_GetByteCount)
+{
+    MetisLogger *logger = _createLogger();
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisContentStoreEntry *storeEntry = metisContentStoreEntry_Create(object, NULL);
+
+    size_t byteCount = metisContentStoreEntry_GetByteCount(storeEntry);
+    assertTrue(byteCount == metisMessage_Length(object), "Incorrect byte count, expected %zu got %zu", metisMessage_Length(object), byteCount);
+
+    metisContentStoreEntry_Release(&storeEntry);
+    metisMessage_Release(&object);
+    metisLogger_Release(&logger);
+}
+
+LONGBOW_TEST_CASE(Global, metisContentStoreEntry_Sequence)
+{
+    MetisLogger *logger = _createLogger();
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisContentStoreEntry *storeEntry = metisContentStoreEntry_Create(object, NULL);
+
+    uint64_t before = metisContentStoreEntry_GetSequence(storeEntry);
+    metisContentStoreEntry_SetSequence(storeEntry, 77);
+    uint64_t after = metisContentStoreEntry_GetSequence(storeEntry);
+
+    metisContentStoreEntry_Release(&storeEntry);
+    metisMessage_Release(&object);
+    metisLogger_Release(&logger);
+
+    assertTrue(before == 0, "New entry should have sequence 0, got %" PRIu64, before);
+    assertTrue(after == 77, "Wrong sequence, expected 77 got %" PRIu64, after);
+}
+
+LONGBOW_TEST_CASE(Global, metisContentStoreEntry_NextWithSameName)
+{
+    MetisLogger *logger = _createLogger();
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisContentStoreEntry *first = metisContentStoreEntry_Create(object, NULL);
+    MetisContentStoreEntry *second = metisContentStoreEntry_Create(object, NULL);
+
+    assertNull(metisContentStoreEntry_GetNextWithSameName(first), "New entry should not be chained");
+
+    metisContentStoreEntry_SetNextWithSameName(first, second);
+    MetisContentStoreEntry *next = metisContentStoreEntry_GetNextWithSameName(first);
+
+    metisContentStoreEntry_Release(&first);
+    metisContentStoreEntry_Release(&second);
+    metisMessage_Release(&object);
+    metisLogger_Release(&logger);
+
+    assertTrue(next == second, "Wrong next entry, expected %p got %p", (void *) second, (void *) next);
+}
+
 LONGBOW_TEST_CASE(Global, metisContentStoreEntry_MoveToHead)
 {
     MetisLogger *logger = _createLogger();
@@ -228,6 +288,37 @@ LONGBOW_TEST_CASE(Global, metisContentStoreEntry_MoveToHead)
     metisLruList_Destroy(&lruList);
 }
 
+LONGBOW_TEST_CASE(Global, metisContentStoreEntry_MoveToHeadOf)
+{
+    MetisLogger *logger = _createLogger();
+    MetisLruList *probation = metisLruList_Create();
+    MetisLruList *protected = metisLruList_Create();
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisContentStoreEntry *storeEntry = metisContentStoreEntry_Create(object, probation);
+
+    MetisLruList *before = metisContentStoreEntry_GetLruList(storeEntry);
+    metisContentStoreEntry_MoveToHeadOf(storeEntry, protected);
+    MetisLruList *after = metisContentStoreEntry_GetLruList(storeEntry);
+    size_t probationLength = metisLruList_Length(probation);
+    size_t protectedLength = metisLruList_Length(protected);
+
+    // releasing the entry removes it from the list it was moved to
+    metisContentStoreEntry_Release(&storeEntry);
+    size_t protectedLengthAfterRelease = metisLruList_Length(protected);
+
+    metisMessage_Release(&object);
+    metisLogger_Release(&logger);
+    metisLruList_Destroy(&probation);
+    metisLruList_Destroy(&protected);
+
+    assertTrue(before == probation, "Entry should start in the list it was created with");
+    assertTrue(after == protected, "Entry should be in the list it was moved to");
+    assertTrue(probationLength == 0, "Wrong probation length, expected 0 got %zu", probationLength);
+    assertTrue(protectedLength == 1, "Wrong protected length, expected 1 got %zu", protectedLength);
+    assertTrue(protectedLengthAfterRelease == 0, "Wrong protected length after release, expected 0 got %zu", protectedLengthAfterRelease);
+}
+
 LONGBOW_TEST_CASE(Global, metisContentStoreEntry_GetExpiryTimeInTicks)
 {
     MetisLogger *logger = _createLogger();
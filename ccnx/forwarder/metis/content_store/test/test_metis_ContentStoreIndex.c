@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metis_ContentStoreIndex.c"
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/logging/parc_LogReporterTextStdout.h>
+
+#include <ccnx/forwarder/metis/content_store/metis_LRUContentStore.h>
+
+#include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
+
+LONGBOW_TEST_RUNNER(metis_ContentStoreIndex)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_ContentStoreIndex)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_ContentStoreIndex)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// =================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisContentStoreIndex_Init_Destroy);
+    LONGBOW_RUN_TEST_CASE(Global, metisContentStoreIndex_Add_MatchInterest);
+    LONGBOW_RUN_TEST_CASE(Global, metisContentStoreIndex_CanStore);
+    LONGBOW_RUN_TEST_CASE(Global, metisContentStoreIndex_Purge);
+    LONGBOW_RUN_TEST_CASE(Global, metisContentStoreIndex_Promote);
+    LONGBOW_RUN_TEST_CASE(Global, metisContentStoreIndex_Promote_PutFails);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static MetisLogger *
+_createLogger(void)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+    metisLogger_SetLogLevel(logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug);
+    return logger;
+}
+
+/**
+ * A minimal store for the promote callbacks: the index and the one list its entries go on
+ */
+typedef struct test_store {
+    MetisContentStoreIndex index;
+    MetisLruList *lru;
+} _TestStore;
+
+static bool
+_testStore_Put(void *context, MetisMessage *content, uint64_t currentTimeTicks)
+{
+    _TestStore *store = context;
+    if (!metisContentStoreIndex_CanStore(&store->index, content, currentTimeTicks)) {
+        return false;
+    }
+    return metisContentStoreIndex_Add(&store->index, content, store->lru) != NULL;
+}
+
+static bool
+_testStore_PutFails(void *context, MetisMessage *content, uint64_t currentTimeTicks)
+{
+    return false;
+}
+
+LONGBOW_TEST_CASE(Global, metisContentStoreIndex_Init_Destroy)
+{
+    MetisLogger *logger = _createLogger();
+    MetisContentStoreConfig config = {
+        .objectCapacity = 10,
+        .byteCapacity = 1000,
+    };
+
+    MetisContentStoreIndex index;
+    bool success = metisContentStoreIndex_Init(&index, "TestStore", &config, logger);
+    metisLogger_Release(&logger);
+
+    assertTrue(success, "Init failed");
+    assertTrue(index.objectCapacity == 10, "Wrong object capacity, expected 10 got %zu", index.objectCapacity);
+    assertTrue(index.byteCapacity == 1000, "Wrong byte capacity, expected 1000 got %zu", index.byteCapacity);
+    assertTrue(index.objectCount == 0, "Wrong object count, expected 0 got %zu", index.objectCount);
+    assertNull(index.secondTier, "Expected no second tier");
+
+    metisContentStoreIndex_Destroy(&index);
+    assertNull(index.storageByNameHashAndSequence, "Destroy did not null the storage table");
+    assertNull(index.logger, "Destroy did not release the logger");
+
+    // Destroy must be safe to call again, the stores' destructors rely on it after a failed Init
+    metisContentStoreIndex_Destroy(&index);
+}
+
+LONGBOW_TEST_CASE(Global, metisContentStoreIndex_Add_MatchInterest)
+{
+    MetisLogger *logger = _createLogger();
+    MetisContentStoreConfig config = {
+        .objectCapacity = 10,
+    };
+
+    MetisContentStoreIndex index;
+    metisContentStoreIndex_Init(&index, "TestStore", &config, logger);
+    MetisLruList *lru = metisLruList_Create();
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisMessage *interestByName = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 3, 5, logger);
+    MetisMessage *interestOtherName = metisMessage_CreateFromArray(metisTestDataV0_InterestWithOtherName,
+                                                                   sizeof(metisTestDataV0_InterestWithOtherName), 4, 5, logger);
+
+    MetisContentStoreEntry *entry = metisContentStoreIndex_Add(&index, object, lru);
+    MetisContentStoreEntry *found = metisContentStoreIndex_FindObject(&index, object);
+    MetisContentStoreEntry *matched = metisContentStoreIndex_MatchInterest(&index, interestByName);
+    MetisContentStoreEntry *missed = metisContentStoreIndex_MatchInterest(&index, interestOtherName);
+
+    assertNotNull(entry, "Add returned NULL");
+    assertTrue(found == entry, "FindObject returned the wrong entry, expected %p got %p", (void *) entry, (void *) found);
+    assertTrue(matched == entry, "MatchInterest returned the wrong entry, expected %p got %p", (void *) entry, (void *) matched);
+    assertNull(missed, "Interest for another name should not match");
+    assertTrue(index.objectCount == 1, "Wrong object count, expected 1 got %zu", index.objectCount);
+    assertTrue(index.byteCount == metisMessage_Length(object), "Wrong byte count, expected %zu got %zu",
+               metisMessage_Length(object), index.byteCount);
+    assertTrue(index.stats.countAdds == 1, "Wrong countAdds, expected 1 got %" PRIu64, index.stats.countAdds);
+    assertTrue(metisLruList_Length(lru) == 1, "Wrong LRU length, expected 1 got %zu", metisLruList_Length(lru));
+
+    metisContentStoreIndex_Destroy(&index);
+    metisLruList_Destroy(&lru);
+    metisMessage_Release(&object);
+    metisMessage_Release(&interestByName);
+    metisMessage_Release(&interestOtherName);
+    metisLogger_Release(&logger);
+}
+
+LONGBOW_TEST_CASE(Global, metisContentStoreIndex_CanStore)
+{
+    MetisLogger *logger = _createLogger();
+    MetisContentStoreConfig config = {
+        .objectCapacity = 10,
+    };
+    MetisContentStoreConfig zeroConfig = {
+        .objectCapacity = 0,
+    };
+
+    MetisContentStoreIndex index;
+    MetisContentStoreIndex zeroIndex;
+    metisContentStoreIndex_Init(&index, "TestStore", &config, logger);
+    metisContentStoreIndex_Init(&zeroIndex, "TestStore", &zeroConfig, logger);
+    MetisLruList *lru = metisLruList_Create();
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+
+    bool canStoreNew = metisContentStoreIndex_CanStore(&index, object, 1);
+    bool canStoreZero = metisContentStoreIndex_CanStore(&zeroIndex, object, 1);
+    metisContentStoreIndex_Add(&index, object, lru);
+    bool canStoreDuplicate = metisContentStoreIndex_CanStore(&index, object, 1);
+
+    assertTrue(canStoreNew, "A new object should be storable");
+    assertFalse(canStoreZero, "A zero capacity index should store nothing");
+    assertFalse(canStoreDuplicate, "An object already in the index should not be stored again");
+
+    metisContentStoreIndex_Destroy(&index);
+    metisContentStoreIndex_Destroy(&zeroIndex);
+    metisLruList_Destroy(&lru);
+    metisMessage_Release(&object);
+    metisLogger_Release(&logger);
+}
+
+LONGBOW_TEST_CASE(Global, metisContentStoreIndex_Purge)
+{
+    MetisLogger *logger = _createLogger();
+    MetisContentStoreConfig config = {
+        .objectCapacity = 10,
+    };
+
+    MetisContentStoreIndex index;
+    metisContentStoreIndex_Init(&index, "TestStore", &config, logger);
+    MetisLruList *lru = metisLruList_Create();
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisMessage *interestByName = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 3, 5, logger);
+
+    MetisContentStoreEntry *entry = metisContentStoreIndex_Add(&index, object, lru);
+    metisContentStoreIndex_Purge(&index, entry);
+    MetisContentStoreEntry *matched = metisContentStoreIndex_MatchInterest(&index, interestByName);
+
+    assertNull(matched, "A purged object should not match");
+    assertTrue(index.objectCount == 0, "Wrong object count, expected 0 got %zu", index.objectCount);
+    assertTrue(index.byteCount == 0, "Wrong byte count, expected 0 got %zu", index.byteCount);
+    assertTrue(metisLruList_Length(lru) == 0, "Wrong LRU length, expected 0 got %zu", metisLruList_Length(lru));
+
+    metisContentStoreIndex_Destroy(&index);
+    metisLruList_Destroy(&lru);
+    metisMessage_Release(&object);
+    metisMessage_Release(&interestByName);
+    metisLogger_Release(&logger);
+}
+
+LONGBOW_TEST_CASE(Global, metisContentStoreIndex_Promote)
+{
+    MetisLogger *logger = _createLogger();
+    MetisContentStoreConfig secondTierConfig = {
+        .objectCapacity = 10,
+    };
+    MetisContentStoreInterface *secondTier = metisLRUContentStore_Create(&secondTierConfig, logger);
+
+    MetisContentStoreConfig config = {
+        .objectCapacity = 10,
+        .secondTier = secondTier,
+    };
+
+    _TestStore store;
+    metisContentStoreIndex_Init(&store.index, "TestStore", &config, logger);
+    store.lru = metisLruList_Create();
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisMessage *interestByName = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 3, 5, logger);
+    metisContentStoreInterface_PutContent(secondTier, object, 1);
+
+    MetisMessage *promoted = metisContentStoreIndex_Promote(&store.index, interestByName, _testStore_Put, &store);
+    size_t secondTierCount = metisContentStoreInterface_GetObjectCount(secondTier);
+
+    assertTrue(promoted == object, "Wrong promoted object, expected %p got %p", (void *) object, (void *) promoted);
+    assertTrue(store.index.objectCount == 1, "Wrong object count, expected 1 got %zu", store.index.objectCount);
+    assertTrue(secondTierCount == 0, "Promoted object should leave the second tier, count %zu", secondTierCount);
+    assertTrue(store.index.stats.countPromotions == 1, "Wrong countPromotions, expected 1 got %" PRIu64, store.index.stats.countPromotions);
+
+    metisContentStoreIndex_Destroy(&store.index);
+    metisLruList_Destroy(&store.lru);
+    metisContentStoreInterface_Release(&secondTier);
+    metisMessage_Release(&object);
+    metisMessage_Release(&interestByName);
+    metisLogger_Release(&logger);
+}
+
+/**
+ * A promotion this store cannot take still answers the interest, and the object stays in the second tier
+ */
+LONGBOW_TEST_CASE(Global, metisContentStoreIndex_Promote_PutFails)
+{
+    MetisLogger *logger = _createLogger();
+    MetisContentStoreConfig secondTierConfig = {
+        .objectCapacity = 10,
+    };
+    MetisContentStoreInterface *secondTier = metisLRUContentStore_Create(&secondTierConfig, logger);
+
+    MetisContentStoreConfig config = {
+        .objectCapacity = 10,
+        .secondTier = secondTier,
+    };
+
+    MetisContentStoreIndex index;
+    metisContentStoreIndex_Init(&index, "TestStore", &config, logger);
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisMessage *interestByName = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 3, 5, logger);
+    metisContentStoreInterface_PutContent(secondTier, object, 1);
+
+    MetisMessage *promoted = metisContentStoreIndex_Promote(&index, interestByName, _testStore_PutFails, NULL);
+    size_t secondTierCount = metisContentStoreInterface_GetObjectCount(secondTier);
+
+    assertTrue(promoted == object, "Wrong promoted object, expected %p got %p", (void *) object, (void *) promoted);
+    assertTrue(index.objectCount == 0, "Wrong object count, expected 0 got %zu", index.objectCount);
+    assertTrue(secondTierCount == 1, "Object should stay in the second tier, count %zu", secondTierCount);
+    assertTrue(index.stats.countPromotions == 0, "Wrong countPromotions, expected 0 got %" PRIu64, index.stats.countPromotions);
+
+    metisContentStoreIndex_Destroy(&index);
+    metisContentStoreInterface_Release(&secondTier);
+    metisMessage_Release(&object);
+    metisMessage_Release(&interestByName);
+    metisLogger_Release(&logger);
+}
+
+// =================================================================
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_ContentStoreIndex);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -97,6 +97,8 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisContentStoreInterface_MatchInterest);
     LONGBOW_RUN_TEST_CASE(Global, metisContentStoreInterface_GetObjectCount);
     LONGBOW_RUN_TEST_CASE(Global, metisContentStoreInterface_GetObjectCapacity);
+    LONGBOW_RUN_TEST_CASE(Global, metisContentStoreInterface_GetByteCount);
+    LONGBOW_RUN_TEST_CASE(Global, metisContentStoreInterface_GetByteCapacity);
     LONGBOW_RUN_TEST_CASE(Global, metisContentStoreInterface_Log);
 }
 
@@ -245,6 +247,41 @@ LONGBOW_TEST_CASE(Global, metisContentStoreInterface_GetObjectCapacity)
     metisLogger_Release(&logger);
 }
 
+LONGBOW_TEST_CASE(Global, metisContentStoreInterface_GetByteCount)
+{
+    MetisLogger *logger = _createLogger();
+    MetisContentStoreInterface *store = _createContentStore(logger);
+
+    size_t expected = 0;
+    for (int i = 1; i < 10; i++) {
+        MetisMessage *content = _createUniqueMetisMessage(logger, i, metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject),
+                                                          metisTestDataV0_EncodedObject_name.offset + 4);
+        metisContentStoreInterface_PutContent(store, content, 1000 + i);
+        expected += metisMessage_Length(content);
+        metisMessage_Release(&content);
+
+        size_t byteCount = metisContentStoreInterface_GetByteCount(store);
+        assertTrue(byteCount == expected, "Expected a byte count of %zu, got %zu", expected, byteCount);
+    }
+
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+}
+
+LONGBOW_TEST_CASE(Global, metisContentStoreInterface_GetByteCapacity)
+{
+    MetisLogger *logger = _createLogger();
+    MetisContentStoreConfig config = {
+        .objectCapacity = 1000,
+        .byteCapacity   = 1000000,
+    };
+
+    MetisContentStoreInterface *store = metisLRUContentStore_Create(&config, logger);
+    assertTrue(metisContentStoreInterface_GetByteCapacity(store) == config.byteCapacity, "Expected to get back the byte capacity we set");
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+}
+
 LONGBOW_TEST_CASE(Global, metisContentStoreInterface_Log)
 {
     MetisLogger *logger = _createLogger();
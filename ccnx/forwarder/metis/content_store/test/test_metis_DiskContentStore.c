@@ -0,0 +1,472 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+
+#include <config.h>
+
+#include "../metis_DiskContentStore.c"
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/logging/parc_LogReporterTextStdout.h>
+
+#include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
+
+LONGBOW_TEST_RUNNER(metis_DiskContentStore)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_DiskContentStore)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_DiskContentStore)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ============================================================================
+
+typedef struct test_data {
+    char directory[64];
+    MetisLogger *logger;
+} TestData;
+
+static void
+_removeDirectory(const char *directory)
+{
+    DIR *dir = opendir(directory);
+    if (dir) {
+        struct dirent *dirent;
+        while ((dirent = readdir(dir)) != NULL) {
+            if (dirent->d_name[0] != '.') {
+                char path[PATH_MAX];
+                snprintf(path, sizeof(path), "%s/%s", directory, dirent->d_name);
+                unlink(path);
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(directory);
+}
+
+static MetisContentStoreInterface *
+_createDiskContentStore(TestData *data, size_t byteCapacity)
+{
+    MetisContentStoreConfig config = {
+        .byteCapacity = byteCapacity,
+    };
+
+    return metisDiskContentStore_Create(&config, data->directory, data->logger);
+}
+
+static MetisMessage *
+_createNumberedObject(MetisLogger *logger, unsigned number)
+{
+    uint8_t buffer[sizeof(metisTestDataV0_EncodedObject)];
+    memcpy(buffer, metisTestDataV0_EncodedObject, sizeof(buffer));
+
+    // Change the first two bytes of the first name segment so each number is a different name
+    size_t nameOffset = metisTestDataV0_EncodedObject_name.offset + 4;
+    buffer[nameOffset] = (uint8_t) (number >> 8);
+    buffer[nameOffset + 1] = (uint8_t) number;
+
+    return metisMessage_CreateFromArray(buffer, sizeof(buffer), 1, 2, logger);
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisDiskContentStore_Create_Destroy);
+    LONGBOW_RUN_TEST_CASE(Global, metisDiskContentStore_Log);
+    LONGBOW_RUN_TEST_CASE(Global, metisDiskContentStore_Fetch_ByName);
+    LONGBOW_RUN_TEST_CASE(Global, metisDiskContentStore_Fetch_Miss);
+    LONGBOW_RUN_TEST_CASE(Global, metisDiskContentStore_Save_Duplicate);
+    LONGBOW_RUN_TEST_CASE(Global, metisDiskContentStore_Save_ExpiredContent);
+    LONGBOW_RUN_TEST_CASE(Global, metisDiskContentStore_Remove_Content);
+    LONGBOW_RUN_TEST_CASE(Global, metisDiskContentStore_Recover);
+    LONGBOW_RUN_TEST_CASE(Global, metisDiskContentStore_Recover_Tombstone);
+    LONGBOW_RUN_TEST_CASE(Global, metisDiskContentStore_SegmentEviction);
+    LONGBOW_RUN_TEST_CASE(Global, metisDiskContentStore_Save_SegmentOpenFails);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+
+    snprintf(data->directory, sizeof(data->directory), "/tmp/test_metis_DiskContentStore.XXXXXX");
+    assertNotNull(mkdtemp(data->directory), "mkdtemp failed: (%d) %s", errno, strerror(errno));
+
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    data->logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    longBowTestCase_SetClipBoardData(testCase, data);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    _removeDirectory(data->directory);
+    metisLogger_Release(&data->logger);
+    parcMemory_Deallocate((void **) &data);
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, metisDiskContentStore_Create_Destroy)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    MetisContentStoreInterface *store = _createDiskContentStore(data, 0);
+    assertNotNull(store, "Expected to create a disk content store in %s", data->directory);
+
+    assertTrue(metisContentStoreInterface_GetByteCapacity(store) == METIS_DISK_CONTENT_STORE_DEFAULT_BYTES,
+               "Expected the default byte capacity, got %zu", metisContentStoreInterface_GetByteCapacity(store));
+    assertTrue(metisContentStoreInterface_GetObjectCount(store) == 0, "Expected an empty store");
+    assertTrue(metisDiskContentStore_GetSegmentCount(store) == 0, "Expected no segments before the first save");
+
+    metisContentStoreInterface_Release(&store);
+}
+
+LONGBOW_TEST_CASE(Global, metisDiskContentStore_Log)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    MetisContentStoreInterface *store = _createDiskContentStore(data, 0);
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, data->logger);
+    metisContentStoreInterface_PutContent(store, object, 1);
+    metisMessage_Release(&object);
+
+    metisContentStoreInterface_Log(store);
+    metisContentStoreInterface_Release(&store);
+}
+
+LONGBOW_TEST_CASE(Global, metisDiskContentStore_Fetch_ByName)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    MetisContentStoreInterface *store = _createDiskContentStore(data, 0);
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, data->logger);
+    metisMessage_SetExpiryTimeTicks(object, 300);
+    metisMessage_SetRecommendedCacheTimeTicks(object, 200);
+
+    bool success = metisContentStoreInterface_PutContent(store, object, 100);
+    assertTrue(success, "Expected to save the object");
+    assertTrue(metisContentStoreInterface_GetObjectCount(store) == 1, "Wrong object count, expected 1 got %zu",
+               metisContentStoreInterface_GetObjectCount(store));
+    assertTrue(metisContentStoreInterface_GetByteCount(store) == metisMessage_Length(object), "Wrong byte count, expected %zu got %zu",
+               metisMessage_Length(object), metisContentStoreInterface_GetByteCount(store));
+
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 3, 5, data->logger);
+    MetisMessage *test = metisContentStoreInterface_MatchInterest(store, interest);
+    assertNotNull(test, "Expected a match by name");
+
+    struct iovec truth;
+    struct iovec actual;
+    metisMessage_GetIovec(object, &truth);
+    metisMessage_GetIovec(test, &actual);
+    assertTrue(truth.iov_len == actual.iov_len && memcmp(truth.iov_base, actual.iov_base, truth.iov_len) == 0,
+               "Matched object does not have the saved bytes");
+
+    // Written by this store, so the tick values are kept
+    assertTrue(metisMessage_HasExpiryTime(test) && metisMessage_GetExpiryTimeTicks(test) == 300, "Expected the saved ExpiryTime");
+    assertTrue(metisMessage_HasRecommendedCacheTime(test) && metisMessage_GetRecommendedCacheTimeTicks(test) == 200, "Expected the saved RCT");
+
+    metisMessage_Release(&interest);
+    metisMessage_Release(&object);
+    metisContentStoreInterface_Release(&store);
+}
+
+LONGBOW_TEST_CASE(Global, metisDiskContentStore_Fetch_Miss)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    MetisContentStoreInterface *store = _createDiskContentStore(data, 0);
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, data->logger);
+    metisContentStoreInterface_PutContent(store, object, 1);
+
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithOtherName, sizeof(metisTestDataV0_InterestWithOtherName), 3, 5, data->logger);
+    MetisMessage *test = metisContentStoreInterface_MatchInterest(store, interest);
+    assertNull(test, "Expected no match for a different name");
+
+    metisMessage_Release(&interest);
+    metisMessage_Release(&object);
+    metisContentStoreInterface_Release(&store);
+}
+
+LONGBOW_TEST_CASE(Global, metisDiskContentStore_Save_Duplicate)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    MetisContentStoreInterface *store = _createDiskContentStore(data, 0);
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, data->logger);
+    assertTrue(metisContentStoreInterface_PutContent(store, object, 1), "Expected the first save to succeed");
+    assertFalse(metisContentStoreInterface_PutContent(store, object, 1), "Expected the duplicate save to fail");
+    assertTrue(metisContentStoreInterface_GetObjectCount(store) == 1, "Wrong object count, expected 1 got %zu",
+               metisContentStoreInterface_GetObjectCount(store));
+
+    metisMessage_Release(&object);
+    metisContentStoreInterface_Release(&store);
+}
+
+LONGBOW_TEST_CASE(Global, metisDiskContentStore_Save_ExpiredContent)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    MetisContentStoreInterface *store = _createDiskContentStore(data, 0);
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, data->logger);
+    metisMessage_SetExpiryTimeTicks(object, 100);
+
+    assertFalse(metisContentStoreInterface_PutContent(store, object, 200), "Expected expired content to be refused");
+    assertTrue(metisContentStoreInterface_GetObjectCount(store) == 0, "Expected an empty store");
+
+    metisMessage_Release(&object);
+    metisContentStoreInterface_Release(&store);
+}
+
+LONGBOW_TEST_CASE(Global, metisDiskContentStore_Remove_Content)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    MetisContentStoreInterface *store = _createDiskContentStore(data, 0);
+
+    MetisMessage *object_1 = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, data->logger);
+    MetisMessage *object_2 = metisMessage_CreateFromArray(metisTestDataV0_SecondObject, sizeof(metisTestDataV0_SecondObject), 1, 2, data->logger);
+    metisContentStoreInterface_PutContent(store, object_1, 1);
+    metisContentStoreInterface_PutContent(store, object_2, 1);
+
+    assertTrue(metisContentStoreInterface_RemoveContent(store, object_2), "Expected to remove the second object");
+    assertFalse(metisContentStoreInterface_RemoveContent(store, object_2), "Expected the second remove to fail");
+    assertTrue(metisContentStoreInterface_GetObjectCount(store) == 1, "Wrong object count, expected 1 got %zu",
+               metisContentStoreInterface_GetObjectCount(store));
+    assertTrue(metisContentStoreInterface_GetByteCount(store) == metisMessage_Length(object_1), "Wrong byte count, expected %zu got %zu",
+               metisMessage_Length(object_1), metisContentStoreInterface_GetByteCount(store));
+
+    metisMessage_Release(&object_1);
+    metisMessage_Release(&object_2);
+    metisContentStoreInterface_Release(&store);
+}
+
+LONGBOW_TEST_CASE(Global, metisDiskContentStore_Recover)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    MetisContentStoreInterface *store = _createDiskContentStore(data, 0);
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, data->logger);
+    metisContentStoreInterface_PutContent(store, object, 1);
+    metisContentStoreInterface_Release(&store);
+
+    // a new store on the same directory, like after a restart
+    store = _createDiskContentStore(data, 0);
+    assertTrue(metisContentStoreInterface_GetObjectCount(store) == 1, "Expected to recover 1 object, got %zu",
+               metisContentStoreInterface_GetObjectCount(store));
+
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 3, 5, data->logger);
+    MetisMessage *test = metisContentStoreInterface_MatchInterest(store, interest);
+    assertNotNull(test, "Expected a match from the recovered segment");
+    assertTrue(metisMessage_Length(test) == metisMessage_Length(object), "Recovered object has the wrong length");
+
+    // New objects go to a new segment, never in to a recovered one
+    MetisMessage *second = metisMessage_CreateFromArray(metisTestDataV0_SecondObject, sizeof(metisTestDataV0_SecondObject), 1, 2, data->logger);
+    metisContentStoreInterface_PutContent(store, second, 1);
+    assertTrue(metisDiskContentStore_GetSegmentCount(store) == 2, "Expected 2 segments, got %zu", metisDiskContentStore_GetSegmentCount(store));
+
+    metisMessage_Release(&second);
+    metisMessage_Release(&interest);
+    metisMessage_Release(&object);
+    metisContentStoreInterface_Release(&store);
+}
+
+LONGBOW_TEST_CASE(Global, metisDiskContentStore_Recover_Tombstone)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    MetisContentStoreInterface *store = _createDiskContentStore(data, 0);
+
+    MetisMessage *object_1 = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, data->logger);
+    MetisMessage *object_2 = metisMessage_CreateFromArray(metisTestDataV0_SecondObject, sizeof(metisTestDataV0_SecondObject), 1, 2, data->logger);
+    metisContentStoreInterface_PutContent(store, object_1, 1);
+    metisContentStoreInterface_PutContent(store, object_2, 1);
+    metisContentStoreInterface_RemoveContent(store, object_1);
+    metisContentStoreInterface_Release(&store);
+
+    store = _createDiskContentStore(data, 0);
+    assertTrue(metisContentStoreInterface_GetObjectCount(store) == 1, "Expected to recover 1 object, got %zu",
+               metisContentStoreInterface_GetObjectCount(store));
+    assertFalse(metisContentStoreInterface_RemoveContent(store, object_1), "Removed object came back after recovery");
+    assertTrue(metisContentStoreInterface_RemoveContent(store, object_2), "Expected the live object after recovery");
+
+    metisMessage_Release(&object_1);
+    metisMessage_Release(&object_2);
+    metisContentStoreInterface_Release(&store);
+}
+
+LONGBOW_TEST_CASE(Global, metisDiskContentStore_SegmentEviction)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    // Small enough for the minimum of two minimum size segments
+    size_t byteCapacity = 2 * METIS_DISK_MIN_SEGMENT_BYTES;
+    MetisContentStoreInterface *store = _createDiskContentStore(data, byteCapacity);
+
+    // Several times more than fits
+    unsigned count = (unsigned) (4 * byteCapacity / sizeof(metisTestDataV0_EncodedObject));
+    for (unsigned i = 0; i < count; i++) {
+        MetisMessage *object = _createNumberedObject(data->logger, i);
+        bool success = metisContentStoreInterface_PutContent(store, object, 1);
+        assertTrue(success, "Failed to save object %u", i);
+        metisMessage_Release(&object);
+    }
+
+    _MetisDiskContentStore *diskStore = metisContentStoreInterface_GetPrivateData(store);
+    assertTrue(diskStore->stats.countSegmentEvictions > 0, "Expected to evict segments");
+    assertTrue(metisDiskContentStore_GetSegmentCount(store) <= diskStore->maxSegments, "Too many segments: %zu",
+               metisDiskContentStore_GetSegmentCount(store));
+    assertTrue(metisContentStoreInterface_GetByteCount(store) <= byteCapacity, "Byte count %zu over capacity %zu",
+               metisContentStoreInterface_GetByteCount(store), byteCapacity);
+    assertTrue(metisContentStoreInterface_GetObjectCount(store) > 0 && metisContentStoreInterface_GetObjectCount(store) < count,
+               "Wrong object count %zu", metisContentStoreInterface_GetObjectCount(store));
+
+    // The newest object survives, the oldest was evicted with its segment
+    MetisMessage *newest = _createNumberedObject(data->logger, count - 1);
+    MetisMessage *oldest = _createNumberedObject(data->logger, 0);
+    assertTrue(metisContentStoreInterface_RemoveContent(store, newest), "Expected the newest object in the store");
+    assertFalse(metisContentStoreInterface_RemoveContent(store, oldest), "Expected the oldest object to be evicted");
+
+    metisMessage_Release(&newest);
+    metisMessage_Release(&oldest);
+    metisContentStoreInterface_Release(&store);
+}
+
+/**
+ * A segment that cannot be created fails the put, it does not take the forwarder down
+ */
+LONGBOW_TEST_CASE(Global, metisDiskContentStore_Save_SegmentOpenFails)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    MetisContentStoreInterface *store = _createDiskContentStore(data, 0);
+    _MetisDiskContentStore *diskStore = metisContentStoreInterface_GetPrivateData(store);
+
+    // Without the directory no segment file can be opened
+    _removeDirectory(data->directory);
+
+    _MetisDiskSegment *segment = _metisDiskContentStore_OpenSegment(diskStore, diskStore->nextSegmentId, true);
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, data->logger);
+    bool success = metisContentStoreInterface_PutContent(store, object, 1);
+    size_t count = metisContentStoreInterface_GetObjectCount(store);
+    size_t segmentCount = metisDiskContentStore_GetSegmentCount(store);
+
+    metisMessage_Release(&object);
+    metisContentStoreInterface_Release(&store);
+
+    assertNull(segment, "Expected no segment without a directory");
+    assertFalse(success, "Put should fail when no segment can be opened");
+    assertTrue(count == 0, "Wrong object count, expected 0 got %zu", count);
+    assertTrue(segmentCount == 0, "Wrong segment count, expected 0 got %zu", segmentCount);
+}
+
+// ============================================================================
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _metisDiskContentStore_RecordBytes);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Local, _metisDiskContentStore_RecordBytes)
+{
+    for (size_t length = 0; length < 64; length++) {
+        size_t recordBytes = _metisDiskContentStore_RecordBytes(length);
+        assertTrue(recordBytes % 8 == 0, "Record of %zu bytes not aligned: %zu", length, recordBytes);
+        assertTrue(recordBytes >= sizeof(_MetisDiskRecordHeader) + length, "Record of %zu bytes too short: %zu", length, recordBytes);
+        assertTrue(recordBytes < sizeof(_MetisDiskRecordHeader) + length + 8, "Record of %zu bytes too long: %zu", length, recordBytes);
+    }
+}
+
+// ============================================================================
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_DiskContentStore);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
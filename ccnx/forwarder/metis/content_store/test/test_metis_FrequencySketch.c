@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metis_FrequencySketch.c"
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+
+LONGBOW_TEST_RUNNER(metis_FrequencySketch)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_FrequencySketch)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_FrequencySketch)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// =================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisFrequencySketch_Create_Destroy);
+    LONGBOW_RUN_TEST_CASE(Global, metisFrequencySketch_Increment_Estimate);
+    LONGBOW_RUN_TEST_CASE(Global, metisFrequencySketch_Increment_Saturates);
+    LONGBOW_RUN_TEST_CASE(Global, metisFrequencySketch_Scan);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, metisFrequencySketch_Create_Destroy)
+{
+    MetisFrequencySketch *sketch = metisFrequencySketch_Create(1000);
+    assertNotNull(sketch, "Got null sketch");
+    assertTrue(metisFrequencySketch_Estimate(sketch, 42) == 0, "New sketch should count nothing");
+    metisFrequencySketch_Destroy(&sketch);
+    assertNull(sketch, "Destroy did not null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, metisFrequencySketch_Increment_Estimate)
+{
+    MetisFrequencySketch *sketch = metisFrequencySketch_Create(1000);
+
+    for (int i = 0; i < 5; i++) {
+        metisFrequencySketch_Increment(sketch, 42);
+    }
+    metisFrequencySketch_Increment(sketch, 7);
+
+    unsigned hot = metisFrequencySketch_Estimate(sketch, 42);
+    unsigned cold = metisFrequencySketch_Estimate(sketch, 7);
+    unsigned unseen = metisFrequencySketch_Estimate(sketch, 99);
+
+    metisFrequencySketch_Destroy(&sketch);
+
+    assertTrue(hot == 5, "Wrong estimate for hot key, expected 5 got %u", hot);
+    assertTrue(cold == 1, "Wrong estimate for cold key, expected 1 got %u", cold);
+    assertTrue(unseen == 0, "Wrong estimate for unseen key, expected 0 got %u", unseen);
+}
+
+LONGBOW_TEST_CASE(Global, metisFrequencySketch_Increment_Saturates)
+{
+    MetisFrequencySketch *sketch = metisFrequencySketch_Create(1000);
+
+    for (int i = 0; i < 100; i++) {
+        metisFrequencySketch_Increment(sketch, 42);
+    }
+    unsigned estimate = metisFrequencySketch_Estimate(sketch, 42);
+
+    metisFrequencySketch_Destroy(&sketch);
+
+    assertTrue(estimate == METIS_FREQUENCY_SKETCH_COUNTER_MAX, "Wrong estimate, expected %u got %u",
+               METIS_FREQUENCY_SKETCH_COUNTER_MAX, estimate);
+}
+
+/**
+ * A scan of many keys seen once must not make those keys look popular, and must not keep
+ * a hot key from looking hot
+ */
+LONGBOW_TEST_CASE(Global, metisFrequencySketch_Scan)
+{
+    MetisFrequencySketch *sketch = metisFrequencySketch_Create(1000);
+
+    for (uint64_t key = 1; key <= 100000; key++) {
+        metisFrequencySketch_Increment(sketch, key * 0x9E3779B1ULL);
+        if (key % 10 == 0) {
+            metisFrequencySketch_Increment(sketch, 42);
+        }
+    }
+
+    unsigned hot = metisFrequencySketch_Estimate(sketch, 42);
+    unsigned scanned = 0;
+    for (uint64_t key = 1; key <= 100000; key += 97) {
+        unsigned estimate = metisFrequencySketch_Estimate(sketch, key * 0x9E3779B1ULL);
+        if (estimate > scanned) {
+            scanned = estimate;
+        }
+    }
+
+    metisFrequencySketch_Destroy(&sketch);
+
+    assertTrue(hot > 5, "Hot key should stand out, got estimate %u", hot);
+    assertTrue(scanned < hot, "Scanned keys (up to %u) should estimate below the hot key (%u)", scanned, hot);
+}
+
+// =================================================================
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _metisFrequencySketch_Halve);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Local, _metisFrequencySketch_Halve)
+{
+    MetisFrequencySketch *sketch = metisFrequencySketch_Create(1000);
+
+    for (int i = 0; i < 9; i++) {
+        metisFrequencySketch_Increment(sketch, 42);
+    }
+    _metisFrequencySketch_Halve(sketch);
+    unsigned estimate = metisFrequencySketch_Estimate(sketch, 42);
+    size_t additions = sketch->additions;
+
+    metisFrequencySketch_Destroy(&sketch);
+
+    // halving must not carry a bit in to the neighbouring counter
+    assertTrue(estimate == 4, "Wrong estimate after halving, expected 4 got %u", estimate);
+    assertTrue(additions == 4, "Wrong additions after halving, expected 4 got %zu", additions);
+}
+
+// =================================================================
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_FrequencySketch);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -57,9 +57,14 @@
 #include "../metis_LRUContentStore.c"
 #include <LongBow/unit-test.h>
 
+#include <dirent.h>
+#include <limits.h>
+
 #include <parc/algol/parc_SafeMemory.h>
 #include <parc/logging/parc_LogReporterTextStdout.h>
 
+#include <ccnx/forwarder/metis/content_store/metis_DiskContentStore.h>
+
 #include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
 #include <ccnx/forwarder/metis/testdata/metis_TestDataV1.h>
 
@@ -94,7 +99,9 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Create_ZeroCapacity);
     LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Fetch_ByName);
     LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Fetch_ByNameAndKeyId);
+    LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Fetch_ByNameAndKeyId_AfterRemoveFirst);
     LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Fetch_ByNameAndObjectHash);
+    LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Fetch_ByNameAndObjectHash_SecondWithName);
 
     LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Remove_Content);
     LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Remove_NonExistentContent);
@@ -103,6 +110,12 @@ LONGBOW_TEST_FIXTURE(Global)
 
     LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Save_ZeroCapacity);
     LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Save_CapacityLimit);
+    LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Save_ByteCapacityLimit);
+    LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Save_LargerThanByteCapacity);
+    LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Remove_ByteCount);
+    LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_SetCapacity_Grow);
+    LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_SetCapacity_Shrink_Trim);
+    LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_SetCapacity_Shrink_Save);
     LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Save_WithoutEviction);
     LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Save_WithEviction);
 
@@ -112,6 +125,10 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Save_ExpiredContent);
 
     LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_Save_DuplicateHash);
+
+    LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_SecondTier_DemoteAndPromote);
+    LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_SecondTier_DemoteOnRelease);
+    LONGBOW_RUN_TEST_CASE(Global, metisLRUContentStore_SecondTier_PromoteFails);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -149,6 +166,27 @@ _createLRUContentStore(size_t capacity)
     return store;
 }
 
+static MetisContentStoreInterface *
+_createLRUContentStoreWithByteCapacity(size_t capacity, size_t byteCapacity)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    metisLogger_SetLogLevel(logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug);
+
+    MetisContentStoreConfig config = {
+        .objectCapacity = capacity,
+        .byteCapacity   = byteCapacity,
+    };
+
+    MetisContentStoreInterface *store = metisLRUContentStore_Create(&config, logger);
+
+    metisLogger_Release(&logger);
+
+    return store;
+}
+
 static MetisMessage *
 _createUniqueMetisMessage(MetisLogger *logger, int tweakNumber, uint8_t *template, size_t templateSize, int nameOffset)
 {
@@ -308,6 +346,46 @@ LONGBOW_TEST_CASE(Global, metisLRUContentStore_Fetch_ByNameAndKeyId)
     metisMessage_Release(&interestByNameKeyId);
 }
 
+LONGBOW_TEST_CASE(Global, metisLRUContentStore_Fetch_ByNameAndKeyId_AfterRemoveFirst)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    size_t capacity = 10;
+    MetisContentStoreInterface *store = _createLRUContentStore(capacity);
+
+    // same name and KeyId as the first object, different signature bits
+    uint8_t secondEncoded[sizeof(metisTestDataV0_EncodedObject)];
+    memcpy(secondEncoded, metisTestDataV0_EncodedObject, sizeof(secondEncoded));
+    secondEncoded[sizeof(secondEncoded) - 1] = 0x01;
+
+    MetisMessage *object_1 = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject,
+                                                          sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisMessage *object_2 = metisMessage_CreateFromArray(secondEncoded, sizeof(secondEncoded), 1, 2, logger);
+
+    metisContentStoreInterface_PutContent(store, object_1, 1);
+    metisContentStoreInterface_PutContent(store, object_2, 1);
+
+    // object_1 was the one in the name and KeyId index
+    bool removed = metisContentStoreInterface_RemoveContent(store, object_1);
+
+    MetisMessage *interestByNameKeyId = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName_keyid,
+                                                                     sizeof(metisTestDataV0_InterestWithName_keyid),
+                                                                     3, 5, logger);
+
+    MetisMessage *testObject = metisContentStoreInterface_MatchInterest(store, interestByNameKeyId);
+    assertTrue(removed, "Failed to remove the first object");
+    assertTrue(testObject == object_2, "Fetch returned wrong object, expecting %p got %p",
+               (void *) object_2, (void *) testObject);
+
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+    metisMessage_Release(&object_1);
+    metisMessage_Release(&object_2);
+    metisMessage_Release(&interestByNameKeyId);
+}
+
 LONGBOW_TEST_CASE(Global, metisLRUContentStore_Fetch_ByNameAndObjectHash)
 {
     PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
@@ -356,6 +434,54 @@ LONGBOW_TEST_CASE(Global, metisLRUContentStore_Fetch_ByNameAndObjectHash)
     metisMessage_Release(&interestByNameObjectHash);
 }
 
+LONGBOW_TEST_CASE(Global, metisLRUContentStore_Fetch_ByNameAndObjectHash_SecondWithName)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    size_t capacity = 10;
+    MetisContentStoreInterface *store = _createLRUContentStore(capacity);
+
+    // Both objects have the same name.  The one the interest's ContentObjectHash matches is stored second,
+    // so it is chained behind the first in the name index.
+    MetisMessage *object_1 = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject,
+                                                          sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisMessage *object_2 = metisMessage_CreateFromArray(metisTestDataV0_SecondObject,
+                                                          sizeof(metisTestDataV0_SecondObject), 1, 2, logger);
+
+    metisContentStoreInterface_PutContent(store, object_2, 10);
+    metisContentStoreInterface_PutContent(store, object_1, 10);
+    size_t count = metisContentStoreInterface_GetObjectCount(store);
+
+    MetisMessage *interestByName =
+        metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 3, 5, logger);
+    MetisMessage *interestByNameObjectHash =
+        metisMessage_CreateFromArray(metisTestDataV0_InterestWithName_objecthash,
+                                     sizeof(metisTestDataV0_InterestWithName_objecthash), 3, 5, logger);
+
+    MetisMessage *byHash = metisContentStoreInterface_MatchInterest(store, interestByNameObjectHash);
+    MetisMessage *byName = metisContentStoreInterface_MatchInterest(store, interestByName);
+
+    // Removing the first object with the name leaves the second one findable by name
+    metisContentStoreInterface_RemoveContent(store, object_2);
+    MetisMessage *byNameAfterRemove = metisContentStoreInterface_MatchInterest(store, interestByName);
+
+    metisContentStoreInterface_Release(&store);
+    metisMessage_Release(&interestByName);
+    metisMessage_Release(&interestByNameObjectHash);
+
+    assertTrue(count == 2, "Expected 2 objects in the store, got %zu", count);
+    assertTrue(byHash == object_1, "Fetch by hash returned wrong object, expecting %p got %p", (void *) object_1, (void *) byHash);
+    assertTrue(byName == object_2, "Fetch by name returned wrong object, expecting %p got %p", (void *) object_2, (void *) byName);
+    assertTrue(byNameAfterRemove == object_1, "Fetch by name after remove returned wrong object, expecting %p got %p",
+               (void *) object_1, (void *) byNameAfterRemove);
+
+    metisMessage_Release(&object_1);
+    metisMessage_Release(&object_2);
+    metisLogger_Release(&logger);
+}
+
 LONGBOW_TEST_CASE(Global, metisLRUContentStore_Remove_Content)
 {
     PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
@@ -522,7 +648,7 @@ LONGBOW_TEST_CASE(Global, metisLRUContentStore_Save_WithoutEviction)
     metisContentStoreInterface_PutContent(store, object_2, 10);
 
     _MetisLRUContentStore *internalStore = ( _MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(store);
-    _MetisLRUContentStoreStats *stats = &internalStore->stats;
+    MetisContentStoreIndexStats *stats = &internalStore->index.stats;
 
     assertTrue(stats->countAdds == 2, "Wrong countAdds, expected %u got %" PRIu64, 2, stats->countAdds);
     assertTrue(stats->countLruEvictions == 0, "Wrong countLruEvictions, expected %u got %" PRIu64, 0, stats->countLruEvictions);
@@ -562,7 +688,7 @@ LONGBOW_TEST_CASE(Global, metisLRUContentStore_Save_WithEviction)
     metisContentStoreInterface_PutContent(store, content_3, 1);
 
     _MetisLRUContentStore *internalStore = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(store);
-    _MetisLRUContentStoreStats *stats = &internalStore->stats;
+    MetisContentStoreIndexStats *stats = &internalStore->index.stats;
 
     // Capacity is 1, so we should never grow bigger than that.
     assertTrue(metisContentStoreInterface_GetObjectCount(store) == 1, "Wrong objectCount. Expected %u, got %zu", 1, metisContentStoreInterface_GetObjectCount(store));
@@ -638,7 +764,7 @@ LONGBOW_TEST_CASE(Global, metisLRUContentStore_Save_WithEvictionByExpiryTime)
     metisContentStoreInterface_PutContent(store, object_2, expiryTime + 10); // Add this one after expiration of first one.
 
     _MetisLRUContentStore *internalStore = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(store);
-    _MetisLRUContentStoreStats *stats = &internalStore->stats;
+    MetisContentStoreIndexStats *stats = &internalStore->index.stats;
 
     // Capacity is 1, so we should never grow bigger than that.
     assertTrue(metisContentStoreInterface_GetObjectCount(store) == 1, "Wrong objectCount. Expected 1, got %zu", metisContentStoreInterface_GetObjectCount(store));
@@ -682,7 +808,7 @@ LONGBOW_TEST_CASE(Global, metisLRUContentStore_Save_WithEvictionByRCT)
     metisContentStoreInterface_PutContent(store, object_2, recommendedCacheTime + 1); // Add this one after the first one's RCT.
 
     _MetisLRUContentStore *internalStore = (_MetisLRUContentStore *) metisContentStoreInterface_GetPrivateData(store);
-    _MetisLRUContentStoreStats *stats = &internalStore->stats;
+    MetisContentStoreIndexStats *stats = &internalStore->index.stats;
 
     // Capacity is 1, so we should never grow bigger than that.
     assertTrue(metisContentStoreInterface_GetObjectCount(store) == 1, "Wrong objectCount. Expected 1, got %zu",
@@ -759,6 +885,191 @@ LONGBOW_TEST_CASE(Global, metisLRUContentStore_Save_CapacityLimit)
     metisContentStoreInterface_Release(&store);
 }
 
+/**
+ * With a byte budget of 3 objects and a large object capacity, the byte budget limits the store
+ */
+LONGBOW_TEST_CASE(Global, metisLRUContentStore_Save_ByteCapacityLimit)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    size_t objectLength = sizeof(metisTestDataV0_EncodedObject);
+    MetisContentStoreInterface *store = _createLRUContentStoreWithByteCapacity(100, 3 * objectLength);
+
+    for (int i = 1; i < 10; i++) {
+        int offsetOfNameInEncodedObject = metisTestDataV0_EncodedObject_name.offset + 4;
+
+        MetisMessage *object = _createUniqueMetisMessage(logger, i,
+                                                         metisTestDataV0_EncodedObject,
+                                                         sizeof(metisTestDataV0_EncodedObject),
+                                                         offsetOfNameInEncodedObject);
+
+        bool success = metisContentStoreInterface_PutContent(store, object, 1);
+        assertTrue(success, "Unexpectedly failed to add entry to ContentStore");
+        metisMessage_Release(&object);
+
+        size_t expectedCount = (i < 3) ? i : 3;
+        size_t count = metisContentStoreInterface_GetObjectCount(store);
+        size_t byteCount = metisContentStoreInterface_GetByteCount(store);
+        assertTrue(count == expectedCount, "Wrong object count, expected %zu got %zu", expectedCount, count);
+        assertTrue(byteCount == expectedCount * objectLength, "Wrong byte count, expected %zu got %zu", expectedCount * objectLength, byteCount);
+        assertTrue(byteCount <= metisContentStoreInterface_GetByteCapacity(store), "Byte count %zu over capacity", byteCount);
+    }
+
+    metisLogger_Release(&logger);
+    metisContentStoreInterface_Release(&store);
+}
+
+/**
+ * An object bigger than the byte budget is not stored and does not evict anything
+ */
+LONGBOW_TEST_CASE(Global, metisLRUContentStore_Save_LargerThanByteCapacity)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    size_t objectLength = sizeof(metisTestDataV0_EncodedObject);
+    MetisContentStoreInterface *store = _createLRUContentStoreWithByteCapacity(100, objectLength - 1);
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    bool success = metisContentStoreInterface_PutContent(store, object, 1);
+    size_t count = metisContentStoreInterface_GetObjectCount(store);
+
+    metisMessage_Release(&object);
+    metisLogger_Release(&logger);
+    metisContentStoreInterface_Release(&store);
+
+    assertFalse(success, "Should not store an object larger than the byte capacity");
+    assertTrue(count == 0, "Wrong object count, expected 0 got %zu", count);
+}
+
+LONGBOW_TEST_CASE(Global, metisLRUContentStore_Remove_ByteCount)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createLRUContentStoreWithByteCapacity(10, 100000);
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    metisContentStoreInterface_PutContent(store, object, 1);
+    size_t before = metisContentStoreInterface_GetByteCount(store);
+    metisContentStoreInterface_RemoveContent(store, object);
+    size_t after = metisContentStoreInterface_GetByteCount(store);
+
+    metisMessage_Release(&object);
+    metisLogger_Release(&logger);
+    metisContentStoreInterface_Release(&store);
+
+    assertTrue(before == sizeof(metisTestDataV0_EncodedObject), "Wrong byte count after put, got %zu", before);
+    assertTrue(after == 0, "Wrong byte count after remove, expected 0 got %zu", after);
+}
+
+static void
+_fillLRUContentStore(MetisContentStoreInterface *store, MetisLogger *logger, int first, int count)
+{
+    int offsetOfNameInEncodedObject = metisTestDataV0_EncodedObject_name.offset + 4;
+
+    for (int i = first; i < first + count; i++) {
+        MetisMessage *object = _createUniqueMetisMessage(logger, i,
+                                                         metisTestDataV0_EncodedObject,
+                                                         sizeof(metisTestDataV0_EncodedObject),
+                                                         offsetOfNameInEncodedObject);
+        bool success = metisContentStoreInterface_PutContent(store, object, 1);
+        assertTrue(success, "Unexpectedly failed to add entry %d to ContentStore", i);
+        metisMessage_Release(&object);
+    }
+}
+
+/**
+ * Growing the store keeps what it holds and lets it take more
+ */
+LONGBOW_TEST_CASE(Global, metisLRUContentStore_SetCapacity_Grow)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createLRUContentStore(3);
+    _fillLRUContentStore(store, logger, 0, 3);
+
+    bool resized = metisContentStoreInterface_SetCapacity(store, 6, 0);
+    size_t countAfterResize = metisContentStoreInterface_GetObjectCount(store);
+    bool trimmed = metisContentStoreInterface_Trim(store, 1, 1);
+
+    _fillLRUContentStore(store, logger, 3, 3);
+    size_t countAfterFill = metisContentStoreInterface_GetObjectCount(store);
+    size_t capacity = metisContentStoreInterface_GetObjectCapacity(store);
+
+    metisLogger_Release(&logger);
+    metisContentStoreInterface_Release(&store);
+
+    assertTrue(resized, "LRU store should resize in place");
+    assertTrue(countAfterResize == 3, "Wrong object count after resize, expected 3 got %zu", countAfterResize);
+    assertTrue(trimmed, "A store under capacity should need no trimming");
+    assertTrue(countAfterFill == 6, "Wrong object count after fill, expected 6 got %zu", countAfterFill);
+    assertTrue(capacity == 6, "Wrong object capacity, expected 6 got %zu", capacity);
+}
+
+/**
+ * Shrinking the store evicts nothing until it is trimmed, and each trim is bounded
+ */
+LONGBOW_TEST_CASE(Global, metisLRUContentStore_SetCapacity_Shrink_Trim)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createLRUContentStore(10);
+    _fillLRUContentStore(store, logger, 0, 10);
+
+    metisContentStoreInterface_SetCapacity(store, 4, 0);
+    size_t countAfterResize = metisContentStoreInterface_GetObjectCount(store);
+
+    bool firstTrimDone = metisContentStoreInterface_Trim(store, 3, 1);
+    size_t countAfterFirstTrim = metisContentStoreInterface_GetObjectCount(store);
+
+    bool secondTrimDone = metisContentStoreInterface_Trim(store, 100, 1);
+    size_t countAfterSecondTrim = metisContentStoreInterface_GetObjectCount(store);
+
+    metisLogger_Release(&logger);
+    metisContentStoreInterface_Release(&store);
+
+    assertTrue(countAfterResize == 10, "Resize should not evict, expected 10 got %zu", countAfterResize);
+    assertFalse(firstTrimDone, "First trim should stop at its batch limit");
+    assertTrue(countAfterFirstTrim == 7, "Wrong object count after first trim, expected 7 got %zu", countAfterFirstTrim);
+    assertTrue(secondTrimDone, "Second trim should reach the capacity");
+    assertTrue(countAfterSecondTrim == 4, "Wrong object count after second trim, expected 4 got %zu", countAfterSecondTrim);
+}
+
+/**
+ * A put into a store that is over capacity after a shrink only makes room for itself,
+ * it leaves the rest of the excess for Trim
+ */
+LONGBOW_TEST_CASE(Global, metisLRUContentStore_SetCapacity_Shrink_Save)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    size_t objectLength = sizeof(metisTestDataV0_EncodedObject);
+    MetisContentStoreInterface *store = _createLRUContentStoreWithByteCapacity(10, 10 * objectLength);
+    _fillLRUContentStore(store, logger, 0, 8);
+
+    metisContentStoreInterface_SetCapacity(store, 4, 2 * objectLength);
+    _fillLRUContentStore(store, logger, 8, 1);
+    size_t count = metisContentStoreInterface_GetObjectCount(store);
+    size_t byteCount = metisContentStoreInterface_GetByteCount(store);
+
+    metisLogger_Release(&logger);
+    metisContentStoreInterface_Release(&store);
+
+    assertTrue(count == 8, "Wrong object count, expected 8 got %zu", count);
+    assertTrue(byteCount == 8 * objectLength, "Wrong byte count, expected %zu got %zu", 8 * objectLength, byteCount);
+}
+
 LONGBOW_TEST_CASE(Global, metisLRUContentStore_Save_DuplicateHash)
 {
     PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
@@ -793,6 +1104,161 @@ LONGBOW_TEST_CASE(Global, metisLRUContentStore_Save_DuplicateHash)
     metisLogger_Release(&logger);
 }
 
+static void
+_removeDirectory(const char *directory)
+{
+    DIR *dir = opendir(directory);
+    if (dir) {
+        struct dirent *dirent;
+        while ((dirent = readdir(dir)) != NULL) {
+            if (dirent->d_name[0] != '.') {
+                char path[PATH_MAX];
+                snprintf(path, sizeof(path), "%s/%s", directory, dirent->d_name);
+                unlink(path);
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(directory);
+}
+
+static MetisContentStoreInterface *
+_createTieredContentStore(MetisLogger *logger, size_t capacity, const char *directory, MetisContentStoreInterface **diskStorePtr)
+{
+    MetisContentStoreConfig diskConfig = {
+        .byteCapacity = 1024 * 1024,
+    };
+    *diskStorePtr = metisDiskContentStore_Create(&diskConfig, directory, logger);
+    assertNotNull(*diskStorePtr, "Could not create a disk store in %s", directory);
+
+    MetisContentStoreConfig config = {
+        .objectCapacity = capacity,
+        .secondTier     = *diskStorePtr,
+    };
+
+    return metisLRUContentStore_Create(&config, logger);
+}
+
+LONGBOW_TEST_CASE(Global, metisLRUContentStore_SecondTier_DemoteAndPromote)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    char directory[] = "/tmp/test_metis_LRUContentStore.XXXXXX";
+    assertNotNull(mkdtemp(directory), "mkdtemp failed: (%d) %s", errno, strerror(errno));
+
+    MetisContentStoreInterface *diskStore;
+    MetisContentStoreInterface *store = _createTieredContentStore(logger, 1, directory, &diskStore);
+
+    MetisMessage *object_1 = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisMessage *object_2 = _createUniqueMetisMessage(logger, 2, metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject),
+                                                       metisTestDataV0_EncodedObject_name.offset + 4);
+
+    // object_2 pushes object_1 out of memory and on to disk
+    metisContentStoreInterface_PutContent(store, object_1, 1);
+    metisContentStoreInterface_PutContent(store, object_2, 1);
+    assertTrue(metisContentStoreInterface_GetObjectCount(store) == 1, "Expected 1 object in memory");
+    assertTrue(metisContentStoreInterface_GetObjectCount(diskStore) == 1, "Expected 1 object demoted to disk, got %zu",
+               metisContentStoreInterface_GetObjectCount(diskStore));
+
+    // A hit on disk promotes object_1, which demotes object_2
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 3, 5, logger);
+    MetisMessage *test = metisContentStoreInterface_MatchInterest(store, interest);
+    assertNotNull(test, "Expected a match from the second tier");
+    assertTrue(metisMessage_Length(test) == metisMessage_Length(object_1), "Promoted the wrong object");
+
+    _MetisLRUContentStore *lruStore = metisContentStoreInterface_GetPrivateData(store);
+    assertTrue(lruStore->index.stats.countPromotions == 1, "Expected 1 promotion, got %" PRIu64, lruStore->index.stats.countPromotions);
+    assertTrue(lruStore->index.stats.countDemotions == 2, "Expected 2 demotions, got %" PRIu64, lruStore->index.stats.countDemotions);
+    assertTrue(lruStore->index.stats.countHits == 1, "Expected a promotion to count as a hit");
+
+    // The next match is served from memory
+    test = metisContentStoreInterface_MatchInterest(store, interest);
+    assertNotNull(test, "Expected a match from memory");
+    assertTrue(lruStore->index.stats.countPromotions == 1, "Expected the second match from memory");
+
+    metisMessage_Release(&interest);
+    metisMessage_Release(&object_1);
+    metisMessage_Release(&object_2);
+    metisContentStoreInterface_Release(&store);
+    metisContentStoreInterface_Release(&diskStore);
+    metisLogger_Release(&logger);
+    _removeDirectory(directory);
+}
+
+/**
+ * A disk hit that does not fit in memory is still a hit, and stays on disk
+ */
+LONGBOW_TEST_CASE(Global, metisLRUContentStore_SecondTier_PromoteFails)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    char directory[] = "/tmp/test_metis_LRUContentStore.XXXXXX";
+    assertNotNull(mkdtemp(directory), "mkdtemp failed: (%d) %s", errno, strerror(errno));
+
+    // a memory store that holds nothing, so every promotion fails
+    MetisContentStoreInterface *diskStore;
+    MetisContentStoreInterface *store = _createTieredContentStore(logger, 0, directory, &diskStore);
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    metisContentStoreInterface_PutContent(diskStore, object, 1);
+
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 3, 5, logger);
+    MetisMessage *test = metisContentStoreInterface_MatchInterest(store, interest);
+    size_t testLength = (test != NULL) ? metisMessage_Length(test) : 0;
+
+    _MetisLRUContentStore *lruStore = metisContentStoreInterface_GetPrivateData(store);
+    uint64_t hits = lruStore->index.stats.countHits;
+    uint64_t promotions = lruStore->index.stats.countPromotions;
+    size_t diskCount = metisContentStoreInterface_GetObjectCount(diskStore);
+
+    metisMessage_Release(&interest);
+    metisContentStoreInterface_Release(&store);
+    metisContentStoreInterface_Release(&diskStore);
+    _removeDirectory(directory);
+
+    assertTrue(testLength == metisMessage_Length(object), "Expected the disk object, got length %zu", testLength);
+    metisMessage_Release(&object);
+    metisLogger_Release(&logger);
+
+    assertTrue(hits == 1, "Expected a disk hit to count as a hit, got %" PRIu64, hits);
+    assertTrue(promotions == 0, "Expected no promotion, got %" PRIu64, promotions);
+    assertTrue(diskCount == 1, "Expected the object to stay on disk, got %zu", diskCount);
+}
+
+LONGBOW_TEST_CASE(Global, metisLRUContentStore_SecondTier_DemoteOnRelease)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    char directory[] = "/tmp/test_metis_LRUContentStore.XXXXXX";
+    assertNotNull(mkdtemp(directory), "mkdtemp failed: (%d) %s", errno, strerror(errno));
+
+    MetisContentStoreInterface *diskStore;
+    MetisContentStoreInterface *store = _createTieredContentStore(logger, 10, directory, &diskStore);
+
+    for (int i = 1; i <= 5; i++) {
+        MetisMessage *object = _createUniqueMetisMessage(logger, i, metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject),
+                                                         metisTestDataV0_EncodedObject_name.offset + 4);
+        metisContentStoreInterface_PutContent(store, object, 1);
+        metisMessage_Release(&object);
+    }
+    assertTrue(metisContentStoreInterface_GetObjectCount(diskStore) == 0, "Expected nothing on disk before release");
+
+    // Releasing the memory store keeps its contents on disk for the next run
+    metisContentStoreInterface_Release(&store);
+    assertTrue(metisContentStoreInterface_GetObjectCount(diskStore) == 5, "Expected 5 objects on disk, got %zu",
+               metisContentStoreInterface_GetObjectCount(diskStore));
+
+    metisContentStoreInterface_Release(&diskStore);
+    metisLogger_Release(&logger);
+    _removeDirectory(directory);
+}
+
 // ============================================================================
 
 LONGBOW_TEST_FIXTURE(Local)
@@ -88,9 +88,11 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, MetisLruListEntry_Destroy);
     LONGBOW_RUN_TEST_CASE(Global, metisLruEntry_GetData);
     LONGBOW_RUN_TEST_CASE(Global, metisLruEntry_MoveToHead);
+    LONGBOW_RUN_TEST_CASE(Global, metisLruEntry_MoveToHeadOf);
 
     LONGBOW_RUN_TEST_CASE(Global, metisLruList_NewHeadEntry);
     LONGBOW_RUN_TEST_CASE(Global, metisLruList_PopTail);
+    LONGBOW_RUN_TEST_CASE(Global, metisLruList_PeekTail);
     LONGBOW_RUN_TEST_CASE(Global, MetisLruList_Length);
 }
 
@@ -152,6 +154,28 @@ LONGBOW_TEST_CASE(Global, metisLruEntry_MoveToHead)
     metisLruList_Destroy(&lru);
 }
 
+LONGBOW_TEST_CASE(Global, metisLruEntry_MoveToHeadOf)
+{
+    MetisLruList *first = metisLruList_Create();
+    MetisLruList *second = metisLruList_Create();
+
+    MetisLruListEntry *a = metisLruList_NewHeadEntry(first, (void *) 1);
+    MetisLruListEntry *b = metisLruList_NewHeadEntry(first, (void *) 2);
+    metisLruList_NewHeadEntry(second, (void *) 3);
+
+    metisLruList_EntryMoveToHeadOf(a, second);
+
+    assertTrue(metisLruList_Length(first) == 1, "Wrong first length, expected 1 got %zu", metisLruList_Length(first));
+    assertTrue(metisLruList_Length(second) == 2, "Wrong second length, expected 2 got %zu", metisLruList_Length(second));
+    assertTrue(metisLruList_EntryGetList(a) == second, "Entry not bound to the second list");
+    assertTrue(metisLruList_EntryGetList(b) == first, "Other entry should stay in the first list");
+    assertTrue(TAILQ_FIRST(&second->head) == a, "Moved entry is not the head of the second list");
+
+    // destroying the second list must free the moved entry
+    metisLruList_Destroy(&first);
+    metisLruList_Destroy(&second);
+}
+
 LONGBOW_TEST_CASE(Global, metisLruList_Create_Destroy)
 {
     size_t baselineMemory = parcMemory_Outstanding();
@@ -216,6 +240,24 @@ LONGBOW_TEST_CASE(Global, metisLruList_PopTail)
     metisLruList_Destroy(&lru);
 }
 
+LONGBOW_TEST_CASE(Global, metisLruList_PeekTail)
+{
+    MetisLruList *lru = metisLruList_Create();
+
+    MetisLruListEntry *empty = metisLruList_PeekTail(lru);
+
+    MetisLruListEntry *tail = metisLruList_NewHeadEntry(lru, (void *) 1);
+    metisLruList_NewHeadEntry(lru, (void *) 2);
+
+    MetisLruListEntry *test = metisLruList_PeekTail(lru);
+    size_t length = metisLruList_Length(lru);
+
+    metisLruList_Destroy(&lru);
+
+    assertNull(empty, "An empty list should have no tail");
+    assertTrue(test == tail, "Wrong tail, expected %p got %p", (void *) tail, (void *) test);
+    assertTrue(length == 2, "Peek should not remove the tail, expected length 2 got %zu", length);
+}
 
 LONGBOW_TEST_CASE(Global, MetisLruList_Length)
 {
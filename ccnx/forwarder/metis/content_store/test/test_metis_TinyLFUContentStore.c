@@ -0,0 +1,631 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+
+#include <config.h>
+
+#include "../metis_TinyLFUContentStore.c"
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/logging/parc_LogReporterTextStdout.h>
+
+#include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
+
+
+LONGBOW_TEST_RUNNER(metis_TinyLFUContentStore)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_TinyLFUContentStore)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_TinyLFUContentStore)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ============================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisTinyLFUContentStore_Create_Destroy);
+    LONGBOW_RUN_TEST_CASE(Global, metisTinyLFUContentStore_Log);
+    LONGBOW_RUN_TEST_CASE(Global, metisTinyLFUContentStore_Fetch_ByName);
+    LONGBOW_RUN_TEST_CASE(Global, metisTinyLFUContentStore_Fetch_ProtectedOverflow);
+    LONGBOW_RUN_TEST_CASE(Global, metisTinyLFUContentStore_Remove_Content);
+    LONGBOW_RUN_TEST_CASE(Global, metisTinyLFUContentStore_Save_WithoutEviction);
+    LONGBOW_RUN_TEST_CASE(Global, metisTinyLFUContentStore_Save_RejectsCold);
+    LONGBOW_RUN_TEST_CASE(Global, metisTinyLFUContentStore_Save_AdmitsHot);
+    LONGBOW_RUN_TEST_CASE(Global, metisTinyLFUContentStore_Save_Scan);
+    LONGBOW_RUN_TEST_CASE(Global, metisTinyLFUContentStore_SetCapacity_Shrink_Trim);
+    LONGBOW_RUN_TEST_CASE(Global, metisTinyLFUContentStore_SetCapacity_Shrink_Protected);
+    LONGBOW_RUN_TEST_CASE(Global, metisTinyLFUContentStore_AccumulateStats);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+static MetisContentStoreInterface *
+_createTinyLFUContentStore(size_t capacity)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    metisLogger_SetLogLevel(logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug);
+
+    MetisContentStoreConfig config = {
+        .objectCapacity = capacity,
+    };
+
+    MetisContentStoreInterface *store = metisTinyLFUContentStore_Create(&config, logger);
+
+    metisLogger_Release(&logger);
+
+    return store;
+}
+
+static MetisMessage *
+_createUniqueMetisMessage(MetisLogger *logger, int tweakNumber, uint8_t *template, size_t templateSize, int nameOffset)
+{
+    PARCBuffer *buffer = parcBuffer_Allocate(templateSize);
+    memcpy(parcBuffer_Overlay(buffer, 0), template, templateSize);     // Copy the template to new memory
+
+    // Tweak the encoded object's name so the name hash varies each time.
+    uint8_t *bufPtr = parcBuffer_Overlay(buffer, 0);
+    bufPtr[nameOffset] = 'a' + tweakNumber;
+
+    MetisMessage *result = metisMessage_CreateFromArray(bufPtr, templateSize, 1, 2, logger);
+    parcBuffer_Release(&buffer);
+
+    return result;
+}
+
+static MetisMessage *
+_createObject(MetisLogger *logger, int tweakNumber)
+{
+    return _createUniqueMetisMessage(logger, tweakNumber, metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject),
+                                     metisTestDataV0_EncodedObject_name.offset + 4);
+}
+
+/**
+ * Counts `count` interests for the object's name, as matchInterest would
+ */
+static void
+_warmObject(MetisContentStoreInterface *store, MetisMessage *object, int count)
+{
+    _MetisTinyLFUContentStore *internalStore = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(store);
+    for (int i = 0; i < count; i++) {
+        metisFrequencySketch_Increment(internalStore->sketch, _metisTinyLFUContentStore_FrequencyKey(object));
+    }
+}
+
+/**
+ * Puts `count` unique objects, named by `first` onwards, and returns how many the store took
+ */
+static int
+_fillTinyLFUContentStore(MetisContentStoreInterface *store, MetisLogger *logger, int first, int count)
+{
+    int saved = 0;
+    for (int i = first; i < first + count; i++) {
+        MetisMessage *object = _createObject(logger, i);
+        if (metisContentStoreInterface_PutContent(store, object, 1)) {
+            saved++;
+        }
+        metisMessage_Release(&object);
+    }
+    return saved;
+}
+
+LONGBOW_TEST_CASE(Global, metisTinyLFUContentStore_Create_Destroy)
+{
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(10);
+    assertNotNull(store, "Expected to init a content store");
+
+    _MetisTinyLFUContentStore *internalStore = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(store);
+    size_t protectedCapacity = internalStore->protectedCapacity;
+    size_t capacity = metisContentStoreInterface_GetObjectCapacity(store);
+
+    metisContentStoreInterface_Release(&store);
+
+    assertTrue(capacity == 10, "Wrong capacity, expected 10 got %zu", capacity);
+    assertTrue(protectedCapacity == 8, "Wrong protected capacity, expected 8 got %zu", protectedCapacity);
+}
+
+LONGBOW_TEST_CASE(Global, metisTinyLFUContentStore_Log)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(20);
+    _fillTinyLFUContentStore(store, logger, 1, 20);
+
+    metisContentStoreInterface_Log(store);
+
+    metisLogger_Release(&logger);
+    metisContentStoreInterface_Release(&store);
+}
+
+/**
+ * A hit moves the object from probation to protected
+ */
+LONGBOW_TEST_CASE(Global, metisTinyLFUContentStore_Fetch_ByName)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(10);
+    _MetisTinyLFUContentStore *internalStore = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(store);
+
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject,
+                                                        sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisMessage *interestByName = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName,
+                                                                sizeof(metisTestDataV0_InterestWithName), 3, 5, logger);
+
+    metisContentStoreInterface_PutContent(store, object, 1);
+    size_t probationBefore = metisLruList_Length(internalStore->probation);
+
+    MetisMessage *testObject = metisContentStoreInterface_MatchInterest(store, interestByName);
+    size_t probationAfter = metisLruList_Length(internalStore->probation);
+    size_t protectedAfter = metisLruList_Length(internalStore->protected);
+    uint64_t hits = internalStore->index.stats.countHits;
+
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+    metisMessage_Release(&interestByName);
+
+    assertTrue(testObject == object, "Fetch returned wrong object, expecting %p got %p", (void *) object, (void *) testObject);
+    metisMessage_Release(&object);
+
+    assertTrue(probationBefore == 1, "New object should be in probation, got length %zu", probationBefore);
+    assertTrue(probationAfter == 0, "Hit should leave probation, got length %zu", probationAfter);
+    assertTrue(protectedAfter == 1, "Hit should be in protected, got length %zu", protectedAfter);
+    assertTrue(hits == 1, "Wrong countHits, expected 1 got %" PRIu64, hits);
+}
+
+/**
+ * When protected is full, a hit pushes its least recently used object back to probation
+ */
+LONGBOW_TEST_CASE(Global, metisTinyLFUContentStore_Fetch_ProtectedOverflow)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    // protected holds 80% of 2, which is 1
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(2);
+    _MetisTinyLFUContentStore *internalStore = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(store);
+
+    MetisMessage *object1 = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject,
+                                                         sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisMessage *object2 = metisMessage_CreateFromArray(metisTestDataV0_object_with_othername,
+                                                         sizeof(metisTestDataV0_object_with_othername), 2, 2, logger);
+    MetisMessage *interestByName = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName,
+                                                                sizeof(metisTestDataV0_InterestWithName), 3, 5, logger);
+    MetisMessage *interestOtherName = metisMessage_CreateFromArray(metisTestDataV0_InterestWithOtherName,
+                                                                   sizeof(metisTestDataV0_InterestWithOtherName), 4, 5, logger);
+
+    metisContentStoreInterface_PutContent(store, object1, 1);
+    metisContentStoreInterface_PutContent(store, object2, 1);
+
+    metisContentStoreInterface_MatchInterest(store, interestByName);
+    metisContentStoreInterface_MatchInterest(store, interestOtherName);
+
+    MetisLruListEntry *protectedTail = metisLruList_PeekTail(internalStore->protected);
+    MetisLruListEntry *probationTail = metisLruList_PeekTail(internalStore->probation);
+    MetisMessage *protectedObject = metisContentStoreEntry_GetMessage(metisLruList_EntryGetData(protectedTail));
+    MetisMessage *probationObject = metisContentStoreEntry_GetMessage(metisLruList_EntryGetData(probationTail));
+    size_t protectedLength = metisLruList_Length(internalStore->protected);
+    size_t probationLength = metisLruList_Length(internalStore->probation);
+
+    assertTrue(protectedLength == 1, "Wrong protected length, expected 1 got %zu", protectedLength);
+    assertTrue(probationLength == 1, "Wrong probation length, expected 1 got %zu", probationLength);
+    assertTrue(protectedObject == object2, "Most recent hit should be protected, expected %p got %p",
+               (void *) object2, (void *) protectedObject);
+    assertTrue(probationObject == object1, "Older hit should be back in probation, expected %p got %p",
+               (void *) object1, (void *) probationObject);
+
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+    metisMessage_Release(&object1);
+    metisMessage_Release(&object2);
+    metisMessage_Release(&interestByName);
+    metisMessage_Release(&interestOtherName);
+}
+
+LONGBOW_TEST_CASE(Global, metisTinyLFUContentStore_Remove_Content)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(10);
+    _MetisTinyLFUContentStore *internalStore = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(store);
+
+    MetisMessage *object = _createObject(logger, 1);
+    metisContentStoreInterface_PutContent(store, object, 1);
+    bool removed = metisContentStoreInterface_RemoveContent(store, object);
+    bool removedAgain = metisContentStoreInterface_RemoveContent(store, object);
+    size_t count = metisContentStoreInterface_GetObjectCount(store);
+    size_t probationLength = metisLruList_Length(internalStore->probation);
+
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+    metisMessage_Release(&object);
+
+    assertTrue(removed, "Expected to remove the object");
+    assertFalse(removedAgain, "Expected the object to be gone");
+    assertTrue(count == 0, "Wrong object count, expected 0 got %zu", count);
+    assertTrue(probationLength == 0, "Wrong probation length, expected 0 got %zu", probationLength);
+}
+
+LONGBOW_TEST_CASE(Global, metisTinyLFUContentStore_Save_WithoutEviction)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(10);
+    int saved = _fillTinyLFUContentStore(store, logger, 1, 10);
+
+    _MetisTinyLFUContentStore *internalStore = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(store);
+    MetisContentStoreIndexStats *stats = &internalStore->index.stats;
+
+    assertTrue(saved == 10, "A store with room should admit everything, saved %d", saved);
+    assertTrue(stats->countAdds == 10, "Wrong countAdds, expected %u got %" PRIu64, 10, stats->countAdds);
+    assertTrue(internalStore->countAdmissionRejects == 0, "Wrong countAdmissionRejects, expected %u got %" PRIu64, 0,
+               internalStore->countAdmissionRejects);
+    assertTrue(metisLruList_Length(internalStore->probation) == 10, "Wrong probation length, expected %u got %zu", 10,
+               metisLruList_Length(internalStore->probation));
+
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+}
+
+/**
+ * A full store does not take an object nobody has asked for
+ */
+LONGBOW_TEST_CASE(Global, metisTinyLFUContentStore_Save_RejectsCold)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(2);
+    _fillTinyLFUContentStore(store, logger, 1, 2);
+
+    MetisMessage *object = _createObject(logger, 3);
+    bool success = metisContentStoreInterface_PutContent(store, object, 1);
+    bool present = metisContentStoreInterface_RemoveContent(store, object);
+
+    _MetisTinyLFUContentStore *internalStore = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(store);
+    uint64_t rejects = internalStore->countAdmissionRejects;
+    uint64_t evictions = internalStore->index.stats.countLruEvictions;
+    size_t count = metisContentStoreInterface_GetObjectCount(store);
+
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+    metisMessage_Release(&object);
+
+    assertFalse(success, "A cold object should not be admitted to a full store");
+    assertFalse(present, "A rejected object should not be in the store");
+    assertTrue(rejects == 1, "Wrong countAdmissionRejects, expected 1 got %" PRIu64, rejects);
+    assertTrue(evictions == 0, "Wrong countLruEvictions, expected 0 got %" PRIu64, evictions);
+    assertTrue(count == 2, "Wrong object count, expected 2 got %zu", count);
+}
+
+/**
+ * A full store takes an object asked for more often than its victim, and evicts the victim
+ */
+LONGBOW_TEST_CASE(Global, metisTinyLFUContentStore_Save_AdmitsHot)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(2);
+    _fillTinyLFUContentStore(store, logger, 1, 2);
+
+    MetisMessage *object = _createObject(logger, 3);
+    _warmObject(store, object, 3);
+    bool success = metisContentStoreInterface_PutContent(store, object, 1);
+
+    _MetisTinyLFUContentStore *internalStore = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(store);
+    uint64_t rejects = internalStore->countAdmissionRejects;
+    uint64_t evictions = internalStore->index.stats.countLruEvictions;
+    size_t count = metisContentStoreInterface_GetObjectCount(store);
+
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+    metisMessage_Release(&object);
+
+    assertTrue(success, "A hot object should be admitted to a full store");
+    assertTrue(rejects == 0, "Wrong countAdmissionRejects, expected 0 got %" PRIu64, rejects);
+    assertTrue(evictions == 1, "Wrong countLruEvictions, expected 1 got %" PRIu64, evictions);
+    assertTrue(count == 2, "Wrong object count, expected 2 got %zu", count);
+}
+
+/**
+ * A scan of one-time objects does not flush the objects that are asked for often
+ */
+LONGBOW_TEST_CASE(Global, metisTinyLFUContentStore_Save_Scan)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    const int capacity = 4;
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(capacity);
+
+    MetisMessage *hot[capacity];
+    for (int i = 0; i < capacity; i++) {
+        hot[i] = _createObject(logger, i);
+        _warmObject(store, hot[i], 5);
+        metisContentStoreInterface_PutContent(store, hot[i], 1);
+    }
+
+    int scanSaved = _fillTinyLFUContentStore(store, logger, capacity, 20);
+
+    int hotPresent = 0;
+    for (int i = 0; i < capacity; i++) {
+        if (metisContentStoreInterface_RemoveContent(store, hot[i])) {
+            hotPresent++;
+        }
+        metisMessage_Release(&hot[i]);
+    }
+
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+
+    assertTrue(scanSaved == 0, "No scan object should be admitted, got %d", scanSaved);
+    assertTrue(hotPresent == capacity, "Every hot object should survive the scan, got %d", hotPresent);
+}
+
+LONGBOW_TEST_CASE(Global, metisTinyLFUContentStore_SetCapacity_Shrink_Trim)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(10);
+    _fillTinyLFUContentStore(store, logger, 0, 10);
+
+    bool resized = metisContentStoreInterface_SetCapacity(store, 5, 0);
+    size_t countAfterResize = metisContentStoreInterface_GetObjectCount(store);
+
+    bool trimmed = metisContentStoreInterface_Trim(store, 100, 1);
+    size_t countAfterTrim = metisContentStoreInterface_GetObjectCount(store);
+
+    _MetisTinyLFUContentStore *internalStore = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(store);
+    size_t protectedCapacity = internalStore->protectedCapacity;
+
+    metisLogger_Release(&logger);
+    metisContentStoreInterface_Release(&store);
+
+    assertTrue(resized, "TinyLFU store should resize in place");
+    assertTrue(countAfterResize == 10, "Resize should not evict, expected 10 got %zu", countAfterResize);
+    assertTrue(trimmed, "Trim should reach the capacity");
+    assertTrue(countAfterTrim == 5, "Wrong object count after trim, expected 5 got %zu", countAfterTrim);
+    assertTrue(protectedCapacity == 4, "Wrong protected capacity, expected 4 got %zu", protectedCapacity);
+}
+
+/**
+ * A smaller protected segment gives its oldest objects back to probation without waiting for a hit
+ */
+LONGBOW_TEST_CASE(Global, metisTinyLFUContentStore_SetCapacity_Shrink_Protected)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(10);
+    _MetisTinyLFUContentStore *internalStore = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(store);
+
+    MetisMessage *object1 = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject,
+                                                         sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    MetisMessage *object2 = metisMessage_CreateFromArray(metisTestDataV0_object_with_othername,
+                                                         sizeof(metisTestDataV0_object_with_othername), 2, 2, logger);
+    MetisMessage *interestByName = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName,
+                                                                sizeof(metisTestDataV0_InterestWithName), 3, 5, logger);
+    MetisMessage *interestOtherName = metisMessage_CreateFromArray(metisTestDataV0_InterestWithOtherName,
+                                                                   sizeof(metisTestDataV0_InterestWithOtherName), 4, 5, logger);
+
+    metisContentStoreInterface_PutContent(store, object1, 1);
+    metisContentStoreInterface_PutContent(store, object2, 1);
+    metisContentStoreInterface_MatchInterest(store, interestByName);
+    metisContentStoreInterface_MatchInterest(store, interestOtherName);
+    size_t protectedBefore = metisLruList_Length(internalStore->protected);
+
+    // protected holds 80% of 2, which is 1
+    metisContentStoreInterface_SetCapacity(store, 2, 0);
+
+    MetisLruListEntry *protectedTail = metisLruList_PeekTail(internalStore->protected);
+    MetisMessage *protectedObject = metisContentStoreEntry_GetMessage(metisLruList_EntryGetData(protectedTail));
+    size_t protectedAfter = metisLruList_Length(internalStore->protected);
+    size_t probationAfter = metisLruList_Length(internalStore->probation);
+
+    assertTrue(protectedBefore == 2, "Wrong protected length before resize, expected 2 got %zu", protectedBefore);
+    assertTrue(protectedAfter == 1, "Wrong protected length after resize, expected 1 got %zu", protectedAfter);
+    assertTrue(probationAfter == 1, "Wrong probation length after resize, expected 1 got %zu", probationAfter);
+    assertTrue(protectedObject == object2, "Most recent hit should stay protected, expected %p got %p",
+               (void *) object2, (void *) protectedObject);
+
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+    metisMessage_Release(&object1);
+    metisMessage_Release(&object2);
+    metisMessage_Release(&interestByName);
+    metisMessage_Release(&interestOtherName);
+}
+
+LONGBOW_TEST_CASE(Global, metisTinyLFUContentStore_AccumulateStats)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(2);
+    _fillTinyLFUContentStore(store, logger, 1, 5);
+
+    MetisMessage *interestByName = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName,
+                                                                sizeof(metisTestDataV0_InterestWithName), 3, 5, logger);
+    metisContentStoreInterface_MatchInterest(store, interestByName);
+    metisMessage_Release(&interestByName);
+
+    MetisStats stats;
+    metisStats_Init(&stats);
+    metisContentStoreInterface_AccumulateStats(store, &stats);
+
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+
+    assertTrue(stats.values[MetisStat_ContentStoreAdds] == 2, "Wrong adds, expected 2 got %" PRIu64,
+               stats.values[MetisStat_ContentStoreAdds]);
+    assertTrue(stats.values[MetisStat_ContentStoreAdmissionRejects] == 3, "Wrong admission rejects, expected 3 got %" PRIu64,
+               stats.values[MetisStat_ContentStoreAdmissionRejects]);
+    assertTrue(stats.values[MetisStat_ContentStoreMisses] == 1, "Wrong misses, expected 1 got %" PRIu64,
+               stats.values[MetisStat_ContentStoreMisses]);
+}
+
+// ============================================================================
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _metisTinyLFUContentStore_Victim);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/**
+ * The victim is the tail of probation, or of protected once probation is empty
+ */
+LONGBOW_TEST_CASE(Local, _metisTinyLFUContentStore_Victim)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisContentStoreInterface *store = _createTinyLFUContentStore(10);
+    _MetisTinyLFUContentStore *internalStore = (_MetisTinyLFUContentStore *) metisContentStoreInterface_GetPrivateData(store);
+
+    MetisMessage *object1 = _createObject(logger, 1);
+    MetisMessage *object2 = _createObject(logger, 2);
+    metisContentStoreInterface_PutContent(store, object1, 1);
+    metisContentStoreInterface_PutContent(store, object2, 1);
+
+    MetisContentStoreEntry *victimBefore = _metisTinyLFUContentStore_Victim(internalStore);
+    MetisMessage *victimBeforeObject = metisContentStoreEntry_GetMessage(victimBefore);
+
+    // move both to protected, object2 last
+    _metisTinyLFUContentStore_Touch(internalStore, victimBefore);
+    _metisTinyLFUContentStore_Touch(internalStore, _metisTinyLFUContentStore_Victim(internalStore));
+    MetisMessage *victimAfterObject = metisContentStoreEntry_GetMessage(_metisTinyLFUContentStore_Victim(internalStore));
+
+    assertTrue(victimBeforeObject == object1, "Oldest probation object should be the victim, expected %p got %p",
+               (void *) object1, (void *) victimBeforeObject);
+    assertTrue(victimAfterObject == object1, "Oldest protected object should be the victim, expected %p got %p",
+               (void *) object1, (void *) victimAfterObject);
+
+    metisContentStoreInterface_Release(&store);
+    metisLogger_Release(&logger);
+    metisMessage_Release(&object1);
+    metisMessage_Release(&object2);
+}
+
+// ============================================================================
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_TinyLFUContentStore);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
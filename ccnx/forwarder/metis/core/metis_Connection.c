@@ -64,6 +64,7 @@
 #include <ccnx/forwarder/metis/io/metis_IoOperations.h>
 #include <ccnx/forwarder/metis/core/metis_Connection.h>
 #include <ccnx/forwarder/metis/io/metis_AddressPair.h>
+#include <ccnx/forwarder/metis/core/metis_Latency.h>
 #include <parc/algol/parc_Memory.h>
 
 #include <LongBow/runtime.h>
@@ -119,7 +120,10 @@ metisConnection_Send(const MetisConnection *conn, MetisMessage *message)
     assertNotNull(message, "Parameter message must be non-null");
 
     if (metisIoOperations_IsUp(conn->ops)) {
-        return metisIoOperations_Send(conn->ops, NULL, message);
+        uint64_t latencyStart = metisLatency_Start();
+        bool success = metisIoOperations_Send(conn->ops, NULL, message);
+        metisLatency_Stop(MetisLatencyStage_Send, latencyStart);
+        return success;
     }
     return false;
 }
@@ -109,12 +109,14 @@
 #include <ccnx/forwarder/metis/core/metis_ConnectionManager.h>
 #include <ccnx/forwarder/metis/core/metis_ConnectionTable.h>
 #include <ccnx/forwarder/metis/core/metis_Dispatcher.h>
+#include <ccnx/forwarder/metis/core/metis_Latency.h>
 #include <ccnx/forwarder/metis/config/metis_Configuration.h>
 #include <ccnx/forwarder/metis/config/metis_ConfigurationFile.h>
 #include <ccnx/forwarder/metis/config/metis_ConfigurationListeners.h>
 #include <ccnx/forwarder/metis/config/metis_CommandLineInterface.h>
 #include <ccnx/forwarder/metis/config/metis_WebInterface.h>
 #include <ccnx/forwarder/metis/processor/metis_MessageProcessor.h>
+#include <ccnx/forwarder/metis/processor/metis_ShardedProcessor.h>
 
 #include <LongBow/runtime.h>
 
@@ -128,6 +130,20 @@
 #define MSEC_TO_TICKS(msec) ((msec < FC_MSEC_PER_TICK) ? 1 : msec / FC_MSEC_PER_TICK)
 #define NSEC_TO_TICKS(nsec) ((nsec < METIS_NSEC_PER_TICK) ? 1 : nsec / METIS_NSEC_PER_TICK)
 
+// how often the cached wall clock to monotonic offset is re-read, in ticks
+#define METIS_WALLCLOCK_OFFSET_REFRESH_TICKS (METISHZ)
+
+// The tick cache opened by metisForwarder_BeginTickCache().  It is per-thread, so the
+// dispatcher, the shard workers, and the UDP ingress threads each keep their own.
+static __thread const MetisForwarder *_tickCacheOwner = NULL;
+static __thread MetisTicks _tickCacheValue = 0;
+static __thread unsigned _tickCacheDepth = 0;
+
+// Wall clock minus monotonic clock, in msec, for metisForwarder_WallclockToTicks().
+// Shared by all threads.  The refresh time is 0 until it has been read once.
+static int64_t _wallclockOffset = 0;
+static MetisTicks _wallclockOffsetRefreshTime = 0;
+
 
 struct metis_forwarder {
     MetisDispatcher *dispatcher;
@@ -136,6 +152,7 @@ struct metis_forwarder {
 
     PARCEventSignal *signal_int;
     PARCEventSignal *signal_term;
+    PARCEventSignal *signal_pipe;
     PARCEventSignal *signal_usr1;
     PARCEventTimer *keepalive_event;
 
@@ -150,8 +167,14 @@ struct metis_forwarder {
     MetisListenerSet *listenerSet;
     MetisConfiguration *config;
 
-    // we'll eventually want to setup a threadpool of these
+    // With one worker, messages are processed inline on the dispatcher thread by `processor`.
+    // With more, `sharded` runs a processor per worker thread and `processor` is NULL.
     MetisMessageProcessor *processor;
+    MetisShardedProcessor *sharded;
+
+    // remembered so a new set of shards gets the same FIB type and content store policy
+    MetisFIBType fibType;
+    MetisContentStoreType contentStoreType;
 
     MetisLogger *logger;
 
@@ -230,6 +253,8 @@ metisForwarder_Create(MetisLogger *logger)
     metis->listenerSet = metisListenerSet_Create();
     metis->config = metisConfiguration_Create(metis);
     metis->processor = metisMessageProcessor_Create(metis);
+    metis->fibType = MetisFIBType_Hash;
+    metis->contentStoreType = MetisContentStoreType_LRU;
 
     metis->signal_term = metisDispatcher_CreateSignalEvent(metis->dispatcher, _signal_cb, metis, SIGTERM);
     metisDispatcher_StartSignalEvent(metis->dispatcher, metis->signal_term);
@@ -237,7 +262,10 @@ metisForwarder_Create(MetisLogger *logger)
     metis->signal_int = metisDispatcher_CreateSignalEvent(metis->dispatcher, _signal_cb, metis, SIGINT);
     metisDispatcher_StartSignalEvent(metis->dispatcher, metis->signal_int);
 
-    metis->signal_usr1 = metisDispatcher_CreateSignalEvent(metis->dispatcher, _signal_cb, metis, SIGPIPE);
+    metis->signal_pipe = metisDispatcher_CreateSignalEvent(metis->dispatcher, _signal_cb, metis, SIGPIPE);
+    metisDispatcher_StartSignalEvent(metis->dispatcher, metis->signal_pipe);
+
+    metis->signal_usr1 = metisDispatcher_CreateSignalEvent(metis->dispatcher, _signal_cb, metis, SIGUSR1);
     metisDispatcher_StartSignalEvent(metis->dispatcher, metis->signal_usr1);
 
     /* ignore child */
@@ -276,7 +304,11 @@ metisForwarder_Destroy(MetisForwarder **metisPtr)
     metisListenerSet_Destroy(&(metis->listenerSet));
     metisConnectionManager_Destroy(&(metis->connectionManager));
     metisConnectionTable_Destroy(&(metis->connectionTable));
-    metisMessageProcessor_Destroy(&(metis->processor));
+    if (metis->sharded != NULL) {
+        metisShardedProcessor_Destroy(&(metis->sharded));
+    } else {
+        metisMessageProcessor_Destroy(&(metis->processor));
+    }
     metisConfiguration_Destroy(&(metis->config));
 
     // the messenger is used by many of the other pieces, so destroy it last
@@ -284,6 +316,7 @@ metisForwarder_Destroy(MetisForwarder **metisPtr)
 
     metisDispatcher_DestroySignalEvent(metis->dispatcher, &(metis->signal_int));
     metisDispatcher_DestroySignalEvent(metis->dispatcher, &(metis->signal_term));
+    metisDispatcher_DestroySignalEvent(metis->dispatcher, &(metis->signal_pipe));
     metisDispatcher_DestroySignalEvent(metis->dispatcher, &(metis->signal_usr1));
 
     parcClock_Release(&metis->clock);
@@ -327,7 +360,8 @@ unsigned
 metisForwarder_GetNextConnectionId(MetisForwarder *metis)
 {
     assertNotNull(metis, "Parameter must be non-null");
-    return metis->nextConnectionid++;
+    // atomic so an id is never handed out twice, whichever thread creates the connection
+    return __atomic_fetch_add(&metis->nextConnectionid, 1, __ATOMIC_RELAXED);
 }
 
 MetisMessenger *
@@ -364,21 +398,115 @@ metisForwarder_Receive(MetisForwarder *metis, MetisMessage *message)
     assertNotNull(metis, "Parameter metis must be non-null");
     assertNotNull(message, "Parameter message must be non-null");
 
+    metisForwarder_BeginTickCache(metis);
+
     // this takes ownership of the message, so we're done here
     if (metisMessage_GetType(message) == MetisMessagePacketType_Control) {
         metisConfiguration_Receive(metis->config, message);
+    } else if (metis->sharded != NULL) {
+        metisShardedProcessor_Receive(metis->sharded, message);
     } else {
         metisMessageProcessor_Receive(metis->processor, message);
     }
+
+    metisForwarder_EndTickCache(metis);
+}
+
+void
+metisForwarder_ReceiveBatch(MetisForwarder *metis, size_t count, MetisMessage *messages[])
+{
+    assertNotNull(metis, "Parameter metis must be non-null");
+    assertTrue(count == 0 || messages != NULL, "Parameter messages must be non-null");
+
+    // the whole batch sees the same time
+    metisForwarder_BeginTickCache(metis);
+
+    // pull out the control messages and pack the rest to the front of the array
+    size_t packets = 0;
+    for (size_t i = 0; i < count; i++) {
+        assertNotNull(messages[i], "Parameter messages[%zu] must be non-null", i);
+        if (metisMessage_GetType(messages[i]) == MetisMessagePacketType_Control) {
+            metisConfiguration_Receive(metis->config, messages[i]);
+        } else {
+            messages[packets++] = messages[i];
+        }
+    }
+
+    if (metis->sharded != NULL) {
+        for (size_t i = 0; i < packets; i++) {
+            metisShardedProcessor_Receive(metis->sharded, messages[i]);
+        }
+    } else if (packets > 0) {
+        metisMessageProcessor_ReceiveBatch(metis->processor, packets, messages);
+    }
+
+    metisForwarder_EndTickCache(metis);
+}
+
+static void
+_metisForwarder_RefreshWallclockOffset(uint64_t monotonicTime)
+{
+    PARCClock *wallclock = parcClock_Wallclock();
+    uint64_t wallclockTime = parcClock_GetTime(wallclock);
+    parcClock_Release(&wallclock);
+
+    __atomic_store_n(&_wallclockOffset, (int64_t) (wallclockTime - monotonicTime), __ATOMIC_RELAXED);
+    __atomic_store_n(&_wallclockOffsetRefreshTime, monotonicTime + METIS_WALLCLOCK_OFFSET_REFRESH_TICKS, __ATOMIC_RELEASE);
 }
 
 MetisTicks
 metisForwarder_GetTicks(const MetisForwarder *metis)
 {
     assertNotNull(metis, "Parameter must be non-null");
+
+    if (_tickCacheDepth > 0 && _tickCacheOwner == metis) {
+        return _tickCacheValue + metis->clockOffset;
+    }
     return parcClock_GetTime(metis->clock) + metis->clockOffset;
 }
 
+MetisTicks
+metisForwarder_BeginTickCache(const MetisForwarder *metis)
+{
+    assertNotNull(metis, "Parameter must be non-null");
+
+    if (_tickCacheDepth++ == 0) {
+        _tickCacheOwner = metis;
+        _tickCacheValue = parcClock_GetTime(metis->clock);
+
+        // piggy back the wall clock offset on the monotonic read we just did
+        if (_tickCacheValue >= __atomic_load_n(&_wallclockOffsetRefreshTime, __ATOMIC_ACQUIRE)) {
+            _metisForwarder_RefreshWallclockOffset(_tickCacheValue);
+        }
+    }
+
+    return metisForwarder_GetTicks(metis);
+}
+
+void
+metisForwarder_EndTickCache(const MetisForwarder *metis)
+{
+    assertNotNull(metis, "Parameter must be non-null");
+    assertTrue(_tickCacheDepth > 0, "metisForwarder_EndTickCache called without metisForwarder_BeginTickCache");
+
+    if (--_tickCacheDepth == 0) {
+        _tickCacheOwner = NULL;
+    }
+}
+
+MetisTicks
+metisForwarder_WallclockToTicks(uint64_t wallclockTime)
+{
+    if (__atomic_load_n(&_wallclockOffsetRefreshTime, __ATOMIC_ACQUIRE) == 0) {
+        // nothing has opened a tick cache yet, so read the clocks directly
+        PARCClock *monotonic = parcClock_Monotonic();
+        _metisForwarder_RefreshWallclockOffset(parcClock_GetTime(monotonic));
+        parcClock_Release(&monotonic);
+    }
+
+    return wallclockTime - (uint64_t) __atomic_load_n(&_wallclockOffset, __ATOMIC_RELAXED);
+}
+
 MetisTicks
 metisForwarder_NanosToTicks(uint64_t nanos)
 {
@@ -397,7 +525,9 @@ metisForwarder_AddOrUpdateRoute(MetisForwarder *metis, CPIRouteEntry *route)
     assertNotNull(metis, "Parameter metis must be non-null");
     assertNotNull(route, "Parameter route must be non-null");
 
-    // we only have one message processor
+    if (metis->sharded != NULL) {
+        return metisShardedProcessor_AddOrUpdateRoute(metis->sharded, route);
+    }
     return metisMessageProcessor_AddOrUpdateRoute(metis->processor, route);
 }
 
@@ -407,7 +537,9 @@ metisForwarder_RemoveRoute(MetisForwarder *metis, CPIRouteEntry *route)
     assertNotNull(metis, "Parameter metis must be non-null");
     assertNotNull(route, "Parameter route must be non-null");
 
-    // we only have one message processor
+    if (metis->sharded != NULL) {
+        return metisShardedProcessor_RemoveRoute(metis->sharded, route);
+    }
     return metisMessageProcessor_RemoveRoute(metis->processor, route);
 }
 
@@ -415,31 +547,153 @@ void
 metisForwarder_RemoveConnectionIdFromRoutes(MetisForwarder *metis, unsigned connectionId)
 {
     assertNotNull(metis, "Parameter metis must be non-null");
-    metisMessageProcessor_RemoveConnectionIdFromRoutes(metis->processor, connectionId);
+    if (metis->sharded != NULL) {
+        metisShardedProcessor_RemoveConnectionIdFromRoutes(metis->sharded, connectionId);
+    } else {
+        metisMessageProcessor_RemoveConnectionIdFromRoutes(metis->processor, connectionId);
+    }
 }
 
 void
 metisForwarder_AddTap(MetisForwarder *metis, MetisTap *tap)
 {
-    metisMessageProcessor_AddTap(metis->processor, tap);
+    if (metis->sharded != NULL) {
+        metisShardedProcessor_AddTap(metis->sharded, tap);
+    } else {
+        metisMessageProcessor_AddTap(metis->processor, tap);
+    }
 }
 
 void
 metisForwarder_RemoveTap(MetisForwarder *metis, MetisTap *tap)
 {
-    metisMessageProcessor_RemoveTap(metis->processor, tap);
+    if (metis->sharded != NULL) {
+        metisShardedProcessor_RemoveTap(metis->sharded, tap);
+    } else {
+        metisMessageProcessor_RemoveTap(metis->processor, tap);
+    }
 }
 
 MetisFibEntryList *
 metisForwarder_GetFibEntries(MetisForwarder *metis)
 {
+    if (metis->sharded != NULL) {
+        return metisShardedProcessor_GetFibEntries(metis->sharded);
+    }
     return metisMessageProcessor_GetFibEntries(metis->processor);
 }
 
+void
+metisForwarder_GetStats(MetisForwarder *metis, MetisStats *stats)
+{
+    assertNotNull(metis, "Parameter metis must be non-null");
+    assertNotNull(stats, "Parameter stats must be non-null");
+
+    metisStats_Init(stats);
+
+    if (metis->sharded != NULL) {
+        metisShardedProcessor_AccumulateStats(metis->sharded, stats);
+    } else {
+        metisMessageProcessor_AccumulateStats(metis->processor, stats);
+    }
+
+    for (size_t i = 0; i < metisListenerSet_Length(metis->listenerSet); i++) {
+        MetisListenerOps *ops = metisListenerSet_Get(metis->listenerSet, i);
+        if (ops->accumulateStats != NULL) {
+            ops->accumulateStats(ops, stats);
+        }
+    }
+}
+
 void
 metisForwarder_SetContentObjectStoreSize(MetisForwarder *metis, size_t maximumContentStoreSize)
 {
-    metisMessageProcessor_SetContentObjectStoreSize(metis->processor, maximumContentStoreSize);
+    if (metis->sharded != NULL) {
+        metisShardedProcessor_SetContentObjectStoreSize(metis->sharded, maximumContentStoreSize);
+    } else {
+        metisMessageProcessor_SetContentObjectStoreSize(metis->processor, maximumContentStoreSize);
+    }
+}
+
+void
+metisForwarder_SetContentObjectStoreBytes(MetisForwarder *metis, size_t maximumContentStoreBytes)
+{
+    if (metis->sharded != NULL) {
+        metisShardedProcessor_SetContentObjectStoreBytes(metis->sharded, maximumContentStoreBytes);
+    } else {
+        metisMessageProcessor_SetContentObjectStoreBytes(metis->processor, maximumContentStoreBytes);
+    }
+}
+
+void
+metisForwarder_SetContentObjectStoreDisk(MetisForwarder *metis, const char *directory, size_t maximumDiskBytes)
+{
+    if (metis->sharded != NULL) {
+        metisShardedProcessor_SetContentObjectStoreDisk(metis->sharded, directory, maximumDiskBytes);
+    } else {
+        metisMessageProcessor_SetContentObjectStoreDisk(metis->processor, directory, maximumDiskBytes);
+    }
+}
+
+void
+metisForwarder_SetFIBType(MetisForwarder *metis, MetisFIBType fibType)
+{
+    metis->fibType = fibType;
+    if (metis->sharded != NULL) {
+        metisShardedProcessor_SetFIBType(metis->sharded, fibType);
+    } else {
+        metisMessageProcessor_SetFIBType(metis->processor, fibType);
+    }
+}
+
+void
+metisForwarder_SetContentStoreType(MetisForwarder *metis, MetisContentStoreType contentStoreType)
+{
+    metis->contentStoreType = contentStoreType;
+    if (metis->sharded != NULL) {
+        metisShardedProcessor_SetContentStoreType(metis->sharded, contentStoreType);
+    } else {
+        metisMessageProcessor_SetContentStoreType(metis->processor, contentStoreType);
+    }
+}
+
+void
+metisForwarder_SetWorkerCount(MetisForwarder *metis, unsigned workerCount)
+{
+    assertNotNull(metis, "Parameter metis must be non-null");
+    assertTrue(workerCount > 0, "Parameter workerCount must be positive");
+
+    MetisFibEntryList *fibEntries = metisForwarder_GetFibEntries(metis);
+    size_t routeCount = metisFibEntryList_Length(fibEntries);
+    metisFibEntryList_Destroy(&fibEntries);
+    assertTrue(routeCount == 0, "Cannot change the worker count after routes are added");
+
+    if (metis->sharded != NULL) {
+        metisShardedProcessor_Destroy(&metis->sharded);
+    } else {
+        metisMessageProcessor_Destroy(&metis->processor);
+    }
+
+    // the new processors read the content store sizes from the configuration
+    if (workerCount == 1) {
+        metis->processor = metisMessageProcessor_Create(metis);
+        metisMessageProcessor_SetFIBType(metis->processor, metis->fibType);
+        metisMessageProcessor_SetContentStoreType(metis->processor, metis->contentStoreType);
+    } else {
+        metis->sharded = metisShardedProcessor_Create(metis, workerCount);
+        metisShardedProcessor_SetFIBType(metis->sharded, metis->fibType);
+        metisShardedProcessor_SetContentStoreType(metis->sharded, metis->contentStoreType);
+    }
+}
+
+unsigned
+metisForwarder_GetWorkerCount(const MetisForwarder *metis)
+{
+    assertNotNull(metis, "Parameter metis must be non-null");
+    if (metis->sharded != NULL) {
+        return metisShardedProcessor_ShardCount(metis->sharded);
+    }
+    return 1;
 }
 
 PARCClock *
@@ -450,6 +704,47 @@ metisForwarder_GetClock(const MetisForwarder *metis)
 
 // =======================================================
 
+/**
+ * Logs the counters and the latency histograms, for SIGUSR1
+ */
+static void
+_logStats(MetisForwarder *metis)
+{
+    MetisStats stats;
+    metisForwarder_GetStats(metis, &stats);
+    for (MetisStat stat = 0; stat < MetisStat_END; stat++) {
+        metisLogger_Log(metis->logger, MetisLoggerFacility_Core, PARCLogLevel_Warning, __func__,
+                        "%s %" PRIu64, metisStats_Name(stat), stats.values[stat]);
+    }
+    metisLogger_Log(metis->logger, MetisLoggerFacility_Core, PARCLogLevel_Warning, __func__,
+                    "contentStore.hitRatio %.4f", metisStats_ContentStoreHitRatio(&stats));
+
+    size_t length = sizeof(MetisLatencyHistogram) * MetisLatencyStage_END;
+    MetisLatencyHistogram *histograms = parcMemory_Allocate(length);
+    assertNotNull(histograms, "parcMemory_Allocate(%zu) returned NULL", length);
+    metisLatency_Snapshot(histograms);
+
+    metisLogger_Log(metis->logger, MetisLoggerFacility_Core, PARCLogLevel_Warning, __func__,
+                    "latency sample interval %u", metisLatency_GetSampleInterval());
+    for (MetisLatencyStage stage = 0; stage < MetisLatencyStage_END; stage++) {
+        const MetisLatencyHistogram *histogram = &histograms[stage];
+        uint64_t meanTicks = histogram->count > 0 ? histogram->sumTicks / histogram->count : 0;
+        metisLogger_Log(metis->logger, MetisLoggerFacility_Core, PARCLogLevel_Warning, __func__,
+                        "latency %s count %" PRIu64 " mean %" PRIu64 " p50 %" PRIu64 " p90 %" PRIu64
+                        " p99 %" PRIu64 " p99.9 %" PRIu64 " max %" PRIu64 " ns",
+                        metisLatency_StageName(stage),
+                        histogram->count,
+                        metisLatency_TicksToNanos(meanTicks),
+                        metisLatency_TicksToNanos(metisLatencyHistogram_Percentile(histogram, 50.0)),
+                        metisLatency_TicksToNanos(metisLatencyHistogram_Percentile(histogram, 90.0)),
+                        metisLatency_TicksToNanos(metisLatencyHistogram_Percentile(histogram, 99.0)),
+                        metisLatency_TicksToNanos(metisLatencyHistogram_Percentile(histogram, 99.9)),
+                        metisLatency_TicksToNanos(histogram->maxTicks));
+    }
+
+    parcMemory_Deallocate((void **) &histograms);
+}
+
 static void
 _signal_cb(int sig, PARCEventType events, void *user_data)
 {
@@ -472,7 +767,7 @@ _signal_cb(int sig, PARCEventType events, void *user_data)
             break;
 
         case SIGUSR1:
-            // dump stats
+            _logStats(metis);
             break;
 
         default:
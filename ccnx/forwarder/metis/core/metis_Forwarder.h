@@ -76,9 +76,12 @@
 #include <ccnx/forwarder/metis/core/metis_Message.h>
 #include <ccnx/forwarder/metis/core/metis_Ticks.h>
 #include <ccnx/forwarder/metis/core/metis_Logger.h>
+#include <ccnx/forwarder/metis/core/metis_Stats.h>
 #include <ccnx/forwarder/metis/io/metis_ListenerSet.h>
 
 #include <ccnx/forwarder/metis/processor/metis_FibEntryList.h>
+#include <ccnx/forwarder/metis/processor/metis_FIB.h>
+#include <ccnx/forwarder/metis/content_store/metis_ContentStoreInterface.h>
 
 #include <parc/algol/parc_Clock.h>
 
@@ -177,7 +180,7 @@ void metisForwarder_SetLogLevel(MetisForwarder *metis, PARCLogLevel level);
  * @function metisForwarder_GetNextConnectionId
  * @abstract Get the next identifier for a new connection
  * @discussion
- *   <#Discussion#>
+ *   Safe to call from any thread, each call returns a different id.
  *
  * @param <#param1#>
  * @return <#return#>
@@ -246,6 +249,9 @@ PARCClock *metisForwarder_GetClock(const MetisForwarder *metis);
  *
  * Runs at approximately 1 msec per tick (see METISHZ in metis_Forwarder.c)
  *
+ * If the calling thread has a tick cache open on this forwarder (see metisForwarder_BeginTickCache()),
+ * returns the cached time and does not read the clock.
+ *
  * @param [in] metis An allocated Metis forwarder
  *
  * @retval <#value#> <#explanation#>
@@ -257,6 +263,64 @@ PARCClock *metisForwarder_GetClock(const MetisForwarder *metis);
  */
 MetisTicks metisForwarder_GetTicks(const MetisForwarder *metis);
 
+/**
+ * Read the clock once and have metisForwarder_GetTicks() return that time on this thread
+ *
+ * An event callback or a batch of packets opens a tick cache so all the work it does sees
+ * one time and only reads the clock once.  Calls nest, only the outermost one reads the clock.
+ * Each call must be matched by metisForwarder_EndTickCache() on the same thread.
+ *
+ * This also refreshes, about once a second, the offset used by metisForwarder_WallclockToTicks().
+ *
+ * @param [in] metis An allocated Metis forwarder
+ *
+ * @return The current ticks, as from metisForwarder_GetTicks()
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisTicks now = metisForwarder_BeginTickCache(metis);
+ *     // ... process a batch of packets
+ *     metisForwarder_EndTickCache(metis);
+ * }
+ * @endcode
+ */
+MetisTicks metisForwarder_BeginTickCache(const MetisForwarder *metis);
+
+/**
+ * Close a tick cache opened by metisForwarder_BeginTickCache()
+ *
+ * When the outermost cache is closed, metisForwarder_GetTicks() reads the clock again.
+ *
+ * @param [in] metis The forwarder passed to metisForwarder_BeginTickCache()
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+void metisForwarder_EndTickCache(const MetisForwarder *metis);
+
+/**
+ * Convert a wall clock time (msec since the UTC epoch) to monotonic ticks
+ *
+ * Used for the ExpiryTime and RecommendedCacheTime of content objects.  The offset between
+ * the two clocks is cached and refreshed by metisForwarder_BeginTickCache(), so this
+ * does not read either clock.  It does not include any test clock offset of a forwarder.
+ *
+ * @param [in] wallclockTime A wall clock time in msec
+ *
+ * @return The same time on the monotonic tick clock
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisTicks expiryTicks = metisForwarder_WallclockToTicks(expiryTimeUTC);
+ * }
+ * @endcode
+ */
+MetisTicks metisForwarder_WallclockToTicks(uint64_t wallclockTime);
+
 /**
  * Convert nano seconds to Ticks
  *
@@ -278,6 +342,28 @@ uint64_t metisForwarder_TicksToNanos(MetisTicks ticks);
 
 void metisForwarder_Receive(MetisForwarder *metis, MetisMessage *mesage);
 
+/**
+ * Receive several messages at once, takes ownership of each of them
+ *
+ * Control messages go to the configuration one at a time.  The rest go to the message
+ * processor as one batch (see metisMessageProcessor_ReceiveBatch()), or one at a time to the
+ * sharded processor if it is running.  Order is preserved within each kind.
+ *
+ * @param [in] metis An allocated forwarder
+ * @param [in] count The number of messages
+ * @param [in] messages The messages, the array contents are undefined afterwards
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisMessage *messages[count];
+ *     // ... read and parse the packets
+ *     metisForwarder_ReceiveBatch(metis, count, messages);
+ * }
+ * @endcode
+ */
+void metisForwarder_ReceiveBatch(MetisForwarder *metis, size_t count, MetisMessage *messages[]);
+
 /**
  * @function metisForwarder_AddOrUpdateRoute
  * @abstract Adds or updates a route on all the message processors
@@ -329,6 +415,27 @@ MetisConfiguration *metisForwarder_GetConfiguration(MetisForwarder *metis);
 
 MetisFibEntryList *metisForwarder_GetFibEntries(MetisForwarder *metis);
 
+/**
+ * Sums the forwarder's counters in to one snapshot
+ *
+ * The processor (or each of its shards), the content stores and each listener keep their own
+ * counters.  This adds them all up, so it is meant for occasional reads, such as the METIS_STATS
+ * control command, not for the packet path.  Call it on the dispatcher thread.
+ *
+ * @param [in] metis An allocated MetisForwarder
+ * @param [out] stats The snapshot, overwritten
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisStats stats;
+ *     metisForwarder_GetStats(metis, &stats);
+ *     printf("interests %" PRIu64 "\n", stats.values[MetisStat_InterestsReceived]);
+ * }
+ * @endcode
+ */
+void metisForwarder_GetStats(MetisForwarder *metis, MetisStats *stats);
+
 /**
  * Sets the maximum number of content objects in the content store
  *
@@ -343,6 +450,118 @@ MetisFibEntryList *metisForwarder_GetFibEntries(MetisForwarder *metis);
  */
 void metisForwarder_SetContentObjectStoreSize(MetisForwarder *metis, size_t maximumContentStoreSize);
 
+/**
+ * Sets the maximum number of bytes of content objects in the ContentStore
+ *
+ * Implementation dependent - may wipe the cache.  The byte limit applies in addition to
+ * the object count limit.  0 means no byte limit.
+ *
+ * @param [in] metis An allocated MetisForwarder
+ * @param [in] maximumContentStoreBytes The most bytes to cache, or 0
+ *
+ * Example:
+ * @code
+ * {
+ *     metisForwarder_SetContentObjectStoreBytes(metis, 512 * 1024 * 1024);
+ * }
+ * @endcode
+ */
+void metisForwarder_SetContentObjectStoreBytes(MetisForwarder *metis, size_t maximumContentStoreBytes);
+
+/**
+ * Puts a persistent disk content store behind the ContentStore
+ *
+ * Implementation dependent - may wipe the in-memory cache (its objects are demoted to disk first).
+ *
+ * @param [in] metis An allocated MetisForwarder
+ * @param [in] directory The segment directory, or NULL for no disk store
+ * @param [in] maximumDiskBytes The disk budget, or 0 for the default
+ *
+ * Example:
+ * @code
+ * {
+ *     metisForwarder_SetContentObjectStoreDisk(metis, "/var/cache/metis", 0);
+ * }
+ * @endcode
+ */
+void metisForwarder_SetContentObjectStoreDisk(MetisForwarder *metis, const char *directory, size_t maximumDiskBytes);
+
+/**
+ * Selects the FIB implementation
+ *
+ * Must be called before any routes are added, as it replaces the FIB with an empty one.
+ *
+ * @param [in] metis An allocated MetisForwarder
+ * @param [in] fibType The FIB implementation to use
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisForwarder *metis = metisForwarder_Create(NULL);
+ *     metisForwarder_SetFIBType(metis, MetisFIBType_Trie);
+ * }
+ * @endcode
+ */
+void metisForwarder_SetFIBType(MetisForwarder *metis, MetisFIBType fibType);
+
+/**
+ * Selects the in-memory content store policy
+ *
+ * The store is replaced with an empty one of the new policy, so call it at startup.  The
+ * choice is kept when metisForwarder_SetWorkerCount() re-creates the processors.
+ *
+ * @param [in] metis An allocated MetisForwarder
+ * @param [in] contentStoreType The content store policy to use
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisForwarder *metis = metisForwarder_Create(NULL);
+ *     metisForwarder_SetContentStoreType(metis, MetisContentStoreType_TinyLFU);
+ * }
+ * @endcode
+ */
+void metisForwarder_SetContentStoreType(MetisForwarder *metis, MetisContentStoreType contentStoreType);
+
+/**
+ * Sets the number of threads that process Interests and ContentObjects
+ *
+ * With 1 (the default), messages are processed on the dispatcher thread as they are read.  With more,
+ * each worker thread owns a shard of the PIT and ContentStore (and a copy of the FIB), and the
+ * dispatcher thread steers each message to a shard by its name hash.  The content store limits are
+ * divided evenly among the shards.
+ *
+ * Must be called before any routes are added.  Any cached content and taps are dropped.
+ *
+ * @param [in] metis An allocated MetisForwarder
+ * @param [in] workerCount The number of processor threads, at least 1
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisForwarder *metis = metisForwarder_Create(NULL);
+ *     metisForwarder_SetWorkerCount(metis, 4);
+ * }
+ * @endcode
+ */
+void metisForwarder_SetWorkerCount(MetisForwarder *metis, unsigned workerCount);
+
+/**
+ * The number of processor threads
+ *
+ * @param [in] metis An allocated MetisForwarder
+ *
+ * @return The worker count, 1 if messages are processed on the dispatcher thread
+ *
+ * Example:
+ * @code
+ * {
+ *     unsigned workers = metisForwarder_GetWorkerCount(metis);
+ * }
+ * @endcode
+ */
+unsigned metisForwarder_GetWorkerCount(const MetisForwarder *metis);
+
 // ========================
 // Functions to manipulate the event dispatcher
 
@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * Each thread that samples has a _MetisLatencyRecorder, created on its first sample and registered
+ * with a pthread key.  When the thread exits, its histograms are added to _retired.  The recorders of
+ * live threads are on a list so metisLatency_Snapshot() can read them.
+ *
+ * The owning thread writes its histograms with the metisStats_Add() relaxed stores, so a reader on
+ * another thread sees whole values.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define METIS_LATENCY_USE_TSC 1
+#endif
+
+#include <ccnx/forwarder/metis/core/metis_Latency.h>
+#include <ccnx/forwarder/metis/core/metis_Stats.h>
+#include <ccnx/api/control/controlPlaneInterface.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <LongBow/runtime.h>
+
+typedef struct metis_latency_recorder {
+    MetisLatencyHistogram histograms[MetisLatencyStage_END];
+    struct metis_latency_recorder *previous;
+    struct metis_latency_recorder *next;
+} _MetisLatencyRecorder;
+
+static const char *_metisLatencyStageNames[MetisLatencyStage_END] = {
+    [MetisLatencyStage_Parse]        = "parse",
+    [MetisLatencyStage_Pit]          = "pit",
+    [MetisLatencyStage_ContentStore] = "contentStore",
+    [MetisLatencyStage_Fib]          = "fib",
+    [MetisLatencyStage_Send]         = "send",
+};
+
+unsigned metisLatency_SampleInterval = 0;
+
+static pthread_once_t _calibrateOnce = PTHREAD_ONCE_INIT;
+static double _nanosPerTick = 1.0;
+
+static pthread_once_t _keyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t _recorderKey;
+static __thread _MetisLatencyRecorder *_threadRecorder = NULL;
+static __thread unsigned _threadCountdown = 0;
+
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+static _MetisLatencyRecorder *_recorders = NULL;
+static MetisLatencyHistogram _retired[MetisLatencyStage_END];
+
+static uint64_t
+_monotonicNanos(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static uint64_t
+_now(void)
+{
+#ifdef METIS_LATENCY_USE_TSC
+    return __rdtsc();
+#else
+    return _monotonicNanos();
+#endif
+}
+
+/**
+ * Measures the time stamp counter against the monotonic clock
+ */
+static void
+_calibrate(void)
+{
+#ifdef METIS_LATENCY_USE_TSC
+    uint64_t startNanos = _monotonicNanos();
+    uint64_t startTicks = _now();
+
+    struct timespec pause = { .tv_sec = 0, .tv_nsec = 10000000 };
+    nanosleep(&pause, NULL);
+
+    uint64_t nanos = _monotonicNanos() - startNanos;
+    uint64_t ticks = _now() - startTicks;
+    if (ticks > 0) {
+        _nanosPerTick = (double) nanos / (double) ticks;
+    }
+#endif
+}
+
+static void
+_addHistogram(MetisLatencyHistogram *total, const MetisLatencyHistogram *histogram)
+{
+    total->count += metisStats_Read(histogram->count);
+    total->sumTicks += metisStats_Read(histogram->sumTicks);
+
+    uint64_t maxTicks = metisStats_Read(histogram->maxTicks);
+    if (maxTicks > total->maxTicks) {
+        total->maxTicks = maxTicks;
+    }
+
+    for (unsigned i = 0; i < METIS_LATENCY_BUCKETS; i++) {
+        total->buckets[i] += metisStats_Read(histogram->buckets[i]);
+    }
+}
+
+/**
+ * Adds a recorder to _retired and frees it.  Call with _lock held.
+ */
+static void
+_retireRecorder(_MetisLatencyRecorder *recorder)
+{
+    for (MetisLatencyStage stage = 0; stage < MetisLatencyStage_END; stage++) {
+        _addHistogram(&_retired[stage], &recorder->histograms[stage]);
+    }
+
+    if (recorder->previous != NULL) {
+        recorder->previous->next = recorder->next;
+    } else {
+        _recorders = recorder->next;
+    }
+    if (recorder->next != NULL) {
+        recorder->next->previous = recorder->previous;
+    }
+
+    parcMemory_Deallocate((void **) &recorder);
+}
+
+/**
+ * pthread key destructor, runs when a thread with a recorder exits
+ */
+static void
+_threadExit(void *recorderVoid)
+{
+    pthread_mutex_lock(&_lock);
+    _retireRecorder((_MetisLatencyRecorder *) recorderVoid);
+    pthread_mutex_unlock(&_lock);
+}
+
+static void
+_createKey(void)
+{
+    int failure = pthread_key_create(&_recorderKey, _threadExit);
+    assertFalse(failure, "pthread_key_create failed: (%d) %s", failure, strerror(failure));
+}
+
+static _MetisLatencyRecorder *
+_getRecorder(void)
+{
+    if (_threadRecorder == NULL) {
+        pthread_once(&_keyOnce, _createKey);
+
+        _MetisLatencyRecorder *recorder = parcMemory_AllocateAndClear(sizeof(_MetisLatencyRecorder));
+        assertNotNull(recorder, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_MetisLatencyRecorder));
+
+        pthread_mutex_lock(&_lock);
+        recorder->next = _recorders;
+        if (_recorders != NULL) {
+            _recorders->previous = recorder;
+        }
+        _recorders = recorder;
+        pthread_mutex_unlock(&_lock);
+
+        pthread_setspecific(_recorderKey, recorder);
+        _threadRecorder = recorder;
+    }
+    return _threadRecorder;
+}
+
+// =====================================================================
+
+uint64_t
+metisLatency_BeginSample(void)
+{
+    if (_threadCountdown > 1) {
+        _threadCountdown--;
+        return 0;
+    }
+
+    _threadCountdown = metisLatency_GetSampleInterval();
+    uint64_t now = _now();
+    return now == 0 ? 1 : now;
+}
+
+void
+metisLatency_Record(MetisLatencyStage stage, uint64_t start)
+{
+    assertTrue(stage < MetisLatencyStage_END, "Invalid stage %d", stage);
+
+    uint64_t now = _now();
+    uint64_t ticks = now > start ? now - start : 0;
+
+    MetisLatencyHistogram *histogram = &_getRecorder()->histograms[stage];
+    metisStats_Increment(histogram->count);
+    metisStats_Add(histogram->sumTicks, ticks);
+    metisStats_Increment(histogram->buckets[metisLatency_BucketIndex(ticks)]);
+    if (ticks > histogram->maxTicks) {
+        __atomic_store_n(&histogram->maxTicks, ticks, __ATOMIC_RELAXED);
+    }
+}
+
+void
+metisLatency_SetSampleInterval(unsigned interval)
+{
+    if (interval > 0) {
+        pthread_once(&_calibrateOnce, _calibrate);
+    }
+    __atomic_store_n(&metisLatency_SampleInterval, interval, __ATOMIC_RELAXED);
+}
+
+unsigned
+metisLatency_GetSampleInterval(void)
+{
+    return __atomic_load_n(&metisLatency_SampleInterval, __ATOMIC_RELAXED);
+}
+
+const char *
+metisLatency_StageName(MetisLatencyStage stage)
+{
+    assertTrue(stage < MetisLatencyStage_END, "Invalid stage %d", stage);
+    return _metisLatencyStageNames[stage];
+}
+
+unsigned
+metisLatency_BucketIndex(uint64_t ticks)
+{
+    if (ticks < METIS_LATENCY_SUB_BUCKETS) {
+        return (unsigned) ticks;
+    }
+
+    // exponent >= METIS_LATENCY_SUB_BUCKET_BITS, the top SUB_BUCKET_BITS + 1 bits pick the bucket
+    unsigned exponent = 63 - (unsigned) __builtin_clzll(ticks);
+    unsigned shift = exponent - METIS_LATENCY_SUB_BUCKET_BITS;
+    unsigned subBucket = (unsigned) (ticks >> shift) - METIS_LATENCY_SUB_BUCKETS;
+    return (shift + 1) * METIS_LATENCY_SUB_BUCKETS + subBucket;
+}
+
+uint64_t
+metisLatency_BucketLowerBound(unsigned index)
+{
+    assertTrue(index < METIS_LATENCY_BUCKETS, "Invalid bucket %u", index);
+
+    if (index < METIS_LATENCY_SUB_BUCKETS) {
+        return index;
+    }
+
+    unsigned shift = index / METIS_LATENCY_SUB_BUCKETS - 1;
+    uint64_t subBucket = index % METIS_LATENCY_SUB_BUCKETS;
+    return (METIS_LATENCY_SUB_BUCKETS + subBucket) << shift;
+}
+
+void
+metisLatency_Snapshot(MetisLatencyHistogram *histograms)
+{
+    assertNotNull(histograms, "Parameter histograms must be non-null");
+
+    memset(histograms, 0, sizeof(MetisLatencyHistogram) * MetisLatencyStage_END);
+
+    pthread_mutex_lock(&_lock);
+    for (MetisLatencyStage stage = 0; stage < MetisLatencyStage_END; stage++) {
+        _addHistogram(&histograms[stage], &_retired[stage]);
+    }
+    for (_MetisLatencyRecorder *recorder = _recorders; recorder != NULL; recorder = recorder->next) {
+        for (MetisLatencyStage stage = 0; stage < MetisLatencyStage_END; stage++) {
+            _addHistogram(&histograms[stage], &recorder->histograms[stage]);
+        }
+    }
+    pthread_mutex_unlock(&_lock);
+}
+
+void
+metisLatency_Reset(void)
+{
+    pthread_mutex_lock(&_lock);
+    memset(_retired, 0, sizeof(_retired));
+    for (_MetisLatencyRecorder *recorder = _recorders; recorder != NULL; recorder = recorder->next) {
+        memset(recorder->histograms, 0, sizeof(recorder->histograms));
+    }
+    pthread_mutex_unlock(&_lock);
+    _threadCountdown = 0;
+}
+
+void
+metisLatency_Drain(void)
+{
+    if (_threadRecorder != NULL) {
+        pthread_setspecific(_recorderKey, NULL);
+        pthread_mutex_lock(&_lock);
+        _retireRecorder(_threadRecorder);
+        pthread_mutex_unlock(&_lock);
+        _threadRecorder = NULL;
+    }
+}
+
+uint64_t
+metisLatencyHistogram_Percentile(const MetisLatencyHistogram *histogram, double percentile)
+{
+    assertNotNull(histogram, "Parameter histogram must be non-null");
+
+    if (histogram->count == 0) {
+        return 0;
+    }
+
+    // the rank of the sample at the percentile, at least the first sample
+    uint64_t rank = (uint64_t) (percentile / 100.0 * (double) histogram->count + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < METIS_LATENCY_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            uint64_t lower = metisLatency_BucketLowerBound(i);
+            uint64_t width = (i + 1 < METIS_LATENCY_BUCKETS) ? metisLatency_BucketLowerBound(i + 1) - lower : 1;
+            uint64_t middle = lower + width / 2;
+            return middle < histogram->maxTicks ? middle : histogram->maxTicks;
+        }
+    }
+    return histogram->maxTicks;
+}
+
+uint64_t
+metisLatency_TicksToNanos(uint64_t ticks)
+{
+    return (uint64_t) ((double) ticks * _nanosPerTick + 0.5);
+}
+
+PARCJSON *
+metisLatency_ToJson(const MetisLatencyHistogram *histograms)
+{
+    assertNotNull(histograms, "Parameter histograms must be non-null");
+
+    PARCJSON *json = parcJSON_Create();
+    parcJSON_AddInteger(json, "SAMPLE_INTERVAL", metisLatency_GetSampleInterval());
+
+    for (MetisLatencyStage stage = 0; stage < MetisLatencyStage_END; stage++) {
+        const MetisLatencyHistogram *histogram = &histograms[stage];
+        uint64_t meanTicks = histogram->count > 0 ? histogram->sumTicks / histogram->count : 0;
+
+        PARCJSON *summary = parcJSON_Create();
+        parcJSON_AddInteger(summary, "count", (int64_t) histogram->count);
+        parcJSON_AddInteger(summary, "meanNs", (int64_t) metisLatency_TicksToNanos(meanTicks));
+        parcJSON_AddInteger(summary, "p50Ns", (int64_t) metisLatency_TicksToNanos(metisLatencyHistogram_Percentile(histogram, 50.0)));
+        parcJSON_AddInteger(summary, "p90Ns", (int64_t) metisLatency_TicksToNanos(metisLatencyHistogram_Percentile(histogram, 90.0)));
+        parcJSON_AddInteger(summary, "p99Ns", (int64_t) metisLatency_TicksToNanos(metisLatencyHistogram_Percentile(histogram, 99.0)));
+        parcJSON_AddInteger(summary, "p999Ns", (int64_t) metisLatency_TicksToNanos(metisLatencyHistogram_Percentile(histogram, 99.9)));
+        parcJSON_AddInteger(summary, "maxNs", (int64_t) metisLatency_TicksToNanos(histogram->maxTicks));
+
+        parcJSON_AddObject(json, _metisLatencyStageNames[stage], summary);
+        parcJSON_Release(&summary);
+    }
+    return json;
+}
+
+CCNxControl *
+metisLatency_CreateCPIRequest(bool setInterval, unsigned interval)
+{
+    PARCJSON *operation = parcJSON_Create();
+    if (setInterval) {
+        parcJSON_AddInteger(operation, "SAMPLE_INTERVAL", interval);
+    }
+    CCNxControl *request = metisStats_CreateCPIMessage("CPI_REQUEST", cpi_GetNextSequenceNumber(), METIS_LATENCY_CPI_OPERATION, operation);
+    parcJSON_Release(&operation);
+    return request;
+}
+
+bool
+metisLatency_IsCPIRequest(CCNxControl *control)
+{
+    assertNotNull(control, "Parameter control must be non-null");
+    return metisStats_GetCPIOperation(control, "CPI_REQUEST", METIS_LATENCY_CPI_OPERATION) != NULL;
+}
+
+CCNxControl *
+metisLatency_ProcessCPIRequest(CCNxControl *request)
+{
+    PARCJSON *operation = metisStats_GetCPIOperation(request, "CPI_REQUEST", METIS_LATENCY_CPI_OPERATION);
+    assertNotNull(operation, "Parameter request must be a latency request");
+
+    PARCJSONValue *value = parcJSON_GetValueByName(operation, "SAMPLE_INTERVAL");
+    if (value != NULL && parcJSONValue_IsNumber(value)) {
+        int64_t interval = parcJSONValue_GetInteger(value);
+        metisLatency_SetSampleInterval(interval > 0 ? (unsigned) interval : 0);
+    }
+
+    size_t length = sizeof(MetisLatencyHistogram) * MetisLatencyStage_END;
+    MetisLatencyHistogram *histograms = parcMemory_Allocate(length);
+    assertNotNull(histograms, "parcMemory_Allocate(%zu) returned NULL", length);
+    metisLatency_Snapshot(histograms);
+
+    PARCJSON *summary = metisLatency_ToJson(histograms);
+    CCNxControl *response = metisStats_CreateCPIMessage("CPI_RESPONSE", cpi_GetSequenceNumber(request), METIS_LATENCY_CPI_OPERATION, summary);
+    parcJSON_Release(&summary);
+    parcMemory_Deallocate((void **) &histograms);
+    return response;
+}
+
+PARCJSON *
+metisLatency_GetCPIResponse(CCNxControl *response)
+{
+    assertNotNull(response, "Parameter response must be non-null");
+    return metisStats_GetCPIOperation(response, "CPI_RESPONSE", METIS_LATENCY_CPI_OPERATION);
+}
@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_Latency.h
+ * @brief Sampled latency histograms for the stages of forwarding a packet
+ *
+ * The forwarder brackets each stage with metisLatency_Start() and metisLatency_Stop(): parsing a
+ * packet, the PIT, the Content Store, the FIB and the send to a connection.  Sampling is off until
+ * metisLatency_SetSampleInterval() is given a positive N.  Then every Nth stage on a thread is
+ * timed with the CPU's time stamp counter (a monotonic nanosecond clock on other machines) and
+ * counted in that thread's histogram for the stage.  While sampling is off, metisLatency_Start()
+ * is one relaxed load and a branch.
+ *
+ * The histograms are log-linear, in the style of HdrHistogram: each power of two is split in to
+ * METIS_LATENCY_SUB_BUCKETS buckets, so a percentile is within 1/METIS_LATENCY_SUB_BUCKETS of
+ * the true value.  A thread's histograms are written only by that thread.  metisLatency_Snapshot()
+ * adds up every thread's histograms, including those of threads that have exited.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_Latency_h
+#define Metis_metis_Latency_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <parc/algol/parc_JSON.h>
+#include <ccnx/api/control/ccnxControl.h>
+
+typedef enum {
+    MetisLatencyStage_Parse,
+    MetisLatencyStage_Pit,
+    MetisLatencyStage_ContentStore,
+    MetisLatencyStage_Fib,
+    MetisLatencyStage_Send,
+    MetisLatencyStage_END             // sentinel value
+} MetisLatencyStage;
+
+/**
+ * log2 of the number of buckets per power of two
+ */
+#define METIS_LATENCY_SUB_BUCKET_BITS 4
+#define METIS_LATENCY_SUB_BUCKETS (1 << METIS_LATENCY_SUB_BUCKET_BITS)
+
+/**
+ * Enough buckets for any 64-bit value
+ */
+#define METIS_LATENCY_BUCKETS ((64 - METIS_LATENCY_SUB_BUCKET_BITS + 1) * METIS_LATENCY_SUB_BUCKETS)
+
+/**
+ * The operation name of the Metis-specific CPI request for the latency histograms.
+ * See metisStats_CreateCPIMessage().
+ */
+#define METIS_LATENCY_CPI_OPERATION "METIS_LATENCY"
+
+/**
+ * The latencies of one stage, in ticks of the sampling clock
+ */
+typedef struct metis_latency_histogram {
+    uint64_t count;
+    uint64_t sumTicks;
+    uint64_t maxTicks;
+    uint64_t buckets[METIS_LATENCY_BUCKETS];
+} MetisLatencyHistogram;
+
+/**
+ * The sample interval, read by metisLatency_Start().  Use metisLatency_SetSampleInterval() to change it.
+ */
+extern unsigned metisLatency_SampleInterval;
+
+/**
+ * Begins timing a stage
+ *
+ * @return non-zero The start time, pass it to metisLatency_Stop()
+ * @return 0 This stage is not sampled
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t start = metisLatency_Start();
+ *     MetisTlvName *nexthops = metisFIB_Match(fib, interest);
+ *     metisLatency_Stop(MetisLatencyStage_Fib, start);
+ * }
+ * @endcode
+ */
+#define metisLatency_Start() \
+    (__atomic_load_n(&metisLatency_SampleInterval, __ATOMIC_RELAXED) == 0 ? 0 : metisLatency_BeginSample())
+
+/**
+ * Ends timing a stage begun by metisLatency_Start(), does nothing if it was not sampled
+ */
+#define metisLatency_Stop(stage, start) \
+    do { \
+        uint64_t metisLatencyStart_ = (start); \
+        if (metisLatencyStart_ != 0) { \
+            metisLatency_Record((stage), metisLatencyStart_); \
+        } \
+    } while (0)
+
+/**
+ * The slow path of metisLatency_Start(), do not call it directly
+ */
+uint64_t metisLatency_BeginSample(void);
+
+/**
+ * The slow path of metisLatency_Stop(), do not call it directly
+ */
+void metisLatency_Record(MetisLatencyStage stage, uint64_t start);
+
+/**
+ * Samples one in every `interval` stages on each thread
+ *
+ * The first time sampling is turned on, this measures the sampling clock against the system's
+ * monotonic clock for a few milliseconds.
+ *
+ * @param [in] interval Sample one in this many, 0 turns sampling off
+ *
+ * Example:
+ * @code
+ * {
+ *     metisLatency_SetSampleInterval(1000);
+ * }
+ * @endcode
+ */
+void metisLatency_SetSampleInterval(unsigned interval);
+
+/**
+ * Returns the sample interval
+ *
+ * @return 0 Sampling is off
+ * @return positive One in this many stages is sampled
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+unsigned metisLatency_GetSampleInterval(void);
+
+/**
+ * The name of a stage, such as "pit"
+ *
+ * @param [in] stage A stage less than MetisLatencyStage_END
+ *
+ * @return non-null A static string
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+const char *metisLatency_StageName(MetisLatencyStage stage);
+
+/**
+ * The bucket a latency goes in
+ *
+ * Latencies below METIS_LATENCY_SUB_BUCKETS each have a bucket.  Above that, each power of
+ * two is split in to METIS_LATENCY_SUB_BUCKETS equal buckets.
+ *
+ * @param [in] ticks A latency
+ *
+ * @return The bucket index, less than METIS_LATENCY_BUCKETS
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+unsigned metisLatency_BucketIndex(uint64_t ticks);
+
+/**
+ * The smallest latency in a bucket
+ *
+ * @param [in] index A bucket index less than METIS_LATENCY_BUCKETS
+ *
+ * @return The smallest latency x with metisLatency_BucketIndex(x) == index
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+uint64_t metisLatency_BucketLowerBound(unsigned index);
+
+/**
+ * Adds every thread's histograms together
+ *
+ * The histograms are read while other threads may be writing them, so the counts of one stage
+ * may be a few samples apart.
+ *
+ * @param [out] histograms An array of MetisLatencyStage_END histograms, indexed by stage
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisLatencyHistogram histograms[MetisLatencyStage_END];
+ *     metisLatency_Snapshot(histograms);
+ * }
+ * @endcode
+ */
+void metisLatency_Snapshot(MetisLatencyHistogram *histograms);
+
+/**
+ * Clears every thread's histograms
+ *
+ * Only safe when no other thread is sampling, such as in a unit test.
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+void metisLatency_Reset(void);
+
+/**
+ * Folds the calling thread's histograms in to the totals and frees them
+ *
+ * A thread's histograms are folded in when it exits.  The main thread should call this
+ * before it exits if it wants a clean leak report.
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+void metisLatency_Drain(void);
+
+/**
+ * A percentile of a histogram
+ *
+ * @param [in] histogram A stage's histogram
+ * @param [in] percentile Between 0 and 100
+ *
+ * @return The middle of the bucket that holds the percentile, in ticks, no more than the
+ *         histogram's maximum.  0 if the histogram is empty.
+ *
+ * Example:
+ * @code
+ * {
+ *     uint64_t p99 = metisLatencyHistogram_Percentile(&histograms[MetisLatencyStage_Pit], 99.0);
+ * }
+ * @endcode
+ */
+uint64_t metisLatencyHistogram_Percentile(const MetisLatencyHistogram *histogram, double percentile);
+
+/**
+ * Converts ticks of the sampling clock to nanoseconds
+ *
+ * @param [in] ticks A latency from a MetisLatencyHistogram
+ *
+ * @return The latency in nanoseconds
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+uint64_t metisLatency_TicksToNanos(uint64_t ticks);
+
+/**
+ * A summary of the histograms, in nanoseconds
+ *
+ * {"SAMPLE_INTERVAL":n, "parse":{"count":c, "meanNs":x, "p50Ns":x, "p90Ns":x, "p99Ns":x, "p999Ns":x, "maxNs":x}, ...}
+ * with one object per stage.
+ *
+ * @param [in] histograms An array of MetisLatencyStage_END histograms
+ *
+ * @return non-null A JSON object, release it with parcJSON_Release()
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+PARCJSON *metisLatency_ToJson(const MetisLatencyHistogram *histograms);
+
+/**
+ * Creates the CPI request for the latency summary
+ *
+ * {"CPI_REQUEST":{"SEQUENCE":n,"METIS_LATENCY":{}}}, or with {"SAMPLE_INTERVAL":n} in the
+ * operation to also change the sample interval.
+ *
+ * @param [in] setInterval true to change the sample interval
+ * @param [in] interval The new sample interval, 0 turns sampling off
+ *
+ * @return non-null A CPI control message, release it with ccnxControl_Release()
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+CCNxControl *metisLatency_CreateCPIRequest(bool setInterval, unsigned interval);
+
+/**
+ * Determines if a control message is a latency request
+ *
+ * @param [in] control A CPI control message
+ *
+ * @return true if it was made by metisLatency_CreateCPIRequest()
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+bool metisLatency_IsCPIRequest(CCNxControl *control);
+
+/**
+ * Carries out a latency request and creates the response
+ *
+ * Changes the sample interval if the request asks to, then returns the summary of metisLatency_ToJson().
+ *
+ * @param [in] request A request from metisLatency_CreateCPIRequest()
+ *
+ * @return non-null A CPI control message, release it with ccnxControl_Release()
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+CCNxControl *metisLatency_ProcessCPIRequest(CCNxControl *request);
+
+/**
+ * Finds the summary in a response from metisLatency_ProcessCPIRequest()
+ *
+ * @param [in] response A CPI response
+ *
+ * @return non-null The summary, owned by `response`
+ * @return null `response` is not a latency response
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+PARCJSON *metisLatency_GetCPIResponse(CCNxControl *response);
+#endif // Metis_metis_Latency_h
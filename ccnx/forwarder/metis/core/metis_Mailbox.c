@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * The producer pushes on the ring, then sets `wakePending`.  Only the producer that changes it
+ * from false to true writes to the pipe.  The consumer drains the pipe, clears `wakePending`, then
+ * drains the ring, so an item pushed at any point is either seen by this pass or wakes the next one.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <ccnx/forwarder/metis/core/metis_Mailbox.h>
+#include <ccnx/forwarder/metis/core/metis_SpscRing.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <LongBow/runtime.h>
+
+struct metis_mailbox {
+    MetisSpscRing *ring;
+    int fds[2];
+    bool wakePending;
+    PARCEvent *event;
+    MetisDispatcher *dispatcher;
+};
+
+static void
+_metisMailbox_SetNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, NULL);
+    assertTrue(flags != -1, "fcntl failed to obtain file descriptor flags (%d)", errno);
+    int failure = fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    assertFalse(failure, "fcntl failed to set file descriptor flags (%d)", errno);
+}
+
+MetisMailbox *
+metisMailbox_Create(size_t capacity, MetisDispatcher *consumer, PARCEvent_Callback *callback, void *userData)
+{
+    assertNotNull(consumer, "Parameter consumer must be non-null");
+    assertNotNull(callback, "Parameter callback must be non-null");
+
+    MetisMailbox *mailbox = parcMemory_AllocateAndClear(sizeof(MetisMailbox));
+    assertNotNull(mailbox, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisMailbox));
+
+    mailbox->ring = metisSpscRing_Create(capacity);
+
+    int failure = pipe(mailbox->fds);
+    assertFalse(failure, "pipe failed (%d) %s", errno, strerror(errno));
+    _metisMailbox_SetNonBlocking(mailbox->fds[0]);
+    _metisMailbox_SetNonBlocking(mailbox->fds[1]);
+
+    mailbox->dispatcher = consumer;
+    mailbox->event = metisDispatcher_CreateNetworkEvent(consumer, true, callback, userData, mailbox->fds[0]);
+    metisDispatcher_StartNetworkEvent(consumer, mailbox->event);
+
+    return mailbox;
+}
+
+void
+metisMailbox_Destroy(MetisMailbox **mailboxPtr)
+{
+    assertNotNull(mailboxPtr, "Parameter must be non-null double pointer");
+    assertNotNull(*mailboxPtr, "Parameter must dereference to non-null pointer");
+
+    MetisMailbox *mailbox = *mailboxPtr;
+    metisDispatcher_StopNetworkEvent(mailbox->dispatcher, mailbox->event);
+    metisDispatcher_DestroyNetworkEvent(mailbox->dispatcher, &mailbox->event);
+    close(mailbox->fds[0]);
+    close(mailbox->fds[1]);
+    metisSpscRing_Destroy(&mailbox->ring);
+    parcMemory_Deallocate((void **) &mailbox);
+    *mailboxPtr = NULL;
+}
+
+bool
+metisMailbox_Post(MetisMailbox *mailbox, void *item, unsigned value)
+{
+    if (!metisSpscRing_Push(mailbox->ring, item, value)) {
+        return false;
+    }
+    metisMailbox_Wake(mailbox);
+    return true;
+}
+
+void
+metisMailbox_Wake(MetisMailbox *mailbox)
+{
+    if (!__atomic_exchange_n(&mailbox->wakePending, true, __ATOMIC_SEQ_CST)) {
+        uint8_t wake = 1;
+        // if the pipe is full the consumer is already due to run, so a short write is fine
+        ssize_t nwritten = write(mailbox->fds[1], &wake, 1);
+        (void) nwritten;
+    }
+}
+
+void
+metisMailbox_Acknowledge(MetisMailbox *mailbox)
+{
+    uint8_t buffer[64];
+    while (read(mailbox->fds[0], buffer, sizeof(buffer)) > 0) {
+        // drain
+    }
+    __atomic_store_n(&mailbox->wakePending, false, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void *
+metisMailbox_Take(MetisMailbox *mailbox, unsigned *valuePtr)
+{
+    return metisSpscRing_Pop(mailbox->ring, valuePtr);
+}
+
+void
+metisMailbox_Rearm(MetisMailbox *mailbox)
+{
+    if (metisSpscRing_Count(mailbox->ring) > 0) {
+        metisMailbox_Wake(mailbox);
+    }
+}
+
+size_t
+metisMailbox_Count(const MetisMailbox *mailbox)
+{
+    return metisSpscRing_Count(mailbox->ring);
+}
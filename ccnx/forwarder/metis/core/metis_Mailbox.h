@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_Mailbox.h
+ * @brief A MetisSpscRing whose consumer is an event on a MetisDispatcher
+ *
+ * The producer thread posts items and the consumer's dispatcher runs a callback to take them.
+ * The wakeup is a byte written to a pipe, and only the first post after the consumer has
+ * acknowledged the previous wakeup writes it, so a busy producer does not make a system call per item.
+ *
+ * The consumer's callback must follow this shape:
+ *
+ * @code
+ * static void
+ * _callback(int fd, PARCEventType which_event, void *user_data)
+ * {
+ *     metisMailbox_Acknowledge(mailbox);
+ *     for (unsigned i = 0; i < BATCH; i++) {
+ *         void *item = metisMailbox_Take(mailbox, NULL);
+ *         if (item == NULL) {
+ *             break;
+ *         }
+ *         // ...
+ *     }
+ *     metisMailbox_Rearm(mailbox);
+ * }
+ * @endcode
+ *
+ * An item posted at any point is then either taken by the current pass or wakes the next one.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_Mailbox_h
+#define Metis_metis_Mailbox_h
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <ccnx/forwarder/metis/core/metis_Dispatcher.h>
+
+struct metis_mailbox;
+typedef struct metis_mailbox MetisMailbox;
+
+/**
+ * Creates an empty mailbox and starts its event on the consumer's dispatcher
+ *
+ * @param [in] capacity The minimum number of queued items, rounded up to a power of 2
+ * @param [in] consumer The dispatcher that runs the callback
+ * @param [in] callback Called on the consumer's thread when items may be waiting
+ * @param [in] userData Passed to the callback
+ *
+ * @return non-null An allocated mailbox
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisMailbox *mailbox = metisMailbox_Create(4096, dispatcher, _callback, context);
+ *     metisMailbox_Destroy(&mailbox);
+ * }
+ * @endcode
+ */
+MetisMailbox *metisMailbox_Create(size_t capacity, MetisDispatcher *consumer, PARCEvent_Callback *callback, void *userData);
+
+/**
+ * Stops the event and destroys the mailbox
+ *
+ * Only call once neither side is running.  Items still queued are not touched, so the
+ * caller should drain them with metisMailbox_Take first.
+ *
+ * @param [in,out] mailboxPtr Pointer to the mailbox, will be NULL'd
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisMessage *message;
+ *     while ((message = metisMailbox_Take(mailbox, NULL)) != NULL) {
+ *         metisMessage_Release(&message);
+ *     }
+ *     metisMailbox_Destroy(&mailbox);
+ * }
+ * @endcode
+ */
+void metisMailbox_Destroy(MetisMailbox **mailboxPtr);
+
+/**
+ * Queues an item and wakes the consumer.  Producer thread only.
+ *
+ * @param [in] mailbox An allocated mailbox
+ * @param [in] item The pointer to pass, may not be NULL
+ * @param [in] value Passed along with the item
+ *
+ * @return true The item was queued
+ * @return false The mailbox is full, the item was not queued
+ *
+ * Example:
+ * @code
+ * {
+ *     if (!metisMailbox_Post(mailbox, message, connectionId)) {
+ *         metisMessage_Release(&message);
+ *     }
+ * }
+ * @endcode
+ */
+bool metisMailbox_Post(MetisMailbox *mailbox, void *item, unsigned value);
+
+/**
+ * Runs the consumer's callback without posting an item
+ *
+ * Used to make the consumer look at some other shared state, such as a stop flag.
+ * Any thread may call it.
+ *
+ * @param [in] mailbox An allocated mailbox
+ *
+ * Example:
+ * @code
+ * {
+ *     __atomic_store_n(&context->stopRequested, true, __ATOMIC_RELEASE);
+ *     metisMailbox_Wake(mailbox);
+ * }
+ * @endcode
+ */
+void metisMailbox_Wake(MetisMailbox *mailbox);
+
+/**
+ * Clears the wakeup.  Consumer only, at the start of the callback and before any Take.
+ *
+ * @param [in] mailbox An allocated mailbox
+ *
+ * Example:
+ * @code
+ * {
+ *     metisMailbox_Acknowledge(mailbox);
+ * }
+ * @endcode
+ */
+void metisMailbox_Acknowledge(MetisMailbox *mailbox);
+
+/**
+ * Removes the oldest item.  Consumer only.
+ *
+ * @param [in] mailbox An allocated mailbox
+ * @param [out] valuePtr If not NULL, receives the value posted with the item
+ *
+ * @return non-null The oldest item
+ * @return null The mailbox is empty
+ *
+ * Example:
+ * @code
+ * {
+ *     unsigned connectionId;
+ *     MetisMessage *message = metisMailbox_Take(mailbox, &connectionId);
+ * }
+ * @endcode
+ */
+void *metisMailbox_Take(MetisMailbox *mailbox, unsigned *valuePtr);
+
+/**
+ * If the callback stopped with items still queued, runs it again.  Consumer only, at the end of the callback.
+ *
+ * @param [in] mailbox An allocated mailbox
+ *
+ * Example:
+ * @code
+ * {
+ *     metisMailbox_Rearm(mailbox);
+ * }
+ * @endcode
+ */
+void metisMailbox_Rearm(MetisMailbox *mailbox);
+
+/**
+ * The number of queued items
+ *
+ * From a thread other than the producer or consumer, the result is only a snapshot.
+ *
+ * @param [in] mailbox An allocated mailbox
+ *
+ * @return The number of queued items
+ *
+ * Example:
+ * @code
+ * {
+ *     if (metisMailbox_Count(mailbox) == 0) {
+ *         // idle
+ *     }
+ * }
+ * @endcode
+ */
+size_t metisMailbox_Count(const MetisMailbox *mailbox);
+#endif // Metis_metis_Mailbox_h
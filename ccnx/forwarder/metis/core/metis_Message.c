@@ -66,7 +66,10 @@
 #include <ccnx/forwarder/metis/core/metis_Message.h>
 #include <ccnx/forwarder/metis/core/metis_StreamBuffer.h>
 #include <ccnx/forwarder/metis/tlv/metis_Tlv.h>
+#include <ccnx/forwarder/metis/tlv/metis_TlvHash.h>
 #include <ccnx/forwarder/metis/core/metis_Forwarder.h>
+#include <ccnx/forwarder/metis/core/metis_Slab.h>
+#include <ccnx/forwarder/metis/core/metis_Latency.h>
 
 #include <parc/algol/parc_Memory.h>
 #include <parc/algol/parc_Hash.h>
@@ -96,6 +99,7 @@ struct metis_message {
     // may be null, even if hasContentObjectHash true due to lazy calculation
     PARCBuffer *contentObjectHash;
 
+    // created from the skeleton on first use, see _lazyBuffer()
     PARCBuffer *certificate;
 
     PARCBuffer *publicKey;
@@ -143,19 +147,33 @@ _setupValidationParams(MetisMessage *message)
     }
     message->isKeyIdVerified = false;
 
-    extent = metisTlvSkeleton_GetCertificate(&message->skeleton);
-    if (extent.offset > 0) {
-        message->certificate = parcBuffer_Flip(parcBuffer_CreateFromArray(&message->messageHead[extent.offset], extent.length));
-    } else {
-        message->certificate = NULL;
-    }
+    // the certificate and public key buffers are created on demand by _lazyBuffer()
+    message->certificate = NULL;
+    message->publicKey = NULL;
+}
 
-    extent = metisTlvSkeleton_GetPublicKey(&message->skeleton);
-    if (extent.offset > 0) {
-        message->publicKey = parcBuffer_Flip(parcBuffer_CreateFromArray(&message->messageHead[extent.offset], extent.length));
-    } else {
-        message->publicKey = NULL;
+/**
+ * Returns the buffer at *bufferPtr, creating it from the extent first if needed.
+ *
+ * Most messages never have their certificate or public key looked at, so we do not allocate
+ * buffers for them while parsing.  The message may be shared between threads, so the buffer is
+ * published with a compare-and-swap and the loser of a race releases its copy.
+ *
+ * @return NULL if the extent is empty
+ */
+static PARCBuffer *
+_lazyBuffer(const MetisMessage *message, PARCBuffer **bufferPtr, MetisTlvExtent extent)
+{
+    PARCBuffer *buffer = __atomic_load_n(bufferPtr, __ATOMIC_ACQUIRE);
+    if (buffer == NULL && extent.offset > 0) {
+        PARCBuffer *created = parcBuffer_Flip(parcBuffer_CreateFromArray(&message->messageHead[extent.offset], extent.length));
+        if (__atomic_compare_exchange_n(bufferPtr, &buffer, created, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            buffer = created;
+        } else {
+            parcBuffer_Release(&created);
+        }
     }
+    return buffer;
 }
 
 static void
@@ -218,10 +236,7 @@ _setupExpiryTime(MetisMessage *message)
                 message->hasExpiryTimeTicks = true;
 
                 // Convert it to ticks that we can use for expiration checking.
-                uint64_t metisWallClockTime = parcClock_GetTime(parcClock_Wallclock());
-                uint64_t currentTimeInTicks = parcClock_GetTime(parcClock_Monotonic());
-
-                message->expiryTimeTicks = expiryTimeUTC - metisWallClockTime + currentTimeInTicks;
+                message->expiryTimeTicks = metisForwarder_WallclockToTicks(expiryTimeUTC);
             }
         }
     }
@@ -241,10 +256,7 @@ _setupRecommendedCacheTime(MetisMessage *message)
                 message->hasRecommendedCacheTimeTicks = true;
 
                 // Convert it to ticks that we can use for expiration checking.
-                uint64_t metisWallClockTime = parcClock_GetTime(parcClock_Wallclock());
-                uint64_t currentTimeInTicks = parcClock_GetTime(parcClock_Monotonic());
-
-                message->recommendedCacheTimeTicks = recommendedCacheTime - metisWallClockTime + currentTimeInTicks;
+                message->recommendedCacheTimeTicks = metisForwarder_WallclockToTicks(recommendedCacheTime);
             }
         }
     }
@@ -268,6 +280,8 @@ _setupRecommendedCacheTime(MetisMessage *message)
 static bool
 _setupInternalData(MetisMessage *message)
 {
+    uint64_t latencyStart = metisLatency_Start();
+
     // -1 means linearize the whole buffer
     message->messageHead = parcEventBuffer_Pullup(message->messageBytes, -1);
     message->packetType = MetisMessagePacketType_Unknown;
@@ -304,6 +318,7 @@ _setupInternalData(MetisMessage *message)
         }
     }
 
+    metisLatency_Stop(MetisLatencyStage_Parse, latencyStart);
     return goodSkeleton;
 }
 
@@ -311,15 +326,16 @@ MetisMessage *
 metisMessage_Acquire(const MetisMessage *message)
 {
     MetisMessage *copy = (MetisMessage *) message;
-    copy->refcount++;
+
+    // atomic because a message may be shared between the I/O thread and a processor worker thread
+    __atomic_add_fetch(&copy->refcount, 1, __ATOMIC_RELAXED);
     return copy;
 }
 
 MetisMessage *
 metisMessage_CreateFromParcBuffer(PARCBuffer *buffer, unsigned ingressConnectionId, MetisTicks receiveTime, MetisLogger *logger)
 {
-    MetisMessage *message = parcMemory_AllocateAndClear(sizeof(MetisMessage));
-    assertNotNull(message, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisMessage));
+    MetisMessage *message = metisSlab_AllocateAndClear(sizeof(MetisMessage));
     message->receiveTime = receiveTime;
     message->ingressConnectionId = ingressConnectionId;
     message->messageBytes = parcEventBuffer_Create();
@@ -352,8 +368,7 @@ metisMessage_CreateFromParcBuffer(PARCBuffer *buffer, unsigned ingressConnection
 MetisMessage *
 metisMessage_CreateFromArray(const uint8_t *data, size_t dataLength, unsigned ingressConnectionId, MetisTicks receiveTime, MetisLogger *logger)
 {
-    MetisMessage *message = parcMemory_AllocateAndClear(sizeof(MetisMessage));
-    assertNotNull(message, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisMessage));
+    MetisMessage *message = metisSlab_AllocateAndClear(sizeof(MetisMessage));
     message->receiveTime = receiveTime;
     message->ingressConnectionId = ingressConnectionId;
     message->messageBytes = parcEventBuffer_Create();
@@ -387,8 +402,7 @@ metisMessage_CreateFromArray(const uint8_t *data, size_t dataLength, unsigned in
 MetisMessage *
 metisMessage_ReadFromBuffer(unsigned ingressConnectionId, MetisTicks receiveTime, PARCEventBuffer *input, size_t bytesToRead, MetisLogger *logger)
 {
-    MetisMessage *message = parcMemory_AllocateAndClear(sizeof(MetisMessage));
-    assertNotNull(message, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisMessage));
+    MetisMessage *message = metisSlab_AllocateAndClear(sizeof(MetisMessage));
     message->receiveTime = receiveTime;
     message->ingressConnectionId = ingressConnectionId;
     message->messageBytes = parcEventBuffer_Create();
@@ -424,8 +438,7 @@ MetisMessage *
 metisMessage_CreateFromBuffer(unsigned ingressConnectionId, MetisTicks receiveTime, PARCEventBuffer *input, MetisLogger *logger)
 {
     assertNotNull(input, "Parameter input must be non-null");
-    MetisMessage *message = parcMemory_AllocateAndClear(sizeof(MetisMessage));
-    assertNotNull(message, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisMessage));
+    MetisMessage *message = metisSlab_AllocateAndClear(sizeof(MetisMessage));
     message->receiveTime = receiveTime;
     message->ingressConnectionId = ingressConnectionId;
     message->messageBytes = input;
@@ -460,8 +473,8 @@ metisMessage_Release(MetisMessage **messagePtr)
     MetisMessage *message = *messagePtr;
     assertTrue(message->refcount > 0, "Invalid state: metisMessage_Release called on message with 0 references %p", (void *) message);
 
-    message->refcount--;
-    if (message->refcount == 0) {
+    // acq_rel so the thread that destroys the message sees every other thread's writes to it
+    if (__atomic_sub_fetch(&message->refcount, 1, __ATOMIC_ACQ_REL) == 0) {
         if (metisLogger_IsLoggable(message->logger, MetisLoggerFacility_Message, PARCLogLevel_Debug)) {
             metisLogger_Log(message->logger, MetisLoggerFacility_Message, PARCLogLevel_Debug, __func__,
                             "Message %p destroyed",
@@ -486,7 +499,7 @@ metisMessage_Release(MetisMessage **messagePtr)
 
         metisLogger_Release(&message->logger);
         parcEventBuffer_Destroy(&(message->messageBytes));
-        parcMemory_Deallocate((void **) &message);
+        metisSlab_Deallocate((void **) &message, sizeof(MetisMessage));
     }
     *messagePtr = NULL;
 }
@@ -507,6 +520,17 @@ metisMessage_Append(PARCEventBuffer *writeBuffer, const MetisMessage *message)
     return parcEventBuffer_Append(writeBuffer, message->messageHead, metisMessage_Length(message));
 }
 
+void
+metisMessage_GetIovec(const MetisMessage *message, struct iovec *vector)
+{
+    assertNotNull(message, "Message parameter must be non-null");
+    assertNotNull(vector, "Vector parameter must be non-null");
+
+    // _setupInternalData did a Pullup, so the message is contiguous at messageHead
+    vector->iov_base = message->messageHead;
+    vector->iov_len = metisMessage_Length(message);
+}
+
 size_t
 metisMessage_Length(const MetisMessage *message)
 {
@@ -521,6 +545,13 @@ metisMessage_GetIngressConnectionId(const MetisMessage *message)
     return message->ingressConnectionId;
 }
 
+void
+metisMessage_SetIngressConnectionId(MetisMessage *message, unsigned ingressConnectionId)
+{
+    assertNotNull(message, "Parameter must be non-null");
+    message->ingressConnectionId = ingressConnectionId;
+}
+
 MetisTicks
 metisMessage_GetReceiveTime(const MetisMessage *message)
 {
@@ -587,14 +618,16 @@ PARCBuffer *
 metisMessage_GetCertificate(const MetisMessage *message)
 {
     assertNotNull(message, "Parameter message must be non-null");
-    return message->certificate;
+    MetisMessage *mutable = (MetisMessage *) message;
+    return _lazyBuffer(message, &mutable->certificate, metisTlvSkeleton_GetCertificate(&message->skeleton));
 }
 
 PARCBuffer *
 metisMessage_GetPublicKey(const MetisMessage *message)
 {
     assertNotNull(message, "Parameter message must be non-null");
-    return message->publicKey;
+    MetisMessage *mutable = (MetisMessage *) message;
+    return _lazyBuffer(message, &mutable->publicKey, metisTlvSkeleton_GetPublicKey(&message->skeleton));
 }
 
 bool
@@ -614,6 +647,19 @@ metisMessage_KeyIdEquals(const MetisMessage *a, const MetisMessage *b)
     return false;
 }
 
+/**
+ * Computes the hash of a content object the first time it is needed
+ */
+static void
+_computeContentObjectHash(MetisMessage *message)
+{
+    if (message->contentObjectHash == NULL) {
+        PARCCryptoHash *hash = metisTlvSkeleton_ComputeContentObjectHash(&message->skeleton);
+        message->contentObjectHash = parcBuffer_Acquire(parcCryptoHash_GetDigest(hash));
+        parcCryptoHash_Release(&hash);
+    }
+}
+
 bool
 metisMessage_ObjectHashEquals(MetisMessage *a, MetisMessage *b)
 {
@@ -621,17 +667,8 @@ metisMessage_ObjectHashEquals(MetisMessage *a, MetisMessage *b)
     assertNotNull(b, "Parameter b must be non-null");
 
     if (a->hasContentObjectHash && b->hasContentObjectHash) {
-        if (a->contentObjectHash == NULL) {
-            PARCCryptoHash *hash = metisTlvSkeleton_ComputeContentObjectHash(&a->skeleton);
-            a->contentObjectHash = parcBuffer_Acquire(parcCryptoHash_GetDigest(hash));
-            parcCryptoHash_Release(&hash);
-        }
-
-        if (b->contentObjectHash == NULL) {
-            PARCCryptoHash *hash = metisTlvSkeleton_ComputeContentObjectHash(&b->skeleton);
-            b->contentObjectHash = parcBuffer_Acquire(parcCryptoHash_GetDigest(hash));
-            parcCryptoHash_Release(&hash);
-        }
+        _computeContentObjectHash(a);
+        _computeContentObjectHash(b);
 
         return parcBuffer_Equals(a->contentObjectHash, b->contentObjectHash);
     }
@@ -646,11 +683,7 @@ metisMessage_GetContentObjectHashHash(MetisMessage *message, uint32_t *hashOutpu
     assertNotNull(hashOutput, "Parameter hashOutput must be non-null");
 
     if (message->hasContentObjectHash) {
-        if (message->contentObjectHash == NULL) {
-            PARCCryptoHash *hash = metisTlvSkeleton_ComputeContentObjectHash(&message->skeleton);
-            message->contentObjectHash = parcBuffer_Acquire(parcCryptoHash_GetDigest(hash));
-            parcCryptoHash_Release(&hash);
-        }
+        _computeContentObjectHash(message);
 
         *hashOutput = (uint32_t) parcBuffer_HashCode(message->contentObjectHash);
         return true;
@@ -658,18 +691,54 @@ metisMessage_GetContentObjectHashHash(MetisMessage *message, uint32_t *hashOutpu
     return false;
 }
 
+size_t
+metisMessage_ComputeContentObjectHashes(size_t count, MetisMessage *messages[])
+{
+    assertTrue(count == 0 || messages != NULL, "Parameter messages must be non-null");
+
+    const MetisTlvSkeleton *skeletons[METIS_TLV_HASH_BATCH_WIDTH];
+    MetisMessage *pending[METIS_TLV_HASH_BATCH_WIDTH];
+    PARCCryptoHash *hashes[METIS_TLV_HASH_BATCH_WIDTH];
+
+    size_t computed = 0;
+    size_t pendingCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        MetisMessage *message = messages[i];
+        assertNotNull(message, "Parameter messages[%zu] must be non-null", i);
+
+        // Only content objects are left without a hash, see _setupContentObjectHash()
+        if (message->hasContentObjectHash && message->contentObjectHash == NULL) {
+            skeletons[pendingCount] = &message->skeleton;
+            pending[pendingCount] = message;
+            pendingCount++;
+        }
+
+        if (pendingCount == METIS_TLV_HASH_BATCH_WIDTH || (pendingCount > 0 && i + 1 == count)) {
+            metisTlvSkeleton_ComputeContentObjectHashBatch(pendingCount, skeletons, hashes);
+            for (size_t j = 0; j < pendingCount; j++) {
+                pending[j]->contentObjectHash = parcBuffer_Acquire(parcCryptoHash_GetDigest(hashes[j]));
+                parcCryptoHash_Release(&hashes[j]);
+            }
+            computed += pendingCount;
+            pendingCount = 0;
+        }
+    }
+
+    return computed;
+}
+
 bool
 metisMessage_HasPublicKey(const MetisMessage *message)
 {
     assertNotNull(message, "Parameter message must be non-null");
-    return (message->publicKey != NULL);
+    return (metisTlvSkeleton_GetPublicKey(&message->skeleton).offset > 0);
 }
 
 bool
 metisMessage_HasCertificate(const MetisMessage *message)
 {
     assertNotNull(message, "Parameter message must be non-null");
-    return (message->certificate != NULL);
+    return (metisTlvSkeleton_GetCertificate(&message->skeleton).offset > 0);
 }
 
 bool
@@ -768,8 +837,7 @@ metisMessage_Slice(const MetisMessage *original, size_t offset, size_t length, s
                parcEventBuffer_GetLength(original->messageBytes),
                offset + length);
 
-    MetisMessage *message = parcMemory_AllocateAndClear(sizeof(MetisMessage));
-    assertNotNull(message, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisMessage));
+    MetisMessage *message = metisSlab_AllocateAndClear(sizeof(MetisMessage));
     message->receiveTime = original->receiveTime;
     message->ingressConnectionId = original->ingressConnectionId;
     message->messageBytes = parcEventBuffer_Create();
@@ -62,6 +62,8 @@
 #ifndef Metis_metis_Message_h
 #define Metis_metis_Message_h
 
+#include <sys/uio.h>
+
 #include <ccnx/forwarder/metis/core/metis_MessagePacketType.h>
 #include <ccnx/forwarder/metis/core/metis_StreamBuffer.h>
 #include <ccnx/forwarder/metis/tlv/metis_TlvName.h>
@@ -181,6 +183,27 @@ bool metisMessage_Write(PARCEventQueue *parcEventQueue, const MetisMessage *mess
  */
 bool metisMessage_Append(PARCEventBuffer *parcEventBuffer, const MetisMessage *message);
 
+/**
+ * Fills in an iovec that references the message's wire format bytes in place
+ *
+ * This lets a connection send the message with writev() or sendmsg() without first copying
+ * it to an output buffer.  The memory is owned by the message and is only valid while the
+ * caller holds a reference to the message.  The caller must not modify the memory.
+ *
+ * @param [in] message An allocated MetisMessage
+ * @param [out] vector The iovec to fill in
+ *
+ * Example:
+ * @code
+ * {
+ *     struct iovec vector;
+ *     metisMessage_GetIovec(message, &vector);
+ *     ssize_t nwritten = writev(fd, &vector, 1);
+ * }
+ * @endcode
+ */
+void metisMessage_GetIovec(const MetisMessage *message, struct iovec *vector);
+
 /**
  * Returns the total byte length of the message
  *
@@ -213,6 +236,27 @@ size_t metisMessage_Length(const MetisMessage *message);
  */
 unsigned metisMessage_GetIngressConnectionId(const MetisMessage *message);
 
+/**
+ * Sets the connection id of the packet input
+ *
+ * Used when a message is parsed before its connection is known, for example on a UDP
+ * ingress thread that hands the message to the dispatcher thread to resolve the peer.
+ * Only call before the message is passed to the forwarder.
+ *
+ * @param [in] message An allocated MetisMessage
+ * @param [in] ingressConnectionId The connection the message arrived on
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisMessage *message = metisMessage_CreateFromArray(packet, length, 0, ticks, logger);
+ *     metisMessage_SetIngressConnectionId(message, connid);
+ *     metisForwarder_Receive(metis, message);
+ * }
+ * @endcode
+ */
+void metisMessage_SetIngressConnectionId(MetisMessage *message, unsigned ingressConnectionId);
+
 /**
  * Returns the receive time (in router ticks) of the message
  *
@@ -443,6 +487,30 @@ bool metisMessage_ObjectHashEquals(MetisMessage *a, MetisMessage *b);
  */
 bool metisMessage_GetContentObjectHashHash(MetisMessage *message, uint32_t *hashOutput);
 
+/**
+ * Computes the ContentObjectHash of the content objects in an array
+ *
+ * The hash of a content object is normally computed the first time it is needed.  This computes
+ * the hashes not yet computed all at once, with metisTlvSkeleton_ComputeContentObjectHashBatch(),
+ * which is faster than one at a time.  Interests and control messages are skipped.
+ *
+ * @param [in] count The number of messages
+ * @param [in] messages The messages
+ *
+ * @return The number of hashes computed
+ *
+ * Example:
+ * @code
+ * {
+ *     metisMessage_ComputeContentObjectHashes(count, messages);
+ *     for (size_t i = 0; i < count; i++) {
+ *         metisPIT_SatisfyInterest(pit, messages[i], ingressSetUnion);
+ *     }
+ * }
+ * @endcode
+ */
+size_t metisMessage_ComputeContentObjectHashes(size_t count, MetisMessage *messages[]);
+
 /**
  * <#One Line Description#>
  *
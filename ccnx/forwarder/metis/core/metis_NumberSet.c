@@ -63,38 +63,52 @@
 
 #include <config.h>
 #include <stdio.h>
+#include <string.h>
 #include <parc/algol/parc_Memory.h>
 #include <ccnx/forwarder/metis/core/metis_NumberSet.h>
+#include <ccnx/forwarder/metis/core/metis_Slab.h>
 #include <parc/algol/parc_ArrayList.h>
 
 #include <LongBow/runtime.h>
 
-struct metis_number_set {
-    MetisNumber *arrayOfNumbers;
-    size_t length;
-    size_t limit;
-    unsigned refcount;
-};
-
 static void metisNumberSet_Expand(MetisNumberSet *set);
 
 MetisNumberSet *
 metisNumberSet_Create()
 {
-    MetisNumberSet *set = parcMemory_AllocateAndClear(sizeof(MetisNumberSet));
-    assertNotNull(set, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisNumberSet));
-    set->arrayOfNumbers = parcMemory_AllocateAndClear(sizeof(MetisNumber) * 16);
-    assertNotNull((set->arrayOfNumbers), "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisNumber) * 16);
-    set->length = 0;
-    set->limit = 16;
+    MetisNumberSet *set = metisSlab_Allocate(sizeof(MetisNumberSet));
+    metisNumberSet_Initialize(set);
     set->refcount = 1;
     return set;
 }
 
+void
+metisNumberSet_Initialize(MetisNumberSet *set)
+{
+    assertNotNull(set, "Parameter set must be non-null");
+    set->arrayOfNumbers = set->inlineNumbers;
+    set->length = 0;
+    set->limit = METIS_NUMBERSET_INLINE_LENGTH;
+    set->refcount = 0;
+}
+
+void
+metisNumberSet_Finalize(MetisNumberSet *set)
+{
+    assertNotNull(set, "Parameter set must be non-null");
+    if (set->arrayOfNumbers != set->inlineNumbers) {
+        metisSlab_Deallocate((void **) &(set->arrayOfNumbers), set->limit * sizeof(MetisNumber));
+    }
+    set->arrayOfNumbers = set->inlineNumbers;
+    set->length = 0;
+    set->limit = METIS_NUMBERSET_INLINE_LENGTH;
+}
+
 MetisNumberSet *
 metisNumberSet_Acquire(const MetisNumberSet *original)
 {
     assertNotNull(original, "Parameter original must be non-null");
+    assertTrue(original->refcount > 0, "Invalid state: cannot acquire a set from metisNumberSet_Initialize()");
     MetisNumberSet *copy = (MetisNumberSet *) original;
     copy->refcount++;
     return copy;
@@ -111,8 +125,8 @@ metisNumberSet_Release(MetisNumberSet **setPtr)
     set->refcount--;
 
     if (set->refcount == 0) {
-        parcMemory_Deallocate((void **) &(set->arrayOfNumbers));
-        parcMemory_Deallocate((void **) &set);
+        metisNumberSet_Finalize(set);
+        metisSlab_Deallocate((void **) &set, sizeof(MetisNumberSet));
         *setPtr = NULL;
     }
 }
@@ -263,6 +277,13 @@ metisNumberSet_Expand(MetisNumberSet *set)
     size_t newlimit = set->limit * 2;
     size_t newbytes = newlimit * sizeof(MetisNumber);
 
-    set->arrayOfNumbers = parcMemory_Reallocate(set->arrayOfNumbers, newbytes);
+    // the array is a metisSlab object (or inline), so no realloc; the size is part of how it is freed
+    MetisNumber *newArray = metisSlab_Allocate(newbytes);
+    memcpy(newArray, set->arrayOfNumbers, set->length * sizeof(MetisNumber));
+    if (set->arrayOfNumbers != set->inlineNumbers) {
+        metisSlab_Deallocate((void **) &(set->arrayOfNumbers), set->limit * sizeof(MetisNumber));
+    }
+
+    set->arrayOfNumbers = newArray;
     set->limit = newlimit;
 }
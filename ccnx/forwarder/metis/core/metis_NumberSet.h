@@ -59,6 +59,10 @@
  * Useful for things like the reverse path of a PIT
  * or the forward paths of a FIB.  Does not allow duplicates.
  *
+ * Most sets have only a few members, so the first METIS_NUMBERSET_INLINE_LENGTH numbers are
+ * stored in the set itself and only larger sets allocate an array.  The struct is declared here
+ * so a temporary set can live on the stack, see metisNumberSet_Initialize().
+ *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright (c) 2013-2014, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
  */
@@ -67,13 +71,32 @@
 #define Metis_metis_NumberSet_h
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <stdbool.h>
 
-struct metis_number_set;
-typedef struct metis_number_set MetisNumberSet;
-
 typedef uint32_t MetisNumber;
 
+/**
+ * The number of members a set holds without allocating
+ */
+#define METIS_NUMBERSET_INLINE_LENGTH 4
+
+/**
+ * The fields are private, use the functions below.
+ */
+struct metis_number_set {
+    // points to inlineNumbers until the set grows past METIS_NUMBERSET_INLINE_LENGTH
+    MetisNumber *arrayOfNumbers;
+    size_t length;
+    size_t limit;
+
+    // 0 for a set from metisNumberSet_Initialize(), which is not reference counted
+    unsigned refcount;
+
+    MetisNumber inlineNumbers[METIS_NUMBERSET_INLINE_LENGTH];
+};
+typedef struct metis_number_set MetisNumberSet;
+
 /**
  * @function metisNumberList_Create
  * @abstract A new list of numbers
@@ -85,6 +108,43 @@ typedef uint32_t MetisNumber;
  */
 MetisNumberSet *metisNumberSet_Create(void);
 
+/**
+ * Sets up a set in caller-provided memory, usually a temporary on the stack
+ *
+ * Such a set is not reference counted, so do not Acquire or Release it.  Call
+ * metisNumberSet_Finalize() when done with it, which frees the array if the set grew
+ * past METIS_NUMBERSET_INLINE_LENGTH.
+ *
+ * @param [in] set Memory for the set
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisNumberSet nexthops;
+ *     metisNumberSet_Initialize(&nexthops);
+ *     metisNumberSet_Add(&nexthops, 7);
+ *     metisNumberSet_Finalize(&nexthops);
+ * }
+ * @endcode
+ */
+void metisNumberSet_Initialize(MetisNumberSet *set);
+
+/**
+ * Frees anything a set from metisNumberSet_Initialize() allocated.  The set is empty afterwards.
+ *
+ * @param [in] set A set from metisNumberSet_Initialize()
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisNumberSet nexthops;
+ *     metisNumberSet_Initialize(&nexthops);
+ *     metisNumberSet_Finalize(&nexthops);
+ * }
+ * @endcode
+ */
+void metisNumberSet_Finalize(MetisNumberSet *set);
+
 /**
  * Obtains a reference counted copy of the original
  *
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * Each thread has a _MetisSlabCache, created on its first allocation or free and registered with a
+ * pthread key so it is drained when the thread exits.  A free object's first word links it in to the
+ * free list for its size, so the cache costs nothing per object.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <ccnx/forwarder/metis/core/metis_Slab.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <LongBow/runtime.h>
+
+#define METIS_SLAB_CLASSES (METIS_SLAB_MAX_OBJECT_SIZE / METIS_SLAB_GRANULARITY)
+
+typedef struct metis_slab_free_object {
+    struct metis_slab_free_object *next;
+} _MetisSlabFreeObject;
+
+typedef struct metis_slab_cache {
+    _MetisSlabFreeObject *freeLists[METIS_SLAB_CLASSES];
+    unsigned freeCounts[METIS_SLAB_CLASSES];
+} _MetisSlabCache;
+
+static bool _enabled = false;
+
+static pthread_once_t _keyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t _cacheKey;
+static __thread _MetisSlabCache *_threadCache = NULL;
+
+static void
+_releaseCache(_MetisSlabCache *cache)
+{
+    for (int class = 0; class < METIS_SLAB_CLASSES; class++) {
+        while (cache->freeLists[class] != NULL) {
+            _MetisSlabFreeObject *object = cache->freeLists[class];
+            cache->freeLists[class] = object->next;
+            parcMemory_Deallocate((void **) &object);
+        }
+        cache->freeCounts[class] = 0;
+    }
+}
+
+/**
+ * pthread key destructor, runs when a thread with a cache exits
+ */
+static void
+_threadExit(void *cacheVoid)
+{
+    _MetisSlabCache *cache = (_MetisSlabCache *) cacheVoid;
+    _releaseCache(cache);
+    parcMemory_Deallocate((void **) &cache);
+}
+
+static void
+_createKey(void)
+{
+    int failure = pthread_key_create(&_cacheKey, _threadExit);
+    assertFalse(failure, "pthread_key_create failed: (%d) %s", failure, strerror(failure));
+}
+
+static _MetisSlabCache *
+_getCache(void)
+{
+    if (_threadCache == NULL) {
+        pthread_once(&_keyOnce, _createKey);
+
+        _threadCache = parcMemory_AllocateAndClear(sizeof(_MetisSlabCache));
+        assertNotNull(_threadCache, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_MetisSlabCache));
+        pthread_setspecific(_cacheKey, _threadCache);
+    }
+    return _threadCache;
+}
+
+static size_t
+_roundedSize(size_t size)
+{
+    return (size + METIS_SLAB_GRANULARITY - 1) & ~((size_t) METIS_SLAB_GRANULARITY - 1);
+}
+
+/**
+ * The free list index for a size.  Only valid for 0 < size <= METIS_SLAB_MAX_OBJECT_SIZE.
+ */
+static int
+_sizeClass(size_t size)
+{
+    return (int) (_roundedSize(size) / METIS_SLAB_GRANULARITY) - 1;
+}
+
+// =====================================================================
+
+void
+metisSlab_SetEnabled(bool enabled)
+{
+    __atomic_store_n(&_enabled, enabled, __ATOMIC_RELAXED);
+}
+
+bool
+metisSlab_IsEnabled(void)
+{
+    return __atomic_load_n(&_enabled, __ATOMIC_RELAXED);
+}
+
+void *
+metisSlab_Allocate(size_t size)
+{
+    assertTrue(size > 0, "Parameter size must be positive");
+
+    if (size > METIS_SLAB_MAX_OBJECT_SIZE) {
+        void *pointer = parcMemory_Allocate(size);
+        assertNotNull(pointer, "parcMemory_Allocate(%zu) returned NULL", size);
+        return pointer;
+    }
+
+    if (metisSlab_IsEnabled()) {
+        _MetisSlabCache *cache = _getCache();
+        int class = _sizeClass(size);
+        _MetisSlabFreeObject *object = cache->freeLists[class];
+        if (object != NULL) {
+            cache->freeLists[class] = object->next;
+            cache->freeCounts[class]--;
+            return object;
+        }
+    }
+
+    // Always allocate the rounded size, so the object can go in a cache when it is freed
+    size_t rounded = _roundedSize(size);
+    void *pointer = parcMemory_Allocate(rounded);
+    assertNotNull(pointer, "parcMemory_Allocate(%zu) returned NULL", rounded);
+    return pointer;
+}
+
+void *
+metisSlab_AllocateAndClear(size_t size)
+{
+    void *pointer = metisSlab_Allocate(size);
+    memset(pointer, 0, size);
+    return pointer;
+}
+
+void
+metisSlab_Deallocate(void **pointerPtr, size_t size)
+{
+    assertNotNull(pointerPtr, "Parameter must be non-null double pointer");
+    assertNotNull(*pointerPtr, "Parameter must dereference to non-null pointer");
+    assertTrue(size > 0, "Parameter size must be positive");
+
+    if (size <= METIS_SLAB_MAX_OBJECT_SIZE && metisSlab_IsEnabled()) {
+        _MetisSlabCache *cache = _getCache();
+        int class = _sizeClass(size);
+        if (cache->freeCounts[class] < METIS_SLAB_CACHE_LIMIT) {
+            _MetisSlabFreeObject *object = (_MetisSlabFreeObject *) *pointerPtr;
+            object->next = cache->freeLists[class];
+            cache->freeLists[class] = object;
+            cache->freeCounts[class]++;
+            *pointerPtr = NULL;
+            return;
+        }
+    }
+
+    parcMemory_Deallocate(pointerPtr);
+}
+
+void
+metisSlab_Drain(void)
+{
+    if (_threadCache != NULL) {
+        pthread_setspecific(_cacheKey, NULL);
+        _releaseCache(_threadCache);
+        parcMemory_Deallocate((void **) &_threadCache);
+    }
+}
+
+size_t
+metisSlab_CachedCount(void)
+{
+    size_t count = 0;
+    if (_threadCache != NULL) {
+        for (int class = 0; class < METIS_SLAB_CLASSES; class++) {
+            count += _threadCache->freeCounts[class];
+        }
+    }
+    return count;
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_Slab.h
+ * @brief Per-thread caches of small fixed-size objects
+ *
+ * The forwarder allocates and frees several small objects for every packet: the MetisMessage,
+ * its MetisTlvName, PIT entries and number sets.  metisSlab_Allocate() and metisSlab_Deallocate()
+ * stand in for parcMemory_Allocate() and parcMemory_Deallocate() for such objects.  Sizes are
+ * rounded up to a multiple of METIS_SLAB_GRANULARITY, and each thread keeps a free list for each
+ * rounded size up to METIS_SLAB_MAX_OBJECT_SIZE.  A freed object goes on the free list of the thread
+ * that frees it, so an object may be allocated on an I/O thread and freed on a worker thread.
+ * Larger objects go straight to parcMemory.
+ *
+ * Caching is off until metisSlab_SetEnabled(true).  Until then every call goes to parcMemory, so the
+ * unit tests' parcSafeMemory leak checks see every object.  The caller must pass the same size to
+ * metisSlab_Deallocate() that it passed to metisSlab_Allocate().
+ *
+ * A thread's cache is released when the thread exits.  The main thread should call
+ * metisSlab_Drain() before it exits if it wants a clean leak report.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_Slab_h
+#define Metis_metis_Slab_h
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * Object sizes are rounded up to a multiple of this many bytes
+ */
+#define METIS_SLAB_GRANULARITY 16
+
+/**
+ * Objects larger than this are not cached
+ */
+#define METIS_SLAB_MAX_OBJECT_SIZE 512
+
+/**
+ * The most free objects of one size that a thread keeps.  Beyond that, freed objects go back to parcMemory.
+ */
+#define METIS_SLAB_CACHE_LIMIT 1024
+
+/**
+ * Turns the per-thread caches on or off for the whole process
+ *
+ * Turning them off does not drain any thread's cache, see metisSlab_Drain().
+ *
+ * @param [in] enabled true to cache freed objects
+ *
+ * Example:
+ * @code
+ * {
+ *     // in main(), before any threads start
+ *     metisSlab_SetEnabled(true);
+ * }
+ * @endcode
+ */
+void metisSlab_SetEnabled(bool enabled);
+
+/**
+ * Determines if the per-thread caches are on
+ *
+ * @return true if metisSlab_SetEnabled(true) was called last
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+bool metisSlab_IsEnabled(void);
+
+/**
+ * Allocates an object, from the calling thread's cache if possible
+ *
+ * The memory is not cleared.
+ *
+ * @param [in] size The size of the object in bytes
+ *
+ * @return non-null The object, release it with metisSlab_Deallocate() and the same size
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisPitEntry *entry = metisSlab_Allocate(sizeof(MetisPitEntry));
+ *     metisSlab_Deallocate((void **) &entry, sizeof(MetisPitEntry));
+ * }
+ * @endcode
+ */
+void *metisSlab_Allocate(size_t size);
+
+/**
+ * Allocates an object, like metisSlab_Allocate(), and clears it to zero
+ *
+ * @param [in] size The size of the object in bytes
+ *
+ * @return non-null The object, release it with metisSlab_Deallocate() and the same size
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisPitEntry *entry = metisSlab_AllocateAndClear(sizeof(MetisPitEntry));
+ *     metisSlab_Deallocate((void **) &entry, sizeof(MetisPitEntry));
+ * }
+ * @endcode
+ */
+void *metisSlab_AllocateAndClear(size_t size);
+
+/**
+ * Frees an object from metisSlab_Allocate(), in to the calling thread's cache if possible
+ *
+ * @param [in,out] pointerPtr Pointer to the object, will be NULL'd
+ * @param [in] size The size passed to metisSlab_Allocate()
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisPitEntry *entry = metisSlab_Allocate(sizeof(MetisPitEntry));
+ *     metisSlab_Deallocate((void **) &entry, sizeof(MetisPitEntry));
+ * }
+ * @endcode
+ */
+void metisSlab_Deallocate(void **pointerPtr, size_t size);
+
+/**
+ * Releases every object in the calling thread's cache back to parcMemory
+ *
+ * Example:
+ * @code
+ * {
+ *     metisForwarder_Destroy(&metis);
+ *     metisSlab_Drain();
+ * }
+ * @endcode
+ */
+void metisSlab_Drain(void);
+
+/**
+ * The number of free objects in the calling thread's cache, of every size
+ *
+ * @return The number of cached objects
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+size_t metisSlab_CachedCount(void);
+#endif // Metis_metis_Slab_h
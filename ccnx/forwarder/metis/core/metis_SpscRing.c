@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * The producer owns `tail` and the consumer owns `head`.  Each side publishes its index with a
+ * release store and reads the other side's index with an acquire load, so a slot's contents are
+ * visible before the index that covers it.  `cachedHead` and `cachedTail` are private copies of
+ * the other side's index, refreshed only when the ring looks full (or empty).
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include <ccnx/forwarder/metis/core/metis_SpscRing.h>
+#include <ccnx/forwarder/metis/core/metis_CacheLine.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <LongBow/runtime.h>
+
+typedef struct metis_spsc_slot {
+    void *item;
+    unsigned value;
+} _MetisSpscSlot;
+
+struct metis_spsc_ring {
+    _MetisSpscSlot *slots;
+    size_t mask;
+
+    // written by the producer
+    size_t tail __attribute__((aligned(METIS_CACHE_LINE_SIZE)));
+    size_t cachedHead;
+
+    // written by the consumer
+    size_t head __attribute__((aligned(METIS_CACHE_LINE_SIZE)));
+    size_t cachedTail;
+};
+
+MetisSpscRing *
+metisSpscRing_Create(size_t capacity)
+{
+    assertTrue(capacity > 0, "Parameter capacity must be positive");
+
+    size_t slotCount = 1;
+    while (slotCount < capacity) {
+        slotCount <<= 1;
+    }
+
+    MetisSpscRing *ring = parcMemory_AllocateAndClear(sizeof(MetisSpscRing));
+    assertNotNull(ring, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisSpscRing));
+
+    ring->slots = parcMemory_AllocateAndClear(slotCount * sizeof(_MetisSpscSlot));
+    assertNotNull(ring->slots, "parcMemory_AllocateAndClear(%zu) returned NULL", slotCount * sizeof(_MetisSpscSlot));
+    ring->mask = slotCount - 1;
+    return ring;
+}
+
+void
+metisSpscRing_Destroy(MetisSpscRing **ringPtr)
+{
+    assertNotNull(ringPtr, "Parameter must be non-null double pointer");
+    assertNotNull(*ringPtr, "Parameter must dereference to non-null pointer");
+
+    MetisSpscRing *ring = *ringPtr;
+    parcMemory_Deallocate((void **) &ring->slots);
+    parcMemory_Deallocate((void **) &ring);
+    *ringPtr = NULL;
+}
+
+bool
+metisSpscRing_Push(MetisSpscRing *ring, void *item, unsigned value)
+{
+    assertNotNull(item, "Parameter item must be non-null");
+
+    size_t tail = ring->tail;
+    if (tail - ring->cachedHead > ring->mask) {
+        ring->cachedHead = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        if (tail - ring->cachedHead > ring->mask) {
+            return false;
+        }
+    }
+
+    _MetisSpscSlot *slot = &ring->slots[tail & ring->mask];
+    slot->item = item;
+    slot->value = value;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+void *
+metisSpscRing_Pop(MetisSpscRing *ring, unsigned *valuePtr)
+{
+    size_t head = ring->head;
+    if (head == ring->cachedTail) {
+        ring->cachedTail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (head == ring->cachedTail) {
+            return NULL;
+        }
+    }
+
+    _MetisSpscSlot *slot = &ring->slots[head & ring->mask];
+    void *item = slot->item;
+    if (valuePtr != NULL) {
+        *valuePtr = slot->value;
+    }
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return item;
+}
+
+size_t
+metisSpscRing_Capacity(const MetisSpscRing *ring)
+{
+    return ring->mask + 1;
+}
+
+size_t
+metisSpscRing_Count(const MetisSpscRing *ring)
+{
+    size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    return tail - head;
+}
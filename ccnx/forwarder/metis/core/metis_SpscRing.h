@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_SpscRing.h
+ * @brief A bounded lock-free queue between exactly one producer thread and one consumer thread
+ *
+ * Each slot carries a pointer and an unsigned value, so a caller can pass a message together with
+ * a connection id without allocating a wrapper.  The capacity is rounded up to a power of 2.
+ *
+ * Only one thread may call Push and only one thread may call Pop.  The producer and consumer
+ * indexes are on separate cache lines and each side caches the other's index, so in the common
+ * case a Push or Pop does not touch a cache line owned by the other thread.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_SpscRing_h
+#define Metis_metis_SpscRing_h
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+struct metis_spsc_ring;
+typedef struct metis_spsc_ring MetisSpscRing;
+
+/**
+ * Creates an empty ring
+ *
+ * @param [in] capacity The minimum number of slots, rounded up to a power of 2
+ *
+ * @return non-null An allocated ring
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisSpscRing *ring = metisSpscRing_Create(1024);
+ *     metisSpscRing_Destroy(&ring);
+ * }
+ * @endcode
+ */
+MetisSpscRing *metisSpscRing_Create(size_t capacity);
+
+/**
+ * Destroys the ring.  Items still in the ring are not touched, so the caller should drain it first.
+ *
+ * @param [in,out] ringPtr Pointer to the ring, will be NULL'd
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisSpscRing *ring = metisSpscRing_Create(1024);
+ *     metisSpscRing_Destroy(&ring);
+ * }
+ * @endcode
+ */
+void metisSpscRing_Destroy(MetisSpscRing **ringPtr);
+
+/**
+ * Appends an item.  Producer thread only.
+ *
+ * @param [in] ring An allocated ring
+ * @param [in] item The pointer to pass, may not be NULL
+ * @param [in] value Passed along with the item
+ *
+ * @return true The item was queued
+ * @return false The ring is full, the item was not queued
+ *
+ * Example:
+ * @code
+ * {
+ *     if (!metisSpscRing_Push(ring, metisMessage_Acquire(message), connectionId)) {
+ *         metisMessage_Release(&message);
+ *     }
+ * }
+ * @endcode
+ */
+bool metisSpscRing_Push(MetisSpscRing *ring, void *item, unsigned value);
+
+/**
+ * Removes the oldest item.  Consumer thread only.
+ *
+ * @param [in] ring An allocated ring
+ * @param [out] valuePtr If not NULL, receives the value pushed with the item
+ *
+ * @return non-null The oldest item
+ * @return null The ring is empty
+ *
+ * Example:
+ * @code
+ * {
+ *     unsigned connectionId;
+ *     MetisMessage *message;
+ *     while ((message = metisSpscRing_Pop(ring, &connectionId)) != NULL) {
+ *         // ...
+ *     }
+ * }
+ * @endcode
+ */
+void *metisSpscRing_Pop(MetisSpscRing *ring, unsigned *valuePtr);
+
+/**
+ * The number of slots in the ring
+ *
+ * @param [in] ring An allocated ring
+ *
+ * @return The capacity, a power of 2
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisSpscRing *ring = metisSpscRing_Create(1000);
+ *     assertTrue(metisSpscRing_Capacity(ring) == 1024, "Wrong capacity");
+ * }
+ * @endcode
+ */
+size_t metisSpscRing_Capacity(const MetisSpscRing *ring);
+
+/**
+ * The number of items in the ring
+ *
+ * If called from a thread that is neither the producer nor the consumer, the result is only a snapshot.
+ *
+ * @param [in] ring An allocated ring
+ *
+ * @return The number of queued items
+ *
+ * Example:
+ * @code
+ * {
+ *     if (metisSpscRing_Count(ring) == 0) {
+ *         // idle
+ *     }
+ * }
+ * @endcode
+ */
+size_t metisSpscRing_Count(const MetisSpscRing *ring);
+#endif // Metis_metis_SpscRing_h
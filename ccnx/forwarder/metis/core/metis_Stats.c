@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ccnx/forwarder/metis/core/metis_Stats.h>
+#include <ccnx/api/control/controlPlaneInterface.h>
+
+#include <LongBow/runtime.h>
+
+static const char *_metisStatsNames[MetisStat_END] = {
+    [MetisStat_Received]                      = "processor.received",
+    [MetisStat_InterestsReceived]             = "processor.interestsReceived",
+    [MetisStat_ObjectsReceived]               = "processor.objectsReceived",
+    [MetisStat_InterestsAggregated]           = "processor.interestsAggregated",
+    [MetisStat_InterestsForwarded]            = "processor.interestsForwarded",
+    [MetisStat_ObjectsForwarded]              = "processor.objectsForwarded",
+    [MetisStat_InterestsSatisfiedFromStore]   = "processor.interestsSatisfiedFromStore",
+    [MetisStat_Dropped]                       = "processor.dropped",
+    [MetisStat_InterestsDropped]              = "processor.interestsDropped",
+    [MetisStat_ObjectsDropped]                = "processor.objectsDropped",
+    [MetisStat_DroppedNoRoute]                = "processor.droppedNoRoute",
+    [MetisStat_DroppedNoReversePath]          = "processor.droppedNoReversePath",
+    [MetisStat_DroppedConnectionNotFound]     = "processor.droppedConnectionNotFound",
+    [MetisStat_DroppedNoHopLimit]             = "processor.droppedNoHopLimit",
+    [MetisStat_DroppedZeroHopLimitFromRemote] = "processor.droppedZeroHopLimitFromRemote",
+    [MetisStat_DroppedZeroHopLimitToRemote]   = "processor.droppedZeroHopLimitToRemote",
+    [MetisStat_SendFailures]                  = "processor.sendFailures",
+
+    [MetisStat_ContentStoreAdds]              = "contentStore.adds",
+    [MetisStat_ContentStoreHits]              = "contentStore.hits",
+    [MetisStat_ContentStoreMisses]            = "contentStore.misses",
+    [MetisStat_ContentStoreLruEvictions]      = "contentStore.lruEvictions",
+    [MetisStat_ContentStoreExpiryEvictions]   = "contentStore.expiryEvictions",
+    [MetisStat_ContentStoreRctEvictions]      = "contentStore.rctEvictions",
+    [MetisStat_ContentStoreDemotions]         = "contentStore.demotions",
+    [MetisStat_ContentStorePromotions]        = "contentStore.promotions",
+    [MetisStat_ContentStoreAdmissionRejects]  = "contentStore.admissionRejects",
+
+    [MetisStat_DiskStoreAdds]                 = "diskStore.adds",
+    [MetisStat_DiskStoreHits]                 = "diskStore.hits",
+    [MetisStat_DiskStoreMisses]               = "diskStore.misses",
+    [MetisStat_DiskStoreRecovered]            = "diskStore.recovered",
+    [MetisStat_DiskStoreSegmentEvictions]     = "diskStore.segmentEvictions",
+
+    [MetisStat_UdpFramesIn]                   = "udp.framesIn",
+    [MetisStat_UdpFramesError]                = "udp.framesError",
+    [MetisStat_UdpFramesReceived]             = "udp.framesReceived",
+    [MetisStat_UdpReadBatches]                = "udp.readBatches",
+    [MetisStat_UdpBatchesDropped]             = "udp.batchesDropped",
+};
+
+void
+metisStats_Init(MetisStats *stats)
+{
+    assertNotNull(stats, "Parameter stats must be non-null");
+    memset(stats, 0, sizeof(MetisStats));
+}
+
+const char *
+metisStats_Name(MetisStat stat)
+{
+    assertTrue(stat < MetisStat_END, "Invalid stat %d", stat);
+    return _metisStatsNames[stat];
+}
+
+PARCJSON *
+metisStats_ToJson(const MetisStats *stats)
+{
+    assertNotNull(stats, "Parameter stats must be non-null");
+
+    PARCJSON *json = parcJSON_Create();
+    for (MetisStat stat = 0; stat < MetisStat_END; stat++) {
+        parcJSON_AddInteger(json, _metisStatsNames[stat], (int64_t) stats->values[stat]);
+    }
+    return json;
+}
+
+void
+metisStats_FromJson(MetisStats *stats, const PARCJSON *json)
+{
+    assertNotNull(stats, "Parameter stats must be non-null");
+    assertNotNull(json, "Parameter json must be non-null");
+
+    for (MetisStat stat = 0; stat < MetisStat_END; stat++) {
+        PARCJSONValue *value = parcJSON_GetValueByName(json, _metisStatsNames[stat]);
+        if (value != NULL && parcJSONValue_IsNumber(value)) {
+            stats->values[stat] = (uint64_t) parcJSONValue_GetInteger(value);
+        } else {
+            stats->values[stat] = 0;
+        }
+    }
+}
+
+double
+metisStats_ContentStoreHitRatio(const MetisStats *stats)
+{
+    assertNotNull(stats, "Parameter stats must be non-null");
+
+    uint64_t lookups = stats->values[MetisStat_ContentStoreHits] + stats->values[MetisStat_ContentStoreMisses];
+    if (lookups == 0) {
+        return 0.0;
+    }
+    return (double) stats->values[MetisStat_ContentStoreHits] / (double) lookups;
+}
+
+PARCJSON *
+metisStats_GetCPIOperation(CCNxControl *control, const char *envelope, const char *operationName)
+{
+    PARCJSONValue *value = parcJSON_GetValueByName(ccnxControl_GetJson(control), envelope);
+    if (value == NULL || !parcJSONValue_IsJSON(value)) {
+        return NULL;
+    }
+
+    value = parcJSON_GetValueByName(parcJSONValue_GetJSON(value), operationName);
+    if (value == NULL || !parcJSONValue_IsJSON(value)) {
+        return NULL;
+    }
+    return parcJSONValue_GetJSON(value);
+}
+
+CCNxControl *
+metisStats_CreateCPIMessage(const char *envelope, uint64_t sequence, const char *operationName, PARCJSON *operation)
+{
+    PARCJSON *inner = parcJSON_Create();
+    parcJSON_AddInteger(inner, "SEQUENCE", (int64_t) sequence);
+    parcJSON_AddObject(inner, operationName, operation);
+
+    PARCJSON *json = parcJSON_Create();
+    parcJSON_AddObject(json, envelope, inner);
+
+    CCNxControl *control = ccnxControl_CreateCPIRequest(json);
+    parcJSON_Release(&json);
+    parcJSON_Release(&inner);
+    return control;
+}
+
+CCNxControl *
+metisStats_CreateCPIRequest(void)
+{
+    PARCJSON *operation = parcJSON_Create();
+    CCNxControl *request = metisStats_CreateCPIMessage("CPI_REQUEST", cpi_GetNextSequenceNumber(), METIS_STATS_CPI_OPERATION, operation);
+    parcJSON_Release(&operation);
+    return request;
+}
+
+bool
+metisStats_IsCPIRequest(CCNxControl *control)
+{
+    assertNotNull(control, "Parameter control must be non-null");
+    return metisStats_GetCPIOperation(control, "CPI_REQUEST", METIS_STATS_CPI_OPERATION) != NULL;
+}
+
+CCNxControl *
+metisStats_CreateCPIResponse(CCNxControl *request, const MetisStats *stats)
+{
+    assertNotNull(request, "Parameter request must be non-null");
+    assertNotNull(stats, "Parameter stats must be non-null");
+
+    PARCJSON *operation = metisStats_ToJson(stats);
+    CCNxControl *response = metisStats_CreateCPIMessage("CPI_RESPONSE", cpi_GetSequenceNumber(request), METIS_STATS_CPI_OPERATION, operation);
+    parcJSON_Release(&operation);
+    return response;
+}
+
+bool
+metisStats_FromCPIResponse(MetisStats *stats, CCNxControl *response)
+{
+    assertNotNull(stats, "Parameter stats must be non-null");
+    assertNotNull(response, "Parameter response must be non-null");
+
+    PARCJSON *operation = metisStats_GetCPIOperation(response, "CPI_RESPONSE", METIS_STATS_CPI_OPERATION);
+    if (operation == NULL) {
+        return false;
+    }
+
+    metisStats_FromJson(stats, operation);
+    return true;
+}
@@ -0,0 +1,344 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_Stats.h
+ * @brief The forwarder's event counters, as one snapshot
+ *
+ * Each module keeps its own counters in a block written by only one thread: the message processor
+ * (or each shard of it), its content stores, and each UDP ingress thread.  The owning thread
+ * updates a counter with metisStats_Increment() or metisStats_Add(), which are relaxed atomic
+ * stores and so cost the same as a plain increment.  Any other thread may read the counter with
+ * metisStats_Read() without tearing it.  The blocks are padded to their own cache lines, with
+ * METIS_CACHE_LINE_SIZE from metis_CacheLine.h, so one thread's counting does not slow the others down.
+ *
+ * Nothing is summed until someone asks.  metisForwarder_GetStats() walks the modules and adds each
+ * block in to a MetisStats, which is what the METIS_STATS control command returns.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_Stats_h
+#define Metis_metis_Stats_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <parc/algol/parc_JSON.h>
+#include <ccnx/api/control/ccnxControl.h>
+
+/**
+ * Adds `n` to a counter.  Only the thread that owns the counter may call this.
+ */
+#define metisStats_Add(counter, n) \
+    __atomic_store_n(&(counter), __atomic_load_n(&(counter), __ATOMIC_RELAXED) + (n), __ATOMIC_RELAXED)
+
+/**
+ * Adds one to a counter.  Only the thread that owns the counter may call this.
+ */
+#define metisStats_Increment(counter) metisStats_Add(counter, 1)
+
+/**
+ * Reads a counter, from any thread
+ */
+#define metisStats_Read(counter) __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+
+/**
+ * The operation name of the Metis-specific CPI request for the forwarder's counters,
+ * {"CPI_REQUEST":{"SEQUENCE":n,"METIS_STATS":{}}}
+ */
+#define METIS_STATS_CPI_OPERATION "METIS_STATS"
+
+/**
+ * The counters in a MetisStats.  The order is the order metis_control prints them.
+ */
+typedef enum {
+    MetisStat_Received,
+    MetisStat_InterestsReceived,
+    MetisStat_ObjectsReceived,
+    MetisStat_InterestsAggregated,
+    MetisStat_InterestsForwarded,
+    MetisStat_ObjectsForwarded,
+    MetisStat_InterestsSatisfiedFromStore,
+    MetisStat_Dropped,
+    MetisStat_InterestsDropped,
+    MetisStat_ObjectsDropped,
+    MetisStat_DroppedNoRoute,
+    MetisStat_DroppedNoReversePath,
+    MetisStat_DroppedConnectionNotFound,
+    MetisStat_DroppedNoHopLimit,
+    MetisStat_DroppedZeroHopLimitFromRemote,
+    MetisStat_DroppedZeroHopLimitToRemote,
+    MetisStat_SendFailures,
+
+    MetisStat_ContentStoreAdds,
+    MetisStat_ContentStoreHits,
+    MetisStat_ContentStoreMisses,
+    MetisStat_ContentStoreLruEvictions,
+    MetisStat_ContentStoreExpiryEvictions,
+    MetisStat_ContentStoreRctEvictions,
+    MetisStat_ContentStoreDemotions,
+    MetisStat_ContentStorePromotions,
+    MetisStat_ContentStoreAdmissionRejects,
+
+    MetisStat_DiskStoreAdds,
+    MetisStat_DiskStoreHits,
+    MetisStat_DiskStoreMisses,
+    MetisStat_DiskStoreRecovered,
+    MetisStat_DiskStoreSegmentEvictions,
+
+    MetisStat_UdpFramesIn,
+    MetisStat_UdpFramesError,
+    MetisStat_UdpFramesReceived,
+    MetisStat_UdpReadBatches,
+    MetisStat_UdpBatchesDropped,
+
+    MetisStat_END
+} MetisStat;
+
+/**
+ * A snapshot of the counters, summed over every thread
+ */
+typedef struct metis_stats {
+    uint64_t values[MetisStat_END];
+} MetisStats;
+
+/**
+ * Zeros every counter in the snapshot
+ *
+ * @param [in] stats The snapshot to clear
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisStats stats;
+ *     metisStats_Init(&stats);
+ *     metisForwarder_GetStats(metis, &stats);
+ * }
+ * @endcode
+ */
+void metisStats_Init(MetisStats *stats);
+
+/**
+ * The name of a counter, such as "processor.interestsReceived"
+ *
+ * The name is the key used in the JSON form of the snapshot.
+ *
+ * @param [in] stat A counter, less than MetisStat_END
+ *
+ * @return non-null A static string
+ *
+ * Example:
+ * @code
+ * {
+ *     printf("%s %" PRIu64 "\n", metisStats_Name(MetisStat_Received), stats.values[MetisStat_Received]);
+ * }
+ * @endcode
+ */
+const char *metisStats_Name(MetisStat stat);
+
+/**
+ * Creates a JSON object with one member for each counter
+ *
+ * @param [in] stats The snapshot
+ *
+ * @return non-null A JSON object, release it with parcJSON_Release()
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCJSON *json = metisStats_ToJson(&stats);
+ *     char *str = parcJSON_ToString(json);
+ *     puts(str);
+ *     parcMemory_Deallocate((void **) &str);
+ *     parcJSON_Release(&json);
+ * }
+ * @endcode
+ */
+PARCJSON *metisStats_ToJson(const MetisStats *stats);
+
+/**
+ * Fills a snapshot from the JSON object made by metisStats_ToJson()
+ *
+ * Counters missing from the JSON are set to 0, so a newer forwarder and an older metis_control
+ * (or the reverse) still understand each other.
+ *
+ * @param [in] stats The snapshot to fill
+ * @param [in] json A JSON object from metisStats_ToJson()
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+void metisStats_FromJson(MetisStats *stats, const PARCJSON *json);
+
+/**
+ * The share of content store lookups that were hits, hits / (hits + misses)
+ *
+ * Use it to compare the content store policies on the same traffic.
+ *
+ * @param [in] stats The snapshot
+ *
+ * @return The hit ratio, from 0 to 1.  0 if there were no lookups.
+ *
+ * Example:
+ * @code
+ * {
+ *     printf("hit ratio %.4f\n", metisStats_ContentStoreHitRatio(&stats));
+ * }
+ * @endcode
+ */
+double metisStats_ContentStoreHitRatio(const MetisStats *stats);
+
+/**
+ * Creates a Metis-specific CPI message, {envelope:{"SEQUENCE":sequence,operationName:operation}}
+ *
+ * The CPI operations are an enum in the ccnx library, so Metis's own operations are made and
+ * recognized by name with this and metisStats_GetCPIOperation().
+ *
+ * @param [in] envelope "CPI_REQUEST" or "CPI_RESPONSE"
+ * @param [in] sequence The CPI sequence number
+ * @param [in] operationName The operation, such as METIS_STATS_CPI_OPERATION
+ * @param [in] operation The operation's parameters or results
+ *
+ * @return non-null A CPI control message, release it with ccnxControl_Release()
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+CCNxControl *metisStats_CreateCPIMessage(const char *envelope, uint64_t sequence, const char *operationName, PARCJSON *operation);
+
+/**
+ * Finds the operation made by metisStats_CreateCPIMessage() in a CPI control message
+ *
+ * @param [in] control A CPI control message
+ * @param [in] envelope "CPI_REQUEST" or "CPI_RESPONSE"
+ * @param [in] operationName The operation to look for
+ *
+ * @return non-null The operation's JSON object, owned by `control`
+ * @return null `control` is not that operation
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+PARCJSON *metisStats_GetCPIOperation(CCNxControl *control, const char *envelope, const char *operationName);
+
+/**
+ * Creates the CPI request for the forwarder's counters
+ *
+ * @return non-null A CPI_REQUEST with the next CPI sequence number, release it with ccnxControl_Release()
+ *
+ * Example:
+ * @code
+ * {
+ *     CCNxControl *request = metisStats_CreateCPIRequest();
+ *     CCNxControl *response = metisConfiguration_ReceiveControl(config, request, 0);
+ *     ccnxControl_Release(&response);
+ *     ccnxControl_Release(&request);
+ * }
+ * @endcode
+ */
+CCNxControl *metisStats_CreateCPIRequest(void);
+
+/**
+ * Determines if a CPI control message is the request made by metisStats_CreateCPIRequest()
+ *
+ * @param [in] control A CPI control message
+ *
+ * @return true if it is a CPI_REQUEST for METIS_STATS_CPI_OPERATION
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+bool metisStats_IsCPIRequest(CCNxControl *control);
+
+/**
+ * Creates the CPI response to metisStats_CreateCPIRequest()
+ *
+ * @param [in] request The request, for its sequence number
+ * @param [in] stats The snapshot to return
+ *
+ * @return non-null A CPI_RESPONSE, release it with ccnxControl_Release()
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+CCNxControl *metisStats_CreateCPIResponse(CCNxControl *request, const MetisStats *stats);
+
+/**
+ * Fills a snapshot from the response made by metisStats_CreateCPIResponse()
+ *
+ * @param [in] stats The snapshot to fill
+ * @param [in] response A CPI control message
+ *
+ * @return true if `response` carried the counters
+ * @return false if it did not (for example, a NACK from a forwarder without the command), `stats` is unchanged
+ *
+ * Example:
+ * @code
+ * <#example#>
+ * @endcode
+ */
+bool metisStats_FromCPIResponse(MetisStats *stats, CCNxControl *response);
+#endif // Metis_metis_Stats_h
@@ -0,0 +1,335 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * The wheel has METIS_TIMER_WHEEL_LEVELS levels of METIS_TIMER_WHEEL_SLOTS slots.  A slot at
+ * level L covers 2^(8L) ticks.  A timer goes in the lowest level whose range covers its distance
+ * from the current time, at the slot given by the bits of its expiry for that level.  When the
+ * level 0 index wraps, we cascade the current slot of level 1 down, and so on up the levels.
+ *
+ * Each slot is a circular doubly-linked list with a sentinel, so unlinking a timer does
+ * not need to know which slot it is in.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+
+#include <ccnx/forwarder/metis/core/metis_TimerWheel.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <LongBow/runtime.h>
+
+#define METIS_TIMER_WHEEL_BITS   8
+#define METIS_TIMER_WHEEL_SLOTS  (1 << METIS_TIMER_WHEEL_BITS)
+#define METIS_TIMER_WHEEL_MASK   (METIS_TIMER_WHEEL_SLOTS - 1)
+#define METIS_TIMER_WHEEL_LEVELS 4
+
+// Timers further out than this are parked in the top level and cascade again
+#define METIS_TIMER_WHEEL_RANGE  (((MetisTicks) 1) << (METIS_TIMER_WHEEL_BITS * METIS_TIMER_WHEEL_LEVELS))
+
+struct metis_timer_wheel_timer {
+    MetisTimerWheelTimer *next;
+    MetisTimerWheelTimer *prev;
+    MetisTicks expiry;
+    void *data;
+};
+
+struct metis_timer_wheel {
+    // The time up to which all slots have been processed
+    MetisTicks current;
+    size_t count;
+
+    MetisTimerWheelTimer expired;
+    MetisTimerWheelTimer slots[METIS_TIMER_WHEEL_LEVELS][METIS_TIMER_WHEEL_SLOTS];
+};
+
+// =====================================================
+
+static void
+_metisTimerWheel_ListInit(MetisTimerWheelTimer *head)
+{
+    head->next = head;
+    head->prev = head;
+}
+
+static bool
+_metisTimerWheel_ListIsEmpty(const MetisTimerWheelTimer *head)
+{
+    return head->next == head;
+}
+
+static void
+_metisTimerWheel_ListAppend(MetisTimerWheelTimer *head, MetisTimerWheelTimer *timer)
+{
+    timer->prev = head->prev;
+    timer->next = head;
+    head->prev->next = timer;
+    head->prev = timer;
+}
+
+static void
+_metisTimerWheel_ListUnlink(MetisTimerWheelTimer *timer)
+{
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->next = timer;
+    timer->prev = timer;
+}
+
+/**
+ * Puts an unlinked timer in the right slot for its expiry
+ */
+static void
+_metisTimerWheel_Place(MetisTimerWheel *wheel, MetisTimerWheelTimer *timer)
+{
+    if (timer->expiry <= wheel->current) {
+        _metisTimerWheel_ListAppend(&wheel->expired, timer);
+        return;
+    }
+
+    MetisTicks delta = timer->expiry - wheel->current;
+    MetisTicks expiry = timer->expiry;
+    if (delta >= METIS_TIMER_WHEEL_RANGE) {
+        expiry = wheel->current + METIS_TIMER_WHEEL_RANGE - 1;
+        delta = METIS_TIMER_WHEEL_RANGE - 1;
+    }
+
+    unsigned level = 0;
+    while (delta >= ((MetisTicks) 1 << (METIS_TIMER_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+
+    size_t slot = (expiry >> (METIS_TIMER_WHEEL_BITS * level)) & METIS_TIMER_WHEEL_MASK;
+    _metisTimerWheel_ListAppend(&wheel->slots[level][slot], timer);
+}
+
+/**
+ * Re-places every timer in the slot.  They all land in lower levels (or back in the
+ * top level if they are beyond the wheel's range).
+ */
+static void
+_metisTimerWheel_Cascade(MetisTimerWheel *wheel, unsigned level, size_t slot)
+{
+    MetisTimerWheelTimer *head = &wheel->slots[level][slot];
+
+    // detach the list first, as placing may append to this same slot
+    MetisTimerWheelTimer pending;
+    _metisTimerWheel_ListInit(&pending);
+    if (!_metisTimerWheel_ListIsEmpty(head)) {
+        pending.next = head->next;
+        pending.prev = head->prev;
+        pending.next->prev = &pending;
+        pending.prev->next = &pending;
+        _metisTimerWheel_ListInit(head);
+    }
+
+    while (!_metisTimerWheel_ListIsEmpty(&pending)) {
+        MetisTimerWheelTimer *timer = pending.next;
+        _metisTimerWheel_ListUnlink(timer);
+        _metisTimerWheel_Place(wheel, timer);
+    }
+}
+
+static void
+_metisTimerWheel_Tick(MetisTimerWheel *wheel)
+{
+    wheel->current++;
+
+    if ((wheel->current & METIS_TIMER_WHEEL_MASK) == 0) {
+        for (unsigned level = 1; level < METIS_TIMER_WHEEL_LEVELS; level++) {
+            size_t slot = (wheel->current >> (METIS_TIMER_WHEEL_BITS * level)) & METIS_TIMER_WHEEL_MASK;
+            _metisTimerWheel_Cascade(wheel, level, slot);
+            if (slot != 0) {
+                break;
+            }
+        }
+    }
+
+    // everything in the current level 0 slot expires now
+    _metisTimerWheel_Cascade(wheel, 0, wheel->current & METIS_TIMER_WHEEL_MASK);
+}
+
+// =====================================================
+
+MetisTimerWheel *
+metisTimerWheel_Create(MetisTicks now)
+{
+    MetisTimerWheel *wheel = parcMemory_AllocateAndClear(sizeof(MetisTimerWheel));
+    assertNotNull(wheel, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisTimerWheel));
+
+    wheel->current = now;
+    _metisTimerWheel_ListInit(&wheel->expired);
+    for (unsigned level = 0; level < METIS_TIMER_WHEEL_LEVELS; level++) {
+        for (size_t slot = 0; slot < METIS_TIMER_WHEEL_SLOTS; slot++) {
+            _metisTimerWheel_ListInit(&wheel->slots[level][slot]);
+        }
+    }
+    return wheel;
+}
+
+static void
+_metisTimerWheel_FreeList(MetisTimerWheelTimer *head)
+{
+    while (!_metisTimerWheel_ListIsEmpty(head)) {
+        MetisTimerWheelTimer *timer = head->next;
+        _metisTimerWheel_ListUnlink(timer);
+        parcMemory_Deallocate((void **) &timer);
+    }
+}
+
+void
+metisTimerWheel_Destroy(MetisTimerWheel **wheelPtr)
+{
+    assertNotNull(wheelPtr, "Parameter must be non-null double pointer");
+    assertNotNull(*wheelPtr, "Parameter must dereference to non-null pointer");
+
+    MetisTimerWheel *wheel = *wheelPtr;
+    _metisTimerWheel_FreeList(&wheel->expired);
+    for (unsigned level = 0; level < METIS_TIMER_WHEEL_LEVELS; level++) {
+        for (size_t slot = 0; slot < METIS_TIMER_WHEEL_SLOTS; slot++) {
+            _metisTimerWheel_FreeList(&wheel->slots[level][slot]);
+        }
+    }
+
+    parcMemory_Deallocate((void **) &wheel);
+    *wheelPtr = NULL;
+}
+
+MetisTimerWheelTimer *
+metisTimerWheel_Schedule(MetisTimerWheel *wheel, MetisTicks expiry, void *data)
+{
+    assertNotNull(wheel, "Parameter wheel must be non-null");
+
+    MetisTimerWheelTimer *timer = parcMemory_Allocate(sizeof(MetisTimerWheelTimer));
+    assertNotNull(timer, "parcMemory_Allocate(%zu) returned NULL", sizeof(MetisTimerWheelTimer));
+    timer->expiry = expiry;
+    timer->data = data;
+
+    _metisTimerWheel_Place(wheel, timer);
+    wheel->count++;
+    return timer;
+}
+
+void
+metisTimerWheel_Reschedule(MetisTimerWheel *wheel, MetisTimerWheelTimer *timer, MetisTicks expiry)
+{
+    assertNotNull(wheel, "Parameter wheel must be non-null");
+    assertNotNull(timer, "Parameter timer must be non-null");
+
+    _metisTimerWheel_ListUnlink(timer);
+    timer->expiry = expiry;
+    _metisTimerWheel_Place(wheel, timer);
+}
+
+void
+metisTimerWheel_Cancel(MetisTimerWheel *wheel, MetisTimerWheelTimer **timerPtr)
+{
+    assertNotNull(wheel, "Parameter wheel must be non-null");
+    assertNotNull(timerPtr, "Parameter must be non-null double pointer");
+    assertNotNull(*timerPtr, "Parameter must dereference to non-null pointer");
+
+    MetisTimerWheelTimer *timer = *timerPtr;
+    _metisTimerWheel_ListUnlink(timer);
+    wheel->count--;
+    parcMemory_Deallocate((void **) &timer);
+    *timerPtr = NULL;
+}
+
+void
+metisTimerWheel_Advance(MetisTimerWheel *wheel, MetisTicks now)
+{
+    assertNotNull(wheel, "Parameter wheel must be non-null");
+
+    if (wheel->count == 0 && now > wheel->current) {
+        // nothing to cascade, jump ahead
+        wheel->current = now;
+        return;
+    }
+
+    while (wheel->current < now) {
+        _metisTimerWheel_Tick(wheel);
+    }
+}
+
+void *
+metisTimerWheel_PopExpired(MetisTimerWheel *wheel)
+{
+    assertNotNull(wheel, "Parameter wheel must be non-null");
+
+    if (_metisTimerWheel_ListIsEmpty(&wheel->expired)) {
+        return NULL;
+    }
+
+    MetisTimerWheelTimer *timer = wheel->expired.next;
+    void *data = timer->data;
+    metisTimerWheel_Cancel(wheel, &timer);
+    return data;
+}
+
+size_t
+metisTimerWheel_Count(const MetisTimerWheel *wheel)
+{
+    assertNotNull(wheel, "Parameter wheel must be non-null");
+    return wheel->count;
+}
+
+MetisTicks
+metisTimerWheelTimer_GetExpiry(const MetisTimerWheelTimer *timer)
+{
+    assertNotNull(timer, "Parameter timer must be non-null");
+    return timer->expiry;
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_TimerWheel.h
+ * @brief A hierarchical timer wheel keyed on MetisTicks
+ *
+ * Schedules many timers that are cheap to add and cancel.  The owner advances the wheel to the
+ * current time and then pops expired timers, as many as it wants to handle at once.  Timers
+ * that are not popped stay in the expired list until the next call.
+ *
+ * The wheel does not call back into the owner and does not own the data pointers.
+ *
+ * Schedule, Cancel and PopExpired are O(1).  Advance is proportional to the number of ticks
+ * passed plus the number of timers moved between levels.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_TimerWheel_h
+#define Metis_metis_TimerWheel_h
+
+#include <stdlib.h>
+#include <ccnx/forwarder/metis/core/metis_Ticks.h>
+
+struct metis_timer_wheel;
+typedef struct metis_timer_wheel MetisTimerWheel;
+
+struct metis_timer_wheel_timer;
+typedef struct metis_timer_wheel_timer MetisTimerWheelTimer;
+
+/**
+ * Creates an empty timer wheel
+ *
+ * @param [in] now The current time
+ *
+ * @return non-null An allocated timer wheel
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisTimerWheel *wheel = metisTimerWheel_Create(metisForwarder_GetTicks(metis));
+ *     metisTimerWheel_Destroy(&wheel);
+ * }
+ * @endcode
+ */
+MetisTimerWheel *metisTimerWheel_Create(MetisTicks now);
+
+/**
+ * Destroys the wheel and any timers still in it.  Does not touch the data pointers.
+ *
+ * @param [in,out] wheelPtr Pointer to the wheel, will be NULL'd
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisTimerWheel *wheel = metisTimerWheel_Create(0);
+ *     metisTimerWheel_Destroy(&wheel);
+ * }
+ * @endcode
+ */
+void metisTimerWheel_Destroy(MetisTimerWheel **wheelPtr);
+
+/**
+ * Schedules a timer
+ *
+ * An expiry time at or before the wheel's current time goes straight to the expired list.
+ *
+ * @param [in] wheel An allocated timer wheel
+ * @param [in] expiry The time at which the timer expires
+ * @param [in] data Returned by metisTimerWheel_PopExpired
+ *
+ * @return non-null A timer handle.  It is valid until the timer is canceled or popped.
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisTimerWheelTimer *timer = metisTimerWheel_Schedule(wheel, now + 4000, pitEntry);
+ * }
+ * @endcode
+ */
+MetisTimerWheelTimer *metisTimerWheel_Schedule(MetisTimerWheel *wheel, MetisTicks expiry, void *data);
+
+/**
+ * Moves a timer to a new expiry time
+ *
+ * @param [in] wheel An allocated timer wheel
+ * @param [in] timer A timer in the wheel
+ * @param [in] expiry The new expiry time
+ *
+ * Example:
+ * @code
+ * {
+ *     metisTimerWheel_Reschedule(wheel, timer, now + 4000);
+ * }
+ * @endcode
+ */
+void metisTimerWheel_Reschedule(MetisTimerWheel *wheel, MetisTimerWheelTimer *timer, MetisTicks expiry);
+
+/**
+ * Removes a timer from the wheel, whether or not it has expired.
+ *
+ * @param [in] wheel An allocated timer wheel
+ * @param [in,out] timerPtr The timer to cancel, will be NULL'd
+ *
+ * Example:
+ * @code
+ * {
+ *     metisTimerWheel_Cancel(wheel, &timer);
+ * }
+ * @endcode
+ */
+void metisTimerWheel_Cancel(MetisTimerWheel *wheel, MetisTimerWheelTimer **timerPtr);
+
+/**
+ * Moves the wheel forward to the given time.  All timers with an expiry at or before
+ * now are moved to the expired list.  Time never goes backwards.
+ *
+ * @param [in] wheel An allocated timer wheel
+ * @param [in] now The current time
+ *
+ * Example:
+ * @code
+ * {
+ *     metisTimerWheel_Advance(wheel, metisForwarder_GetTicks(metis));
+ *     void *data;
+ *     while ((data = metisTimerWheel_PopExpired(wheel)) != NULL) {
+ *         // handle the expiry
+ *     }
+ * }
+ * @endcode
+ */
+void metisTimerWheel_Advance(MetisTimerWheel *wheel, MetisTicks now);
+
+/**
+ * Removes the first timer from the expired list
+ *
+ * The timer handle is no longer valid after this call.
+ *
+ * @param [in] wheel An allocated timer wheel
+ *
+ * @return non-null The data of the expired timer
+ * @return null There are no expired timers
+ *
+ * Example:
+ * @code
+ * {
+ *     void *data = metisTimerWheel_PopExpired(wheel);
+ * }
+ * @endcode
+ */
+void *metisTimerWheel_PopExpired(MetisTimerWheel *wheel);
+
+/**
+ * The number of timers in the wheel, including expired ones not yet popped
+ *
+ * @param [in] wheel An allocated timer wheel
+ *
+ * @return The number of timers
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t pending = metisTimerWheel_Count(wheel);
+ * }
+ * @endcode
+ */
+size_t metisTimerWheel_Count(const MetisTimerWheel *wheel);
+
+/**
+ * The expiry time of a timer
+ *
+ * @param [in] timer A timer in the wheel
+ *
+ * @return The expiry time
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisTicks expiry = metisTimerWheelTimer_GetExpiry(timer);
+ * }
+ * @endcode
+ */
+MetisTicks metisTimerWheelTimer_GetExpiry(const MetisTimerWheelTimer *timer);
+#endif // Metis_metis_TimerWheel_h
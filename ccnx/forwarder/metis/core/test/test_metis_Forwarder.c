@@ -62,6 +62,8 @@
 #include <LongBow/unit-test.h>
 #include <parc/algol/parc_SafeMemory.h>
 
+#include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
+
 LONGBOW_TEST_RUNNER(metis_Forwarder)
 {
     // The following Test Fixtures will run their corresponding Test Cases.
@@ -93,8 +95,13 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisForwarder_GetMessenger);
     LONGBOW_RUN_TEST_CASE(Global, metisForwarder_GetNextConnectionId);
     LONGBOW_RUN_TEST_CASE(Global, metisForwarder_GetTicks);
+    LONGBOW_RUN_TEST_CASE(Global, metisForwarder_BeginTickCache);
+    LONGBOW_RUN_TEST_CASE(Global, metisForwarder_BeginTickCache_Nested);
+    LONGBOW_RUN_TEST_CASE(Global, metisForwarder_BeginTickCache_OtherForwarder);
+    LONGBOW_RUN_TEST_CASE(Global, metisForwarder_WallclockToTicks);
     LONGBOW_RUN_TEST_CASE(Global, metisForwarder_Log);
     LONGBOW_RUN_TEST_CASE(Global, metisForwarder_Receive);
+    LONGBOW_RUN_TEST_CASE(Global, metisForwarder_ReceiveBatch);
     LONGBOW_RUN_TEST_CASE(Global, metis_run);
     LONGBOW_RUN_TEST_CASE(Global, metis_stop);
 
@@ -104,6 +111,8 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisForwarder_NanosToTicks_LessThanHz);
 
     LONGBOW_RUN_TEST_CASE(Global, metisForwarder_TicksToNanos_1sec);
+
+    LONGBOW_RUN_TEST_CASE(Global, metisForwarder_SetWorkerCount);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -180,6 +189,83 @@ LONGBOW_TEST_CASE(Global, metisForwarder_GetTicks)
 
 }
 
+LONGBOW_TEST_CASE(Global, metisForwarder_BeginTickCache)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+
+    MetisTicks t0 = metisForwarder_BeginTickCache(metis);
+    usleep(20000);
+    MetisTicks t1 = metisForwarder_GetTicks(metis);
+
+    // the clock offset still applies to the cached time
+    metis->clockOffset = 1000;
+    MetisTicks t2 = metisForwarder_GetTicks(metis);
+    metisForwarder_EndTickCache(metis);
+
+    MetisTicks t3 = metisForwarder_GetTicks(metis);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(t1 == t0, "Cached ticks should not move, expected %" PRIu64 " got %" PRIu64, t0, t1);
+    assertTrue(t2 == t0 + 1000, "Wrong cached ticks with offset, expected %" PRIu64 " got %" PRIu64, t0 + 1000, t2);
+    assertTrue(t3 >= t0 + 1000 + 20, "Ticks should read the clock after the cache ends, expected at least %" PRIu64 " got %" PRIu64, t0 + 1020, t3);
+}
+
+LONGBOW_TEST_CASE(Global, metisForwarder_BeginTickCache_Nested)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+
+    MetisTicks t0 = metisForwarder_BeginTickCache(metis);
+    usleep(20000);
+    MetisTicks t1 = metisForwarder_BeginTickCache(metis);
+    metisForwarder_EndTickCache(metis);
+
+    // still inside the outer cache
+    MetisTicks t2 = metisForwarder_GetTicks(metis);
+    metisForwarder_EndTickCache(metis);
+
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(t1 == t0, "Inner cache should not read the clock, expected %" PRIu64 " got %" PRIu64, t0, t1);
+    assertTrue(t2 == t0, "Outer cache should still be open, expected %" PRIu64 " got %" PRIu64, t0, t2);
+}
+
+LONGBOW_TEST_CASE(Global, metisForwarder_BeginTickCache_OtherForwarder)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisForwarder *other = metisForwarder_Create(NULL);
+    other->clockOffset = 1000000;
+
+    // a cache on one forwarder must not leak into another with a different clock
+    metisForwarder_BeginTickCache(metis);
+    MetisTicks ticks = metisForwarder_GetTicks(metis);
+    MetisTicks otherTicks = metisForwarder_GetTicks(other);
+    metisForwarder_EndTickCache(metis);
+
+    metisForwarder_Destroy(&other);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(otherTicks >= ticks + 1000000, "Other forwarder got the cached ticks, expected at least %" PRIu64 " got %" PRIu64, ticks + 1000000, otherTicks);
+}
+
+LONGBOW_TEST_CASE(Global, metisForwarder_WallclockToTicks)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+
+    PARCClock *wallclock = parcClock_Wallclock();
+    uint64_t wallclockTime = parcClock_GetTime(wallclock);
+    parcClock_Release(&wallclock);
+
+    MetisTicks now = metisForwarder_BeginTickCache(metis);
+    MetisTicks ticks = metisForwarder_WallclockToTicks(wallclockTime + 5000);
+    metisForwarder_EndTickCache(metis);
+
+    metisForwarder_Destroy(&metis);
+
+    // 5 seconds from now on the wall clock is about 5 seconds from now in ticks
+    int64_t error = llabs((int64_t) (ticks - now) - 5000);
+    assertTrue(error <= 10, "Wrong ticks for wall clock time, expected about %" PRIu64 " got %" PRIu64, now + 5000, ticks);
+}
+
 LONGBOW_TEST_CASE(Global, metisForwarder_Log)
 {
     testUnimplemented("This test is unimplemented");
@@ -190,6 +276,24 @@ LONGBOW_TEST_CASE(Global, metisForwarder_Receive)
     testUnimplemented("This test is unimplemented");
 }
 
+LONGBOW_TEST_CASE(Global, metisForwarder_ReceiveBatch)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+
+    MetisMessage *messages[] = {
+        metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger),
+        metisMessage_CreateFromArray(metisTestDataV0_EncodedObject,    sizeof(metisTestDataV0_EncodedObject),    3, 4, logger),
+    };
+
+    // an empty batch is fine, the real one takes ownership of both messages, which the
+    // fixture teardown checks for leaks
+    metisForwarder_ReceiveBatch(metis, 0, NULL);
+    metisForwarder_ReceiveBatch(metis, 2, messages);
+
+    metisForwarder_Destroy(&metis);
+}
+
 LONGBOW_TEST_CASE(Global, metis_run)
 {
     testUnimplemented("This test is unimplemented");
@@ -243,6 +347,30 @@ LONGBOW_TEST_CASE(Global, metisForwarder_TicksToNanos_1sec)
 
 // ======================================================================
 
+LONGBOW_TEST_CASE(Global, metisForwarder_SetWorkerCount)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    unsigned defaultCount = metisForwarder_GetWorkerCount(metis);
+
+    metisForwarder_SetWorkerCount(metis, 3);
+    unsigned shardedCount = metisForwarder_GetWorkerCount(metis);
+
+    // routes go to every shard
+    CCNxName *ccnxName = ccnxName_CreateFromCString("lci:/foo/bar");
+    CPIRouteEntry *route = cpiRouteEntry_Create(ccnxName, 22, NULL, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, NULL, 12);
+    metisForwarder_AddOrUpdateRoute(metis, route);
+    MetisFibEntryList *list = metisForwarder_GetFibEntries(metis);
+    size_t routeCount = metisFibEntryList_Length(list);
+    metisFibEntryList_Destroy(&list);
+    cpiRouteEntry_Destroy(&route);
+
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(defaultCount == 1, "Wrong default worker count, expected 1 got %u", defaultCount);
+    assertTrue(shardedCount == 3, "Wrong worker count, expected 3 got %u", shardedCount);
+    assertTrue(routeCount == 1, "Wrong route count, expected 1 got %zu", routeCount);
+}
+
 LONGBOW_TEST_FIXTURE(Local)
 {
     LONGBOW_RUN_TEST_CASE(Local, metisForwarder_Seed);
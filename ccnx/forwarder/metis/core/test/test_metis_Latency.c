@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metis_Latency.c"
+#include <inttypes.h>
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+
+LONGBOW_TEST_RUNNER(metis_Latency)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_Latency)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_Latency)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// =================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisLatency_BucketIndex);
+    LONGBOW_RUN_TEST_CASE(Global, metisLatency_BucketLowerBound);
+    LONGBOW_RUN_TEST_CASE(Global, metisLatency_Start_Off);
+    LONGBOW_RUN_TEST_CASE(Global, metisLatency_Start_SampleInterval);
+    LONGBOW_RUN_TEST_CASE(Global, metisLatency_Snapshot_ExitedThread);
+    LONGBOW_RUN_TEST_CASE(Global, metisLatency_StageName);
+    LONGBOW_RUN_TEST_CASE(Global, metisLatencyHistogram_Percentile);
+    LONGBOW_RUN_TEST_CASE(Global, metisLatency_ToJson);
+    LONGBOW_RUN_TEST_CASE(Global, metisLatency_ProcessCPIRequest);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    metisLatency_SetSampleInterval(0);
+    metisLatency_Reset();
+    metisLatency_Drain();
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, metisLatency_BucketIndex)
+{
+    for (uint64_t ticks = 0; ticks < METIS_LATENCY_SUB_BUCKETS; ticks++) {
+        assertTrue(metisLatency_BucketIndex(ticks) == ticks, "Small latency %" PRIu64 " should have its own bucket", ticks);
+    }
+
+    for (uint64_t ticks = 0; ticks < 100000; ticks++) {
+        unsigned index = metisLatency_BucketIndex(ticks);
+        assertTrue(metisLatency_BucketLowerBound(index) <= ticks, "Latency %" PRIu64 " below its bucket %u", ticks, index);
+        assertTrue(metisLatency_BucketLowerBound(index + 1) > ticks, "Latency %" PRIu64 " above its bucket %u", ticks, index);
+    }
+
+    assertTrue(metisLatency_BucketIndex(UINT64_MAX) == METIS_LATENCY_BUCKETS - 1,
+               "Wrong last bucket, expected %d got %u", METIS_LATENCY_BUCKETS - 1, metisLatency_BucketIndex(UINT64_MAX));
+}
+
+LONGBOW_TEST_CASE(Global, metisLatency_BucketLowerBound)
+{
+    for (unsigned index = 0; index < METIS_LATENCY_BUCKETS; index++) {
+        uint64_t lower = metisLatency_BucketLowerBound(index);
+        assertTrue(metisLatency_BucketIndex(lower) == index, "Bucket %u lower bound %" PRIu64 " in the wrong bucket", index, lower);
+    }
+
+    // each power of two is split in to METIS_LATENCY_SUB_BUCKETS equal buckets
+    unsigned index = metisLatency_BucketIndex(1024);
+    uint64_t width = metisLatency_BucketLowerBound(index + 1) - metisLatency_BucketLowerBound(index);
+    assertTrue(width == 1024 / METIS_LATENCY_SUB_BUCKETS, "Wrong bucket width, expected %d got %" PRIu64, 1024 / METIS_LATENCY_SUB_BUCKETS, width);
+}
+
+LONGBOW_TEST_CASE(Global, metisLatency_Start_Off)
+{
+    metisLatency_SetSampleInterval(0);
+    for (int i = 0; i < 10; i++) {
+        uint64_t start = metisLatency_Start();
+        assertTrue(start == 0, "Sampled with sampling off");
+        metisLatency_Stop(MetisLatencyStage_Pit, start);
+    }
+
+    MetisLatencyHistogram histograms[MetisLatencyStage_END];
+    metisLatency_Snapshot(histograms);
+    assertTrue(histograms[MetisLatencyStage_Pit].count == 0, "Wrong count, expected 0 got %" PRIu64, histograms[MetisLatencyStage_Pit].count);
+}
+
+LONGBOW_TEST_CASE(Global, metisLatency_Start_SampleInterval)
+{
+    metisLatency_Reset();
+    metisLatency_SetSampleInterval(10);
+    assertTrue(metisLatency_GetSampleInterval() == 10, "Wrong interval, got %u", metisLatency_GetSampleInterval());
+
+    unsigned sampled = 0;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t start = metisLatency_Start();
+        if (start != 0) {
+            sampled++;
+        }
+        metisLatency_Stop(MetisLatencyStage_Fib, start);
+    }
+
+    MetisLatencyHistogram histograms[MetisLatencyStage_END];
+    metisLatency_Snapshot(histograms);
+
+    assertTrue(sampled == 100, "Wrong samples, expected 100 got %u", sampled);
+    assertTrue(histograms[MetisLatencyStage_Fib].count == 100, "Wrong count, expected 100 got %" PRIu64, histograms[MetisLatencyStage_Fib].count);
+    assertTrue(histograms[MetisLatencyStage_Pit].count == 0, "Wrong pit count, expected 0 got %" PRIu64, histograms[MetisLatencyStage_Pit].count);
+}
+
+static void *
+_sampleThread(void *arg)
+{
+    for (int i = 0; i < 50; i++) {
+        uint64_t start = metisLatency_Start();
+        metisLatency_Stop(MetisLatencyStage_Send, start);
+    }
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Global, metisLatency_Snapshot_ExitedThread)
+{
+    metisLatency_Reset();
+    metisLatency_SetSampleInterval(1);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, _sampleThread, NULL);
+    pthread_join(thread, NULL);
+
+    MetisLatencyHistogram histograms[MetisLatencyStage_END];
+    metisLatency_Snapshot(histograms);
+
+    assertTrue(histograms[MetisLatencyStage_Send].count == 50,
+               "Exited thread's samples lost, expected 50 got %" PRIu64, histograms[MetisLatencyStage_Send].count);
+}
+
+LONGBOW_TEST_CASE(Global, metisLatency_StageName)
+{
+    for (MetisLatencyStage stage = 0; stage < MetisLatencyStage_END; stage++) {
+        assertNotNull(metisLatency_StageName(stage), "Stage %d has no name", stage);
+    }
+    assertTrue(strcmp(metisLatency_StageName(MetisLatencyStage_ContentStore), "contentStore") == 0,
+               "Wrong name, got %s", metisLatency_StageName(MetisLatencyStage_ContentStore));
+}
+
+LONGBOW_TEST_CASE(Global, metisLatencyHistogram_Percentile)
+{
+    MetisLatencyHistogram histogram;
+    memset(&histogram, 0, sizeof(histogram));
+    assertTrue(metisLatencyHistogram_Percentile(&histogram, 50.0) == 0, "Empty histogram should have 0 percentiles");
+
+    for (uint64_t ticks = 1; ticks <= 1000; ticks++) {
+        histogram.count++;
+        histogram.buckets[metisLatency_BucketIndex(ticks)]++;
+    }
+    histogram.maxTicks = 1000;
+
+    // within one bucket width, 1/METIS_LATENCY_SUB_BUCKETS
+    uint64_t p50 = metisLatencyHistogram_Percentile(&histogram, 50.0);
+    uint64_t p99 = metisLatencyHistogram_Percentile(&histogram, 99.0);
+    uint64_t p100 = metisLatencyHistogram_Percentile(&histogram, 100.0);
+
+    assertTrue(p50 >= 500 - 500 / METIS_LATENCY_SUB_BUCKETS && p50 <= 500 + 500 / METIS_LATENCY_SUB_BUCKETS, "Wrong p50, got %" PRIu64, p50);
+    assertTrue(p99 >= 990 - 990 / METIS_LATENCY_SUB_BUCKETS && p99 <= 990 + 990 / METIS_LATENCY_SUB_BUCKETS, "Wrong p99, got %" PRIu64, p99);
+    assertTrue(p100 == 1000, "p100 should be the maximum, got %" PRIu64, p100);
+}
+
+LONGBOW_TEST_CASE(Global, metisLatency_ToJson)
+{
+    MetisLatencyHistogram histograms[MetisLatencyStage_END];
+    memset(histograms, 0, sizeof(histograms));
+    histograms[MetisLatencyStage_Parse].count = 3;
+
+    PARCJSON *json = metisLatency_ToJson(histograms);
+    PARCJSON *parse = parcJSONValue_GetJSON(parcJSON_GetValueByName(json, "parse"));
+    int64_t count = parcJSONValue_GetInteger(parcJSON_GetValueByName(parse, "count"));
+    PARCJSONValue *p99 = parcJSON_GetValueByName(parse, "p99Ns");
+    parcJSON_Release(&json);
+
+    assertTrue(count == 3, "Wrong count, expected 3 got %" PRId64, count);
+    assertNotNull(p99, "Summary missing p99Ns");
+}
+
+LONGBOW_TEST_CASE(Global, metisLatency_ProcessCPIRequest)
+{
+    CCNxControl *request = metisLatency_CreateCPIRequest(true, 7);
+    bool isLatency = metisLatency_IsCPIRequest(request);
+    CCNxControl *response = metisLatency_ProcessCPIRequest(request);
+
+    PARCJSON *summary = metisLatency_GetCPIResponse(response);
+    assertNotNull(summary, "Response did not carry the summary");
+    int64_t interval = parcJSONValue_GetInteger(parcJSON_GetValueByName(summary, "SAMPLE_INTERVAL"));
+
+    ccnxControl_Release(&response);
+    ccnxControl_Release(&request);
+
+    assertTrue(isLatency, "Request not recognized as a latency request");
+    assertTrue(interval == 7, "Wrong sample interval, expected 7 got %" PRId64, interval);
+    assertTrue(metisLatency_GetSampleInterval() == 7, "Sample interval not set, got %u", metisLatency_GetSampleInterval());
+
+    CCNxControl *other = metisStats_CreateCPIRequest();
+    isLatency = metisLatency_IsCPIRequest(other);
+    ccnxControl_Release(&other);
+    assertFalse(isLatency, "Stats request recognized as a latency request");
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_Latency);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metis_Mailbox.c"
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/logging/parc_LogReporterTextStdout.h>
+
+#include <ccnx/forwarder/metis/core/metis_Logger.h>
+
+// The most items the test callback takes per call
+#define TEST_BATCH 2
+
+typedef struct test_data {
+    MetisLogger *logger;
+    MetisDispatcher *dispatcher;
+    MetisMailbox *mailbox;
+
+    unsigned callbackCount;
+    unsigned takenCount;
+    void *taken[16];
+    unsigned values[16];
+} TestData;
+
+static void
+_testCallback(int fd, PARCEventType which_event, void *user_data)
+{
+    TestData *data = (TestData *) user_data;
+    data->callbackCount++;
+
+    metisMailbox_Acknowledge(data->mailbox);
+    for (unsigned i = 0; i < TEST_BATCH; i++) {
+        unsigned value;
+        void *item = metisMailbox_Take(data->mailbox, &value);
+        if (item == NULL) {
+            break;
+        }
+        data->taken[data->takenCount] = item;
+        data->values[data->takenCount] = value;
+        data->takenCount++;
+    }
+    metisMailbox_Rearm(data->mailbox);
+}
+
+LONGBOW_TEST_RUNNER(metis_Mailbox)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_Mailbox)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_Mailbox)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// =================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisMailbox_Create_Destroy);
+    LONGBOW_RUN_TEST_CASE(Global, metisMailbox_Post_Take);
+    LONGBOW_RUN_TEST_CASE(Global, metisMailbox_Post_Full);
+    LONGBOW_RUN_TEST_CASE(Global, metisMailbox_Rearm);
+    LONGBOW_RUN_TEST_CASE(Global, metisMailbox_Wake);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    TestData *data = parcMemory_AllocateAndClear(sizeof(TestData));
+    assertNotNull(data, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(TestData));
+
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    data->logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+    data->dispatcher = metisDispatcher_Create(data->logger);
+    data->mailbox = metisMailbox_Create(4, data->dispatcher, _testCallback, data);
+
+    longBowTestCase_SetClipBoardData(testCase, data);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    if (data->mailbox) {
+        metisMailbox_Destroy(&data->mailbox);
+    }
+    metisDispatcher_Destroy(&data->dispatcher);
+    metisLogger_Release(&data->logger);
+    parcMemory_Deallocate((void **) &data);
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, metisMailbox_Create_Destroy)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    assertTrue(metisMailbox_Count(data->mailbox) == 0, "New mailbox should be empty");
+    metisMailbox_Destroy(&data->mailbox);
+    assertNull(data->mailbox, "Destroy did not null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, metisMailbox_Post_Take)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    int a, b;
+
+    assertTrue(metisMailbox_Post(data->mailbox, &a, 1), "Post failed");
+    assertTrue(metisMailbox_Post(data->mailbox, &b, 2), "Post failed");
+    assertTrue(metisMailbox_Count(data->mailbox) == 2, "Wrong count, expected 2 got %zu", metisMailbox_Count(data->mailbox));
+
+    metisDispatcher_RunCount(data->dispatcher, 1);
+
+    assertTrue(data->callbackCount == 1, "Expected 1 callback, got %u", data->callbackCount);
+    assertTrue(data->takenCount == 2, "Expected 2 items, got %u", data->takenCount);
+    assertTrue(data->taken[0] == &a && data->values[0] == 1, "Wrong first item");
+    assertTrue(data->taken[1] == &b && data->values[1] == 2, "Wrong second item");
+}
+
+LONGBOW_TEST_CASE(Global, metisMailbox_Post_Full)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    int a;
+
+    for (unsigned i = 0; i < 4; i++) {
+        assertTrue(metisMailbox_Post(data->mailbox, &a, i), "Post %u failed", i);
+    }
+    assertFalse(metisMailbox_Post(data->mailbox, &a, 4), "Post to a full mailbox should fail");
+
+    while (metisMailbox_Take(data->mailbox, NULL) != NULL) {
+        // drain
+    }
+}
+
+LONGBOW_TEST_CASE(Global, metisMailbox_Rearm)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+    int a;
+
+    for (unsigned i = 0; i < 3; i++) {
+        metisMailbox_Post(data->mailbox, &a, i);
+    }
+
+    // the first callback takes TEST_BATCH items, then Rearm must wake it for the last one
+    metisDispatcher_RunCount(data->dispatcher, 1);
+    assertTrue(data->takenCount == TEST_BATCH, "Expected %u items, got %u", TEST_BATCH, data->takenCount);
+
+    metisDispatcher_RunCount(data->dispatcher, 1);
+    assertTrue(data->takenCount == 3, "Expected 3 items, got %u", data->takenCount);
+    assertTrue(data->values[2] == 2, "Wrong last value, expected 2 got %u", data->values[2]);
+}
+
+LONGBOW_TEST_CASE(Global, metisMailbox_Wake)
+{
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    // two wakes before the consumer runs are one callback
+    metisMailbox_Wake(data->mailbox);
+    metisMailbox_Wake(data->mailbox);
+    metisDispatcher_RunCount(data->dispatcher, 1);
+
+    assertTrue(data->callbackCount == 1, "Expected 1 callback, got %u", data->callbackCount);
+    assertTrue(data->takenCount == 0, "Expected no items, got %u", data->takenCount);
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_Mailbox);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -106,7 +106,9 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisMessage_Length);
     LONGBOW_RUN_TEST_CASE(Global, metisMessage_Append);
     LONGBOW_RUN_TEST_CASE(Global, metisMessage_Write);
+    LONGBOW_RUN_TEST_CASE(Global, metisMessage_GetIovec);
     LONGBOW_RUN_TEST_CASE(Global, metisMessage_GetConnectionId);
+    LONGBOW_RUN_TEST_CASE(Global, metisMessage_SetIngressConnectionId);
     LONGBOW_RUN_TEST_CASE(Global, metisMessage_GetReceiveTime);
     LONGBOW_RUN_TEST_CASE(Global, metisMessage_ReadFromBuffer);
     LONGBOW_RUN_TEST_CASE(Global, metisMessage_Copy);
@@ -130,6 +132,7 @@ LONGBOW_TEST_FIXTURE(Global)
 
     LONGBOW_RUN_TEST_CASE(Global, metisMessage_ObjectHashHashCode_Precomputed);
     LONGBOW_RUN_TEST_CASE(Global, metisMessage_ObjectHashHashCode_Lazy);
+    LONGBOW_RUN_TEST_CASE(Global, metisMessage_ComputeContentObjectHashes);
 
     LONGBOW_RUN_TEST_CASE(Global, metisMessage_HasContentObjectHash_True);
     LONGBOW_RUN_TEST_CASE(Global, metisMessage_HasContentObjectHash_False);
@@ -359,6 +362,25 @@ LONGBOW_TEST_CASE(Global, metisMessage_ReadFromBuffer)
     parcEventBuffer_Destroy(&buff);
 }
 
+LONGBOW_TEST_CASE(Global, metisMessage_GetIovec)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+    MetisMessage *message = metisMessage_CreateFromArray(metisTestDataV0_EncodedInterest, sizeof(metisTestDataV0_EncodedInterest), 1, 2, logger);
+
+    struct iovec vector;
+    metisMessage_GetIovec(message, &vector);
+
+    assertTrue(vector.iov_base == metisMessage_FixedHeader(message), "iovec does not reference the message bytes in place");
+    assertTrue(vector.iov_len == sizeof(metisTestDataV0_EncodedInterest), "Wrong length, expected %zu got %zu",
+               sizeof(metisTestDataV0_EncodedInterest), vector.iov_len);
+    assertTrue(memcmp(vector.iov_base, metisTestDataV0_EncodedInterest, vector.iov_len) == 0, "iovec bytes do not match");
+
+    metisLogger_Release(&logger);
+    metisMessage_Release(&message);
+}
+
 LONGBOW_TEST_CASE(Global, metisMessage_Append)
 {
     char message_str[] = "\x00Once upon a time ...";
@@ -443,6 +465,26 @@ LONGBOW_TEST_CASE(Global, metisMessage_GetConnectionId)
     metisMessage_Release(&message);
 }
 
+LONGBOW_TEST_CASE(Global, metisMessage_SetIngressConnectionId)
+{
+    char message_str[] = "\x00Once upon a time, in a stack far away, a dangling pointer found its way to the top of the heap.";
+
+    PARCEventBuffer *buff = parcEventBuffer_Create();
+    parcEventBuffer_Append(buff, message_str, sizeof(message_str));
+
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+    MetisMessage *message = metisMessage_CreateFromBuffer(1, 2, buff, logger);
+    metisLogger_Release(&logger);
+
+    metisMessage_SetIngressConnectionId(message, 7);
+    unsigned connid = metisMessage_GetIngressConnectionId(message);
+
+    assertTrue(connid == 7, "Wrong connection id, expected %u got %u", 7, connid);
+    metisMessage_Release(&message);
+}
+
 LONGBOW_TEST_CASE(Global, metisMessage_GetReceiveTime)
 {
     char message_str[] = "\x00Once upon a time, in a stack far away, a dangling pointer found its way to the top of the heap.";
@@ -729,6 +771,36 @@ LONGBOW_TEST_CASE(Global, metisMessage_ObjectHashHashCode_Lazy)
     metisMessage_Release(&a);
 }
 
+LONGBOW_TEST_CASE(Global, metisMessage_ComputeContentObjectHashes)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+    MetisMessage *messages[3];
+    messages[0] = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    messages[1] = metisMessage_CreateFromArray(metisTestDataV0_EncodedInterest, sizeof(metisTestDataV0_EncodedInterest), 1, 2, logger);
+    messages[2] = metisMessage_CreateFromArray(metisTestDataV0_SecondObject, sizeof(metisTestDataV0_SecondObject), 1, 2, logger);
+    MetisMessage *lazy = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    metisLogger_Release(&logger);
+
+    // the interest already has its hash
+    size_t computed = metisMessage_ComputeContentObjectHashes(3, messages);
+    assertTrue(computed == 2, "Wrong number of hashes computed, expected 2 got %zu", computed);
+    assertNotNull(messages[0]->contentObjectHash, "First object was not hashed");
+    assertNotNull(messages[2]->contentObjectHash, "Second object was not hashed");
+
+    assertTrue(metisMessage_ObjectHashEquals(messages[0], lazy), "Batch hash does not equal the lazy hash");
+    assertFalse(metisMessage_ObjectHashEquals(messages[2], lazy), "Different objects have the same hash");
+
+    computed = metisMessage_ComputeContentObjectHashes(3, messages);
+    assertTrue(computed == 0, "Hashes were computed twice, expected 0 got %zu", computed);
+
+    for (int i = 0; i < 3; i++) {
+        metisMessage_Release(&messages[i]);
+    }
+    metisMessage_Release(&lazy);
+}
+
 LONGBOW_TEST_CASE(Global, metisMessage_HasHopLimit_True)
 {
     PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
@@ -92,6 +92,9 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisNumberSet_Contains);
     LONGBOW_RUN_TEST_CASE(Global, metisNumberSet_Copy);
     LONGBOW_RUN_TEST_CASE(Global, metisNumberSet_Create_Destroy);
+    LONGBOW_RUN_TEST_CASE(Global, metisNumberSet_Create_Inline);
+    LONGBOW_RUN_TEST_CASE(Global, metisNumberSet_Initialize_Finalize);
+    LONGBOW_RUN_TEST_CASE(Global, metisNumberSet_Initialize_Spill);
 
     LONGBOW_RUN_TEST_CASE(Global, metisNumberSet_Equals_IsEqual);
     LONGBOW_RUN_TEST_CASE(Global, metisNumberSet_Equals_BothEmpty);
@@ -226,6 +229,72 @@ LONGBOW_TEST_CASE(Global, metisNumberSet_Create_Destroy)
     assertTrue(parcSafeMemory_ReportAllocation(STDOUT_FILENO) == 0, "Memory imbalance on create/destroy: %u", parcMemory_Outstanding());
 }
 
+LONGBOW_TEST_CASE(Global, metisNumberSet_Create_Inline)
+{
+    MetisNumberSet *set = metisNumberSet_Create();
+    uint32_t allocations = parcMemory_Outstanding();
+
+    for (int i = 1; i <= METIS_NUMBERSET_INLINE_LENGTH; i++) {
+        metisNumberSet_Add(set, i);
+    }
+    bool isInline = (set->arrayOfNumbers == set->inlineNumbers);
+    uint32_t inlineAllocations = parcMemory_Outstanding();
+
+    metisNumberSet_Add(set, METIS_NUMBERSET_INLINE_LENGTH + 1);
+    bool spilled = (set->arrayOfNumbers != set->inlineNumbers);
+    bool containsAll = true;
+    for (int i = 1; i <= METIS_NUMBERSET_INLINE_LENGTH + 1; i++) {
+        containsAll = containsAll && metisNumberSet_Contains(set, i);
+    }
+
+    metisNumberSet_Release(&set);
+
+    assertTrue(isInline, "A set of %d should be inline", METIS_NUMBERSET_INLINE_LENGTH);
+    assertTrue(inlineAllocations == allocations, "Inline adds should not allocate, expected %u got %u", allocations, inlineAllocations);
+    assertTrue(spilled, "A set of %d should have spilled", METIS_NUMBERSET_INLINE_LENGTH + 1);
+    assertTrue(containsAll, "Lost a member when spilling");
+}
+
+LONGBOW_TEST_CASE(Global, metisNumberSet_Initialize_Finalize)
+{
+    uint32_t allocations = parcMemory_Outstanding();
+
+    MetisNumberSet set;
+    metisNumberSet_Initialize(&set);
+    metisNumberSet_Add(&set, 7);
+    metisNumberSet_Add(&set, 8);
+
+    MetisNumberSet *other = metisNumberSet_Create();
+    metisNumberSet_Add(other, 8);
+    metisNumberSet_Add(other, 7);
+    bool equals = metisNumberSet_Equals(&set, other);
+    metisNumberSet_Release(&other);
+
+    uint32_t stackAllocations = parcMemory_Outstanding();
+    metisNumberSet_Finalize(&set);
+
+    assertTrue(equals, "Stack set should equal the same heap set");
+    assertTrue(stackAllocations == allocations, "A small stack set should not allocate, expected %u got %u", allocations, stackAllocations);
+    assertTrue(metisNumberSet_Length(&set) == 0, "Finalized set should be empty, got %zu", metisNumberSet_Length(&set));
+}
+
+LONGBOW_TEST_CASE(Global, metisNumberSet_Initialize_Spill)
+{
+    MetisNumberSet set;
+    metisNumberSet_Initialize(&set);
+
+    const int count = 3 * METIS_NUMBERSET_INLINE_LENGTH;
+    for (int i = 0; i < count; i++) {
+        metisNumberSet_Add(&set, i);
+    }
+    size_t length = metisNumberSet_Length(&set);
+
+    // the spilled array is freed here, the fixture teardown checks for leaks
+    metisNumberSet_Finalize(&set);
+
+    assertTrue(length == count, "Wrong length, expected %d got %zu", count, length);
+}
+
 LONGBOW_TEST_CASE(Global, metisNumberSet_Equals_IsEqual)
 {
     // 0 is the terminator
@@ -582,7 +651,19 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
 
 LONGBOW_TEST_CASE(Local, metisNumberSet_Expand)
 {
-    testUnimplemented("This test is unimplemented");
+    MetisNumberSet *set = metisNumberSet_Create();
+    metisNumberSet_Add(set, 1);
+    metisNumberSet_Add(set, 2);
+
+    size_t limit = set->limit;
+    metisNumberSet_Expand(set);
+    size_t expandedLimit = set->limit;
+    bool containsAll = metisNumberSet_Contains(set, 1) && metisNumberSet_Contains(set, 2);
+
+    metisNumberSet_Release(&set);
+
+    assertTrue(expandedLimit == 2 * limit, "Wrong limit, expected %zu got %zu", 2 * limit, expandedLimit);
+    assertTrue(containsAll, "Lost a member in expand");
 }
 
 LONGBOW_TEST_CASE(Local, metisNumberSet_AddNoChecks)
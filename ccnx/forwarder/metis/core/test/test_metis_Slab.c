@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metis_Slab.c"
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+
+LONGBOW_TEST_RUNNER(metis_Slab)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_Slab)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_Slab)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// =================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisSlab_Allocate_Disabled);
+    LONGBOW_RUN_TEST_CASE(Global, metisSlab_Allocate_Reuse);
+    LONGBOW_RUN_TEST_CASE(Global, metisSlab_Allocate_Large);
+    LONGBOW_RUN_TEST_CASE(Global, metisSlab_AllocateAndClear);
+    LONGBOW_RUN_TEST_CASE(Global, metisSlab_Deallocate_CacheLimit);
+    LONGBOW_RUN_TEST_CASE(Global, metisSlab_Deallocate_OtherThread);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    // put things back the way the other tests expect them
+    metisSlab_SetEnabled(false);
+    metisSlab_Drain();
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, metisSlab_Allocate_Disabled)
+{
+    assertFalse(metisSlab_IsEnabled(), "Caching should be off by default");
+
+    void *pointer = metisSlab_Allocate(40);
+    metisSlab_Deallocate(&pointer, 40);
+
+    assertNull(pointer, "Deallocate did not null the pointer");
+    assertTrue(metisSlab_CachedCount() == 0, "Nothing should be cached, got %zu", metisSlab_CachedCount());
+}
+
+LONGBOW_TEST_CASE(Global, metisSlab_Allocate_Reuse)
+{
+    metisSlab_SetEnabled(true);
+
+    void *first = metisSlab_Allocate(40);
+    void *expected = first;
+    metisSlab_Deallocate(&first, 40);
+    size_t cached = metisSlab_CachedCount();
+
+    // 33 rounds up to the same size as 40
+    void *second = metisSlab_Allocate(33);
+    metisSlab_Deallocate(&second, 33);
+
+    // 100 does not
+    void *third = metisSlab_Allocate(100);
+    bool thirdIsNew = (third != expected);
+    metisSlab_Deallocate(&third, 100);
+
+    assertTrue(cached == 1, "Wrong cached count, expected 1 got %zu", cached);
+    assertTrue(thirdIsNew, "A different size should not reuse the cached object");
+}
+
+LONGBOW_TEST_CASE(Global, metisSlab_Allocate_Large)
+{
+    metisSlab_SetEnabled(true);
+
+    void *pointer = metisSlab_Allocate(METIS_SLAB_MAX_OBJECT_SIZE + 1);
+    metisSlab_Deallocate(&pointer, METIS_SLAB_MAX_OBJECT_SIZE + 1);
+
+    assertTrue(metisSlab_CachedCount() == 0, "Large objects should not be cached, got %zu", metisSlab_CachedCount());
+}
+
+LONGBOW_TEST_CASE(Global, metisSlab_AllocateAndClear)
+{
+    metisSlab_SetEnabled(true);
+
+    uint8_t *dirty = metisSlab_Allocate(64);
+    memset(dirty, 0xFF, 64);
+    metisSlab_Deallocate((void **) &dirty, 64);
+
+    uint8_t *clean = metisSlab_AllocateAndClear(64);
+    for (int i = 0; i < 64; i++) {
+        assertTrue(clean[i] == 0, "Byte %d not cleared: %02X", i, clean[i]);
+    }
+    metisSlab_Deallocate((void **) &clean, 64);
+}
+
+LONGBOW_TEST_CASE(Global, metisSlab_Deallocate_CacheLimit)
+{
+    metisSlab_SetEnabled(true);
+
+    const size_t count = METIS_SLAB_CACHE_LIMIT + 10;
+    void **pointers = parcMemory_Allocate(count * sizeof(void *));
+    for (size_t i = 0; i < count; i++) {
+        pointers[i] = metisSlab_Allocate(16);
+    }
+    for (size_t i = 0; i < count; i++) {
+        metisSlab_Deallocate(&pointers[i], 16);
+    }
+    parcMemory_Deallocate((void **) &pointers);
+
+    assertTrue(metisSlab_CachedCount() == METIS_SLAB_CACHE_LIMIT,
+               "Wrong cached count, expected %u got %zu", METIS_SLAB_CACHE_LIMIT, metisSlab_CachedCount());
+}
+
+static void *
+_freeOnThread(void *pointer)
+{
+    metisSlab_Deallocate(&pointer, 48);
+    size_t *cached = parcMemory_Allocate(sizeof(size_t));
+    *cached = metisSlab_CachedCount();
+
+    // the thread's cache is released when it exits
+    return cached;
+}
+
+LONGBOW_TEST_CASE(Global, metisSlab_Deallocate_OtherThread)
+{
+    metisSlab_SetEnabled(true);
+
+    void *pointer = metisSlab_Allocate(48);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, _freeOnThread, pointer);
+
+    size_t *threadCached;
+    pthread_join(thread, (void **) &threadCached);
+    size_t cached = *threadCached;
+    parcMemory_Deallocate((void **) &threadCached);
+
+    assertTrue(cached == 1, "The freeing thread should have cached it, got %zu", cached);
+    assertTrue(metisSlab_CachedCount() == 0, "The allocating thread should not have it, got %zu", metisSlab_CachedCount());
+}
+
+// =================================================================
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _sizeClass);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Local, _sizeClass)
+{
+    assertTrue(_sizeClass(1) == 0, "Wrong class for 1, got %d", _sizeClass(1));
+    assertTrue(_sizeClass(METIS_SLAB_GRANULARITY) == 0, "Wrong class for granularity, got %d", _sizeClass(METIS_SLAB_GRANULARITY));
+    assertTrue(_sizeClass(METIS_SLAB_GRANULARITY + 1) == 1, "Wrong class for granularity + 1, got %d", _sizeClass(METIS_SLAB_GRANULARITY + 1));
+    assertTrue(_sizeClass(METIS_SLAB_MAX_OBJECT_SIZE) == METIS_SLAB_CLASSES - 1,
+               "Wrong class for max size, got %d", _sizeClass(METIS_SLAB_MAX_OBJECT_SIZE));
+}
+
+// =================================================================
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_Slab);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metis_SpscRing.c"
+#include <pthread.h>
+#include <sched.h>
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+
+LONGBOW_TEST_RUNNER(metis_SpscRing)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_SpscRing)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_SpscRing)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// =================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisSpscRing_Create_Destroy);
+    LONGBOW_RUN_TEST_CASE(Global, metisSpscRing_Capacity_RoundsUp);
+    LONGBOW_RUN_TEST_CASE(Global, metisSpscRing_Push_Pop_Order);
+    LONGBOW_RUN_TEST_CASE(Global, metisSpscRing_Push_Full);
+    LONGBOW_RUN_TEST_CASE(Global, metisSpscRing_Pop_Empty);
+    LONGBOW_RUN_TEST_CASE(Global, metisSpscRing_TwoThreads);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, metisSpscRing_Create_Destroy)
+{
+    MetisSpscRing *ring = metisSpscRing_Create(16);
+    assertNotNull(ring, "Got null ring");
+    assertTrue(metisSpscRing_Count(ring) == 0, "New ring should be empty");
+    metisSpscRing_Destroy(&ring);
+    assertNull(ring, "Destroy did not null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, metisSpscRing_Capacity_RoundsUp)
+{
+    MetisSpscRing *ring = metisSpscRing_Create(1000);
+    size_t capacity = metisSpscRing_Capacity(ring);
+    metisSpscRing_Destroy(&ring);
+
+    assertTrue(capacity == 1024, "Wrong capacity, expected 1024 got %zu", capacity);
+}
+
+LONGBOW_TEST_CASE(Global, metisSpscRing_Push_Pop_Order)
+{
+    int data[3];
+    MetisSpscRing *ring = metisSpscRing_Create(4);
+
+    for (unsigned i = 0; i < 3; i++) {
+        assertTrue(metisSpscRing_Push(ring, &data[i], i + 10), "Push %u failed", i);
+    }
+    assertTrue(metisSpscRing_Count(ring) == 3, "Wrong count, expected 3 got %zu", metisSpscRing_Count(ring));
+
+    for (unsigned i = 0; i < 3; i++) {
+        unsigned value;
+        void *item = metisSpscRing_Pop(ring, &value);
+        assertTrue(item == &data[i], "Item %u out of order", i);
+        assertTrue(value == i + 10, "Wrong value, expected %u got %u", i + 10, value);
+    }
+
+    metisSpscRing_Destroy(&ring);
+}
+
+LONGBOW_TEST_CASE(Global, metisSpscRing_Push_Full)
+{
+    int data;
+    MetisSpscRing *ring = metisSpscRing_Create(4);
+
+    for (unsigned i = 0; i < 4; i++) {
+        assertTrue(metisSpscRing_Push(ring, &data, i), "Push %u failed", i);
+    }
+    bool fullPush = metisSpscRing_Push(ring, &data, 4);
+
+    // a pop makes room again
+    metisSpscRing_Pop(ring, NULL);
+    bool roomPush = metisSpscRing_Push(ring, &data, 5);
+
+    metisSpscRing_Destroy(&ring);
+
+    assertFalse(fullPush, "Push on a full ring should fail");
+    assertTrue(roomPush, "Push after a pop should succeed");
+}
+
+LONGBOW_TEST_CASE(Global, metisSpscRing_Pop_Empty)
+{
+    int data;
+    MetisSpscRing *ring = metisSpscRing_Create(4);
+    void *empty = metisSpscRing_Pop(ring, NULL);
+
+    metisSpscRing_Push(ring, &data, 0);
+    metisSpscRing_Pop(ring, NULL);
+    void *drained = metisSpscRing_Pop(ring, NULL);
+
+    metisSpscRing_Destroy(&ring);
+
+    assertNull(empty, "Pop on a new ring should return NULL");
+    assertNull(drained, "Pop on a drained ring should return NULL");
+}
+
+#define TWO_THREAD_COUNT 200000
+
+static void *
+_producer(void *arg)
+{
+    MetisSpscRing *ring = (MetisSpscRing *) arg;
+    for (unsigned i = 1; i <= TWO_THREAD_COUNT; i++) {
+        while (!metisSpscRing_Push(ring, (void *) (uintptr_t) i, i)) {
+            // the consumer may be on the same core
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+LONGBOW_TEST_CASE(Global, metisSpscRing_TwoThreads)
+{
+    MetisSpscRing *ring = metisSpscRing_Create(64);
+
+    pthread_t producer;
+    pthread_create(&producer, NULL, _producer, ring);
+
+    unsigned expected = 1;
+    bool inOrder = true;
+    while (expected <= TWO_THREAD_COUNT) {
+        unsigned value;
+        void *item = metisSpscRing_Pop(ring, &value);
+        if (item != NULL) {
+            if ((uintptr_t) item != expected || value != expected) {
+                inOrder = false;
+            }
+            expected++;
+        } else {
+            sched_yield();
+        }
+    }
+
+    pthread_join(producer, NULL);
+    metisSpscRing_Destroy(&ring);
+
+    assertTrue(inOrder, "Items were lost or reordered between threads");
+}
+
+// =================================================================
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_SpscRing);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metis_Stats.c"
+#include <inttypes.h>
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+
+LONGBOW_TEST_RUNNER(metis_Stats)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_Stats)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_Stats)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// =================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisStats_Increment);
+    LONGBOW_RUN_TEST_CASE(Global, metisStats_Init);
+    LONGBOW_RUN_TEST_CASE(Global, metisStats_Name);
+    LONGBOW_RUN_TEST_CASE(Global, metisStats_ToJson_FromJson);
+    LONGBOW_RUN_TEST_CASE(Global, metisStats_FromJson_Missing);
+    LONGBOW_RUN_TEST_CASE(Global, metisStats_ContentStoreHitRatio);
+    LONGBOW_RUN_TEST_CASE(Global, metisStats_CPIRequest);
+    LONGBOW_RUN_TEST_CASE(Global, metisStats_CPIResponse);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, metisStats_Increment)
+{
+    uint64_t counter = UINT32_MAX;
+    metisStats_Increment(counter);
+    assertTrue(metisStats_Read(counter) == (uint64_t) UINT32_MAX + 1, "Counter wrapped at 32 bits: %" PRIu64, counter);
+
+    metisStats_Add(counter, 9);
+    assertTrue(metisStats_Read(counter) == (uint64_t) UINT32_MAX + 10, "Wrong counter, got %" PRIu64, counter);
+}
+
+LONGBOW_TEST_CASE(Global, metisStats_Init)
+{
+    MetisStats stats;
+    memset(&stats, 0xFF, sizeof(stats));
+    metisStats_Init(&stats);
+
+    for (MetisStat stat = 0; stat < MetisStat_END; stat++) {
+        assertTrue(stats.values[stat] == 0, "Stat %s not zeroed", metisStats_Name(stat));
+    }
+}
+
+LONGBOW_TEST_CASE(Global, metisStats_Name)
+{
+    for (MetisStat stat = 0; stat < MetisStat_END; stat++) {
+        assertNotNull(metisStats_Name(stat), "Stat %d has no name", stat);
+        for (MetisStat other = 0; other < stat; other++) {
+            assertFalse(strcmp(metisStats_Name(stat), metisStats_Name(other)) == 0,
+                        "Stats %d and %d have the same name %s", stat, other, metisStats_Name(stat));
+        }
+    }
+
+    assertTrue(strcmp(metisStats_Name(MetisStat_InterestsReceived), "processor.interestsReceived") == 0,
+               "Wrong name, got %s", metisStats_Name(MetisStat_InterestsReceived));
+}
+
+LONGBOW_TEST_CASE(Global, metisStats_ToJson_FromJson)
+{
+    MetisStats stats;
+    metisStats_Init(&stats);
+    for (MetisStat stat = 0; stat < MetisStat_END; stat++) {
+        stats.values[stat] = ((uint64_t) 1 << 40) + stat;
+    }
+
+    PARCJSON *json = metisStats_ToJson(&stats);
+    char *string = parcJSON_ToCompactString(json);
+    PARCJSON *parsed = parcJSON_ParseString(string);
+
+    MetisStats truth;
+    metisStats_FromJson(&truth, parsed);
+
+    parcJSON_Release(&parsed);
+    parcMemory_Deallocate((void **) &string);
+    parcJSON_Release(&json);
+
+    for (MetisStat stat = 0; stat < MetisStat_END; stat++) {
+        assertTrue(truth.values[stat] == stats.values[stat], "Stat %s wrong, expected %" PRIu64 " got %" PRIu64,
+                   metisStats_Name(stat), stats.values[stat], truth.values[stat]);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, metisStats_FromJson_Missing)
+{
+    PARCJSON *json = parcJSON_Create();
+    parcJSON_AddInteger(json, metisStats_Name(MetisStat_UdpFramesIn), 7);
+
+    MetisStats stats;
+    memset(&stats, 0xFF, sizeof(stats));
+    metisStats_FromJson(&stats, json);
+    parcJSON_Release(&json);
+
+    assertTrue(stats.values[MetisStat_UdpFramesIn] == 7, "Wrong framesIn, got %" PRIu64, stats.values[MetisStat_UdpFramesIn]);
+    assertTrue(stats.values[MetisStat_Received] == 0, "Missing stat should be 0, got %" PRIu64, stats.values[MetisStat_Received]);
+}
+
+LONGBOW_TEST_CASE(Global, metisStats_ContentStoreHitRatio)
+{
+    MetisStats stats;
+    metisStats_Init(&stats);
+    assertTrue(metisStats_ContentStoreHitRatio(&stats) == 0.0, "No lookups should be 0, got %f", metisStats_ContentStoreHitRatio(&stats));
+
+    stats.values[MetisStat_ContentStoreHits] = 3;
+    stats.values[MetisStat_ContentStoreMisses] = 1;
+    assertTrue(metisStats_ContentStoreHitRatio(&stats) == 0.75, "Wrong ratio, got %f", metisStats_ContentStoreHitRatio(&stats));
+}
+
+LONGBOW_TEST_CASE(Global, metisStats_CPIRequest)
+{
+    CCNxControl *request = metisStats_CreateCPIRequest();
+    bool isStats = metisStats_IsCPIRequest(request);
+    CPIMessageType type = cpi_GetMessageType(request);
+    ccnxControl_Release(&request);
+
+    assertTrue(isStats, "Request not recognized as a stats request");
+    assertTrue(type == CPI_REQUEST, "Wrong message type, expected CPI_REQUEST got %d", type);
+
+    CCNxControl *other = ccnxControl_CreateInterfaceListRequest();
+    isStats = metisStats_IsCPIRequest(other);
+    ccnxControl_Release(&other);
+
+    assertFalse(isStats, "Interface list request recognized as a stats request");
+}
+
+LONGBOW_TEST_CASE(Global, metisStats_CPIResponse)
+{
+    MetisStats stats;
+    metisStats_Init(&stats);
+    stats.values[MetisStat_InterestsReceived] = (uint64_t) UINT32_MAX + 5;
+
+    CCNxControl *request = metisStats_CreateCPIRequest();
+    CCNxControl *response = metisStats_CreateCPIResponse(request, &stats);
+
+    MetisStats truth;
+    bool success = metisStats_FromCPIResponse(&truth, response);
+    uint64_t requestSequence = cpi_GetSequenceNumber(request);
+    uint64_t responseSequence = cpi_GetSequenceNumber(response);
+    bool requestHasStats = metisStats_FromCPIResponse(&truth, request);
+
+    ccnxControl_Release(&response);
+    ccnxControl_Release(&request);
+
+    assertTrue(success, "Response did not carry the stats");
+    assertFalse(requestHasStats, "A request should not be read as a response");
+    assertTrue(requestSequence == responseSequence, "Wrong sequence, expected %" PRIu64 " got %" PRIu64, requestSequence, responseSequence);
+    assertTrue(memcmp(&truth, &stats, sizeof(MetisStats)) == 0, "Wrong stats from response");
+}
+
+// =================================================================
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_Stats);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
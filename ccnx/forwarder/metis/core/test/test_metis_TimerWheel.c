@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metis_TimerWheel.c"
+#include <LongBow/unit-test.h>
+
+#include <parc/algol/parc_SafeMemory.h>
+
+LONGBOW_TEST_RUNNER(metis_TimerWheel)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_TimerWheel)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_TimerWheel)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// =================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisTimerWheel_Create_Destroy);
+    LONGBOW_RUN_TEST_CASE(Global, metisTimerWheel_Destroy_WithTimers);
+    LONGBOW_RUN_TEST_CASE(Global, metisTimerWheel_Schedule_Expires);
+    LONGBOW_RUN_TEST_CASE(Global, metisTimerWheel_Schedule_InPast);
+    LONGBOW_RUN_TEST_CASE(Global, metisTimerWheel_Schedule_FarFuture);
+    LONGBOW_RUN_TEST_CASE(Global, metisTimerWheel_Cancel);
+    LONGBOW_RUN_TEST_CASE(Global, metisTimerWheel_Reschedule);
+    LONGBOW_RUN_TEST_CASE(Global, metisTimerWheel_Count);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, metisTimerWheel_Create_Destroy)
+{
+    MetisTimerWheel *wheel = metisTimerWheel_Create(1000);
+    assertNotNull(wheel, "Got null wheel");
+    assertTrue(metisTimerWheel_Count(wheel) == 0, "New wheel should be empty");
+    metisTimerWheel_Destroy(&wheel);
+    assertNull(wheel, "Destroy did not null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, metisTimerWheel_Destroy_WithTimers)
+{
+    int data;
+    MetisTimerWheel *wheel = metisTimerWheel_Create(0);
+    metisTimerWheel_Schedule(wheel, 10, &data);
+    metisTimerWheel_Schedule(wheel, 100000, &data);
+    metisTimerWheel_Schedule(wheel, 0, &data);
+
+    // the teardown checks that the pending timers were freed
+    metisTimerWheel_Destroy(&wheel);
+}
+
+LONGBOW_TEST_CASE(Global, metisTimerWheel_Schedule_Expires)
+{
+    int data;
+    MetisTimerWheel *wheel = metisTimerWheel_Create(0);
+    metisTimerWheel_Schedule(wheel, 300, &data);
+
+    metisTimerWheel_Advance(wheel, 299);
+    void *early = metisTimerWheel_PopExpired(wheel);
+
+    metisTimerWheel_Advance(wheel, 300);
+    void *test = metisTimerWheel_PopExpired(wheel);
+    void *empty = metisTimerWheel_PopExpired(wheel);
+    size_t count = metisTimerWheel_Count(wheel);
+
+    metisTimerWheel_Destroy(&wheel);
+
+    assertNull(early, "Timer expired before its expiry time");
+    assertTrue(test == &data, "Wrong data, expected %p got %p", (void *) &data, test);
+    assertNull(empty, "Timer should only expire once");
+    assertTrue(count == 0, "Wheel should be empty, got %zu", count);
+}
+
+LONGBOW_TEST_CASE(Global, metisTimerWheel_Schedule_InPast)
+{
+    int data;
+    MetisTimerWheel *wheel = metisTimerWheel_Create(500);
+    metisTimerWheel_Schedule(wheel, 100, &data);
+
+    void *test = metisTimerWheel_PopExpired(wheel);
+    metisTimerWheel_Destroy(&wheel);
+
+    assertTrue(test == &data, "A timer in the past should be immediately expired");
+}
+
+/**
+ * A timer several levels up must cascade down and fire at exactly its expiry time
+ */
+LONGBOW_TEST_CASE(Global, metisTimerWheel_Schedule_FarFuture)
+{
+    int data;
+    MetisTicks expiry = 3 * 65536 + 257;
+    MetisTimerWheel *wheel = metisTimerWheel_Create(7);
+    metisTimerWheel_Schedule(wheel, expiry, &data);
+
+    // keep a second timer so Advance has to tick through every slot
+    int other;
+    metisTimerWheel_Schedule(wheel, expiry * 2, &other);
+
+    metisTimerWheel_Advance(wheel, expiry - 1);
+    void *early = metisTimerWheel_PopExpired(wheel);
+
+    metisTimerWheel_Advance(wheel, expiry);
+    void *test = metisTimerWheel_PopExpired(wheel);
+
+    metisTimerWheel_Destroy(&wheel);
+
+    assertNull(early, "Timer expired before its expiry time");
+    assertTrue(test == &data, "Far future timer did not expire at its expiry time");
+}
+
+LONGBOW_TEST_CASE(Global, metisTimerWheel_Cancel)
+{
+    int data;
+    MetisTimerWheel *wheel = metisTimerWheel_Create(0);
+    MetisTimerWheelTimer *timer = metisTimerWheel_Schedule(wheel, 50, &data);
+
+    metisTimerWheel_Cancel(wheel, &timer);
+    metisTimerWheel_Advance(wheel, 100);
+    void *test = metisTimerWheel_PopExpired(wheel);
+    size_t count = metisTimerWheel_Count(wheel);
+
+    metisTimerWheel_Destroy(&wheel);
+
+    assertNull(timer, "Cancel did not null the pointer");
+    assertNull(test, "A cancelled timer expired");
+    assertTrue(count == 0, "Wheel should be empty, got %zu", count);
+}
+
+LONGBOW_TEST_CASE(Global, metisTimerWheel_Reschedule)
+{
+    int data;
+    MetisTimerWheel *wheel = metisTimerWheel_Create(0);
+    MetisTimerWheelTimer *timer = metisTimerWheel_Schedule(wheel, 50, &data);
+
+    metisTimerWheel_Reschedule(wheel, timer, 5000);
+    MetisTicks expiry = metisTimerWheelTimer_GetExpiry(timer);
+
+    metisTimerWheel_Advance(wheel, 4999);
+    void *early = metisTimerWheel_PopExpired(wheel);
+    metisTimerWheel_Advance(wheel, 5000);
+    void *test = metisTimerWheel_PopExpired(wheel);
+
+    metisTimerWheel_Destroy(&wheel);
+
+    assertTrue(expiry == 5000, "Wrong expiry, expected 5000 got %" PRIu64, expiry);
+    assertNull(early, "Rescheduled timer expired at its old time");
+    assertTrue(test == &data, "Rescheduled timer did not expire at its new time");
+}
+
+LONGBOW_TEST_CASE(Global, metisTimerWheel_Count)
+{
+    int data;
+    MetisTimerWheel *wheel = metisTimerWheel_Create(0);
+    for (int i = 1; i <= 10; i++) {
+        metisTimerWheel_Schedule(wheel, i * 1000, &data);
+    }
+
+    size_t before = metisTimerWheel_Count(wheel);
+    metisTimerWheel_Advance(wheel, 5000);
+    while (metisTimerWheel_PopExpired(wheel) != NULL) {
+        // drain
+    }
+    size_t after = metisTimerWheel_Count(wheel);
+
+    metisTimerWheel_Destroy(&wheel);
+
+    assertTrue(before == 10, "Wrong count, expected 10 got %zu", before);
+    assertTrue(after == 5, "Wrong count, expected 5 got %zu", after);
+}
+
+// =================================================================
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _metisTimerWheel_Place_Level);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Local, _metisTimerWheel_Place_Level)
+{
+    int data;
+    MetisTimerWheel *wheel = metisTimerWheel_Create(0);
+
+    // a short delay lands in level 0, a long one in a higher level
+    MetisTimerWheelTimer *near = metisTimerWheel_Schedule(wheel, 10, &data);
+    MetisTimerWheelTimer *far = metisTimerWheel_Schedule(wheel, 100000, &data);
+
+    // 100000 = 0x186A0, so it belongs in level 2 slot 0x01
+    bool nearInLevelZero = wheel->slots[0][10].next == near;
+    bool farInLevelTwo = wheel->slots[2][1].next == far;
+
+    metisTimerWheel_Cancel(wheel, &near);
+    metisTimerWheel_Cancel(wheel, &far);
+    metisTimerWheel_Destroy(&wheel);
+
+    assertTrue(nearInLevelZero, "Near timer should be in level 0");
+    assertTrue(farInLevelTwo, "Far timer should be in level 2");
+}
+
+// =================================================================
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_TimerWheel);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -735,6 +735,8 @@ _metisEtherListener_ReadCallback(int fd, PARCEventType what, void *user_data)
     }
 
     if (what & PARCEventType_Read) {
+        metisForwarder_BeginTickCache(etherListener->metis);
+
         while (true) {
             PARCEventBuffer *buffer = _metisEtherListener_ReadEtherFrame(etherListener);
 
@@ -765,5 +767,7 @@ _metisEtherListener_ReadCallback(int fd, PARCEventType what, void *user_data)
                     trapUnexpectedState("Do not understand parse result %d", result);
             }
         }
+
+        metisForwarder_EndTickCache(etherListener->metis);
     }
 }
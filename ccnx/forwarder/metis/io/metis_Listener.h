@@ -68,6 +68,7 @@
 #define Metis_metis_Listener_h
 
 #include <ccnx/api/control/cpi_Address.h>
+#include <ccnx/forwarder/metis/core/metis_Stats.h>
 
 struct metis_listener_ops;
 typedef struct metis_listener_ops MetisListenerOps;
@@ -140,5 +141,16 @@ struct metis_listener_ops {
      * @endcode
      */
     int (*getSocket)(const MetisListenerOps *ops);
+
+    /**
+     * Adds the listener's counters in to a snapshot
+     *
+     * Listeners without counters leave this NULL.  UDP adds in the counters of each of its
+     * ingress threads.  Called on the forwarder's dispatcher thread.
+     *
+     * @param [in] ops Pointer to this structure
+     * @param [in] stats The snapshot to add to
+     */
+    void (*accumulateStats)(const MetisListenerOps *ops, MetisStats *stats);
 };
 #endif // Metis_metis_Listener_h
@@ -66,6 +66,8 @@
 #include <stdbool.h>
 #include <string.h>
 #include <errno.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 #include <ccnx/forwarder/metis/io/metis_StreamConnection.h>
 #include <ccnx/forwarder/metis/core/metis_Forwarder.h>
@@ -305,11 +307,60 @@ _metisStreamConnection_GetConnectionId(const MetisIoOperations *ops)
     return stream->id;
 }
 
+/**
+ * @function _writeDirect
+ * @abstract Try to write the message straight to the socket from the message's own memory
+ * @discussion
+ *   Only valid when the output queue is empty, otherwise we would re-order the byte stream.
+ *   The socket write is non-blocking.  If the kernel takes only part of the message, the
+ *   remainder is copied to the output queue.  So in the common case a message is copied
+ *   zero times instead of once per egress connection.
+ *
+ * @return 0 on success, non-zero on error (same as metisMessage_Write)
+ */
+static int
+_writeDirect(_MetisStreamState *stream, MetisMessage *message)
+{
+    struct iovec vector;
+    metisMessage_GetIovec(message, &vector);
+
+    struct msghdr header;
+    memset(&header, 0, sizeof(header));
+    header.msg_iov = &vector;
+    header.msg_iovlen = 1;
+
+    int flags = MSG_DONTWAIT;
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#endif
+
+    ssize_t written = sendmsg(stream->fd, &header, flags);
+    if (written == (ssize_t) vector.iov_len) {
+        return 0;
+    }
+
+    if (written < 0) {
+        // Let the PARCEventQueue deal with the socket and any errors
+        written = 0;
+    }
+
+    if (metisLogger_IsLoggable(stream->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug)) {
+        metisLogger_Log(stream->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug, __func__,
+                        "connid %u direct write %zd of %zu bytes, queueing the rest",
+                        stream->id,
+                        written,
+                        vector.iov_len);
+    }
+
+    return parcEventQueue_Write(stream->bufferEventVector, (uint8_t *) vector.iov_base + written, vector.iov_len - written);
+}
+
 /**
  * @function metisStreamConnection_Send
  * @abstract Non-destructive send of the message.
  * @discussion
- *   Send uses metisMessage_CopyToStreamBuffer, which is a non-destructive write.
+ *   If the output queue is empty, send writes the message directly from its own memory.
+ *   Otherwise, Send uses metisMessage_Write, which is a non-destructive write.
  *   The send may fail if there's no buffer space in the output queue.
  *
  * @param dummy is ignored.  A stream has only one peer.
@@ -337,7 +388,13 @@ _metisStreamConnection_Send(MetisIoOperations *ops, const CPIAddress *dummy, Met
                                 buffer_backlog);
             }
 
-            int failure = metisMessage_Write(stream->bufferEventVector, message);
+            int failure;
+            if (buffer_backlog == 0) {
+                failure = _writeDirect(stream, message);
+            } else {
+                failure = metisMessage_Write(stream->bufferEventVector, message);
+            }
+
             if (failure == 0) {
                 success = true;
             }
@@ -502,6 +559,8 @@ _conn_readcb(PARCEventQueue *event, PARCEventType type, void *ioOpsVoid)
 
     PARCEventBuffer *input = parcEventBuffer_GetQueueBufferInput(event);
 
+    metisForwarder_BeginTickCache(stream->metis);
+
     // drain the input buffer
     while (parcEventBuffer_GetLength(input) >= metisTlv_FixedHeaderLength() && parcEventBuffer_GetLength(input) >= stream->nextMessageLength) {
         // this may set the stream->nextMessageLength
@@ -512,6 +571,8 @@ _conn_readcb(PARCEventQueue *event, PARCEventType type, void *ioOpsVoid)
         }
     }
 
+    metisForwarder_EndTickCache(stream->metis);
+
     if (stream->nextMessageLength == 0) {
         // we don't have the next header, so set it to the header length
         metisStreamBuffer_SetWatermark(event, true, false, metisTlv_FixedHeaderLength(), 0);
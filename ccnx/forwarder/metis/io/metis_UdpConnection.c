@@ -55,7 +55,9 @@
 /**
  * Embodies the reader/writer for a UDP connection
  *
- * NB The Send() function may overflow the output buffer
+ * The Send() function queues the message by reference.  The queue is flushed with a single
+ * sendmmsg() (on Linux) after the current dispatcher callback finishes, or immediately if
+ * the queue fills up.  If the socket buffer is full, the remaining messages are dropped and counted.
  *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
@@ -65,6 +67,9 @@
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
+#include <inttypes.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 #include <ccnx/forwarder/metis/io/metis_UdpConnection.h>
 
@@ -77,6 +82,45 @@
 #include <parc/algol/parc_Memory.h>
 #include <ccnx/forwarder/metis/tlv/metis_Tlv.h>
 
+/**
+ * The maximum number of messages queued on a connection between flushes.
+ */
+#define METIS_UDP_TX_QUEUE_LENGTH 64
+
+#if defined(__linux__)
+typedef struct mmsghdr _MetisUdpMessageHeader;
+#else
+typedef struct metis_udp_message_header {
+    struct msghdr msg_hdr;
+    unsigned msg_len;
+} _MetisUdpMessageHeader;
+#endif
+
+/**
+ * @constant framesQueued is the number of messages passed to Send()
+ * @constant framesSent is the number of messages the kernel accepted
+ * @constant framesDropped is the number of messages dropped because of a full socket buffer or error
+ * @constant sendBatches is the number of flushes of the transmit queue
+ */
+typedef struct metis_udp_tx_stats {
+    uint64_t framesQueued;
+    uint64_t framesSent;
+    uint64_t framesDropped;
+    uint64_t sendBatches;
+} _MetisUdpTxStats;
+
+/**
+ * Messages waiting to be sent.  We store a reference to each message (not a copy)
+ * and point the iovecs at the message's bytes.
+ */
+typedef struct metis_udp_tx_queue {
+    size_t length;
+    MetisMessage *messages[METIS_UDP_TX_QUEUE_LENGTH];
+    struct iovec iovecs[METIS_UDP_TX_QUEUE_LENGTH];
+    _MetisUdpMessageHeader headers[METIS_UDP_TX_QUEUE_LENGTH];
+    PARCEventTimer *flushEvent;
+} _MetisUdpTxQueue;
+
 typedef struct metis_udp_state {
     MetisForwarder *metis;
     MetisLogger *logger;
@@ -94,6 +138,9 @@ typedef struct metis_udp_state {
     bool isLocal;
     bool isUp;
     unsigned id;
+
+    _MetisUdpTxQueue txQueue;
+    _MetisUdpTxStats txStats;
 } _MetisUdpState;
 
 // Prototypes
@@ -138,6 +185,8 @@ static MetisIoOperations _template = {
 
 static void _setConnectionState(_MetisUdpState *Udp, bool isUp);
 static bool _saveSockaddr(_MetisUdpState *udpConnState, const MetisAddressPair *pair);
+static void _flushTransmitQueue(_MetisUdpState *udpConnState);
+static void _flushTransmitQueueCallback(int fd, PARCEventType which_event, void *udpConnStateVoid);
 
 MetisIoOperations *
 metisUdpConnection_Create(MetisForwarder *metis, int fd, const MetisAddressPair *pair, bool isLocal)
@@ -157,6 +206,10 @@ metisUdpConnection_Create(MetisForwarder *metis, int fd, const MetisAddressPair
         udpConnState->addressPair = metisAddressPair_Acquire(pair);
         udpConnState->isLocal = isLocal;
 
+        // creates the timer, but does not start it
+        udpConnState->txQueue.flushEvent = metisDispatcher_CreateTimer(metisForwarder_GetDispatcher(metis), false,
+                                                                       _flushTransmitQueueCallback, udpConnState);
+
         // allocate a connection
         io_ops = parcMemory_AllocateAndClear(sizeof(MetisIoOperations));
         assertNotNull(io_ops, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisIoOperations));
@@ -197,6 +250,11 @@ _destroy(MetisIoOperations **opsPtr)
     assertNotNull(metisIoOperations_GetClosure(ops), "ops->context must not be null");
 
     _MetisUdpState *udpConnState = (_MetisUdpState *) metisIoOperations_GetClosure(ops);
+
+    // send anything still queued before we lose the peer address
+    _flushTransmitQueue(udpConnState);
+    metisDispatcher_DestroyTimerEvent(metisForwarder_GetDispatcher(udpConnState->metis), &udpConnState->txQueue.flushEvent);
+
     metisAddressPair_Release(&udpConnState->addressPair);
     parcMemory_Deallocate((void **) &(udpConnState->peerAddress));
 
@@ -204,8 +262,12 @@ _destroy(MetisIoOperations **opsPtr)
 
     if (metisLogger_IsLoggable(udpConnState->logger, MetisLoggerFacility_IO, PARCLogLevel_Info)) {
         metisLogger_Log(udpConnState->logger, MetisLoggerFacility_IO, PARCLogLevel_Info, __func__,
-                        "UdpConnection %p destroyed",
-                        (void *) udpConnState);
+                        "UdpConnection %p destroyed, queued %" PRIu64 " sent %" PRIu64 " dropped %" PRIu64 " batches %" PRIu64,
+                        (void *) udpConnState,
+                        udpConnState->txStats.framesQueued,
+                        udpConnState->txStats.framesSent,
+                        udpConnState->txStats.framesDropped,
+                        udpConnState->txStats.sendBatches);
     }
 
     // do not close udp->udpListenerSocket, the listener will close
@@ -262,10 +324,11 @@ _getConnectionId(const MetisIoOperations *ops)
  * @function metisUdpConnection_Send
  * @abstract Non-destructive send of the message.
  * @discussion
- *   sends a message to the peer.
+ *   Queues a reference to the message for the peer.  The queue is flushed
+ *   when the dispatcher runs the flush event or when the queue is full.
  *
  * @param dummy is ignored.  A udp connection has only one peer.
- * @return <#return#>
+ * @return true if the message was queued
  */
 static bool
 _send(MetisIoOperations *ops, const CPIAddress *dummy, MetisMessage *message)
@@ -273,24 +336,134 @@ _send(MetisIoOperations *ops, const CPIAddress *dummy, MetisMessage *message)
     assertNotNull(ops, "Parameter ops must be non-null");
     assertNotNull(message, "Parameter message must be non-null");
     _MetisUdpState *udpConnState = (_MetisUdpState *) metisIoOperations_GetClosure(ops);
+    _MetisUdpTxQueue *txQueue = &udpConnState->txQueue;
 
-    PARCEventBuffer *writeBuffer = parcEventBuffer_Create();
-    metisMessage_Append(writeBuffer, message);
+    if (txQueue->length == METIS_UDP_TX_QUEUE_LENGTH) {
+        _flushTransmitQueue(udpConnState);
+    }
 
-    const uint8_t *buffer = parcEventBuffer_Pullup(writeBuffer, -1);
-    size_t bufferLength = parcEventBuffer_GetLength(writeBuffer);
+    size_t position = txQueue->length;
+    txQueue->messages[position] = metisMessage_Acquire(message);
+    txQueue->length++;
+    udpConnState->txStats.framesQueued++;
 
-    ssize_t writeLength = sendto(udpConnState->udpListenerSocket, buffer, bufferLength, 0, udpConnState->peerAddress, udpConnState->peerAddressLength);
+    if (txQueue->length == 1) {
+        // We need to schedule the flush when a message is added to an empty queue
+        struct timeval immediateTimeout = { 0, 0 };
+        metisDispatcher_StartTimer(metisForwarder_GetDispatcher(udpConnState->metis), txQueue->flushEvent, &immediateTimeout);
+    }
 
-    // Should not assert on underrun, might just be full output socket (case 822)
-    // Should not assert here on most errors, but maybe close the connection instead (case 823)
-    assertTrue(writeLength == bufferLength,
-               "Incorrect write length %zd, expected %zd: (%d) %s",
-               writeLength, bufferLength, errno, strerror(errno));
+    return true;
+}
 
-    parcEventBuffer_Destroy(&writeBuffer);
+/**
+ * @function _sendBatch
+ * @abstract Sends up to count messages from the transmit queue starting at offset
+ * @discussion
+ *   On Linux, this is a single sendmmsg() call.  On other platforms we loop over sendmsg().
+ *
+ * @return The number of messages the kernel accepted, or -1 on error for the first message
+ */
+static int
+_sendBatch(_MetisUdpState *udpConnState, size_t offset, size_t count)
+{
+    _MetisUdpTxQueue *txQueue = &udpConnState->txQueue;
+
+#if defined(__linux__)
+    return sendmmsg(udpConnState->udpListenerSocket, &txQueue->headers[offset], (unsigned) count, MSG_DONTWAIT);
+#else
+    int sent = 0;
+    while (sent < count) {
+        ssize_t writeLength = sendmsg(udpConnState->udpListenerSocket, &txQueue->headers[offset + sent].msg_hdr, MSG_DONTWAIT);
+        if (writeLength < 0) {
+            return (sent > 0) ? sent : -1;
+        }
+        sent++;
+    }
+    return sent;
+#endif
+}
 
-    return true;
+/**
+ * @function _isBackpressure
+ * @abstract True if the errno means the socket buffer is full
+ */
+static bool
+_isBackpressure(int error)
+{
+    return (error == EAGAIN || error == EWOULDBLOCK || error == ENOBUFS);
+}
+
+/**
+ * @function _flushTransmitQueue
+ * @abstract Sends all the queued messages and releases our references to them
+ * @discussion
+ *   A full socket buffer is not an error (case 822).  We drop what's left in the queue
+ *   and count the drops.  Any other error drops only the message that caused it (case 823).
+ */
+static void
+_flushTransmitQueue(_MetisUdpState *udpConnState)
+{
+    _MetisUdpTxQueue *txQueue = &udpConnState->txQueue;
+    if (txQueue->length == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < txQueue->length; i++) {
+        metisMessage_GetIovec(txQueue->messages[i], &txQueue->iovecs[i]);
+
+        struct msghdr *header = &txQueue->headers[i].msg_hdr;
+        memset(header, 0, sizeof(struct msghdr));
+        header->msg_name = udpConnState->peerAddress;
+        header->msg_namelen = udpConnState->peerAddressLength;
+        header->msg_iov = &txQueue->iovecs[i];
+        header->msg_iovlen = 1;
+    }
+
+    udpConnState->txStats.sendBatches++;
+
+    size_t position = 0;
+    while (position < txQueue->length) {
+        int sent = _sendBatch(udpConnState, position, txQueue->length - position);
+        if (sent > 0) {
+            udpConnState->txStats.framesSent += sent;
+            position += sent;
+        } else {
+            int myerrno = errno;
+            if (_isBackpressure(myerrno)) {
+                size_t dropped = txQueue->length - position;
+                udpConnState->txStats.framesDropped += dropped;
+                position = txQueue->length;
+
+                if (metisLogger_IsLoggable(udpConnState->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug)) {
+                    metisLogger_Log(udpConnState->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug, __func__,
+                                    "UdpConnection %p socket full, dropped %zu messages (total dropped %" PRIu64 ")",
+                                    (void *) udpConnState, dropped, udpConnState->txStats.framesDropped);
+                }
+            } else {
+                udpConnState->txStats.framesDropped++;
+                position++;
+
+                if (metisLogger_IsLoggable(udpConnState->logger, MetisLoggerFacility_IO, PARCLogLevel_Warning)) {
+                    metisLogger_Log(udpConnState->logger, MetisLoggerFacility_IO, PARCLogLevel_Warning, __func__,
+                                    "UdpConnection %p send error, dropped message: (%d) %s",
+                                    (void *) udpConnState, myerrno, strerror(myerrno));
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < txQueue->length; i++) {
+        metisMessage_Release(&txQueue->messages[i]);
+    }
+    txQueue->length = 0;
+}
+
+static void
+_flushTransmitQueueCallback(int fd, PARCEventType which_event, void *udpConnStateVoid)
+{
+    _MetisUdpState *udpConnState = (_MetisUdpState *) udpConnStateVoid;
+    _flushTransmitQueue(udpConnState);
 }
 
 static CPIConnectionType
@@ -53,6 +53,16 @@
  * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
  */
 /**
+ * When the configuration asks for more than one socket per UDP listener, the listener opens that
+ * many SO_REUSEPORT sockets on its address and the kernel spreads peers across them.  The first
+ * socket is read on the forwarder's dispatcher exactly as with a single socket.  Each other socket
+ * is read by an ingress thread with its own dispatcher, which does the system calls and parses the
+ * datagrams, then passes a batch of messages to the forwarder's dispatcher through a MetisMailbox.
+ *
+ * The dispatcher thread looks up or creates the connection for each message's peer, so the
+ * connection table and the connection ids stay owned by one thread.  UDP connections always send
+ * on the first socket, which has the same local address and port as the others.
+ *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
  */
@@ -64,7 +74,11 @@
 #include <string.h>
 #include <errno.h>
 #include <arpa/inet.h>
+#include <pthread.h>
+#include <signal.h>
 #include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 #include <ccnx/forwarder/metis/io/metis_UdpListener.h>
 #include <ccnx/forwarder/metis/io/metis_UdpConnection.h>
@@ -73,17 +87,110 @@
 #include <ccnx/forwarder/metis/core/metis_Connection.h>
 #include <ccnx/forwarder/metis/tlv/metis_Tlv.h>
 #include <ccnx/forwarder/metis/core/metis_Message.h>
+#include <ccnx/forwarder/metis/core/metis_Mailbox.h>
+#include <ccnx/forwarder/metis/core/metis_SpscRing.h>
+#include <ccnx/forwarder/metis/core/metis_Stats.h>
+#include <ccnx/forwarder/metis/core/metis_CacheLine.h>
+#include <ccnx/forwarder/metis/config/metis_Configuration.h>
 #include <ccnx/forwarder/metis/messenger/metis_Messenger.h>
 
 #include <LongBow/runtime.h>
 #include <parc/algol/parc_Memory.h>
 
+/**
+ * The number of datagrams we try to read per read event.  On Linux this is done
+ * with a single recvmmsg() system call.
+ */
+#define METIS_UDP_RECEIVE_BATCH 16
+
+/**
+ * Each slot in the receive ring can hold the largest possible UDP payload, so a datagram is
+ * never truncated.  A CCNx packet length is a 16-bit field, so it cannot be larger either.
+ */
+#define METIS_UDP_MAX_DATAGRAM 65536
+
+/**
+ * The batches that may be queued from one ingress thread to the forwarder's dispatcher
+ */
+#define METIS_UDP_INGRESS_QUEUE 256
+
+/**
+ * The most batches the forwarder's dispatcher delivers per callback, so an ingress thread
+ * cannot starve the other sockets
+ */
+#define METIS_UDP_INGRESS_DELIVER 16
+
+#if defined(__linux__)
+typedef struct mmsghdr _MetisUdpMessageHeader;
+#else
+typedef struct metis_udp_message_header {
+    struct msghdr msg_hdr;
+    unsigned msg_len;
+} _MetisUdpMessageHeader;
+#endif
+
+/**
+ * A pre-allocated set of receive buffers.  The datagrams are read directly into the buffers
+ * and the fixed header is parsed in place, so we do not need to MSG_PEEK the header
+ * nor allocate a PARCEventBuffer per datagram just to read it.
+ */
+typedef struct metis_udp_receive_ring {
+    uint8_t *buffers;
+    struct iovec iovecs[METIS_UDP_RECEIVE_BATCH];
+    struct sockaddr_storage peers[METIS_UDP_RECEIVE_BATCH];
+    _MetisUdpMessageHeader headers[METIS_UDP_RECEIVE_BATCH];
+} _MetisUdpReceiveRing;
+
 typedef struct metis_udp_stats {
     uint64_t framesIn;
     uint64_t framesError;
     uint64_t framesReceived;
+    uint64_t readBatches;
 } _MetisUdpStats;
 
+/**
+ * The messages parsed from one read on an ingress socket.  Their ingress connection id is
+ * not known until the forwarder's dispatcher resolves the peers.
+ */
+typedef struct metis_udp_ingress_batch {
+    unsigned count;
+    MetisMessage *messages[METIS_UDP_RECEIVE_BATCH];
+    struct sockaddr_storage peers[METIS_UDP_RECEIVE_BATCH];
+    socklen_t peerLengths[METIS_UDP_RECEIVE_BATCH];
+} _MetisUdpIngressBatch;
+
+/**
+ * One additional SO_REUSEPORT socket and the thread that reads it
+ */
+typedef struct metis_udp_ingress {
+    MetisUdpListener *udp;
+    MetisSocketType socket;
+
+    pthread_t thread;
+    MetisDispatcher *dispatcher;
+    PARCEvent *readEvent;
+    _MetisUdpReceiveRing *ring;
+
+    // ingress thread to the forwarder's dispatcher
+    MetisMailbox *batches;
+
+    // the forwarder's dispatcher back to the ingress thread, emptied batches to reuse
+    MetisSpscRing *spares;
+
+    // the batch being filled, owned by the ingress thread
+    _MetisUdpIngressBatch *current;
+
+    // wakes the ingress thread to look at stopRequested
+    MetisMailbox *control;
+    bool stopRequested;
+
+    // written by the ingress thread, on their own cache lines
+    uint8_t statsPadBefore[METIS_CACHE_LINE_SIZE];
+    _MetisUdpStats stats;
+    uint64_t batchesDropped;
+    uint8_t statsPadAfter[METIS_CACHE_LINE_SIZE];
+} _MetisUdpIngress;
+
 struct metis_udp_listener {
     MetisForwarder *metis;
     MetisLogger *logger;
@@ -96,7 +203,13 @@ struct metis_udp_listener {
     unsigned id;
     CPIAddress *localAddress;
 
+    _MetisUdpReceiveRing *ring;
+
     _MetisUdpStats stats;
+
+    // the other SO_REUSEPORT sockets on localAddress
+    unsigned ingressCount;
+    _MetisUdpIngress *ingress;
 };
 
 static void              _destroy(MetisListenerOps **listenerOpsPtr);
@@ -104,6 +217,7 @@ static unsigned          _getInterfaceIndex(const MetisListenerOps *ops);
 static const CPIAddress *_getListenAddress(const MetisListenerOps *ops);
 static MetisEncapType    _getEncapType(const MetisListenerOps *ops);
 static int               _getSocket(const MetisListenerOps *ops);
+static void              _accumulateStats(const MetisListenerOps *ops, MetisStats *stats);
 
 static MetisListenerOps udpTemplate = {
     .context           = NULL,
@@ -111,10 +225,90 @@ static MetisListenerOps udpTemplate = {
     .getInterfaceIndex = &_getInterfaceIndex,
     .getListenAddress  = &_getListenAddress,
     .getEncapType      = &_getEncapType,
-    .getSocket         = &_getSocket
+    .getSocket         = &_getSocket,
+    .accumulateStats   = &_accumulateStats
 };
 
 static void _readcb(int fd, PARCEventType what, void *udpVoid);
+static void _startIngress(MetisUdpListener *udp, int family, const struct sockaddr *address, socklen_t addressLength);
+static void _stopIngress(MetisUdpListener *udp);
+
+static _MetisUdpReceiveRing *
+_receiveRing_Create(void)
+{
+    _MetisUdpReceiveRing *ring = parcMemory_AllocateAndClear(sizeof(_MetisUdpReceiveRing));
+    assertNotNull(ring, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_MetisUdpReceiveRing));
+
+    size_t bufferLength = METIS_UDP_RECEIVE_BATCH * METIS_UDP_MAX_DATAGRAM;
+    ring->buffers = parcMemory_Allocate(bufferLength);
+    assertNotNull(ring->buffers, "parcMemory_Allocate(%zu) returned NULL", bufferLength);
+
+    for (int i = 0; i < METIS_UDP_RECEIVE_BATCH; i++) {
+        ring->iovecs[i].iov_base = ring->buffers + i * METIS_UDP_MAX_DATAGRAM;
+        ring->iovecs[i].iov_len = METIS_UDP_MAX_DATAGRAM;
+        ring->headers[i].msg_hdr.msg_iov = &ring->iovecs[i];
+        ring->headers[i].msg_hdr.msg_iovlen = 1;
+        ring->headers[i].msg_hdr.msg_name = &ring->peers[i];
+        ring->headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+    }
+
+    return ring;
+}
+
+static void
+_receiveRing_Destroy(_MetisUdpReceiveRing **ringPtr)
+{
+    _MetisUdpReceiveRing *ring = *ringPtr;
+    parcMemory_Deallocate((void **) &ring->buffers);
+    parcMemory_Deallocate((void **) &ring);
+    *ringPtr = NULL;
+}
+
+/**
+ * Opens a non-blocking UDP socket
+ *
+ * @param family AF_INET or AF_INET6
+ * @param reusePort If true, also sets SO_REUSEPORT so other sockets may bind the same address
+ */
+static MetisSocketType
+_openSocket(int family, bool reusePort)
+{
+    MetisSocketType fd = socket(family, SOCK_DGRAM, 0);
+    assertFalse(fd < 0, "Error opening UDP socket: (%d) %s", errno, strerror(errno));
+
+    // Set non-blocking flag
+    int flags = fcntl(fd, F_GETFL, NULL);
+    assertTrue(flags != -1, "fcntl failed to obtain file descriptor flags (%d)", errno);
+    int failure = fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    assertFalse(failure, "fcntl failed to set file descriptor flags (%d)", errno);
+
+    int one = 1;
+    // don't hang onto address after listener has closed
+    failure = setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, (void *) &one, (socklen_t) sizeof(one));
+    assertFalse(failure, "failed to set REUSEADDR on socket(%d)", errno);
+
+#if defined(SO_REUSEPORT)
+    if (reusePort) {
+        failure = setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, (void *) &one, (socklen_t) sizeof(one));
+        assertFalse(failure, "failed to set REUSEPORT on socket(%d)", errno);
+    }
+#endif
+
+    return fd;
+}
+
+/**
+ * The number of sockets to open for a listener, 1 if the system does not have SO_REUSEPORT
+ */
+static unsigned
+_socketCount(MetisForwarder *metis)
+{
+#if defined(SO_REUSEPORT)
+    return metisConfiguration_GetUdpSocketsPerListener(metisForwarder_GetConfiguration(metis));
+#else
+    return 1;
+#endif
+}
 
 MetisListenerOps *
 metisUdpListener_CreateInet6(MetisForwarder *metis, struct sockaddr_in6 sin6)
@@ -128,25 +322,23 @@ metisUdpListener_CreateInet6(MetisForwarder *metis, struct sockaddr_in6 sin6)
     udp->localAddress = cpiAddress_CreateFromInet6(&sin6);
     udp->id = metisForwarder_GetNextConnectionId(metis);
 
-    udp->udp_socket = socket(AF_INET6, SOCK_DGRAM, 0);
-    assertFalse(udp->udp_socket < 0, "Error opening UDP socket: (%d) %s", errno, strerror(errno));
-
-    // Set non-blocking flag
-    int flags = fcntl(udp->udp_socket, F_GETFL, NULL);
-    assertTrue(flags != -1, "fcntl failed to obtain file descriptor flags (%d)", errno);
-    int failure = fcntl(udp->udp_socket, F_SETFL, flags | O_NONBLOCK);
-    assertFalse(failure, "fcntl failed to set file descriptor flags (%d)", errno);
+    unsigned socketCount = _socketCount(metis);
+    udp->udp_socket = _openSocket(AF_INET6, socketCount > 1);
 
-    int one = 1;
-    // don't hang onto address after listener has closed
-    failure = setsockopt(udp->udp_socket, SOL_SOCKET, SO_REUSEADDR, (void *) &one, (socklen_t) sizeof(one));
-    assertFalse(failure, "failed to set REUSEADDR on socket(%d)", errno);
-
-    failure = bind(udp->udp_socket, (struct sockaddr *) &sin6, sizeof(sin6));
+    int failure = bind(udp->udp_socket, (struct sockaddr *) &sin6, sizeof(sin6));
     if (failure == 0) {
+        udp->ring = _receiveRing_Create();
         udp->udp_event = metisDispatcher_CreateNetworkEvent(metisForwarder_GetDispatcher(metis), true, _readcb, (void *) udp, udp->udp_socket);
         metisDispatcher_StartNetworkEvent(metisForwarder_GetDispatcher(metis), udp->udp_event);
 
+        if (socketCount > 1) {
+            udp->ingress = parcMemory_AllocateAndClear(sizeof(_MetisUdpIngress) * (socketCount - 1));
+            assertNotNull(udp->ingress, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_MetisUdpIngress) * (socketCount - 1));
+            for (unsigned i = 1; i < socketCount; i++) {
+                _startIngress(udp, AF_INET6, (struct sockaddr *) &sin6, sizeof(sin6));
+            }
+        }
+
         ops = parcMemory_AllocateAndClear(sizeof(MetisListenerOps));
         assertNotNull(ops, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisListenerOps));
         memcpy(ops, &udpTemplate, sizeof(MetisListenerOps));
@@ -189,25 +381,23 @@ metisUdpListener_CreateInet(MetisForwarder *metis, struct sockaddr_in sin)
     udp->localAddress = cpiAddress_CreateFromInet(&sin);
     udp->id = metisForwarder_GetNextConnectionId(metis);
 
-    udp->udp_socket = socket(AF_INET, SOCK_DGRAM, 0);
-    assertFalse(udp->udp_socket < 0, "Error opening UDP socket: (%d) %s", errno, strerror(errno));
-
-    // Set non-blocking flag
-    int flags = fcntl(udp->udp_socket, F_GETFL, NULL);
-    assertTrue(flags != -1, "fcntl failed to obtain file descriptor flags (%d)", errno);
-    int failure = fcntl(udp->udp_socket, F_SETFL, flags | O_NONBLOCK);
-    assertFalse(failure, "fcntl failed to set file descriptor flags (%d)", errno);
-
-    int one = 1;
-    // don't hang onto address after listener has closed
-    failure = setsockopt(udp->udp_socket, SOL_SOCKET, SO_REUSEADDR, (void *) &one, (socklen_t) sizeof(one));
-    assertFalse(failure, "failed to set REUSEADDR on socket(%d)", errno);
+    unsigned socketCount = _socketCount(metis);
+    udp->udp_socket = _openSocket(AF_INET, socketCount > 1);
 
-    failure = bind(udp->udp_socket, (struct sockaddr *) &sin, sizeof(sin));
+    int failure = bind(udp->udp_socket, (struct sockaddr *) &sin, sizeof(sin));
     if (failure == 0) {
+        udp->ring = _receiveRing_Create();
         udp->udp_event = metisDispatcher_CreateNetworkEvent(metisForwarder_GetDispatcher(metis), true, _readcb, (void *) udp, udp->udp_socket);
         metisDispatcher_StartNetworkEvent(metisForwarder_GetDispatcher(metis), udp->udp_event);
 
+        if (socketCount > 1) {
+            udp->ingress = parcMemory_AllocateAndClear(sizeof(_MetisUdpIngress) * (socketCount - 1));
+            assertNotNull(udp->ingress, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_MetisUdpIngress) * (socketCount - 1));
+            for (unsigned i = 1; i < socketCount; i++) {
+                _startIngress(udp, AF_INET, (struct sockaddr *) &sin, sizeof(sin));
+            }
+        }
+
         ops = parcMemory_AllocateAndClear(sizeof(MetisListenerOps));
         assertNotNull(ops, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisListenerOps));
         memcpy(ops, &udpTemplate, sizeof(MetisListenerOps));
@@ -252,9 +442,12 @@ metisUdpListener_Destroy(MetisUdpListener **listenerPtr)
                         (void *) udp);
     }
 
+    _stopIngress(udp);
+
     close(udp->udp_socket);
     cpiAddress_Destroy(&udp->localAddress);
     metisDispatcher_DestroyNetworkEvent(metisForwarder_GetDispatcher(udp->metis), &udp->udp_event);
+    _receiveRing_Destroy(&udp->ring);
     metisLogger_Release(&udp->logger);
     parcMemory_Deallocate((void **) &udp);
     *listenerPtr = NULL;
@@ -298,101 +491,43 @@ _getSocket(const MetisListenerOps *ops)
 }
 
 static void
-_logStats(MetisUdpListener *udp, PARCLogLevel level)
+_addStats(MetisStats *stats, const _MetisUdpStats *udpStats)
 {
-    if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, level)) {
-        metisLogger_Log(udp->logger, MetisLoggerFacility_IO, level, __func__,
-                        "UdpListener %p frames in %" PRIu64 ", errors %" PRIu64 " ok %" PRIu64,
-                        (void *) udp,
-                        udp->stats.framesIn,
-                        udp->stats.framesError,
-                        udp->stats.framesReceived);
-    }
+    stats->values[MetisStat_UdpFramesIn] += metisStats_Read(udpStats->framesIn);
+    stats->values[MetisStat_UdpFramesError] += metisStats_Read(udpStats->framesError);
+    stats->values[MetisStat_UdpFramesReceived] += metisStats_Read(udpStats->framesReceived);
+    stats->values[MetisStat_UdpReadBatches] += metisStats_Read(udpStats->readBatches);
 }
 
-
-// =====================================================================
-
-/**
- * @function peekMesageLength
- * @abstract Peek at the next packet to learn its length by reading the fixed header
- * @discussion
- *   <#Discussion#>
- *
- * @param <#param1#>
- * @return <#return#>
- */
-static size_t
-_peekMessageLength(MetisUdpListener *udp, int fd, struct sockaddr *peerIpAddress, socklen_t *peerIpAddressLengthPtr)
+static void
+_accumulateStats(const MetisListenerOps *ops, MetisStats *stats)
 {
-    size_t packetLength = 0;
-
-    uint8_t fixedHeader[metisTlv_FixedHeaderLength()];
-
-    // peek at the UDP packet and read in the fixed header.
-    // Also returns the socket information for the remote peer
-
-    ssize_t readLength = recvfrom(fd, fixedHeader, metisTlv_FixedHeaderLength(), MSG_PEEK, (struct sockaddr *) peerIpAddress, peerIpAddressLengthPtr);
-
-	if( readLength == -1 ){
-	  return -1;
-	}
-
-    if (readLength == metisTlv_FixedHeaderLength()) {
-        packetLength = metisTlv_TotalPacketLength(fixedHeader);
-    } else {
-        if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Warning)) {
-            metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Warning, __func__,
-                            "read %zu bytes from fd %d, wrong size for a FixedHeader",
-                            readLength,
-                            fd);
-        }
+    MetisUdpListener *udp = (MetisUdpListener *) ops->context;
 
-        if (readLength < 0) {
-            if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Error)) {
-                metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Error, __func__,
-                                "Error reading fd %d: (%d) %s", fd, errno, strerror(errno));
-            }
-        }
+    _addStats(stats, &udp->stats);
+    for (unsigned i = 0; i < udp->ingressCount; i++) {
+        _addStats(stats, &udp->ingress[i].stats);
+        stats->values[MetisStat_UdpBatchesDropped] += metisStats_Read(udp->ingress[i].batchesDropped);
     }
-
-    return packetLength;
 }
 
-static MetisMessage *
-_readMessage(MetisForwarder *metis, unsigned connid, int fd, size_t packetLength)
+static void
+_logStats(MetisUdpListener *udp, const _MetisUdpStats *stats, PARCLogLevel level)
 {
-    PARCEventBuffer *readbuffer = parcEventBuffer_Create();
-    int readLength = parcEventBuffer_ReadFromFileDescriptor(readbuffer, fd, packetLength);
-
-    MetisMessage *message = NULL;
-    if (readLength == packetLength) {
-        message = metisMessage_CreateFromBuffer(connid, metisForwarder_GetTicks(metis), readbuffer, metisForwarder_GetLogger(metis));
-
-        // because metisMessage_CreateFromBuffer takes ownership of readbuffer, if there is
-        // an error and it returns null, metisMessage_CreateFromBuffer will destroy the readbuffer.
-    } else {
-        parcEventBuffer_Destroy(&readbuffer);
-
-        if (metisLogger_IsLoggable(metisForwarder_GetLogger(metis), MetisLoggerFacility_IO, PARCLogLevel_Warning)) {
-            metisLogger_Log(metisForwarder_GetLogger(metis), MetisLoggerFacility_IO, PARCLogLevel_Warning, __func__,
-                            "read %d bytes from fd %d, expected %zu",
-                            readLength,
-                            fd,
-                            packetLength);
-        }
-
-        if (readLength < 0) {
-            if (metisLogger_IsLoggable(metisForwarder_GetLogger(metis), MetisLoggerFacility_IO, PARCLogLevel_Error)) {
-                metisLogger_Log(metisForwarder_GetLogger(metis), MetisLoggerFacility_IO, PARCLogLevel_Error, __func__,
-                                "Error reading fd %d: (%d) %s", fd, errno, strerror(errno));
-            }
-        }
+    if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, level)) {
+        metisLogger_Log(udp->logger, MetisLoggerFacility_IO, level, __func__,
+                        "UdpListener %p frames in %" PRIu64 ", errors %" PRIu64 " ok %" PRIu64 " batches %" PRIu64,
+                        (void *) udp,
+                        stats->framesIn,
+                        stats->framesError,
+                        stats->framesReceived,
+                        stats->readBatches);
     }
-
-    return message;
 }
 
+
+// =====================================================================
+
 /**
  * @function _constructAddressPair
  * @abstract Creates the address pair that uniquely identifies the connection
@@ -476,8 +611,53 @@ _createNewConnection(MetisUdpListener *udp, int fd, const MetisAddressPair *pair
     return connid;
 }
 
-static void
-_receivePacket(MetisUdpListener *udp, int fd, size_t packetLength, struct sockaddr_storage *peerIpAddress, socklen_t peerIpAddressLength)
+/**
+ * @function _validatePacketLength
+ * @abstract Parses the fixed header in place and returns the CCNx packet length
+ * @discussion
+ *   If the datagram is too short for a fixed header or shorter than the packet length in
+ *   the fixed header, returns 0.  If the datagram is longer than the packet length, the
+ *   extra bytes are ignored.
+ *
+ * @param datagram The bytes read from the socket
+ * @param datagramLength The number of bytes read from the socket
+ * @return The packet length, or 0 on error
+ */
+static size_t
+_validatePacketLength(MetisUdpListener *udp, int fd, const uint8_t *datagram, size_t datagramLength)
+{
+    size_t packetLength = 0;
+
+    if (datagramLength >= metisTlv_FixedHeaderLength()) {
+        packetLength = metisTlv_TotalPacketLength(datagram);
+        if (packetLength > datagramLength || packetLength < metisTlv_FixedHeaderLength()) {
+            if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Warning)) {
+                metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Warning, __func__,
+                                "read %zu bytes from fd %d, expected %zu",
+                                datagramLength,
+                                fd,
+                                packetLength);
+            }
+            packetLength = 0;
+        }
+    } else {
+        if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Warning)) {
+            metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Warning, __func__,
+                            "read %zu bytes from fd %d, wrong size for a FixedHeader",
+                            datagramLength,
+                            fd);
+        }
+    }
+
+    return packetLength;
+}
+
+/**
+ * @function _lookupOrCreateConnection
+ * @abstract Returns the connection id for the peer, creating the connection if necessary
+ */
+static unsigned
+_lookupOrCreateConnection(MetisUdpListener *udp, int fd, struct sockaddr_storage *peerIpAddress, socklen_t peerIpAddressLength)
 {
     unsigned connid = 0;
     MetisAddressPair *pair = _constructAddressPair(udp, (struct sockaddr *) peerIpAddress, peerIpAddressLength);
@@ -488,11 +668,22 @@ _receivePacket(MetisUdpListener *udp, int fd, size_t packetLength, struct sockad
     }
 
     metisAddressPair_Release(&pair);
+    return connid;
+}
 
-    MetisMessage *message = _readMessage(udp->metis, connid, fd, packetLength);
+/**
+ * @function _receivePacket
+ * @abstract Parses a datagram in to a message
+ * @return The message, which the caller passes on to the forwarder, or NULL if it did not parse
+ */
+static MetisMessage *
+_receivePacket(MetisUdpListener *udp, int fd, unsigned connid, const uint8_t *packet, size_t packetLength, struct sockaddr_storage *peerIpAddress)
+{
+    // this is the one copy of the packet, from the receive ring to the message
+    MetisMessage *message = metisMessage_CreateFromArray(packet, packetLength, connid, metisForwarder_GetTicks(udp->metis), udp->logger);
 
     if (message) {
-        udp->stats.framesReceived++;
+        metisStats_Increment(udp->stats.framesReceived);
 
         if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug)) {
             metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug, __func__,
@@ -504,41 +695,55 @@ _receivePacket(MetisUdpListener *udp, int fd, size_t packetLength, struct sockad
                             connid);
         }
 
-        _logStats(udp, PARCLogLevel_Debug);
-
-        metisForwarder_Receive(udp->metis, message);
+        _logStats(udp, &udp->stats, PARCLogLevel_Debug);
     } else {
-        udp->stats.framesError++;
+        metisStats_Increment(udp->stats.framesError);
         if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Warning)) {
             metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Warning, __func__,
                             "Could not parse frame from fd %d, discarding", fd);
         }
-        _logStats(udp, PARCLogLevel_Warning);
+        _logStats(udp, &udp->stats, PARCLogLevel_Warning);
     }
+
+    return message;
 }
 
-static void
-_readFrameToDiscard(MetisUdpListener *udp, int fd)
+/**
+ * @function _readBatch
+ * @abstract Reads up to METIS_UDP_RECEIVE_BATCH datagrams in to the receive ring
+ * @discussion
+ *   On Linux, this is a single recvmmsg() call.  On other platforms we loop over recvmsg()
+ *   until the socket would block, which still saves the MSG_PEEK system call per datagram.
+ *
+ * @return The number of datagrams read, or -1 on error
+ */
+static int
+_readBatch(_MetisUdpReceiveRing *ring, int fd)
 {
-    // we need to discard the frame.  Read 1 byte.  This will clear it off the stack.
-    uint8_t buffer;
-    ssize_t nread = read(fd, &buffer, 1);
-
-    udp->stats.framesError++;
+    // the kernel overwrites msg_namelen, so reset it on each read
+    for (int i = 0; i < METIS_UDP_RECEIVE_BATCH; i++) {
+        ring->headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+        ring->headers[i].msg_hdr.msg_flags = 0;
+    }
 
-    if (nread == 1) {
-        if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug)) {
-            metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug, __func__,
-                            "Discarded frame from fd %d", fd);
-        }
-        _logStats(udp, PARCLogLevel_Debug);
-    } else if (nread < 0) {
-        if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Error)) {
-            metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Error, __func__,
-                            "Error trying to discard frame from fd %d: (%d) %s", fd, errno, strerror(errno));
+#if defined(__linux__)
+    return recvmmsg(fd, ring->headers, METIS_UDP_RECEIVE_BATCH, MSG_DONTWAIT, NULL);
+#else
+    int count = 0;
+    while (count < METIS_UDP_RECEIVE_BATCH) {
+        ssize_t readLength = recvmsg(fd, &ring->headers[count].msg_hdr, MSG_DONTWAIT);
+        if (readLength < 0) {
+            break;
         }
-        _logStats(udp, PARCLogLevel_Error);
+        ring->headers[count].msg_len = (unsigned) readLength;
+        count++;
+    }
+
+    if (count == 0 && (errno != EAGAIN && errno != EWOULDBLOCK)) {
+        return -1;
     }
+    return count;
+#endif
 }
 
 static void
@@ -558,16 +763,368 @@ _readcb(int fd, PARCEventType what, void *udpVoid)
     }
 
     if (what & PARCEventType_Read) {
-        udp->stats.framesIn++;
-        struct sockaddr_storage peerIpAddress;
-        socklen_t peerIpAddressLength = sizeof(peerIpAddress);
+        // We read one batch per callback.  The event is level triggered, so if there are
+        // more datagrams waiting we will be called again without starving other sockets.
+        int count = _readBatch(udp->ring, fd);
+
+        if (count < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Error)) {
+                    metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Error, __func__,
+                                    "Error reading fd %d: (%d) %s", fd, errno, strerror(errno));
+                }
+                _logStats(udp, &udp->stats, PARCLogLevel_Error);
+            }
+            return;
+        }
+
+        metisStats_Increment(udp->stats.readBatches);
 
-        size_t packetLength = _peekMessageLength(udp, fd, (struct sockaddr *) &peerIpAddress, &peerIpAddressLength);
+        // one clock read for parsing and processing the whole read
+        metisForwarder_BeginTickCache(udp->metis);
 
+        _MetisUdpReceiveRing *ring = udp->ring;
+        struct sockaddr_storage *previousPeer = NULL;
+        socklen_t previousPeerLength = 0;
+        unsigned connid = 0;
+
+        MetisMessage *messages[METIS_UDP_RECEIVE_BATCH];
+        size_t messageCount = 0;
+
+        for (int i = 0; i < count; i++) {
+            metisStats_Increment(udp->stats.framesIn);
+
+            struct msghdr *header = &ring->headers[i].msg_hdr;
+            const uint8_t *datagram = ring->iovecs[i].iov_base;
+            size_t packetLength = 0;
+
+            if ((header->msg_flags & MSG_TRUNC) == 0) {
+                packetLength = _validatePacketLength(udp, fd, datagram, ring->headers[i].msg_len);
+            }
+
+            if (packetLength > 0) {
+                struct sockaddr_storage *peer = &ring->peers[i];
+                socklen_t peerLength = header->msg_namelen;
+
+                // consecutive datagrams from the same peer share the connection lookup
+                if (previousPeer == NULL || previousPeerLength != peerLength || memcmp(previousPeer, peer, peerLength) != 0) {
+                    connid = _lookupOrCreateConnection(udp, fd, peer, peerLength);
+                    previousPeer = peer;
+                    previousPeerLength = peerLength;
+                }
+
+                MetisMessage *message = _receivePacket(udp, fd, connid, datagram, packetLength, peer);
+                if (message != NULL) {
+                    messages[messageCount++] = message;
+                }
+            } else {
+                metisStats_Increment(udp->stats.framesError);
+                if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug)) {
+                    metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug, __func__,
+                                    "Discarded frame from fd %d", fd);
+                }
+                _logStats(udp, &udp->stats, PARCLogLevel_Debug);
+            }
+        }
+
+        // the whole read goes through the forwarder together, see metisMessageProcessor_ReceiveBatch
+        metisForwarder_ReceiveBatch(udp->metis, messageCount, messages);
+        metisForwarder_EndTickCache(udp->metis);
+    }
+}
+
+// =====================================================================
+// Ingress threads
+
+static _MetisUdpIngressBatch *
+_ingressBatch_Create(void)
+{
+    _MetisUdpIngressBatch *batch = parcMemory_AllocateAndClear(sizeof(_MetisUdpIngressBatch));
+    assertNotNull(batch, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_MetisUdpIngressBatch));
+    return batch;
+}
+
+static void
+_ingressBatch_Destroy(_MetisUdpIngressBatch **batchPtr)
+{
+    _MetisUdpIngressBatch *batch = *batchPtr;
+    for (unsigned i = 0; i < batch->count; i++) {
+        metisMessage_Release(&batch->messages[i]);
+    }
+    parcMemory_Deallocate((void **) &batch);
+    *batchPtr = NULL;
+}
+
+/**
+ * Ingress thread: the batch to fill, reusing one the dispatcher thread has emptied if there is one
+ */
+static _MetisUdpIngressBatch *
+_ingressBatch_Get(_MetisUdpIngress *ingress)
+{
+    if (ingress->current == NULL) {
+        ingress->current = metisSpscRing_Pop(ingress->spares, NULL);
+        if (ingress->current == NULL) {
+            ingress->current = _ingressBatch_Create();
+        }
+    }
+    ingress->current->count = 0;
+    return ingress->current;
+}
+
+/**
+ * Ingress thread: reads one batch of datagrams and parses them
+ *
+ * The messages carry connection id 0 until the dispatcher thread sets it in _deliverBatch.
+ */
+static void
+_ingressReadcb(int fd, PARCEventType what, void *ingressVoid)
+{
+    _MetisUdpIngress *ingress = (_MetisUdpIngress *) ingressVoid;
+    MetisUdpListener *udp = ingress->udp;
+
+    if (!(what & PARCEventType_Read)) {
+        return;
+    }
+
+    int count = _readBatch(ingress->ring, fd);
+    if (count < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Error)) {
+                metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Error, __func__,
+                                "Error reading fd %d: (%d) %s", fd, errno, strerror(errno));
+            }
+            _logStats(udp, &ingress->stats, PARCLogLevel_Error);
+        }
+        return;
+    }
+
+    metisStats_Increment(ingress->stats.readBatches);
+
+    _MetisUdpReceiveRing *ring = ingress->ring;
+    _MetisUdpIngressBatch *batch = _ingressBatch_Get(ingress);
+    MetisTicks now = metisForwarder_GetTicks(udp->metis);
+
+    for (int i = 0; i < count; i++) {
+        metisStats_Increment(ingress->stats.framesIn);
+
+        struct msghdr *header = &ring->headers[i].msg_hdr;
+        const uint8_t *datagram = ring->iovecs[i].iov_base;
+        size_t packetLength = 0;
+
+        if ((header->msg_flags & MSG_TRUNC) == 0) {
+            packetLength = _validatePacketLength(udp, fd, datagram, ring->headers[i].msg_len);
+        }
+
+        MetisMessage *message = NULL;
         if (packetLength > 0) {
-            _receivePacket(udp, fd, packetLength, &peerIpAddress, peerIpAddressLength);
+            message = metisMessage_CreateFromArray(datagram, packetLength, 0, now, udp->logger);
+        }
+
+        if (message) {
+            metisStats_Increment(ingress->stats.framesReceived);
+            batch->messages[batch->count] = message;
+            memcpy(&batch->peers[batch->count], &ring->peers[i], header->msg_namelen);
+            batch->peerLengths[batch->count] = header->msg_namelen;
+            batch->count++;
         } else {
-            _readFrameToDiscard(udp, fd);
+            metisStats_Increment(ingress->stats.framesError);
+            if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug)) {
+                metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug, __func__,
+                                "Discarded frame from fd %d", fd);
+            }
         }
     }
+
+    if (batch->count > 0) {
+        if (metisMailbox_Post(ingress->batches, batch, 0)) {
+            ingress->current = NULL;
+        } else {
+            // the dispatcher thread is behind, drop the batch as the socket buffer would have
+            metisStats_Increment(ingress->batchesDropped);
+            for (unsigned i = 0; i < batch->count; i++) {
+                metisMessage_Release(&batch->messages[i]);
+            }
+            batch->count = 0;
+
+            if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Warning)) {
+                metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Warning, __func__,
+                                "UdpListener %p fd %d queue full, dropped batch (count %" PRIu64 ")",
+                                (void *) udp, fd, ingress->batchesDropped);
+            }
+        }
+    }
+}
+
+/**
+ * Ingress thread: stops the ingress dispatcher when asked to
+ */
+static void
+_ingressControlcb(int fd, PARCEventType what, void *ingressVoid)
+{
+    _MetisUdpIngress *ingress = (_MetisUdpIngress *) ingressVoid;
+
+    metisMailbox_Acknowledge(ingress->control);
+    if (__atomic_load_n(&ingress->stopRequested, __ATOMIC_ACQUIRE)) {
+        metisDispatcher_Stop(ingress->dispatcher);
+    }
+}
+
+static void *
+_ingressRun(void *ingressVoid)
+{
+    _MetisUdpIngress *ingress = (_MetisUdpIngress *) ingressVoid;
+
+    // signals are handled by the forwarder's dispatcher
+    sigset_t blocked;
+    sigfillset(&blocked);
+    pthread_sigmask(SIG_BLOCK, &blocked, NULL);
+
+    metisDispatcher_Run(ingress->dispatcher);
+    return NULL;
+}
+
+/**
+ * Dispatcher thread: sets each message's connection, creating connections for new peers, and
+ * passes the messages to the forwarder.  New connections send on the listener's first socket.
+ */
+static void
+_deliverBatch(MetisUdpListener *udp, _MetisUdpIngressBatch *batch)
+{
+    struct sockaddr_storage *previousPeer = NULL;
+    socklen_t previousPeerLength = 0;
+    unsigned connid = 0;
+
+    for (unsigned i = 0; i < batch->count; i++) {
+        struct sockaddr_storage *peer = &batch->peers[i];
+        socklen_t peerLength = batch->peerLengths[i];
+
+        // consecutive datagrams from the same peer share the connection lookup
+        if (previousPeer == NULL || previousPeerLength != peerLength || memcmp(previousPeer, peer, peerLength) != 0) {
+            connid = _lookupOrCreateConnection(udp, udp->udp_socket, peer, peerLength);
+            previousPeer = peer;
+            previousPeerLength = peerLength;
+        }
+
+        metisMessage_SetIngressConnectionId(batch->messages[i], connid);
+    }
+
+    metisForwarder_ReceiveBatch(udp->metis, batch->count, batch->messages);
+    memset(batch->messages, 0, sizeof(batch->messages));
+    batch->count = 0;
+}
+
+/**
+ * Dispatcher thread: delivers the batches queued by one ingress thread
+ */
+static void
+_ingressDelivercb(int fd, PARCEventType what, void *ingressVoid)
+{
+    _MetisUdpIngress *ingress = (_MetisUdpIngress *) ingressVoid;
+
+    metisMailbox_Acknowledge(ingress->batches);
+
+    for (unsigned i = 0; i < METIS_UDP_INGRESS_DELIVER; i++) {
+        _MetisUdpIngressBatch *batch = metisMailbox_Take(ingress->batches, NULL);
+        if (batch == NULL) {
+            break;
+        }
+
+        _deliverBatch(ingress->udp, batch);
+        if (!metisSpscRing_Push(ingress->spares, batch, 0)) {
+            _ingressBatch_Destroy(&batch);
+        }
+    }
+
+    metisMailbox_Rearm(ingress->batches);
+}
+
+/**
+ * Opens and binds another SO_REUSEPORT socket on the listener's address and starts its thread.
+ * If the bind fails, logs an error and the listener has one fewer socket.
+ */
+static void
+_startIngress(MetisUdpListener *udp, int family, const struct sockaddr *address, socklen_t addressLength)
+{
+    _MetisUdpIngress *ingress = &udp->ingress[udp->ingressCount];
+    ingress->udp = udp;
+    ingress->socket = _openSocket(family, true);
+
+    int failure = bind(ingress->socket, address, addressLength);
+    if (failure) {
+        if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Error)) {
+            int myerrno = errno;
+            char *str = cpiAddress_ToString(udp->localAddress);
+            metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Error, __func__,
+                            "Error binding additional UDP socket to address %s: (%d) %s", str, myerrno, strerror(myerrno));
+            parcMemory_Deallocate((void **) &str);
+        }
+        close(ingress->socket);
+        memset(ingress, 0, sizeof(_MetisUdpIngress));
+        return;
+    }
+
+    ingress->ring = _receiveRing_Create();
+    ingress->dispatcher = metisDispatcher_Create(udp->logger);
+    ingress->readEvent = metisDispatcher_CreateNetworkEvent(ingress->dispatcher, true, _ingressReadcb, ingress, ingress->socket);
+    metisDispatcher_StartNetworkEvent(ingress->dispatcher, ingress->readEvent);
+    ingress->control = metisMailbox_Create(1, ingress->dispatcher, _ingressControlcb, ingress);
+
+    ingress->batches = metisMailbox_Create(METIS_UDP_INGRESS_QUEUE, metisForwarder_GetDispatcher(udp->metis), _ingressDelivercb, ingress);
+    ingress->spares = metisSpscRing_Create(METIS_UDP_INGRESS_QUEUE);
+
+    failure = pthread_create(&ingress->thread, NULL, _ingressRun, ingress);
+    assertFalse(failure, "pthread_create failed (%d) %s", failure, strerror(failure));
+
+    udp->ingressCount++;
+
+    if (metisLogger_IsLoggable(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug)) {
+        metisLogger_Log(udp->logger, MetisLoggerFacility_IO, PARCLogLevel_Debug, __func__,
+                        "UdpListener %p started ingress thread %u on fd %d",
+                        (void *) udp, udp->ingressCount, ingress->socket);
+    }
+}
+
+/**
+ * Stops every ingress thread and releases any messages still queued from them
+ */
+static void
+_stopIngress(MetisUdpListener *udp)
+{
+    for (unsigned i = 0; i < udp->ingressCount; i++) {
+        _MetisUdpIngress *ingress = &udp->ingress[i];
+
+        __atomic_store_n(&ingress->stopRequested, true, __ATOMIC_RELEASE);
+        metisMailbox_Wake(ingress->control);
+        pthread_join(ingress->thread, NULL);
+
+        _logStats(udp, &ingress->stats, PARCLogLevel_Debug);
+
+        metisDispatcher_StopNetworkEvent(ingress->dispatcher, ingress->readEvent);
+        metisDispatcher_DestroyNetworkEvent(ingress->dispatcher, &ingress->readEvent);
+        close(ingress->socket);
+        metisMailbox_Destroy(&ingress->control);
+
+        _MetisUdpIngressBatch *batch;
+        while ((batch = metisMailbox_Take(ingress->batches, NULL)) != NULL) {
+            _ingressBatch_Destroy(&batch);
+        }
+        metisMailbox_Destroy(&ingress->batches);
+
+        while ((batch = metisSpscRing_Pop(ingress->spares, NULL)) != NULL) {
+            _ingressBatch_Destroy(&batch);
+        }
+        metisSpscRing_Destroy(&ingress->spares);
+
+        if (ingress->current != NULL) {
+            _ingressBatch_Destroy(&ingress->current);
+        }
+
+        _receiveRing_Destroy(&ingress->ring);
+        metisDispatcher_Destroy(&ingress->dispatcher);
+    }
+
+    if (udp->ingress != NULL) {
+        parcMemory_Deallocate((void **) &udp->ingress);
+    }
+    udp->ingressCount = 0;
 }
@@ -420,6 +420,34 @@ LONGBOW_TEST_CASE(Local, _saveSockaddr_INET6)
 
 LONGBOW_TEST_CASE(Local, _send)
 {
+    TestData *data = longBowTestCase_GetClipBoardData(testCase);
+
+    // Create a connection from Alice to Bob
+    const CPIAddress *aliceAddress = data->listener[ALICE]->getListenAddress(data->listener[ALICE]);
+    const CPIAddress *bobAddress = data->listener[BOB]->getListenAddress(data->listener[BOB]);
+
+    MetisAddressPair *pair = metisAddressPair_Create(aliceAddress, bobAddress);
+    int fd = data->listener[ALICE]->getSocket(data->listener[ALICE]);
+    MetisIoOperations *ops = metisUdpConnection_Create(data->metis[ALICE], fd, pair, false);
+    metisAddressPair_Release(&pair);
+
+    MetisMessage *message = metisMessage_CreateFromArray(metisTestDataV1_Interest_NameA_Crc32c, sizeof(metisTestDataV1_Interest_NameA_Crc32c), 2, 3, metisForwarder_GetLogger(data->metis[ALICE]));
+
+    bool success = _send(ops, NULL, message);
+    assertTrue(success, "Send failed");
+
+    _MetisUdpState *udpConnState = (_MetisUdpState *) metisIoOperations_GetClosure(ops);
+    assertTrue(udpConnState->txQueue.length == 1, "Wrong queue length, expected 1 got %zu", udpConnState->txQueue.length);
+
+    // the flush event should run on the next turn of the dispatcher
+    _crankHandle(data);
+
+    assertTrue(udpConnState->txQueue.length == 0, "Wrong queue length, expected 0 got %zu", udpConnState->txQueue.length);
+    assertTrue(udpConnState->txStats.framesSent == 1, "Wrong frames sent, expected 1 got %" PRIu64, udpConnState->txStats.framesSent);
+    assertTrue(udpConnState->txStats.sendBatches == 1, "Wrong send batches, expected 1 got %" PRIu64, udpConnState->txStats.sendBatches);
+
+    metisMessage_Release(&message);
+    ops->destroy(&ops);
 }
 
 LONGBOW_TEST_CASE(Local, _getRemoteAddress)
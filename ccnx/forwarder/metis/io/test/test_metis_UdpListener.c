@@ -76,6 +76,8 @@
 
 #include <signal.h>
 
+#include <ccnx/forwarder/metis/config/metis_Configuration.h>
+
 // ========================================================
 
 struct test_set {
@@ -104,6 +106,26 @@ setupInetListener()
     metisDispatcher_RunDuration(metisForwarder_GetDispatcher(TestSet.metis), &((struct timeval) { 0, 10000 }));
 }
 
+static void
+setupReusePortListener(unsigned socketCount)
+{
+    struct sockaddr_in addr;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(49009);
+    inet_pton(AF_INET, "127.0.0.1", &(addr.sin_addr));
+
+    TestSet.metis = metisForwarder_Create(NULL);
+    metisConfiguration_SetUdpSocketsPerListener(metisForwarder_GetConfiguration(TestSet.metis), socketCount);
+
+    TestSet.ops = metisUdpListener_CreateInet(TestSet.metis, addr);
+    TestSet.listenAddress = cpiAddress_CreateFromInet(&addr);
+
+    // crank the handle
+    metisDispatcher_RunDuration(metisForwarder_GetDispatcher(TestSet.metis), &((struct timeval) { 0, 10000 }));
+}
+
 static void
 teardownListener()
 {
@@ -172,6 +194,7 @@ LONGBOW_TEST_RUNNER(metis_UdpListener)
     // There are bugs in the UDP code that need to be fixed. These are shown in
 	// this test. The code needs to be fixed first.
 	//LONGBOW_RUN_TEST_FIXTURE(Global_Inet6);
+    LONGBOW_RUN_TEST_FIXTURE(Global_ReusePort);
     LONGBOW_RUN_TEST_FIXTURE(Local);
 }
 
@@ -435,12 +458,110 @@ LONGBOW_TEST_CASE(Global_Inet6, metisListenerUdp_SendPacket)
 
 // ================================================================================
 
+LONGBOW_TEST_FIXTURE(Global_ReusePort)
+{
+    LONGBOW_RUN_TEST_CASE(Global_ReusePort, metisListenerUdp_CreateInet_IngressThreads);
+    LONGBOW_RUN_TEST_CASE(Global_ReusePort, metisListenerUdp_ManyPeers);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global_ReusePort)
+{
+    setupReusePortListener(3);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global_ReusePort)
+{
+    teardownListener();
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global_ReusePort, metisListenerUdp_CreateInet_IngressThreads)
+{
+    assertNotNull(TestSet.ops, "Listener failed to bind with SO_REUSEPORT");
+
+    MetisUdpListener *udp = (MetisUdpListener *) TestSet.ops->context;
+#if defined(SO_REUSEPORT)
+    assertTrue(udp->ingressCount == 2, "Wrong ingress thread count, expected 2 got %u", udp->ingressCount);
+#else
+    assertTrue(udp->ingressCount == 0, "Without SO_REUSEPORT there should be no ingress threads, got %u", udp->ingressCount);
+#endif
+}
+
+/**
+ * The kernel picks the socket for each peer, so send from enough peers that some of them land on
+ * the ingress threads.  Every peer must end up with exactly one connection, whichever socket read it.
+ */
+LONGBOW_TEST_CASE(Global_ReusePort, metisListenerUdp_ManyPeers)
+{
+    const int peerCount = 16;
+    int fds[peerCount];
+    struct sockaddr_in peerAddresses[peerCount];
+
+    struct sockaddr_in serverAddress;
+    cpiAddress_GetInet(TestSet.listenAddress, &serverAddress);
+
+    for (int i = 0; i < peerCount; i++) {
+        fds[i] = socket(PF_INET, SOCK_DGRAM, 0);
+        assertFalse(fds[i] < 0, "Error on socket: (%d) %s", errno, strerror(errno));
+
+        int failure = connect(fds[i], (struct sockaddr *) &serverAddress, sizeof(serverAddress));
+        assertFalse(failure, "Error on connect: (%d) %s", errno, strerror(errno));
+
+        socklen_t addressLength = sizeof(peerAddresses[i]);
+        failure = getsockname(fds[i], (struct sockaddr *) &peerAddresses[i], &addressLength);
+        assertFalse(failure, "Error on getsockname: (%d) %s", errno, strerror(errno));
+
+        ssize_t nwritten = write(fds[i], metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName));
+        assertTrue(nwritten == sizeof(metisTestDataV0_InterestWithName), "Error on write expected %zu got %zd", sizeof(metisTestDataV0_InterestWithName), nwritten);
+    }
+
+    // the ingress threads hand their messages to the forwarder's dispatcher, so give them a few passes
+    MetisConnectionTable *table = metisForwarder_GetConnectionTable(TestSet.metis);
+    int found = 0;
+    for (int pass = 0; pass < 100 && found < peerCount; pass++) {
+        metisDispatcher_RunDuration(metisForwarder_GetDispatcher(TestSet.metis), &((struct timeval) { 0, 10000 }));
+
+        found = 0;
+        for (int i = 0; i < peerCount; i++) {
+            CPIAddress *remote = cpiAddress_CreateFromInet(&peerAddresses[i]);
+            MetisAddressPair *pair = metisAddressPair_Create(TestSet.listenAddress, remote);
+            if (metisConnectionTable_FindByAddressPair(table, pair) != NULL) {
+                found++;
+            }
+            cpiAddress_Destroy(&remote);
+            metisAddressPair_Release(&pair);
+        }
+    }
+
+    assertTrue(found == peerCount, "Expected a connection for each of %d peers, found %d", peerCount, found);
+
+    // connection ids are only assigned on the dispatcher thread, so there is one per peer plus the listener
+    MetisUdpListener *udp = (MetisUdpListener *) TestSet.ops->context;
+    unsigned nextId = metisForwarder_GetNextConnectionId(TestSet.metis);
+    assertTrue(nextId == udp->id + peerCount + 1, "Wrong next connection id, expected %u got %u", udp->id + peerCount + 1, nextId);
+
+    for (int i = 0; i < peerCount; i++) {
+        close(fds[i]);
+    }
+}
+
+// ================================================================================
+
 LONGBOW_TEST_FIXTURE(Local)
 {
     LONGBOW_RUN_TEST_CASE(Local, _getInterfaceIndex);
     LONGBOW_RUN_TEST_CASE(Local, _getListenAddress);
     LONGBOW_RUN_TEST_CASE(Local, _getEncapType);
     LONGBOW_RUN_TEST_CASE(Local, _getSocket);
+    LONGBOW_RUN_TEST_CASE(Local, _validatePacketLength_Good);
+    LONGBOW_RUN_TEST_CASE(Local, _validatePacketLength_Short);
+    LONGBOW_RUN_TEST_CASE(Local, _validatePacketLength_TooShortForHeader);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Local)
@@ -484,6 +605,28 @@ LONGBOW_TEST_CASE(Local, _getSocket)
     assertTrue(fd > 0, "Unexpected socket, got %d, expected positive", fd);
 }
 
+LONGBOW_TEST_CASE(Local, _validatePacketLength_Good)
+{
+    MetisUdpListener *udp = (MetisUdpListener *) TestSet.ops->context;
+    size_t test = _validatePacketLength(udp, 0, metisTestDataV1_Interest_AllFields, sizeof(metisTestDataV1_Interest_AllFields));
+    assertTrue(test == sizeof(metisTestDataV1_Interest_AllFields), "Wrong length, got %zu expected %zu", test, sizeof(metisTestDataV1_Interest_AllFields));
+}
+
+LONGBOW_TEST_CASE(Local, _validatePacketLength_Short)
+{
+    // the datagram is shorter than the packet length in the fixed header
+    MetisUdpListener *udp = (MetisUdpListener *) TestSet.ops->context;
+    size_t test = _validatePacketLength(udp, 0, metisTestDataV1_Interest_AllFields, sizeof(metisTestDataV1_Interest_AllFields) - 1);
+    assertTrue(test == 0, "Truncated packet should return 0, got %zu", test);
+}
+
+LONGBOW_TEST_CASE(Local, _validatePacketLength_TooShortForHeader)
+{
+    MetisUdpListener *udp = (MetisUdpListener *) TestSet.ops->context;
+    size_t test = _validatePacketLength(udp, 0, metisTestDataV1_Interest_AllFields, metisTlv_FixedHeaderLength() - 1);
+    assertTrue(test == 0, "Partial fixed header should return 0, got %zu", test);
+}
+
 
 // ================================================================================
 
@@ -53,9 +53,7 @@
  * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
  */
 /**
- * Right now, the FIB table is sparse.  There can be an entry for /a and for /a/b/c, but
- * not for /a/b.  This means we need to exhastively lookup all the components to make sure
- * there's not a route for it.
+ * Generic interface to the FIB table
  *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
@@ -63,272 +61,54 @@
 
 #include <config.h>
 #include <stdio.h>
-
-#include <ccnx/forwarder/metis/processor/metis_FIB.h>
-#include <ccnx/forwarder/metis/processor/metis_FibEntry.h>
-#include <ccnx/forwarder/metis/processor/metis_HashTableFunction.h>
-#include <parc/algol/parc_Memory.h>
-#include <parc/algol/parc_TreeRedBlack.h>
-
 #include <LongBow/runtime.h>
 
-// =====================================================
-
-/**
- * @function hashTableFunction_FibEntryDestroyer
- * @abstract Used in the hash table to destroy the data pointer when an item's removed
- * @discussion
- *   <#Discussion#>
- *
- * @param <#param1#>
- * @return <#return#>
- */
-static void
-_hashTableFunction_FibEntryDestroyer(void **dataPtr)
-{
-    metisFibEntry_Release((MetisFibEntry **) dataPtr);
-}
-
-/**
- * @function hashTableFunction_TlvNameDestroyer
- * @abstract Used in the hash table to destroy the key pointer when an item's removed
- * @discussion
- *   <#Discussion#>
- *
- * @param <#param1#>
- * @return <#return#>
- */
-static void
-_hashTableFunction_TlvNameDestroyer(void **dataPtr)
-{
-    metisTlvName_Release((MetisTlvName **) dataPtr);
-}
-
-// =====================================================
-
-struct metis_fib {
-    // KEY = tlvName, VALUE = FibEntry
-    PARCHashCodeTable *tableByName;
-
-    // KEY = tlvName.  We use a tree for the keys because that
-    // has the same average insert and remove time.  The tree
-    // is only used by GetEntries, which in turn is used by things
-    // that want to enumerate the FIB
-    PARCTreeRedBlack *tableOfKeys;
-
-    MetisLogger *logger;
-
-    // If there are no forward paths, we return an emtpy set.  Allocate this
-    // once and return a reference to it whenever we need an empty set.
-    MetisNumberSet *emptySet;
-};
-
-static MetisFibEntry *_metisFIB_CreateFibEntry(MetisFIB *fib, MetisTlvName *tlvName);
-
-// =====================================================
-// Public API
+#include <ccnx/forwarder/metis/processor/metis_FIB.h>
 
-MetisFIB *
-metisFIB_Create(MetisLogger *logger)
+void *
+metisFIB_Closure(const MetisFIB *fib)
 {
-    unsigned initialSize = 1024;
-
-    MetisFIB *fib = parcMemory_AllocateAndClear(sizeof(MetisFIB));
-    assertNotNull(fib, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisFIB));
-    fib->emptySet = metisNumberSet_Create();
-    fib->logger = metisLogger_Acquire(logger);
-    fib->tableByName = parcHashCodeTable_Create_Size(metisHashTableFunction_TlvNameEquals,
-                                                     metisHashTableFunction_TlvNameHashCode,
-                                                     _hashTableFunction_TlvNameDestroyer,
-                                                     _hashTableFunction_FibEntryDestroyer,
-                                                     initialSize);
-
-    fib->tableOfKeys =
-        parcTreeRedBlack_Create(metisHashTableFunction_TlvNameCompare, NULL, NULL, NULL, NULL, NULL);
-
-    if (metisLogger_IsLoggable(fib->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
-        metisLogger_Log(fib->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                        "FIB %p created with initialSize %u",
-                        (void *) fib, initialSize);
-    }
-
-    return fib;
+    return fib->closure;
 }
 
 void
 metisFIB_Destroy(MetisFIB **fibPtr)
 {
-    assertNotNull(fibPtr, "Parameter must be non-null double pointer");
-    assertNotNull(*fibPtr, "Parameter must dereference to non-null pointer");
-
-    MetisFIB *fib = *fibPtr;
-
-    if (metisLogger_IsLoggable(fib->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
-        metisLogger_Log(fib->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                        "FIB %p destroyed",
-                        (void *) fib);
-    }
-
-    metisNumberSet_Release(&fib->emptySet);
-    metisLogger_Release(&fib->logger);
-    parcTreeRedBlack_Destroy(&fib->tableOfKeys);
-    parcHashCodeTable_Destroy(&fib->tableByName);
-    parcMemory_Deallocate((void **) &fib);
-    *fibPtr = NULL;
-}
-
-const MetisNumberSet *
-metisFIB_Match(MetisFIB *fib, const MetisMessage *interestMessage)
-{
-    assertNotNull(fib, "Parameter fib must be non-null");
-    assertNotNull(interestMessage, "Parameter interestMessage must be non-null");
-
-    if (metisMessage_HasName(interestMessage)) {
-        // this is NOT reference counted, don't destroy it
-        MetisTlvName *tlvName = metisMessage_GetName(interestMessage);
-        MetisFibEntry *longestMatchingFibEntry = NULL;
-
-        // because the FIB table is sparse, we need to scan all the name segments in order.
-        for (size_t i = 0; i < metisTlvName_SegmentCount(tlvName); i++) {
-            MetisTlvName *prefixName = metisTlvName_Slice(tlvName, i + 1);
-            MetisFibEntry *fibEntry = parcHashCodeTable_Get(fib->tableByName, prefixName);
-            if (fibEntry != NULL) {
-
-                // we can accept the FIB entry if it does not contain the ingress connection id or if
-                // there is more than one forward path besides the ingress connection id.
-                const MetisNumberSet *nexthops = metisFibEntry_GetNexthops(fibEntry);
-                if (!metisNumberSet_Contains(nexthops, metisMessage_GetIngressConnectionId(interestMessage)) || metisNumberSet_Length(nexthops) > 1) {
-                    longestMatchingFibEntry = fibEntry;
-                }
-            }
-            metisTlvName_Release(&prefixName);
-        }
-
-        if (longestMatchingFibEntry != NULL) {
-            // this returns a reference counted copy of the next hops
-            return metisFibEntry_GetNexthops(longestMatchingFibEntry);
-        }
-    }
-
-    // return an empty set
-    return fib->emptySet;
+    (*fibPtr)->destroy(fibPtr);
 }
 
 bool
 metisFIB_AddOrUpdate(MetisFIB *fib, CPIRouteEntry *route)
 {
-    assertNotNull(fib, "Parameter fib must be non-null");
-    assertNotNull(route, "Parameter route must be non-null");
-
-    const CCNxName *ccnxName = cpiRouteEntry_GetPrefix(route);
-    unsigned interfaceIndex = cpiRouteEntry_GetInterfaceIndex(route);
-    MetisTlvName *tlvName = metisTlvName_CreateFromCCNxName(ccnxName);
-
-    MetisFibEntry *fibEntry = parcHashCodeTable_Get(fib->tableByName, tlvName);
-    if (fibEntry == NULL) {
-        fibEntry = _metisFIB_CreateFibEntry(fib, tlvName);
-    }
-
-    metisFibEntry_AddNexthop(fibEntry, interfaceIndex);
-
-    // if anyone saved the name in a table, they copied it.
-    metisTlvName_Release(&tlvName);
-
-    return true;
+    return fib->addOrUpdate(fib, route);
 }
 
 bool
 metisFIB_Remove(MetisFIB *fib, CPIRouteEntry *route)
 {
-    assertNotNull(fib, "Parameter fib must be non-null");
-    assertNotNull(route, "Parameter route must be non-null");
-
-    bool routeRemoved = false;
-
-    const CCNxName *ccnxName = cpiRouteEntry_GetPrefix(route);
-    unsigned interfaceIndex = cpiRouteEntry_GetInterfaceIndex(route);
-    MetisTlvName *tlvName = metisTlvName_CreateFromCCNxName(ccnxName);
-
-    MetisFibEntry *fibEntry = parcHashCodeTable_Get(fib->tableByName, tlvName);
-    if (fibEntry != NULL) {
-        metisFibEntry_RemoveNexthop(fibEntry, interfaceIndex);
-        if (metisFibEntry_NexthopCount(fibEntry) == 0) {
-            parcTreeRedBlack_Remove(fib->tableOfKeys, tlvName);
-
-            // this will de-allocate the key, so must be done last
-            parcHashCodeTable_Del(fib->tableByName, tlvName);
-
-            routeRemoved = true;
-        }
-    }
-
-    metisTlvName_Release(&tlvName);
-    return routeRemoved;
+    return fib->remove(fib, route);
 }
 
-size_t
-metisFIB_Length(const MetisFIB *fib)
+void
+metisFIB_RemoveConnectionIdFromRoutes(MetisFIB *fib, unsigned connectionId)
 {
-    assertNotNull(fib, "Parameter fib must be non-null");
-    return parcHashCodeTable_Length(fib->tableByName);
+    fib->removeConnectionIdFromRoutes(fib, connectionId);
 }
 
-MetisFibEntryList *
-metisFIB_GetEntries(const MetisFIB *fib)
+const MetisNumberSet *
+metisFIB_Match(MetisFIB *fib, const MetisMessage *interestMessage)
 {
-    assertNotNull(fib, "Parameter fib must be non-null");
-    MetisFibEntryList *list = metisFibEntryList_Create();
-
-    PARCArrayList *values = parcTreeRedBlack_Values(fib->tableOfKeys);
-    for (size_t i = 0; i < parcArrayList_Size(values); i++) {
-        MetisFibEntry *original = (MetisFibEntry *) parcArrayList_Get(values, i);
-        metisFibEntryList_Append(list, original);
-    }
-    parcArrayList_Destroy(&values);
-    return list;
+    return fib->match(fib, interestMessage);
 }
 
-void
-metisFIB_RemoveConnectionIdFromRoutes(MetisFIB *fib, unsigned connectionId)
+size_t
+metisFIB_Length(const MetisFIB *fib)
 {
-    assertNotNull(fib, "Parameter fib must be non-null");
-
-    // NB: This is very inefficient.  We need a reverse-index from connectionId to FibEntry (case 814)
-
-    // Walk the entire tree and remove the connection id from every entry.
-    PARCArrayList *values = parcTreeRedBlack_Values(fib->tableOfKeys);
-    for (size_t i = 0; i < parcArrayList_Size(values); i++) {
-        MetisFibEntry *original = (MetisFibEntry *) parcArrayList_Get(values, i);
-        metisFibEntry_RemoveNexthop(original, connectionId);
-    }
-    parcArrayList_Destroy(&values);
+    return fib->length(fib);
 }
 
-// =========================================================================
-// Private API
-
-/**
- * @function metisFib_CreateFibEntry
- * @abstract Create the given FIB entry
- * @discussion
- *    PRECONDITION: You know that the FIB entry does not exist already
- *
- * @param <#param1#>
- * @return <#return#>
- */
-static MetisFibEntry *
-_metisFIB_CreateFibEntry(MetisFIB *fib, MetisTlvName *tlvName)
+MetisFibEntryList *
+metisFIB_GetEntries(const MetisFIB *fib)
 {
-    MetisFibEntry *entry = metisFibEntry_Create(tlvName);
-
-    // add a reference counted name, as we specified a key destroyer when we
-    // created the table.
-    MetisTlvName *copy = metisTlvName_Acquire(tlvName);
-    parcHashCodeTable_Add(fib->tableByName, copy, entry);
-
-    // this is an index structure.  It does not have its own destroyer functions in
-    // the data structure.  The data in this table is the same pointer as in the hash table.
-    parcTreeRedBlack_Insert(fib->tableOfKeys, copy, entry);
-
-    return entry;
+    return fib->getEntries(fib);
 }
@@ -70,6 +70,10 @@
  *
  * NB Right now, there's no strategy in the FIB, its just a list of nexthops (case 192)
  *
+ * This is the generic FIB interface.  Implementations fill in the function pointers
+ * and keep their own state in the closure, like MetisPIT.  See metis_HashFIB.h and
+ * metis_TrieFIB.h.
+ *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
  */
@@ -89,29 +93,43 @@ struct metis_fib;
 typedef struct metis_fib MetisFIB;
 
 /**
- * <#One Line Description#>
- *
- * <#Paragraphs Of Explanation#>
- *
- * @param [<#in out in,out#>] <#name#> <#description#>
+ * @typedef MetisFIBType
+ * @abstract The available FIB implementations
+ * @constant MetisFIBType_Hash A hash table of name prefixes (metis_HashFIB.h)
+ * @constant MetisFIBType_Trie A compressed name-component trie (metis_TrieFIB.h)
+ */
+typedef enum {
+    MetisFIBType_Hash,
+    MetisFIBType_Trie
+} MetisFIBType;
+
+struct metis_fib {
+    void (*destroy)(MetisFIB **fibPtr);
+    bool (*addOrUpdate)(MetisFIB *fib, CPIRouteEntry *route);
+    bool (*remove)(MetisFIB *fib, CPIRouteEntry *route);
+    void (*removeConnectionIdFromRoutes)(MetisFIB *fib, unsigned connectionId);
+    const MetisNumberSet * (*match)(MetisFIB *fib, const MetisMessage *interestMessage);
+    size_t (*length)(const MetisFIB *fib);
+    MetisFibEntryList * (*getEntries)(const MetisFIB *fib);
+    void *closure;
+};
+
+/**
+ * Returns the implementation's private state
  *
- * @return <#value#> <#explanation#>
+ * @param [in] fib An allocated FIB
  *
- * Example:
- * @code
- * <#example#>
- * @endcode
+ * @return The closure set by the implementation
  */
-MetisFIB *metisFIB_Create(MetisLogger *logger);
+void *metisFIB_Closure(const MetisFIB *fib);
 
 /**
- * <#One Line Description#>
- *
- * <#Paragraphs Of Explanation#>
+ * Destroys the FIB table and all entries contained in it.
  *
- * @param [<#in out in,out#>] <#name#> <#description#>
+ * FIB entries are reference counted, so if the user has stored one outside the FIB table
+ * it will still be valid.
  *
- * @return <#value#> <#explanation#>
+ * @param [in,out] fibPtr Double pointer to the FIB table, will be NULLed
  *
  * Example:
  * @code
@@ -154,9 +172,11 @@ bool metisFIB_Remove(MetisFIB *fib, CPIRouteEntry *route);
  * Removes the given connection ID from all routes
  *
  * Removes the given connection ID from all routes.  If that leaves a route
- * with no nexthops, the route remains in the table with an empty nexthop set.
+ * with no nexthops, the route is removed from the table, the same as if
+ * metisFIB_Remove had removed its last nexthop.
  *
- * decide if this is really the right behavior, should it remove the route? (case 815)
+ * Implementations keep a reverse index from connection ID to routes, so this
+ * only visits the routes that use the connection.
  *
  * @param [in] fib The forwarding table
  * @param [in] connectionId The connection to remove.
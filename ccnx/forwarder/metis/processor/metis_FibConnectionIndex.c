@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * The index is a hash table from connection id to the set of FIB entries routed to that connection.
+ * Each set is an open-addressed table of entry pointers with linear probing, so adding or
+ * removing one route is O(1) and removing a connection is proportional to its own routes.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#include <ccnx/forwarder/metis/processor/metis_FibConnectionIndex.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_HashCodeTable.h>
+#include <parc/algol/parc_Hash.h>
+
+#include <LongBow/runtime.h>
+
+// must be a power of 2
+#define METIS_FIB_CONNECTION_ROUTES_INITIAL_CAPACITY 8
+
+/**
+ * The set of FIB entries for one connection.  The key in the hash table points to
+ * connectionId, so the key lives as long as the routes.
+ */
+typedef struct metis_fib_connection_routes {
+    unsigned connectionId;
+
+    // open addressing with linear probing.  NULL is an empty slot.
+    const MetisFibEntry **slots;
+    size_t capacity;
+    size_t count;
+} _MetisConnectionRoutes;
+
+struct metis_fib_connection_index {
+    // KEY = &routes->connectionId, VALUE = _MetisConnectionRoutes
+    PARCHashCodeTable *tableById;
+};
+
+// =====================================================
+
+static bool
+_hashTableFunction_ConnectionIdEquals(const void *keyA, const void *keyB)
+{
+    unsigned idA = *((const unsigned *) keyA);
+    unsigned idB = *((const unsigned *) keyB);
+    return (idA == idB);
+}
+
+static HashCodeType
+_hashTableFunction_ConnectionIdHashCode(const void *keyA)
+{
+    unsigned idA = *((const unsigned *) keyA);
+    return parcHash32_Int32(idA);
+}
+
+static void
+_hashTableFunction_ConnectionRoutesDestroyer(void **dataPtr)
+{
+    _MetisConnectionRoutes *routes = (_MetisConnectionRoutes *) *dataPtr;
+    parcMemory_Deallocate((void **) &routes->slots);
+    parcMemory_Deallocate((void **) &routes);
+    *dataPtr = NULL;
+}
+
+// =====================================================
+
+static size_t
+_metisConnectionRoutes_Home(const _MetisConnectionRoutes *routes, const MetisFibEntry *fibEntry)
+{
+    return parcHash32_Int64((uint64_t) (uintptr_t) fibEntry) & (routes->capacity - 1);
+}
+
+static _MetisConnectionRoutes *
+_metisConnectionRoutes_Create(unsigned connectionId)
+{
+    _MetisConnectionRoutes *routes = parcMemory_AllocateAndClear(sizeof(_MetisConnectionRoutes));
+    assertNotNull(routes, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_MetisConnectionRoutes));
+
+    size_t allocation = METIS_FIB_CONNECTION_ROUTES_INITIAL_CAPACITY * sizeof(MetisFibEntry *);
+    routes->slots = parcMemory_AllocateAndClear(allocation);
+    assertNotNull(routes->slots, "parcMemory_AllocateAndClear(%zu) returned NULL", allocation);
+
+    routes->connectionId = connectionId;
+    routes->capacity = METIS_FIB_CONNECTION_ROUTES_INITIAL_CAPACITY;
+    return routes;
+}
+
+/**
+ * @return The slot holding fibEntry, or the empty slot where it would go
+ */
+static size_t
+_metisConnectionRoutes_Find(const _MetisConnectionRoutes *routes, const MetisFibEntry *fibEntry)
+{
+    size_t mask = routes->capacity - 1;
+    size_t slot = _metisConnectionRoutes_Home(routes, fibEntry);
+    while (routes->slots[slot] != NULL && routes->slots[slot] != fibEntry) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static void
+_metisConnectionRoutes_Grow(_MetisConnectionRoutes *routes)
+{
+    const MetisFibEntry **oldSlots = routes->slots;
+    size_t oldCapacity = routes->capacity;
+
+    size_t allocation = 2 * oldCapacity * sizeof(MetisFibEntry *);
+    routes->slots = parcMemory_AllocateAndClear(allocation);
+    assertNotNull(routes->slots, "parcMemory_AllocateAndClear(%zu) returned NULL", allocation);
+    routes->capacity = 2 * oldCapacity;
+
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldSlots[i] != NULL) {
+            routes->slots[_metisConnectionRoutes_Find(routes, oldSlots[i])] = oldSlots[i];
+        }
+    }
+
+    parcMemory_Deallocate((void **) &oldSlots);
+}
+
+static void
+_metisConnectionRoutes_Add(_MetisConnectionRoutes *routes, const MetisFibEntry *fibEntry)
+{
+    // keep the load factor at or below 1/2
+    if (2 * (routes->count + 1) > routes->capacity) {
+        _metisConnectionRoutes_Grow(routes);
+    }
+
+    size_t slot = _metisConnectionRoutes_Find(routes, fibEntry);
+    if (routes->slots[slot] == NULL) {
+        routes->slots[slot] = fibEntry;
+        routes->count++;
+    }
+}
+
+/**
+ * Removes the entry with backward-shift deletion, so the table never has tombstones.
+ *
+ * @return true if the entry was in the set
+ */
+static bool
+_metisConnectionRoutes_Remove(_MetisConnectionRoutes *routes, const MetisFibEntry *fibEntry)
+{
+    size_t mask = routes->capacity - 1;
+    size_t hole = _metisConnectionRoutes_Find(routes, fibEntry);
+    if (routes->slots[hole] == NULL) {
+        return false;
+    }
+
+    routes->slots[hole] = NULL;
+    routes->count--;
+
+    size_t next = (hole + 1) & mask;
+    while (routes->slots[next] != NULL) {
+        size_t home = _metisConnectionRoutes_Home(routes, routes->slots[next]);
+
+        // The entry at next may move into the hole only if its home is not
+        // cyclically inside (hole, next].
+        bool homeBetween = (hole <= next) ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!homeBetween) {
+            routes->slots[hole] = routes->slots[next];
+            routes->slots[next] = NULL;
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+
+    return true;
+}
+
+// =====================================================
+
+MetisFibConnectionIndex *
+metisFibConnectionIndex_Create(void)
+{
+    MetisFibConnectionIndex *index = parcMemory_AllocateAndClear(sizeof(MetisFibConnectionIndex));
+    assertNotNull(index, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisFibConnectionIndex));
+
+    // The key is inside the data, so there is no key destroyer
+    index->tableById = parcHashCodeTable_Create_Size(_hashTableFunction_ConnectionIdEquals,
+                                                     _hashTableFunction_ConnectionIdHashCode,
+                                                     NULL,
+                                                     _hashTableFunction_ConnectionRoutesDestroyer,
+                                                     64);
+    return index;
+}
+
+void
+metisFibConnectionIndex_Destroy(MetisFibConnectionIndex **indexPtr)
+{
+    assertNotNull(indexPtr, "Parameter must be non-null double pointer");
+    assertNotNull(*indexPtr, "Parameter must dereference to non-null pointer");
+
+    MetisFibConnectionIndex *index = *indexPtr;
+    parcHashCodeTable_Destroy(&index->tableById);
+    parcMemory_Deallocate((void **) &index);
+    *indexPtr = NULL;
+}
+
+void
+metisFibConnectionIndex_Add(MetisFibConnectionIndex *index, unsigned connectionId, MetisFibEntry *fibEntry)
+{
+    assertNotNull(index, "Parameter index must be non-null");
+    assertNotNull(fibEntry, "Parameter fibEntry must be non-null");
+
+    _MetisConnectionRoutes *routes = parcHashCodeTable_Get(index->tableById, &connectionId);
+    if (routes == NULL) {
+        routes = _metisConnectionRoutes_Create(connectionId);
+        parcHashCodeTable_Add(index->tableById, &routes->connectionId, routes);
+    }
+
+    _metisConnectionRoutes_Add(routes, fibEntry);
+}
+
+void
+metisFibConnectionIndex_Remove(MetisFibConnectionIndex *index, unsigned connectionId, const MetisFibEntry *fibEntry)
+{
+    assertNotNull(index, "Parameter index must be non-null");
+    assertNotNull(fibEntry, "Parameter fibEntry must be non-null");
+
+    _MetisConnectionRoutes *routes = parcHashCodeTable_Get(index->tableById, &connectionId);
+    if (routes != NULL) {
+        _metisConnectionRoutes_Remove(routes, fibEntry);
+        if (routes->count == 0) {
+            parcHashCodeTable_Del(index->tableById, &connectionId);
+        }
+    }
+}
+
+size_t
+metisFibConnectionIndex_Count(const MetisFibConnectionIndex *index, unsigned connectionId)
+{
+    assertNotNull(index, "Parameter index must be non-null");
+
+    _MetisConnectionRoutes *routes = parcHashCodeTable_Get(index->tableById, &connectionId);
+    return (routes == NULL) ? 0 : routes->count;
+}
+
+MetisFibEntryList *
+metisFibConnectionIndex_RemoveConnection(MetisFibConnectionIndex *index, unsigned connectionId)
+{
+    assertNotNull(index, "Parameter index must be non-null");
+
+    MetisFibEntryList *list = metisFibEntryList_Create();
+
+    _MetisConnectionRoutes *routes = parcHashCodeTable_Get(index->tableById, &connectionId);
+    if (routes != NULL) {
+        for (size_t i = 0; i < routes->capacity; i++) {
+            if (routes->slots[i] != NULL) {
+                // the list acquires a reference to the entry
+                metisFibEntryList_Append(list, (MetisFibEntry *) routes->slots[i]);
+            }
+        }
+        parcHashCodeTable_Del(index->tableById, &connectionId);
+    }
+
+    return list;
+}
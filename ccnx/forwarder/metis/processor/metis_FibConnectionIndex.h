@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_FibConnectionIndex.h
+ * @brief A reverse index from connection id to the FIB entries that use it as a nexthop
+ *
+ * When a connection goes down, the FIB uses this index to visit only the entries
+ * that route to that connection instead of walking the whole table.
+ *
+ * The index does not hold references to the FIB entries.  The FIB owns the entries and
+ * must remove an entry from the index when it removes the nexthop or destroys the entry.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_FibConnectionIndex_h
+#define Metis_metis_FibConnectionIndex_h
+
+#include <ccnx/forwarder/metis/processor/metis_FibEntry.h>
+#include <ccnx/forwarder/metis/processor/metis_FibEntryList.h>
+
+struct metis_fib_connection_index;
+typedef struct metis_fib_connection_index MetisFibConnectionIndex;
+
+/**
+ * Creates an empty index
+ *
+ * @retval non-null An allocated index
+ * @retval null An error
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisFibConnectionIndex *index = metisFibConnectionIndex_Create();
+ *     metisFibConnectionIndex_Destroy(&index);
+ * }
+ * @endcode
+ */
+MetisFibConnectionIndex *metisFibConnectionIndex_Create(void);
+
+/**
+ * Destroys the index.  It does not release the FIB entries.
+ *
+ * @param [in,out] indexPtr Pointer to the index, will be NULL'd
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisFibConnectionIndex *index = metisFibConnectionIndex_Create();
+ *     metisFibConnectionIndex_Destroy(&index);
+ * }
+ * @endcode
+ */
+void metisFibConnectionIndex_Destroy(MetisFibConnectionIndex **indexPtr);
+
+/**
+ * Records that the FIB entry has the connection as a nexthop
+ *
+ * Adding the same (connectionId, fibEntry) pair twice has no effect.
+ *
+ * @param [in] index An allocated index
+ * @param [in] connectionId The nexthop
+ * @param [in] fibEntry The FIB entry, which is not acquired
+ *
+ * Example:
+ * @code
+ * {
+ *     metisFibEntry_AddNexthop(fibEntry, connectionId);
+ *     metisFibConnectionIndex_Add(index, connectionId, fibEntry);
+ * }
+ * @endcode
+ */
+void metisFibConnectionIndex_Add(MetisFibConnectionIndex *index, unsigned connectionId, MetisFibEntry *fibEntry);
+
+/**
+ * Records that the FIB entry no longer has the connection as a nexthop
+ *
+ * Removing a pair that is not in the index has no effect.
+ *
+ * @param [in] index An allocated index
+ * @param [in] connectionId The nexthop
+ * @param [in] fibEntry The FIB entry
+ *
+ * Example:
+ * @code
+ * {
+ *     metisFibEntry_RemoveNexthop(fibEntry, connectionId);
+ *     metisFibConnectionIndex_Remove(index, connectionId, fibEntry);
+ * }
+ * @endcode
+ */
+void metisFibConnectionIndex_Remove(MetisFibConnectionIndex *index, unsigned connectionId, const MetisFibEntry *fibEntry);
+
+/**
+ * The number of FIB entries that have the connection as a nexthop
+ *
+ * @param [in] index An allocated index
+ * @param [in] connectionId The nexthop
+ *
+ * @return The number of FIB entries
+ *
+ * Example:
+ * @code
+ * {
+ *     size_t routes = metisFibConnectionIndex_Count(index, connectionId);
+ * }
+ * @endcode
+ */
+size_t metisFibConnectionIndex_Count(const MetisFibConnectionIndex *index, unsigned connectionId);
+
+/**
+ * Removes a connection from the index and returns the FIB entries that used it
+ *
+ * The entries in the list are reference counted copies, so they remain valid if the
+ * FIB destroys them while walking the list.  The nexthops of the entries are not changed.
+ *
+ * @param [in] index An allocated index
+ * @param [in] connectionId The nexthop to remove
+ *
+ * @return non-null A list of FIB entries, which may be empty.  You must destroy the list.
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisFibEntryList *list = metisFibConnectionIndex_RemoveConnection(index, connectionId);
+ *     for (size_t i = 0; i < metisFibEntryList_Length(list); i++) {
+ *         // remove the nexthop from the entry
+ *     }
+ *     metisFibEntryList_Destroy(&list);
+ * }
+ * @endcode
+ */
+MetisFibEntryList *metisFibConnectionIndex_RemoveConnection(MetisFibConnectionIndex *index, unsigned connectionId);
+#endif // Metis_metis_FibConnectionIndex_h
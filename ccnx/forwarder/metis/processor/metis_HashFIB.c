@@ -0,0 +1,495 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * A FIB implementation built on a hash table keyed by name prefix.
+ *
+ * Right now, the FIB table is sparse.  There can be an entry for /a and for /a/b/c, but
+ * not for /a/b.  This means we need to exhastively lookup all the components to make sure
+ * there's not a route for it.
+ *
+ * To make that cheap, the hash table key is a (name, prefix length) pair.  A lookup uses
+ * a key on the stack that points to the interest's name and uses the cumulative segment
+ * hashes already in the MetisTlvName, so it does not allocate.  We probe from the longest
+ * prefix to the shortest and skip prefix lengths that have no routes.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ccnx/forwarder/metis/processor/metis_HashFIB.h>
+#include <ccnx/forwarder/metis/processor/metis_FibEntry.h>
+#include <ccnx/forwarder/metis/processor/metis_FibConnectionIndex.h>
+#include <ccnx/forwarder/metis/processor/metis_HashTableFunction.h>
+#include <parc/algol/parc_Memory.h>
+#include <parc/algol/parc_TreeRedBlack.h>
+
+#include <LongBow/runtime.h>
+
+// =====================================================
+
+/**
+ * @function hashTableFunction_FibEntryDestroyer
+ * @abstract Used in the hash table to destroy the data pointer when an item's removed
+ * @discussion
+ *   <#Discussion#>
+ *
+ * @param <#param1#>
+ * @return <#return#>
+ */
+static void
+_hashTableFunction_FibEntryDestroyer(void **dataPtr)
+{
+    metisFibEntry_Release((MetisFibEntry **) dataPtr);
+}
+
+/**
+ * The key in the hash table.  Stored keys own a reference to the name and use the full
+ * name (segmentCount is the name's segment count).  Probe keys live on the stack and
+ * refer to a prefix of the interest's name.
+ */
+typedef struct metis_fib_key {
+    MetisTlvName *name;
+    size_t segmentCount;
+    HashCodeType hashCode;
+} _MetisFibKey;
+
+static bool
+_hashTableFunction_FibKeyEquals(const void *keyA, const void *keyB)
+{
+    const _MetisFibKey *a = (const _MetisFibKey *) keyA;
+    const _MetisFibKey *b = (const _MetisFibKey *) keyB;
+
+    if (a->segmentCount == b->segmentCount) {
+        return metisTlvName_PrefixEquals(a->name, b->name, a->segmentCount);
+    }
+    return false;
+}
+
+static HashCodeType
+_hashTableFunction_FibKeyHashCode(const void *keyA)
+{
+    const _MetisFibKey *key = (const _MetisFibKey *) keyA;
+    return key->hashCode;
+}
+
+/**
+ * @function hashTableFunction_FibKeyDestroyer
+ * @abstract Used in the hash table to destroy the key pointer when an item's removed
+ * @discussion
+ *   Releases the reference to the name and frees the key.
+ *
+ * @param <#param1#>
+ * @return <#return#>
+ */
+static void
+_hashTableFunction_FibKeyDestroyer(void **dataPtr)
+{
+    _MetisFibKey *key = (_MetisFibKey *) *dataPtr;
+    metisTlvName_Release(&key->name);
+    parcMemory_Deallocate((void **) &key);
+    *dataPtr = NULL;
+}
+
+// =====================================================
+
+typedef struct metis_hash_fib {
+    // KEY = _MetisFibKey, VALUE = FibEntry
+    PARCHashCodeTable *tableByName;
+
+    // KEY = tlvName.  We use a tree for the keys because that
+    // has the same average insert and remove time.  The tree
+    // is only used by GetEntries, which in turn is used by things
+    // that want to enumerate the FIB
+    PARCTreeRedBlack *tableOfKeys;
+
+    // connection id -> the entries that route to it, so removing a connection
+    // only visits its own routes
+    MetisFibConnectionIndex *connectionIndex;
+
+    MetisLogger *logger;
+
+    // If there are no forward paths, we return an emtpy set.  Allocate this
+    // once and return a reference to it whenever we need an empty set.
+    MetisNumberSet *emptySet;
+
+    // prefixLengthCounts[i] is the number of entries with i name segments.  Match
+    // does not probe the hash table for prefix lengths with no entries.
+    size_t *prefixLengthCounts;
+    size_t prefixLengthCountsLength;
+} MetisHashFIB;
+
+static MetisFibEntry *_metisHashFIB_CreateFibEntry(MetisHashFIB *fib, MetisTlvName *tlvName);
+static void _metisHashFIB_RemoveFibEntry(MetisHashFIB *fib, MetisTlvName *tlvName);
+static MetisFibEntry *_metisHashFIB_Lookup(const MetisHashFIB *fib, MetisTlvName *tlvName, size_t segmentCount);
+
+static void                   _metisHashFIB_Destroy(MetisFIB **fibPtr);
+static const MetisNumberSet *_metisHashFIB_Match(MetisFIB *generic, const MetisMessage *interestMessage);
+static bool                   _metisHashFIB_AddOrUpdate(MetisFIB *generic, CPIRouteEntry *route);
+static bool                   _metisHashFIB_Remove(MetisFIB *generic, CPIRouteEntry *route);
+static size_t                 _metisHashFIB_Length(const MetisFIB *generic);
+static MetisFibEntryList     *_metisHashFIB_GetEntries(const MetisFIB *generic);
+static void                   _metisHashFIB_RemoveConnectionIdFromRoutes(MetisFIB *generic, unsigned connectionId);
+
+// =====================================================
+// Public API
+
+MetisFIB *
+metisHashFIB_Create(MetisLogger *logger)
+{
+    unsigned initialSize = 1024;
+
+    size_t allocation = sizeof(MetisFIB) + sizeof(MetisHashFIB);
+
+    MetisFIB *generic = parcMemory_AllocateAndClear(allocation);
+    assertNotNull(generic, "parcMemory_AllocateAndClear(%zu) returned NULL", allocation);
+    generic->closure = (uint8_t *) generic + sizeof(MetisFIB);
+
+    MetisHashFIB *fib = metisFIB_Closure(generic);
+    fib->emptySet = metisNumberSet_Create();
+    fib->logger = metisLogger_Acquire(logger);
+    fib->tableByName = parcHashCodeTable_Create_Size(_hashTableFunction_FibKeyEquals,
+                                                     _hashTableFunction_FibKeyHashCode,
+                                                     _hashTableFunction_FibKeyDestroyer,
+                                                     _hashTableFunction_FibEntryDestroyer,
+                                                     initialSize);
+
+    fib->tableOfKeys =
+        parcTreeRedBlack_Create(metisHashTableFunction_TlvNameCompare, NULL, NULL, NULL, NULL, NULL);
+
+    fib->connectionIndex = metisFibConnectionIndex_Create();
+
+    if (metisLogger_IsLoggable(fib->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+        metisLogger_Log(fib->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                        "FIB %p created with initialSize %u",
+                        (void *) fib, initialSize);
+    }
+
+    generic->destroy = _metisHashFIB_Destroy;
+    generic->match = _metisHashFIB_Match;
+    generic->addOrUpdate = _metisHashFIB_AddOrUpdate;
+    generic->remove = _metisHashFIB_Remove;
+    generic->length = _metisHashFIB_Length;
+    generic->getEntries = _metisHashFIB_GetEntries;
+    generic->removeConnectionIdFromRoutes = _metisHashFIB_RemoveConnectionIdFromRoutes;
+
+    return generic;
+}
+
+// =====================================================
+// Interface implementation
+
+static void
+_metisHashFIB_Destroy(MetisFIB **fibPtr)
+{
+    assertNotNull(fibPtr, "Parameter must be non-null double pointer");
+    assertNotNull(*fibPtr, "Parameter must dereference to non-null pointer");
+
+    MetisHashFIB *fib = metisFIB_Closure(*fibPtr);
+
+    if (metisLogger_IsLoggable(fib->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+        metisLogger_Log(fib->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                        "FIB %p destroyed",
+                        (void *) fib);
+    }
+
+    metisNumberSet_Release(&fib->emptySet);
+    metisLogger_Release(&fib->logger);
+    metisFibConnectionIndex_Destroy(&fib->connectionIndex);
+    parcTreeRedBlack_Destroy(&fib->tableOfKeys);
+    parcHashCodeTable_Destroy(&fib->tableByName);
+    if (fib->prefixLengthCounts) {
+        parcMemory_Deallocate((void **) &fib->prefixLengthCounts);
+    }
+    parcMemory_Deallocate((void **) fibPtr);
+    *fibPtr = NULL;
+}
+
+static const MetisNumberSet *
+_metisHashFIB_Match(MetisFIB *generic, const MetisMessage *interestMessage)
+{
+    assertNotNull(generic, "Parameter fib must be non-null");
+    assertNotNull(interestMessage, "Parameter interestMessage must be non-null");
+    MetisHashFIB *fib = metisFIB_Closure(generic);
+
+    if (metisMessage_HasName(interestMessage)) {
+        // this is NOT reference counted, don't destroy it
+        MetisTlvName *tlvName = metisMessage_GetName(interestMessage);
+        MetisFibEntry *longestMatchingFibEntry = NULL;
+
+        size_t segmentCount = metisTlvName_SegmentCount(tlvName);
+        if (segmentCount >= fib->prefixLengthCountsLength) {
+            segmentCount = (fib->prefixLengthCountsLength > 0) ? fib->prefixLengthCountsLength - 1 : 0;
+        }
+
+        // because the FIB table is sparse, we need to probe all the prefix lengths that have routes.
+        // Going from the longest to the shortest, the first acceptable entry is the longest match.
+        for (size_t length = segmentCount; length > 0 && longestMatchingFibEntry == NULL; length--) {
+            if (fib->prefixLengthCounts[length] == 0) {
+                continue;
+            }
+
+            MetisFibEntry *fibEntry = _metisHashFIB_Lookup(fib, tlvName, length);
+            if (fibEntry != NULL) {
+                // we can accept the FIB entry if it does not contain the ingress connection id or if
+                // there is more than one forward path besides the ingress connection id.
+                const MetisNumberSet *nexthops = metisFibEntry_GetNexthops(fibEntry);
+                if (!metisNumberSet_Contains(nexthops, metisMessage_GetIngressConnectionId(interestMessage)) || metisNumberSet_Length(nexthops) > 1) {
+                    longestMatchingFibEntry = fibEntry;
+                }
+            }
+        }
+
+        if (longestMatchingFibEntry != NULL) {
+            // this returns a reference counted copy of the next hops
+            return metisFibEntry_GetNexthops(longestMatchingFibEntry);
+        }
+    }
+
+    // return an empty set
+    return fib->emptySet;
+}
+
+static bool
+_metisHashFIB_AddOrUpdate(MetisFIB *generic, CPIRouteEntry *route)
+{
+    assertNotNull(generic, "Parameter fib must be non-null");
+    assertNotNull(route, "Parameter route must be non-null");
+    MetisHashFIB *fib = metisFIB_Closure(generic);
+
+    const CCNxName *ccnxName = cpiRouteEntry_GetPrefix(route);
+    unsigned interfaceIndex = cpiRouteEntry_GetInterfaceIndex(route);
+    MetisTlvName *tlvName = metisTlvName_CreateFromCCNxName(ccnxName);
+
+    MetisFibEntry *fibEntry = _metisHashFIB_Lookup(fib, tlvName, metisTlvName_SegmentCount(tlvName));
+    if (fibEntry == NULL) {
+        fibEntry = _metisHashFIB_CreateFibEntry(fib, tlvName);
+    }
+
+    metisFibEntry_AddNexthop(fibEntry, interfaceIndex);
+    metisFibConnectionIndex_Add(fib->connectionIndex, interfaceIndex, fibEntry);
+
+    // if anyone saved the name in a table, they copied it.
+    metisTlvName_Release(&tlvName);
+
+    return true;
+}
+
+static bool
+_metisHashFIB_Remove(MetisFIB *generic, CPIRouteEntry *route)
+{
+    assertNotNull(generic, "Parameter fib must be non-null");
+    assertNotNull(route, "Parameter route must be non-null");
+    MetisHashFIB *fib = metisFIB_Closure(generic);
+
+    bool routeRemoved = false;
+
+    const CCNxName *ccnxName = cpiRouteEntry_GetPrefix(route);
+    unsigned interfaceIndex = cpiRouteEntry_GetInterfaceIndex(route);
+    MetisTlvName *tlvName = metisTlvName_CreateFromCCNxName(ccnxName);
+
+    MetisFibEntry *fibEntry = _metisHashFIB_Lookup(fib, tlvName, metisTlvName_SegmentCount(tlvName));
+    if (fibEntry != NULL) {
+        metisFibEntry_RemoveNexthop(fibEntry, interfaceIndex);
+        metisFibConnectionIndex_Remove(fib->connectionIndex, interfaceIndex, fibEntry);
+        if (metisFibEntry_NexthopCount(fibEntry) == 0) {
+            _metisHashFIB_RemoveFibEntry(fib, tlvName);
+            routeRemoved = true;
+        }
+    }
+
+    metisTlvName_Release(&tlvName);
+    return routeRemoved;
+}
+
+static size_t
+_metisHashFIB_Length(const MetisFIB *generic)
+{
+    assertNotNull(generic, "Parameter fib must be non-null");
+    const MetisHashFIB *fib = metisFIB_Closure(generic);
+    return parcHashCodeTable_Length(fib->tableByName);
+}
+
+static MetisFibEntryList *
+_metisHashFIB_GetEntries(const MetisFIB *generic)
+{
+    assertNotNull(generic, "Parameter fib must be non-null");
+    const MetisHashFIB *fib = metisFIB_Closure(generic);
+    MetisFibEntryList *list = metisFibEntryList_Create();
+
+    PARCArrayList *values = parcTreeRedBlack_Values(fib->tableOfKeys);
+    for (size_t i = 0; i < parcArrayList_Size(values); i++) {
+        MetisFibEntry *original = (MetisFibEntry *) parcArrayList_Get(values, i);
+        metisFibEntryList_Append(list, original);
+    }
+    parcArrayList_Destroy(&values);
+    return list;
+}
+
+static void
+_metisHashFIB_RemoveConnectionIdFromRoutes(MetisFIB *generic, unsigned connectionId)
+{
+    assertNotNull(generic, "Parameter fib must be non-null");
+    MetisHashFIB *fib = metisFIB_Closure(generic);
+
+    // Only visit the entries that route to the connection.  The list holds a reference to
+    // each entry, so they stay valid while we remove them from the table.
+    MetisFibEntryList *list = metisFibConnectionIndex_RemoveConnection(fib->connectionIndex, connectionId);
+    for (size_t i = 0; i < metisFibEntryList_Length(list); i++) {
+        MetisFibEntry *fibEntry = (MetisFibEntry *) metisFibEntryList_Get(list, i);
+        metisFibEntry_RemoveNexthop(fibEntry, connectionId);
+
+        // an entry with no nexthops is no longer a route
+        if (metisFibEntry_NexthopCount(fibEntry) == 0) {
+            MetisTlvName *prefix = metisFibEntry_GetPrefix(fibEntry);
+            _metisHashFIB_RemoveFibEntry(fib, prefix);
+            metisTlvName_Release(&prefix);
+        }
+    }
+    metisFibEntryList_Destroy(&list);
+}
+
+// =========================================================================
+// Private API
+
+/**
+ * @function _metisHashFIB_CreateFibEntry
+ * @abstract Create the given FIB entry
+ * @discussion
+ *    PRECONDITION: You know that the FIB entry does not exist already
+ *
+ * @param <#param1#>
+ * @return <#return#>
+ */
+static MetisFibEntry *
+_metisHashFIB_CreateFibEntry(MetisHashFIB *fib, MetisTlvName *tlvName)
+{
+    MetisFibEntry *entry = metisFibEntry_Create(tlvName);
+
+    // add a reference counted name, as we specified a key destroyer when we
+    // created the table.
+    _MetisFibKey *key = parcMemory_Allocate(sizeof(_MetisFibKey));
+    assertNotNull(key, "parcMemory_Allocate(%zu) returned NULL", sizeof(_MetisFibKey));
+    key->name = metisTlvName_Acquire(tlvName);
+    key->segmentCount = metisTlvName_SegmentCount(tlvName);
+    key->hashCode = metisTlvName_PrefixHashCode(tlvName, key->segmentCount);
+    parcHashCodeTable_Add(fib->tableByName, key, entry);
+
+    // this is an index structure.  It does not have its own destroyer functions in
+    // the data structure.  The data in this table is the same pointer as in the hash table.
+    parcTreeRedBlack_Insert(fib->tableOfKeys, key->name, entry);
+
+    if (key->segmentCount >= fib->prefixLengthCountsLength) {
+        size_t newLength = key->segmentCount + 1;
+        size_t *newCounts = parcMemory_AllocateAndClear(newLength * sizeof(size_t));
+        assertNotNull(newCounts, "parcMemory_AllocateAndClear(%zu) returned NULL", newLength * sizeof(size_t));
+        if (fib->prefixLengthCounts) {
+            memcpy(newCounts, fib->prefixLengthCounts, fib->prefixLengthCountsLength * sizeof(size_t));
+            parcMemory_Deallocate((void **) &fib->prefixLengthCounts);
+        }
+        fib->prefixLengthCounts = newCounts;
+        fib->prefixLengthCountsLength = newLength;
+    }
+    fib->prefixLengthCounts[key->segmentCount]++;
+
+    return entry;
+}
+
+/**
+ * @function _metisHashFIB_RemoveFibEntry
+ * @abstract Removes the entry for the name from all the FIB indices
+ * @discussion
+ *    PRECONDITION: You know that the FIB entry exists
+ */
+static void
+_metisHashFIB_RemoveFibEntry(MetisHashFIB *fib, MetisTlvName *tlvName)
+{
+    size_t segmentCount = metisTlvName_SegmentCount(tlvName);
+    _MetisFibKey probe = {
+        .name         = tlvName,
+        .segmentCount = segmentCount,
+        .hashCode     = metisTlvName_PrefixHashCode(tlvName, segmentCount)
+    };
+
+    parcTreeRedBlack_Remove(fib->tableOfKeys, tlvName);
+
+    // this will de-allocate the key, so must be done last
+    parcHashCodeTable_Del(fib->tableByName, &probe);
+
+    fib->prefixLengthCounts[segmentCount]--;
+}
+
+/**
+ * @function _metisHashFIB_Lookup
+ * @abstract Finds the FIB entry for the first segmentCount segments of the name
+ * @discussion
+ *    Uses a key on the stack, so it does not allocate memory.
+ *
+ * @return The FIB entry or NULL if not found
+ */
+static MetisFibEntry *
+_metisHashFIB_Lookup(const MetisHashFIB *fib, MetisTlvName *tlvName, size_t segmentCount)
+{
+    _MetisFibKey probe = {
+        .name         = tlvName,
+        .segmentCount = segmentCount,
+        .hashCode     = metisTlvName_PrefixHashCode(tlvName, segmentCount)
+    };
+
+    return parcHashCodeTable_Get(fib->tableByName, &probe);
+}
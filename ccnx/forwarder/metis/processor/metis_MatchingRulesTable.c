@@ -52,67 +52,436 @@
  * intellectual property used by its contributions to this software. You may
  * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
  */
-
 //
 //  metis_MatchingRulesTable.c
 //  Metis
 //
 //  Created by Mosko, Marc <Marc.Mosko@parc.com> on 11/29/13.
 
+/*
+ * The table is a single open-addressed (linear probing) hash table keyed by the name hash.
+ * There is one bucket per distinct name.  Every entry stored under that name -- by Name,
+ * by Name+KeyId or by Name+ObjectHash -- lives in the bucket as a "variant" tagged with its
+ * matching rule.  A content object hashes its name once, probes to the one bucket and checks
+ * each variant, so matching all three rules is one probe and no allocation.
+ *
+ * The first METIS_MATCHING_RULES_INLINE variants are stored in the bucket itself, which keeps a
+ * bucket to one 64 byte cache line.  Buckets are aligned to METIS_CACHE_LINE_SIZE and the bucket
+ * array is allocated on a cache line boundary, so a bucket never shares a line with another bucket.
+ * A name with more variants (e.g. many KeyId restrictions) spills the rest to a heap allocated
+ * overflow array.  When a variant is removed, the last variant is moved
+ * in to its place, so the inline array is always full before the overflow array is used.
+ */
+
 #include <config.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
 
 #include <parc/algol/parc_Memory.h>
-#include <parc/algol/parc_Hash.h>
 
-#include <ccnx/forwarder/metis/processor/metis_HashTableFunction.h>
+#include <ccnx/forwarder/metis/core/metis_CacheLine.h>
 #include <ccnx/forwarder/metis/processor/metis_MatchingRulesTable.h>
 #include <LongBow/runtime.h>
 
+typedef enum {
+    MetisMatchingRule_Name = 0,
+    MetisMatchingRule_NameAndKeyId = 1,
+    MetisMatchingRule_NameAndObjectHash = 2
+} MetisMatchingRule;
+
+// the number of variants stored in the bucket
+#define METIS_MATCHING_RULES_INLINE 3
+
+// Initial number of buckets, must be a power of 2
+#define METIS_MATCHING_RULES_INITIAL_CAPACITY 1024
+
+typedef struct metis_matching_rules_variant {
+    MetisMessage *key;
+    void *data;
+    MetisMatchingRule rule;
+} _MetisMatchingRulesVariant;
+
+typedef struct metis_matching_rules_overflow {
+    size_t length;
+    size_t capacity;
+    _MetisMatchingRulesVariant *variants;
+} _MetisMatchingRulesOverflow;
+
+typedef struct __attribute__ ((aligned(METIS_CACHE_LINE_SIZE))) metis_matching_rules_bucket {
+    uint32_t nameHash;
+
+    // number of inline variants, 0 means the bucket is empty
+    uint8_t length;
+    uint8_t rules[METIS_MATCHING_RULES_INLINE];
+
+    MetisMessage *keys[METIS_MATCHING_RULES_INLINE];
+    void *data[METIS_MATCHING_RULES_INLINE];
+
+    // NULL unless all inline variants are in use
+    _MetisMatchingRulesOverflow *overflow;
+} _MetisMatchingRulesBucket;
+
+_Static_assert(sizeof(_MetisMatchingRulesBucket) % METIS_CACHE_LINE_SIZE == 0, "A bucket must fill whole cache lines");
+
 struct metis_matching_rules_table {
-    // we maintain three hash tables indexed by the different ways
-    // one could ask for something.  THis means a content object needs
-    // to do three lookups.  We can optimize this later.
+    _MetisMatchingRulesBucket *buckets;
+
+    // always a power of 2
+    size_t capacity;
 
-    PARCHashCodeTable *tableByName;
-    PARCHashCodeTable *tableByNameAndKeyId;
-    PARCHashCodeTable *tableByNameAndObjectHash;
+    // number of non-empty buckets
+    size_t bucketCount;
+
+    // number of stored variants
+    size_t length;
 
     PARCHashCodeTable_Destroyer dataDestroyer;
 };
 
-static PARCHashCodeTable *metisMatchingRulesTable_GetTableForMessage(const MetisMatchingRulesTable *pit, const MetisMessage *interestMessage);
+// ======================================================================
+// Bucket functions
+
+static size_t
+_metisMatchingRulesBucket_Length(const _MetisMatchingRulesBucket *bucket)
+{
+    return bucket->length + (bucket->overflow ? bucket->overflow->length : 0);
+}
+
+static MetisMatchingRule
+_metisMatchingRulesBucket_Rule(const _MetisMatchingRulesBucket *bucket, size_t index)
+{
+    if (index < METIS_MATCHING_RULES_INLINE) {
+        return (MetisMatchingRule) bucket->rules[index];
+    }
+    return bucket->overflow->variants[index - METIS_MATCHING_RULES_INLINE].rule;
+}
+
+static MetisMessage *
+_metisMatchingRulesBucket_Key(const _MetisMatchingRulesBucket *bucket, size_t index)
+{
+    if (index < METIS_MATCHING_RULES_INLINE) {
+        return bucket->keys[index];
+    }
+    return bucket->overflow->variants[index - METIS_MATCHING_RULES_INLINE].key;
+}
+
+static void *
+_metisMatchingRulesBucket_Data(const _MetisMatchingRulesBucket *bucket, size_t index)
+{
+    if (index < METIS_MATCHING_RULES_INLINE) {
+        return bucket->data[index];
+    }
+    return bucket->overflow->variants[index - METIS_MATCHING_RULES_INLINE].data;
+}
+
+static void
+_metisMatchingRulesBucket_Set(_MetisMatchingRulesBucket *bucket, size_t index, MetisMatchingRule rule, MetisMessage *key, void *data)
+{
+    if (index < METIS_MATCHING_RULES_INLINE) {
+        bucket->rules[index] = (uint8_t) rule;
+        bucket->keys[index] = key;
+        bucket->data[index] = data;
+    } else {
+        _MetisMatchingRulesVariant *variant = &bucket->overflow->variants[index - METIS_MATCHING_RULES_INLINE];
+        variant->rule = rule;
+        variant->key = key;
+        variant->data = data;
+    }
+}
+
+static void
+_metisMatchingRulesBucket_Append(_MetisMatchingRulesBucket *bucket, MetisMatchingRule rule, MetisMessage *key, void *data)
+{
+    if (bucket->length < METIS_MATCHING_RULES_INLINE) {
+        _metisMatchingRulesBucket_Set(bucket, bucket->length, rule, key, data);
+        bucket->length++;
+        return;
+    }
+
+    if (bucket->overflow == NULL) {
+        bucket->overflow = parcMemory_AllocateAndClear(sizeof(_MetisMatchingRulesOverflow));
+        assertNotNull(bucket->overflow, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_MetisMatchingRulesOverflow));
+    }
+
+    _MetisMatchingRulesOverflow *overflow = bucket->overflow;
+    if (overflow->length == overflow->capacity) {
+        size_t capacity = overflow->capacity ? overflow->capacity * 2 : 4;
+        size_t bytes = capacity * sizeof(_MetisMatchingRulesVariant);
+        if (overflow->variants) {
+            overflow->variants = parcMemory_Reallocate(overflow->variants, bytes);
+        } else {
+            overflow->variants = parcMemory_Allocate(bytes);
+        }
+        assertNotNull(overflow->variants, "Could not allocate %zu bytes for the overflow variants", bytes);
+        overflow->capacity = capacity;
+    }
+
+    overflow->length++;
+    _metisMatchingRulesBucket_Set(bucket, METIS_MATCHING_RULES_INLINE + overflow->length - 1, rule, key, data);
+}
+
+static void
+_metisMatchingRulesBucket_FreeOverflow(_MetisMatchingRulesBucket *bucket)
+{
+    if (bucket->overflow) {
+        if (bucket->overflow->variants) {
+            parcMemory_Deallocate((void **) &bucket->overflow->variants);
+        }
+        parcMemory_Deallocate((void **) &bucket->overflow);
+    }
+}
+
+/**
+ * Removes the variant at index by moving the last variant in to its place
+ */
+static void
+_metisMatchingRulesBucket_RemoveAt(_MetisMatchingRulesBucket *bucket, size_t index)
+{
+    size_t last = _metisMatchingRulesBucket_Length(bucket) - 1;
+    if (index != last) {
+        _metisMatchingRulesBucket_Set(bucket, index,
+                                      _metisMatchingRulesBucket_Rule(bucket, last),
+                                      _metisMatchingRulesBucket_Key(bucket, last),
+                                      _metisMatchingRulesBucket_Data(bucket, last));
+    }
+
+    if (bucket->overflow && bucket->overflow->length > 0) {
+        bucket->overflow->length--;
+        if (bucket->overflow->length == 0) {
+            _metisMatchingRulesBucket_FreeOverflow(bucket);
+        }
+    } else {
+        bucket->length--;
+    }
+}
+
+/**
+ * A variant matches a message if they have the same rule and the same restriction.
+ * The caller has already matched the name.
+ */
+static bool
+_metisMatchingRulesBucket_VariantMatches(const _MetisMatchingRulesBucket *bucket, size_t index, MetisMatchingRule rule, const MetisMessage *message)
+{
+    if (_metisMatchingRulesBucket_Rule(bucket, index) != rule) {
+        return false;
+    }
+
+    bool matches = false;
+    switch (rule) {
+        case MetisMatchingRule_Name:
+            matches = true;
+            break;
+
+        case MetisMatchingRule_NameAndKeyId:
+            matches = metisMessage_KeyIdEquals(_metisMatchingRulesBucket_Key(bucket, index), message);
+            break;
+
+        case MetisMatchingRule_NameAndObjectHash:
+            // due to lazy calculation of hash in content objects, need non-const
+            matches = metisMessage_ObjectHashEquals(_metisMatchingRulesBucket_Key(bucket, index), (MetisMessage *) message);
+            break;
+
+        default:
+            trapUnexpectedState("Unknown matching rule %d", rule);
+    }
+    return matches;
+}
+
+/**
+ * @return The index of the variant, or -1 if not found
+ */
+static ssize_t
+_metisMatchingRulesBucket_Find(const _MetisMatchingRulesBucket *bucket, MetisMatchingRule rule, const MetisMessage *message)
+{
+    size_t length = _metisMatchingRulesBucket_Length(bucket);
+    for (size_t i = 0; i < length; i++) {
+        if (_metisMatchingRulesBucket_VariantMatches(bucket, i, rule, message)) {
+            return (ssize_t) i;
+        }
+    }
+    return -1;
+}
+
+// ======================================================================
+// Table functions
+
+static MetisMatchingRule
+_metisMatchingRulesTable_RuleForMessage(const MetisMessage *message)
+{
+    if (metisMessage_HasContentObjectHash(message)) {
+        return MetisMatchingRule_NameAndObjectHash;
+    } else if (metisMessage_HasKeyId(message)) {
+        return MetisMatchingRule_NameAndKeyId;
+    }
+    return MetisMatchingRule_Name;
+}
+
+/**
+ * Finds the bucket for the message's name
+ *
+ * @param [out] indexOutput The bucket index if found, otherwise the empty bucket where it would go
+ * @return true if the name is in the table
+ */
+static bool
+_metisMatchingRulesTable_FindBucket(const MetisMatchingRulesTable *table, const MetisMessage *message, uint32_t nameHash, size_t *indexOutput)
+{
+    const MetisTlvName *name = metisMessage_GetName(message);
+    size_t mask = table->capacity - 1;
+    size_t index = nameHash & mask;
+
+    while (table->buckets[index].length > 0) {
+        const _MetisMatchingRulesBucket *bucket = &table->buckets[index];
+        if (bucket->nameHash == nameHash && metisTlvName_Equals(metisMessage_GetName(bucket->keys[0]), name)) {
+            *indexOutput = index;
+            return true;
+        }
+        index = (index + 1) & mask;
+    }
+
+    *indexOutput = index;
+    return false;
+}
+
+static _MetisMatchingRulesBucket *
+_metisMatchingRulesTable_GetBucket(const MetisMatchingRulesTable *table, const MetisMessage *message)
+{
+    size_t index;
+    uint32_t nameHash = metisTlvName_HashCode(metisMessage_GetName(message));
+    if (_metisMatchingRulesTable_FindBucket(table, message, nameHash, &index)) {
+        return &table->buckets[index];
+    }
+    return NULL;
+}
+
+static void
+_metisMatchingRulesTable_Resize(MetisMatchingRulesTable *table, size_t capacity)
+{
+    _MetisMatchingRulesBucket *oldBuckets = table->buckets;
+    size_t oldCapacity = table->capacity;
+
+    size_t length = capacity * sizeof(_MetisMatchingRulesBucket);
+    int failure = parcMemory_MemAlign((void **) &table->buckets, METIS_CACHE_LINE_SIZE, length);
+    assertTrue(failure == 0, "parcMemory_MemAlign(%d, %zu) failed: %d", METIS_CACHE_LINE_SIZE, length, failure);
+    memset(table->buckets, 0, length);
+    table->capacity = capacity;
+
+    size_t mask = capacity - 1;
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldBuckets[i].length > 0) {
+            size_t index = oldBuckets[i].nameHash & mask;
+            while (table->buckets[index].length > 0) {
+                index = (index + 1) & mask;
+            }
+            table->buckets[index] = oldBuckets[i];
+        }
+    }
+
+    if (oldBuckets) {
+        parcMemory_Deallocate((void **) &oldBuckets);
+    }
+}
+
+/**
+ * Removes an empty bucket with backward-shift deletion, so the table never has tombstones.
+ */
+static void
+_metisMatchingRulesTable_RemoveBucket(MetisMatchingRulesTable *table, size_t hole)
+{
+    size_t mask = table->capacity - 1;
+    size_t next = (hole + 1) & mask;
+    while (table->buckets[next].length > 0) {
+        size_t home = table->buckets[next].nameHash & mask;
+
+        // The bucket at next may move into the hole only if its home is not
+        // cyclically inside (hole, next].
+        bool homeBetween = (hole <= next) ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!homeBetween) {
+            table->buckets[hole] = table->buckets[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+
+    memset(&table->buckets[hole], 0, sizeof(_MetisMatchingRulesBucket));
+    table->bucketCount--;
+}
+
+/**
+ * Adds the key and data with the given rule, unless there is already a matching variant
+ *
+ * @return true if added
+ */
+static bool
+_metisMatchingRulesTable_Add(MetisMatchingRulesTable *table, MetisMatchingRule rule, MetisMessage *key, void *data)
+{
+    // keep the load factor at or below 3/4
+    if (4 * (table->bucketCount + 1) > 3 * table->capacity) {
+        _metisMatchingRulesTable_Resize(table, table->capacity * 2);
+    }
+
+    size_t index;
+    uint32_t nameHash = metisTlvName_HashCode(metisMessage_GetName(key));
+    _MetisMatchingRulesBucket *bucket;
+    if (_metisMatchingRulesTable_FindBucket(table, key, nameHash, &index)) {
+        bucket = &table->buckets[index];
+        if (_metisMatchingRulesBucket_Find(bucket, rule, key) >= 0) {
+            return false;
+        }
+    } else {
+        bucket = &table->buckets[index];
+        bucket->nameHash = nameHash;
+        table->bucketCount++;
+    }
+
+    _metisMatchingRulesBucket_Append(bucket, rule, key, data);
+    table->length++;
+    return true;
+}
+
+/**
+ * Removes the variant matching the message under the given rule, calling the data destroyer
+ */
+static void
+_metisMatchingRulesTable_Remove(MetisMatchingRulesTable *table, MetisMatchingRule rule, const MetisMessage *message)
+{
+    size_t index;
+    uint32_t nameHash = metisTlvName_HashCode(metisMessage_GetName(message));
+    if (!_metisMatchingRulesTable_FindBucket(table, message, nameHash, &index)) {
+        return;
+    }
+
+    _MetisMatchingRulesBucket *bucket = &table->buckets[index];
+    ssize_t position = _metisMatchingRulesBucket_Find(bucket, rule, message);
+    if (position < 0) {
+        return;
+    }
+
+    void *data = _metisMatchingRulesBucket_Data(bucket, position);
+    _metisMatchingRulesBucket_RemoveAt(bucket, position);
+    table->length--;
+
+    if (bucket->length == 0) {
+        _metisMatchingRulesTable_RemoveBucket(table, index);
+    }
+
+    // The data may own the key (and the message), so only destroy it once it is out of the table
+    if (table->dataDestroyer) {
+        table->dataDestroyer(&data);
+    }
+}
 
 // ======================================================================
 
 MetisMatchingRulesTable *
 metisMatchingRulesTable_Create(PARCHashCodeTable_Destroyer dataDestroyer)
 {
-    size_t initialSize = 65535;
-
     MetisMatchingRulesTable *table = parcMemory_AllocateAndClear(sizeof(MetisMatchingRulesTable));
     assertNotNull(table, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisMatchingRulesTable));
     table->dataDestroyer = dataDestroyer;
 
     // There is not a Key destroyer because we use the message from the MetisPitEntry as the key
-
-    table->tableByName = parcHashCodeTable_Create_Size(metisHashTableFunction_MessageNameEquals,
-                                                       metisHashTableFunction_MessageNameHashCode,
-                                                       NULL,
-                                                       dataDestroyer,
-                                                       initialSize);
-
-    table->tableByNameAndKeyId = parcHashCodeTable_Create_Size(metisHashTableFunction_MessageNameAndKeyIdEquals,
-                                                               metisHashTableFunction_MessageNameAndKeyIdHashCode,
-                                                               NULL,
-                                                               dataDestroyer,
-                                                               initialSize);
-
-    table->tableByNameAndObjectHash = parcHashCodeTable_Create_Size(metisHashTableFunction_MessageNameAndObjectHashEquals,
-                                                                    metisHashTableFunction_MessageNameAndObjectHashHashCode,
-                                                                    NULL,
-                                                                    dataDestroyer,
-                                                                    initialSize);
+    _metisMatchingRulesTable_Resize(table, METIS_MATCHING_RULES_INITIAL_CAPACITY);
     return table;
 }
 
@@ -124,50 +493,85 @@ metisMatchingRulesTable_Destroy(MetisMatchingRulesTable **tablePtr)
 
     MetisMatchingRulesTable *table = *tablePtr;
 
-    parcHashCodeTable_Destroy(&table->tableByNameAndObjectHash);
-    parcHashCodeTable_Destroy(&table->tableByNameAndKeyId);
-    parcHashCodeTable_Destroy(&table->tableByName);
+    for (size_t i = 0; i < table->capacity; i++) {
+        _MetisMatchingRulesBucket *bucket = &table->buckets[i];
+        if (table->dataDestroyer) {
+            size_t length = _metisMatchingRulesBucket_Length(bucket);
+            for (size_t j = 0; j < length; j++) {
+                void *data = _metisMatchingRulesBucket_Data(bucket, j);
+                table->dataDestroyer(&data);
+            }
+        }
+        _metisMatchingRulesBucket_FreeOverflow(bucket);
+    }
 
+    parcMemory_Deallocate((void **) &table->buckets);
     parcMemory_Deallocate((void **) &table);
     *tablePtr = NULL;
 }
 
+size_t
+metisMatchingRulesTable_Length(const MetisMatchingRulesTable *table)
+{
+    assertNotNull(table, "Parameter table must be non-null");
+    return table->length;
+}
+
 void *
 metisMatchingRulesTable_Get(const MetisMatchingRulesTable *rulesTable, const MetisMessage *message)
 {
     assertNotNull(rulesTable, "Parameter rulesTable must be non-null");
     assertNotNull(message, "Parameter message must be non-null");
 
-    PARCHashCodeTable *hashTable = metisMatchingRulesTable_GetTableForMessage(rulesTable, message);
-    return parcHashCodeTable_Get(hashTable, message);
+    _MetisMatchingRulesBucket *bucket = _metisMatchingRulesTable_GetBucket(rulesTable, message);
+    if (bucket) {
+        ssize_t position = _metisMatchingRulesBucket_Find(bucket, _metisMatchingRulesTable_RuleForMessage(message), message);
+        if (position >= 0) {
+            return _metisMatchingRulesBucket_Data(bucket, position);
+        }
+    }
+    return NULL;
 }
 
-PARCArrayList *
-metisMatchingRulesTable_GetUnion(const MetisMatchingRulesTable *table, const MetisMessage *message)
+void
+metisMatchingRulesTable_Prefetch(const MetisMatchingRulesTable *table, const MetisMessage *message)
 {
-    // we can have at most 3 results, so create with that capacity
-    PARCArrayList *list = parcArrayList_Create_Capacity(NULL, NULL, 3);
+    uint32_t nameHash = metisTlvName_HashCode(metisMessage_GetName(message));
 
-    void *dataByName = parcHashCodeTable_Get(table->tableByName, message);
-    if (dataByName) {
-        parcArrayList_Add(list, dataByName);
-    }
+    // prefetch for writing, a PIT lookup usually adds or removes a variant
+    __builtin_prefetch(&table->buckets[nameHash & (table->capacity - 1)], 1);
+}
 
-    if (metisMessage_HasKeyId(message)) {
-        void *dataByNameAndKeyId = parcHashCodeTable_Get(table->tableByNameAndKeyId, message);
-        if (dataByNameAndKeyId) {
-            parcArrayList_Add(list, dataByNameAndKeyId);
-        }
+size_t
+metisMatchingRulesTable_GetUnion(const MetisMatchingRulesTable *table, const MetisMessage *message, void *matches[METIS_MATCHING_RULES_TABLE_MAX_MATCHES])
+{
+    assertNotNull(table, "Parameter table must be non-null");
+    assertNotNull(message, "Parameter message must be non-null");
+    assertNotNull(matches, "Parameter matches must be non-null");
+
+    _MetisMatchingRulesBucket *bucket = _metisMatchingRulesTable_GetBucket(table, message);
+    if (bucket == NULL) {
+        return 0;
     }
 
-    if (metisMessage_HasContentObjectHash(message)) {
-        void *dataByNameAndObjectHash = parcHashCodeTable_Get(table->tableByNameAndObjectHash, message);
-        if (dataByNameAndObjectHash) {
-            parcArrayList_Add(list, dataByNameAndObjectHash);
+    bool hasKeyId = metisMessage_HasKeyId(message);
+    bool hasObjectHash = metisMessage_HasContentObjectHash(message);
+
+    // Each rule is unique per message, so there is at most one match per rule
+    size_t count = 0;
+    size_t length = _metisMatchingRulesBucket_Length(bucket);
+    for (size_t i = 0; i < length && count < METIS_MATCHING_RULES_TABLE_MAX_MATCHES; i++) {
+        MetisMatchingRule rule = _metisMatchingRulesBucket_Rule(bucket, i);
+        bool applies = (rule == MetisMatchingRule_Name) ||
+                       (rule == MetisMatchingRule_NameAndKeyId && hasKeyId) ||
+                       (rule == MetisMatchingRule_NameAndObjectHash && hasObjectHash);
+
+        if (applies && _metisMatchingRulesBucket_VariantMatches(bucket, i, rule, message)) {
+            matches[count++] = _metisMatchingRulesBucket_Data(bucket, i);
         }
     }
 
-    return list;
+    return count;
 }
 
 void
@@ -176,8 +580,7 @@ metisMatchingRulesTable_RemoveFromBest(MetisMatchingRulesTable *rulesTable, cons
     assertNotNull(rulesTable, "Parameter rulesTable must be non-null");
     assertNotNull(message, "Parameter message must be non-null");
 
-    PARCHashCodeTable *hashTable = metisMatchingRulesTable_GetTableForMessage(rulesTable, message);
-    parcHashCodeTable_Del(hashTable, message);
+    _metisMatchingRulesTable_Remove(rulesTable, _metisMatchingRulesTable_RuleForMessage(message), message);
 }
 
 void
@@ -186,15 +589,15 @@ metisMatchingRulesTable_RemoveFromAll(MetisMatchingRulesTable *rulesTable, const
     assertNotNull(rulesTable, "Parameter rulesTable must be non-null");
     assertNotNull(message, "Parameter message must be non-null");
 
-    parcHashCodeTable_Del(rulesTable->tableByName, message);
+    _metisMatchingRulesTable_Remove(rulesTable, MetisMatchingRule_Name, message);
 
     // not all messages have a keyid any more
     if (metisMessage_HasKeyId(message)) {
-        parcHashCodeTable_Del(rulesTable->tableByNameAndKeyId, message);
+        _metisMatchingRulesTable_Remove(rulesTable, MetisMatchingRule_NameAndKeyId, message);
     }
 
     if (metisMessage_HasContentObjectHash(message)) {
-        parcHashCodeTable_Del(rulesTable->tableByNameAndObjectHash, message);
+        _metisMatchingRulesTable_Remove(rulesTable, MetisMatchingRule_NameAndObjectHash, message);
     }
 }
 
@@ -205,11 +608,7 @@ metisMatchingRulesTable_AddToBestTable(MetisMatchingRulesTable *rulesTable, Meti
     assertNotNull(key, "Parameter key must be non-null");
     assertNotNull(data, "Parameter data must be non-null");
 
-    PARCHashCodeTable *hashTable = metisMatchingRulesTable_GetTableForMessage(rulesTable, key);
-
-    bool success = parcHashCodeTable_Add(hashTable, key, data);
-
-    return success;
+    return _metisMatchingRulesTable_Add(rulesTable, _metisMatchingRulesTable_RuleForMessage(key), key, data);
 }
 
 void
@@ -219,29 +618,12 @@ metisMatchingRulesTable_AddToAllTables(MetisMatchingRulesTable *rulesTable, Meti
     assertNotNull(key, "Parameter key must be non-null");
     assertNotNull(data, "Parameter data must be non-null");
 
-    parcHashCodeTable_Add(rulesTable->tableByName, key, data);
+    _metisMatchingRulesTable_Add(rulesTable, MetisMatchingRule_Name, key, data);
 
     // not all messages have a keyid any more
     if (metisMessage_HasKeyId(key)) {
-        parcHashCodeTable_Add(rulesTable->tableByNameAndKeyId, key, data);
-    }
-
-    parcHashCodeTable_Add(rulesTable->tableByNameAndObjectHash, key, data);
-}
-
-// ========================================================================================
-
-static PARCHashCodeTable *
-metisMatchingRulesTable_GetTableForMessage(const MetisMatchingRulesTable *pit, const MetisMessage *interestMessage)
-{
-    PARCHashCodeTable *table;
-    if (metisMessage_HasContentObjectHash(interestMessage)) {
-        table = pit->tableByNameAndObjectHash;
-    } else if (metisMessage_HasKeyId(interestMessage)) {
-        table = pit->tableByNameAndKeyId;
-    } else {
-        table = pit->tableByName;
+        _metisMatchingRulesTable_Add(rulesTable, MetisMatchingRule_NameAndKeyId, key, data);
     }
 
-    return table;
+    _metisMatchingRulesTable_Add(rulesTable, MetisMatchingRule_NameAndObjectHash, key, data);
 }
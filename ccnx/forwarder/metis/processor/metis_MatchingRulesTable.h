@@ -64,6 +64,10 @@
  *     <code>metisMatchingRulesTable_GetUnion()</code> on a content object to match against
  *     all of them.
  *
+ *     The "tables" are logical.  Storage is one open-addressed hash table keyed by name, where
+ *     each bucket holds every entry for that name along with its matching rule, so a lookup
+ *     for all three rules is a single probe.
+ *
  *     When used in a ContentStore, one calls <code>metisMatchingRulesTable_AddToAllTables()</code>
  *     to index a Content Object in all the tables.  one then calls <code>metisMatchingRulesTable_Get()</code>
  *     with an Interest to do the "best" matching (i.e by hash first, then keyid, then just by name).
@@ -77,7 +81,11 @@
 
 #include <parc/algol/parc_HashCodeTable.h>
 #include <ccnx/forwarder/metis/core/metis_Message.h>
-#include <parc/algol/parc_ArrayList.h>
+
+/**
+ * The most entries metisMatchingRulesTable_GetUnion() will return, one for each matching rule
+ */
+#define METIS_MATCHING_RULES_TABLE_MAX_MATCHES 3
 
 struct metis_matching_rules_table;
 typedef struct metis_matching_rules_table MetisMatchingRulesTable;
@@ -125,18 +133,60 @@ void metisMatchingRulesTable_Destroy(MetisMatchingRulesTable **tablePtr);
  */
 void *metisMatchingRulesTable_Get(const MetisMatchingRulesTable *table, const MetisMessage *message);
 
+/**
+ * @function metisMatchingRulesTable_Prefetch
+ * @abstract Starts loading the message's home bucket in to the cache
+ * @discussion
+ *   A hint for batch processing: call it for a message a few packets ahead of the one being
+ *   looked up, so the bucket is in the cache by the time that message gets to the table.
+ *   It computes the name hash, if not already cached in the name, and does not change the table.
+ *
+ * @param table The table the message will be looked up in
+ * @param message The message that will be looked up
+ */
+void metisMatchingRulesTable_Prefetch(const MetisMatchingRulesTable *table, const MetisMessage *message);
+
 /**
  * @function metisMatchingRulesTable_GetUnion
  * @abstract Returns matching data items from all index tables.
  * @discussion
- *   The PARCArrayList does not have an item destructor, so destroying it will not affect
- *   the underlying data.
+ *   Fills in the caller's array, so there is no allocation.  The order of the matches is unspecified.
  *
+ * @param matches [out] Filled in with up to METIS_MATCHING_RULES_TABLE_MAX_MATCHES data items
+ * @return The number of matches, may be 0
  *
- * @param <#param1#>
- * @return Will not be NULL, but may be empty
+ * Example:
+ * @code
+ * {
+ *     void *matches[METIS_MATCHING_RULES_TABLE_MAX_MATCHES];
+ *     size_t count = metisMatchingRulesTable_GetUnion(table, objectMessage, matches);
+ *     for (size_t i = 0; i < count; i++) {
+ *         MetisPitEntry *pitEntry = matches[i];
+ *     }
+ * }
+ * @endcode
+ */
+size_t metisMatchingRulesTable_GetUnion(const MetisMatchingRulesTable *table, const MetisMessage *message, void *matches[METIS_MATCHING_RULES_TABLE_MAX_MATCHES]);
+
+/**
+ * The number of entries stored in the table
+ *
+ * An entry added with metisMatchingRulesTable_AddToAllTables() counts once for each rule it was
+ * indexed under.
+ *
+ * @param [in] table An allocated MetisMatchingRulesTable
+ *
+ * @return The number of stored entries
+ *
+ * Example:
+ * @code
+ * {
+ *     metisMatchingRulesTable_AddToBestTable(table, interest, pitEntry);
+ *     size_t length = metisMatchingRulesTable_Length(table);
+ * }
+ * @endcode
  */
-PARCArrayList *metisMatchingRulesTable_GetUnion(const MetisMatchingRulesTable *table, const MetisMessage *message);
+size_t metisMatchingRulesTable_Length(const MetisMatchingRulesTable *table);
 
 /**
  * @function metisMatchingRulesTable_Add
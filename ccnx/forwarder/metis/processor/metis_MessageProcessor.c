@@ -60,6 +60,10 @@
 #include <config.h>
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <inttypes.h>
 
 #include <ccnx/forwarder/metis/processor/metis_MessageProcessor.h>
 #include <parc/algol/parc_Memory.h>
@@ -67,12 +71,31 @@
 
 #include <ccnx/forwarder/metis/processor/metis_StandardPIT.h>
 #include <ccnx/forwarder/metis/processor/metis_FIB.h>
+#include <ccnx/forwarder/metis/processor/metis_HashFIB.h>
+#include <ccnx/forwarder/metis/processor/metis_TrieFIB.h>
 
 #include <ccnx/forwarder/metis/content_store/metis_ContentStoreInterface.h>
 #include <ccnx/forwarder/metis/content_store/metis_LRUContentStore.h>
+#include <ccnx/forwarder/metis/content_store/metis_TinyLFUContentStore.h>
+#include <ccnx/forwarder/metis/content_store/metis_DiskContentStore.h>
+
+#include <ccnx/forwarder/metis/core/metis_CacheLine.h>
+#include <ccnx/forwarder/metis/core/metis_Latency.h>
 
 #include <LongBow/runtime.h>
 
+/**
+ * In metisMessageProcessor_ReceiveBatch, how many messages ahead of the one being looked up
+ * to prefetch the PIT bucket.  Far enough to hide a cache miss behind the lookups in between.
+ */
+#define METIS_PROCESSOR_PREFETCH_DISTANCE 4
+
+/**
+ * The most objects evicted per event loop pass when a content store is shrunk, so a large shrink
+ * does not stall forwarding.
+ */
+#define METIS_PROCESSOR_TRIM_BATCH 1024
+
 /**
  * @typedef MetisProcessorStats
  * @abstract MessageProcessor         event counters
@@ -96,31 +119,32 @@
  * @constant countDroppedZeroHopLimitToRemote Number of Interest not forwarded to a FIB entry because hoplimit is 0 and its remote
  * @constant countSendFailures         Number of send failures (problems using MetisIoOperations)
  *
- * @discussion <#Discussion#>
+ * @discussion Only the thread running the processor writes these, with metisStats_Increment(), so
+ *   metisMessageProcessor_AccumulateStats() may read them from another thread.
  */
 typedef struct metis_processor_stats {
-    uint32_t countReceived;
-    uint32_t countInterestsReceived;
-    uint32_t countObjectsReceived;
+    uint64_t countReceived;
+    uint64_t countInterestsReceived;
+    uint64_t countObjectsReceived;
 
-    uint32_t countInterestsAggregated;
+    uint64_t countInterestsAggregated;
 
-    uint32_t countDropped;
-    uint32_t countInterestsDropped;
-    uint32_t countDroppedNoRoute;
-    uint32_t countDroppedNoReversePath;
+    uint64_t countDropped;
+    uint64_t countInterestsDropped;
+    uint64_t countDroppedNoRoute;
+    uint64_t countDroppedNoReversePath;
 
-    uint32_t countDroppedConnectionNotFound;
-    uint32_t countObjectsDropped;
+    uint64_t countDroppedConnectionNotFound;
+    uint64_t countObjectsDropped;
 
-    uint32_t countSendFailures;
-    uint32_t countInterestForwarded;
-    uint32_t countObjectsForwarded;
-    uint32_t countInterestsSatisfiedFromStore;
+    uint64_t countSendFailures;
+    uint64_t countInterestForwarded;
+    uint64_t countObjectsForwarded;
+    uint64_t countInterestsSatisfiedFromStore;
 
-    uint32_t countDroppedNoHopLimit;
-    uint32_t countDroppedZeroHopLimitFromRemote;
-    uint32_t countDroppedZeroHopLimitToRemote;
+    uint64_t countDroppedNoHopLimit;
+    uint64_t countDroppedZeroHopLimitFromRemote;
+    uint64_t countDroppedZeroHopLimitToRemote;
 } _MetisProcessorStats;
 
 struct metis_message_processor {
@@ -130,14 +154,40 @@ struct metis_message_processor {
 
     MetisPIT *pit;
     MetisContentStoreInterface *contentStore;
+    MetisContentStoreConfig contentStoreConfig;
+    MetisContentStoreType contentStoreType;
+
+    // The optional second tier of contentStore, may be NULL
+    MetisContentStoreInterface *diskStore;
     MetisFIB *fib;
 
+    // Runs this processor's timers.  After the content store is shrunk, contentStoreTrimEvent
+    // evicts the excess in batches of METIS_PROCESSOR_TRIM_BATCH, one batch per pass of the event loop.
+    MetisDispatcher *dispatcher;
+    PARCEventTimer *contentStoreTrimEvent;
+
+    // A shard of a multi-threaded processor sends through egress instead of the connection table
+    unsigned shard;
+    unsigned shardCount;
+    MetisProcessorEgress egress;
+
+    // Interests with a ContentObjectHash restriction looked up and not yet matched by a content
+    // object hashed in metisMessageProcessor_ReceiveBatch().  While non-zero, batches hash their
+    // content objects together.
+    uint64_t pendingObjectHashes;
+
+    // Written only by the thread running this processor, read by metisMessageProcessor_AccumulateStats()
+    uint8_t statsPadBefore[METIS_CACHE_LINE_SIZE];
     _MetisProcessorStats stats;
+    uint8_t statsPadAfter[METIS_CACHE_LINE_SIZE];
 };
 
 static void metisMessageProcessor_Drop(MetisMessageProcessor *processor, MetisMessage *message);
 static void metisMessageProcessor_ReceiveInterest(MetisMessageProcessor *processor, MetisMessage *interestMessage);
 static void metisMessageProcessor_ReceiveContentObject(MetisMessageProcessor *processor, MetisMessage *objectMessage);
+static void metisMessageProcessor_CountReceived(MetisMessageProcessor *processor, MetisMessage *message);
+static bool metisMessageProcessor_AcceptMessage(MetisMessageProcessor *processor, MetisMessage *message);
+static void metisMessageProcessor_LookupMessage(MetisMessageProcessor *processor, MetisMessage *message);
 static unsigned metisMessageProcessor_ForwardToNexthops(MetisMessageProcessor *processor, MetisMessage *message, const MetisNumberSet *nexthops);
 
 static void metisMessageProcessor_ForwardToInterfaceId(MetisMessageProcessor *processor, MetisMessage *message, unsigned interfaceId);
@@ -145,10 +195,137 @@ static void metisMessageProcessor_ForwardToInterfaceId(MetisMessageProcessor *pr
 // ============================================================
 // Public API
 
+/**
+ * A shard's share of a content store limit.  The first total % shardCount shards get one more than
+ * the others, so the shares add up to exactly `total`.
+ *
+ * For an object capacity a share of 0 turns the shard's store off, which is what a total of 0 means.
+ */
+static size_t
+_metisMessageProcessor_ShardShare(const MetisMessageProcessor *processor, size_t total)
+{
+    size_t share = total / processor->shardCount;
+    if (processor->shard < total % processor->shardCount) {
+        share++;
+    }
+    return share;
+}
+
+/**
+ * A shard's share of a byte capacity.  A byte capacity of 0 means no limit, so a shard whose share of
+ * a (tiny) limit rounds down to 0 gets 1 byte instead, which stores nothing.
+ */
+static size_t
+_metisMessageProcessor_ShardByteShare(const MetisMessageProcessor *processor, size_t total)
+{
+    size_t share = _metisMessageProcessor_ShardShare(processor, total);
+    return (total > 0 && share == 0) ? 1 : share;
+}
+
+static void
+_metisMessageProcessor_ScheduleTrim(MetisMessageProcessor *processor)
+{
+    struct timeval now = { 0, 0 };
+    metisDispatcher_StartTimer(processor->dispatcher, processor->contentStoreTrimEvent, &now);
+}
+
+static void
+_metisMessageProcessor_TrimCallback(int fd, PARCEventType which_event, void *user_data)
+{
+    MetisMessageProcessor *processor = (MetisMessageProcessor *) user_data;
+
+    uint64_t currentTimeTicks = metisForwarder_GetTicks(processor->metis);
+    if (!metisContentStoreInterface_Trim(processor->contentStore, METIS_PROCESSOR_TRIM_BATCH, currentTimeTicks)) {
+        _metisMessageProcessor_ScheduleTrim(processor);
+    }
+}
+
+/**
+ * Creates an empty content store of processor->contentStoreType from processor->contentStoreConfig
+ */
+static MetisContentStoreInterface *
+_metisMessageProcessor_CreateContentStore(MetisMessageProcessor *processor)
+{
+    MetisContentStoreInterface *store = NULL;
+
+    switch (processor->contentStoreType) {
+        case MetisContentStoreType_LRU:
+            store = metisLRUContentStore_Create(&processor->contentStoreConfig, processor->logger);
+            break;
+
+        case MetisContentStoreType_TinyLFU:
+            store = metisTinyLFUContentStore_Create(&processor->contentStoreConfig, processor->logger);
+            break;
+
+        default:
+            trapIllegalValue(processor->contentStoreType, "Unknown content store type %d", processor->contentStoreType);
+    }
+
+    return store;
+}
+
+/**
+ * Applies processor->contentStoreConfig to the content store.  A store that can change its limits in
+ * place keeps its contents, and is trimmed from the event loop if it is now too big.  Otherwise it
+ * is re-created empty.
+ */
+static void
+_metisMessageProcessor_ResizeContentStore(MetisMessageProcessor *processor)
+{
+    if (metisContentStoreInterface_SetCapacity(processor->contentStore,
+                                               processor->contentStoreConfig.objectCapacity,
+                                               processor->contentStoreConfig.byteCapacity)) {
+        _metisMessageProcessor_ScheduleTrim(processor);
+    } else {
+        metisContentStoreInterface_Release(&processor->contentStore);
+        processor->contentStore = _metisMessageProcessor_CreateContentStore(processor);
+    }
+}
+
+/**
+ * Each shard keeps its own segment files, in a sub-directory of the configured directory
+ */
+static MetisContentStoreInterface *
+_metisMessageProcessor_CreateDiskStore(MetisMessageProcessor *processor, const char *directory, size_t maximumDiskBytes)
+{
+    MetisContentStoreConfig diskConfig = {
+        .byteCapacity = _metisMessageProcessor_ShardByteShare(processor, maximumDiskBytes),
+    };
+
+    if (processor->shardCount == 1) {
+        return metisDiskContentStore_Create(&diskConfig, directory, processor->logger);
+    }
+
+    if (mkdir(directory, 0700) != 0 && errno != EEXIST) {
+        if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error)) {
+            metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Error, __func__,
+                            "MessageProcessor could not create directory %s: (%d) %s",
+                            directory, errno, strerror(errno));
+        }
+    }
+
+    char shardDirectory[PATH_MAX];
+    snprintf(shardDirectory, sizeof(shardDirectory), "%s/shard%u", directory, processor->shard);
+    return metisDiskContentStore_Create(&diskConfig, shardDirectory, processor->logger);
+}
+
 MetisMessageProcessor *
 metisMessageProcessor_Create(MetisForwarder *metis)
 {
+    return metisMessageProcessor_CreateShard(metis, metisForwarder_GetDispatcher(metis), NULL, 0, 1);
+}
+
+MetisMessageProcessor *
+metisMessageProcessor_CreateShard(MetisForwarder *metis, MetisDispatcher *dispatcher, const MetisProcessorEgress *egress, unsigned shard, unsigned shardCount)
+{
+    assertNotNull(metis, "Parameter metis must be non-null");
+    assertNotNull(dispatcher, "Parameter dispatcher must be non-null");
+    assertTrue(shard < shardCount, "Shard %u out of range, shard count %u", shard, shardCount);
+
     size_t objectStoreSize = metisConfiguration_GetObjectStoreSize(metisForwarder_GetConfiguration(metis));
+    size_t objectStoreBytes = metisConfiguration_GetObjectStoreBytes(metisForwarder_GetConfiguration(metis));
+    const char *diskDirectory = metisConfiguration_GetObjectStoreDiskDirectory(metisForwarder_GetConfiguration(metis));
+    size_t diskBytes = metisConfiguration_GetObjectStoreDiskBytes(metisForwarder_GetConfiguration(metis));
 
     MetisMessageProcessor *processor = parcMemory_AllocateAndClear(sizeof(MetisMessageProcessor));
     assertNotNull(processor, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisMessageProcessor));
@@ -156,23 +333,36 @@ metisMessageProcessor_Create(MetisForwarder *metis)
 
     processor->metis = metis;
     processor->logger = metisLogger_Acquire(metisForwarder_GetLogger(metis));
-    processor->pit = metisStandardPIT_Create(metis);
+    processor->pit = metisStandardPIT_CreateWithDispatcher(metis, dispatcher);
 
-    processor->fib = metisFIB_Create(processor->logger);
+    processor->shard = shard;
+    processor->shardCount = shardCount;
+    if (egress != NULL) {
+        processor->egress = *egress;
+    }
+
+    processor->fib = metisHashFIB_Create(processor->logger);
+
+    processor->dispatcher = dispatcher;
+    processor->contentStoreTrimEvent = metisDispatcher_CreateTimer(dispatcher, false, _metisMessageProcessor_TrimCallback, processor);
 
     if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
         metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                        "MessageProcessor %p created",
-                        (void *) processor);
+                        "MessageProcessor %p created (shard %u of %u)",
+                        (void *) processor, shard, shardCount);
     }
 
-    MetisContentStoreConfig contentStoreConfig = {
-        .objectCapacity = objectStoreSize,
-    };
+    processor->contentStoreConfig.objectCapacity = _metisMessageProcessor_ShardShare(processor, objectStoreSize);
+    processor->contentStoreConfig.byteCapacity = _metisMessageProcessor_ShardByteShare(processor, objectStoreBytes);
 
-    // Currently, this will instantiate an LRUContentStore. Perhaps someday it'll switch stores
-    // based on the MetisContentStoreConfig passed to it.
-    processor->contentStore = metisLRUContentStore_Create(&contentStoreConfig, processor->logger);
+    if (diskDirectory != NULL) {
+        processor->diskStore = _metisMessageProcessor_CreateDiskStore(processor, diskDirectory, diskBytes);
+        processor->contentStoreConfig.secondTier = processor->diskStore;
+    }
+
+    // Starts as an LRU store, metisMessageProcessor_SetContentStoreType() may replace it
+    processor->contentStoreType = MetisContentStoreType_LRU;
+    processor->contentStore = _metisMessageProcessor_CreateContentStore(processor);
 
     return processor;
 }
@@ -181,13 +371,72 @@ void
 metisMessageProcessor_SetContentObjectStoreSize(MetisMessageProcessor *processor, size_t maximumContentStoreSize)
 {
     assertNotNull(processor, "Parameter processor must be non-null");
+
+    processor->contentStoreConfig.objectCapacity = _metisMessageProcessor_ShardShare(processor, maximumContentStoreSize);
+    _metisMessageProcessor_ResizeContentStore(processor);
+}
+
+void
+metisMessageProcessor_SetContentObjectStoreBytes(MetisMessageProcessor *processor, size_t maximumContentStoreBytes)
+{
+    assertNotNull(processor, "Parameter processor must be non-null");
+
+    processor->contentStoreConfig.byteCapacity = _metisMessageProcessor_ShardByteShare(processor, maximumContentStoreBytes);
+    _metisMessageProcessor_ResizeContentStore(processor);
+}
+
+void
+metisMessageProcessor_SetContentObjectStoreDisk(MetisMessageProcessor *processor, const char *directory, size_t maximumDiskBytes)
+{
+    assertNotNull(processor, "Parameter processor must be non-null");
+
+    // Releasing the memory store demotes its objects to the old disk store
     metisContentStoreInterface_Release(&processor->contentStore);
+    if (processor->diskStore != NULL) {
+        metisContentStoreInterface_Release(&processor->diskStore);
+    }
 
-    MetisContentStoreConfig contentStoreConfig = {
-        .objectCapacity = maximumContentStoreSize
-    };
+    processor->diskStore = NULL;
+    if (directory != NULL) {
+        processor->diskStore = _metisMessageProcessor_CreateDiskStore(processor, directory, maximumDiskBytes);
+    }
+
+    processor->contentStoreConfig.secondTier = processor->diskStore;
+    processor->contentStore = _metisMessageProcessor_CreateContentStore(processor);
+}
+
+void
+metisMessageProcessor_SetContentStoreType(MetisMessageProcessor *processor, MetisContentStoreType contentStoreType)
+{
+    assertNotNull(processor, "Parameter processor must be non-null");
 
-    processor->contentStore = metisLRUContentStore_Create(&contentStoreConfig, processor->logger);
+    // Releasing the old store demotes its objects to the disk store, if there is one, and the new
+    // store promotes them back as they are asked for.
+    metisContentStoreInterface_Release(&processor->contentStore);
+    processor->contentStoreType = contentStoreType;
+    processor->contentStore = _metisMessageProcessor_CreateContentStore(processor);
+}
+
+void
+metisMessageProcessor_SetFIBType(MetisMessageProcessor *processor, MetisFIBType fibType)
+{
+    assertNotNull(processor, "Parameter processor must be non-null");
+    assertTrue(metisFIB_Length(processor->fib) == 0, "Cannot change the FIB type after routes are added");
+
+    metisFIB_Destroy(&processor->fib);
+
+    switch (fibType) {
+        case MetisFIBType_Hash:
+            processor->fib = metisHashFIB_Create(processor->logger);
+            break;
+
+        case MetisFIBType_Trie:
+            processor->fib = metisTrieFIB_Create(processor->logger);
+            break;
+
+        default:
+            trapIllegalValue(fibType, "Unknown FIB type %d", fibType);
+    }
 }
 
 MetisContentStoreInterface *
@@ -211,9 +460,14 @@ metisMessageProcessor_Destroy(MetisMessageProcessor **processorPtr)
                         (void *) processor);
     }
 
+    metisDispatcher_StopTimer(processor->dispatcher, processor->contentStoreTrimEvent);
+    metisDispatcher_DestroyTimerEvent(processor->dispatcher, &processor->contentStoreTrimEvent);
     metisLogger_Release(&processor->logger);
     metisFIB_Destroy(&processor->fib);
     metisContentStoreInterface_Release(&processor->contentStore);
+    if (processor->diskStore != NULL) {
+        metisContentStoreInterface_Release(&processor->diskStore);
+    }
     metisPIT_Release(&processor->pit);
 
     parcMemory_Deallocate((void **) &processor);
@@ -226,29 +480,7 @@ metisMessageProcessor_Receive(MetisMessageProcessor *processor, MetisMessage *me
     assertNotNull(processor, "Parameter processor must be non-null");
     assertNotNull(message, "Parameter message must be non-null");
 
-    processor->stats.countReceived++;
-
-    if (processor->tap != NULL && processor->tap->isTapOnReceive(processor->tap)) {
-        processor->tap->tapOnReceive(processor->tap, message);
-    }
-
-    if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
-        char *nameString = "NONAME";
-        if (metisMessage_HasName(message)) {
-            CCNxName *name = metisTlvName_ToCCNxName(metisMessage_GetName(message));
-            nameString = ccnxName_ToString(name);
-
-            metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                            "Message %p ingress %3u length %5u received name %s",
-                            (void *) message,
-                            metisMessage_GetIngressConnectionId(message),
-                            metisMessage_Length(message),
-                            nameString);
-
-            parcMemory_Deallocate((void **) &nameString);
-            ccnxName_Release(&name);
-        }
-    }
+    metisMessageProcessor_CountReceived(processor, message);
 
     switch (metisMessage_GetType(message)) {
         case MetisMessagePacketType_Interest:
@@ -268,6 +500,50 @@ metisMessageProcessor_Receive(MetisMessageProcessor *processor, MetisMessage *me
     metisMessage_Release(&message);
 }
 
+void
+metisMessageProcessor_ReceiveBatch(MetisMessageProcessor *processor, size_t count, MetisMessage *messages[])
+{
+    assertNotNull(processor, "Parameter processor must be non-null");
+    assertTrue(count == 0 || messages != NULL, "Parameter messages must be non-null");
+
+    // Stage 1: everything that does not touch the tables.  Dropped messages are released here and
+    // the rest are packed to the front of the array.
+    size_t accepted = 0;
+    for (size_t i = 0; i < count; i++) {
+        MetisMessage *message = messages[i];
+        assertNotNull(message, "Parameter messages[%zu] must be non-null", i);
+
+        if (metisMessageProcessor_AcceptMessage(processor, message)) {
+            messages[accepted++] = message;
+        } else {
+            metisMessage_Release(&message);
+        }
+    }
+
+    // Content objects answering interests with a ContentObjectHash restriction need their hash
+    // for the PIT, and hashing them together is much faster than hashing them one at a time.
+    if (processor->pendingObjectHashes > 0) {
+        size_t hashed = metisMessage_ComputeContentObjectHashes(accepted, messages);
+        processor->pendingObjectHashes -= (hashed < processor->pendingObjectHashes) ? hashed : processor->pendingObjectHashes;
+    }
+
+    // Stage 2: ContentStore, PIT and FIB, in arrival order.  Prefetching also computes the name
+    // hash, which the PIT, ContentStore and FIB all use.
+    size_t warmup = (accepted < METIS_PROCESSOR_PREFETCH_DISTANCE) ? accepted : METIS_PROCESSOR_PREFETCH_DISTANCE;
+    for (size_t i = 0; i < warmup; i++) {
+        metisPIT_Prefetch(processor->pit, messages[i]);
+    }
+
+    for (size_t i = 0; i < accepted; i++) {
+        if (i + METIS_PROCESSOR_PREFETCH_DISTANCE < accepted) {
+            metisPIT_Prefetch(processor->pit, messages[i + METIS_PROCESSOR_PREFETCH_DISTANCE]);
+        }
+
+        metisMessageProcessor_LookupMessage(processor, messages[i]);
+        metisMessage_Release(&messages[i]);
+    }
+}
+
 void
 metisMessageProcessor_AddTap(MetisMessageProcessor *processor, MetisTap *tap)
 {
@@ -313,6 +589,34 @@ metisMessageProcessor_GetFibEntries(MetisMessageProcessor *processor)
     return metisFIB_GetEntries(processor->fib);
 }
 
+void
+metisMessageProcessor_AccumulateStats(MetisMessageProcessor *processor, MetisStats *stats)
+{
+    assertNotNull(processor, "Parameter processor must be non-null");
+    assertNotNull(stats, "Parameter stats must be non-null");
+
+    stats->values[MetisStat_Received] += metisStats_Read(processor->stats.countReceived);
+    stats->values[MetisStat_InterestsReceived] += metisStats_Read(processor->stats.countInterestsReceived);
+    stats->values[MetisStat_ObjectsReceived] += metisStats_Read(processor->stats.countObjectsReceived);
+    stats->values[MetisStat_InterestsAggregated] += metisStats_Read(processor->stats.countInterestsAggregated);
+    stats->values[MetisStat_InterestsForwarded] += metisStats_Read(processor->stats.countInterestForwarded);
+    stats->values[MetisStat_ObjectsForwarded] += metisStats_Read(processor->stats.countObjectsForwarded);
+    stats->values[MetisStat_InterestsSatisfiedFromStore] += metisStats_Read(processor->stats.countInterestsSatisfiedFromStore);
+    stats->values[MetisStat_Dropped] += metisStats_Read(processor->stats.countDropped);
+    stats->values[MetisStat_InterestsDropped] += metisStats_Read(processor->stats.countInterestsDropped);
+    stats->values[MetisStat_ObjectsDropped] += metisStats_Read(processor->stats.countObjectsDropped);
+    stats->values[MetisStat_DroppedNoRoute] += metisStats_Read(processor->stats.countDroppedNoRoute);
+    stats->values[MetisStat_DroppedNoReversePath] += metisStats_Read(processor->stats.countDroppedNoReversePath);
+    stats->values[MetisStat_DroppedConnectionNotFound] += metisStats_Read(processor->stats.countDroppedConnectionNotFound);
+    stats->values[MetisStat_DroppedNoHopLimit] += metisStats_Read(processor->stats.countDroppedNoHopLimit);
+    stats->values[MetisStat_DroppedZeroHopLimitFromRemote] += metisStats_Read(processor->stats.countDroppedZeroHopLimitFromRemote);
+    stats->values[MetisStat_DroppedZeroHopLimitToRemote] += metisStats_Read(processor->stats.countDroppedZeroHopLimitToRemote);
+    stats->values[MetisStat_SendFailures] += metisStats_Read(processor->stats.countSendFailures);
+
+    // the LRU store adds in its second tier, processor->diskStore
+    metisContentStoreInterface_AccumulateStats(processor->contentStore, stats);
+}
+
 // ============================================================
 // Internal API
 
@@ -335,15 +639,15 @@ metisMessageProcessor_Drop(MetisMessageProcessor *processor, MetisMessage *messa
         processor->tap->tapOnDrop(processor->tap, message);
     }
 
-    processor->stats.countDropped++;
+    metisStats_Increment(processor->stats.countDropped);
 
     switch (metisMessage_GetType(message)) {
         case MetisMessagePacketType_Interest:
-            processor->stats.countInterestsDropped++;
+            metisStats_Increment(processor->stats.countInterestsDropped);
             break;
 
         case MetisMessagePacketType_ContentObject:
-            processor->stats.countObjectsDropped++;
+            metisStats_Increment(processor->stats.countObjectsDropped);
             break;
 
         default:
@@ -365,15 +669,17 @@ metisMessageProcessor_Drop(MetisMessageProcessor *processor, MetisMessage *messa
 static bool
 metisMessageProcessor_AggregateInterestInPit(MetisMessageProcessor *processor, MetisMessage *interestMessage)
 {
+    uint64_t latencyStart = metisLatency_Start();
     MetisPITVerdict verdict = metisPIT_ReceiveInterest(processor->pit, interestMessage);
+    metisLatency_Stop(MetisLatencyStage_Pit, latencyStart);
 
     if (verdict == MetisPITVerdict_Aggregate) {
         // PIT has it, we're done
-        processor->stats.countInterestsAggregated++;
+        metisStats_Increment(processor->stats.countInterestsAggregated);
 
         if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
             metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                            "Message %p aggregated in PIT (aggregated count %u)",
+                            "Message %p aggregated in PIT (aggregated count %" PRIu64 ")",
                             (void *) interestMessage,
                             processor->stats.countInterestsAggregated);
         }
@@ -383,7 +689,7 @@ metisMessageProcessor_AggregateInterestInPit(MetisMessageProcessor *processor, M
 
     if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
         metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                        "Message %p not aggregated in PIT (aggregated count %u)",
+                        "Message %p not aggregated in PIT (aggregated count %" PRIu64 ")",
                         (void *) interestMessage,
                         processor->stats.countInterestsAggregated);
     }
@@ -391,13 +697,26 @@ metisMessageProcessor_AggregateInterestInPit(MetisMessageProcessor *processor, M
     return false;
 }
 
+/**
+ * Answers an interest from the content store, without touching the PIT
+ *
+ * This runs before the PIT, so a hit never creates a PIT entry only to remove it again.  The
+ * object goes straight back to the interest's ingress connection (unless that is where the object
+ * came from, as metisMessageProcessor_ForwardToNexthops() would do).  An interest the store can
+ * answer has no need to be aggregated; PIT entries of other interests for the same name are left
+ * for the reply from upstream.
+ *
+ * @return true if the interest was answered
+ */
 static bool
 _satisfyFromContentStore(MetisMessageProcessor *processor, MetisMessage *interestMessage)
 {
     bool result = false;
 
     // See if there's a match in the store.
+    uint64_t latencyStart = metisLatency_Start();
     MetisMessage *objectMessage = metisContentStoreInterface_MatchInterest(processor->contentStore, interestMessage);
+    metisLatency_Stop(MetisLatencyStage_ContentStore, latencyStart);
 
     if (objectMessage) {
         // If the Interest specified a KeyId restriction and we had a match, check to see if the ContentObject's KeyId
@@ -427,22 +746,20 @@ _satisfyFromContentStore(MetisMessageProcessor *processor, MetisMessage *interes
         }
 
         if (!hasExpired) { // && !hasExceededRCT ? It's up to us.
-            // Remove it from the PIT.  nexthops is allocated, so need to destroy
-            MetisNumberSet *nexthops = metisPIT_SatisfyInterest(processor->pit, objectMessage);
-            assertNotNull(nexthops, "Illegal state: got a null nexthops for an interest we just inserted.");
-
             // send message in reply, then done
-            processor->stats.countInterestsSatisfiedFromStore++;
+            metisStats_Increment(processor->stats.countInterestsSatisfiedFromStore);
 
             if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
                 metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                                "Message %p satisfied from content store (satisfied count %u)",
+                                "Message %p satisfied from content store (satisfied count %" PRIu64 ")",
                                 (void *) interestMessage,
                                 processor->stats.countInterestsSatisfiedFromStore);
             }
 
-            metisMessageProcessor_ForwardToNexthops(processor, objectMessage, nexthops);
-            metisNumberSet_Release(&nexthops);
+            unsigned ingressId = metisMessage_GetIngressConnectionId(interestMessage);
+            if (ingressId != metisMessage_GetIngressConnectionId(objectMessage)) {
+                metisMessageProcessor_ForwardToInterfaceId(processor, objectMessage, ingressId);
+            }
 
             result = true;
         }
@@ -479,7 +796,9 @@ metisMessageProcessor_ForwardViaFib(MetisMessageProcessor *processor, MetisMessa
     // Look in the FIB.
     // nexthops will not be NULL, but may be empty.
 
+    uint64_t latencyStart = metisLatency_Start();
     const MetisNumberSet *nexthops = metisFIB_Match(processor->fib, interestMessage);
+    metisLatency_Stop(MetisLatencyStage_Fib, latencyStart);
 
     if (metisMessageProcessor_ForwardToNexthops(processor, interestMessage, nexthops) > 0) {
         forwarded = true;
@@ -496,6 +815,10 @@ metisMessageProcessor_ForwardViaFib(MetisMessageProcessor *processor, MetisMessa
 static bool
 metisMessageProcessor_IsIngressConnectionLocal(MetisMessageProcessor *processor, MetisMessage *interestMessage)
 {
+    if (processor->egress.isIngressLocal != NULL) {
+        return processor->egress.isIngressLocal(processor->egress.context, interestMessage);
+    }
+
     MetisConnectionTable *connTable = metisForwarder_GetConnectionTable(processor->metis);
     unsigned ingressConnId = metisMessage_GetIngressConnectionId(interestMessage);
     const MetisConnection *ingressConn = metisConnectionTable_FindById(connTable, ingressConnId);
@@ -531,11 +854,11 @@ metisMessageProcessor_CheckAndDecrementHopLimitOnIngress(MetisMessageProcessor *
 {
     bool success = true;
     if (!metisMessage_HasHopLimit(interestMessage)) {
-        processor->stats.countDroppedNoHopLimit++;
+        metisStats_Increment(processor->stats.countDroppedNoHopLimit);
 
         if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
             metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                            "Message %p did not have a hop limit (count %u)",
+                            "Message %p did not have a hop limit (count %" PRIu64 ")",
                             (void *) interestMessage,
                             processor->stats.countDroppedNoHopLimit);
         }
@@ -546,11 +869,11 @@ metisMessageProcessor_CheckAndDecrementHopLimitOnIngress(MetisMessageProcessor *
         if (!metisMessageProcessor_IsIngressConnectionLocal(processor, interestMessage)) {
             uint8_t hoplimit = metisMessage_GetHopLimit(interestMessage);
             if (hoplimit == 0) {
-                processor->stats.countDroppedZeroHopLimitFromRemote++;
+                metisStats_Increment(processor->stats.countDroppedZeroHopLimitFromRemote);
 
                 if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
                     metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                                    "Message %p from remote host has 0 hop limit (count %u)",
+                                    "Message %p from remote host has 0 hop limit (count %" PRIu64 ")",
                                     (void *) interestMessage,
                                     processor->stats.countDroppedZeroHopLimitFromRemote);
                 }
@@ -566,29 +889,109 @@ metisMessageProcessor_CheckAndDecrementHopLimitOnIngress(MetisMessageProcessor *
 }
 
 /**
- * @function metisMessageProcessor_ReceiveInterest
- * @abstract Receive an interest from the network
+ * @function metisMessageProcessor_CountReceived
+ * @abstract Counts a received message and shows it to the tap
+ */
+static void
+metisMessageProcessor_CountReceived(MetisMessageProcessor *processor, MetisMessage *message)
+{
+    metisStats_Increment(processor->stats.countReceived);
+
+    if (processor->tap != NULL && processor->tap->isTapOnReceive(processor->tap)) {
+        processor->tap->tapOnReceive(processor->tap, message);
+    }
+
+    if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+        char *nameString = "NONAME";
+        if (metisMessage_HasName(message)) {
+            CCNxName *name = metisTlvName_ToCCNxName(metisMessage_GetName(message));
+            nameString = ccnxName_ToString(name);
+
+            metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                            "Message %p ingress %3u length %5u received name %s",
+                            (void *) message,
+                            metisMessage_GetIngressConnectionId(message),
+                            metisMessage_Length(message),
+                            nameString);
+
+            parcMemory_Deallocate((void **) &nameString);
+            ccnxName_Release(&name);
+        }
+    }
+}
+
+/**
+ * @function metisMessageProcessor_AcceptInterest
+ * @abstract Counts an in-bound interest and checks its HopLimit
  * @discussion
- *   (0) It must have a HopLimit and pass the hoplimit checks
- *   (1) if interest in the PIT, aggregate in PIT
- *   (2) if interest in the ContentStore, reply
+ *   An interest that fails the check is counted as dropped, but not released.
+ *
+ * @return true if the interest should go on to metisMessageProcessor_LookupInterest()
+ */
+static bool
+metisMessageProcessor_AcceptInterest(MetisMessageProcessor *processor, MetisMessage *interestMessage)
+{
+    metisStats_Increment(processor->stats.countInterestsReceived);
+
+    if (!metisMessageProcessor_CheckAndDecrementHopLimitOnIngress(processor, interestMessage)) {
+        metisMessageProcessor_Drop(processor, interestMessage);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @function metisMessageProcessor_AcceptMessage
+ * @abstract The per-message work of metisMessageProcessor_ReceiveBatch() that does not touch the tables
+ * @discussion
+ *   A message that is dropped is counted, but not released.
+ *
+ * @return true if the message should go on to metisMessageProcessor_LookupMessage()
+ */
+static bool
+metisMessageProcessor_AcceptMessage(MetisMessageProcessor *processor, MetisMessage *message)
+{
+    metisMessageProcessor_CountReceived(processor, message);
+
+    switch (metisMessage_GetType(message)) {
+        case MetisMessagePacketType_Interest:
+            return metisMessageProcessor_AcceptInterest(processor, message);
+
+        case MetisMessagePacketType_ContentObject:
+            metisStats_Increment(processor->stats.countObjectsReceived);
+            return true;
+
+        default:
+            metisMessageProcessor_Drop(processor, message);
+            return false;
+    }
+}
+
+/**
+ * @function metisMessageProcessor_LookupInterest
+ * @abstract Run an accepted interest through the tables
+ * @discussion
+ *   (1) if interest in the ContentStore, reply
+ *   (2) if interest in the PIT, aggregate in PIT
  *   (3) if in the FIB, forward
  *   (4) drop
  *
  * @param <#param1#>
- * @return <#return#>
  */
 static void
-metisMessageProcessor_ReceiveInterest(MetisMessageProcessor *processor, MetisMessage *interestMessage)
+metisMessageProcessor_LookupInterest(MetisMessageProcessor *processor, MetisMessage *interestMessage)
 {
-    processor->stats.countInterestsReceived++;
-
-    if (!metisMessageProcessor_CheckAndDecrementHopLimitOnIngress(processor, interestMessage)) {
-        metisMessageProcessor_Drop(processor, interestMessage);
+    // (1) Try to satisfy from content store.  A hit never touches the PIT.
+    if (_satisfyFromContentStore(processor, interestMessage)) {
+        // done
         return;
     }
 
-    // (1) Try to aggregate in PIT
+    if (metisMessage_HasContentObjectHash(interestMessage)) {
+        processor->pendingObjectHashes++;
+    }
+
+    // (2) Try to aggregate in PIT
     if (metisMessageProcessor_AggregateInterestInPit(processor, interestMessage)) {
         // done
         return;
@@ -597,14 +1000,6 @@ metisMessageProcessor_ReceiveInterest(MetisMessageProcessor *processor, MetisMes
     // At this point, we just created a PIT entry.  If we don't forward the interest, we need
     // to remove the PIT entry.
 
-    // (2) Try to satisfy from content store
-    if (_satisfyFromContentStore(processor, interestMessage)) {
-        // done
-        // If we found a content object in the CS, metisMessageProcess_SatisfyFromContentStore already
-        // cleared the PIT state
-        return;
-    }
-
     // (3) Try to forward it
     if (metisMessageProcessor_ForwardViaFib(processor, interestMessage)) {
         // done
@@ -612,11 +1007,11 @@ metisMessageProcessor_ReceiveInterest(MetisMessageProcessor *processor, MetisMes
     }
 
     // Remove the PIT entry?
-    processor->stats.countDroppedNoRoute++;
+    metisStats_Increment(processor->stats.countDroppedNoRoute);
 
     if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
         metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                        "Message %p did not match FIB, no route (count %u)",
+                        "Message %p did not match FIB, no route (count %" PRIu64 ")",
                         (void *) interestMessage,
                         processor->stats.countDroppedNoRoute);
     }
@@ -625,7 +1020,24 @@ metisMessageProcessor_ReceiveInterest(MetisMessageProcessor *processor, MetisMes
 }
 
 /**
- * @function metisMessageProcessor_ReceiveContentObject
+ * @function metisMessageProcessor_ReceiveInterest
+ * @abstract Receive an interest from the network
+ * @discussion
+ *   (0) It must have a HopLimit and pass the hoplimit checks
+ *   (1) - (4) as in metisMessageProcessor_LookupInterest()
+ *
+ * @param <#param1#>
+ */
+static void
+metisMessageProcessor_ReceiveInterest(MetisMessageProcessor *processor, MetisMessage *interestMessage)
+{
+    if (metisMessageProcessor_AcceptInterest(processor, interestMessage)) {
+        metisMessageProcessor_LookupInterest(processor, interestMessage);
+    }
+}
+
+/**
+ * @function metisMessageProcessor_LookupContentObject
  * @abstract Process an in-bound content object
  * @discussion
  *   (1) If it does not match anything in the PIT, drop it
@@ -635,19 +1047,21 @@ metisMessageProcessor_ReceiveInterest(MetisMessageProcessor *processor, MetisMes
  * @param <#param1#>
  */
 static void
-metisMessageProcessor_ReceiveContentObject(MetisMessageProcessor *processor, MetisMessage *message)
+metisMessageProcessor_LookupContentObject(MetisMessageProcessor *processor, MetisMessage *message)
 {
-    processor->stats.countObjectsReceived++;
-
-    MetisNumberSet *ingressSetUnion = metisPIT_SatisfyInterest(processor->pit, message);
+    MetisNumberSet ingressSetUnion;
+    metisNumberSet_Initialize(&ingressSetUnion);
+    uint64_t latencyStart = metisLatency_Start();
+    metisPIT_SatisfyInterest(processor->pit, message, &ingressSetUnion);
+    metisLatency_Stop(MetisLatencyStage_Pit, latencyStart);
 
-    if (metisNumberSet_Length(ingressSetUnion) == 0) {
+    if (metisNumberSet_Length(&ingressSetUnion) == 0) {
         // (1) If it does not match anything in the PIT, drop it
-        processor->stats.countDroppedNoReversePath++;
+        metisStats_Increment(processor->stats.countDroppedNoReversePath);
 
         if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
             metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                            "Message %p did not match PIT, no reverse path (count %u)",
+                            "Message %p did not match PIT, no reverse path (count %" PRIu64 ")",
                             (void *) message,
                             processor->stats.countDroppedNoReversePath);
         }
@@ -656,13 +1070,42 @@ metisMessageProcessor_ReceiveContentObject(MetisMessageProcessor *processor, Met
     } else {
         // (2) Add to Content Store. Store may remove expired content, if necessary, depending on store policy.
         uint64_t currentTimeTicks = metisForwarder_GetTicks(processor->metis);
+        latencyStart = metisLatency_Start();
         metisContentStoreInterface_PutContent(processor->contentStore, message, currentTimeTicks);
+        metisLatency_Stop(MetisLatencyStage_ContentStore, latencyStart);
 
         // (3) Reverse path forward via PIT entries
-        metisMessageProcessor_ForwardToNexthops(processor, message, ingressSetUnion);
+        metisMessageProcessor_ForwardToNexthops(processor, message, &ingressSetUnion);
     }
 
-    metisNumberSet_Release(&ingressSetUnion);
+    metisNumberSet_Finalize(&ingressSetUnion);
+}
+
+static void
+metisMessageProcessor_ReceiveContentObject(MetisMessageProcessor *processor, MetisMessage *message)
+{
+    metisStats_Increment(processor->stats.countObjectsReceived);
+    metisMessageProcessor_LookupContentObject(processor, message);
+}
+
+/**
+ * The table stage for a message that passed metisMessageProcessor_AcceptMessage()
+ */
+static void
+metisMessageProcessor_LookupMessage(MetisMessageProcessor *processor, MetisMessage *message)
+{
+    switch (metisMessage_GetType(message)) {
+        case MetisMessagePacketType_Interest:
+            metisMessageProcessor_LookupInterest(processor, message);
+            break;
+
+        case MetisMessagePacketType_ContentObject:
+            metisMessageProcessor_LookupContentObject(processor, message);
+            break;
+
+        default:
+            trapUnexpectedState("Message %p of type %d should not have been accepted", (void *) message, metisMessage_GetType(message));
+    }
 }
 
 /**
@@ -698,15 +1141,22 @@ metisMessageProcessor_ForwardToNexthops(MetisMessageProcessor *processor, MetisM
 static void
 metisMessageProcessor_SendWithGoodHopLimit(MetisMessageProcessor *processor, MetisMessage *message, unsigned interfaceId, const MetisConnection *conn)
 {
-    bool success = metisConnection_Send(conn, message);
+    bool success;
+    if (conn == NULL) {
+        // a shard hands the message to the I/O thread, which owns the connection
+        success = processor->egress.send(processor->egress.context, message, interfaceId);
+    } else {
+        success = metisConnection_Send(conn, message);
+    }
+
     if (success) {
         switch (metisMessage_GetType(message)) {
             case MetisMessagePacketType_Interest:
-                processor->stats.countInterestForwarded++;
+                metisStats_Increment(processor->stats.countInterestForwarded);
                 break;
 
             case MetisMessagePacketType_ContentObject:
-                processor->stats.countObjectsForwarded++;
+                metisStats_Increment(processor->stats.countObjectsForwarded);
                 break;
 
             default:
@@ -715,18 +1165,18 @@ metisMessageProcessor_SendWithGoodHopLimit(MetisMessageProcessor *processor, Met
 
         if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
             metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                            "forward message %p to interface %u (int %u, obj %u)",
+                            "forward message %p to interface %u (int %" PRIu64 ", obj %" PRIu64 ")",
                             (void *) message,
                             interfaceId,
                             processor->stats.countInterestForwarded,
                             processor->stats.countObjectsForwarded);
         }
     } else {
-        processor->stats.countSendFailures++;
+        metisStats_Increment(processor->stats.countSendFailures);
 
         if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
             metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                            "forward message %p to interface %u send failure (count %u)",
+                            "forward message %p to interface %u send failure (count %" PRIu64 ")",
                             (void *) message,
                             interfaceId,
                             processor->stats.countSendFailures);
@@ -743,6 +1193,12 @@ metisMessageProcessor_SendWithGoodHopLimit(MetisMessageProcessor *processor, Met
 static void
 metisMessageProcessor_ForwardToInterfaceId(MetisMessageProcessor *processor, MetisMessage *message, unsigned interfaceId)
 {
+    if (processor->egress.send != NULL) {
+        // the egress connection's hop limit check is done by the I/O thread
+        metisMessageProcessor_SendWithGoodHopLimit(processor, message, interfaceId, NULL);
+        return;
+    }
+
     MetisConnectionTable *connectionTable = metisForwarder_GetConnectionTable(processor->metis);
     const MetisConnection *conn = metisConnectionTable_FindById(connectionTable, interfaceId);
 
@@ -758,22 +1214,22 @@ metisMessageProcessor_ForwardToInterfaceId(MetisMessageProcessor *processor, Met
             metisMessageProcessor_SendWithGoodHopLimit(processor, message, interfaceId, conn);
         } else {
             // To reach here, the message has to have a hop limit, it has to be 0 and and going to a remote target
-            processor->stats.countDroppedZeroHopLimitToRemote++;
+            metisStats_Increment(processor->stats.countDroppedZeroHopLimitToRemote);
 
             if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
                 metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                                "forward message %p to interface %u hop limit 0 and not local (count %u)",
+                                "forward message %p to interface %u hop limit 0 and not local (count %" PRIu64 ")",
                                 (void *) message,
                                 interfaceId,
                                 processor->stats.countDroppedZeroHopLimitToRemote);
             }
         }
     } else {
-        processor->stats.countDroppedConnectionNotFound++;
+        metisStats_Increment(processor->stats.countDroppedConnectionNotFound);
 
         if (metisLogger_IsLoggable(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
             metisLogger_Log(processor->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
-                            "forward message %p to interface %u not found (count %u)",
+                            "forward message %p to interface %u not found (count %" PRIu64 ")",
                             (void *) message,
                             interfaceId,
                             processor->stats.countDroppedConnectionNotFound);
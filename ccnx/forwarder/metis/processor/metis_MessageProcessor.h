@@ -70,12 +70,30 @@
 #include <ccnx/api/control/cpi_RouteEntry.h>
 #include <ccnx/forwarder/metis/core/metis_Forwarder.h>
 #include <ccnx/forwarder/metis/core/metis_Message.h>
+#include <ccnx/forwarder/metis/core/metis_Stats.h>
 #include <ccnx/forwarder/metis/processor/metis_Tap.h>
+#include <ccnx/forwarder/metis/processor/metis_FIB.h>
 #include <ccnx/forwarder/metis/content_store/metis_ContentStoreInterface.h>
 
 struct metis_message_processor;
 typedef struct metis_message_processor MetisMessageProcessor;
 
+/**
+ * @typedef MetisProcessorEgress
+ * @abstract How a processor on a worker thread reaches the connections
+ * @discussion
+ *   The connection table belongs to the I/O thread, so a processor shard running on its own
+ *   thread never looks up a connection itself.  `isIngressLocal` answers metisConnection_IsLocal()
+ *   for the message's ingress connection.  `send` takes its own reference to the message and queues
+ *   it for the egress connection; the hop limit check against the egress connection is then done
+ *   by the I/O thread.  `send` returns false if the message could not be queued.
+ */
+typedef struct metis_processor_egress {
+    void *context;
+    bool (*isIngressLocal)(void *context, const MetisMessage *message);
+    bool (*send)(void *context, MetisMessage *message, unsigned connectionId);
+} MetisProcessorEgress;
+
 /**
  * Allocates a MessageProcessor along with PIT, FIB and ContentStore tables
  *
@@ -94,6 +112,33 @@ typedef struct metis_message_processor MetisMessageProcessor;
  */
 MetisMessageProcessor *metisMessageProcessor_Create(MetisForwarder *metis);
 
+/**
+ * Allocates one shard of a MessageProcessor that is split over several threads
+ *
+ * The shard owns its own PIT, FIB and ContentStore.  Its PIT timers run on `dispatcher`, which must be
+ * the dispatcher of the thread that calls metisMessageProcessor_Receive() on the shard.  The content
+ * store sizes in the configuration are divided among `shardCount` shards, the low shards taking the
+ * remainder so the shards together hold the configured limit, and a disk store gets a sub-directory
+ * per shard.
+ *
+ * @param [in] metis Pointer to owning Metis process
+ * @param [in] dispatcher The dispatcher of the shard's thread
+ * @param [in] egress How the shard sends messages, copied
+ * @param [in] shard This shard's index, from 0 to shardCount - 1
+ * @param [in] shardCount The number of shards
+ *
+ * @retval non-null An allocated message processor
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisMessageProcessor *shard = metisMessageProcessor_CreateShard(metis, workerDispatcher, &egress, 0, 4);
+ *     metisMessageProcessor_Destroy(&shard);
+ * }
+ * @endcode
+ */
+MetisMessageProcessor *metisMessageProcessor_CreateShard(MetisForwarder *metis, MetisDispatcher *dispatcher, const MetisProcessorEgress *egress, unsigned shard, unsigned shardCount);
+
 /**
  * Deallocates a message processor an all internal tables
  *
@@ -122,6 +167,27 @@ void metisMessageProcessor_Destroy(MetisMessageProcessor **processorPtr);
  */
 void metisMessageProcessor_Receive(MetisMessageProcessor *procesor, MetisMessage *message);
 
+/**
+ * @function metisMessageProcessor_ReceiveBatch
+ * @abstract Process several messages, takes ownership of each of them.
+ * @discussion
+ *   The same as calling metisMessageProcessor_Receive() on each message in order, except that each
+ *   stage runs over the whole batch.  First every message gets its counters, tap, hop limit check
+ *   and name hash.  Then the messages that survive go through the ContentStore, PIT and FIB in
+ *   order, with the PIT bucket of a message a few places ahead prefetched while the current one is
+ *   looked up.  A listener that reads several packets per system call should hand them over this way.
+ *
+ *   While interests with a ContentObjectHash restriction are outstanding, the content objects of a
+ *   batch are hashed together (see metisMessage_ComputeContentObjectHashes()) before the PIT stage.
+ *
+ *   The array itself still belongs to the caller, but its contents are undefined afterwards.
+ *
+ * @param processor An allocated message processor
+ * @param count The number of messages in the array
+ * @param messages The messages, in the order they were received
+ */
+void metisMessageProcessor_ReceiveBatch(MetisMessageProcessor *processor, size_t count, MetisMessage *messages[]);
+
 /**
  * @function metisMessageProcessor_AddTap
  * @abstract Add a tap to see messages.  Only one allowed. caller must remove and free it.
@@ -217,10 +283,31 @@ void metisMessageProcessor_RemoveConnectionIdFromRoutes(MetisMessageProcessor *p
  */
 MetisFibEntryList *metisMessageProcessor_GetFibEntries(MetisMessageProcessor *processor);
 
+/**
+ * Adds the processor's counters, and its content store's, in to `stats`
+ *
+ * The counters are written by the thread running the processor.  This may be called from any
+ * thread, each counter is read atomically but the snapshot as a whole is not.
+ *
+ * @param [in] processor An allocated MetisMessageProcessor
+ * @param [in] stats The snapshot to add to
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisStats stats;
+ *     metisStats_Init(&stats);
+ *     metisMessageProcessor_AccumulateStats(processor, &stats);
+ * }
+ * @endcode
+ */
+void metisMessageProcessor_AccumulateStats(MetisMessageProcessor *processor, MetisStats *stats);
+
 /**
  * Adjusts the ContentStore to the given size.
  *
- * This will destroy and re-create the content store, so any cached objects will be lost.
+ * Cached objects are kept.  If the store is now over its limits, the least recently used objects
+ * are evicted from the event loop in small batches rather than all at once.
  *
  * @param [<#in out in,out#>] <#name#> <#description#>
  *
@@ -231,6 +318,81 @@ MetisFibEntryList *metisMessageProcessor_GetFibEntries(MetisMessageProcessor *pr
  */
 void metisMessageProcessor_SetContentObjectStoreSize(MetisMessageProcessor *processor, size_t maximumContentStoreSize);
 
+/**
+ * Limits the ContentStore to the given number of bytes of content objects.
+ *
+ * The byte limit applies in addition to the object count limit.  0 removes the byte limit.
+ * As with metisMessageProcessor_SetContentObjectStoreSize(), cached objects are kept and any excess
+ * is trimmed in batches from the event loop.
+ *
+ * @param [in] processor An allocated MetisMessageProcessor
+ * @param [in] maximumContentStoreBytes The most bytes (by metisMessage_Length) to cache, or 0
+ *
+ * Example:
+ * @code
+ * {
+ *     // cache at most 512 MB of content objects
+ *     metisMessageProcessor_SetContentObjectStoreBytes(processor, 512 * 1024 * 1024);
+ * }
+ * @endcode
+ */
+void metisMessageProcessor_SetContentObjectStoreBytes(MetisMessageProcessor *processor, size_t maximumContentStoreBytes);
+
+/**
+ * Puts a persistent disk content store behind the in-memory ContentStore
+ *
+ * Objects evicted from memory are demoted to segment files in `directory` and promoted back on a hit.
+ * Segments already in the directory are recovered, so a restarted forwarder starts with a warm cache.
+ * The in-memory store is re-created; its objects are first demoted to the previous disk store, if any.
+ *
+ * @param [in] processor An allocated MetisMessageProcessor
+ * @param [in] directory The segment directory, or NULL to remove the disk store
+ * @param [in] maximumDiskBytes The disk budget, 0 for METIS_DISK_CONTENT_STORE_DEFAULT_BYTES
+ *
+ * Example:
+ * @code
+ * {
+ *     metisMessageProcessor_SetContentObjectStoreDisk(processor, "/var/cache/metis", 4ULL * 1024 * 1024 * 1024);
+ * }
+ * @endcode
+ */
+void metisMessageProcessor_SetContentObjectStoreDisk(MetisMessageProcessor *processor, const char *directory, size_t maximumDiskBytes);
+
+/**
+ * Replaces the in-memory ContentStore with an empty store of the given policy
+ *
+ * The limits and the disk store are kept.  The old store's objects are demoted to the disk store,
+ * if there is one, and promoted back on a hit; without a disk store they are dropped.
+ *
+ * @param [in] processor An allocated MetisMessageProcessor
+ * @param [in] contentStoreType The content store policy to use
+ *
+ * Example:
+ * @code
+ * {
+ *     metisMessageProcessor_SetContentStoreType(processor, MetisContentStoreType_TinyLFU);
+ * }
+ * @endcode
+ */
+void metisMessageProcessor_SetContentStoreType(MetisMessageProcessor *processor, MetisContentStoreType contentStoreType);
+
+/**
+ * Replaces the FIB with an empty FIB of the given type.
+ *
+ * The FIB must be empty, so this is only useful before any routes are added.
+ *
+ * @param [in] processor An allocated MetisMessageProcessor
+ * @param [in] fibType The FIB implementation to use
+ *
+ * Example:
+ * @code
+ * {
+ *     metisMessageProcessor_SetFIBType(processor, MetisFIBType_Trie);
+ * }
+ * @endcode
+ */
+void metisMessageProcessor_SetFIBType(MetisMessageProcessor *processor, MetisFIBType fibType);
+
 /**
  * Return the interface to the currently instantiated ContentStore, if any.
  *
@@ -83,10 +83,10 @@ metisPIT_ReceiveInterest(MetisPIT *pit, MetisMessage *interestMessage)
     return pit->receiveInterest(pit, interestMessage);
 }
 
-MetisNumberSet *
-metisPIT_SatisfyInterest(MetisPIT *pit, const MetisMessage *objectMessage)
+void
+metisPIT_SatisfyInterest(MetisPIT *pit, const MetisMessage *objectMessage, MetisNumberSet *ingressSetUnion)
 {
-    return pit->satisfyInterest(pit, objectMessage);
+    pit->satisfyInterest(pit, objectMessage, ingressSetUnion);
 }
 
 void
@@ -100,3 +100,11 @@ metisPIT_GetPitEntry(const MetisPIT *pit, const MetisMessage *interestMessage)
 {
     return pit->getPitEntry(pit, interestMessage);
 }
+
+void
+metisPIT_Prefetch(const MetisPIT *pit, const MetisMessage *message)
+{
+    if (pit->prefetch != NULL) {
+        pit->prefetch(pit, message);
+    }
+}
@@ -77,9 +77,12 @@ typedef struct metis_pit MetisPIT;
 struct metis_pit {
     void (*release)(MetisPIT **pitPtr);
     MetisPITVerdict (*receiveInterest)(MetisPIT *pit, MetisMessage *interestMessage);
-    MetisNumberSet * (*satisfyInterest)(MetisPIT *pit, const MetisMessage *objectMessage);
+    void (*satisfyInterest)(MetisPIT *pit, const MetisMessage *objectMessage, MetisNumberSet *ingressSetUnion);
     void (*removeInterest)(MetisPIT *pit, const MetisMessage *interestMessage);
     MetisPitEntry * (*getPitEntry)(const MetisPIT *pit, const MetisMessage *interestMessage);
+
+    // optional, may be NULL
+    void (*prefetch)(const MetisPIT *pit, const MetisMessage *message);
     void *closure;
 };
 
@@ -121,15 +124,16 @@ MetisPITVerdict metisPIT_ReceiveInterest(MetisPIT *pit, MetisMessage *interestMe
  * @function metisPit_SatisfyInterest
  * @abstract Tries to satisfy PIT entries based on the message, returning where to send message
  * @discussion
- *     If matching interests are in the PIT, will return the set of reverse paths to use
- *     to forward the content object.
+ *     If matching interests are in the PIT, will add the reverse paths to use
+ *     to forward the content object to ingressSetUnion.
  *
- *     The return value is allocated and must be destroyed.
+ *     The caller owns the set, usually a temporary from metisNumberSet_Initialize() so
+ *     that satisfying an interest does not allocate.
  *
  * @param <#param1#>
- * @return Set of ConnectionTable id's to forward the message, may be empty or NULL.  Must be destroyed.
+ * @param ingressSetUnion Receives the ConnectionTable id's to forward the message, unchanged if nothing matched.
  */
-MetisNumberSet *metisPIT_SatisfyInterest(MetisPIT *pit, const MetisMessage *objectMessage);
+void metisPIT_SatisfyInterest(MetisPIT *pit, const MetisMessage *objectMessage, MetisNumberSet *ingressSetUnion);
 
 /**
  * @function metisPit_RemoveInterest
@@ -157,4 +161,17 @@ void metisPIT_RemoveInterest(MetisPIT *pit, const MetisMessage *interestMessage)
  * @return NULL if not in table, otherwise a reference counted copy of the entry
  */
 MetisPitEntry *metisPIT_GetPitEntry(const MetisPIT *pit, const MetisMessage *interestMessage);
+
+/**
+ * @function metisPIT_Prefetch
+ * @abstract Hints that the message will be looked up soon
+ * @discussion
+ *   Batch processing calls this for a message a few packets ahead, so the PIT can start loading
+ *   the memory the lookup will touch.  It does not change the PIT.  A PIT that does not
+ *   implement it ignores the hint.
+ *
+ * @param pit The PIT the message will be looked up in
+ * @param message An interest or content object
+ */
+void metisPIT_Prefetch(const MetisPIT *pit, const MetisMessage *message);
 #endif // Metis_metis_PIT_h
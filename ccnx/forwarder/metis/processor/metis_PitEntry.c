@@ -63,31 +63,35 @@
 #include <parc/algol/parc_Memory.h>
 #include <ccnx/forwarder/metis/processor/metis_PitEntry.h>
 #include <ccnx/forwarder/metis/core/metis_NumberSet.h>
+#include <ccnx/forwarder/metis/core/metis_Slab.h>
 
 #include <LongBow/runtime.h>
 
 struct metis_pit_entry {
     MetisMessage *message;
-    MetisNumberSet *ingressIdSet;
-    MetisNumberSet *egressIdSet;
+    // embedded, so a new entry with a few faces does not allocate for them
+    MetisNumberSet ingressIdSet;
+    MetisNumberSet egressIdSet;
 
     MetisTicks expiryTime;
 
+    // The PIT's expiry timer, not owned by the entry
+    MetisTimerWheelTimer *expiryTimer;
+
     unsigned refcount;
 };
 
 MetisPitEntry *
 metisPitEntry_Create(MetisMessage *message, MetisTicks expiryTime)
 {
-    MetisPitEntry *pitEntry = parcMemory_AllocateAndClear(sizeof(MetisPitEntry));
-    assertNotNull(pitEntry, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisPitEntry));
+    MetisPitEntry *pitEntry = metisSlab_AllocateAndClear(sizeof(MetisPitEntry));
     pitEntry->message = message;
-    pitEntry->ingressIdSet = metisNumberSet_Create();
-    pitEntry->egressIdSet = metisNumberSet_Create();
+    metisNumberSet_Initialize(&pitEntry->ingressIdSet);
+    metisNumberSet_Initialize(&pitEntry->egressIdSet);
     pitEntry->refcount = 1;
 
     // add the message to the reverse path set
-    metisNumberSet_Add(pitEntry->ingressIdSet, metisMessage_GetIngressConnectionId(message));
+    metisNumberSet_Add(&pitEntry->ingressIdSet, metisMessage_GetIngressConnectionId(message));
 
     // hack in a 4-second timeout
     pitEntry->expiryTime = expiryTime;
@@ -105,10 +109,10 @@ metisPitEntry_Release(MetisPitEntry **pitEntryPtr)
 
     pitEntry->refcount--;
     if (pitEntry->refcount == 0) {
-        metisNumberSet_Release(&pitEntry->ingressIdSet);
-        metisNumberSet_Release(&pitEntry->egressIdSet);
+        metisNumberSet_Finalize(&pitEntry->ingressIdSet);
+        metisNumberSet_Finalize(&pitEntry->egressIdSet);
         metisMessage_Release(&pitEntry->message);
-        parcMemory_Deallocate((void **) &pitEntry);
+        metisSlab_Deallocate((void **) &pitEntry, sizeof(MetisPitEntry));
     }
     *pitEntryPtr = NULL;
 }
@@ -125,14 +129,14 @@ void
 metisPitEntry_AddIngressId(MetisPitEntry *pitEntry, unsigned ingressId)
 {
     assertNotNull(pitEntry, "Parameter pitEntry must be non-null");
-    metisNumberSet_Add(pitEntry->ingressIdSet, ingressId);
+    metisNumberSet_Add(&pitEntry->ingressIdSet, ingressId);
 }
 
 void
 metisPitEntry_AddEgressId(MetisPitEntry *pitEntry, unsigned egressId)
 {
     assertNotNull(pitEntry, "Parameter pitEntry must be non-null");
-    metisNumberSet_Add(pitEntry->egressIdSet, egressId);
+    metisNumberSet_Add(&pitEntry->egressIdSet, egressId);
 }
 
 MetisTicks
@@ -149,19 +153,32 @@ metisPitEntry_SetExpiryTime(MetisPitEntry *pitEntry, MetisTicks expiryTime)
     pitEntry->expiryTime = expiryTime;
 }
 
+void
+metisPitEntry_SetExpiryTimer(MetisPitEntry *pitEntry, MetisTimerWheelTimer *timer)
+{
+    assertNotNull(pitEntry, "Parameter pitEntry must be non-null");
+    pitEntry->expiryTimer = timer;
+}
+
+MetisTimerWheelTimer *
+metisPitEntry_GetExpiryTimer(const MetisPitEntry *pitEntry)
+{
+    assertNotNull(pitEntry, "Parameter pitEntry must be non-null");
+    return pitEntry->expiryTimer;
+}
 
 const MetisNumberSet *
 metisPitEntry_GetIngressSet(const MetisPitEntry *pitEntry)
 {
     assertNotNull(pitEntry, "Parameter pitEntry must be non-null");
-    return pitEntry->ingressIdSet;
+    return &pitEntry->ingressIdSet;
 }
 
 const MetisNumberSet *
 metisPitEntry_GetEgressSet(const MetisPitEntry *pitEntry)
 {
     assertNotNull(pitEntry, "Parameter pitEntry must be non-null");
-    return pitEntry->egressIdSet;
+    return &pitEntry->egressIdSet;
 }
 
 MetisMessage *
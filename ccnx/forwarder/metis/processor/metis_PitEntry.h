@@ -68,6 +68,7 @@
 #include <ccnx/forwarder/metis/core/metis_Ticks.h>
 #include <ccnx/forwarder/metis/core/metis_Message.h>
 #include <ccnx/forwarder/metis/core/metis_NumberSet.h>
+#include <ccnx/forwarder/metis/core/metis_TimerWheel.h>
 
 struct metis_pit_entry;
 typedef struct metis_pit_entry MetisPitEntry;
@@ -146,11 +147,11 @@ void  metisPitEntry_AddEgressId(MetisPitEntry *pitEntry, unsigned egressId);
  * @function metisPitEntry_GetIngressSet
  * @abstract The Ingress connection id set
  * @discussion
- *   You must acquire a copy of the number set if you will store the result.  This is
- *   the internal reference.
+ *   This is the internal set, embedded in the entry, so it cannot be acquired.  Copy it
+ *   with metisNumberSet_AddSet() if you will store the result.
  *
  * @param <#param1#>
- * @return May be empty, will not be null.  Must be destroyed.
+ * @return May be empty, will not be null.  Valid as long as the entry.
  */
 const MetisNumberSet *metisPitEntry_GetIngressSet(const MetisPitEntry *pitEntry);
 
@@ -158,11 +159,11 @@ const MetisNumberSet *metisPitEntry_GetIngressSet(const MetisPitEntry *pitEntry)
  * @function metisPitEntry_GetEgressSet
  * @abstract The Egress connection id set
  * @discussion
- *   You must acquire a copy of the number set if you will store the result.  This is
- *   the internal reference.
+ *   This is the internal set, embedded in the entry, so it cannot be acquired.  Copy it
+ *   with metisNumberSet_AddSet() if you will store the result.
  *
  * @param <#param1#>
- * @return May be empty, will not be null.  Must be destroyed.
+ * @return May be empty, will not be null.  Valid as long as the entry.
  */
 const MetisNumberSet *metisPitEntry_GetEgressSet(const MetisPitEntry *pitEntry);
 
@@ -210,4 +211,38 @@ MetisTicks metisPitEntry_GetExpiryTime(const MetisPitEntry *pitEntry);
  */
 void metisPitEntry_SetExpiryTime(MetisPitEntry *pitEntry, MetisTicks expiryTime);
 
+/**
+ * Stores the PIT's expiry timer for this entry
+ *
+ * The PIT entry does not own the timer.  The PIT must cancel it before it removes the entry.
+ *
+ * @param [in] pitEntry The allocated PIT entry to modify
+ * @param [in] timer The timer handle, or NULL if there is none
+ *
+ * Example:
+ * @code
+ * {
+ *     metisPitEntry_SetExpiryTimer(pitEntry, metisTimerWheel_Schedule(wheel, expiryTime, pitEntry));
+ * }
+ * @endcode
+ */
+void metisPitEntry_SetExpiryTimer(MetisPitEntry *pitEntry, MetisTimerWheelTimer *timer);
+
+/**
+ * Returns the timer set by metisPitEntry_SetExpiryTimer
+ *
+ * @param [in] pitEntry An allocated PIT entry
+ *
+ * @retval non-null The timer handle
+ * @retval null There is no timer
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisTimerWheelTimer *timer = metisPitEntry_GetExpiryTimer(pitEntry);
+ * }
+ * @endcode
+ */
+MetisTimerWheelTimer *metisPitEntry_GetExpiryTimer(const MetisPitEntry *pitEntry);
+
 #endif // Metis_metis_PitEntry_h
@@ -0,0 +1,579 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * Threads and ownership:
+ * - The I/O thread runs the forwarder's dispatcher.  It is the only producer on every inbound mailbox
+ *   and the only consumer of every outbound mailbox, and it is the only thread that touches connections.
+ * - Worker `i` runs its own dispatcher, which holds its PIT expiry timer and the event of its
+ *   inbound mailbox.  It is the only thread that touches shard `i` while the workers are running.
+ * - A message may be referenced from both sides at once (e.g. it is in a shard's ContentStore and
+ *   queued for sending), which is why metisMessage_Acquire and metisMessage_Release are atomic.
+ *
+ * Wakeups: each direction is a MetisMailbox, so a busy producer does not write the pipe per message.
+ *
+ * Pausing: a configuration call sets `pauseRequested` and wakes every worker.  Each worker parks in
+ * its inbound callback until the I/O thread is done with the shards.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+
+#include <ccnx/forwarder/metis/processor/metis_ShardedProcessor.h>
+#include <ccnx/forwarder/metis/core/metis_Mailbox.h>
+#include <ccnx/forwarder/metis/core/metis_Connection.h>
+#include <ccnx/forwarder/metis/core/metis_Stats.h>
+#include <ccnx/forwarder/metis/core/metis_CacheLine.h>
+
+#include <parc/algol/parc_Memory.h>
+#include <LongBow/runtime.h>
+
+// The messages that may be queued between the I/O thread and one worker, in each direction
+#define METIS_SHARDED_PROCESSOR_RING_SIZE 4096
+
+// The most messages a callback handles before letting its dispatcher run other events
+#define METIS_SHARDED_PROCESSOR_BATCH 256
+
+typedef struct metis_shard_worker {
+    MetisShardedProcessor *sharded;
+    unsigned index;
+
+    pthread_t thread;
+    MetisDispatcher *dispatcher;
+    MetisMessageProcessor *processor;
+
+    // I/O thread to worker, the value is true if the ingress connection is local
+    MetisMailbox *inbound;
+
+    // worker to I/O thread, the value is the egress connection id
+    MetisMailbox *outbound;
+
+    // the ingress locality of the message the worker is processing
+    bool currentIngressLocal;
+
+    // Written only by the worker, read by metisShardedProcessor_AccumulateStats()
+    uint8_t workerStatsPad[METIS_CACHE_LINE_SIZE];
+    uint64_t countOutboundFull;
+
+    // Written only by the I/O thread, read by metisShardedProcessor_AccumulateStats()
+    uint8_t ioStatsPad[METIS_CACHE_LINE_SIZE];
+    uint64_t countInboundFull;
+    uint64_t countDroppedConnectionNotFound;
+    uint64_t countDroppedZeroHopLimitToRemote;
+    uint64_t countSendFailures;
+    uint8_t ioStatsPadAfter[METIS_CACHE_LINE_SIZE];
+} _MetisShardWorker;
+
+struct metis_sharded_processor {
+    MetisForwarder *metis;
+    MetisLogger *logger;
+
+    unsigned shardCount;
+    _MetisShardWorker *workers;
+
+    pthread_mutex_t lock;
+    pthread_cond_t parkedCondition;
+    pthread_cond_t resumeCondition;
+    unsigned parkedCount;
+    bool pauseRequested;
+    bool stopRequested;
+};
+
+/**
+ * Releases any messages left in the mailbox.  Only call once neither side is running.
+ */
+static void
+_metisShardedProcessor_DestroyMailbox(MetisMailbox **mailboxPtr)
+{
+    MetisMessage *message;
+    while ((message = metisMailbox_Take(*mailboxPtr, NULL)) != NULL) {
+        metisMessage_Release(&message);
+    }
+    metisMailbox_Destroy(mailboxPtr);
+}
+
+// ============================================================
+// Worker thread
+
+static bool
+_metisShardedProcessor_EgressIsIngressLocal(void *context, const MetisMessage *message)
+{
+    _MetisShardWorker *worker = (_MetisShardWorker *) context;
+    return worker->currentIngressLocal;
+}
+
+static bool
+_metisShardedProcessor_EgressSend(void *context, MetisMessage *message, unsigned connectionId)
+{
+    _MetisShardWorker *worker = (_MetisShardWorker *) context;
+
+    if (!metisMailbox_Post(worker->outbound, metisMessage_Acquire(message), connectionId)) {
+        metisStats_Increment(worker->countOutboundFull);
+        metisMessage_Release(&message);
+        return false;
+    }
+    return true;
+}
+
+static void
+_metisShardedProcessor_Park(_MetisShardWorker *worker)
+{
+    MetisShardedProcessor *sharded = worker->sharded;
+
+    pthread_mutex_lock(&sharded->lock);
+    sharded->parkedCount++;
+    pthread_cond_signal(&sharded->parkedCondition);
+    while (sharded->pauseRequested) {
+        pthread_cond_wait(&sharded->resumeCondition, &sharded->lock);
+    }
+    sharded->parkedCount--;
+    pthread_mutex_unlock(&sharded->lock);
+}
+
+static void
+_metisShardedProcessor_InboundCallback(int fd, PARCEventType which_event, void *user_data)
+{
+    _MetisShardWorker *worker = (_MetisShardWorker *) user_data;
+    MetisShardedProcessor *sharded = worker->sharded;
+
+    metisMailbox_Acknowledge(worker->inbound);
+
+    if (__atomic_load_n(&sharded->stopRequested, __ATOMIC_ACQUIRE)) {
+        metisDispatcher_Stop(worker->dispatcher);
+        return;
+    }
+
+    if (__atomic_load_n(&sharded->pauseRequested, __ATOMIC_ACQUIRE)) {
+        _metisShardedProcessor_Park(worker);
+    }
+
+    metisForwarder_BeginTickCache(sharded->metis);
+
+    for (unsigned i = 0; i < METIS_SHARDED_PROCESSOR_BATCH; i++) {
+        unsigned ingressLocal;
+        MetisMessage *message = metisMailbox_Take(worker->inbound, &ingressLocal);
+        if (message == NULL) {
+            break;
+        }
+
+        worker->currentIngressLocal = (ingressLocal != 0);
+        metisMessageProcessor_Receive(worker->processor, message);
+    }
+
+    metisForwarder_EndTickCache(sharded->metis);
+
+    metisMailbox_Rearm(worker->inbound);
+}
+
+static void *
+_metisShardedProcessor_WorkerRun(void *arg)
+{
+    _MetisShardWorker *worker = (_MetisShardWorker *) arg;
+
+    // signals are handled by the I/O thread's dispatcher
+    sigset_t blocked;
+    sigfillset(&blocked);
+    pthread_sigmask(SIG_BLOCK, &blocked, NULL);
+
+    metisDispatcher_Run(worker->dispatcher);
+    return NULL;
+}
+
+// ============================================================
+// I/O thread
+
+/**
+ * The same egress checks as metisMessageProcessor_ForwardToInterfaceId, made where the connection lives
+ */
+static void
+_metisShardedProcessor_SendOnConnection(_MetisShardWorker *worker, MetisMessage *message, unsigned connectionId)
+{
+    MetisConnectionTable *connectionTable = metisForwarder_GetConnectionTable(worker->sharded->metis);
+    const MetisConnection *conn = metisConnectionTable_FindById(connectionTable, connectionId);
+
+    if (conn == NULL) {
+        metisStats_Increment(worker->countDroppedConnectionNotFound);
+    } else if ((!metisMessage_HasHopLimit(message)) || (metisMessage_GetHopLimit(message) > 0) || metisConnection_IsLocal(conn)) {
+        if (!metisConnection_Send(conn, message)) {
+            metisStats_Increment(worker->countSendFailures);
+        }
+    } else {
+        metisStats_Increment(worker->countDroppedZeroHopLimitToRemote);
+    }
+}
+
+static void
+_metisShardedProcessor_OutboundCallback(int fd, PARCEventType which_event, void *user_data)
+{
+    _MetisShardWorker *worker = (_MetisShardWorker *) user_data;
+
+    metisMailbox_Acknowledge(worker->outbound);
+
+    for (unsigned i = 0; i < METIS_SHARDED_PROCESSOR_BATCH; i++) {
+        unsigned connectionId;
+        MetisMessage *message = metisMailbox_Take(worker->outbound, &connectionId);
+        if (message == NULL) {
+            break;
+        }
+
+        _metisShardedProcessor_SendOnConnection(worker, message, connectionId);
+        metisMessage_Release(&message);
+    }
+
+    metisMailbox_Rearm(worker->outbound);
+}
+
+static void
+_metisShardedProcessor_Enqueue(MetisShardedProcessor *sharded, unsigned shard, MetisMessage *message)
+{
+    _MetisShardWorker *worker = &sharded->workers[shard];
+
+    MetisConnectionTable *connectionTable = metisForwarder_GetConnectionTable(sharded->metis);
+    const MetisConnection *ingress = metisConnectionTable_FindById(connectionTable, metisMessage_GetIngressConnectionId(message));
+    unsigned ingressLocal = (ingress != NULL && metisConnection_IsLocal(ingress)) ? 1 : 0;
+
+    if (!metisMailbox_Post(worker->inbound, message, ingressLocal)) {
+        metisStats_Increment(worker->countInboundFull);
+
+        if (metisLogger_IsLoggable(sharded->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+            metisLogger_Log(sharded->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                            "Message %p dropped, shard %u queue full (count %" PRIu64 ")",
+                            (void *) message, shard, worker->countInboundFull);
+        }
+
+        metisMessage_Release(&message);
+    }
+}
+
+static unsigned
+_metisShardedProcessor_ShardOf(const MetisShardedProcessor *sharded, const MetisMessage *message)
+{
+    return metisTlvName_HashCode(metisMessage_GetName(message)) % sharded->shardCount;
+}
+
+/**
+ * Parks every worker.  When this returns, the I/O thread may touch any shard.
+ */
+static void
+_metisShardedProcessor_Pause(MetisShardedProcessor *sharded)
+{
+    pthread_mutex_lock(&sharded->lock);
+    __atomic_store_n(&sharded->pauseRequested, true, __ATOMIC_RELEASE);
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        metisMailbox_Wake(sharded->workers[i].inbound);
+    }
+    while (sharded->parkedCount < sharded->shardCount) {
+        pthread_cond_wait(&sharded->parkedCondition, &sharded->lock);
+    }
+    pthread_mutex_unlock(&sharded->lock);
+}
+
+static void
+_metisShardedProcessor_Resume(MetisShardedProcessor *sharded)
+{
+    pthread_mutex_lock(&sharded->lock);
+    __atomic_store_n(&sharded->pauseRequested, false, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&sharded->resumeCondition);
+    pthread_mutex_unlock(&sharded->lock);
+}
+
+// ============================================================
+// Public API
+
+MetisShardedProcessor *
+metisShardedProcessor_Create(MetisForwarder *metis, unsigned shardCount)
+{
+    assertNotNull(metis, "Parameter metis must be non-null");
+    assertTrue(shardCount > 0, "Parameter shardCount must be positive");
+
+    MetisShardedProcessor *sharded = parcMemory_AllocateAndClear(sizeof(MetisShardedProcessor));
+    assertNotNull(sharded, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisShardedProcessor));
+
+    sharded->metis = metis;
+    sharded->logger = metisLogger_Acquire(metisForwarder_GetLogger(metis));
+    sharded->shardCount = shardCount;
+    pthread_mutex_init(&sharded->lock, NULL);
+    pthread_cond_init(&sharded->parkedCondition, NULL);
+    pthread_cond_init(&sharded->resumeCondition, NULL);
+
+    sharded->workers = parcMemory_AllocateAndClear(shardCount * sizeof(_MetisShardWorker));
+    assertNotNull(sharded->workers, "parcMemory_AllocateAndClear(%zu) returned NULL", shardCount * sizeof(_MetisShardWorker));
+
+    for (unsigned i = 0; i < shardCount; i++) {
+        _MetisShardWorker *worker = &sharded->workers[i];
+        worker->sharded = sharded;
+        worker->index = i;
+        worker->dispatcher = metisDispatcher_Create(sharded->logger);
+
+        MetisProcessorEgress egress = {
+            .context        = worker,
+            .isIngressLocal = _metisShardedProcessor_EgressIsIngressLocal,
+            .send           = _metisShardedProcessor_EgressSend,
+        };
+        worker->processor = metisMessageProcessor_CreateShard(metis, worker->dispatcher, &egress, i, shardCount);
+
+        worker->inbound = metisMailbox_Create(METIS_SHARDED_PROCESSOR_RING_SIZE, worker->dispatcher, _metisShardedProcessor_InboundCallback, worker);
+        worker->outbound = metisMailbox_Create(METIS_SHARDED_PROCESSOR_RING_SIZE, metisForwarder_GetDispatcher(metis), _metisShardedProcessor_OutboundCallback, worker);
+    }
+
+    // start the threads only once every shard is set up
+    for (unsigned i = 0; i < shardCount; i++) {
+        int failure = pthread_create(&sharded->workers[i].thread, NULL, _metisShardedProcessor_WorkerRun, &sharded->workers[i]);
+        assertFalse(failure, "pthread_create failed (%d) %s", failure, strerror(failure));
+    }
+
+    if (metisLogger_IsLoggable(sharded->logger, MetisLoggerFacility_Processor, PARCLogLevel_Info)) {
+        metisLogger_Log(sharded->logger, MetisLoggerFacility_Processor, PARCLogLevel_Info, __func__,
+                        "ShardedProcessor %p started %u workers",
+                        (void *) sharded, shardCount);
+    }
+
+    return sharded;
+}
+
+void
+metisShardedProcessor_Destroy(MetisShardedProcessor **shardedPtr)
+{
+    assertNotNull(shardedPtr, "Parameter must be non-null double pointer");
+    assertNotNull(*shardedPtr, "Parameter must dereference to non-null pointer");
+
+    MetisShardedProcessor *sharded = *shardedPtr;
+
+    __atomic_store_n(&sharded->stopRequested, true, __ATOMIC_RELEASE);
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        metisMailbox_Wake(sharded->workers[i].inbound);
+    }
+
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        _MetisShardWorker *worker = &sharded->workers[i];
+        pthread_join(worker->thread, NULL);
+
+        _metisShardedProcessor_DestroyMailbox(&worker->inbound);
+        _metisShardedProcessor_DestroyMailbox(&worker->outbound);
+        metisMessageProcessor_Destroy(&worker->processor);
+        metisDispatcher_Destroy(&worker->dispatcher);
+    }
+
+    if (metisLogger_IsLoggable(sharded->logger, MetisLoggerFacility_Processor, PARCLogLevel_Info)) {
+        metisLogger_Log(sharded->logger, MetisLoggerFacility_Processor, PARCLogLevel_Info, __func__,
+                        "ShardedProcessor %p stopped %u workers",
+                        (void *) sharded, sharded->shardCount);
+    }
+
+    pthread_cond_destroy(&sharded->resumeCondition);
+    pthread_cond_destroy(&sharded->parkedCondition);
+    pthread_mutex_destroy(&sharded->lock);
+    metisLogger_Release(&sharded->logger);
+    parcMemory_Deallocate((void **) &sharded->workers);
+    parcMemory_Deallocate((void **) &sharded);
+    *shardedPtr = NULL;
+}
+
+unsigned
+metisShardedProcessor_ShardCount(const MetisShardedProcessor *sharded)
+{
+    assertNotNull(sharded, "Parameter sharded must be non-null");
+    return sharded->shardCount;
+}
+
+void
+metisShardedProcessor_Receive(MetisShardedProcessor *sharded, MetisMessage *message)
+{
+    assertNotNull(sharded, "Parameter sharded must be non-null");
+    assertNotNull(message, "Parameter message must be non-null");
+
+    // Interests and ContentObjects always have a name (metisMessage rejects them otherwise),
+    // anything else goes to shard 0 to be counted as a drop
+    unsigned shard = 0;
+    if (metisMessage_HasName(message)) {
+        shard = _metisShardedProcessor_ShardOf(sharded, message);
+    }
+    _metisShardedProcessor_Enqueue(sharded, shard, message);
+}
+
+void
+metisShardedProcessor_AddTap(MetisShardedProcessor *sharded, MetisTap *tap)
+{
+    _metisShardedProcessor_Pause(sharded);
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        metisMessageProcessor_AddTap(sharded->workers[i].processor, tap);
+    }
+    _metisShardedProcessor_Resume(sharded);
+}
+
+void
+metisShardedProcessor_RemoveTap(MetisShardedProcessor *sharded, const MetisTap *tap)
+{
+    _metisShardedProcessor_Pause(sharded);
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        metisMessageProcessor_RemoveTap(sharded->workers[i].processor, tap);
+    }
+    _metisShardedProcessor_Resume(sharded);
+}
+
+bool
+metisShardedProcessor_AddOrUpdateRoute(MetisShardedProcessor *sharded, CPIRouteEntry *route)
+{
+    bool result = true;
+    _metisShardedProcessor_Pause(sharded);
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        result = metisMessageProcessor_AddOrUpdateRoute(sharded->workers[i].processor, route) && result;
+    }
+    _metisShardedProcessor_Resume(sharded);
+    return result;
+}
+
+bool
+metisShardedProcessor_RemoveRoute(MetisShardedProcessor *sharded, CPIRouteEntry *route)
+{
+    bool result = true;
+    _metisShardedProcessor_Pause(sharded);
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        result = metisMessageProcessor_RemoveRoute(sharded->workers[i].processor, route) && result;
+    }
+    _metisShardedProcessor_Resume(sharded);
+    return result;
+}
+
+void
+metisShardedProcessor_RemoveConnectionIdFromRoutes(MetisShardedProcessor *sharded, unsigned connectionId)
+{
+    _metisShardedProcessor_Pause(sharded);
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        metisMessageProcessor_RemoveConnectionIdFromRoutes(sharded->workers[i].processor, connectionId);
+    }
+    _metisShardedProcessor_Resume(sharded);
+}
+
+MetisFibEntryList *
+metisShardedProcessor_GetFibEntries(MetisShardedProcessor *sharded)
+{
+    _metisShardedProcessor_Pause(sharded);
+    MetisFibEntryList *list = metisMessageProcessor_GetFibEntries(sharded->workers[0].processor);
+    _metisShardedProcessor_Resume(sharded);
+    return list;
+}
+
+void
+metisShardedProcessor_AccumulateStats(MetisShardedProcessor *sharded, MetisStats *stats)
+{
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        _MetisShardWorker *worker = &sharded->workers[i];
+        metisMessageProcessor_AccumulateStats(worker->processor, stats);
+
+        // A message dropped at a full mailbox never reaches a processor or a connection
+        stats->values[MetisStat_Dropped] += metisStats_Read(worker->countInboundFull);
+        stats->values[MetisStat_Dropped] += metisStats_Read(worker->countOutboundFull);
+        stats->values[MetisStat_DroppedConnectionNotFound] += metisStats_Read(worker->countDroppedConnectionNotFound);
+        stats->values[MetisStat_DroppedZeroHopLimitToRemote] += metisStats_Read(worker->countDroppedZeroHopLimitToRemote);
+        stats->values[MetisStat_SendFailures] += metisStats_Read(worker->countSendFailures);
+    }
+}
+
+void
+metisShardedProcessor_SetContentObjectStoreSize(MetisShardedProcessor *sharded, size_t maximumContentStoreSize)
+{
+    _metisShardedProcessor_Pause(sharded);
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        metisMessageProcessor_SetContentObjectStoreSize(sharded->workers[i].processor, maximumContentStoreSize);
+    }
+    _metisShardedProcessor_Resume(sharded);
+}
+
+void
+metisShardedProcessor_SetContentObjectStoreBytes(MetisShardedProcessor *sharded, size_t maximumContentStoreBytes)
+{
+    _metisShardedProcessor_Pause(sharded);
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        metisMessageProcessor_SetContentObjectStoreBytes(sharded->workers[i].processor, maximumContentStoreBytes);
+    }
+    _metisShardedProcessor_Resume(sharded);
+}
+
+void
+metisShardedProcessor_SetContentObjectStoreDisk(MetisShardedProcessor *sharded, const char *directory, size_t maximumDiskBytes)
+{
+    _metisShardedProcessor_Pause(sharded);
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        metisMessageProcessor_SetContentObjectStoreDisk(sharded->workers[i].processor, directory, maximumDiskBytes);
+    }
+    _metisShardedProcessor_Resume(sharded);
+}
+
+void
+metisShardedProcessor_SetFIBType(MetisShardedProcessor *sharded, MetisFIBType fibType)
+{
+    _metisShardedProcessor_Pause(sharded);
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        metisMessageProcessor_SetFIBType(sharded->workers[i].processor, fibType);
+    }
+    _metisShardedProcessor_Resume(sharded);
+}
+
+void
+metisShardedProcessor_SetContentStoreType(MetisShardedProcessor *sharded, MetisContentStoreType contentStoreType)
+{
+    _metisShardedProcessor_Pause(sharded);
+    for (unsigned i = 0; i < sharded->shardCount; i++) {
+        metisMessageProcessor_SetContentStoreType(sharded->workers[i].processor, contentStoreType);
+    }
+    _metisShardedProcessor_Resume(sharded);
+}
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_ShardedProcessor.h
+ * @brief Runs the MessageProcessor on several worker threads, each owning a shard of the tables
+ *
+ * Each worker thread has its own MetisDispatcher and its own MetisMessageProcessor, so its own PIT,
+ * FIB and ContentStore.  The I/O thread (the forwarder's dispatcher) steers each message to a shard
+ * by metisTlvName_HashCode() of its name, so an Interest and the ContentObjects that satisfy it meet
+ * in the same PIT and the same ContentStore.
+ *
+ * Messages go from the I/O thread to a worker over a MetisSpscRing, and the worker's sends come back
+ * over a second ring, because the connections belong to the I/O thread.  A one-byte write on a pipe
+ * wakes the other side's dispatcher, only when it is not already due to run.
+ *
+ * The FIB is replicated in every shard.  Configuration calls (routes, taps, content store sizes) are
+ * made from the I/O thread; they pause all workers, change every shard, and resume them.  Taps are
+ * called on the worker threads.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_ShardedProcessor_h
+#define Metis_metis_ShardedProcessor_h
+
+#include <ccnx/forwarder/metis/processor/metis_MessageProcessor.h>
+
+struct metis_sharded_processor;
+typedef struct metis_sharded_processor MetisShardedProcessor;
+
+/**
+ * Creates the shards and starts one worker thread per shard
+ *
+ * Must be called on the forwarder's dispatcher thread, which becomes the I/O thread.
+ *
+ * @param [in] metis Pointer to owning Metis process
+ * @param [in] shardCount The number of worker threads, at least 1
+ *
+ * @return non-null An allocated sharded processor with running workers
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisShardedProcessor *sharded = metisShardedProcessor_Create(metis, 4);
+ *     metisShardedProcessor_Destroy(&sharded);
+ * }
+ * @endcode
+ */
+MetisShardedProcessor *metisShardedProcessor_Create(MetisForwarder *metis, unsigned shardCount);
+
+/**
+ * Stops and joins the worker threads and destroys the shards
+ *
+ * Messages still queued in either direction are released without being processed or sent.
+ *
+ * @param [in,out] shardedPtr Pointer to the sharded processor, will be NULL'd
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisShardedProcessor *sharded = metisShardedProcessor_Create(metis, 4);
+ *     metisShardedProcessor_Destroy(&sharded);
+ * }
+ * @endcode
+ */
+void metisShardedProcessor_Destroy(MetisShardedProcessor **shardedPtr);
+
+/**
+ * The number of shards (worker threads)
+ *
+ * @param [in] sharded An allocated sharded processor
+ *
+ * @return The shard count
+ *
+ * Example:
+ * @code
+ * {
+ *     unsigned workers = metisShardedProcessor_ShardCount(sharded);
+ * }
+ * @endcode
+ */
+unsigned metisShardedProcessor_ShardCount(const MetisShardedProcessor *sharded);
+
+/**
+ * Queues the message to its shard, takes ownership of the message
+ *
+ * Same contract as metisMessageProcessor_Receive(), but returns before the message is processed.
+ * If the shard's queue is full, the message is dropped.
+ *
+ * @param [in] sharded An allocated sharded processor
+ * @param [in] message The Interest or ContentObject
+ *
+ * Example:
+ * @code
+ * {
+ *     metisShardedProcessor_Receive(sharded, message);
+ * }
+ * @endcode
+ */
+void metisShardedProcessor_Receive(MetisShardedProcessor *sharded, MetisMessage *message);
+
+/**
+ * Adds a tap to every shard.  See metisMessageProcessor_AddTap().
+ *
+ * The tap is called on the worker threads.
+ *
+ * @param [in] sharded An allocated sharded processor
+ * @param [in] tap The tap, owned by the caller
+ *
+ * Example:
+ * @code
+ * {
+ *     metisShardedProcessor_AddTap(sharded, &tap);
+ * }
+ * @endcode
+ */
+void metisShardedProcessor_AddTap(MetisShardedProcessor *sharded, MetisTap *tap);
+
+/**
+ * Removes the tap from every shard.  See metisMessageProcessor_RemoveTap().
+ *
+ * @param [in] sharded An allocated sharded processor
+ * @param [in] tap The tap to remove
+ *
+ * Example:
+ * @code
+ * {
+ *     metisShardedProcessor_RemoveTap(sharded, &tap);
+ * }
+ * @endcode
+ */
+void metisShardedProcessor_RemoveTap(MetisShardedProcessor *sharded, const MetisTap *tap);
+
+/**
+ * Adds or updates a route in every shard's FIB.  See metisMessageProcessor_AddOrUpdateRoute().
+ *
+ * @param [in] sharded An allocated sharded processor
+ * @param [in] route The route to update
+ *
+ * @retval true added or updated
+ * @retval false An error
+ *
+ * Example:
+ * @code
+ * {
+ *     metisShardedProcessor_AddOrUpdateRoute(sharded, route);
+ * }
+ * @endcode
+ */
+bool metisShardedProcessor_AddOrUpdateRoute(MetisShardedProcessor *sharded, CPIRouteEntry *route);
+
+/**
+ * Removes a route from every shard's FIB.  See metisMessageProcessor_RemoveRoute().
+ *
+ * @param [in] sharded An allocated sharded processor
+ * @param [in] route The route to remove
+ *
+ * @retval true Route completely removed
+ * @retval false There is still a nexthop for the route
+ *
+ * Example:
+ * @code
+ * {
+ *     metisShardedProcessor_RemoveRoute(sharded, route);
+ * }
+ * @endcode
+ */
+bool metisShardedProcessor_RemoveRoute(MetisShardedProcessor *sharded, CPIRouteEntry *route);
+
+/**
+ * Removes a connection id from every shard's FIB.  See metisMessageProcessor_RemoveConnectionIdFromRoutes().
+ *
+ * @param [in] sharded An allocated sharded processor
+ * @param [in] connectionId The connection that went away
+ *
+ * Example:
+ * @code
+ * {
+ *     metisShardedProcessor_RemoveConnectionIdFromRoutes(sharded, connectionId);
+ * }
+ * @endcode
+ */
+void metisShardedProcessor_RemoveConnectionIdFromRoutes(MetisShardedProcessor *sharded, unsigned connectionId);
+
+/**
+ * Returns a list of all FIB entries.  Every shard has the same FIB.
+ *
+ * You must destroy the list.
+ *
+ * @param [in] sharded An allocated sharded processor
+ *
+ * @retval non-null The list of FIB entries
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisFibEntryList *list = metisShardedProcessor_GetFibEntries(sharded);
+ *     metisFibEntryList_Destroy(&list);
+ * }
+ * @endcode
+ */
+MetisFibEntryList *metisShardedProcessor_GetFibEntries(MetisShardedProcessor *sharded);
+
+/**
+ * Adds every shard's counters in to `stats`
+ *
+ * This includes the drops counted on the I/O thread: full mailboxes, unknown egress connections,
+ * send failures and hop limit 0 to a remote connection.
+ *
+ * Unlike the table operations, this does not pause the workers.  Each counter is read
+ * atomically while the workers keep counting.
+ *
+ * @param [in] sharded An allocated sharded processor
+ * @param [in] stats The snapshot to add to
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisStats stats;
+ *     metisStats_Init(&stats);
+ *     metisShardedProcessor_AccumulateStats(sharded, &stats);
+ * }
+ * @endcode
+ */
+void metisShardedProcessor_AccumulateStats(MetisShardedProcessor *sharded, MetisStats *stats);
+
+/**
+ * Sets the total ContentStore object count, divided evenly among the shards
+ *
+ * @param [in] sharded An allocated sharded processor
+ * @param [in] maximumContentStoreSize The most objects cached by all shards together
+ *
+ * Example:
+ * @code
+ * {
+ *     metisShardedProcessor_SetContentObjectStoreSize(sharded, 100000);
+ * }
+ * @endcode
+ */
+void metisShardedProcessor_SetContentObjectStoreSize(MetisShardedProcessor *sharded, size_t maximumContentStoreSize);
+
+/**
+ * Sets the total ContentStore byte limit, divided evenly among the shards
+ *
+ * @param [in] sharded An allocated sharded processor
+ * @param [in] maximumContentStoreBytes The most bytes cached by all shards together, or 0 for no limit
+ *
+ * Example:
+ * @code
+ * {
+ *     metisShardedProcessor_SetContentObjectStoreBytes(sharded, 512 * 1024 * 1024);
+ * }
+ * @endcode
+ */
+void metisShardedProcessor_SetContentObjectStoreBytes(MetisShardedProcessor *sharded, size_t maximumContentStoreBytes);
+
+/**
+ * Puts a disk store behind every shard, each in its own sub-directory of `directory`
+ *
+ * @param [in] sharded An allocated sharded processor
+ * @param [in] directory The parent directory, or NULL to remove the disk stores
+ * @param [in] maximumDiskBytes The total disk budget, divided evenly among the shards
+ *
+ * Example:
+ * @code
+ * {
+ *     metisShardedProcessor_SetContentObjectStoreDisk(sharded, "/var/cache/metis", 4ULL * 1024 * 1024 * 1024);
+ * }
+ * @endcode
+ */
+void metisShardedProcessor_SetContentObjectStoreDisk(MetisShardedProcessor *sharded, const char *directory, size_t maximumDiskBytes);
+
+/**
+ * Replaces every shard's FIB with an empty FIB of the given type.  See metisMessageProcessor_SetFIBType().
+ *
+ * @param [in] sharded An allocated sharded processor
+ * @param [in] fibType The FIB implementation to use
+ *
+ * Example:
+ * @code
+ * {
+ *     metisShardedProcessor_SetFIBType(sharded, MetisFIBType_Trie);
+ * }
+ * @endcode
+ */
+void metisShardedProcessor_SetFIBType(MetisShardedProcessor *sharded, MetisFIBType fibType);
+
+/**
+ * Replaces every shard's content store with an empty store of the given policy.  See metisMessageProcessor_SetContentStoreType().
+ *
+ * @param [in] sharded An allocated sharded processor
+ * @param [in] contentStoreType The content store policy to use
+ *
+ * Example:
+ * @code
+ * {
+ *     metisShardedProcessor_SetContentStoreType(sharded, MetisContentStoreType_TinyLFU);
+ * }
+ * @endcode
+ */
+void metisShardedProcessor_SetContentStoreType(MetisShardedProcessor *sharded, MetisContentStoreType contentStoreType);
+#endif // Metis_metis_ShardedProcessor_h
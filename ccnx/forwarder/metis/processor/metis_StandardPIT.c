@@ -64,6 +64,13 @@
  * - Whan an Interest arrives or is aggregated, the Lifetime for that reverse hop is extended.  As a simplification,
  *   we only keep a single lifetime not per reverse hop.
  *
+ * Expiry:
+ * - Every PIT entry has a timer in a hierarchical timer wheel.  A periodic dispatcher timer advances the
+ *   wheel and removes at most METIS_PIT_EXPIRY_BATCH expired entries per tick, so entries that are never
+ *   satisfied do not stay in the table.
+ * - Extending the lifetime does not touch the wheel.  When the timer fires, we check the entry's
+ *   current expiry time and reschedule it if it was extended.
+ *
  * Caveats:
  * - Does not support multiple MTUs yet (case 218)
  * - Does not handle the case when an interest comes in two different interfaces that are both
@@ -85,6 +92,7 @@
 #include <ccnx/forwarder/metis/processor/metis_MatchingRulesTable.h>
 
 #include <ccnx/forwarder/metis/core/metis_Ticks.h>
+#include <ccnx/forwarder/metis/core/metis_TimerWheel.h>
 
 #include <parc/algol/parc_Memory.h>
 #include <parc/algol/parc_HashCodeTable.h>
@@ -97,16 +105,29 @@
 struct metis_standard_pit;
 typedef struct metis_standard_pit MetisStandardPIT;
 
+// How often we advance the expiry wheel
+#define METIS_PIT_EXPIRY_INTERVAL_USEC 10000
+
+// The most PIT entries we expire per interval, so one tick never stalls the forwarder
+#define METIS_PIT_EXPIRY_BATCH 4096
+
 struct metis_standard_pit {
     MetisForwarder *metis;
     MetisLogger *logger;
 
+    // runs the expiry timer, the forwarder's or a processor worker thread's
+    MetisDispatcher *dispatcher;
+
     MetisMatchingRulesTable *table;
 
+    MetisTimerWheel *expiryWheel;
+    PARCEventTimer *expiryEvent;
+
     // counters to track how many of each type of Interest we get
     unsigned insertCounterByName;
     unsigned insertCounterByKeyId;
     unsigned insertCounterByObjectHash;
+    unsigned expiredCounter;
 };
 
 static void _metisPIT_StoreInTable(MetisStandardPIT *pit, MetisMessage *interestMessage);
@@ -152,7 +173,9 @@ _metisPIT_StoreInTable(MetisStandardPIT *pit, MetisMessage *interestMessage)
     // this is done in metisPitEntry_Create
     //    metisPitEntry_AddIngressId(pitEntry, metisMessage_GetIngressConnectionId(interestMessage));
 
-    metisMatchingRulesTable_AddToBestTable(pit->table, key, pitEntry);
+    if (metisMatchingRulesTable_AddToBestTable(pit->table, key, pitEntry)) {
+        metisPitEntry_SetExpiryTimer(pitEntry, metisTimerWheel_Schedule(pit->expiryWheel, expiryTime, pitEntry));
+    }
 
     if (metisLogger_IsLoggable(pit->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
         metisLogger_Log(pit->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
@@ -170,6 +193,71 @@ _metisPIT_ExtendLifetime(MetisStandardPIT *pit, MetisPitEntry *pitEntry, MetisMe
     metisPitEntry_SetExpiryTime(pitEntry, expiryTime);
 }
 
+/**
+ * Cancels the entry's expiry timer.  Must be called before the entry is removed from the table.
+ */
+static void
+_metisPIT_CancelExpiry(MetisStandardPIT *pit, MetisPitEntry *pitEntry)
+{
+    MetisTimerWheelTimer *timer = metisPitEntry_GetExpiryTimer(pitEntry);
+    if (timer) {
+        metisTimerWheel_Cancel(pit->expiryWheel, &timer);
+        metisPitEntry_SetExpiryTimer(pitEntry, NULL);
+    }
+}
+
+/**
+ * Removes up to maxEntries expired entries from the table
+ *
+ * Entries whose lifetime was extended since they were scheduled go back in the wheel.
+ *
+ * @return The number of entries removed
+ */
+static size_t
+_metisPIT_ExpireEntries(MetisStandardPIT *pit, MetisTicks now, size_t maxEntries)
+{
+    metisTimerWheel_Advance(pit->expiryWheel, now);
+
+    size_t processed = 0;
+    size_t removed = 0;
+    MetisPitEntry *pitEntry;
+    while (processed < maxEntries && (pitEntry = metisTimerWheel_PopExpired(pit->expiryWheel)) != NULL) {
+        processed++;
+
+        // the wheel freed the timer
+        metisPitEntry_SetExpiryTimer(pitEntry, NULL);
+
+        MetisTicks expiryTime = metisPitEntry_GetExpiryTime(pitEntry);
+        if (now < expiryTime) {
+            metisPitEntry_SetExpiryTimer(pitEntry, metisTimerWheel_Schedule(pit->expiryWheel, expiryTime, pitEntry));
+            continue;
+        }
+
+        if (metisLogger_IsLoggable(pit->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+            metisLogger_Log(pit->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                            "PIT entry %p expired (expiry %" PRIu64 ")",
+                            (void *) pitEntry,
+                            expiryTime);
+        }
+
+        // Key is a reference counted copy of the pit entry message.  This destroys the entry.
+        MetisMessage *key = metisPitEntry_GetMessage(pitEntry);
+        metisMatchingRulesTable_RemoveFromBest(pit->table, key);
+        metisMessage_Release(&key);
+        removed++;
+    }
+
+    pit->expiredCounter += removed;
+    return removed;
+}
+
+static void
+_metisPIT_ExpiryCallback(int fd, PARCEventType which_event, void *user_data)
+{
+    MetisStandardPIT *pit = (MetisStandardPIT *) user_data;
+    _metisPIT_ExpireEntries(pit, metisForwarder_GetTicks(pit->metis), METIS_PIT_EXPIRY_BATCH);
+}
+
 // this appears to only be used in some unit tests
 __attribute__((unused))
 static void
@@ -204,7 +292,12 @@ _metisStandardPIT_Destroy(MetisPIT **pitPtr)
                         (void *) pit);
     }
 
+    metisDispatcher_StopTimer(pit->dispatcher, pit->expiryEvent);
+    metisDispatcher_DestroyTimerEvent(pit->dispatcher, &pit->expiryEvent);
+
+    // destroy the table before the wheel, the entries hold pointers to their timers
     metisMatchingRulesTable_Destroy(&pit->table);
+    metisTimerWheel_Destroy(&pit->expiryWheel);
     metisLogger_Release(&pit->logger);
     parcMemory_Deallocate(pitPtr);
 }
@@ -257,6 +350,7 @@ _metisStandardPIT_ReceiveInterest(MetisPIT *generic, MetisMessage *interestMessa
         }
 
         // it's an old entry, remove it
+        _metisPIT_CancelExpiry(pit, pitEntry);
         metisMatchingRulesTable_RemoveFromBest(pit->table, interestMessage);
     }
 
@@ -265,35 +359,33 @@ _metisStandardPIT_ReceiveInterest(MetisPIT *generic, MetisMessage *interestMessa
     return MetisPITVerdict_Forward;
 }
 
-static MetisNumberSet *
-_metisStandardPIT_SatisfyInterest(MetisPIT *generic, const MetisMessage *objectMessage)
+static void
+_metisStandardPIT_SatisfyInterest(MetisPIT *generic, const MetisMessage *objectMessage, MetisNumberSet *ingressSetUnion)
 {
     assertNotNull(generic, "Parameter pit must be non-null");
     assertNotNull(objectMessage, "Parameter objectMessage must be non-null");
+    assertNotNull(ingressSetUnion, "Parameter ingressSetUnion must be non-null");
 
     MetisStandardPIT *pit = metisPIT_Closure(generic);
 
     // we need to look in all three tables to see if there's anything
     // to satisy in each of them and take the union of the reverse path sets.
 
-    MetisNumberSet *ingressSetUnion = metisNumberSet_Create();
+    void *matches[METIS_MATCHING_RULES_TABLE_MAX_MATCHES];
+    size_t count = metisMatchingRulesTable_GetUnion(pit->table, objectMessage, matches);
+    for (size_t i = 0; i < count; i++) {
+        MetisPitEntry *pitEntry = (MetisPitEntry *) matches[i];
 
-    PARCArrayList *list = metisMatchingRulesTable_GetUnion(pit->table, objectMessage);
-    for (size_t i = 0; i < parcArrayList_Size(list); i++) {
-        MetisPitEntry *pitEntry = (MetisPitEntry *) parcArrayList_Get(list, i);
-
-        // this is a reference counted return
+        // this is the entry's own set, not a copy
         const MetisNumberSet *ingressSet = metisPitEntry_GetIngressSet(pitEntry);
         metisNumberSet_AddSet(ingressSetUnion, ingressSet);
 
         // and remove it from the PIT.  Key is a reference counted copy of the pit entry message
+        _metisPIT_CancelExpiry(pit, pitEntry);
         MetisMessage *key = metisPitEntry_GetMessage(pitEntry);
         metisMatchingRulesTable_RemoveFromBest(pit->table, key);
         metisMessage_Release(&key);
     }
-    parcArrayList_Destroy(&list);
-
-    return ingressSetUnion;
 }
 
 static void
@@ -310,7 +402,11 @@ _metisStandardPIT_RemoveInterest(MetisPIT *generic, const MetisMessage *interest
                         (void *) interestMessage);
     }
 
-    metisMatchingRulesTable_RemoveFromBest(pit->table, interestMessage);
+    MetisPitEntry *pitEntry = metisMatchingRulesTable_Get(pit->table, interestMessage);
+    if (pitEntry) {
+        _metisPIT_CancelExpiry(pit, pitEntry);
+        metisMatchingRulesTable_RemoveFromBest(pit->table, interestMessage);
+    }
 }
 
 static MetisPitEntry *
@@ -328,6 +424,13 @@ _metisStandardPIT_GetPitEntry(const MetisPIT *generic, const MetisMessage *inter
     return NULL;
 }
 
+static void
+_metisStandardPIT_Prefetch(const MetisPIT *generic, const MetisMessage *message)
+{
+    MetisStandardPIT *pit = metisPIT_Closure(generic);
+    metisMatchingRulesTable_Prefetch(pit->table, message);
+}
+
 
 // ======================================================================
 // Public API
@@ -336,6 +439,14 @@ MetisPIT *
 metisStandardPIT_Create(MetisForwarder *metis)
 {
     assertNotNull(metis, "Parameter must be non-null");
+    return metisStandardPIT_CreateWithDispatcher(metis, metisForwarder_GetDispatcher(metis));
+}
+
+MetisPIT *
+metisStandardPIT_CreateWithDispatcher(MetisForwarder *metis, MetisDispatcher *dispatcher)
+{
+    assertNotNull(metis, "Parameter metis must be non-null");
+    assertNotNull(dispatcher, "Parameter dispatcher must be non-null");
 
     size_t allocation = sizeof(MetisPIT) + sizeof(MetisStandardPIT);
 
@@ -347,6 +458,12 @@ metisStandardPIT_Create(MetisForwarder *metis)
     pit->metis = metis;
     pit->logger = metisLogger_Acquire(metisForwarder_GetLogger(metis));
     pit->table = metisMatchingRulesTable_Create(_metisPIT_PitEntryDestroyer);
+    pit->expiryWheel = metisTimerWheel_Create(metisForwarder_GetTicks(metis));
+
+    pit->dispatcher = dispatcher;
+    pit->expiryEvent = metisDispatcher_CreateTimer(dispatcher, true, _metisPIT_ExpiryCallback, pit);
+    struct timeval interval = { 0, METIS_PIT_EXPIRY_INTERVAL_USEC };
+    metisDispatcher_StartTimer(dispatcher, pit->expiryEvent, &interval);
 
     if (metisLogger_IsLoggable(pit->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
         metisLogger_Log(pit->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
@@ -355,6 +472,7 @@ metisStandardPIT_Create(MetisForwarder *metis)
     }
 
     generic->getPitEntry = _metisStandardPIT_GetPitEntry;
+    generic->prefetch = _metisStandardPIT_Prefetch;
     generic->receiveInterest = _metisStandardPIT_ReceiveInterest;
     generic->release = _metisStandardPIT_Destroy;
     generic->removeInterest = _metisStandardPIT_RemoveInterest;
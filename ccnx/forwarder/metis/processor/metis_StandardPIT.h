@@ -84,4 +84,24 @@
  * @endcode
  */
 MetisPIT *metisStandardPIT_Create(MetisForwarder *metis);
+
+/**
+ * Creates a PIT table whose expiry timer runs on the given dispatcher
+ *
+ * Used by a MessageProcessor running on its own thread, so the PIT is only touched from that thread.
+ *
+ * @param [in] metis The releated MetisForwarder
+ * @param [in] dispatcher The dispatcher of the thread that owns the PIT
+ *
+ * @return non-null a PIT table
+ *
+ * Example:
+ * @code
+ * {
+ *     MetisPIT *pit = metisStandardPIT_CreateWithDispatcher(metis, workerDispatcher);
+ *     metisPIT_Release(&pit);
+ * }
+ * @endcode
+ */
+MetisPIT *metisStandardPIT_CreateWithDispatcher(MetisForwarder *metis, MetisDispatcher *dispatcher);
 #endif // Metis_metis_PIT_h
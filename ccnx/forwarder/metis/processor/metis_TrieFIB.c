@@ -0,0 +1,578 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * A FIB built on a compressed name-component trie.
+ *
+ * The root is the empty prefix.  Every other node stores a reference to a name that
+ * has the node's prefix and the number of segments in that prefix.  The edge from a node's
+ * parent is the segments [parent->segmentCount, node->segmentCount) of the node's name,
+ * so a chain of nodes without routes is one edge.  A node without a route always has at least
+ * two children; we split an edge when a route is added inside it and merge edges again when
+ * a route is removed.
+ *
+ * The children of a node are kept in an array sorted by the first segment of their edge,
+ * so finding the next node is a binary search.  No two children have the same first segment.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ccnx/forwarder/metis/processor/metis_TrieFIB.h>
+#include <ccnx/forwarder/metis/processor/metis_FibEntry.h>
+#include <ccnx/forwarder/metis/processor/metis_FibConnectionIndex.h>
+#include <parc/algol/parc_Memory.h>
+
+#include <LongBow/runtime.h>
+
+typedef struct metis_trie_fib_node _MetisTrieNode;
+
+struct metis_trie_fib_node {
+    _MetisTrieNode *parent;
+
+    // A name with this node's prefix, NULL for the root
+    MetisTlvName *name;
+
+    // The number of segments in this node's prefix
+    size_t segmentCount;
+
+    // The route for this prefix, NULL if none
+    MetisFibEntry *entry;
+
+    // sorted by the first segment of the edge to the child
+    _MetisTrieNode **children;
+    size_t childrenLength;
+    size_t childrenCapacity;
+};
+
+typedef struct metis_trie_fib {
+    _MetisTrieNode *root;
+    size_t entryCount;
+
+    // connection id -> the entries that route to it
+    MetisFibConnectionIndex *connectionIndex;
+
+    MetisLogger *logger;
+
+    // If there are no forward paths, we return an emtpy set.  Allocate this
+    // once and return a reference to it whenever we need an empty set.
+    MetisNumberSet *emptySet;
+} MetisTrieFIB;
+
+static void                   _metisTrieFIB_Destroy(MetisFIB **fibPtr);
+static const MetisNumberSet *_metisTrieFIB_Match(MetisFIB *generic, const MetisMessage *interestMessage);
+static bool                   _metisTrieFIB_AddOrUpdate(MetisFIB *generic, CPIRouteEntry *route);
+static bool                   _metisTrieFIB_Remove(MetisFIB *generic, CPIRouteEntry *route);
+static size_t                 _metisTrieFIB_Length(const MetisFIB *generic);
+static MetisFibEntryList     *_metisTrieFIB_GetEntries(const MetisFIB *generic);
+static void                   _metisTrieFIB_RemoveConnectionIdFromRoutes(MetisFIB *generic, unsigned connectionId);
+
+// =====================================================
+// Trie nodes
+
+static _MetisTrieNode *
+_metisTrieNode_Create(_MetisTrieNode *parent, const MetisTlvName *name, size_t segmentCount)
+{
+    _MetisTrieNode *node = parcMemory_AllocateAndClear(sizeof(_MetisTrieNode));
+    assertNotNull(node, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(_MetisTrieNode));
+    node->parent = parent;
+    node->segmentCount = segmentCount;
+    if (name) {
+        node->name = metisTlvName_Acquire(name);
+    }
+    return node;
+}
+
+/**
+ * Destroys the node and all its children
+ */
+static void
+_metisTrieNode_Destroy(_MetisTrieNode **nodePtr)
+{
+    _MetisTrieNode *node = *nodePtr;
+
+    for (size_t i = 0; i < node->childrenLength; i++) {
+        _metisTrieNode_Destroy(&node->children[i]);
+    }
+
+    if (node->children) {
+        parcMemory_Deallocate((void **) &node->children);
+    }
+
+    if (node->entry) {
+        metisFibEntry_Release(&node->entry);
+    }
+
+    if (node->name) {
+        metisTlvName_Release(&node->name);
+    }
+
+    parcMemory_Deallocate((void **) &node);
+    *nodePtr = NULL;
+}
+
+/**
+ * Binary search for the child whose edge starts with segment segmentIndex of name.
+ *
+ * @param [out] foundPtr Set true if there is such a child
+ * @return The index of the child if found, otherwise the index where it would be inserted
+ */
+static size_t
+_metisTrieNode_FindChild(const _MetisTrieNode *node, const MetisTlvName *name, size_t segmentIndex, bool *foundPtr)
+{
+    size_t low = 0;
+    size_t high = node->childrenLength;
+
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        int compare = metisTlvName_SegmentCompare(name, segmentIndex, node->children[middle]->name, node->segmentCount);
+        if (compare == 0) {
+            *foundPtr = true;
+            return middle;
+        }
+
+        if (compare < 0) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+
+    *foundPtr = false;
+    return low;
+}
+
+static void
+_metisTrieNode_InsertChild(_MetisTrieNode *node, size_t index, _MetisTrieNode *child)
+{
+    if (node->childrenLength == node->childrenCapacity) {
+        size_t newCapacity = (node->childrenCapacity == 0) ? 2 : node->childrenCapacity * 2;
+        _MetisTrieNode **newChildren = parcMemory_Allocate(newCapacity * sizeof(_MetisTrieNode *));
+        assertNotNull(newChildren, "parcMemory_Allocate(%zu) returned NULL", newCapacity * sizeof(_MetisTrieNode *));
+        if (node->children) {
+            memcpy(newChildren, node->children, node->childrenLength * sizeof(_MetisTrieNode *));
+            parcMemory_Deallocate((void **) &node->children);
+        }
+        node->children = newChildren;
+        node->childrenCapacity = newCapacity;
+    }
+
+    memmove(&node->children[index + 1], &node->children[index], (node->childrenLength - index) * sizeof(_MetisTrieNode *));
+    node->children[index] = child;
+    node->childrenLength++;
+    child->parent = node;
+}
+
+static void
+_metisTrieNode_RemoveChildAt(_MetisTrieNode *node, size_t index)
+{
+    memmove(&node->children[index], &node->children[index + 1], (node->childrenLength - index - 1) * sizeof(_MetisTrieNode *));
+    node->childrenLength--;
+}
+
+/**
+ * Compares the edge to child with name, starting at segment 'from', up to segment 'limit' (exclusive).
+ *
+ * @return The first segment index that does not match, or min(limit, child->segmentCount)
+ */
+static size_t
+_metisTrieNode_MatchEdge(const _MetisTrieNode *child, const MetisTlvName *name, size_t from, size_t limit)
+{
+    size_t end = (limit < child->segmentCount) ? limit : child->segmentCount;
+    size_t i = from;
+    while (i < end && metisTlvName_SegmentCompare(name, i, child->name, i) == 0) {
+        i++;
+    }
+    return i;
+}
+
+// =====================================================
+// Trie operations
+
+/**
+ * Finds the node for exactly the name.  If create is true, creates the node (splitting
+ * an edge if necessary) if it does not exist.
+ *
+ * @return The node, or NULL if not found and create is false
+ */
+static _MetisTrieNode *
+_metisTrieFIB_FindNode(MetisTrieFIB *fib, const MetisTlvName *name, bool create)
+{
+    size_t nameCount = metisTlvName_SegmentCount(name);
+    _MetisTrieNode *node = fib->root;
+
+    while (node->segmentCount < nameCount) {
+        bool found;
+        size_t index = _metisTrieNode_FindChild(node, name, node->segmentCount, &found);
+        if (!found) {
+            if (!create) {
+                return NULL;
+            }
+
+            _MetisTrieNode *leaf = _metisTrieNode_Create(node, name, nameCount);
+            _metisTrieNode_InsertChild(node, index, leaf);
+            return leaf;
+        }
+
+        _MetisTrieNode *child = node->children[index];
+
+        // we know the first segment of the edge matches
+        size_t depth = _metisTrieNode_MatchEdge(child, name, node->segmentCount + 1, nameCount);
+        if (depth == child->segmentCount) {
+            node = child;
+            continue;
+        }
+
+        // The name ends inside the edge or diverges from it
+        if (!create) {
+            return NULL;
+        }
+
+        // Split the edge at depth.  The middle node has the same first edge segment as
+        // the child, so it takes the child's place in the sorted array.
+        _MetisTrieNode *middle = _metisTrieNode_Create(node, child->name, depth);
+        node->children[index] = middle;
+        _metisTrieNode_InsertChild(middle, 0, child);
+
+        if (depth == nameCount) {
+            return middle;
+        }
+
+        _MetisTrieNode *leaf = _metisTrieNode_Create(middle, name, nameCount);
+        size_t leafIndex = _metisTrieNode_FindChild(middle, name, depth, &found);
+        _metisTrieNode_InsertChild(middle, leafIndex, leaf);
+        return leaf;
+    }
+
+    return node;
+}
+
+/**
+ * After a route is removed from node, remove nodes that no longer carry a route
+ * or a branch, merging edges as needed so the trie stays compressed.
+ */
+static void
+_metisTrieFIB_Compress(MetisTrieFIB *fib, _MetisTrieNode *node)
+{
+    while (node != fib->root && node->entry == NULL && node->childrenLength <= 1) {
+        _MetisTrieNode *parent = node->parent;
+
+        bool found;
+        size_t index = _metisTrieNode_FindChild(parent, node->name, parent->segmentCount, &found);
+        assertTrue(found && parent->children[index] == node, "Trie node %p not found in its parent %p", (void *) node, (void *) parent);
+
+        if (node->childrenLength == 1) {
+            // Merge the edges.  The child's edge now starts at the parent and has the same first
+            // segment as the node's edge, so it takes the node's place in the sorted array.
+            _MetisTrieNode *child = node->children[0];
+            child->parent = parent;
+            parent->children[index] = child;
+            node->childrenLength = 0;
+            _metisTrieNode_Destroy(&node);
+
+            // the parent has the same number of children, so we're done
+            return;
+        }
+
+        _metisTrieNode_RemoveChildAt(parent, index);
+        _metisTrieNode_Destroy(&node);
+        node = parent;
+    }
+}
+
+static void
+_metisTrieFIB_AppendEntries(const _MetisTrieNode *node, MetisFibEntryList *list)
+{
+    if (node->entry) {
+        metisFibEntryList_Append(list, node->entry);
+    }
+
+    for (size_t i = 0; i < node->childrenLength; i++) {
+        _metisTrieFIB_AppendEntries(node->children[i], list);
+    }
+}
+
+/**
+ * Removes the route from the node and removes nodes that are no longer needed.
+ * The caller must have removed all the nexthops of the route.
+ */
+static void
+_metisTrieFIB_RemoveEntry(MetisTrieFIB *fib, _MetisTrieNode *node)
+{
+    metisFibEntry_Release(&node->entry);
+    fib->entryCount--;
+    _metisTrieFIB_Compress(fib, node);
+}
+
+/**
+ * We can accept the FIB entry if it does not contain the ingress connection id or if
+ * there is more than one forward path besides the ingress connection id.
+ */
+static bool
+_metisTrieFIB_IsAcceptable(const MetisFibEntry *fibEntry, unsigned ingressId)
+{
+    const MetisNumberSet *nexthops = metisFibEntry_GetNexthops(fibEntry);
+    return !metisNumberSet_Contains(nexthops, ingressId) || metisNumberSet_Length(nexthops) > 1;
+}
+
+// =====================================================
+// Public API
+
+MetisFIB *
+metisTrieFIB_Create(MetisLogger *logger)
+{
+    size_t allocation = sizeof(MetisFIB) + sizeof(MetisTrieFIB);
+
+    MetisFIB *generic = parcMemory_AllocateAndClear(allocation);
+    assertNotNull(generic, "parcMemory_AllocateAndClear(%zu) returned NULL", allocation);
+    generic->closure = (uint8_t *) generic + sizeof(MetisFIB);
+
+    MetisTrieFIB *fib = metisFIB_Closure(generic);
+    fib->emptySet = metisNumberSet_Create();
+    fib->logger = metisLogger_Acquire(logger);
+    fib->root = _metisTrieNode_Create(NULL, NULL, 0);
+    fib->connectionIndex = metisFibConnectionIndex_Create();
+
+    if (metisLogger_IsLoggable(fib->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+        metisLogger_Log(fib->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                        "FIB %p created",
+                        (void *) fib);
+    }
+
+    generic->destroy = _metisTrieFIB_Destroy;
+    generic->match = _metisTrieFIB_Match;
+    generic->addOrUpdate = _metisTrieFIB_AddOrUpdate;
+    generic->remove = _metisTrieFIB_Remove;
+    generic->length = _metisTrieFIB_Length;
+    generic->getEntries = _metisTrieFIB_GetEntries;
+    generic->removeConnectionIdFromRoutes = _metisTrieFIB_RemoveConnectionIdFromRoutes;
+
+    return generic;
+}
+
+// =====================================================
+// Interface implementation
+
+static void
+_metisTrieFIB_Destroy(MetisFIB **fibPtr)
+{
+    assertNotNull(fibPtr, "Parameter must be non-null double pointer");
+    assertNotNull(*fibPtr, "Parameter must dereference to non-null pointer");
+
+    MetisTrieFIB *fib = metisFIB_Closure(*fibPtr);
+
+    if (metisLogger_IsLoggable(fib->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug)) {
+        metisLogger_Log(fib->logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug, __func__,
+                        "FIB %p destroyed",
+                        (void *) fib);
+    }
+
+    _metisTrieNode_Destroy(&fib->root);
+    metisFibConnectionIndex_Destroy(&fib->connectionIndex);
+    metisNumberSet_Release(&fib->emptySet);
+    metisLogger_Release(&fib->logger);
+    parcMemory_Deallocate((void **) fibPtr);
+    *fibPtr = NULL;
+}
+
+static const MetisNumberSet *
+_metisTrieFIB_Match(MetisFIB *generic, const MetisMessage *interestMessage)
+{
+    assertNotNull(generic, "Parameter fib must be non-null");
+    assertNotNull(interestMessage, "Parameter interestMessage must be non-null");
+    MetisTrieFIB *fib = metisFIB_Closure(generic);
+
+    if (metisMessage_HasName(interestMessage)) {
+        // this is NOT reference counted, don't destroy it
+        MetisTlvName *tlvName = metisMessage_GetName(interestMessage);
+        unsigned ingressId = metisMessage_GetIngressConnectionId(interestMessage);
+        size_t nameCount = metisTlvName_SegmentCount(tlvName);
+
+        MetisFibEntry *longestMatchingFibEntry = NULL;
+
+        // walk down the trie, remembering the deepest acceptable entry
+        _MetisTrieNode *node = fib->root;
+        while (node->segmentCount < nameCount) {
+            bool found;
+            size_t index = _metisTrieNode_FindChild(node, tlvName, node->segmentCount, &found);
+            if (!found) {
+                break;
+            }
+
+            _MetisTrieNode *child = node->children[index];
+            if (child->segmentCount > nameCount) {
+                break;
+            }
+
+            size_t depth = _metisTrieNode_MatchEdge(child, tlvName, node->segmentCount + 1, nameCount);
+            if (depth < child->segmentCount) {
+                break;
+            }
+
+            node = child;
+            if (node->entry != NULL && _metisTrieFIB_IsAcceptable(node->entry, ingressId)) {
+                longestMatchingFibEntry = node->entry;
+            }
+        }
+
+        if (longestMatchingFibEntry != NULL) {
+            // this returns a reference counted copy of the next hops
+            return metisFibEntry_GetNexthops(longestMatchingFibEntry);
+        }
+    }
+
+    // return an empty set
+    return fib->emptySet;
+}
+
+static bool
+_metisTrieFIB_AddOrUpdate(MetisFIB *generic, CPIRouteEntry *route)
+{
+    assertNotNull(generic, "Parameter fib must be non-null");
+    assertNotNull(route, "Parameter route must be non-null");
+    MetisTrieFIB *fib = metisFIB_Closure(generic);
+
+    const CCNxName *ccnxName = cpiRouteEntry_GetPrefix(route);
+    unsigned interfaceIndex = cpiRouteEntry_GetInterfaceIndex(route);
+    MetisTlvName *tlvName = metisTlvName_CreateFromCCNxName(ccnxName);
+
+    _MetisTrieNode *node = _metisTrieFIB_FindNode(fib, tlvName, true);
+    if (node->entry == NULL) {
+        node->entry = metisFibEntry_Create(tlvName);
+        fib->entryCount++;
+    }
+
+    metisFibEntry_AddNexthop(node->entry, interfaceIndex);
+    metisFibConnectionIndex_Add(fib->connectionIndex, interfaceIndex, node->entry);
+
+    // if anyone saved the name in a table, they copied it.
+    metisTlvName_Release(&tlvName);
+
+    return true;
+}
+
+static bool
+_metisTrieFIB_Remove(MetisFIB *generic, CPIRouteEntry *route)
+{
+    assertNotNull(generic, "Parameter fib must be non-null");
+    assertNotNull(route, "Parameter route must be non-null");
+    MetisTrieFIB *fib = metisFIB_Closure(generic);
+
+    bool routeRemoved = false;
+
+    const CCNxName *ccnxName = cpiRouteEntry_GetPrefix(route);
+    unsigned interfaceIndex = cpiRouteEntry_GetInterfaceIndex(route);
+    MetisTlvName *tlvName = metisTlvName_CreateFromCCNxName(ccnxName);
+
+    _MetisTrieNode *node = _metisTrieFIB_FindNode(fib, tlvName, false);
+    if (node != NULL && node->entry != NULL) {
+        metisFibEntry_RemoveNexthop(node->entry, interfaceIndex);
+        metisFibConnectionIndex_Remove(fib->connectionIndex, interfaceIndex, node->entry);
+        if (metisFibEntry_NexthopCount(node->entry) == 0) {
+            _metisTrieFIB_RemoveEntry(fib, node);
+            routeRemoved = true;
+        }
+    }
+
+    metisTlvName_Release(&tlvName);
+    return routeRemoved;
+}
+
+static size_t
+_metisTrieFIB_Length(const MetisFIB *generic)
+{
+    assertNotNull(generic, "Parameter fib must be non-null");
+    const MetisTrieFIB *fib = metisFIB_Closure(generic);
+    return fib->entryCount;
+}
+
+static MetisFibEntryList *
+_metisTrieFIB_GetEntries(const MetisFIB *generic)
+{
+    assertNotNull(generic, "Parameter fib must be non-null");
+    const MetisTrieFIB *fib = metisFIB_Closure(generic);
+
+    MetisFibEntryList *list = metisFibEntryList_Create();
+    _metisTrieFIB_AppendEntries(fib->root, list);
+    return list;
+}
+
+static void
+_metisTrieFIB_RemoveConnectionIdFromRoutes(MetisFIB *generic, unsigned connectionId)
+{
+    assertNotNull(generic, "Parameter fib must be non-null");
+    MetisTrieFIB *fib = metisFIB_Closure(generic);
+
+    // Only visit the entries that route to the connection.  The list holds a reference to
+    // each entry, so they stay valid while we remove them from the trie.
+    MetisFibEntryList *list = metisFibConnectionIndex_RemoveConnection(fib->connectionIndex, connectionId);
+    for (size_t i = 0; i < metisFibEntryList_Length(list); i++) {
+        MetisFibEntry *fibEntry = (MetisFibEntry *) metisFibEntryList_Get(list, i);
+        metisFibEntry_RemoveNexthop(fibEntry, connectionId);
+
+        // an entry with no nexthops is no longer a route
+        if (metisFibEntry_NexthopCount(fibEntry) == 0) {
+            MetisTlvName *prefix = metisFibEntry_GetPrefix(fibEntry);
+            _MetisTrieNode *node = _metisTrieFIB_FindNode(fib, prefix, false);
+            assertTrue(node != NULL && node->entry == fibEntry, "FIB entry %p not found in the trie", (void *) fibEntry);
+            _metisTrieFIB_RemoveEntry(fib, node);
+            metisTlvName_Release(&prefix);
+        }
+    }
+    metisFibEntryList_Destroy(&list);
+}
@@ -53,525 +53,237 @@
  * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
  */
 
+
 // Include the file(s) containing the functions to be tested.
 // This permits internal static functions to be visible to this Test Framework.
 #include "../metis_FIB.c"
+
 #include <LongBow/unit-test.h>
 #include <parc/algol/parc_SafeMemory.h>
-#include <parc/logging/parc_LogReporterTextStdout.h>
-
-#include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
-
-LONGBOW_TEST_RUNNER(metis_FIB)
+#include <parc/algol/parc_Memory.h>
+
+// ===============================================================================================
+// Mock FIB
+// These functions just count calls.  The Destroy interface does not actually release memeory, you
+// need to call _metisFIB_Release() yourself -- note that this is a static function with leading "_".
+
+typedef struct mock_fib {
+    unsigned countDestroy;
+    unsigned countAddOrUpdate;
+    unsigned countRemove;
+    unsigned countRemoveConnectionIdFromRoutes;
+    unsigned countMatch;
+    unsigned countLength;
+    unsigned countGetEntries;
+} _MockFIB;
+
+static void
+_mockFIBInterface_Destroy(MetisFIB **fibPtr)
 {
-    // The following Test Fixtures will run their corresponding Test Cases.
-    // Test Fixtures are run in the order specified, but all tests should be idempotent.
-    // Never rely on the execution order of tests or share state between them.
-    LONGBOW_RUN_TEST_FIXTURE(Global);
-    LONGBOW_RUN_TEST_FIXTURE(Local);
+    _MockFIB *mock = metisFIB_Closure(*fibPtr);
+    mock->countDestroy++;
+    *fibPtr = NULL;
 }
 
-// The Test Runner calls this function once before any Test Fixtures are run.
-LONGBOW_TEST_RUNNER_SETUP(metis_FIB)
+static bool
+_mockFIBInterface_AddOrUpdate(MetisFIB *fib, CPIRouteEntry *route)
 {
-    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
-    return LONGBOW_STATUS_SUCCEEDED;
+    _MockFIB *mock = metisFIB_Closure(fib);
+    mock->countAddOrUpdate++;
+    return true;
 }
 
-// The Test Runner calls this function once after all the Test Fixtures are run.
-LONGBOW_TEST_RUNNER_TEARDOWN(metis_FIB)
+static bool
+_mockFIBInterface_Remove(MetisFIB *fib, CPIRouteEntry *route)
 {
-    return LONGBOW_STATUS_SUCCEEDED;
+    _MockFIB *mock = metisFIB_Closure(fib);
+    mock->countRemove++;
+    return true;
 }
 
-LONGBOW_TEST_FIXTURE(Global)
+static void
+_mockFIBInterface_RemoveConnectionIdFromRoutes(MetisFIB *fib, unsigned connectionId)
 {
-    LONGBOW_RUN_TEST_CASE(Global, metisFib_AddOrUpdate_Add);
-    LONGBOW_RUN_TEST_CASE(Global, metisFib_AddOrUpdate_Update);
-    LONGBOW_RUN_TEST_CASE(Global, metisFib_Create_Destroy);
-
-    LONGBOW_RUN_TEST_CASE(Global, metisFib_Match_Exists);
-    LONGBOW_RUN_TEST_CASE(Global, metisFib_Match_NotExists);
-    LONGBOW_RUN_TEST_CASE(Global, metisFib_Match_ExcludeIngress);
-
-    LONGBOW_RUN_TEST_CASE(Global, metisFib_Remove_NoEntry);
-    LONGBOW_RUN_TEST_CASE(Global, metisFib_Remove_ExistsNotLast);
-    LONGBOW_RUN_TEST_CASE(Global, metisFib_Remove_ExistsIsLast);
-
-    LONGBOW_RUN_TEST_CASE(Global, metisFIB_Length);
+    _MockFIB *mock = metisFIB_Closure(fib);
+    mock->countRemoveConnectionIdFromRoutes++;
 }
 
-LONGBOW_TEST_FIXTURE_SETUP(Global)
+static const MetisNumberSet *
+_mockFIBInterface_Match(MetisFIB *fib, const MetisMessage *interestMessage)
 {
-    return LONGBOW_STATUS_SUCCEEDED;
+    _MockFIB *mock = metisFIB_Closure(fib);
+    mock->countMatch++;
+    return NULL;
 }
 
-LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+static size_t
+_mockFIBInterface_Length(const MetisFIB *fib)
 {
-    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
-    if (outstandingAllocations != 0) {
-        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
-        return LONGBOW_STATUS_MEMORYLEAK;
-    }
-    return LONGBOW_STATUS_SUCCEEDED;
+    _MockFIB *mock = metisFIB_Closure(fib);
+    mock->countLength++;
+    return 0;
 }
 
-LONGBOW_TEST_CASE(Global, metisFib_AddOrUpdate_Add)
+static MetisFibEntryList *
+_mockFIBInterface_GetEntries(const MetisFIB *fib)
 {
-    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
-    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
-    parcLogReporter_Release(&reporter);
-    MetisFIB *fib = metisFIB_Create(logger);
-    metisLogger_Release(&logger);
-
-    CCNxName *ccnxName = ccnxName_CreateFromCString("lci:/foo/bar");
-    MetisTlvName *tlvName = metisTlvName_CreateFromCCNxName(ccnxName);
-    unsigned interfaceIndex = 22;
-    CPIAddress *nexthop = NULL;
-    struct timeval *lifetime = NULL;
-    unsigned cost = 12;
-
-    CPIRouteEntry *route = cpiRouteEntry_Create(ccnxName, interfaceIndex, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-
-    metisFIB_AddOrUpdate(fib, route);
-    size_t hashCodeTableLength = parcHashCodeTable_Length(fib->tableByName);
-
-    MetisFibEntry *fibEntry = parcHashCodeTable_Get(fib->tableByName, tlvName);
-    size_t nexthopCount = metisFibEntry_NexthopCount(fibEntry);
-
-    cpiRouteEntry_Destroy(&route);
-    metisTlvName_Release(&tlvName);
-    metisFIB_Destroy(&fib);
-
-    assertTrue(hashCodeTableLength == 1, "Wrong hash table length, expected %u got %zu", 1, hashCodeTableLength);
-    assertTrue(nexthopCount == 1, "Wrong hash table length, expected %u got %zu", 1, nexthopCount);
+    _MockFIB *mock = metisFIB_Closure(fib);
+    mock->countGetEntries++;
+    return NULL;
 }
 
-LONGBOW_TEST_CASE(Global, metisFib_AddOrUpdate_Update)
+static MetisFIB *
+_mockFIB_Create(void)
 {
-    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
-    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
-    parcLogReporter_Release(&reporter);
-    MetisFIB *fib = metisFIB_Create(logger);
-    metisLogger_Release(&logger);
-
-    CCNxName *ccnxName = ccnxName_CreateFromCString("lci:/foo/bar");
-    MetisTlvName *tlvName = metisTlvName_CreateFromCCNxName(ccnxName);
-    unsigned interfaceIndex_1 = 22;
-    CPIAddress *nexthop = NULL;
-    struct timeval *lifetime = NULL;
-    unsigned cost = 12;
-
-    // ----- Add
-    CPIRouteEntry *route_1 = cpiRouteEntry_Create(ccnxName_Copy(ccnxName), interfaceIndex_1, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_AddOrUpdate(fib, route_1);
-
-    // ----- Update
-    unsigned interfaceIndex_2 = 33;
-    CPIRouteEntry *route_2 = cpiRouteEntry_Create(ccnxName_Copy(ccnxName), interfaceIndex_2, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_AddOrUpdate(fib, route_2);
-
-    // ----- Measure
-    size_t hashCodeTableLength = parcHashCodeTable_Length(fib->tableByName);
-    MetisFibEntry *fibEntry = parcHashCodeTable_Get(fib->tableByName, tlvName);
-    size_t nexthopCount = metisFibEntry_NexthopCount(fibEntry);
-
-
-    cpiRouteEntry_Destroy(&route_1);
-    cpiRouteEntry_Destroy(&route_2);
-    ccnxName_Release(&ccnxName);
-    metisTlvName_Release(&tlvName);
-    metisFIB_Destroy(&fib);
-
-    assertTrue(hashCodeTableLength == 1, "Wrong hash table length, expected %u got %zu", 1, hashCodeTableLength);
-    assertTrue(nexthopCount == 2, "Wrong hash table length, expected %u got %zu", 2, nexthopCount);
+    size_t allocation = sizeof(MetisFIB) + sizeof(_MockFIB);
+    MetisFIB *fib = parcMemory_AllocateAndClear(allocation);
+
+    fib->destroy = _mockFIBInterface_Destroy;
+    fib->addOrUpdate = _mockFIBInterface_AddOrUpdate;
+    fib->remove = _mockFIBInterface_Remove;
+    fib->removeConnectionIdFromRoutes = _mockFIBInterface_RemoveConnectionIdFromRoutes;
+    fib->match = _mockFIBInterface_Match;
+    fib->length = _mockFIBInterface_Length;
+    fib->getEntries = _mockFIBInterface_GetEntries;
+
+    fib->closure = (uint8_t *) fib + sizeof(MetisFIB);
+    return fib;
 }
 
-LONGBOW_TEST_CASE(Global, metisFib_Create_Destroy)
+static void
+_metisFIB_Release(MetisFIB **fibPtr)
 {
-    size_t beforeMemory = parcMemory_Outstanding();
-    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
-    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
-    parcLogReporter_Release(&reporter);
-    MetisFIB *fib = metisFIB_Create(logger);
-    metisLogger_Release(&logger);
+    parcMemory_Deallocate(fibPtr);
+}
 
-    metisFIB_Destroy(&fib);
-    size_t afterMemory = parcMemory_Outstanding();
+// ===============================================================================================
 
-    assertTrue(beforeMemory == afterMemory, "Memory imbalance on create/destroy: expected %zu got %zu", beforeMemory, afterMemory);
+LONGBOW_TEST_RUNNER(metis_FIB)
+{
+    LONGBOW_RUN_TEST_FIXTURE(Global);
 }
 
-/**
- * Add /hello/ouch and lookup that name
- */
-LONGBOW_TEST_CASE(Global, metisFib_Match_Exists)
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_FIB)
 {
-    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
-    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
-    parcLogReporter_Release(&reporter);
-    MetisFIB *fib = metisFIB_Create(logger);
-    CCNxName *ccnxNameToAdd = ccnxName_CreateFromCString("lci:/2=hello/0xF000=ouch");
-    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger);
-    metisLogger_Release(&logger);
-
-    unsigned interfaceIndex_1 = 22;
-    CPIAddress *nexthop = NULL;
-    struct timeval *lifetime = NULL;
-    unsigned cost = 12;
-
-    // ----- Add
-    CPIRouteEntry *routeAdd = cpiRouteEntry_Create(ccnxNameToAdd, interfaceIndex_1, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_AddOrUpdate(fib, routeAdd);
-
-    // ----- Match
-    const MetisNumberSet *nexthops = metisFIB_Match(fib, interest);
-
-    // ----- Measure
-    size_t nexthopsLength = metisNumberSet_Length(nexthops);
-
-    // ----- Cleanup
-    cpiRouteEntry_Destroy(&routeAdd);
-    metisMessage_Release(&interest);
-    metisFIB_Destroy(&fib);
-
-    // ----- Validate
-    assertTrue(nexthopsLength == 1, "Wrong nexthops length, expected %u got %zu", 1, nexthopsLength);
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
 }
 
-/**
- * Add /foo/bar to connection 10
- * Add /foo to connection 11
- * Forward an Interest /foo/bar/cat from connection 10.  Should select 11.
- */
-LONGBOW_TEST_CASE(Global, metisFib_Match_ExcludeIngress)
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_FIB)
 {
-    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
-    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
-    parcLogReporter_Release(&reporter);
-    MetisFIB *fib = metisFIB_Create(logger);
-
-    CCNxName *nameFoo = ccnxName_CreateFromCString("lci:/foo");
-    CCNxName *nameFooBar = ccnxName_CreateFromCString("lci:/foo/bar");
-
-    uint8_t encodedInterest[] = {
-        0x01, 0x00, 0x00,   37, // ver = 1, type = interest, length = 37
-        0xFF, 0x00, 0x00,    8, // hoplimit = 255, header length = 8
-        // ------------------------
-        0x00, 0x01, 0x00,   25, // type = interest, length = 25
-        // ------------------------
-        0x00, 0x00, 0x00,   21,   // type = name, length = 21
-        0x00, 0x01, 0x00,    3,   // type = name, length = 3
-        'f', 'o', 'o',
-        0x00, 0x01, 0x00,    3,   // type = name, length = 3
-        'b', 'a', 'r',
-        0x00, 0x01, 0x00,    3,   // type = name, length = 3
-        'c', 'a', 't',
-    };
-
-    MetisMessage *interest = metisMessage_CreateFromArray(encodedInterest, sizeof(encodedInterest), 10, 2, logger);
-    metisLogger_Release(&logger);
-
-    CPIAddress *nexthop = NULL;
-    struct timeval *lifetime = NULL;
-    unsigned cost = 12;
-
-    CPIRouteEntry *routeAdd;
-
-    // ----- Add long route to Interface 10
-    routeAdd = cpiRouteEntry_Create(nameFooBar, 10, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_AddOrUpdate(fib, routeAdd);
-    cpiRouteEntry_Destroy(&routeAdd);
-
-    // ----- Add short route to Interface 11
-    routeAdd = cpiRouteEntry_Create(nameFoo, 11, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_AddOrUpdate(fib, routeAdd);
-    cpiRouteEntry_Destroy(&routeAdd);
-
-    // ----- Match
-    const MetisNumberSet *nexthops = metisFIB_Match(fib, interest);
-
-    // ----- Measure
-    size_t nexthopsLength = metisNumberSet_Length(nexthops);
-
-    // ----- Validate
-    assertTrue(nexthopsLength == 1, "Wrong nexthops length, expected %u got %zu", 1, nexthopsLength);
-    bool hasEgress = metisNumberSet_Contains(nexthops, 11);
-    assertTrue(hasEgress, "Egress interface 11 not in nexthop set");
-
-    // ----- Cleanup
-    metisMessage_Release(&interest);
-    metisFIB_Destroy(&fib);
+    return LONGBOW_STATUS_SUCCEEDED;
 }
 
+// ===============================================================================================
 
-/**
- * Add /hello/ouch and lookup /party/ouch
- */
-LONGBOW_TEST_CASE(Global, metisFib_Match_NotExists)
+LONGBOW_TEST_FIXTURE(Global)
 {
-    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
-    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
-    parcLogReporter_Release(&reporter);
-    MetisFIB *fib = metisFIB_Create(logger);
-    CCNxName *ccnxNameToAdd = ccnxName_CreateFromCString("lci:/2=hello/0xF000=ouch");
-
-    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithOtherName, sizeof(metisTestDataV0_InterestWithOtherName), 1, 2, logger);
-    metisLogger_Release(&logger);
-
-    unsigned interfaceIndex_1 = 22;
-    CPIAddress *nexthop = NULL;
-    struct timeval *lifetime = NULL;
-    unsigned cost = 12;
-
-    // ----- Add
-    CPIRouteEntry *routeAdd = cpiRouteEntry_Create(ccnxNameToAdd, interfaceIndex_1, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_AddOrUpdate(fib, routeAdd);
-
-    // ----- Match
-    const MetisNumberSet *nexthops = metisFIB_Match(fib, interest);
-
-    // ----- Measure
-    size_t nexthopsLength = metisNumberSet_Length(nexthops);
-
-    // ----- Cleanup
-    cpiRouteEntry_Destroy(&routeAdd);
-    metisMessage_Release(&interest);
-    metisFIB_Destroy(&fib);
-
-    // ----- Validate
-    assertTrue(nexthopsLength == 0, "Wrong nexthops length, expected %u got %zu", 0, nexthopsLength);
+    LONGBOW_RUN_TEST_CASE(Global, metisFIB_Closure);
+    LONGBOW_RUN_TEST_CASE(Global, metisFIB_Destroy);
+    LONGBOW_RUN_TEST_CASE(Global, metisFIB_AddOrUpdate);
+    LONGBOW_RUN_TEST_CASE(Global, metisFIB_Remove);
+    LONGBOW_RUN_TEST_CASE(Global, metisFIB_RemoveConnectionIdFromRoutes);
+    LONGBOW_RUN_TEST_CASE(Global, metisFIB_Match);
+    LONGBOW_RUN_TEST_CASE(Global, metisFIB_Length);
+    LONGBOW_RUN_TEST_CASE(Global, metisFIB_GetEntries);
 }
 
-/**
- * Add /foo/bar and try to remove /baz
- */
-LONGBOW_TEST_CASE(Global, metisFib_Remove_NoEntry)
+LONGBOW_TEST_FIXTURE_SETUP(Global)
 {
-    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
-    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
-    parcLogReporter_Release(&reporter);
-    MetisFIB *fib = metisFIB_Create(logger);
-    metisLogger_Release(&logger);
-
-    CCNxName *ccnxNameToAdd = ccnxName_CreateFromCString("lci:/foo/bar");
-    CCNxName *ccnxNameToRemove = ccnxName_CreateFromCString("lci:/baz");
-    MetisTlvName *tlvNameToCheck = metisTlvName_CreateFromCCNxName(ccnxNameToAdd);
-    unsigned interfaceIndex_1 = 22;
-    CPIAddress *nexthop = NULL;
-    struct timeval *lifetime = NULL;
-    unsigned cost = 12;
-
-    // ----- Add
-    CPIRouteEntry *routeAdd = cpiRouteEntry_Create(ccnxNameToAdd, interfaceIndex_1, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_AddOrUpdate(fib, routeAdd);
-
-    // ----- Remove
-    CPIRouteEntry *routeRemove = cpiRouteEntry_Create(ccnxNameToRemove, interfaceIndex_1, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_Remove(fib, routeRemove);
-
-    // ----- Measure
-    size_t hashCodeTableLength = parcHashCodeTable_Length(fib->tableByName);
-    MetisFibEntry *fibEntry = parcHashCodeTable_Get(fib->tableByName, tlvNameToCheck);
-    size_t nexthopCount = metisFibEntry_NexthopCount(fibEntry);
-
-    // ----- Cleanup
-    cpiRouteEntry_Destroy(&routeAdd);
-    cpiRouteEntry_Destroy(&routeRemove);
-    metisTlvName_Release(&tlvNameToCheck);
-    metisFIB_Destroy(&fib);
-
-    // ----- Validate
-    assertTrue(hashCodeTableLength == 1, "Wrong hash table length, expected %u got %zu", 1, hashCodeTableLength);
-    assertTrue(nexthopCount == 1, "Wrong hash table length, expected %u got %zu", 1, nexthopCount);
+    return LONGBOW_STATUS_SUCCEEDED;
 }
 
-LONGBOW_TEST_CASE(Global, metisFib_Remove_ExistsNotLast)
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
 {
-    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
-    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
-    parcLogReporter_Release(&reporter);
-    MetisFIB *fib = metisFIB_Create(logger);
-    metisLogger_Release(&logger);
-
-    CCNxName *ccnxNameToAdd = ccnxName_CreateFromCString("lci:/foo/bar");
-    CCNxName *ccnxNameToRemove = ccnxName_CreateFromCString("lci:/foo/bar");
-    MetisTlvName *tlvNameToCheck = metisTlvName_CreateFromCCNxName(ccnxNameToAdd);
-    unsigned interfaceIndex_1 = 11;
-    unsigned interfaceIndex_2 = 22;
-    CPIAddress *nexthop = NULL;
-    struct timeval *lifetime = NULL;
-    unsigned cost = 12;
-
-    // ----- Add two next hops
-    CPIRouteEntry *routeAdd1 = cpiRouteEntry_Create(ccnxName_Copy(ccnxNameToAdd), interfaceIndex_1, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_AddOrUpdate(fib, routeAdd1);
-
-    CPIRouteEntry *routeAdd2 = cpiRouteEntry_Create(ccnxNameToAdd, interfaceIndex_2, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_AddOrUpdate(fib, routeAdd2);
-
-    // ----- Remove
-    CPIRouteEntry *routeRemove = cpiRouteEntry_Create(ccnxNameToRemove, interfaceIndex_1, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_Remove(fib, routeRemove);
-
-    // ----- Measure
-    size_t hashCodeTableLength = parcHashCodeTable_Length(fib->tableByName);
-    MetisFibEntry *fibEntry = parcHashCodeTable_Get(fib->tableByName, tlvNameToCheck);
-    size_t nexthopCount = metisFibEntry_NexthopCount(fibEntry);
-
-    // ----- Cleanup
-    cpiRouteEntry_Destroy(&routeAdd1);
-    cpiRouteEntry_Destroy(&routeAdd2);
-    cpiRouteEntry_Destroy(&routeRemove);
-    metisTlvName_Release(&tlvNameToCheck);
-    metisFIB_Destroy(&fib);
-
-    // ----- Validate
-    assertTrue(hashCodeTableLength == 1, "Wrong hash table length, expected %u got %zu", 1, hashCodeTableLength);
-    assertTrue(nexthopCount == 1, "Wrong hash table length, expected %u got %zu", 1, nexthopCount);
+    if (parcSafeMemory_ReportAllocation(STDOUT_FILENO) != 0) {
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
 }
 
-/**
- * Remove the last nexthop for a route.  should remove the route
- */
-LONGBOW_TEST_CASE(Global, metisFib_Remove_ExistsIsLast)
+LONGBOW_TEST_CASE(Global, metisFIB_Closure)
 {
-    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
-    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
-    parcLogReporter_Release(&reporter);
-    MetisFIB *fib = metisFIB_Create(logger);
-    metisLogger_Release(&logger);
-
-    CCNxName *ccnxNameToAdd = ccnxName_CreateFromCString("lci:/foo/bar");
-    CCNxName *ccnxNameToRemove = ccnxName_CreateFromCString("lci:/foo/bar");
-    MetisTlvName *tlvNameToCheck = metisTlvName_CreateFromCCNxName(ccnxNameToAdd);
-    unsigned interfaceIndex_1 = 22;
-    CPIAddress *nexthop = NULL;
-    struct timeval *lifetime = NULL;
-    unsigned cost = 12;
-
-    // ----- Add
-    CPIRouteEntry *routeAdd = cpiRouteEntry_Create(ccnxNameToAdd, interfaceIndex_1, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_AddOrUpdate(fib, routeAdd);
-
-    // ----- Remove
-    CPIRouteEntry *routeRemove = cpiRouteEntry_Create(ccnxNameToRemove, interfaceIndex_1, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_Remove(fib, routeRemove);
-
-    // ----- Measure
-    size_t hashCodeTableLength = parcHashCodeTable_Length(fib->tableByName);
-
-    // ----- Cleanup
-    cpiRouteEntry_Destroy(&routeAdd);
-    cpiRouteEntry_Destroy(&routeRemove);
-    metisTlvName_Release(&tlvNameToCheck);
-    metisFIB_Destroy(&fib);
-
-    // ----- Validate
-    assertTrue(hashCodeTableLength == 0, "Wrong hash table length, expected %u got %zu", 0, hashCodeTableLength);
+    MetisFIB *fib = _mockFIB_Create();
+    _MockFIB *mock = metisFIB_Closure(fib);
+    assertTrue(mock == fib->closure, "Wrong pointer expected %p got %p", fib->closure, mock);
+    _metisFIB_Release(&fib);
 }
 
-LONGBOW_TEST_CASE(Global, metisFIB_Length)
+LONGBOW_TEST_CASE(Global, metisFIB_Destroy)
 {
-    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
-    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
-    parcLogReporter_Release(&reporter);
-    MetisFIB *fib = metisFIB_Create(logger);
-
-    //    CCNxName *ccnxNameToAdd = ccnxName_CreateFromCString("lci:/%02=hello/%F0%00=ouch");
-    CCNxName *ccnxNameToAdd = ccnxName_CreateFromCString("lci:/2=hello/0xF000=ouch");
-    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger);
-    metisLogger_Release(&logger);
-
-    unsigned interfaceIndex_1 = 22;
-    CPIAddress *nexthop = NULL;
-    struct timeval *lifetime = NULL;
-    unsigned cost = 12;
-
-    // ----- Add
-    CPIRouteEntry *routeAdd = cpiRouteEntry_Create(ccnxNameToAdd, interfaceIndex_1, nexthop, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, lifetime, cost);
-    metisFIB_AddOrUpdate(fib, routeAdd);
-
-    // ----- Measure
-    size_t tableLength = metisFIB_Length(fib);
-
-    // ----- Cleanup
-    cpiRouteEntry_Destroy(&routeAdd);
-    metisMessage_Release(&interest);
+    MetisFIB *fib = _mockFIB_Create();
+    MetisFIB *original = fib;
+    _MockFIB *mock = metisFIB_Closure(fib);
     metisFIB_Destroy(&fib);
 
-    // ----- Validate
-    assertTrue(tableLength == 1, "Wrong table length, expected %u got %zu", 1, tableLength);
+    assertTrue(mock->countDestroy == 1, "Wrong count expected 1 got %u", mock->countDestroy);
+    _metisFIB_Release(&original);
 }
 
-// ====================================================================
-
-LONGBOW_TEST_FIXTURE(Local)
+LONGBOW_TEST_CASE(Global, metisFIB_AddOrUpdate)
 {
-    LONGBOW_RUN_TEST_CASE(Local, _hashTableFunction_FibEntryDestroyer);
-    LONGBOW_RUN_TEST_CASE(Local, _hashTableFunction_TlvNameDestroyer);
-    LONGBOW_RUN_TEST_CASE(Local, _metisFIB_CreateFibEntry);
-}
+    MetisFIB *fib = _mockFIB_Create();
+    _MockFIB *mock = metisFIB_Closure(fib);
+    metisFIB_AddOrUpdate(fib, NULL);
 
-LONGBOW_TEST_FIXTURE_SETUP(Local)
-{
-    return LONGBOW_STATUS_SUCCEEDED;
+    assertTrue(mock->countAddOrUpdate == 1, "Wrong count expected 1 got %u", mock->countAddOrUpdate);
+    _metisFIB_Release(&fib);
 }
 
-LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+LONGBOW_TEST_CASE(Global, metisFIB_Remove)
 {
-    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
-    if (outstandingAllocations != 0) {
-        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
-        return LONGBOW_STATUS_MEMORYLEAK;
-    }
-    return LONGBOW_STATUS_SUCCEEDED;
+    MetisFIB *fib = _mockFIB_Create();
+    _MockFIB *mock = metisFIB_Closure(fib);
+    metisFIB_Remove(fib, NULL);
+
+    assertTrue(mock->countRemove == 1, "Wrong count expected 1 got %u", mock->countRemove);
+    _metisFIB_Release(&fib);
 }
 
-LONGBOW_TEST_CASE(Local, _hashTableFunction_FibEntryDestroyer)
+LONGBOW_TEST_CASE(Global, metisFIB_RemoveConnectionIdFromRoutes)
 {
-    CCNxName *ccnxName = ccnxName_CreateFromCString("lci:/foo/bar");
-    MetisTlvName *tlvName = metisTlvName_CreateFromCCNxName(ccnxName);
-    MetisFibEntry *fibEntry = metisFibEntry_Create(tlvName);
-
-    _hashTableFunction_FibEntryDestroyer((void **) &fibEntry);
+    MetisFIB *fib = _mockFIB_Create();
+    _MockFIB *mock = metisFIB_Closure(fib);
+    metisFIB_RemoveConnectionIdFromRoutes(fib, 1);
 
-    metisTlvName_Release(&tlvName);
-    ccnxName_Release(&ccnxName);
-    assertTrue(parcMemory_Outstanding() == 0, "Memory imbalance after hashTableFunction_TlvNameDestroyer: %u", parcMemory_Outstanding());
+    assertTrue(mock->countRemoveConnectionIdFromRoutes == 1, "Wrong count expected 1 got %u", mock->countRemoveConnectionIdFromRoutes);
+    _metisFIB_Release(&fib);
 }
 
-LONGBOW_TEST_CASE(Local, _hashTableFunction_TlvNameDestroyer)
+LONGBOW_TEST_CASE(Global, metisFIB_Match)
 {
-    CCNxName *ccnxName = ccnxName_CreateFromCString("lci:/foo/bar");
-    MetisTlvName *tlvName = metisTlvName_CreateFromCCNxName(ccnxName);
-
-    _hashTableFunction_TlvNameDestroyer((void **) &tlvName);
-    ccnxName_Release(&ccnxName);
+    MetisFIB *fib = _mockFIB_Create();
+    _MockFIB *mock = metisFIB_Closure(fib);
+    metisFIB_Match(fib, NULL);
 
-    assertTrue(parcMemory_Outstanding() == 0, "Memory imbalance after hashTableFunction_TlvNameDestroyer: %u", parcMemory_Outstanding());
+    assertTrue(mock->countMatch == 1, "Wrong count expected 1 got %u", mock->countMatch);
+    _metisFIB_Release(&fib);
 }
 
-LONGBOW_TEST_CASE(Local, _metisFIB_CreateFibEntry)
+LONGBOW_TEST_CASE(Global, metisFIB_Length)
 {
-    CCNxName *ccnxName = ccnxName_CreateFromCString("lci:/foo/bar");
-    MetisTlvName *tlvName = metisTlvName_CreateFromCCNxName(ccnxName);
-    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
-    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
-    parcLogReporter_Release(&reporter);
-    MetisFIB *fib = metisFIB_Create(logger);
-    metisLogger_Release(&logger);
+    MetisFIB *fib = _mockFIB_Create();
+    _MockFIB *mock = metisFIB_Closure(fib);
+    metisFIB_Length(fib);
 
-    _metisFIB_CreateFibEntry(fib, tlvName);
-    size_t hashCodeTableLength = parcHashCodeTable_Length(fib->tableByName);
+    assertTrue(mock->countLength == 1, "Wrong count expected 1 got %u", mock->countLength);
+    _metisFIB_Release(&fib);
+}
 
-    metisFIB_Destroy(&fib);
-    metisTlvName_Release(&tlvName);
-    ccnxName_Release(&ccnxName);
+LONGBOW_TEST_CASE(Global, metisFIB_GetEntries)
+{
+    MetisFIB *fib = _mockFIB_Create();
+    _MockFIB *mock = metisFIB_Closure(fib);
+    metisFIB_GetEntries(fib);
 
-    assertTrue(hashCodeTableLength == 1, "Wrong hash table size, expected %u got %zu", 1, hashCodeTableLength);
+    assertTrue(mock->countGetEntries == 1, "Wrong count expected 1 got %u", mock->countGetEntries);
+    _metisFIB_Release(&fib);
 }
 
+// ===============================================================================================
+
 int
 main(int argc, char *argv[])
 {
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metis_FibConnectionIndex.c"
+
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+static MetisFibEntry *
+_createFibEntry(const char *uri)
+{
+    CCNxName *ccnxName = ccnxName_CreateFromCString(uri);
+    MetisTlvName *tlvName = metisTlvName_CreateFromCCNxName(ccnxName);
+    MetisFibEntry *fibEntry = metisFibEntry_Create(tlvName);
+    metisTlvName_Release(&tlvName);
+    ccnxName_Release(&ccnxName);
+    return fibEntry;
+}
+
+LONGBOW_TEST_RUNNER(metis_FibConnectionIndex)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_FibConnectionIndex)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_FibConnectionIndex)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// ====================================================================
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisFibConnectionIndex_Create_Destroy);
+    LONGBOW_RUN_TEST_CASE(Global, metisFibConnectionIndex_Add);
+    LONGBOW_RUN_TEST_CASE(Global, metisFibConnectionIndex_Add_Duplicate);
+    LONGBOW_RUN_TEST_CASE(Global, metisFibConnectionIndex_Remove);
+    LONGBOW_RUN_TEST_CASE(Global, metisFibConnectionIndex_Remove_NotPresent);
+    LONGBOW_RUN_TEST_CASE(Global, metisFibConnectionIndex_RemoveConnection);
+    LONGBOW_RUN_TEST_CASE(Global, metisFibConnectionIndex_RemoveConnection_Unknown);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, metisFibConnectionIndex_Create_Destroy)
+{
+    MetisFibConnectionIndex *index = metisFibConnectionIndex_Create();
+    assertNotNull(index, "Got null index from Create");
+    metisFibConnectionIndex_Destroy(&index);
+    assertNull(index, "Destroy did not null the pointer");
+}
+
+LONGBOW_TEST_CASE(Global, metisFibConnectionIndex_Add)
+{
+    MetisFibConnectionIndex *index = metisFibConnectionIndex_Create();
+    MetisFibEntry *a = _createFibEntry("lci:/a");
+    MetisFibEntry *b = _createFibEntry("lci:/b");
+
+    metisFibConnectionIndex_Add(index, 1, a);
+    metisFibConnectionIndex_Add(index, 1, b);
+    metisFibConnectionIndex_Add(index, 2, b);
+
+    size_t count1 = metisFibConnectionIndex_Count(index, 1);
+    size_t count2 = metisFibConnectionIndex_Count(index, 2);
+    size_t count3 = metisFibConnectionIndex_Count(index, 3);
+
+    metisFibConnectionIndex_Destroy(&index);
+    metisFibEntry_Release(&a);
+    metisFibEntry_Release(&b);
+
+    assertTrue(count1 == 2, "Wrong count for connection 1, expected 2 got %zu", count1);
+    assertTrue(count2 == 1, "Wrong count for connection 2, expected 1 got %zu", count2);
+    assertTrue(count3 == 0, "Wrong count for connection 3, expected 0 got %zu", count3);
+}
+
+LONGBOW_TEST_CASE(Global, metisFibConnectionIndex_Add_Duplicate)
+{
+    MetisFibConnectionIndex *index = metisFibConnectionIndex_Create();
+    MetisFibEntry *a = _createFibEntry("lci:/a");
+
+    metisFibConnectionIndex_Add(index, 1, a);
+    metisFibConnectionIndex_Add(index, 1, a);
+    size_t count = metisFibConnectionIndex_Count(index, 1);
+
+    metisFibConnectionIndex_Destroy(&index);
+    metisFibEntry_Release(&a);
+
+    assertTrue(count == 1, "Wrong count, expected 1 got %zu", count);
+}
+
+LONGBOW_TEST_CASE(Global, metisFibConnectionIndex_Remove)
+{
+    MetisFibConnectionIndex *index = metisFibConnectionIndex_Create();
+    MetisFibEntry *a = _createFibEntry("lci:/a");
+    MetisFibEntry *b = _createFibEntry("lci:/b");
+
+    metisFibConnectionIndex_Add(index, 1, a);
+    metisFibConnectionIndex_Add(index, 1, b);
+    metisFibConnectionIndex_Remove(index, 1, a);
+    size_t countAfterFirst = metisFibConnectionIndex_Count(index, 1);
+
+    metisFibConnectionIndex_Remove(index, 1, b);
+    size_t countAfterSecond = metisFibConnectionIndex_Count(index, 1);
+    size_t tableLength = parcHashCodeTable_Length(index->tableById);
+
+    metisFibConnectionIndex_Destroy(&index);
+    metisFibEntry_Release(&a);
+    metisFibEntry_Release(&b);
+
+    assertTrue(countAfterFirst == 1, "Wrong count, expected 1 got %zu", countAfterFirst);
+    assertTrue(countAfterSecond == 0, "Wrong count, expected 0 got %zu", countAfterSecond);
+    assertTrue(tableLength == 0, "Connection with no routes should be removed, table length %zu", tableLength);
+}
+
+LONGBOW_TEST_CASE(Global, metisFibConnectionIndex_Remove_NotPresent)
+{
+    MetisFibConnectionIndex *index = metisFibConnectionIndex_Create();
+    MetisFibEntry *a = _createFibEntry("lci:/a");
+    MetisFibEntry *b = _createFibEntry("lci:/b");
+
+    metisFibConnectionIndex_Add(index, 1, a);
+    metisFibConnectionIndex_Remove(index, 1, b);
+    metisFibConnectionIndex_Remove(index, 2, a);
+    size_t count = metisFibConnectionIndex_Count(index, 1);
+
+    metisFibConnectionIndex_Destroy(&index);
+    metisFibEntry_Release(&a);
+    metisFibEntry_Release(&b);
+
+    assertTrue(count == 1, "Wrong count, expected 1 got %zu", count);
+}
+
+LONGBOW_TEST_CASE(Global, metisFibConnectionIndex_RemoveConnection)
+{
+    MetisFibConnectionIndex *index = metisFibConnectionIndex_Create();
+    MetisFibEntry *a = _createFibEntry("lci:/a");
+    MetisFibEntry *b = _createFibEntry("lci:/b");
+
+    metisFibConnectionIndex_Add(index, 1, a);
+    metisFibConnectionIndex_Add(index, 1, b);
+    metisFibConnectionIndex_Add(index, 2, b);
+
+    MetisFibEntryList *list = metisFibConnectionIndex_RemoveConnection(index, 1);
+    size_t listLength = metisFibEntryList_Length(list);
+    const MetisFibEntry *first = metisFibEntryList_Get(list, 0);
+    const MetisFibEntry *second = metisFibEntryList_Get(list, 1);
+    bool hasBoth = (first == a && second == b) || (first == b && second == a);
+    size_t count1 = metisFibConnectionIndex_Count(index, 1);
+    size_t count2 = metisFibConnectionIndex_Count(index, 2);
+
+    metisFibEntryList_Destroy(&list);
+    metisFibConnectionIndex_Destroy(&index);
+    metisFibEntry_Release(&a);
+    metisFibEntry_Release(&b);
+
+    assertTrue(listLength == 2, "Wrong list length, expected 2 got %zu", listLength);
+    assertTrue(hasBoth, "List should contain both entries");
+    assertTrue(count1 == 0, "Connection 1 should be removed, got count %zu", count1);
+    assertTrue(count2 == 1, "Connection 2 should be unchanged, got count %zu", count2);
+}
+
+LONGBOW_TEST_CASE(Global, metisFibConnectionIndex_RemoveConnection_Unknown)
+{
+    MetisFibConnectionIndex *index = metisFibConnectionIndex_Create();
+    MetisFibEntryList *list = metisFibConnectionIndex_RemoveConnection(index, 99);
+    size_t listLength = metisFibEntryList_Length(list);
+
+    metisFibEntryList_Destroy(&list);
+    metisFibConnectionIndex_Destroy(&index);
+
+    assertTrue(listLength == 0, "Wrong list length, expected 0 got %zu", listLength);
+}
+
+// ====================================================================
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _metisConnectionRoutes_Grow);
+    LONGBOW_RUN_TEST_CASE(Local, _metisConnectionRoutes_Remove);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/**
+ * Use fake pointers, as the set never dereferences them
+ */
+LONGBOW_TEST_CASE(Local, _metisConnectionRoutes_Grow)
+{
+    _MetisConnectionRoutes *routes = _metisConnectionRoutes_Create(1);
+    const size_t entries = 1000;
+
+    for (size_t i = 1; i <= entries; i++) {
+        _metisConnectionRoutes_Add(routes, (const MetisFibEntry *) (uintptr_t) (i * 16));
+    }
+
+    assertTrue(routes->count == entries, "Wrong count, expected %zu got %zu", entries, routes->count);
+    assertTrue(routes->capacity >= 2 * entries, "Load factor too high, capacity %zu", routes->capacity);
+
+    for (size_t i = 1; i <= entries; i++) {
+        const MetisFibEntry *fake = (const MetisFibEntry *) (uintptr_t) (i * 16);
+        size_t slot = _metisConnectionRoutes_Find(routes, fake);
+        assertTrue(routes->slots[slot] == fake, "Entry %zu not found after growing", i);
+    }
+
+    void *routesPtr = routes;
+    _hashTableFunction_ConnectionRoutesDestroyer(&routesPtr);
+}
+
+/**
+ * Removing from the middle of probe chains must not lose the other entries
+ */
+LONGBOW_TEST_CASE(Local, _metisConnectionRoutes_Remove)
+{
+    _MetisConnectionRoutes *routes = _metisConnectionRoutes_Create(1);
+    const size_t entries = 500;
+
+    for (size_t i = 1; i <= entries; i++) {
+        _metisConnectionRoutes_Add(routes, (const MetisFibEntry *) (uintptr_t) (i * 16));
+    }
+
+    // remove the odd ones
+    for (size_t i = 1; i <= entries; i += 2) {
+        bool removed = _metisConnectionRoutes_Remove(routes, (const MetisFibEntry *) (uintptr_t) (i * 16));
+        assertTrue(removed, "Entry %zu should have been removed", i);
+    }
+
+    assertTrue(routes->count == entries / 2, "Wrong count, expected %zu got %zu", entries / 2, routes->count);
+
+    for (size_t i = 1; i <= entries; i++) {
+        const MetisFibEntry *fake = (const MetisFibEntry *) (uintptr_t) (i * 16);
+        size_t slot = _metisConnectionRoutes_Find(routes, fake);
+        bool present = (routes->slots[slot] == fake);
+        assertTrue(present == (i % 2 == 0), "Entry %zu has wrong membership %d", i, present);
+    }
+
+    void *routesPtr = routes;
+    _hashTableFunction_ConnectionRoutesDestroyer(&routesPtr);
+}
+
+// ====================================================================
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_FibConnectionIndex);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -59,8 +59,11 @@
 #include <LongBow/unit-test.h>
 
 #include <parc/algol/parc_SafeMemory.h>
+#include <parc/algol/parc_Hash.h>
 #include <parc/logging/parc_LogReporterTextStdout.h>
 
+#include <ccnx/forwarder/metis/processor/metis_HashTableFunction.h>
+
 #include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
 
 LONGBOW_TEST_RUNNER(metis_MatchingRulesTable)
@@ -97,6 +100,7 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisMatchingRulesTable_AddToAllTables);
 
     LONGBOW_RUN_TEST_CASE(Global, metisMatchingRulesTable_Get);
+    LONGBOW_RUN_TEST_CASE(Global, metisMatchingRulesTable_Prefetch);
     LONGBOW_RUN_TEST_CASE(Global, metisMatchingRulesTable_RemoveFromBest);
     LONGBOW_RUN_TEST_CASE(Global, metisMatchingRulesTable_RemoveFromAll);
 
@@ -132,12 +136,14 @@ LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_Add_ByName)
     void *data = (void *) 0x01;
 
     metisMatchingRulesTable_AddToBestTable(rulesTable, interest, data);
-    size_t tableLength = parcHashCodeTable_Length(rulesTable->tableByName);
+    size_t tableLength = metisMatchingRulesTable_Length(rulesTable);
+    void *test = metisMatchingRulesTable_Get(rulesTable, interest);
 
     metisMatchingRulesTable_Destroy(&rulesTable);
     metisMessage_Release(&interest);
 
-    assertTrue(tableLength == 1, "tableByName wrong length, expected %u got %zu", 1, tableLength);
+    assertTrue(tableLength == 1, "table wrong length, expected %u got %zu", 1, tableLength);
+    assertTrue(test == data, "Get returned wrong data, expected %p got %p", data, test);
 }
 
 LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_Add_ByNameAndKeyId)
@@ -152,12 +158,14 @@ LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_Add_ByNameAndKeyId)
     void *data = (void *) 0x01;
 
     metisMatchingRulesTable_AddToBestTable(rulesTable, interest, data);
-    size_t tableLength = parcHashCodeTable_Length(rulesTable->tableByNameAndKeyId);
+    size_t tableLength = metisMatchingRulesTable_Length(rulesTable);
+    void *test = metisMatchingRulesTable_Get(rulesTable, interest);
 
     metisMatchingRulesTable_Destroy(&rulesTable);
     metisMessage_Release(&interest);
 
-    assertTrue(tableLength == 1, "tableByNameAndKeyId wrong length, expected %u got %zu", 1, tableLength);
+    assertTrue(tableLength == 1, "table wrong length, expected %u got %zu", 1, tableLength);
+    assertTrue(test == data, "Get returned wrong data, expected %p got %p", data, test);
 }
 
 LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_Add_ByNameAndObjectHash)
@@ -172,12 +180,14 @@ LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_Add_ByNameAndObjectHash)
     void *data = (void *) 0x01;
 
     metisMatchingRulesTable_AddToBestTable(rulesTable, interest, data);
-    size_t tableLength = parcHashCodeTable_Length(rulesTable->tableByNameAndObjectHash);
+    size_t tableLength = metisMatchingRulesTable_Length(rulesTable);
+    void *test = metisMatchingRulesTable_Get(rulesTable, interest);
 
     metisMatchingRulesTable_Destroy(&rulesTable);
     metisMessage_Release(&interest);
 
-    assertTrue(tableLength == 1, "tableByNameAndObjectHash wrong length, expected %u got %zu", 1, tableLength);
+    assertTrue(tableLength == 1, "table wrong length, expected %u got %zu", 1, tableLength);
+    assertTrue(test == data, "Get returned wrong data, expected %p got %p", data, test);
 }
 
 LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_AddToAllTables)
@@ -192,8 +202,11 @@ LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_AddToAllTables)
     void *data = (void *) 0x01;
 
     metisMatchingRulesTable_AddToAllTables(rulesTable, interest, data);
-    size_t tableLength = parcHashCodeTable_Length(rulesTable->tableByNameAndObjectHash);
-    assertTrue(tableLength == 1, "tableToAllTables wrong length, expected %u got %zu", 1, tableLength);
+
+    // indexed by name, by name and object hash, and by name and keyid if it has one
+    size_t expected = metisMessage_HasKeyId(interest) ? 3 : 2;
+    size_t tableLength = metisMatchingRulesTable_Length(rulesTable);
+    assertTrue(tableLength == expected, "tableToAllTables wrong length, expected %zu got %zu", expected, tableLength);
 
     metisMatchingRulesTable_Destroy(&rulesTable);
     metisMessage_Release(&interest);
@@ -230,6 +243,31 @@ LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_Get)
     assertTrue(data == test, "metisMatchingRulesTable_Get returned wrong result, expected %p got %p", data, test);
 }
 
+LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_Prefetch)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 1, logger);
+    metisLogger_Release(&logger);
+    MetisMatchingRulesTable *rulesTable = metisMatchingRulesTable_Create(NULL);
+    void *data = (void *) 0x01;
+
+    // a prefetch on an empty table and on the stored name is only a hint, it must not change the table
+    metisMatchingRulesTable_Prefetch(rulesTable, interest);
+    metisMatchingRulesTable_AddToBestTable(rulesTable, interest, data);
+    metisMatchingRulesTable_Prefetch(rulesTable, interest);
+
+    size_t length = metisMatchingRulesTable_Length(rulesTable);
+    void *test = metisMatchingRulesTable_Get(rulesTable, interest);
+
+    metisMatchingRulesTable_Destroy(&rulesTable);
+    metisMessage_Release(&interest);
+
+    assertTrue(length == 1, "Wrong length, expected 1 got %zu", length);
+    assertTrue(data == test, "metisMatchingRulesTable_Get returned wrong result, expected %p got %p", data, test);
+}
+
 LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_RemoveFromAll)
 {
     MetisMatchingRulesTable *rulesTable = metisMatchingRulesTable_Create(NULL);
@@ -241,10 +279,10 @@ LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_RemoveFromAll)
     metisLogger_Release(&logger);
     void *data = (void *) 0x01;
 
-    size_t before = parcHashCodeTable_Length(rulesTable->tableByName);
-    parcHashCodeTable_Add(rulesTable->tableByName, interest, data);
+    size_t before = metisMatchingRulesTable_Length(rulesTable);
+    metisMatchingRulesTable_AddToAllTables(rulesTable, interest, data);
     metisMatchingRulesTable_RemoveFromAll(rulesTable, interest);
-    size_t after = parcHashCodeTable_Length(rulesTable->tableByName);
+    size_t after = metisMatchingRulesTable_Length(rulesTable);
 
     metisMessage_Release(&interest);
     metisMatchingRulesTable_Destroy(&rulesTable);
@@ -263,10 +301,10 @@ LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_RemoveFromBest)
     metisLogger_Release(&logger);
     void *data = (void *) 0x01;
 
-    size_t before = parcHashCodeTable_Length(rulesTable->tableByName);
-    parcHashCodeTable_Add(rulesTable->tableByName, interest, data);
+    size_t before = metisMatchingRulesTable_Length(rulesTable);
+    metisMatchingRulesTable_AddToBestTable(rulesTable, interest, data);
     metisMatchingRulesTable_RemoveFromBest(rulesTable, interest);
-    size_t after = parcHashCodeTable_Length(rulesTable->tableByName);
+    size_t after = metisMatchingRulesTable_Length(rulesTable);
 
     metisMessage_Release(&interest);
     metisMatchingRulesTable_Destroy(&rulesTable);
@@ -284,10 +322,10 @@ LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_GetUnion_NoMatch)
     MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 1, logger);
     metisLogger_Release(&logger);
 
-    PARCArrayList *list = metisMatchingRulesTable_GetUnion(rulesTable, object);
-    assertTrue(parcArrayList_Size(list) == 0, "Incorrect result length, expected %u got %zu", 0, parcArrayList_Size(list));
+    void *matches[METIS_MATCHING_RULES_TABLE_MAX_MATCHES];
+    size_t count = metisMatchingRulesTable_GetUnion(rulesTable, object, matches);
+    assertTrue(count == 0, "Incorrect result length, expected %u got %zu", 0, count);
 
-    parcArrayList_Destroy(&list);
     metisMessage_Release(&object);
     metisMatchingRulesTable_Destroy(&rulesTable);
 }
@@ -308,11 +346,11 @@ LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_GetUnion_1Table)
     // now retrieve it with a matching content object
     MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 4, logger);
 
-    PARCArrayList *list = metisMatchingRulesTable_GetUnion(rulesTable, object);
-    assertTrue(parcArrayList_Size(list) == 1, "Incorrect result length, expected %u got %zu", 1, parcArrayList_Size(list));
+    void *matches[METIS_MATCHING_RULES_TABLE_MAX_MATCHES];
+    size_t count = metisMatchingRulesTable_GetUnion(rulesTable, object, matches);
+    assertTrue(count == 1, "Incorrect result length, expected %u got %zu", 1, count);
 
     metisLogger_Release(&logger);
-    parcArrayList_Destroy(&list);
     metisMessage_Release(&object);
     metisMessage_Release(&interestByName);
     metisMatchingRulesTable_Destroy(&rulesTable);
@@ -336,11 +374,11 @@ LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_GetUnion_2Tables)
     // now retrieve it with a matching content object
     MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 4, logger);
 
-    PARCArrayList *list = metisMatchingRulesTable_GetUnion(rulesTable, object);
-    assertTrue(parcArrayList_Size(list) == 2, "Incorrect result length, expected %u got %zu", 2, parcArrayList_Size(list));
+    void *matches[METIS_MATCHING_RULES_TABLE_MAX_MATCHES];
+    size_t count = metisMatchingRulesTable_GetUnion(rulesTable, object, matches);
+    assertTrue(count == 2, "Incorrect result length, expected %u got %zu", 2, count);
 
     metisLogger_Release(&logger);
-    parcArrayList_Destroy(&list);
     metisMessage_Release(&object);
     metisMessage_Release(&interestByName);
     metisMessage_Release(&interestByNameAndKeyId);
@@ -367,11 +405,11 @@ LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_GetUnion_3Tables)
     // now retrieve it with a matching content object
     MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 4, logger);
 
-    PARCArrayList *list = metisMatchingRulesTable_GetUnion(rulesTable, object);
-    assertTrue(parcArrayList_Size(list) == 3, "Incorrect result length, expected %u got %zu", 3, parcArrayList_Size(list));
+    void *matches[METIS_MATCHING_RULES_TABLE_MAX_MATCHES];
+    size_t count = metisMatchingRulesTable_GetUnion(rulesTable, object, matches);
+    assertTrue(count == 3, "Incorrect result length, expected %u got %zu", 3, count);
 
     metisLogger_Release(&logger);
-    parcArrayList_Destroy(&list);
     metisMessage_Release(&object);
     metisMessage_Release(&interestByName);
     metisMessage_Release(&interestByNameAndKeyId);
@@ -383,9 +421,11 @@ LONGBOW_TEST_CASE(Global, metisMatchingRulesTable_GetUnion_3Tables)
 
 LONGBOW_TEST_FIXTURE(Local)
 {
-    LONGBOW_RUN_TEST_CASE(Local, metisMatchingRulesTable_GetTableForMessage_TableByNameAndObjectHash);
-    LONGBOW_RUN_TEST_CASE(Local, metisMatchingRulesTable_GetTableForMessage_TableByNameAndKeyId);
-    LONGBOW_RUN_TEST_CASE(Local, metisMatchingRulesTable_GetTableForMessage_TableByName);
+    LONGBOW_RUN_TEST_CASE(Local, _metisMatchingRulesTable_RuleForMessage_NameAndObjectHash);
+    LONGBOW_RUN_TEST_CASE(Local, _metisMatchingRulesTable_RuleForMessage_NameAndKeyId);
+    LONGBOW_RUN_TEST_CASE(Local, _metisMatchingRulesTable_RuleForMessage_Name);
+    LONGBOW_RUN_TEST_CASE(Local, _metisMatchingRulesTable_SameNameSharesBucket);
+    LONGBOW_RUN_TEST_CASE(Local, _metisMatchingRulesTable_Resize);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Local)
@@ -402,9 +442,9 @@ LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
 }
 
 /**
- * Use an interest with only a name, should select tableByName
+ * Use an interest with only a name, should use the Name rule
  */
-LONGBOW_TEST_CASE(Local, metisMatchingRulesTable_GetTableForMessage_TableByName)
+LONGBOW_TEST_CASE(Local, _metisMatchingRulesTable_RuleForMessage_Name)
 {
     PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
     MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
@@ -413,64 +453,121 @@ LONGBOW_TEST_CASE(Local, metisMatchingRulesTable_GetTableForMessage_TableByName)
     MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 1, logger);
     metisLogger_Release(&logger);
 
-    MetisMatchingRulesTable *rulesTable = metisMatchingRulesTable_Create(NULL);
-    PARCHashCodeTable *table = metisMatchingRulesTable_GetTableForMessage(rulesTable, interest);
+    MetisMatchingRule rule = _metisMatchingRulesTable_RuleForMessage(interest);
+    metisMessage_Release(&interest);
 
-    assertTrue(table == rulesTable->tableByName,
-               "Chose wrong table, expected TableByName, got %s",
-               (table == rulesTable->tableByNameAndKeyId) ? "tableByNameAndKeyId" :
-               (table == rulesTable->tableByNameAndObjectHash) ? "tableByNameAndObjectHash" : "unknown");
+    assertTrue(rule == MetisMatchingRule_Name, "Chose wrong rule, expected MetisMatchingRule_Name, got %d", rule);
+}
 
-    metisMatchingRulesTable_Destroy(&rulesTable);
+/**
+ * Use an interest with a name and keyid, should use the NameAndKeyId rule
+ */
+LONGBOW_TEST_CASE(Local, _metisMatchingRulesTable_RuleForMessage_NameAndKeyId)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    metisLogger_SetLogLevel(logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug);
+    parcLogReporter_Release(&reporter);
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName_keyid, sizeof(metisTestDataV0_InterestWithName_keyid), 1, 1, logger);
+    metisLogger_Release(&logger);
+
+    MetisMatchingRule rule = _metisMatchingRulesTable_RuleForMessage(interest);
     metisMessage_Release(&interest);
+
+    assertTrue(rule == MetisMatchingRule_NameAndKeyId, "Chose wrong rule, expected MetisMatchingRule_NameAndKeyId, got %d", rule);
 }
 
 /**
- * Use an interest with a name and keyid, should select tableByNameAndKeyId
+ * Use an interest with a name and objecthash, should use the NameAndObjectHash rule
  */
-LONGBOW_TEST_CASE(Local, metisMatchingRulesTable_GetTableForMessage_TableByNameAndKeyId)
+LONGBOW_TEST_CASE(Local, _metisMatchingRulesTable_RuleForMessage_NameAndObjectHash)
 {
     PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
     MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
     metisLogger_SetLogLevel(logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug);
     parcLogReporter_Release(&reporter);
-    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName_keyid, sizeof(metisTestDataV0_InterestWithName_keyid), 1, 1, logger);
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName_objecthash, sizeof(metisTestDataV0_InterestWithName_objecthash), 1, 1, logger);
+    metisLogger_Release(&logger);
+
+    MetisMatchingRule rule = _metisMatchingRulesTable_RuleForMessage(interest);
+    metisMessage_Release(&interest);
+
+    assertTrue(rule == MetisMatchingRule_NameAndObjectHash, "Chose wrong rule, expected MetisMatchingRule_NameAndObjectHash, got %d", rule);
+}
+
+/**
+ * Interests with the same name and different restrictions are stored in one bucket
+ */
+LONGBOW_TEST_CASE(Local, _metisMatchingRulesTable_SameNameSharesBucket)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+    MetisMessage *interestByNameAndKeyId = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName_keyid, sizeof(metisTestDataV0_InterestWithName_keyid), 1, 2, logger);
+    MetisMessage *interestByNameAndKeyId2 = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName_keyid2, sizeof(metisTestDataV0_InterestWithName_keyid2), 1, 2, logger);
+    MetisMessage *interestByName = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger);
     metisLogger_Release(&logger);
 
     MetisMatchingRulesTable *rulesTable = metisMatchingRulesTable_Create(NULL);
-    PARCHashCodeTable *table = metisMatchingRulesTable_GetTableForMessage(rulesTable, interest);
+    metisMatchingRulesTable_AddToBestTable(rulesTable, interestByNameAndKeyId, (void *) 0x01);
+    metisMatchingRulesTable_AddToBestTable(rulesTable, interestByNameAndKeyId2, (void *) 0x02);
+    metisMatchingRulesTable_AddToBestTable(rulesTable, interestByName, (void *) 0x03);
+
+    size_t bucketCount = rulesTable->bucketCount;
+    size_t length = metisMatchingRulesTable_Length(rulesTable);
+    void *test1 = metisMatchingRulesTable_Get(rulesTable, interestByNameAndKeyId);
+    void *test2 = metisMatchingRulesTable_Get(rulesTable, interestByNameAndKeyId2);
+    void *test3 = metisMatchingRulesTable_Get(rulesTable, interestByName);
 
-    assertTrue(table == rulesTable->tableByNameAndKeyId,
-               "Chose wrong table, expected TableByNameAndKeyId, got %s",
-               (table == rulesTable->tableByName) ? "tableByName" :
-               (table == rulesTable->tableByNameAndObjectHash) ? "tableByNameAndObjectHash" : "unknown");
+    // removing one variant leaves the others in place
+    metisMatchingRulesTable_RemoveFromBest(rulesTable, interestByNameAndKeyId);
+    void *removed = metisMatchingRulesTable_Get(rulesTable, interestByNameAndKeyId);
+    void *remaining = metisMatchingRulesTable_Get(rulesTable, interestByNameAndKeyId2);
 
     metisMatchingRulesTable_Destroy(&rulesTable);
-    metisMessage_Release(&interest);
+    metisMessage_Release(&interestByNameAndKeyId);
+    metisMessage_Release(&interestByNameAndKeyId2);
+    metisMessage_Release(&interestByName);
+
+    assertTrue(bucketCount == 1, "Expected 1 bucket, got %zu", bucketCount);
+    assertTrue(length == 3, "Expected 3 entries, got %zu", length);
+    assertTrue(test1 == (void *) 0x01 && test2 == (void *) 0x02 && test3 == (void *) 0x03, "Get returned the wrong variant");
+    assertNull(removed, "Removed variant still in the table");
+    assertTrue(remaining == (void *) 0x02, "Wrong variant removed");
 }
 
 /**
- * Use an interest with a name and objecthash, should select tableByNameAndObjectHash
+ * Growing the table keeps every bucket reachable
  */
-LONGBOW_TEST_CASE(Local, metisMatchingRulesTable_GetTableForMessage_TableByNameAndObjectHash)
+LONGBOW_TEST_CASE(Local, _metisMatchingRulesTable_Resize)
 {
     PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
     MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
-    metisLogger_SetLogLevel(logger, MetisLoggerFacility_Processor, PARCLogLevel_Debug);
     parcLogReporter_Release(&reporter);
-    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName_objecthash, sizeof(metisTestDataV0_InterestWithName_objecthash), 1, 1, logger);
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger);
+    MetisMessage *otherInterest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithOtherName, sizeof(metisTestDataV0_InterestWithOtherName), 1, 2, logger);
     metisLogger_Release(&logger);
 
     MetisMatchingRulesTable *rulesTable = metisMatchingRulesTable_Create(NULL);
-    PARCHashCodeTable *table = metisMatchingRulesTable_GetTableForMessage(rulesTable, interest);
+    metisMatchingRulesTable_AddToBestTable(rulesTable, interest, (void *) 0x01);
+    metisMatchingRulesTable_AddToBestTable(rulesTable, otherInterest, (void *) 0x02);
 
-    assertTrue(table == rulesTable->tableByNameAndObjectHash,
-               "Chose wrong table, expected TableByName, got %s",
-               (table == rulesTable->tableByNameAndKeyId) ? "tableByNameAndKeyId" :
-               (table == rulesTable->tableByName) ? "tableByName" : "unknown");
+    size_t capacity = rulesTable->capacity;
+    _metisMatchingRulesTable_Resize(rulesTable, capacity * 4);
+
+    void *test1 = metisMatchingRulesTable_Get(rulesTable, interest);
+    void *test2 = metisMatchingRulesTable_Get(rulesTable, otherInterest);
+    size_t newCapacity = rulesTable->capacity;
+    uintptr_t bucketAddress = (uintptr_t) rulesTable->buckets;
 
     metisMatchingRulesTable_Destroy(&rulesTable);
     metisMessage_Release(&interest);
+    metisMessage_Release(&otherInterest);
+
+    assertTrue(newCapacity == capacity * 4, "Wrong capacity, expected %zu got %zu", capacity * 4, newCapacity);
+    assertTrue(test1 == (void *) 0x01, "Lost first entry on resize");
+    assertTrue(test2 == (void *) 0x02, "Lost second entry on resize");
+    assertTrue(bucketAddress % METIS_CACHE_LINE_SIZE == 0, "Buckets not cache line aligned: %p", (void *) bucketAddress);
 }
 
 // ============================================================================
@@ -98,6 +98,10 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_Receive_WithTap);
     LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_Receive_Interest_WithoutTap);
     LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_Receive_Object_WithoutTap);
+    LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_ReceiveBatch);
+    LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_ReceiveBatch_Dropped);
+    LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_ReceiveBatch_Prefetch);
+    LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_AccumulateStats);
 
     LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_RemoveTap_RemoveCurrentTap);
     LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_RemoveTap_RemoveOtherTap);
@@ -106,6 +110,11 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_RemoveRoute);
 
     LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_SetContentStoreSize);
+    LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_SetContentStoreBytes);
+    LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_SetContentStoreSize_KeepsContents);
+    LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_SetContentStoreDisk);
+    LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_SetContentStoreType);
+    LONGBOW_RUN_TEST_CASE(Global, metisMessageProcessor_SetFIBType);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -181,11 +190,11 @@ LONGBOW_TEST_CASE(Global, metisMessageProcessor_Receive_Interest_WithoutTap)
     MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 4, 5, logger);
 
     // now test the function and measure results
-    uint32_t beforeCountReceived = processor->stats.countReceived;
-    uint32_t beforeCountInterestsReceived = processor->stats.countInterestsReceived;
+    uint64_t beforeCountReceived = processor->stats.countReceived;
+    uint64_t beforeCountInterestsReceived = processor->stats.countInterestsReceived;
     metisMessageProcessor_Receive(processor, interest);
-    uint32_t afterCountInterestsReceived = processor->stats.countInterestsReceived;
-    uint32_t afterCountReceived = processor->stats.countReceived;
+    uint64_t afterCountInterestsReceived = processor->stats.countInterestsReceived;
+    uint64_t afterCountReceived = processor->stats.countReceived;
 
     // cleanup
     // do not cleanup interest, metisMessageProcessor_Receive() takes ownership
@@ -194,12 +203,12 @@ LONGBOW_TEST_CASE(Global, metisMessageProcessor_Receive_Interest_WithoutTap)
 
     // validate
     assertTrue(afterCountReceived == beforeCountReceived + 1,
-               "Incorrect afterCountReceived, expected %u got %u",
+               "Incorrect afterCountReceived, expected %" PRIu64 " got %" PRIu64,
                beforeCountReceived + 1,
                afterCountReceived);
 
     assertTrue(afterCountInterestsReceived == beforeCountInterestsReceived + 1,
-               "Incorrect afterCountInterestsReceived, expected %u got %u",
+               "Incorrect afterCountInterestsReceived, expected %" PRIu64 " got %" PRIu64,
                beforeCountInterestsReceived + 1,
                afterCountInterestsReceived);
 }
@@ -213,11 +222,11 @@ LONGBOW_TEST_CASE(Global, metisMessageProcessor_Receive_Object_WithoutTap)
 
 
     // now test the function and measure results
-    uint32_t beforeCountReceived = processor->stats.countReceived;
-    uint32_t beforeCountObjectsReceived = processor->stats.countObjectsReceived;
+    uint64_t beforeCountReceived = processor->stats.countReceived;
+    uint64_t beforeCountObjectsReceived = processor->stats.countObjectsReceived;
     metisMessageProcessor_Receive(processor, object);
-    uint32_t afterCountObjectsReceived = processor->stats.countObjectsReceived;
-    uint32_t afterCountReceived = processor->stats.countReceived;
+    uint64_t afterCountObjectsReceived = processor->stats.countObjectsReceived;
+    uint64_t afterCountReceived = processor->stats.countReceived;
 
     // cleanup
     // do not cleanup object, metisMessageProcessor_Receive() takes ownership
@@ -226,16 +235,139 @@ LONGBOW_TEST_CASE(Global, metisMessageProcessor_Receive_Object_WithoutTap)
 
     // validate
     assertTrue(afterCountReceived == beforeCountReceived + 1,
-               "Incorrect afterCountReceived, expected %u got %u",
+               "Incorrect afterCountReceived, expected %" PRIu64 " got %" PRIu64,
                beforeCountReceived + 1,
                afterCountReceived);
 
     assertTrue(afterCountObjectsReceived == beforeCountObjectsReceived + 1,
-               "Incorrect afterCountInterestsReceived, expected %u got %u",
+               "Incorrect afterCountInterestsReceived, expected %" PRIu64 " got %" PRIu64,
                afterCountObjectsReceived,
                beforeCountObjectsReceived + 1);
 }
 
+LONGBOW_TEST_CASE(Global, metisMessageProcessor_ReceiveBatch)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisMessageProcessor *processor = metisMessageProcessor_Create(metis);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+
+    // The interest goes in the PIT before the object is looked up.  There is no actual
+    // connection "1", so the object shows up as countDroppedConnectionNotFound.
+    MetisMessage *messages[] = {
+        metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger),
+        metisMessage_CreateFromArray(metisTestDataV0_EncodedObject,    sizeof(metisTestDataV0_EncodedObject),    3, 4, logger),
+    };
+
+    metisMessageProcessor_ReceiveBatch(processor, 2, messages);
+
+    uint64_t countReceived = processor->stats.countReceived;
+    uint64_t countInterestsReceived = processor->stats.countInterestsReceived;
+    uint64_t countObjectsReceived = processor->stats.countObjectsReceived;
+    uint64_t countDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
+    uint64_t countDroppedNoReversePath = processor->stats.countDroppedNoReversePath;
+
+    // cleanup
+    // do not cleanup messages, metisMessageProcessor_ReceiveBatch() takes ownership
+    metisMessageProcessor_Destroy(&processor);
+    metisForwarder_Destroy(&metis);
+
+    // validate
+    assertTrue(countReceived == 2, "Incorrect countReceived, expected %u got %" PRIu64, 2, countReceived);
+    assertTrue(countInterestsReceived == 1, "Incorrect countInterestsReceived, expected %u got %" PRIu64, 1, countInterestsReceived);
+    assertTrue(countObjectsReceived == 1, "Incorrect countObjectsReceived, expected %u got %" PRIu64, 1, countObjectsReceived);
+    assertTrue(countDroppedConnectionNotFound == 1, "Incorrect countDroppedConnectionNotFound, expected %u got %" PRIu64, 1, countDroppedConnectionNotFound);
+    assertTrue(countDroppedNoReversePath == 0, "Incorrect countDroppedNoReversePath, expected %u got %" PRIu64, 0, countDroppedNoReversePath);
+}
+
+LONGBOW_TEST_CASE(Global, metisMessageProcessor_ReceiveBatch_Dropped)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisMessageProcessor *processor = metisMessageProcessor_Create(metis);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+
+    // the interest without a hoplimit is dropped in the first stage, the object after it still
+    // goes through the tables
+    MetisMessage *messages[] = {
+        metisMessage_CreateFromArray(metisTestDataV0_EncodedInterest_no_hoplimit, sizeof(metisTestDataV0_EncodedInterest_no_hoplimit), 1, 2, logger),
+        metisMessage_CreateFromArray(metisTestDataV0_EncodedObject,               sizeof(metisTestDataV0_EncodedObject),               3, 4, logger),
+    };
+
+    metisMessageProcessor_ReceiveBatch(processor, 2, messages);
+
+    uint64_t countReceived = processor->stats.countReceived;
+    uint64_t countDroppedNoHopLimit = processor->stats.countDroppedNoHopLimit;
+    uint64_t countDroppedNoReversePath = processor->stats.countDroppedNoReversePath;
+
+    // cleanup
+    metisMessageProcessor_Destroy(&processor);
+    metisForwarder_Destroy(&metis);
+
+    // validate
+    assertTrue(countReceived == 2, "Incorrect countReceived, expected %u got %" PRIu64, 2, countReceived);
+    assertTrue(countDroppedNoHopLimit == 1, "Incorrect countDroppedNoHopLimit, expected %u got %" PRIu64, 1, countDroppedNoHopLimit);
+    assertTrue(countDroppedNoReversePath == 1, "Incorrect countDroppedNoReversePath, expected %u got %" PRIu64, 1, countDroppedNoReversePath);
+}
+
+LONGBOW_TEST_CASE(Global, metisMessageProcessor_ReceiveBatch_Prefetch)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisMessageProcessor *processor = metisMessageProcessor_Create(metis);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+
+    // longer than the prefetch distance, so some lookups run behind a prefetch
+    const size_t count = 2 * METIS_PROCESSOR_PREFETCH_DISTANCE + 1;
+    MetisMessage *messages[count];
+    for (size_t i = 0; i < count; i++) {
+        messages[i] = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 3, 4, logger);
+    }
+
+    metisMessageProcessor_ReceiveBatch(processor, count, messages);
+
+    uint64_t countObjectsReceived = processor->stats.countObjectsReceived;
+    uint64_t countDroppedNoReversePath = processor->stats.countDroppedNoReversePath;
+
+    // cleanup
+    metisMessageProcessor_Destroy(&processor);
+    metisForwarder_Destroy(&metis);
+
+    // validate
+    assertTrue(countObjectsReceived == count, "Incorrect countObjectsReceived, expected %zu got %" PRIu64, count, countObjectsReceived);
+    assertTrue(countDroppedNoReversePath == count, "Incorrect countDroppedNoReversePath, expected %zu got %" PRIu64, count, countDroppedNoReversePath);
+}
+
+LONGBOW_TEST_CASE(Global, metisMessageProcessor_AccumulateStats)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisMessageProcessor *processor = metisMessageProcessor_Create(metis);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+
+    // the interest misses the content store and has no route
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger);
+    metisMessageProcessor_Receive(processor, interest);
+
+    // a counter past 32 bits is not truncated
+    processor->stats.countReceived += UINT32_MAX;
+
+    MetisStats stats;
+    metisStats_Init(&stats);
+    metisMessageProcessor_AccumulateStats(processor, &stats);
+    metisMessageProcessor_AccumulateStats(processor, &stats);
+
+    metisMessageProcessor_Destroy(&processor);
+    metisForwarder_Destroy(&metis);
+
+    // validate, each counter is added twice
+    uint64_t expectedReceived = 2 * ((uint64_t) UINT32_MAX + 1);
+    assertTrue(stats.values[MetisStat_Received] == expectedReceived,
+               "Wrong received, expected %" PRIu64 " got %" PRIu64, expectedReceived, stats.values[MetisStat_Received]);
+    assertTrue(stats.values[MetisStat_InterestsReceived] == 2,
+               "Wrong interestsReceived, expected 2 got %" PRIu64, stats.values[MetisStat_InterestsReceived]);
+    assertTrue(stats.values[MetisStat_DroppedNoRoute] == 2,
+               "Wrong droppedNoRoute, expected 2 got %" PRIu64, stats.values[MetisStat_DroppedNoRoute]);
+    assertTrue(stats.values[MetisStat_ContentStoreMisses] == 2,
+               "Wrong contentStore.misses, expected 2 got %" PRIu64, stats.values[MetisStat_ContentStoreMisses]);
+}
+
 LONGBOW_TEST_CASE(Global, metisMessageProcessor_RemoveTap_RemoveCurrentTap)
 {
     MetisForwarder *metis = metisForwarder_Create(NULL);
@@ -339,6 +471,131 @@ LONGBOW_TEST_CASE(Global, metisMessageProcessor_SetContentStoreSize)
     metisForwarder_Destroy(&metis);
 }
 
+LONGBOW_TEST_CASE(Global, metisMessageProcessor_SetContentStoreBytes)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+
+    size_t newCapacity = 1234;
+    size_t newBytes = 65536;
+    metisForwarder_SetContentObjectStoreSize(metis, newCapacity);
+    metisForwarder_SetContentObjectStoreBytes(metis, newBytes);
+
+    MetisContentStoreInterface *storeImpl = metisMessageProcessor_GetContentObjectStore(metis->processor);
+
+    size_t testBytes = metisContentStoreInterface_GetByteCapacity(storeImpl);
+    assertTrue(testBytes == newBytes, "Expected byte capacity %zu, got %zu", newBytes, testBytes);
+
+    // setting the byte capacity must not lose the object capacity
+    size_t testCapacity = metisContentStoreInterface_GetObjectCapacity(storeImpl);
+    assertTrue(testCapacity == newCapacity, "Expected object capacity %zu, got %zu", newCapacity, testCapacity);
+
+    metisForwarder_Destroy(&metis);
+}
+
+LONGBOW_TEST_CASE(Global, metisMessageProcessor_SetContentStoreSize_KeepsContents)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+
+    MetisContentStoreInterface *before = metisMessageProcessor_GetContentObjectStore(metis->processor);
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    metisContentStoreInterface_PutContent(before, object, 1);
+    metisMessage_Release(&object);
+
+    // growing keeps the same store and its object
+    metisForwarder_SetContentObjectStoreSize(metis, 1234);
+    MetisContentStoreInterface *after = metisMessageProcessor_GetContentObjectStore(metis->processor);
+    size_t countAfterGrow = metisContentStoreInterface_GetObjectCount(after);
+
+    // shrinking to nothing evicts the object on the next pass of the event loop
+    metisForwarder_SetContentObjectStoreSize(metis, 0);
+    metisDispatcher_RunCount(metisForwarder_GetDispatcher(metis), 1);
+    size_t countAfterShrink = metisContentStoreInterface_GetObjectCount(after);
+
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(before == after, "Resizing should not re-create the content store");
+    assertTrue(countAfterGrow == 1, "Wrong object count after grow, expected 1 got %zu", countAfterGrow);
+    assertTrue(countAfterShrink == 0, "Wrong object count after shrink, expected 0 got %zu", countAfterShrink);
+}
+
+LONGBOW_TEST_CASE(Global, metisMessageProcessor_SetContentStoreDisk)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+
+    char directory[] = "/tmp/test_metis_MessageProcessor.XXXXXX";
+    assertNotNull(mkdtemp(directory), "mkdtemp failed: (%d) %s", errno, strerror(errno));
+
+    size_t diskBytes = 1024 * 1024;
+    metisForwarder_SetContentObjectStoreDisk(metis, directory, diskBytes);
+    assertNotNull(metis->processor->diskStore, "Expected a disk store");
+    assertTrue(metis->processor->contentStoreConfig.secondTier == metis->processor->diskStore,
+               "Expected the disk store behind the content store");
+    assertTrue(metisContentStoreInterface_GetByteCapacity(metis->processor->diskStore) == diskBytes,
+               "Expected disk byte capacity %zu, got %zu", diskBytes,
+               metisContentStoreInterface_GetByteCapacity(metis->processor->diskStore));
+
+    metisForwarder_SetContentObjectStoreDisk(metis, NULL, 0);
+    assertNull(metis->processor->diskStore, "Expected the disk store to be removed");
+
+    metisForwarder_Destroy(&metis);
+
+    // nothing was cached, so no segment files were created
+    rmdir(directory);
+}
+
+LONGBOW_TEST_CASE(Global, metisMessageProcessor_SetContentStoreType)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+    MetisMessageProcessor *processor = metisMessageProcessor_Create(metis);
+
+    metisMessageProcessor_SetContentObjectStoreSize(processor, 100);
+
+    // an object in the old store does not carry over to the new one, as there is no disk store
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 1, 2, logger);
+    metisContentStoreInterface_PutContent(metisMessageProcessor_GetContentObjectStore(processor), object, 1);
+    size_t countBefore = metisContentStoreInterface_GetObjectCount(metisMessageProcessor_GetContentObjectStore(processor));
+
+    metisMessageProcessor_SetContentStoreType(processor, MetisContentStoreType_TinyLFU);
+    MetisContentStoreInterface *after = metisMessageProcessor_GetContentObjectStore(processor);
+    size_t countAfter = metisContentStoreInterface_GetObjectCount(after);
+
+    bool saved = metisContentStoreInterface_PutContent(after, object, 1);
+    metisMessage_Release(&object);
+
+    size_t capacity = metisContentStoreInterface_GetObjectCapacity(after);
+    MetisContentStoreType contentStoreType = processor->contentStoreType;
+
+    metisMessageProcessor_Destroy(&processor);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(countBefore == 1, "Expected the old store to hold 1 object, got %zu", countBefore);
+    assertTrue(countAfter == 0, "Changing the type should re-create the content store, new store holds %zu objects", countAfter);
+    assertTrue(contentStoreType == MetisContentStoreType_TinyLFU, "Wrong content store type %d", contentStoreType);
+    assertTrue(capacity == 100, "The new store should keep the capacity, expected 100 got %zu", capacity);
+    assertTrue(saved, "Expected the new store to save an object");
+}
+
+LONGBOW_TEST_CASE(Global, metisMessageProcessor_SetFIBType)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisMessageProcessor *processor = metisMessageProcessor_Create(metis);
+    metisMessageProcessor_SetFIBType(processor, MetisFIBType_Trie);
+
+    CCNxName *ccnxName = ccnxName_CreateFromCString("lci:/foo/bar");
+    CPIRouteEntry *route = cpiRouteEntry_Create(ccnxName, 22, NULL, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, NULL, 12);
+
+    metisMessageProcessor_AddOrUpdateRoute(processor, route);
+    size_t fibLength = metisFIB_Length(processor->fib);
+
+    cpiRouteEntry_Destroy(&route);
+    metisMessageProcessor_Destroy(&processor);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(fibLength == 1, "Wrong FIB length, expected %u got %zu", 1, fibLength);
+}
+
 // ===================================================================================
 
 LONGBOW_TEST_FIXTURE(Local)
@@ -369,6 +626,7 @@ LONGBOW_TEST_FIXTURE(Local)
     LONGBOW_RUN_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_NotInPit);
 
     LONGBOW_RUN_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InCache);
+    LONGBOW_RUN_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InCache_NotInPit);
     LONGBOW_RUN_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InCacheButExpired);
 
     LONGBOW_RUN_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_NotInCache);
@@ -391,6 +649,9 @@ LONGBOW_TEST_FIXTURE(Local)
     LONGBOW_RUN_TEST_CASE(Local, metisMessageProcessor_CheckAndDecrementHopLimitOnIngress_Local_NonZero);
     LONGBOW_RUN_TEST_CASE(Local, metisMessageProcessor_CheckAndDecrementHopLimitOnIngress_Remote_Zero);
     LONGBOW_RUN_TEST_CASE(Local, metisMessageProcessor_CheckAndDecrementHopLimitOnIngress_Remote_NonZero);
+
+    LONGBOW_RUN_TEST_CASE(Local, _metisMessageProcessor_ShardShare);
+    LONGBOW_RUN_TEST_CASE(Local, _metisMessageProcessor_ShardByteShare);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Local)
@@ -471,15 +732,15 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_Drop_Interest)
     // should increment a counter
     metisMessageProcessor_Drop(processor, interest);
 
-    unsigned countDropped = processor->stats.countDropped;
-    unsigned countInterestsDropped = processor->stats.countInterestsDropped;
+    uint64_t countDropped = processor->stats.countDropped;
+    uint64_t countInterestsDropped = processor->stats.countInterestsDropped;
 
     metisMessage_Release(&interest);
     metisMessageProcessor_Destroy(&processor);
     metisForwarder_Destroy(&metis);
 
-    assertTrue(countInterestsDropped == 1, "Incorrect countInterestsDropped, expecting %u, got %u", 1, countInterestsDropped);
-    assertTrue(countDropped == 1, "Incorrect countDropped, expecting %u, got %u", 1, countDropped);
+    assertTrue(countInterestsDropped == 1, "Incorrect countInterestsDropped, expecting %u, got %" PRIu64, 1, countInterestsDropped);
+    assertTrue(countDropped == 1, "Incorrect countDropped, expecting %u, got %" PRIu64, 1, countDropped);
 }
 
 /**
@@ -496,15 +757,15 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_Drop_Object)
     // should increment a counter
     metisMessageProcessor_Drop(processor, object);
 
-    unsigned countDropped = processor->stats.countDropped;
-    unsigned countObjectsDropped = processor->stats.countObjectsDropped;
+    uint64_t countDropped = processor->stats.countDropped;
+    uint64_t countObjectsDropped = processor->stats.countObjectsDropped;
 
     metisMessage_Release(&object);
     metisMessageProcessor_Destroy(&processor);
     metisForwarder_Destroy(&metis);
 
-    assertTrue(countObjectsDropped == 1, "Incorrect countInterestsDropped, expecting %u, got %u", 1, countObjectsDropped);
-    assertTrue(countDropped == 1, "Incorrect countDropped, expecting %u, got %u", 1, countDropped);
+    assertTrue(countObjectsDropped == 1, "Incorrect countInterestsDropped, expecting %u, got %" PRIu64, 1, countObjectsDropped);
+    assertTrue(countDropped == 1, "Incorrect countDropped, expecting %u, got %" PRIu64, 1, countDropped);
 }
 
 /**
@@ -521,15 +782,15 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToInterfaceId_NoConnection
 
     metisMessageProcessor_ForwardToInterfaceId(processor, object, 99);
 
-    uint32_t countDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
-    uint32_t countObjectsDropped = processor->stats.countObjectsDropped;
+    uint64_t countDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
+    uint64_t countObjectsDropped = processor->stats.countObjectsDropped;
 
     metisMessage_Release(&object);
     metisMessageProcessor_Destroy(&processor);
     metisForwarder_Destroy(&metis);
 
-    assertTrue(countDroppedConnectionNotFound == 1, "Incorrect countDroppedConnectionNotFound, expecting %u, got %u", 1, countDroppedConnectionNotFound);
-    assertTrue(countObjectsDropped == 1, "Incorrect countDropped, expecting %u, got %u", 1, countObjectsDropped);
+    assertTrue(countDroppedConnectionNotFound == 1, "Incorrect countDroppedConnectionNotFound, expecting %u, got %" PRIu64, 1, countDroppedConnectionNotFound);
+    assertTrue(countObjectsDropped == 1, "Incorrect countDropped, expecting %u, got %" PRIu64, 1, countObjectsDropped);
 }
 
 /**
@@ -549,16 +810,16 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToInterfaceId_SendFails)
     metisConnectionTable_Add(metisForwarder_GetConnectionTable(metis), conn);
     metisMessageProcessor_ForwardToInterfaceId(processor, object, 99);
 
-    uint32_t countSendFailures = processor->stats.countSendFailures;
-    uint32_t countObjectsDropped = processor->stats.countObjectsDropped;
+    uint64_t countSendFailures = processor->stats.countSendFailures;
+    uint64_t countObjectsDropped = processor->stats.countObjectsDropped;
 
     metisMessage_Release(&object);
     metisMessageProcessor_Destroy(&processor);
     metisForwarder_Destroy(&metis);
     mockIoOperationsData_Destroy(&ops);
 
-    assertTrue(countSendFailures == 1, "Incorrect countSendFailures, expecting %u, got %u", 1, countSendFailures);
-    assertTrue(countObjectsDropped == 1, "Incorrect countDropped, expecting %u, got %u", 1, countObjectsDropped);
+    assertTrue(countSendFailures == 1, "Incorrect countSendFailures, expecting %u, got %" PRIu64, 1, countSendFailures);
+    assertTrue(countObjectsDropped == 1, "Incorrect countDropped, expecting %u, got %" PRIu64, 1, countObjectsDropped);
 }
 
 /**
@@ -579,7 +840,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToInterfaceId_SendInterest
     metisConnectionTable_Add(metisForwarder_GetConnectionTable(metis), conn);
     metisMessageProcessor_ForwardToInterfaceId(processor, object, 99);
 
-    uint32_t countInterestForwarded = processor->stats.countInterestForwarded;
+    uint64_t countInterestForwarded = processor->stats.countInterestForwarded;
     uint32_t sendCount = data->sendCount;
 
     metisMessage_Release(&object);
@@ -587,7 +848,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToInterfaceId_SendInterest
     metisForwarder_Destroy(&metis);
     mockIoOperationsData_Destroy(&ops);
 
-    assertTrue(countInterestForwarded == 1, "Incorrect countInterestForwarded, expecting %u, got %u", 1, countInterestForwarded);
+    assertTrue(countInterestForwarded == 1, "Incorrect countInterestForwarded, expecting %u, got %" PRIu64, 1, countInterestForwarded);
     assertTrue(sendCount == 1, "Incorrect sendCount, expecting %u, got %u", 1, sendCount);
 }
 
@@ -612,7 +873,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToInterfaceId_SendObject)
     metisMessageProcessor_ForwardToInterfaceId(processor, object, 99);
 
     // measure
-    uint32_t countObjectsForwarded = processor->stats.countObjectsForwarded;
+    uint64_t countObjectsForwarded = processor->stats.countObjectsForwarded;
     uint32_t sendCount = data->sendCount;
 
     // cleanup
@@ -622,7 +883,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToInterfaceId_SendObject)
     mockIoOperationsData_Destroy(&ops);
 
     // validate
-    assertTrue(countObjectsForwarded == 1, "Incorrect countObjectsForwarded, expecting %u, got %u", 1, countObjectsForwarded);
+    assertTrue(countObjectsForwarded == 1, "Incorrect countObjectsForwarded, expecting %u, got %" PRIu64, 1, countObjectsForwarded);
     assertTrue(sendCount == 1, "Incorrect sendCount, expecting %u, got %u", 1, sendCount);
 }
 
@@ -649,7 +910,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToInterfaceId_ZeroHopLimit
     metisMessageProcessor_ForwardToInterfaceId(processor, object, connId);
 
     // measure
-    uint32_t countDropZeroToRemote = processor->stats.countDroppedZeroHopLimitToRemote;
+    uint64_t countDropZeroToRemote = processor->stats.countDroppedZeroHopLimitToRemote;
     uint32_t sendCount = data->sendCount;
 
     // cleanup
@@ -659,7 +920,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToInterfaceId_ZeroHopLimit
     mockIoOperationsData_Destroy(&ops);
 
     // validate
-    assertTrue(countDropZeroToRemote == 1, "Incorrect countDropZeroToRemote, expecting %u, got %u", 1, countDropZeroToRemote);
+    assertTrue(countDropZeroToRemote == 1, "Incorrect countDropZeroToRemote, expecting %u, got %" PRIu64, 1, countDropZeroToRemote);
     assertTrue(sendCount == 0, "Incorrect sendCount, expecting %u, got %u", 0, sendCount);
 }
 
@@ -686,7 +947,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToInterfaceId_ZeroHopLimit
     metisMessageProcessor_ForwardToInterfaceId(processor, object, connId);
 
     // measure
-    uint32_t countDropZeroToRemote = processor->stats.countDroppedZeroHopLimitToRemote;
+    uint64_t countDropZeroToRemote = processor->stats.countDroppedZeroHopLimitToRemote;
     uint32_t sendCount = data->sendCount;
 
     // cleanup
@@ -696,7 +957,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToInterfaceId_ZeroHopLimit
     mockIoOperationsData_Destroy(&ops);
 
     // validate
-    assertTrue(countDropZeroToRemote == 0, "Incorrect countDropZeroToRemote, expecting %u, got %u", 0, countDropZeroToRemote);
+    assertTrue(countDropZeroToRemote == 0, "Incorrect countDropZeroToRemote, expecting %u, got %" PRIu64, 0, countDropZeroToRemote);
     assertTrue(sendCount == 1, "Incorrect sendCount, expecting %u, got %u", 1, sendCount);
 }
 
@@ -734,7 +995,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToNexthops)
     metisMessageProcessor_ForwardToNexthops(processor, object, nexthops);
 
     // there should be 2 object forwards and each IoOps should have gotten 1 send
-    uint32_t countObjectsForwarded = processor->stats.countObjectsForwarded;
+    uint64_t countObjectsForwarded = processor->stats.countObjectsForwarded;
     uint32_t sendCount_42 = data_42->sendCount;
     uint32_t sendCount_43 = data_43->sendCount;
 
@@ -747,7 +1008,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToNexthops)
     mockIoOperationsData_Destroy(&ops_43);
 
     // validate
-    assertTrue(countObjectsForwarded == 2, "Incorrect countObjectsForwarded, expecting %u, got %u", 2, countObjectsForwarded);
+    assertTrue(countObjectsForwarded == 2, "Incorrect countObjectsForwarded, expecting %u, got %" PRIu64, 2, countObjectsForwarded);
     assertTrue(sendCount_42 == 1, "Incorrect sendCount_42, expecting %u, got %u", 1, sendCount_42);
     assertTrue(sendCount_43 == 1, "Incorrect sendCount_43, expecting %u, got %u", 1, sendCount_43);
 }
@@ -788,7 +1049,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToNexthops_DontForwardToIn
     metisMessageProcessor_ForwardToNexthops(processor, object, nexthops);
 
     // there should be 2 object forwards and each IoOps should have gotten 1 send
-    uint32_t countObjectsForwarded = processor->stats.countObjectsForwarded;
+    uint64_t countObjectsForwarded = processor->stats.countObjectsForwarded;
     uint32_t sendCount_42 = data_42->sendCount;
     uint32_t sendCount_43 = data_43->sendCount;
 
@@ -801,7 +1062,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ForwardToNexthops_DontForwardToIn
     mockIoOperationsData_Destroy(&ops_43);
 
     // validate
-    assertTrue(countObjectsForwarded == 1, "Incorrect countObjectsForwarded, expecting %u, got %u", 1, countObjectsForwarded);
+    assertTrue(countObjectsForwarded == 1, "Incorrect countObjectsForwarded, expecting %u, got %" PRIu64, 1, countObjectsForwarded);
     assertTrue(sendCount_42 == 0, "Incorrect sendCount_42, expecting %u, got %u", 0, sendCount_42);
     assertTrue(sendCount_43 == 1, "Incorrect sendCount_43, expecting %u, got %u", 1, sendCount_43);
 }
@@ -822,9 +1083,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveContentObjectV0_InPit)
     // There is no actual connection "1" (the interest ingress port), so the forwarding
     // will show up as a countDroppedConnectionNotFound.
 
-    uint32_t beforeCountDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
+    uint64_t beforeCountDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
     metisMessageProcessor_ReceiveContentObject(processor, object);
-    uint32_t afterCountDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
+    uint64_t afterCountDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
 
     // cleanup
     metisMessage_Release(&interest);
@@ -834,7 +1095,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveContentObjectV0_InPit)
 
     // validate
     assertTrue(afterCountDroppedConnectionNotFound == beforeCountDroppedConnectionNotFound + 1,
-               "Incorrect afterCountDroppedConnectionNotFound, expected %u got %u",
+               "Incorrect afterCountDroppedConnectionNotFound, expected %" PRIu64 " got %" PRIu64,
                beforeCountDroppedConnectionNotFound + 1,
                afterCountDroppedConnectionNotFound);
 }
@@ -848,9 +1109,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveContentObjectV0_NotInPit)
 
 
     // now test the function and measure results
-    uint32_t beforeCountDroppedNoReversePath = processor->stats.countDroppedNoReversePath;
+    uint64_t beforeCountDroppedNoReversePath = processor->stats.countDroppedNoReversePath;
     metisMessageProcessor_ReceiveContentObject(processor, object);
-    uint32_t afterCountDroppedNoReversePath = processor->stats.countDroppedNoReversePath;
+    uint64_t afterCountDroppedNoReversePath = processor->stats.countDroppedNoReversePath;
 
     // cleanup
     metisMessage_Release(&object);
@@ -859,7 +1120,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveContentObjectV0_NotInPit)
 
     // validate
     assertTrue(afterCountDroppedNoReversePath == beforeCountDroppedNoReversePath + 1,
-               "Incorrect afterCountDroppedNoReversePath, expected %u got %u",
+               "Incorrect afterCountDroppedNoReversePath, expected %" PRIu64 " got %" PRIu64,
                beforeCountDroppedNoReversePath + 1,
                afterCountDroppedNoReversePath);
 }
@@ -883,9 +1144,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveContentObjectV1_InPit)
     // There is no actual connection "1" (the interest ingress port), so the forwarding
     // will show up as a countDroppedConnectionNotFound.
 
-    uint32_t beforeCountDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
+    uint64_t beforeCountDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
     metisMessageProcessor_ReceiveContentObject(processor, object);
-    uint32_t afterCountDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
+    uint64_t afterCountDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
 
     // cleanup
     metisMessage_Release(&interest);
@@ -895,7 +1156,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveContentObjectV1_InPit)
 
     // validate
     assertTrue(afterCountDroppedConnectionNotFound == beforeCountDroppedConnectionNotFound + 1,
-               "Incorrect afterCountDroppedConnectionNotFound, expected %u got %u",
+               "Incorrect afterCountDroppedConnectionNotFound, expected %" PRIu64 " got %" PRIu64,
                beforeCountDroppedConnectionNotFound + 1,
                afterCountDroppedConnectionNotFound);
 }
@@ -909,9 +1170,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveContentObjectV1_NotInPit)
 
 
     // now test the function and measure results
-    uint32_t beforeCountDroppedNoReversePath = processor->stats.countDroppedNoReversePath;
+    uint64_t beforeCountDroppedNoReversePath = processor->stats.countDroppedNoReversePath;
     metisMessageProcessor_ReceiveContentObject(processor, object);
-    uint32_t afterCountDroppedNoReversePath = processor->stats.countDroppedNoReversePath;
+    uint64_t afterCountDroppedNoReversePath = processor->stats.countDroppedNoReversePath;
 
     // cleanup
     metisMessage_Release(&object);
@@ -920,7 +1181,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveContentObjectV1_NotInPit)
 
     // validate
     assertTrue(afterCountDroppedNoReversePath == beforeCountDroppedNoReversePath + 1,
-               "Incorrect afterCountDroppedNoReversePath, expected %u got %u",
+               "Incorrect afterCountDroppedNoReversePath, expected %" PRIu64 " got %" PRIu64,
                beforeCountDroppedNoReversePath + 1,
                afterCountDroppedNoReversePath);
 }
@@ -944,9 +1205,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InPit)
     metisMessageProcessor_AggregateInterestInPit(processor, interest1);
 
     // now test the function and measure results
-    uint32_t beforeCountInterestsAggregated = processor->stats.countInterestsAggregated;
+    uint64_t beforeCountInterestsAggregated = processor->stats.countInterestsAggregated;
     metisMessageProcessor_ReceiveInterest(processor, interest2);
-    uint32_t afterCountInterestsAggregated = processor->stats.countInterestsAggregated;
+    uint64_t afterCountInterestsAggregated = processor->stats.countInterestsAggregated;
 
     // cleanup
     metisMessage_Release(&interest1);
@@ -956,7 +1217,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InPit)
 
     // validate
     assertTrue(afterCountInterestsAggregated == beforeCountInterestsAggregated + 1,
-               "Incorrect afterCountInterestsAggregated, expected %u got %u",
+               "Incorrect afterCountInterestsAggregated, expected %" PRIu64 " got %" PRIu64,
                beforeCountInterestsAggregated + 1,
                afterCountInterestsAggregated);
 }
@@ -974,9 +1235,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_NotInPit)
 
 
     // now test the function and measure results
-    uint32_t beforeCountInterestsAggregated = processor->stats.countInterestsAggregated;
+    uint64_t beforeCountInterestsAggregated = processor->stats.countInterestsAggregated;
     metisMessageProcessor_ReceiveInterest(processor, interest);
-    uint32_t afterCountInterestsAggregated = processor->stats.countInterestsAggregated;
+    uint64_t afterCountInterestsAggregated = processor->stats.countInterestsAggregated;
 
     // also check its in the PIT now
     MetisPitEntry *pitEntry = metisPIT_GetPitEntry(processor->pit, interest);
@@ -993,7 +1254,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_NotInPit)
 
     // validate
     assertTrue(afterCountInterestsAggregated == beforeCountInterestsAggregated,
-               "Incorrect afterCountInterestsAggregated, expected %u got %u",
+               "Incorrect afterCountInterestsAggregated, expected %" PRIu64 " got %" PRIu64,
                beforeCountInterestsAggregated,
                afterCountInterestsAggregated);
 
@@ -1016,9 +1277,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InCache)
     metisContentStoreInterface_PutContent(processor->contentStore, object, 0l);
 
     // now test the function and measure results
-    uint32_t beforeCountObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
+    uint64_t beforeCountObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
     metisMessageProcessor_ReceiveInterest(processor, interest);
-    uint32_t afterCountObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
+    uint64_t afterCountObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
 
     // cleanup
     metisMessage_Release(&object);
@@ -1028,11 +1289,51 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InCache)
 
     // validate
     assertTrue(afterCountObjectsForwardedFromStore == beforeCountObjectsForwardedFromStore + 1,
-               "Incorrect afterCountObjectsForwardedFromStore, expected %u got %u",
+               "Incorrect afterCountObjectsForwardedFromStore, expected %" PRIu64 " got %" PRIu64,
                beforeCountObjectsForwardedFromStore + 1,
                afterCountObjectsForwardedFromStore);
 }
 
+/**
+ * A cache hit is answered to the ingress connection without creating a PIT entry
+ */
+LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InCache_NotInPit)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisMessageProcessor *processor = metisMessageProcessor_Create(metis);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger);
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 4, 5, logger);
+
+    metisContentStoreInterface_PutContent(processor->contentStore, object, 0l);
+
+    // connection 1 does not exist, so the reply to it is counted as not found
+    uint64_t beforeCountNotFound = processor->stats.countDroppedConnectionNotFound;
+    metisMessageProcessor_ReceiveInterest(processor, interest);
+    uint64_t afterCountNotFound = processor->stats.countDroppedConnectionNotFound;
+
+    MetisPitEntry *pitEntry = metisPIT_GetPitEntry(processor->pit, interest);
+    bool foundInPit = (pitEntry != NULL);
+    uint64_t countInterestsAggregated = processor->stats.countInterestsAggregated;
+
+    // cleanup
+    if (pitEntry) {
+        metisPitEntry_Release(&pitEntry);
+    }
+    metisMessage_Release(&object);
+    metisMessage_Release(&interest);
+    metisMessageProcessor_Destroy(&processor);
+    metisForwarder_Destroy(&metis);
+
+    // validate
+    assertFalse(foundInPit, "A cache hit should not create a PIT entry");
+    assertTrue(countInterestsAggregated == 0, "A cache hit should not be aggregated, got %" PRIu64, countInterestsAggregated);
+    assertTrue(afterCountNotFound == beforeCountNotFound + 1,
+               "Reply was not sent to the ingress connection, expected %" PRIu64 " got %" PRIu64,
+               beforeCountNotFound + 1,
+               afterCountNotFound);
+}
+
 LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InCacheButExpired)
 {
     MetisForwarder *metis = metisForwarder_Create(NULL);
@@ -1054,9 +1355,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InCacheButExpired
     metis->clockOffset = metisForwarder_NanosToTicks(5000000000ULL); // Add 5 seconds. Content is now expired.
 
     // now test the function and measure results.
-    uint32_t beforeCountObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
+    uint64_t beforeCountObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
     metisMessageProcessor_ReceiveInterest(processor, interest);
-    uint32_t afterCountObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
+    uint64_t afterCountObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
 
     // cleanup
     metisMessage_Release(&object);
@@ -1066,7 +1367,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InCacheButExpired
 
     // validate. Nothing should have been forwarded.
     assertTrue(afterCountObjectsForwardedFromStore == beforeCountObjectsForwardedFromStore,
-               "Incorrect afterCountObjectsForwardedFromStore, expected %u got %u",
+               "Incorrect afterCountObjectsForwardedFromStore, expected %" PRIu64 " got %" PRIu64,
                beforeCountObjectsForwardedFromStore,
                afterCountObjectsForwardedFromStore);
 }
@@ -1086,9 +1387,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_NotInCache)
 
 
     // now test the function and measure results
-    uint32_t beforeCountObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
+    uint64_t beforeCountObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
     metisMessageProcessor_ReceiveInterest(processor, interest);
-    uint32_t afterCountObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
+    uint64_t afterCountObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
 
     // cleanup
     metisMessage_Release(&object);
@@ -1098,7 +1399,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_NotInCache)
 
     // validate
     assertTrue(afterCountObjectsForwardedFromStore == beforeCountObjectsForwardedFromStore,
-               "Incorrect afterCountObjectsForwardedFromStore, expected %u got %u",
+               "Incorrect afterCountObjectsForwardedFromStore, expected %" PRIu64 " got %" PRIu64,
                beforeCountObjectsForwardedFromStore,
                afterCountObjectsForwardedFromStore);
 }
@@ -1133,9 +1434,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InFib)
 
     // now test the function and measure results
     // We will see it in countDroppedConnectionNotFound, because we didnt mock up the interface 22 connection
-    uint32_t beforeCountDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
+    uint64_t beforeCountDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
     metisMessageProcessor_ReceiveInterest(processor, interest);
-    uint32_t afterCountDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
+    uint64_t afterCountDroppedConnectionNotFound = processor->stats.countDroppedConnectionNotFound;
 
     // cleanup
     cpiRouteEntry_Destroy(&routeAdd);
@@ -1145,7 +1446,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_InFib)
 
     // validate
     assertTrue(afterCountDroppedConnectionNotFound == beforeCountDroppedConnectionNotFound + 1,
-               "Incorrect afterCountDroppedConnectionNotFound, expected %u got %u",
+               "Incorrect afterCountDroppedConnectionNotFound, expected %" PRIu64 " got %" PRIu64,
                beforeCountDroppedConnectionNotFound + 1,
                afterCountDroppedConnectionNotFound);
 }
@@ -1169,7 +1470,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_ReceiveInterest_NoHopLimit)
 
 
     metisMessageProcessor_ReceiveInterest(processor, interest);
-    uint32_t dropCount = processor->stats.countDroppedNoHopLimit;
+    uint64_t dropCount = processor->stats.countDroppedNoHopLimit;
 
     // cleanup
     metisMessage_Release(&interest);
@@ -1195,16 +1496,16 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_AggregateInterestInPit_NewEntry)
     MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger);
 
 
-    uint32_t beforeCountInterestsAggregated = processor->stats.countInterestsAggregated;
+    uint64_t beforeCountInterestsAggregated = processor->stats.countInterestsAggregated;
     bool aggregated = metisMessageProcessor_AggregateInterestInPit(processor, interest);
-    uint32_t afterCountInterestsAggregated = processor->stats.countInterestsAggregated;
+    uint64_t afterCountInterestsAggregated = processor->stats.countInterestsAggregated;
 
     metisMessage_Release(&interest);
     metisMessageProcessor_Destroy(&processor);
     metisForwarder_Destroy(&metis);
 
     assertTrue(afterCountInterestsAggregated == beforeCountInterestsAggregated,
-               "Incorrect afterCountInterestsAggregated, expected %u got %u",
+               "Incorrect afterCountInterestsAggregated, expected %" PRIu64 " got %" PRIu64,
                beforeCountInterestsAggregated,
                afterCountInterestsAggregated);
     assertFalse(aggregated, "Interest aggregated when no interests in table!");
@@ -1227,9 +1528,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_AggregateInterestInPit_ExistingEn
     metisMessageProcessor_AggregateInterestInPit(processor, interest1);
 
     // now add it again
-    uint32_t beforeCountInterestsAggregated = processor->stats.countInterestsAggregated;
+    uint64_t beforeCountInterestsAggregated = processor->stats.countInterestsAggregated;
     bool aggregated = metisMessageProcessor_AggregateInterestInPit(processor, interest2);
-    uint32_t afterCountInterestsAggregated = processor->stats.countInterestsAggregated;
+    uint64_t afterCountInterestsAggregated = processor->stats.countInterestsAggregated;
 
     metisMessage_Release(&interest1);
     metisMessage_Release(&interest2);
@@ -1237,7 +1538,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_AggregateInterestInPit_ExistingEn
     metisForwarder_Destroy(&metis);
 
     assertTrue(afterCountInterestsAggregated == beforeCountInterestsAggregated + 1,
-               "Incorrect afterCountInterestsAggregated, expected %u got %u",
+               "Incorrect afterCountInterestsAggregated, expected %" PRIu64 " got %" PRIu64,
                beforeCountInterestsAggregated + 1,
                afterCountInterestsAggregated);
     assertTrue(aggregated, "Interest not aggregated with self!");
@@ -1263,7 +1564,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_SatisfyFromContentStore_WithKeyId
 
     // Now test the code. We should NOT match it, due to the content store not currently verifying keyIds.
     bool success = _satisfyFromContentStore(processor, interestWithKeyIdRestriction);
-    unsigned countObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
+    uint64_t countObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
 
     // cleanup
     metisMessage_Release(&interestWithKeyIdRestriction);
@@ -1274,7 +1575,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_SatisfyFromContentStore_WithKeyId
     // validate
     assertFalse(success, "Expected Interest to not be satisfied from cache!");
     assertTrue(countObjectsForwardedFromStore == 0,
-               "Incorrect countObjectsForwardedFromStore, expected %u got %u",
+               "Incorrect countObjectsForwardedFromStore, expected %u got %" PRIu64,
                0,
                countObjectsForwardedFromStore);
 }
@@ -1292,7 +1593,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_SatisfyFromContentStore_IsInStore
 
     // now test the code
     bool success = _satisfyFromContentStore(processor, interest);
-    unsigned countObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
+    uint64_t countObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
 
     // cleanup
     metisMessage_Release(&interest);
@@ -1303,7 +1604,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_SatisfyFromContentStore_IsInStore
     // validate
     assertTrue(success, "Interest not satisfied from cache!");
     assertTrue(countObjectsForwardedFromStore == 1,
-               "Incorrect countObjectsForwardedFromStore, expected %u got %u",
+               "Incorrect countObjectsForwardedFromStore, expected %u got %" PRIu64,
                1,
                countObjectsForwardedFromStore);
 }
@@ -1321,7 +1622,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_SatisfyFromContentStore_IsNotInSt
 
     // now test the code
     bool success = _satisfyFromContentStore(processor, interest);
-    unsigned countObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
+    uint64_t countObjectsForwardedFromStore = processor->stats.countInterestsSatisfiedFromStore;
 
     // cleanup
     metisMessage_Release(&interest);
@@ -1332,7 +1633,7 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_SatisfyFromContentStore_IsNotInSt
     // validate
     assertFalse(success, "Interest satisfied from cache, when we didn't put it there!");
     assertTrue(countObjectsForwardedFromStore == 0,
-               "Incorrect countObjectsForwardedFromStore, expected %u got %u",
+               "Incorrect countObjectsForwardedFromStore, expected %u got %" PRIu64,
                0,
                countObjectsForwardedFromStore);
 }
@@ -1441,9 +1742,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_CheckAndDecrementHopLimitOnIngres
     assertFalse(success, "Should have failed for an interest without hoplimit");
 
     assertTrue(processor->stats.countDroppedNoHopLimit == 1,
-               "Wrong countDroppedNoHopLimit, got %u expected %u", processor->stats.countDroppedNoHopLimit, 1);
+               "Wrong countDroppedNoHopLimit, got %" PRIu64 " expected %u", processor->stats.countDroppedNoHopLimit, 1);
     assertTrue(processor->stats.countDroppedZeroHopLimitFromRemote == 0,
-               "Wrong countDroppedZeroHopLimitFromRemote, got %u expected %u", processor->stats.countDroppedZeroHopLimitFromRemote, 0);
+               "Wrong countDroppedZeroHopLimitFromRemote, got %" PRIu64 " expected %u", processor->stats.countDroppedZeroHopLimitFromRemote, 0);
 
     metisMessage_Release(&interest);
     metisMessageProcessor_Destroy(&processor);
@@ -1468,9 +1769,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_CheckAndDecrementHopLimitOnIngres
     bool success = metisMessageProcessor_CheckAndDecrementHopLimitOnIngress(processor, interest);
     assertTrue(success, "Local with 0 hoplimit should have been ok");
     assertTrue(processor->stats.countDroppedNoHopLimit == 0,
-               "Wrong countDroppedNoHopLimit, got %u expected %u", processor->stats.countDroppedNoHopLimit, 0);
+               "Wrong countDroppedNoHopLimit, got %" PRIu64 " expected %u", processor->stats.countDroppedNoHopLimit, 0);
     assertTrue(processor->stats.countDroppedZeroHopLimitFromRemote == 0,
-               "Wrong countDroppedZeroHopLimitFromRemote, got %u expected %u", processor->stats.countDroppedZeroHopLimitFromRemote, 0);
+               "Wrong countDroppedZeroHopLimitFromRemote, got %" PRIu64 " expected %u", processor->stats.countDroppedZeroHopLimitFromRemote, 0);
 
     metisMessage_Release(&interest);
     metisMessageProcessor_Destroy(&processor);
@@ -1495,9 +1796,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_CheckAndDecrementHopLimitOnIngres
     bool success = metisMessageProcessor_CheckAndDecrementHopLimitOnIngress(processor, interest);
     assertTrue(success, "Local with non-0 hoplimit should have been ok");
     assertTrue(processor->stats.countDroppedNoHopLimit == 0,
-               "Wrong countDroppedNoHopLimit, got %u expected %u", processor->stats.countDroppedNoHopLimit, 0);
+               "Wrong countDroppedNoHopLimit, got %" PRIu64 " expected %u", processor->stats.countDroppedNoHopLimit, 0);
     assertTrue(processor->stats.countDroppedZeroHopLimitFromRemote == 0,
-               "Wrong countDroppedZeroHopLimitFromRemote, got %u expected %u", processor->stats.countDroppedZeroHopLimitFromRemote, 0);
+               "Wrong countDroppedZeroHopLimitFromRemote, got %" PRIu64 " expected %u", processor->stats.countDroppedZeroHopLimitFromRemote, 0);
 
     metisMessage_Release(&interest);
     metisMessageProcessor_Destroy(&processor);
@@ -1522,9 +1823,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_CheckAndDecrementHopLimitOnIngres
     bool success = metisMessageProcessor_CheckAndDecrementHopLimitOnIngress(processor, interest);
     assertFalse(success, "Remote with 0 hoplimit should have been failure");
     assertTrue(processor->stats.countDroppedNoHopLimit == 0,
-               "Wrong countDroppedNoHopLimit, got %u expected %u", processor->stats.countDroppedNoHopLimit, 0);
+               "Wrong countDroppedNoHopLimit, got %" PRIu64 " expected %u", processor->stats.countDroppedNoHopLimit, 0);
     assertTrue(processor->stats.countDroppedZeroHopLimitFromRemote == 1,
-               "Wrong countDroppedZeroHopLimitFromRemote, got %u expected %u", processor->stats.countDroppedZeroHopLimitFromRemote, 1);
+               "Wrong countDroppedZeroHopLimitFromRemote, got %" PRIu64 " expected %u", processor->stats.countDroppedZeroHopLimitFromRemote, 1);
 
     metisMessage_Release(&interest);
     metisMessageProcessor_Destroy(&processor);
@@ -1548,9 +1849,9 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_CheckAndDecrementHopLimitOnIngres
     bool success = metisMessageProcessor_CheckAndDecrementHopLimitOnIngress(processor, interest);
     assertTrue(success, "Remote with non-0 hoplimit should have been ok");
     assertTrue(processor->stats.countDroppedNoHopLimit == 0,
-               "Wrong countDroppedNoHopLimit, got %u expected %u", processor->stats.countDroppedNoHopLimit, 0);
+               "Wrong countDroppedNoHopLimit, got %" PRIu64 " expected %u", processor->stats.countDroppedNoHopLimit, 0);
     assertTrue(processor->stats.countDroppedZeroHopLimitFromRemote == 0,
-               "Wrong countDroppedZeroHopLimitFromRemote, got %u expected %u", processor->stats.countDroppedZeroHopLimitFromRemote, 0);
+               "Wrong countDroppedZeroHopLimitFromRemote, got %" PRIu64 " expected %u", processor->stats.countDroppedZeroHopLimitFromRemote, 0);
 
     metisMessage_Release(&interest);
     metisMessageProcessor_Destroy(&processor);
@@ -1560,6 +1861,46 @@ LONGBOW_TEST_CASE(Local, metisMessageProcessor_CheckAndDecrementHopLimitOnIngres
 }
 
 
+/**
+ * The shards' shares add up to exactly the configured limit
+ */
+LONGBOW_TEST_CASE(Local, _metisMessageProcessor_ShardShare)
+{
+    MetisMessageProcessor processor = { .shardCount = 4 };
+
+    size_t shares[4];
+    size_t sum = 0;
+    for (unsigned i = 0; i < 4; i++) {
+        processor.shard = i;
+        shares[i] = _metisMessageProcessor_ShardShare(&processor, 10);
+        sum += shares[i];
+    }
+
+    processor.shard = 3;
+    size_t zeroShare = _metisMessageProcessor_ShardShare(&processor, 0);
+    size_t smallShare = _metisMessageProcessor_ShardShare(&processor, 3);
+
+    assertTrue(sum == 10, "Shares should add up to 10, got %zu", sum);
+    assertTrue(shares[0] == 3 && shares[1] == 3, "Low shards should get the remainder, got %zu and %zu", shares[0], shares[1]);
+    assertTrue(shares[2] == 2 && shares[3] == 2, "High shards should get the even share, got %zu and %zu", shares[2], shares[3]);
+    assertTrue(zeroShare == 0, "A capacity of 0 should stay 0, got %zu", zeroShare);
+    assertTrue(smallShare == 0, "Shard 3 of a capacity of 3 should get nothing, got %zu", smallShare);
+}
+
+/**
+ * A byte limit too small to split never becomes 0, which would mean no limit
+ */
+LONGBOW_TEST_CASE(Local, _metisMessageProcessor_ShardByteShare)
+{
+    MetisMessageProcessor processor = { .shard = 3, .shardCount = 4 };
+
+    size_t noLimit = _metisMessageProcessor_ShardByteShare(&processor, 0);
+    size_t tinyLimit = _metisMessageProcessor_ShardByteShare(&processor, 3);
+
+    assertTrue(noLimit == 0, "No limit should stay no limit, got %zu", noLimit);
+    assertTrue(tinyLimit == 1, "A tiny limit should give 1 byte, got %zu", tinyLimit);
+}
+
 // ========================================================
 
 int
@@ -82,6 +82,7 @@ typedef struct mock_pit {
     unsigned countSatisfyInterest;
     unsigned countRemoveInterest;
     unsigned countGetPitEntry;
+    unsigned countPrefetch;
 } _MockPIT;
 
 static void
@@ -100,12 +101,11 @@ _mockPITInterface_ReceiveInterest(MetisPIT *pit, MetisMessage *interestMessage)
     return MetisPITVerdict_Aggregate;
 }
 
-static MetisNumberSet *
-_mockPITInterface_SatisfyInterest(MetisPIT *pit, const MetisMessage *objectMessage)
+static void
+_mockPITInterface_SatisfyInterest(MetisPIT *pit, const MetisMessage *objectMessage, MetisNumberSet *ingressSetUnion)
 {
     _MockPIT *mock = metisPIT_Closure(pit);
     mock->countSatisfyInterest++;
-    return NULL;
 }
 
 static void
@@ -123,6 +123,13 @@ _mockPITInterface_GetPitEntry(const MetisPIT *pit, const MetisMessage *interestM
     return NULL;
 }
 
+static void
+_mockPITInterface_Prefetch(const MetisPIT *pit, const MetisMessage *message)
+{
+    _MockPIT *mock = metisPIT_Closure(pit);
+    mock->countPrefetch++;
+}
+
 static MetisPIT *
 _mockPIT_Create(void)
 {
@@ -130,6 +137,7 @@ _mockPIT_Create(void)
     MetisPIT *pit = parcMemory_AllocateAndClear(allocation);
 
     pit->getPitEntry = _mockPITInterface_GetPitEntry;
+    pit->prefetch = _mockPITInterface_Prefetch;
     pit->receiveInterest = _mockPITInterface_ReceiveInterest;
     pit->release = _mockPITInterface_Release;
     pit->removeInterest = _mockPITInterface_RemoveInterest;
@@ -176,6 +184,8 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisPIT_SatisfyInterest);
     LONGBOW_RUN_TEST_CASE(Global, metisPIT_RemoveInterest);
     LONGBOW_RUN_TEST_CASE(Global, metisPIT_GetPitEntry);
+    LONGBOW_RUN_TEST_CASE(Global, metisPIT_Prefetch);
+    LONGBOW_RUN_TEST_CASE(Global, metisPIT_Prefetch_NotImplemented);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Global)
@@ -224,7 +234,7 @@ LONGBOW_TEST_CASE(Global, metisPIT_SatisfyInterest)
 {
     MetisPIT *pit = _mockPIT_Create();
     _MockPIT *mock = metisPIT_Closure(pit);
-    metisPIT_SatisfyInterest(pit, NULL);
+    metisPIT_SatisfyInterest(pit, NULL, NULL);
 
     assertTrue(mock->countSatisfyInterest == 1, "Wrong count expected 1 got %u", mock->countSatisfyInterest);
     _metisPIT_Release(&pit);
@@ -250,6 +260,29 @@ LONGBOW_TEST_CASE(Global, metisPIT_GetPitEntry)
     _metisPIT_Release(&pit);
 }
 
+LONGBOW_TEST_CASE(Global, metisPIT_Prefetch)
+{
+    MetisPIT *pit = _mockPIT_Create();
+    _MockPIT *mock = metisPIT_Closure(pit);
+    metisPIT_Prefetch(pit, NULL);
+
+    assertTrue(mock->countPrefetch == 1, "Wrong count expected 1 got %u", mock->countPrefetch);
+    _metisPIT_Release(&pit);
+}
+
+LONGBOW_TEST_CASE(Global, metisPIT_Prefetch_NotImplemented)
+{
+    MetisPIT *pit = _mockPIT_Create();
+    _MockPIT *mock = metisPIT_Closure(pit);
+    pit->prefetch = NULL;
+
+    // the hint is optional, so this must be a no-op
+    metisPIT_Prefetch(pit, NULL);
+
+    assertTrue(mock->countPrefetch == 0, "Wrong count expected 0 got %u", mock->countPrefetch);
+    _metisPIT_Release(&pit);
+}
+
 // ===============================================================================================
 
 int
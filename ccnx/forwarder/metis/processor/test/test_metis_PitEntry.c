@@ -94,6 +94,7 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisPitEntry_Create_Destroy);
     LONGBOW_RUN_TEST_CASE(Global, metisPitEntry_GetExpiryTime);
     LONGBOW_RUN_TEST_CASE(Global, metisPitEntry_SetExpiryTime);
+    LONGBOW_RUN_TEST_CASE(Global, metisPitEntry_SetExpiryTimer);
     LONGBOW_RUN_TEST_CASE(Global, metisPitEntry_GetIngressSet);
     LONGBOW_RUN_TEST_CASE(Global, metisPitEntry_GetEgressSet);
 
@@ -126,9 +127,9 @@ LONGBOW_TEST_CASE(Global, metisPitEntry_AddEgressId)
     metisPitEntry_AddEgressId(entry, 10);
     metisPitEntry_AddEgressId(entry, 11);
 
-    size_t set_length = metisNumberSet_Length(entry->egressIdSet);
-    bool contains_10 = metisNumberSet_Contains(entry->egressIdSet, 10);
-    bool contains_11 = metisNumberSet_Contains(entry->egressIdSet, 11);
+    size_t set_length = metisNumberSet_Length(&entry->egressIdSet);
+    bool contains_10 = metisNumberSet_Contains(&entry->egressIdSet, 10);
+    bool contains_11 = metisNumberSet_Contains(&entry->egressIdSet, 11);
 
     metisPitEntry_Release(&entry);
     metisMessage_Release(&interest);
@@ -151,12 +152,12 @@ LONGBOW_TEST_CASE(Global, metisPitEntry_AddIngressId)
     metisPitEntry_AddIngressId(entry, 10);
     metisPitEntry_AddIngressId(entry, 11);
 
-    size_t set_length = metisNumberSet_Length(entry->ingressIdSet);
+    size_t set_length = metisNumberSet_Length(&entry->ingressIdSet);
 
     // #1 is from the original interest
-    bool contains_1 = metisNumberSet_Contains(entry->ingressIdSet, 1);
-    bool contains_10 = metisNumberSet_Contains(entry->ingressIdSet, 10);
-    bool contains_11 = metisNumberSet_Contains(entry->ingressIdSet, 11);
+    bool contains_1 = metisNumberSet_Contains(&entry->ingressIdSet, 1);
+    bool contains_10 = metisNumberSet_Contains(&entry->ingressIdSet, 10);
+    bool contains_11 = metisNumberSet_Contains(&entry->ingressIdSet, 11);
 
     metisPitEntry_Release(&entry);
     metisMessage_Release(&interest);
@@ -247,6 +248,33 @@ LONGBOW_TEST_CASE(Global, metisPitEntry_SetExpiryTime)
     assertTrue(expiry2 == test, "Got wrong expiry time, expected %" PRIu64 ", got %" PRIu64, expiry2, test);
 }
 
+LONGBOW_TEST_CASE(Global, metisPitEntry_SetExpiryTimer)
+{
+    MetisTicks expiry = 40000;
+
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger);
+    metisLogger_Release(&logger);
+    MetisPitEntry *entry = metisPitEntry_Create(metisMessage_Acquire(interest), expiry);
+
+    assertNull(metisPitEntry_GetExpiryTimer(entry), "A new entry should not have an expiry timer");
+
+    MetisTimerWheel *wheel = metisTimerWheel_Create(0);
+    MetisTimerWheelTimer *timer = metisTimerWheel_Schedule(wheel, expiry, entry);
+    metisPitEntry_SetExpiryTimer(entry, timer);
+
+    MetisTimerWheelTimer *test = metisPitEntry_GetExpiryTimer(entry);
+
+    metisTimerWheel_Cancel(wheel, &timer);
+    metisTimerWheel_Destroy(&wheel);
+    metisPitEntry_Release(&entry);
+    metisMessage_Release(&interest);
+
+    assertTrue(test == timer || timer == NULL, "Got wrong expiry timer");
+}
+
 LONGBOW_TEST_CASE(Global, metisPitEntry_GetIngressSet)
 {
     PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metis_ShardedProcessor.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+
+#include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
+
+// =========================================================================
+
+LONGBOW_TEST_RUNNER(metis_ShardedProcessor)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_ShardedProcessor)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_ShardedProcessor)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisShardedProcessor_Create_Destroy);
+    LONGBOW_RUN_TEST_CASE(Global, metisShardedProcessor_Receive_Interest);
+    LONGBOW_RUN_TEST_CASE(Global, metisShardedProcessor_AddOrUpdateRoute);
+    LONGBOW_RUN_TEST_CASE(Global, metisShardedProcessor_SetContentStoreSize);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/**
+ * Waits up to a second for the shards to have received `expected` messages in total
+ */
+static unsigned
+_waitForReceived(MetisShardedProcessor *sharded, unsigned expected)
+{
+    unsigned received = 0;
+    for (int tries = 0; tries < 1000 && received < expected; tries++) {
+        usleep(1000);
+
+        received = 0;
+        _metisShardedProcessor_Pause(sharded);
+        for (unsigned i = 0; i < sharded->shardCount; i++) {
+            received += sharded->workers[i].processor->stats.countReceived;
+        }
+        _metisShardedProcessor_Resume(sharded);
+    }
+    return received;
+}
+
+LONGBOW_TEST_CASE(Global, metisShardedProcessor_Create_Destroy)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+
+    uint32_t beforeBalance = parcMemory_Outstanding();
+    MetisShardedProcessor *sharded = metisShardedProcessor_Create(metis, 3);
+    unsigned shardCount = metisShardedProcessor_ShardCount(sharded);
+    metisShardedProcessor_Destroy(&sharded);
+    uint32_t afterBalance = parcMemory_Outstanding();
+
+    metisForwarder_Destroy(&metis);
+    assertTrue(shardCount == 3, "Wrong shard count, expected 3 got %u", shardCount);
+    assertTrue(beforeBalance == afterBalance, "Memory imbalance on create/destroy: before %u after %u", beforeBalance, afterBalance);
+}
+
+LONGBOW_TEST_CASE(Global, metisShardedProcessor_Receive_Interest)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisShardedProcessor *sharded = metisShardedProcessor_Create(metis, 2);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 4, 5, logger);
+    unsigned shard = _metisShardedProcessor_ShardOf(sharded, interest);
+
+    metisShardedProcessor_Receive(sharded, interest);
+    unsigned received = _waitForReceived(sharded, 1);
+
+    _metisShardedProcessor_Pause(sharded);
+    unsigned shardReceived = sharded->workers[shard].processor->stats.countInterestsReceived;
+    _metisShardedProcessor_Resume(sharded);
+
+    metisShardedProcessor_Destroy(&sharded);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(received == 1, "Wrong received count, expected 1 got %u", received);
+    assertTrue(shardReceived == 1, "Interest did not go to shard %u", shard);
+}
+
+LONGBOW_TEST_CASE(Global, metisShardedProcessor_AddOrUpdateRoute)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisShardedProcessor *sharded = metisShardedProcessor_Create(metis, 2);
+
+    CCNxName *ccnxName = ccnxName_CreateFromCString("lci:/foo/bar");
+    CPIRouteEntry *route = cpiRouteEntry_Create(ccnxName, 22, NULL, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, NULL, 12);
+
+    metisShardedProcessor_AddOrUpdateRoute(sharded, route);
+
+    _metisShardedProcessor_Pause(sharded);
+    size_t firstLength = metisFIB_Length(sharded->workers[0].processor->fib);
+    size_t secondLength = metisFIB_Length(sharded->workers[1].processor->fib);
+    _metisShardedProcessor_Resume(sharded);
+
+    MetisFibEntryList *list = metisShardedProcessor_GetFibEntries(sharded);
+    size_t listLength = metisFibEntryList_Length(list);
+    metisFibEntryList_Destroy(&list);
+
+    cpiRouteEntry_Destroy(&route);
+    metisShardedProcessor_Destroy(&sharded);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(firstLength == 1, "Wrong shard 0 FIB length, expected 1 got %zu", firstLength);
+    assertTrue(secondLength == 1, "Wrong shard 1 FIB length, expected 1 got %zu", secondLength);
+    assertTrue(listLength == 1, "Wrong FIB entry list length, expected 1 got %zu", listLength);
+}
+
+LONGBOW_TEST_CASE(Global, metisShardedProcessor_SetContentStoreSize)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisShardedProcessor *sharded = metisShardedProcessor_Create(metis, 4);
+
+    metisShardedProcessor_SetContentObjectStoreSize(sharded, 1001);
+
+    _metisShardedProcessor_Pause(sharded);
+    size_t capacity = metisContentStoreInterface_GetObjectCapacity(metisMessageProcessor_GetContentObjectStore(sharded->workers[3].processor));
+    _metisShardedProcessor_Resume(sharded);
+
+    metisShardedProcessor_Destroy(&sharded);
+    metisForwarder_Destroy(&metis);
+
+    // each shard gets an even share, rounded up
+    assertTrue(capacity == 251, "Wrong shard capacity, expected 251 got %zu", capacity);
+}
+
+// =========================================================================
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _metisShardedProcessor_ShardOf);
+    LONGBOW_RUN_TEST_CASE(Local, _metisShardedProcessor_Pause_Resume);
+    LONGBOW_RUN_TEST_CASE(Local, _metisShardedProcessor_SendOnConnection_NotFound);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Local, _metisShardedProcessor_ShardOf)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisShardedProcessor *sharded = metisShardedProcessor_Create(metis, 4);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+
+    // an Interest and the object that answers it have the same name
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 4, 5, logger);
+    MetisMessage *object = metisMessage_CreateFromArray(metisTestDataV0_EncodedObject, sizeof(metisTestDataV0_EncodedObject), 4, 5, logger);
+
+    unsigned interestShard = _metisShardedProcessor_ShardOf(sharded, interest);
+    unsigned objectShard = _metisShardedProcessor_ShardOf(sharded, object);
+    unsigned expected = metisTlvName_HashCode(metisMessage_GetName(interest)) % 4;
+
+    metisMessage_Release(&interest);
+    metisMessage_Release(&object);
+    metisShardedProcessor_Destroy(&sharded);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(interestShard == expected, "Wrong shard, expected %u got %u", expected, interestShard);
+    assertTrue(objectShard == interestShard, "Object shard %u does not match interest shard %u", objectShard, interestShard);
+}
+
+LONGBOW_TEST_CASE(Local, _metisShardedProcessor_Pause_Resume)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisShardedProcessor *sharded = metisShardedProcessor_Create(metis, 3);
+
+    _metisShardedProcessor_Pause(sharded);
+    unsigned parked = sharded->parkedCount;
+    _metisShardedProcessor_Resume(sharded);
+
+    // a second pause right after a resume must not deadlock
+    _metisShardedProcessor_Pause(sharded);
+    _metisShardedProcessor_Resume(sharded);
+
+    metisShardedProcessor_Destroy(&sharded);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(parked == 3, "Wrong parked count, expected 3 got %u", parked);
+}
+
+LONGBOW_TEST_CASE(Local, _metisShardedProcessor_SendOnConnection_NotFound)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisShardedProcessor *sharded = metisShardedProcessor_Create(metis, 2);
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 4, 5, logger);
+
+    // the test thread is the I/O thread, and there is no connection 99
+    _metisShardedProcessor_SendOnConnection(&sharded->workers[1], interest, 99);
+
+    MetisStats stats;
+    metisStats_Init(&stats);
+    metisShardedProcessor_AccumulateStats(sharded, &stats);
+
+    metisMessage_Release(&interest);
+    metisShardedProcessor_Destroy(&sharded);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(stats.values[MetisStat_DroppedConnectionNotFound] == 1,
+               "Wrong DroppedConnectionNotFound, expected 1 got %" PRIu64, stats.values[MetisStat_DroppedConnectionNotFound]);
+    assertTrue(stats.values[MetisStat_SendFailures] == 0,
+               "Wrong SendFailures, expected 0 got %" PRIu64, stats.values[MetisStat_SendFailures]);
+}
+
+// =========================================================================
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_ShardedProcessor);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
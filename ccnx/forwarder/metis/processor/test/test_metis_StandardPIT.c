@@ -53,12 +53,6 @@
  * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
  */
 
-/*
- * These tests were written before MetisMatchRulesTable was broken out of the PIT.
- * So, many of the tests "cheat" by looking directly in a constiuent table in MetisMatchingRulesTable.
- * They should be re-written to use the MetisMatchingRulesTable API.
- */
-
 // Include this so we can step the clock forward without waiting real time
 #include "../../core/metis_Forwarder.c"
 
@@ -66,7 +60,6 @@
 // This permits internal static functions to be visible to this Test Framework.
 #include "../metis_StandardPIT.c"
 
-// so we can directly test the underlying tables
 #include "../metis_MatchingRulesTable.c"
 
 // test data set
@@ -160,14 +153,14 @@ LONGBOW_TEST_CASE(Global, metisPit_ReceiveInterest_NewEntry)
     metisLogger_Release(&logger);
 
     MetisPITVerdict verdict = metisPIT_ReceiveInterest(generic, interest);
-    size_t table_length = parcHashCodeTable_Length(pit->table->tableByName);
+    size_t table_length = metisMatchingRulesTable_Length(pit->table);
 
     metisMessage_Release(&interest);
 
     metisPIT_Release(&generic);
     metisForwarder_Destroy(&metis);
 
-    assertTrue(table_length == 1, "tableByName wrong length, expected %u got %zu", 1, table_length);
+    assertTrue(table_length == 1, "table wrong length, expected %u got %zu", 1, table_length);
     assertTrue(verdict == MetisPITVerdict_Forward, "New entry did not return PIT_VERDICT_NEW_ENTRY, got %d", verdict);
 }
 
@@ -194,7 +187,7 @@ LONGBOW_TEST_CASE(Global, metisPit_ReceiveInterest_ExistingExpired)
     // now do the operation we're testing.  The previous entry should show as expired
     MetisPITVerdict verdict_2 = metisPIT_ReceiveInterest(generic, interest_2);
 
-    size_t table_length = parcHashCodeTable_Length(pit->table->tableByName);
+    size_t table_length = metisMatchingRulesTable_Length(pit->table);
 
     metisMessage_Release(&interest_1);
     metisMessage_Release(&interest_2);
@@ -202,7 +195,7 @@ LONGBOW_TEST_CASE(Global, metisPit_ReceiveInterest_ExistingExpired)
     metisPIT_Release(&generic);
     metisForwarder_Destroy(&metis);
 
-    assertTrue(table_length == 1, "tableByName wrong length, expected %u got %zu", 1, table_length);
+    assertTrue(table_length == 1, "table wrong length, expected %u got %zu", 1, table_length);
     assertTrue(verdict_2 == MetisPITVerdict_Forward, "New entry did not return PIT_VERDICT_NEW_ENTRY, got %d", verdict_2);
 }
 
@@ -230,7 +223,7 @@ LONGBOW_TEST_CASE(Global, metisPit_ReceiveInterest_ExistingExpired_VerifyTable)
     // now do the operation we're testing.  The previous entry should show as expired
     metisPIT_ReceiveInterest(generic, interest_2);
 
-    MetisPitEntry *entry = parcHashCodeTable_Get(pit->table->tableByName, interest_2);
+    MetisPitEntry *entry = metisMatchingRulesTable_Get(pit->table, interest_2);
     const MetisNumberSet *ingressSet = metisPitEntry_GetIngressSet(entry);
     bool containsTwo = metisNumberSet_Contains(ingressSet, 2);
 
@@ -262,14 +255,14 @@ LONGBOW_TEST_CASE(Global, metisPit_ReceiveInterest_ExistingCurrentSameReversePat
 
     // now do the operation we're testing
     MetisPITVerdict verdict_2 = metisPIT_ReceiveInterest(generic, interest_2);
-    size_t table_length = parcHashCodeTable_Length(pit->table->tableByName);
+    size_t table_length = metisMatchingRulesTable_Length(pit->table);
 
     metisMessage_Release(&interest_1);
     metisMessage_Release(&interest_2);
     metisPIT_Release(&generic);
     metisForwarder_Destroy(&metis);
 
-    assertTrue(table_length == 1, "tableByName wrong length, expected %u got %zu", 1, table_length);
+    assertTrue(table_length == 1, "table wrong length, expected %u got %zu", 1, table_length);
     assertTrue(verdict_2 == MetisPITVerdict_Forward, "New entry did not return MetisPITVerdict_Forward, got %d", verdict_2);
 }
 
@@ -294,14 +287,14 @@ LONGBOW_TEST_CASE(Global, metisPit_ReceiveInterest_ExistingCurrentNewReversePath
 
     // now do the operation we're testing
     MetisPITVerdict verdict_2 = metisPIT_ReceiveInterest(generic, interest_2);
-    size_t table_length = parcHashCodeTable_Length(pit->table->tableByName);
+    size_t table_length = metisMatchingRulesTable_Length(pit->table);
 
     metisMessage_Release(&interest_1);
     metisMessage_Release(&interest_2);
     metisPIT_Release(&generic);
     metisForwarder_Destroy(&metis);
 
-    assertTrue(table_length == 1, "tableByName wrong length, expected %u got %zu", 1, table_length);
+    assertTrue(table_length == 1, "table wrong length, expected %u got %zu", 1, table_length);
     assertTrue(verdict_2 == MetisPITVerdict_Aggregate, "New entry did not return MetisPITVerdict_Aggregate, got %d", verdict_2);
 }
 
@@ -320,21 +313,23 @@ LONGBOW_TEST_CASE(Global, metisPit_SatisfyInterest)
 
     // we manually stuff it in to the proper table, then call the public API, which will
     // figure out the right table then remove it.
-    size_t before = parcHashCodeTable_Length(pit->table->tableByName);
+    size_t before = metisMatchingRulesTable_Length(pit->table);
     _metisPIT_StoreInTable(pit, interest);
-    MetisNumberSet *ingressSetUnion = metisPIT_SatisfyInterest(generic, contentObjectMessage);
+    MetisNumberSet ingressSetUnion;
+    metisNumberSet_Initialize(&ingressSetUnion);
+    metisPIT_SatisfyInterest(generic, contentObjectMessage, &ingressSetUnion);
     metisPIT_RemoveInterest(generic, interest);
-    assertTrue(metisNumberSet_Length(ingressSetUnion) == 1, "Unexpected satisfy interest return set size (%zu)",
-               metisNumberSet_Length(ingressSetUnion));
-    size_t after = parcHashCodeTable_Length(pit->table->tableByName);
+    assertTrue(metisNumberSet_Length(&ingressSetUnion) == 1, "Unexpected satisfy interest return set size (%zu)",
+               metisNumberSet_Length(&ingressSetUnion));
+    size_t after = metisMatchingRulesTable_Length(pit->table);
 
-    metisNumberSet_Release(&ingressSetUnion);
+    metisNumberSet_Finalize(&ingressSetUnion);
     metisMessage_Release(&interest);
     metisMessage_Release(&contentObjectMessage);
     metisPIT_Release(&generic);
     metisForwarder_Destroy(&metis);
 
-    assertTrue(after == before, "Did not remove interest in HashCodeTable: before %zu after %zu", before, after);
+    assertTrue(after == before, "Did not remove interest in the table: before %zu after %zu", before, after);
 }
 
 LONGBOW_TEST_CASE(Global, metisPIT_RemoveInterest)
@@ -349,16 +344,16 @@ LONGBOW_TEST_CASE(Global, metisPIT_RemoveInterest)
 
     // we manually stuff it in to the proper table, then call the public API, which will
     // figure out the right table then remove it.
-    size_t before = parcHashCodeTable_Length(pit->table->tableByName);
+    size_t before = metisMatchingRulesTable_Length(pit->table);
     _metisPIT_StoreInTable(pit, interest);
     metisPIT_RemoveInterest(generic, interest);
-    size_t after = parcHashCodeTable_Length(pit->table->tableByName);
+    size_t after = metisMatchingRulesTable_Length(pit->table);
 
     metisMessage_Release(&interest);
     metisPIT_Release(&generic);
     metisForwarder_Destroy(&metis);
 
-    assertTrue(after == before, "Did not remove interest in HashCodeTable: before %zu after %zu", before, after);
+    assertTrue(after == before, "Did not remove interest in the table: before %zu after %zu", before, after);
 }
 
 LONGBOW_TEST_CASE(Global, metisPIT_AddEgressConnectionId)
@@ -398,6 +393,9 @@ LONGBOW_TEST_FIXTURE(Local)
     LONGBOW_RUN_TEST_CASE(Local, metisPit_StoreInTable_IngressSetCheck);
     LONGBOW_RUN_TEST_CASE(Local, _metisPIT_CalculateLifetime_WithLifetime);
     LONGBOW_RUN_TEST_CASE(Local, _metisPIT_CalculateLifetime_DefaultLifetime);
+    LONGBOW_RUN_TEST_CASE(Local, _metisPIT_ExpireEntries);
+    LONGBOW_RUN_TEST_CASE(Local, _metisPIT_ExpireEntries_BatchLimit);
+    LONGBOW_RUN_TEST_CASE(Local, _metisPIT_ExpireEntries_ExtendedLifetime);
 }
 
 LONGBOW_TEST_FIXTURE_SETUP(Local)
@@ -433,15 +431,15 @@ LONGBOW_TEST_CASE(Local, _metisPIT_StoreInTable)
     MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 1, logger);
     metisLogger_Release(&logger);
 
-    size_t before = parcHashCodeTable_Length(pit->table->tableByName);
+    size_t before = metisMatchingRulesTable_Length(pit->table);
     _metisPIT_StoreInTable(pit, interest);
-    size_t after = parcHashCodeTable_Length(pit->table->tableByName);
+    size_t after = metisMatchingRulesTable_Length(pit->table);
 
     metisMessage_Release(&interest);
     metisPIT_Release(&generic);
     metisForwarder_Destroy(&metis);
 
-    assertTrue(after == before + 1, "Did not store interest in HashCodeTable: before %zu after %zu", before, after);
+    assertTrue(after == before + 1, "Did not store interest in the table: before %zu after %zu", before, after);
 }
 
 LONGBOW_TEST_CASE(Local, metisPit_StoreInTable_IngressSetCheck)
@@ -459,7 +457,7 @@ LONGBOW_TEST_CASE(Local, metisPit_StoreInTable_IngressSetCheck)
     metisLogger_Release(&logger);
 
     _metisPIT_StoreInTable(pit, interest);
-    MetisPitEntry *entry = parcHashCodeTable_Get(pit->table->tableByName, interest);
+    MetisPitEntry *entry = metisMatchingRulesTable_Get(pit->table, interest);
     const MetisNumberSet *ingressSet = metisPitEntry_GetIngressSet(entry);
     bool containsIngressId = metisNumberSet_Contains(ingressSet, connid);
 
@@ -525,6 +523,105 @@ LONGBOW_TEST_CASE(Local, _metisPIT_CalculateLifetime_DefaultLifetime)
 
 
 
+/*
+ * An unsatisfied interest is removed from the table once the wheel passes its expiry time
+ */
+LONGBOW_TEST_CASE(Local, _metisPIT_ExpireEntries)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisPIT *generic = metisStandardPIT_Create(metis);
+    MetisStandardPIT *pit = metisPIT_Closure(generic);
+
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 1, logger);
+
+    _metisPIT_StoreInTable(pit, interest);
+    MetisPitEntry *entry = metisMatchingRulesTable_Get(pit->table, interest);
+    MetisTicks expiryTime = metisPitEntry_GetExpiryTime(entry);
+
+    size_t early = _metisPIT_ExpireEntries(pit, expiryTime - 1, METIS_PIT_EXPIRY_BATCH);
+    size_t lengthEarly = metisMatchingRulesTable_Length(pit->table);
+    size_t removed = _metisPIT_ExpireEntries(pit, expiryTime, METIS_PIT_EXPIRY_BATCH);
+    size_t lengthAfter = metisMatchingRulesTable_Length(pit->table);
+    size_t wheelCount = metisTimerWheel_Count(pit->expiryWheel);
+
+    metisMessage_Release(&interest);
+    metisPIT_Release(&generic);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(early == 0, "Removed %zu entries before expiry", early);
+    assertTrue(lengthEarly == 1, "Wrong table length before expiry, expected 1 got %zu", lengthEarly);
+    assertTrue(removed == 1, "Wrong number of expired entries, expected 1 got %zu", removed);
+    assertTrue(lengthAfter == 0, "Wrong table length after expiry, expected 0 got %zu", lengthAfter);
+    assertTrue(wheelCount == 0, "Wheel should be empty, got %zu timers", wheelCount);
+}
+
+/*
+ * Only maxEntries are removed per call, the rest wait for the next tick
+ */
+LONGBOW_TEST_CASE(Local, _metisPIT_ExpireEntries_BatchLimit)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisPIT *generic = metisStandardPIT_Create(metis);
+    MetisStandardPIT *pit = metisPIT_Closure(generic);
+
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+    MetisMessage *interest_1 = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 1, logger);
+    MetisMessage *interest_2 = metisMessage_CreateFromArray(metisTestDataV0_InterestWithOtherName, sizeof(metisTestDataV0_InterestWithOtherName), 1, 1, logger);
+
+    _metisPIT_StoreInTable(pit, interest_1);
+    _metisPIT_StoreInTable(pit, interest_2);
+
+    MetisTicks later = metisForwarder_GetTicks(metis) + metisForwarder_NanosToTicks(5000000000ULL);
+    size_t firstBatch = _metisPIT_ExpireEntries(pit, later, 1);
+    size_t lengthFirst = metisMatchingRulesTable_Length(pit->table);
+    size_t secondBatch = _metisPIT_ExpireEntries(pit, later, 1);
+    size_t lengthSecond = metisMatchingRulesTable_Length(pit->table);
+
+    metisMessage_Release(&interest_1);
+    metisMessage_Release(&interest_2);
+    metisPIT_Release(&generic);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(firstBatch == 1, "First batch should remove 1 entry, got %zu", firstBatch);
+    assertTrue(lengthFirst == 1, "Wrong table length after first batch, expected 1 got %zu", lengthFirst);
+    assertTrue(secondBatch == 1, "Second batch should remove 1 entry, got %zu", secondBatch);
+    assertTrue(lengthSecond == 0, "Wrong table length after second batch, expected 0 got %zu", lengthSecond);
+}
+
+/*
+ * An entry whose lifetime was extended after it was scheduled is rescheduled, not removed
+ */
+LONGBOW_TEST_CASE(Local, _metisPIT_ExpireEntries_ExtendedLifetime)
+{
+    MetisForwarder *metis = metisForwarder_Create(NULL);
+    MetisPIT *generic = metisStandardPIT_Create(metis);
+    MetisStandardPIT *pit = metisPIT_Closure(generic);
+
+    MetisLogger *logger = metisForwarder_GetLogger(metis);
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 1, logger);
+
+    _metisPIT_StoreInTable(pit, interest);
+    MetisPitEntry *entry = metisMatchingRulesTable_Get(pit->table, interest);
+    MetisTicks expiryTime = metisPitEntry_GetExpiryTime(entry);
+    metisPitEntry_SetExpiryTime(entry, expiryTime + 1000);
+
+    size_t removed = _metisPIT_ExpireEntries(pit, expiryTime, METIS_PIT_EXPIRY_BATCH);
+    size_t length = metisMatchingRulesTable_Length(pit->table);
+    bool hasTimer = metisPitEntry_GetExpiryTimer(entry) != NULL;
+    size_t removedLater = _metisPIT_ExpireEntries(pit, expiryTime + 1000, METIS_PIT_EXPIRY_BATCH);
+
+    metisMessage_Release(&interest);
+    metisPIT_Release(&generic);
+    metisForwarder_Destroy(&metis);
+
+    assertTrue(removed == 0, "Extended entry should not be removed, got %zu", removed);
+    assertTrue(length == 1, "Wrong table length, expected 1 got %zu", length);
+    assertTrue(hasTimer, "Extended entry should have been rescheduled");
+    assertTrue(removedLater == 1, "Extended entry should expire at its new time, got %zu", removedLater);
+}
+
+
 // ===============================================================================================
 
 int
@@ -0,0 +1,519 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+
+
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metis_TrieFIB.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/logging/parc_LogReporterTextStdout.h>
+
+#include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
+
+// An interest for lci:/foo/bar/cat
+static uint8_t _encodedInterestFooBarCat[] = {
+    0x01, 0x00, 0x00,   37, // ver = 1, type = interest, length = 37
+    0xFF, 0x00, 0x00,    8, // hoplimit = 255, header length = 8
+    // ------------------------
+    0x00, 0x01, 0x00,   25, // type = interest, length = 25
+    // ------------------------
+    0x00, 0x00, 0x00,   21,   // type = name, length = 21
+    0x00, 0x01, 0x00,    3,   // type = name, length = 3
+    'f',  'o',  'o',
+    0x00, 0x01, 0x00,    3,   // type = name, length = 3
+    'b',  'a',  'r',
+    0x00, 0x01, 0x00,    3,   // type = name, length = 3
+    'c',  'a',  't',
+};
+
+static MetisFIB *
+_createFib(void)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+    MetisFIB *fib = metisTrieFIB_Create(logger);
+    metisLogger_Release(&logger);
+    return fib;
+}
+
+static MetisMessage *
+_createInterestFooBarCat(unsigned ingressId)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+    MetisMessage *interest = metisMessage_CreateFromArray(_encodedInterestFooBarCat, sizeof(_encodedInterestFooBarCat), ingressId, 2, logger);
+    metisLogger_Release(&logger);
+    return interest;
+}
+
+static bool
+_addRoute(MetisFIB *fib, const char *uri, unsigned interfaceIndex)
+{
+    CCNxName *ccnxName = ccnxName_CreateFromCString(uri);
+    CPIRouteEntry *route = cpiRouteEntry_Create(ccnxName, interfaceIndex, NULL, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, NULL, 1);
+    bool result = metisFIB_AddOrUpdate(fib, route);
+    cpiRouteEntry_Destroy(&route);
+    return result;
+}
+
+static bool
+_removeRoute(MetisFIB *fib, const char *uri, unsigned interfaceIndex)
+{
+    CCNxName *ccnxName = ccnxName_CreateFromCString(uri);
+    CPIRouteEntry *route = cpiRouteEntry_Create(ccnxName, interfaceIndex, NULL, cpiNameRouteProtocolType_STATIC, cpiNameRouteType_LONGEST_MATCH, NULL, 1);
+    bool result = metisFIB_Remove(fib, route);
+    cpiRouteEntry_Destroy(&route);
+    return result;
+}
+
+LONGBOW_TEST_RUNNER(metis_TrieFIB)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+    LONGBOW_RUN_TEST_FIXTURE(Local);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_TrieFIB)
+{
+    parcMemory_SetInterface(&PARCSafeMemoryAsPARCMemory);
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_TrieFIB)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_Create_Destroy);
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_AddOrUpdate_Update);
+
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_Match_Exists);
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_Match_NotExists);
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_Match_Longest);
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_Match_ExcludeIngress);
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_Match_LongerRouteOnly);
+
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_Remove_NoEntry);
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_Remove_ExistsNotLast);
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_Remove_ExistsIsLast);
+
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_GetEntries);
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_RemoveConnectionIdFromRoutes);
+    LONGBOW_RUN_TEST_CASE(Global, metisTrieFIB_RemoveConnectionIdFromRoutes_ReclaimsEntries);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, metisTrieFIB_Create_Destroy)
+{
+    size_t beforeMemory = parcMemory_Outstanding();
+    MetisFIB *fib = _createFib();
+    metisFIB_Destroy(&fib);
+    size_t afterMemory = parcMemory_Outstanding();
+
+    assertNull(fib, "Destroy did not null the pointer");
+    assertTrue(beforeMemory == afterMemory, "Memory imbalance on create/destroy: expected %zu got %zu", beforeMemory, afterMemory);
+}
+
+LONGBOW_TEST_CASE(Global, metisTrieFIB_AddOrUpdate_Update)
+{
+    MetisFIB *fib = _createFib();
+    _addRoute(fib, "lci:/foo/bar", 22);
+    _addRoute(fib, "lci:/foo/bar", 33);
+
+    size_t length = metisFIB_Length(fib);
+    MetisFibEntryList *list = metisFIB_GetEntries(fib);
+    size_t nexthopCount = metisFibEntry_NexthopCount(metisFibEntryList_Get(list, 0));
+
+    metisFibEntryList_Destroy(&list);
+    metisFIB_Destroy(&fib);
+
+    assertTrue(length == 1, "Wrong length, expected 1 got %zu", length);
+    assertTrue(nexthopCount == 2, "Wrong nexthop count, expected 2 got %zu", nexthopCount);
+}
+
+/**
+ * Add /hello/ouch and lookup that name
+ */
+LONGBOW_TEST_CASE(Global, metisTrieFIB_Match_Exists)
+{
+    MetisFIB *fib = _createFib();
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithName, sizeof(metisTestDataV0_InterestWithName), 1, 2, logger);
+    metisLogger_Release(&logger);
+
+    _addRoute(fib, "lci:/2=hello/0xF000=ouch", 22);
+    const MetisNumberSet *nexthops = metisFIB_Match(fib, interest);
+    size_t nexthopsLength = metisNumberSet_Length(nexthops);
+    bool hasEgress = metisNumberSet_Contains(nexthops, 22);
+
+    metisMessage_Release(&interest);
+    metisFIB_Destroy(&fib);
+
+    assertTrue(nexthopsLength == 1, "Wrong nexthops length, expected 1 got %zu", nexthopsLength);
+    assertTrue(hasEgress, "Egress interface 22 not in nexthop set");
+}
+
+/**
+ * Add /hello/ouch and lookup /party/ouch
+ */
+LONGBOW_TEST_CASE(Global, metisTrieFIB_Match_NotExists)
+{
+    MetisFIB *fib = _createFib();
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+    MetisMessage *interest = metisMessage_CreateFromArray(metisTestDataV0_InterestWithOtherName, sizeof(metisTestDataV0_InterestWithOtherName), 1, 2, logger);
+    metisLogger_Release(&logger);
+
+    _addRoute(fib, "lci:/2=hello/0xF000=ouch", 22);
+    const MetisNumberSet *nexthops = metisFIB_Match(fib, interest);
+    size_t nexthopsLength = metisNumberSet_Length(nexthops);
+
+    metisMessage_Release(&interest);
+    metisFIB_Destroy(&fib);
+
+    assertTrue(nexthopsLength == 0, "Wrong nexthops length, expected 0 got %zu", nexthopsLength);
+}
+
+/**
+ * Add /foo to 11, /foo/bar to 12, /foo/baz to 13.  /foo/bar/cat should match 12.
+ */
+LONGBOW_TEST_CASE(Global, metisTrieFIB_Match_Longest)
+{
+    MetisFIB *fib = _createFib();
+    MetisMessage *interest = _createInterestFooBarCat(1);
+
+    _addRoute(fib, "lci:/foo", 11);
+    _addRoute(fib, "lci:/foo/bar", 12);
+    _addRoute(fib, "lci:/foo/baz", 13);
+
+    const MetisNumberSet *nexthops = metisFIB_Match(fib, interest);
+    size_t nexthopsLength = metisNumberSet_Length(nexthops);
+    bool hasEgress = metisNumberSet_Contains(nexthops, 12);
+
+    metisMessage_Release(&interest);
+    metisFIB_Destroy(&fib);
+
+    assertTrue(nexthopsLength == 1, "Wrong nexthops length, expected 1 got %zu", nexthopsLength);
+    assertTrue(hasEgress, "Egress interface 12 not in nexthop set");
+}
+
+/**
+ * Add /foo/bar to connection 10
+ * Add /foo to connection 11
+ * Forward an Interest /foo/bar/cat from connection 10.  Should select 11.
+ */
+LONGBOW_TEST_CASE(Global, metisTrieFIB_Match_ExcludeIngress)
+{
+    MetisFIB *fib = _createFib();
+    MetisMessage *interest = _createInterestFooBarCat(10);
+
+    _addRoute(fib, "lci:/foo/bar", 10);
+    _addRoute(fib, "lci:/foo", 11);
+
+    const MetisNumberSet *nexthops = metisFIB_Match(fib, interest);
+    size_t nexthopsLength = metisNumberSet_Length(nexthops);
+    bool hasEgress = metisNumberSet_Contains(nexthops, 11);
+
+    metisMessage_Release(&interest);
+    metisFIB_Destroy(&fib);
+
+    assertTrue(nexthopsLength == 1, "Wrong nexthops length, expected 1 got %zu", nexthopsLength);
+    assertTrue(hasEgress, "Egress interface 11 not in nexthop set");
+}
+
+/**
+ * A route longer than the interest name, or one that ends inside a compressed edge, must not match.
+ * Add /foo/bar/cat/dog and /foo/bar/cow, lookup /foo/bar/cat.
+ */
+LONGBOW_TEST_CASE(Global, metisTrieFIB_Match_LongerRouteOnly)
+{
+    MetisFIB *fib = _createFib();
+    MetisMessage *interest = _createInterestFooBarCat(1);
+
+    _addRoute(fib, "lci:/foo/bar/cat/dog", 11);
+    _addRoute(fib, "lci:/foo/bar/cow", 12);
+
+    const MetisNumberSet *nexthops = metisFIB_Match(fib, interest);
+    size_t nexthopsLength = metisNumberSet_Length(nexthops);
+
+    metisMessage_Release(&interest);
+    metisFIB_Destroy(&fib);
+
+    assertTrue(nexthopsLength == 0, "Wrong nexthops length, expected 0 got %zu", nexthopsLength);
+}
+
+LONGBOW_TEST_CASE(Global, metisTrieFIB_Remove_NoEntry)
+{
+    MetisFIB *fib = _createFib();
+    _addRoute(fib, "lci:/foo/bar", 22);
+
+    bool removed = _removeRoute(fib, "lci:/baz", 22);
+    bool removedPrefix = _removeRoute(fib, "lci:/foo", 22);
+    size_t length = metisFIB_Length(fib);
+
+    metisFIB_Destroy(&fib);
+
+    assertFalse(removed, "Should not have removed a route that does not exist");
+    assertFalse(removedPrefix, "Should not have removed a route for a prefix with no entry");
+    assertTrue(length == 1, "Wrong length, expected 1 got %zu", length);
+}
+
+LONGBOW_TEST_CASE(Global, metisTrieFIB_Remove_ExistsNotLast)
+{
+    MetisFIB *fib = _createFib();
+    _addRoute(fib, "lci:/foo/bar", 22);
+    _addRoute(fib, "lci:/foo/bar", 33);
+
+    bool removed = _removeRoute(fib, "lci:/foo/bar", 22);
+    size_t length = metisFIB_Length(fib);
+
+    metisFIB_Destroy(&fib);
+
+    assertFalse(removed, "Route should remain while it has a nexthop");
+    assertTrue(length == 1, "Wrong length, expected 1 got %zu", length);
+}
+
+LONGBOW_TEST_CASE(Global, metisTrieFIB_Remove_ExistsIsLast)
+{
+    MetisFIB *fib = _createFib();
+    _addRoute(fib, "lci:/foo/bar", 22);
+
+    bool removed = _removeRoute(fib, "lci:/foo/bar", 22);
+    size_t length = metisFIB_Length(fib);
+    MetisTrieFIB *trie = metisFIB_Closure(fib);
+    size_t rootChildren = trie->root->childrenLength;
+
+    metisFIB_Destroy(&fib);
+
+    assertTrue(removed, "Route should have been removed");
+    assertTrue(length == 0, "Wrong length, expected 0 got %zu", length);
+    assertTrue(rootChildren == 0, "Trie should be empty, root has %zu children", rootChildren);
+}
+
+LONGBOW_TEST_CASE(Global, metisTrieFIB_GetEntries)
+{
+    MetisFIB *fib = _createFib();
+    _addRoute(fib, "lci:/foo", 11);
+    _addRoute(fib, "lci:/foo/bar/cat", 12);
+    _addRoute(fib, "lci:/foo/bar/dog", 13);
+    _addRoute(fib, "lci:/baz", 14);
+
+    MetisFibEntryList *list = metisFIB_GetEntries(fib);
+    size_t listLength = metisFibEntryList_Length(list);
+    size_t fibLength = metisFIB_Length(fib);
+
+    metisFibEntryList_Destroy(&list);
+    metisFIB_Destroy(&fib);
+
+    assertTrue(listLength == 4, "Wrong list length, expected 4 got %zu", listLength);
+    assertTrue(fibLength == 4, "Wrong FIB length, expected 4 got %zu", fibLength);
+}
+
+LONGBOW_TEST_CASE(Global, metisTrieFIB_RemoveConnectionIdFromRoutes)
+{
+    MetisFIB *fib = _createFib();
+    MetisMessage *interest = _createInterestFooBarCat(1);
+
+    _addRoute(fib, "lci:/foo", 11);
+    _addRoute(fib, "lci:/foo/bar", 12);
+    _addRoute(fib, "lci:/foo/bar", 13);
+
+    metisFIB_RemoveConnectionIdFromRoutes(fib, 12);
+    const MetisNumberSet *nexthops = metisFIB_Match(fib, interest);
+    size_t nexthopsLength = metisNumberSet_Length(nexthops);
+    bool hasEgress = metisNumberSet_Contains(nexthops, 13);
+
+    metisMessage_Release(&interest);
+    metisFIB_Destroy(&fib);
+
+    assertTrue(nexthopsLength == 1, "Wrong nexthops length, expected 1 got %zu", nexthopsLength);
+    assertTrue(hasEgress, "Egress interface 13 not in nexthop set");
+}
+
+/**
+ * Removing the only nexthop of /foo/bar/cat and /foo/bar/dog removes those entries and
+ * compresses the trie back to the /foo route.
+ */
+LONGBOW_TEST_CASE(Global, metisTrieFIB_RemoveConnectionIdFromRoutes_ReclaimsEntries)
+{
+    MetisFIB *fib = _createFib();
+    MetisTrieFIB *trie = metisFIB_Closure(fib);
+
+    _addRoute(fib, "lci:/foo", 11);
+    _addRoute(fib, "lci:/foo/bar/cat", 12);
+    _addRoute(fib, "lci:/foo/bar/dog", 12);
+
+    metisFIB_RemoveConnectionIdFromRoutes(fib, 12);
+    size_t length = metisFIB_Length(fib);
+    size_t indexCount = metisFibConnectionIndex_Count(trie->connectionIndex, 12);
+    size_t rootChildren = trie->root->childrenLength;
+    size_t fooChildren = trie->root->children[0]->childrenLength;
+
+    metisFIB_Destroy(&fib);
+
+    assertTrue(length == 1, "Wrong length, expected 1 got %zu", length);
+    assertTrue(indexCount == 0, "Connection 12 should have no routes, got %zu", indexCount);
+    assertTrue(rootChildren == 1, "Root should have 1 child, got %zu", rootChildren);
+    assertTrue(fooChildren == 0, "/foo should have no children, got %zu", fooChildren);
+}
+
+// ====================================================================
+
+LONGBOW_TEST_FIXTURE(Local)
+{
+    LONGBOW_RUN_TEST_CASE(Local, _metisTrieFIB_FindNode_SplitEdge);
+    LONGBOW_RUN_TEST_CASE(Local, _metisTrieFIB_Compress);
+}
+
+LONGBOW_TEST_FIXTURE_SETUP(Local)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Local)
+{
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+/**
+ * Adding /foo/bar/cat puts a single 3-segment edge under the root.  Adding /foo/bar/dog
+ * splits it at /foo/bar, which has two children in sorted order.
+ */
+LONGBOW_TEST_CASE(Local, _metisTrieFIB_FindNode_SplitEdge)
+{
+    MetisFIB *fib = _createFib();
+    MetisTrieFIB *trie = metisFIB_Closure(fib);
+
+    _addRoute(fib, "lci:/foo/bar/cat", 11);
+    assertTrue(trie->root->childrenLength == 1, "Root should have 1 child, got %zu", trie->root->childrenLength);
+    assertTrue(trie->root->children[0]->segmentCount == 3, "Edge should be 3 segments, got %zu", trie->root->children[0]->segmentCount);
+
+    _addRoute(fib, "lci:/foo/bar/dog", 12);
+    _MetisTrieNode *middle = trie->root->children[0];
+    assertTrue(middle->segmentCount == 2, "Split node should be 2 segments, got %zu", middle->segmentCount);
+    assertNull(middle->entry, "Split node should not have a route");
+    assertTrue(middle->childrenLength == 2, "Split node should have 2 children, got %zu", middle->childrenLength);
+    assertTrue(metisTlvName_SegmentCompare(middle->children[0]->name, 2, middle->children[1]->name, 2) < 0, "Children out of order");
+
+    // a route that ends exactly at the split point
+    _addRoute(fib, "lci:/foo/bar", 13);
+    assertTrue(trie->root->children[0] == middle, "Adding /foo/bar should reuse the split node");
+    assertNotNull(middle->entry, "Split node should now have a route");
+
+    metisFIB_Destroy(&fib);
+}
+
+/**
+ * Removing a route leaves no node without a route and with fewer than two children
+ */
+LONGBOW_TEST_CASE(Local, _metisTrieFIB_Compress)
+{
+    MetisFIB *fib = _createFib();
+    MetisTrieFIB *trie = metisFIB_Closure(fib);
+
+    _addRoute(fib, "lci:/foo/bar/cat", 11);
+    _addRoute(fib, "lci:/foo/bar/dog", 12);
+    _removeRoute(fib, "lci:/foo/bar/dog", 12);
+
+    assertTrue(trie->root->childrenLength == 1, "Root should have 1 child, got %zu", trie->root->childrenLength);
+    _MetisTrieNode *leaf = trie->root->children[0];
+    assertTrue(leaf->segmentCount == 3, "Edges should have merged to 3 segments, got %zu", leaf->segmentCount);
+    assertTrue(leaf->parent == trie->root, "Merged node has wrong parent");
+    assertNotNull(leaf->entry, "Merged node should have a route");
+
+    metisFIB_Destroy(&fib);
+}
+
+// ====================================================================
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_TrieFIB);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
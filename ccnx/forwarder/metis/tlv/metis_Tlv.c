@@ -179,6 +179,13 @@ _metisTlv_ParseName(uint8_t *name, size_t nameLength, MetisTlvExtent *outputArra
     return count;
 }
 
+size_t
+metisTlv_ParseNameSegments(uint8_t *name, size_t nameLength, MetisTlvExtent *outputArray, size_t outputLength)
+{
+    assertTrue(outputLength == 0 || outputArray != NULL, "Parameter outputArray must be non-null for a positive outputLength");
+    return _metisTlv_ParseName(name, nameLength, outputArray, outputLength);
+}
+
 void
 metisTlv_NameSegments(uint8_t *name, size_t nameLength, MetisTlvExtent **outputArrayPtr, size_t *outputLengthPtr)
 {
@@ -210,6 +210,31 @@ size_t metisTlv_TotalPacketLength(const uint8_t *packet);
  */
 void metisTlv_NameSegments(uint8_t *name, size_t nameLength, MetisTlvExtent **outputArrayPtr, size_t *outputLengthPtr);
 
+/**
+ * @function metisTlv_ParseNameSegments
+ * @abstract Like metisTlv_NameSegments(), but in to a caller-supplied array
+ * @discussion
+ *   Fills in at most outputLength extents and returns the number of segments in the name, which
+ *   may be larger than outputLength.  Call it with a NULL array and 0 length to count the segments.
+ *
+ * @param name is a TLV-encoded name, not including the container name TLV
+ * @param nameLength is the length of the name
+ * @param outputArray receives the extents, may be NULL if outputLength is 0
+ * @param outputLength is the number of elements in outputArray
+ * @return The number of segments in the name
+ *
+ * Example:
+ * @code
+ * {
+ *    uint8_t encodedName[] = "\x00\x01\x00\x05" "apple" "\x00\x01\x00\x03" "pie";
+ *    size_t count = metisTlv_ParseNameSegments(encodedName, sizeof(encodedName) - 1, NULL, 0);
+ *    MetisTlvExtent extentArray[count];
+ *    metisTlv_ParseNameSegments(encodedName, sizeof(encodedName) - 1, extentArray, count);
+ * }
+ * @endcode
+ */
+size_t metisTlv_ParseNameSegments(uint8_t *name, size_t nameLength, MetisTlvExtent *outputArray, size_t outputLength);
+
 /**
  * Given a CCNxControl packet, encode it in the proper schema
  *
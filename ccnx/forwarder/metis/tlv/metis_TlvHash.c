@@ -0,0 +1,548 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * The three SHA-256 implementations share the padding code in _sha256 and differ only in how they
+ * compress 64-byte blocks.  The AVX2 code keeps eight independent states, one per 32-bit lane, and
+ * masks out the lanes whose message has no more blocks.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#include <config.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define METIS_TLV_HASH_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#include <ccnx/forwarder/metis/tlv/metis_TlvHash.h>
+
+#include <parc/algol/parc_Buffer.h>
+#include <LongBow/runtime.h>
+
+#define SHA256_BLOCK_LENGTH 64
+
+// The padding is a 0x80 byte and a 64-bit length, so the last one or two blocks are built here
+#define SHA256_TAIL_LENGTH (2 * SHA256_BLOCK_LENGTH)
+
+typedef void (_MetisTlvHashCompress)(uint32_t state[8], const uint8_t *blocks, size_t blockCount);
+
+static const uint32_t _initialState[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static const uint32_t _k[64] __attribute__((aligned(16))) = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static inline uint32_t
+_load32(const uint8_t *p)
+{
+    return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | (uint32_t) p[3];
+}
+
+static inline void
+_store32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t) (value >> 24);
+    p[1] = (uint8_t) (value >> 16);
+    p[2] = (uint8_t) (value >> 8);
+    p[3] = (uint8_t) value;
+}
+
+/**
+ * Builds the padded last blocks of a message in tail
+ *
+ * @return The number of blocks in tail, 1 or 2
+ */
+static size_t
+_padTail(const uint8_t *data, size_t length, uint8_t tail[SHA256_TAIL_LENGTH])
+{
+    size_t remainder = length % SHA256_BLOCK_LENGTH;
+    size_t tailBlocks = (remainder + 1 + 8 > SHA256_BLOCK_LENGTH) ? 2 : 1;
+    size_t tailLength = tailBlocks * SHA256_BLOCK_LENGTH;
+
+    memset(tail, 0, tailLength);
+    if (remainder > 0) {
+        memcpy(tail, data + length - remainder, remainder);
+    }
+    tail[remainder] = 0x80;
+
+    uint64_t bits = (uint64_t) length * 8;
+    _store32(tail + tailLength - 8, (uint32_t) (bits >> 32));
+    _store32(tail + tailLength - 4, (uint32_t) bits);
+    return tailBlocks;
+}
+
+static void
+_finish(const uint32_t state[8], uint8_t digest[METIS_TLV_HASH_DIGEST_LENGTH])
+{
+    for (int i = 0; i < 8; i++) {
+        _store32(digest + 4 * i, state[i]);
+    }
+}
+
+static void
+_sha256(_MetisTlvHashCompress *compress, const uint8_t *data, size_t length, uint8_t digest[METIS_TLV_HASH_DIGEST_LENGTH])
+{
+    uint32_t state[8];
+    memcpy(state, _initialState, sizeof(state));
+
+    size_t fullBlocks = length / SHA256_BLOCK_LENGTH;
+    if (fullBlocks > 0) {
+        compress(state, data, fullBlocks);
+    }
+
+    uint8_t tail[SHA256_TAIL_LENGTH];
+    size_t tailBlocks = _padTail(data, length, tail);
+    compress(state, tail, tailBlocks);
+
+    _finish(state, digest);
+}
+
+// ==========================================================================
+// Generic
+
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void
+_compressGeneric(uint32_t state[8], const uint8_t *blocks, size_t blockCount)
+{
+    uint32_t w[64];
+
+    for (size_t block = 0; block < blockCount; block++) {
+        const uint8_t *p = blocks + block * SHA256_BLOCK_LENGTH;
+        for (int t = 0; t < 16; t++) {
+            w[t] = _load32(p + 4 * t);
+        }
+        for (int t = 16; t < 64; t++) {
+            uint32_t s0 = ROTR32(w[t - 15], 7) ^ ROTR32(w[t - 15], 18) ^ (w[t - 15] >> 3);
+            uint32_t s1 = ROTR32(w[t - 2], 17) ^ ROTR32(w[t - 2], 19) ^ (w[t - 2] >> 10);
+            w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int t = 0; t < 64; t++) {
+            uint32_t t1 = h + (ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25)) + ((e & f) ^ (~e & g)) + _k[t] + w[t];
+            uint32_t t2 = (ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+#ifdef METIS_TLV_HASH_X86
+// ==========================================================================
+// SHA-NI
+
+__attribute__((target("sha,sse4.1,ssse3")))
+static void
+_compressShaNi(uint32_t state[8], const uint8_t *blocks, size_t blockCount)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // The instructions want the state as ABEF and CDGH
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &state[0]), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *) &state[4]), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for (size_t block = 0; block < blockCount; block++) {
+        const uint8_t *p = blocks + block * SHA256_BLOCK_LENGTH;
+        __m128i abefSave = state0;
+        __m128i cdghSave = state1;
+
+        // w[i & 3] holds message words 4i to 4i+3, computed four rounds before they are used
+        __m128i w[4];
+        for (int i = 0; i < 4; i++) {
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) (p + 16 * i)), byteSwap);
+        }
+
+        for (int i = 0; i < 16; i++) {
+            __m128i message = _mm_add_epi32(w[i & 3], _mm_load_si128((const __m128i *) &_k[4 * i]));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, message);
+            message = _mm_shuffle_epi32(message, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, message);
+
+            if (i < 12) {
+                __m128i next = _mm_sha256msg1_epu32(w[i & 3], w[(i + 1) & 3]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(w[(i + 3) & 3], w[(i + 2) & 3], 4));
+                w[i & 3] = _mm_sha256msg2_epu32(next, w[(i + 3) & 3]);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    _mm_storeu_si128((__m128i *) &state[0], _mm_blend_epi16(tmp, state1, 0xF0));
+    _mm_storeu_si128((__m128i *) &state[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+
+// ==========================================================================
+// AVX2, eight messages per call
+
+#define AVX2_ROTR(x, n) _mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+
+/**
+ * Hashes up to METIS_TLV_HASH_BATCH_WIDTH messages, one per lane.  Lanes that run out of blocks
+ * keep computing on a zero block but their state is not updated.
+ */
+__attribute__((target("avx2")))
+static void
+_batchAvx2(size_t count, const uint8_t *const data[], const size_t lengths[], uint8_t digests[][METIS_TLV_HASH_DIGEST_LENGTH])
+{
+    static const uint8_t zeroBlock[SHA256_BLOCK_LENGTH] = { 0 };
+
+    uint8_t tails[METIS_TLV_HASH_BATCH_WIDTH][SHA256_TAIL_LENGTH];
+    size_t fullBlocks[METIS_TLV_HASH_BATCH_WIDTH];
+    size_t totalBlocks[METIS_TLV_HASH_BATCH_WIDTH];
+    size_t maxBlocks = 0;
+
+    for (size_t lane = 0; lane < METIS_TLV_HASH_BATCH_WIDTH; lane++) {
+        if (lane < count) {
+            fullBlocks[lane] = lengths[lane] / SHA256_BLOCK_LENGTH;
+            totalBlocks[lane] = fullBlocks[lane] + _padTail(data[lane], lengths[lane], tails[lane]);
+        } else {
+            fullBlocks[lane] = 0;
+            totalBlocks[lane] = 0;
+        }
+        if (totalBlocks[lane] > maxBlocks) {
+            maxBlocks = totalBlocks[lane];
+        }
+    }
+
+    __m256i state[8];
+    for (int i = 0; i < 8; i++) {
+        state[i] = _mm256_set1_epi32((int) _initialState[i]);
+    }
+
+    for (size_t block = 0; block < maxBlocks; block++) {
+        const uint8_t *p[METIS_TLV_HASH_BATCH_WIDTH];
+        int32_t active[METIS_TLV_HASH_BATCH_WIDTH];
+        for (size_t lane = 0; lane < METIS_TLV_HASH_BATCH_WIDTH; lane++) {
+            if (block < fullBlocks[lane]) {
+                p[lane] = data[lane] + block * SHA256_BLOCK_LENGTH;
+            } else if (block < totalBlocks[lane]) {
+                p[lane] = tails[lane] + (block - fullBlocks[lane]) * SHA256_BLOCK_LENGTH;
+            } else {
+                p[lane] = zeroBlock;
+            }
+            active[lane] = (block < totalBlocks[lane]) ? -1 : 0;
+        }
+        __m256i mask = _mm256_loadu_si256((const __m256i *) active);
+
+        __m256i w[16];
+        for (int t = 0; t < 16; t++) {
+            w[t] = _mm256_set_epi32((int) _load32(p[7] + 4 * t), (int) _load32(p[6] + 4 * t),
+                                    (int) _load32(p[5] + 4 * t), (int) _load32(p[4] + 4 * t),
+                                    (int) _load32(p[3] + 4 * t), (int) _load32(p[2] + 4 * t),
+                                    (int) _load32(p[1] + 4 * t), (int) _load32(p[0] + 4 * t));
+        }
+
+        __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+        __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int t = 0; t < 64; t++) {
+            // the message schedule is kept in a ring of 16 words
+            if (t >= 16) {
+                __m256i w15 = w[(t - 15) & 15];
+                __m256i w2 = w[(t - 2) & 15];
+                __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(w15, 7), AVX2_ROTR(w15, 18)), _mm256_srli_epi32(w15, 3));
+                __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(w2, 17), AVX2_ROTR(w2, 19)), _mm256_srli_epi32(w2, 10));
+                w[t & 15] = _mm256_add_epi32(_mm256_add_epi32(w[t & 15], s0), _mm256_add_epi32(w[(t - 7) & 15], s1));
+            }
+
+            __m256i sigma1 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(e, 6), AVX2_ROTR(e, 11)), AVX2_ROTR(e, 25));
+            __m256i choose = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+            __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, sigma1), _mm256_add_epi32(choose, w[t & 15]));
+            t1 = _mm256_add_epi32(t1, _mm256_set1_epi32((int) _k[t]));
+
+            __m256i sigma0 = _mm256_xor_si256(_mm256_xor_si256(AVX2_ROTR(a, 2), AVX2_ROTR(a, 13)), AVX2_ROTR(a, 22));
+            __m256i majority = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+            __m256i t2 = _mm256_add_epi32(sigma0, majority);
+
+            h = g;
+            g = f;
+            f = e;
+            e = _mm256_add_epi32(d, t1);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm256_add_epi32(t1, t2);
+        }
+
+        __m256i work[8] = { a, b, c, d, e, f, g, h };
+        for (int i = 0; i < 8; i++) {
+            state[i] = _mm256_blendv_epi8(state[i], _mm256_add_epi32(state[i], work[i]), mask);
+        }
+    }
+
+    uint32_t lanes[8][METIS_TLV_HASH_BATCH_WIDTH];
+    for (int i = 0; i < 8; i++) {
+        _mm256_storeu_si256((__m256i *) lanes[i], state[i]);
+    }
+    for (size_t lane = 0; lane < count; lane++) {
+        for (int i = 0; i < 8; i++) {
+            _store32(digests[lane] + 4 * i, lanes[i][lane]);
+        }
+    }
+}
+
+static bool
+_cpuHasShaNi(void)
+{
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    bool ssse3 = (ecx & bit_SSSE3) != 0;
+    bool sse41 = (ecx & bit_SSE4_1) != 0;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    bool sha = (ebx & (1u << 29)) != 0;
+
+    return ssse3 && sse41 && sha;
+}
+
+static bool
+_cpuHasAvx2(void)
+{
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+
+    // The OS must save the YMM registers
+    if ((ecx & bit_OSXSAVE) == 0 || (ecx & bit_AVX) == 0) {
+        return false;
+    }
+    unsigned xcr0Low, xcr0High;
+    __asm__ ("xgetbv" : "=a" (xcr0Low), "=d" (xcr0High) : "c" (0));
+    if ((xcr0Low & 0x6) != 0x6) {
+        return false;
+    }
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return (ebx & bit_AVX2) != 0;
+}
+#endif // METIS_TLV_HASH_X86
+
+// ==========================================================================
+// Dispatch
+
+static pthread_once_t _backendOnce = PTHREAD_ONCE_INIT;
+static bool _backendSupported[MetisTlvHashBackend_END];
+static MetisTlvHashBackend _backend = MetisTlvHashBackend_Generic;
+static _MetisTlvHashCompress *_compress = _compressGeneric;
+
+static const char *_backendNames[MetisTlvHashBackend_END] = {
+    [MetisTlvHashBackend_Generic] = "generic",
+    [MetisTlvHashBackend_Avx2]    = "avx2",
+    [MetisTlvHashBackend_ShaNi]   = "sha-ni",
+};
+
+static void
+_selectBackend(MetisTlvHashBackend backend)
+{
+    _backend = backend;
+#ifdef METIS_TLV_HASH_X86
+    _compress = (backend == MetisTlvHashBackend_ShaNi) ? _compressShaNi : _compressGeneric;
+#else
+    _compress = _compressGeneric;
+#endif
+}
+
+static void
+_initBackend(void)
+{
+    _backendSupported[MetisTlvHashBackend_Generic] = true;
+#ifdef METIS_TLV_HASH_X86
+    _backendSupported[MetisTlvHashBackend_Avx2] = _cpuHasAvx2();
+    _backendSupported[MetisTlvHashBackend_ShaNi] = _cpuHasShaNi();
+#endif
+
+    if (_backendSupported[MetisTlvHashBackend_ShaNi]) {
+        _selectBackend(MetisTlvHashBackend_ShaNi);
+    } else if (_backendSupported[MetisTlvHashBackend_Avx2]) {
+        _selectBackend(MetisTlvHashBackend_Avx2);
+    } else {
+        _selectBackend(MetisTlvHashBackend_Generic);
+    }
+}
+
+void
+metisTlvHash_Sha256(const uint8_t *data, size_t length, uint8_t digest[METIS_TLV_HASH_DIGEST_LENGTH])
+{
+    assertTrue(length == 0 || data != NULL, "Parameter data must be non-null");
+    assertNotNull(digest, "Parameter digest must be non-null");
+
+    pthread_once(&_backendOnce, _initBackend);
+    _sha256(_compress, data, length, digest);
+}
+
+void
+metisTlvHash_Sha256Batch(size_t count, const uint8_t *const data[], const size_t lengths[], uint8_t digests[][METIS_TLV_HASH_DIGEST_LENGTH])
+{
+    assertTrue(count == 0 || (data != NULL && lengths != NULL && digests != NULL), "Parameters must be non-null");
+
+    pthread_once(&_backendOnce, _initBackend);
+
+#ifdef METIS_TLV_HASH_X86
+    if (_backend == MetisTlvHashBackend_Avx2) {
+        // A batch of one would pay for eight lanes, so leftovers of one go through the generic code
+        size_t i = 0;
+        while (count - i > 1) {
+            size_t width = (count - i < METIS_TLV_HASH_BATCH_WIDTH) ? count - i : METIS_TLV_HASH_BATCH_WIDTH;
+            _batchAvx2(width, &data[i], &lengths[i], &digests[i]);
+            i += width;
+        }
+        if (i < count) {
+            _sha256(_compressGeneric, data[i], lengths[i], digests[i]);
+        }
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < count; i++) {
+        _sha256(_compress, data[i], lengths[i], digests[i]);
+    }
+}
+
+PARCCryptoHash *
+metisTlvHash_CryptoHashFromDigest(const uint8_t digest[METIS_TLV_HASH_DIGEST_LENGTH])
+{
+    PARCBuffer *buffer = parcBuffer_Allocate(METIS_TLV_HASH_DIGEST_LENGTH);
+    parcBuffer_PutArray(buffer, METIS_TLV_HASH_DIGEST_LENGTH, digest);
+    parcBuffer_Flip(buffer);
+
+    PARCCryptoHash *hash = parcCryptoHash_Create(PARCCryptoHashType_SHA256, buffer);
+    parcBuffer_Release(&buffer);
+    return hash;
+}
+
+PARCCryptoHash *
+metisTlvHash_CreateCryptoHash(const uint8_t *data, size_t length)
+{
+    uint8_t digest[METIS_TLV_HASH_DIGEST_LENGTH];
+    metisTlvHash_Sha256(data, length, digest);
+    return metisTlvHash_CryptoHashFromDigest(digest);
+}
+
+MetisTlvHashBackend
+metisTlvHash_GetBackend(void)
+{
+    pthread_once(&_backendOnce, _initBackend);
+    return _backend;
+}
+
+bool
+metisTlvHash_IsBackendSupported(MetisTlvHashBackend backend)
+{
+    pthread_once(&_backendOnce, _initBackend);
+    return (backend < MetisTlvHashBackend_END) && _backendSupported[backend];
+}
+
+bool
+metisTlvHash_SetBackend(MetisTlvHashBackend backend)
+{
+    if (!metisTlvHash_IsBackendSupported(backend)) {
+        return false;
+    }
+    _selectBackend(backend);
+    return true;
+}
+
+const char *
+metisTlvHash_BackendName(MetisTlvHashBackend backend)
+{
+    assertTrue(backend < MetisTlvHashBackend_END, "Invalid backend %d", backend);
+    return _backendNames[backend];
+}
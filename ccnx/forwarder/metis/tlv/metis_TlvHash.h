@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @file metis_TlvHash.h
+ * @brief SHA-256 of content objects, using the CPU's SHA extensions when it has them
+ *
+ * The ContentObjectHash is the SHA-256 of a content object from the end of its fixed and optional
+ * headers to the end of the packet.  When every interest carries a ContentObjectHash restriction
+ * the forwarder computes one of these per object, so the hash is usually the most expensive thing
+ * it does.
+ *
+ * There are three implementations, picked once at run time from what the CPU supports:
+ *
+ *   - MetisTlvHashBackend_ShaNi uses the x86 SHA extensions, one message at a time.  It is the
+ *     fastest for a single message and for batches.
+ *   - MetisTlvHashBackend_Avx2 hashes up to 8 messages at once, one per 32-bit lane of the AVX2
+ *     registers.  It is only used by metisTlvHash_Sha256Batch(); a single message uses the generic code.
+ *   - MetisTlvHashBackend_Generic is portable C.
+ *
+ * All three give the same digests.  metisTlvHash_SetBackend() overrides the choice, for tests and benchmarks.
+ *
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+
+#ifndef Metis_metis_TlvHash_h
+#define Metis_metis_TlvHash_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <parc/security/parc_CryptoHash.h>
+
+#define METIS_TLV_HASH_DIGEST_LENGTH 32
+
+/**
+ * The number of messages the AVX2 backend hashes together.  Callers of metisTlvHash_Sha256Batch()
+ * get the most out of it with batches of this many messages.
+ */
+#define METIS_TLV_HASH_BATCH_WIDTH 8
+
+typedef enum {
+    MetisTlvHashBackend_Generic,
+    MetisTlvHashBackend_Avx2,
+    MetisTlvHashBackend_ShaNi,
+    MetisTlvHashBackend_END             // sentinel value
+} MetisTlvHashBackend;
+
+/**
+ * The SHA-256 digest of a buffer
+ *
+ * @param [in] data The bytes to hash, may be NULL if length is 0
+ * @param [in] length The number of bytes
+ * @param [out] digest The digest
+ *
+ * Example:
+ * @code
+ * {
+ *     uint8_t digest[METIS_TLV_HASH_DIGEST_LENGTH];
+ *     metisTlvHash_Sha256(packet + endHeaders, endPacket - endHeaders, digest);
+ * }
+ * @endcode
+ */
+void metisTlvHash_Sha256(const uint8_t *data, size_t length, uint8_t digest[METIS_TLV_HASH_DIGEST_LENGTH]);
+
+/**
+ * The SHA-256 digests of several buffers
+ *
+ * Gives the same digests as calling metisTlvHash_Sha256() on each buffer, but with the AVX2 backend
+ * it hashes METIS_TLV_HASH_BATCH_WIDTH buffers in the time of about two.  Any count may be used.
+ *
+ * @param [in] count The number of buffers
+ * @param [in] data The buffers
+ * @param [in] lengths The length of each buffer
+ * @param [out] digests The digest of each buffer
+ *
+ * Example:
+ * @code
+ * {
+ *     const uint8_t *data[2] = { a, b };
+ *     size_t lengths[2] = { aLength, bLength };
+ *     uint8_t digests[2][METIS_TLV_HASH_DIGEST_LENGTH];
+ *     metisTlvHash_Sha256Batch(2, data, lengths, digests);
+ * }
+ * @endcode
+ */
+void metisTlvHash_Sha256Batch(size_t count, const uint8_t *const data[], const size_t lengths[], uint8_t digests[][METIS_TLV_HASH_DIGEST_LENGTH]);
+
+/**
+ * The SHA-256 digest of a buffer, as a PARCCryptoHash
+ *
+ * @param [in] data The bytes to hash
+ * @param [in] length The number of bytes
+ *
+ * @return non-null An allocated PARCCryptoHash of type PARCCryptoHashType_SHA256, must be released
+ *
+ * Example:
+ * @code
+ * {
+ *     PARCCryptoHash *hash = metisTlvHash_CreateCryptoHash(packet + endHeaders, endPacket - endHeaders);
+ *     // ...
+ *     parcCryptoHash_Release(&hash);
+ * }
+ * @endcode
+ */
+PARCCryptoHash *metisTlvHash_CreateCryptoHash(const uint8_t *data, size_t length);
+
+/**
+ * Wraps a digest from metisTlvHash_Sha256() or metisTlvHash_Sha256Batch() in a PARCCryptoHash
+ *
+ * @param [in] digest A SHA-256 digest
+ *
+ * @return non-null An allocated PARCCryptoHash of type PARCCryptoHashType_SHA256, must be released
+ */
+PARCCryptoHash *metisTlvHash_CryptoHashFromDigest(const uint8_t digest[METIS_TLV_HASH_DIGEST_LENGTH]);
+
+/**
+ * The backend in use
+ *
+ * Unless metisTlvHash_SetBackend() has been called, this is the fastest one the CPU supports.
+ *
+ * @return The backend used by metisTlvHash_Sha256Batch()
+ */
+MetisTlvHashBackend metisTlvHash_GetBackend(void);
+
+/**
+ * Determines if the CPU supports a backend
+ *
+ * @param [in] backend A backend
+ *
+ * @retval true The backend may be used
+ * @retval false The CPU or the compiler does not support it
+ */
+bool metisTlvHash_IsBackendSupported(MetisTlvHashBackend backend);
+
+/**
+ * Selects the backend
+ *
+ * @param [in] backend A backend
+ *
+ * @retval true The backend is now in use
+ * @retval false The backend is not supported, the backend in use is unchanged
+ */
+bool metisTlvHash_SetBackend(MetisTlvHashBackend backend);
+
+/**
+ * A short name for a backend: "generic", "avx2" or "sha-ni"
+ *
+ * @param [in] backend A backend
+ *
+ * @return A static string
+ */
+const char *metisTlvHash_BackendName(MetisTlvHashBackend backend);
+#endif // Metis_metis_TlvHash_h
@@ -63,6 +63,11 @@
  * one malloc for the new shell and do a shallow memcpy of the struct.  Destroy will always
  * free the shell, but will only free the guts when the shared reference count goes to zero.
  *
+ * A new name is a single allocation: the first shell, then the shared state, the segment array,
+ * the hash array and the name memory.  That first shell is not freed on its own, it goes with the
+ * rest of the block when the shared reference count goes to zero.  Shells and small blocks come
+ * from metisSlab.
+ *
  * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
  * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
  */
@@ -79,6 +84,7 @@
 #include <ccnx/forwarder/metis/tlv/metis_TlvName.h>
 #include <ccnx/forwarder/metis/tlv/metis_Tlv.h>
 #include <ccnx/forwarder/metis/tlv/metis_TlvNameCodec.h>
+#include <ccnx/forwarder/metis/core/metis_Slab.h>
 
 #include <LongBow/runtime.h>
 
@@ -103,8 +109,22 @@ struct metis_tlv_name {
     // one copy extends the array, all copies see it
     size_t *segmentCumulativeHashArrayLengthPtr;
     uint32_t *segmentCumulativeHashArray;
+
+    // the allocation holding the first shell and everything shared
+    struct metis_tlv_name_block *block;
 };
 
+/**
+ * The shared state of all copies of a name.  The segment array, the hash array and the name
+ * memory follow it in the same allocation.
+ */
+typedef struct metis_tlv_name_block {
+    MetisTlvName first;
+    unsigned refCount;
+    size_t segmentCumulativeHashArrayLength;
+    size_t blockLength;
+} _MetisTlvNameBlock;
+
 // =====================================================
 
 static unsigned
@@ -129,25 +149,46 @@ _decrementRefCount(MetisTlvName *name)
 
 // ============================================================================
 
+/**
+ * Allocates the block for a name of memoryLength bytes and segmentCount segments, and points the
+ * first shell at its parts.  The caller copies the name in to name->memory then calls _setup().
+ */
+static MetisTlvName *
+_create(size_t memoryLength, size_t segmentCount)
+{
+    size_t segmentBytes = segmentCount * sizeof(MetisTlvExtent);
+    size_t hashBytes = segmentCount * sizeof(uint32_t);
+    size_t blockLength = sizeof(_MetisTlvNameBlock) + segmentBytes + hashBytes + memoryLength;
+
+    _MetisTlvNameBlock *block = metisSlab_Allocate(blockLength);
+    memset(block, 0, sizeof(_MetisTlvNameBlock));
+    block->blockLength = blockLength;
+
+    uint8_t *p = (uint8_t *) (block + 1);
+    MetisTlvName *name = &block->first;
+    name->block = block;
+    name->refCountPtr = &block->refCount;
+    name->segmentCumulativeHashArrayLengthPtr = &block->segmentCumulativeHashArrayLength;
+    name->segmentArray = (MetisTlvExtent *) p;
+    name->segmentArrayLength = segmentCount;
+    name->segmentCumulativeHashArray = (uint32_t *) (p + segmentBytes);
+    name->memory = p + segmentBytes + hashBytes;
+    name->memoryLength = memoryLength;
+    return name;
+}
+
 /**
  * Common parts of setting up a MetisTlvName after the backing memory has been allocated and copied in to.
  *
- * PRECONDITIONS: name->memory and name->memoryLength set
+ * PRECONDITIONS: name from _create() and name->memory filled in
  */
 static void
 _setup(MetisTlvName *name)
 {
-    name->refCountPtr = parcMemory_Allocate(sizeof(unsigned));
-    assertNotNull(name->refCountPtr, "parcMemory_Allocate(%zu) returned NULL", sizeof(unsigned));
     *name->refCountPtr = 1;
 
-    metisTlv_NameSegments(name->memory, name->memoryLength, &name->segmentArray, &name->segmentArrayLength);
-
-    name->segmentCumulativeHashArray = parcMemory_Allocate(name->segmentArrayLength * sizeof(uint32_t));
-    assertNotNull(name->segmentCumulativeHashArray, "parcMemory_Allocate(%zu) returned NULL", name->segmentArrayLength * sizeof(uint32_t));
-
-    name->segmentCumulativeHashArrayLengthPtr = parcMemory_Allocate(sizeof(size_t));
-    assertNotNull(name->segmentCumulativeHashArrayLengthPtr, "parcMemory_Allocate(%zu) returned NULL", sizeof(size_t));
+    size_t actualLength = metisTlv_ParseNameSegments(name->memory, name->memoryLength, name->segmentArray, name->segmentArrayLength);
+    assertTrue(actualLength == name->segmentArrayLength, "Name has %zu segments, expected %zu", actualLength, name->segmentArrayLength);
 
     *name->segmentCumulativeHashArrayLengthPtr = 1;
     name->segmentCumulativeHashArrayLimit = name->segmentArrayLength;
@@ -163,14 +204,11 @@ _setup(MetisTlvName *name)
 MetisTlvName *
 metisTlvName_Create(const uint8_t *memory, size_t memoryLength)
 {
-    MetisTlvName *name = parcMemory_AllocateAndClear(sizeof(MetisTlvName));
-    assertNotNull(name, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisTlvName));
-
-    name->memory = parcMemory_Allocate(memoryLength);
-    assertNotNull(name->memory, "parcMemory_Allocate(%zu) returned NULL", memoryLength);
+    // count the segments first, so the arrays can go in the same allocation
+    size_t segmentCount = metisTlv_ParseNameSegments((uint8_t *) memory, memoryLength, NULL, 0);
+    MetisTlvName *name = _create(memoryLength, segmentCount);
 
     memcpy(name->memory, memory, memoryLength);
-    name->memoryLength = memoryLength;
 
     _setup(name);
 
@@ -187,12 +225,7 @@ metisTlvName_CreateFromCCNxName(const CCNxName *ccnxName)
         memoryLength += 4 + ccnxNameSegment_Length(segment);
     }
 
-    MetisTlvName *name = parcMemory_AllocateAndClear(sizeof(MetisTlvName));
-    assertNotNull(name, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisTlvName));
-
-    name->memoryLength = memoryLength;
-    name->memory = parcMemory_Allocate(memoryLength);
-    assertNotNull(name->memory, "parcMemory_Allocate(%zu) returned NULL", memoryLength);
+    MetisTlvName *name = _create(memoryLength, ccnxName_GetSegmentCount(ccnxName));
 
     uint8_t *p = name->memory;
     uint8_t *end = p + memoryLength;
@@ -230,15 +263,18 @@ metisTlvName_Release(MetisTlvName **namePtr)
     assertNotNull(*namePtr, "Parameter must dereference to non-null pointer");
 
     MetisTlvName *name = *namePtr;
+    _MetisTlvNameBlock *block = name->block;
     _decrementRefCount(name);
-    if (_getRefCount(name) == 0) {
-        parcMemory_Deallocate((void **) &(name->refCountPtr));
-        parcMemory_Deallocate((void **) &(name->segmentArray));
-        parcMemory_Deallocate((void **) &(name->segmentCumulativeHashArray));
-        parcMemory_Deallocate((void **) &(name->segmentCumulativeHashArrayLengthPtr));
-        parcMemory_Deallocate((void **) &(name->memory));
+    unsigned remaining = _getRefCount(name);
+
+    // the first shell lives in the block, so it goes when the block goes
+    if (name != &block->first) {
+        metisSlab_Deallocate((void **) &name, sizeof(MetisTlvName));
+    }
+
+    if (remaining == 0) {
+        metisSlab_Deallocate((void **) &block, block->blockLength);
     }
-    parcMemory_Deallocate((void **) &name);
     *namePtr = NULL;
 }
 
@@ -252,8 +288,7 @@ MetisTlvName *
 metisTlvName_Slice(const MetisTlvName *original, size_t segmentCount)
 {
     assertNotNull(original, "Parameter must be non-null");
-    MetisTlvName *copy = parcMemory_AllocateAndClear(sizeof(MetisTlvName));
-    assertNotNull(copy, "parcMemory_AllocateAndClear(%zu) returned NULL", sizeof(MetisTlvName));
+    MetisTlvName *copy = metisSlab_Allocate(sizeof(MetisTlvName));
 
     memcpy(copy, original, sizeof(MetisTlvName));
     _incrementRefCount(copy);
@@ -270,15 +305,14 @@ metisTlvName_Slice(const MetisTlvName *original, size_t segmentCount)
     return copy;
 }
 
-uint32_t
-metisTlvName_HashCode(const MetisTlvName *name)
+/**
+ * Extends the shared cumulative hash array through (and including) lastSegment.
+ *
+ * PRECONDITION: lastSegment < segmentCumulativeHashArrayLimit
+ */
+static void
+_computeCumulativeHashes(const MetisTlvName *name, size_t lastSegment)
 {
-    if ((name == NULL) || (name->segmentArrayLength == 0)) {
-        return 0;
-    }
-
-    size_t lastSegment = name->segmentArrayLength - 1;
-
     if (lastSegment >= *name->segmentCumulativeHashArrayLengthPtr) {
         // we have not yet computed this, so lets do it now!
         // Note that we go up to and including lastSegment in the for loop.  lastSegment is not a "length", it is
@@ -292,10 +326,69 @@ metisTlvName_HashCode(const MetisTlvName *name)
         }
         *name->segmentCumulativeHashArrayLengthPtr = lastSegment + 1;
     }
+}
+
+/**
+ * The number of bytes of name memory used by the first segmentCount segments
+ *
+ * PRECONDITION: 0 < segmentCount <= name->segmentArrayLength
+ */
+static size_t
+_prefixMemoryLength(const MetisTlvName *name, size_t segmentCount)
+{
+    return name->segmentArray[segmentCount - 1].offset + name->segmentArray[segmentCount - 1].length;
+}
 
+uint32_t
+metisTlvName_HashCode(const MetisTlvName *name)
+{
+    if ((name == NULL) || (name->segmentArrayLength == 0)) {
+        return 0;
+    }
+
+    size_t lastSegment = name->segmentArrayLength - 1;
+    _computeCumulativeHashes(name, lastSegment);
     return name->segmentCumulativeHashArray[lastSegment];
 }
 
+uint32_t
+metisTlvName_PrefixHashCode(const MetisTlvName *name, size_t segmentCount)
+{
+    assertNotNull(name, "Parameter name must be non-null");
+    assertTrue(segmentCount <= name->segmentArrayLength,
+               "Parameter segmentCount %zu longer than name %zu", segmentCount, name->segmentArrayLength);
+
+    if (segmentCount == 0) {
+        return 0;
+    }
+
+    size_t lastSegment = segmentCount - 1;
+    _computeCumulativeHashes(name, lastSegment);
+    return name->segmentCumulativeHashArray[lastSegment];
+}
+
+bool
+metisTlvName_PrefixEquals(const MetisTlvName *a, const MetisTlvName *b, size_t segmentCount)
+{
+    assertNotNull(a, "Parameter a must be non-null");
+    assertNotNull(b, "Parameter b must be non-null");
+
+    if (segmentCount > a->segmentArrayLength || segmentCount > b->segmentArrayLength) {
+        return false;
+    }
+
+    if (segmentCount == 0) {
+        return true;
+    }
+
+    size_t lengthA = _prefixMemoryLength(a, segmentCount);
+    size_t lengthB = _prefixMemoryLength(b, segmentCount);
+    if (lengthA == lengthB) {
+        return (memcmp(a->memory, b->memory, lengthA) == 0);
+    }
+    return false;
+}
+
 bool
 metisTlvName_Equals(const MetisTlvName *a, const MetisTlvName *b)
 {
@@ -308,6 +401,28 @@ metisTlvName_Equals(const MetisTlvName *a, const MetisTlvName *b)
     return false;
 }
 
+int
+metisTlvName_SegmentCompare(const MetisTlvName *a, size_t aIndex, const MetisTlvName *b, size_t bIndex)
+{
+    assertNotNull(a, "Parameter a must be non-null");
+    assertNotNull(b, "Parameter b must be non-null");
+    assertTrue(aIndex < a->segmentArrayLength, "Parameter aIndex %zu beyond end %zu", aIndex, a->segmentArrayLength);
+    assertTrue(bIndex < b->segmentArrayLength, "Parameter bIndex %zu beyond end %zu", bIndex, b->segmentArrayLength);
+
+    const MetisTlvExtent *extentA = &a->segmentArray[aIndex];
+    const MetisTlvExtent *extentB = &b->segmentArray[bIndex];
+
+    if (extentA->length < extentB->length) {
+        return -1;
+    }
+
+    if (extentA->length > extentB->length) {
+        return +1;
+    }
+
+    return memcmp(&a->memory[extentA->offset], &b->memory[extentB->offset], extentA->length);
+}
+
 int
 metisTlvName_Compare(const MetisTlvName *a, const MetisTlvName *b)
 {
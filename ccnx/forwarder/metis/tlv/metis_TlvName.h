@@ -251,6 +251,61 @@ uint32_t metisTlvName_HashCode(const MetisTlvName *name);
  */
 bool metisTlvName_Equals(const MetisTlvName *a, const MetisTlvName *b);
 
+/**
+ * The hash code of the first segmentCount segments of the name
+ *
+ * This is the same value as metisTlvName_HashCode() of metisTlvName_Slice(name, segmentCount),
+ * but does not allocate a slice.  It uses (and extends) the cumulative segment hashes
+ * shared by all copies of the name.  A segmentCount of 0 returns 0.
+ *
+ * @param [in] name An allocated MetisTlvName
+ * @param [in] segmentCount The prefix length, must be no more than metisTlvName_SegmentCount(name)
+ *
+ * @retval number The hash of the prefix
+ *
+ * Example:
+ * @code
+ * {
+ *    uint8_t encodedName[] = {0x00, 0x01, 0x00, 0x05, 'a', 'p', 'p', 'l', 'e', 0x00, 0x01, 0x00, 0x03, 'p', 'i', 'e'};
+ *    MetisTlvName *name = metisTlvName_Create(encodedName, sizeof(encodedName));
+ *    MetisTlvName *prefix = metisTlvName_Slice(name, 1);
+ *    // metisTlvName_PrefixHashCode(name, 1) == metisTlvName_HashCode(prefix)
+ *    metisTlvName_Release(&prefix);
+ *    metisTlvName_Release(&name);
+ * }
+ * @endcode
+ */
+uint32_t metisTlvName_PrefixHashCode(const MetisTlvName *name, size_t segmentCount);
+
+/**
+ * Determines if the first segmentCount segments of two names are equal
+ *
+ * This is the same as metisTlvName_Equals() of the two slices of length segmentCount,
+ * but does not allocate the slices.  If either name has fewer than segmentCount segments,
+ * they are not equal.
+ *
+ * @param [in] a An allocated MetisTlvName
+ * @param [in] b An allocated MetisTlvName
+ * @param [in] segmentCount The number of segments to compare
+ *
+ * @retval true The prefixes are equal
+ * @retval false The prefixes are not equal
+ *
+ * Example:
+ * @code
+ * {
+ *    uint8_t encodedName[] = {0x00, 0x01, 0x00, 0x05, 'a', 'p', 'p', 'l', 'e', 0x00, 0x01, 0x00, 0x03, 'p', 'i', 'e'};
+ *    MetisTlvName *name = metisTlvName_Create(encodedName, sizeof(encodedName));
+ *    MetisTlvName *prefix = metisTlvName_Slice(name, 1);
+ *    bool equal = metisTlvName_PrefixEquals(name, prefix, 1);
+ *    // equal is true
+ *    metisTlvName_Release(&prefix);
+ *    metisTlvName_Release(&name);
+ * }
+ * @endcode
+ */
+bool metisTlvName_PrefixEquals(const MetisTlvName *a, const MetisTlvName *b, size_t segmentCount);
+
 /**
  * Compares two names and returns their ordering
  *
@@ -272,6 +327,35 @@ bool metisTlvName_Equals(const MetisTlvName *a, const MetisTlvName *b);
  */
 int metisTlvName_Compare(const MetisTlvName *a, const MetisTlvName *b);
 
+/**
+ * Compares one name segment of a to one name segment of b
+ *
+ * Segments are ordered first by length then by their bytes (including the segment type),
+ * the same ordering as metisTlvName_Compare().  This lets a caller compare names one
+ * segment at a time without slicing them.
+ *
+ * @param [in] a An allocated MetisTlvName
+ * @param [in] aIndex The segment index in a, must be less than metisTlvName_SegmentCount(a)
+ * @param [in] b An allocated MetisTlvName
+ * @param [in] bIndex The segment index in b, must be less than metisTlvName_SegmentCount(b)
+ *
+ * @retval negative segment aIndex of a sorts before segment bIndex of b
+ * @retval 0 The segments are equal
+ * @retval positive segment aIndex of a sorts after segment bIndex of b
+ *
+ * Example:
+ * @code
+ * {
+ *    uint8_t encodedName[] = {0x00, 0x01, 0x00, 0x05, 'a', 'p', 'p', 'l', 'e', 0x00, 0x01, 0x00, 0x05, 'a', 'p', 'p', 'l', 'e'};
+ *    MetisTlvName *name = metisTlvName_Create(encodedName, sizeof(encodedName));
+ *    int compare = metisTlvName_SegmentCompare(name, 0, name, 1);
+ *    // compare == 0
+ *    metisTlvName_Release(&name);
+ * }
+ * @endcode
+ */
+int metisTlvName_SegmentCompare(const MetisTlvName *a, size_t aIndex, const MetisTlvName *b, size_t bIndex);
+
 /**
  * @function metsName_StartsWith
  * @abstract Tests if name starts with prefix
@@ -72,9 +72,9 @@
 
 #include <ccnx/forwarder/metis/tlv/metis_Tlv.h>
 #include <ccnx/forwarder/metis/tlv/metis_TlvExtent.h>
+#include <ccnx/forwarder/metis/tlv/metis_TlvHash.h>
 
 #include <parc/algol/parc_Memory.h>
-#include <parc/security/parc_CryptoHasher.h>
 
 #include <ccnx/forwarder/metis/tlv/metis_TlvSchemaV0.h>
 
@@ -298,12 +298,7 @@ _parseControlPlaneInterface(const uint8_t *packet, size_t offset, size_t endMess
 static PARCCryptoHash *
 _computeHash(const uint8_t *packet, size_t offset, size_t endMessage)
 {
-    PARCCryptoHasher *hasher = parcCryptoHasher_Create(PARCCryptoHashType_SHA256);
-    parcCryptoHasher_Init(hasher);
-    parcCryptoHasher_UpdateBytes(hasher, packet + offset, endMessage - offset);
-    PARCCryptoHash *hash = parcCryptoHasher_Finalize(hasher);
-    parcCryptoHasher_Release(&hasher);
-    return hash;
+    return metisTlvHash_CreateCryptoHash(packet + offset, endMessage - offset);
 }
 
 // ==================
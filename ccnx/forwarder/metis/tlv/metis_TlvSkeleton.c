@@ -66,6 +66,7 @@
 
 #include <ccnx/forwarder/metis/tlv/metis_TlvSchemaV0.h>
 #include <ccnx/forwarder/metis/tlv/metis_TlvSchemaV1.h>
+#include <ccnx/forwarder/metis/tlv/metis_TlvHash.h>
 
 #define INDEX_NAME 0
 #define INDEX_KEYID 1
@@ -407,6 +408,46 @@ metisTlvSkeleton_ComputeContentObjectHash(const MetisTlvSkeleton *opaque)
     return skeleton->tlvOps->computeContentObjectHash(skeleton->packet);
 }
 
+size_t
+metisTlvSkeleton_ComputeContentObjectHashBatch(size_t count, const MetisTlvSkeleton *skeletons[], PARCCryptoHash *hashes[])
+{
+    assertTrue(count == 0 || (skeletons != NULL && hashes != NULL), "Parameters must be non-null");
+
+    const uint8_t *data[METIS_TLV_HASH_BATCH_WIDTH];
+    size_t lengths[METIS_TLV_HASH_BATCH_WIDTH];
+    size_t positions[METIS_TLV_HASH_BATCH_WIDTH];
+    uint8_t digests[METIS_TLV_HASH_BATCH_WIDTH][METIS_TLV_HASH_DIGEST_LENGTH];
+
+    size_t hashed = 0;
+    size_t pending = 0;
+    for (size_t i = 0; i < count; i++) {
+        const _InternalSkeleton *skeleton = (const _InternalSkeleton *) skeletons[i];
+        _assertInvariants(skeleton);
+
+        hashes[i] = NULL;
+        if (skeleton->tlvOps->isPacketTypeContentObject(skeleton->packet)) {
+            // The ContentObjectHash covers everything after the fixed and optional headers
+            size_t endHeaders = skeleton->tlvOps->totalHeaderLength(skeleton->packet);
+            size_t endPacket = skeleton->tlvOps->totalPacketLength(skeleton->packet);
+            data[pending] = skeleton->packet + endHeaders;
+            lengths[pending] = endPacket - endHeaders;
+            positions[pending] = i;
+            pending++;
+        }
+
+        if (pending == METIS_TLV_HASH_BATCH_WIDTH || (pending > 0 && i + 1 == count)) {
+            metisTlvHash_Sha256Batch(pending, data, lengths, digests);
+            for (size_t j = 0; j < pending; j++) {
+                hashes[positions[j]] = metisTlvHash_CryptoHashFromDigest(digests[j]);
+            }
+            hashed += pending;
+            pending = 0;
+        }
+    }
+
+    return hashed;
+}
+
 size_t
 metisTlvSkeleton_TotalPacketLength(const MetisTlvSkeleton *opaque)
 {
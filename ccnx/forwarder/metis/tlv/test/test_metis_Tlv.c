@@ -91,6 +91,7 @@ LONGBOW_TEST_FIXTURE(Global)
 {
     LONGBOW_RUN_TEST_CASE(Global, metisTlv_NameSegments);
     LONGBOW_RUN_TEST_CASE(Global, metisTlv_NameSegments_Realloc);
+    LONGBOW_RUN_TEST_CASE(Global, metisTlv_ParseNameSegments);
     LONGBOW_RUN_TEST_CASE(Global, metisTlv_ExtentToVarInt);
 
     LONGBOW_RUN_TEST_CASE(Global, metisTlv_FixedHeaderLength);
@@ -192,6 +193,27 @@ LONGBOW_TEST_CASE(Global, metisTlv_NameSegments_Realloc)
     parcMemory_Deallocate((void **) &nameBuffer);
 }
 
+LONGBOW_TEST_CASE(Global, metisTlv_ParseNameSegments)
+{
+    uint8_t name[] = {
+        0x00, 0x02, 0x00, 0x05, // type = binary, length = 5
+        'h',  'e',  'l',  'l',
+        'o',  // "hello"
+        0xF0, 0x00, 0x00, 0x04, // type = app, length = 4
+        'o',  'u',  'c',  'h'
+    };
+
+    size_t count = metisTlv_ParseNameSegments(name, sizeof(name), NULL, 0);
+    assertTrue(count == 2, "Wrong segment count, expected %u got %zu", 2, count);
+
+    // a short array gets the first extents and the full count
+    MetisTlvExtent nameExtents[1];
+    count = metisTlv_ParseNameSegments(name, sizeof(name), nameExtents, 1);
+    assertTrue(count == 2, "Wrong segment count, expected %u got %zu", 2, count);
+    assertTrue(nameExtents[0].offset == 0 && nameExtents[0].length == 9,
+               "Wrong extent, expected {0, 9} got {%u, %u}", nameExtents[0].offset, nameExtents[0].length);
+}
+
 LONGBOW_TEST_CASE(Global, metisTlv_ExtentToVarInt)
 {
     uint8_t packet[] = { 0xff, 0xff, 0x00, 0x01, 0x02, 0xff, 0xff };
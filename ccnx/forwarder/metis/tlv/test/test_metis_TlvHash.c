@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC)
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL XEROX OR PARC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * ################################################################################
+ * #
+ * # PATENT NOTICE
+ * #
+ * # This software is distributed under the BSD 2-clause License (see LICENSE
+ * # file).  This BSD License does not make any patent claims and as such, does
+ * # not act as a patent grant.  The purpose of this section is for each contributor
+ * # to define their intentions with respect to intellectual property.
+ * #
+ * # Each contributor to this source code is encouraged to state their patent
+ * # claims and licensing mechanisms for any contributions made. At the end of
+ * # this section contributors may each make their own statements.  Contributor's
+ * # claims and grants only apply to the pieces (source code, programs, text,
+ * # media, etc) that they have contributed directly to this software.
+ * #
+ * # There is no guarantee that this section is complete, up to date or accurate. It
+ * # is up to the contributors to maintain their portion of this section and up to
+ * # the user of the software to verify any claims herein.
+ * #
+ * # Do not remove this header notification.  The contents of this section must be
+ * # present in all distributions of the software.  You may only modify your own
+ * # intellectual property statements.  Please provide contact information.
+ *
+ * - Palo Alto Research Center, Inc
+ * This software distribution does not grant any rights to patents owned by Palo
+ * Alto Research Center, Inc (PARC). Rights to these patents are available via
+ * various mechanisms. As of January 2016 PARC has committed to FRAND licensing any
+ * intellectual property used by its contributions to this software. You may
+ * contact PARC at cipo@parc.com for more information or visit http://www.ccnx.org
+ */
+/**
+ * @author Marc Mosko, Palo Alto Research Center (Xerox PARC)
+ * @copyright (c) 2013-2015, Xerox Corporation (Xerox) and Palo Alto Research Center, Inc (PARC).  All rights reserved.
+ */
+// Include the file(s) containing the functions to be tested.
+// This permits internal static functions to be visible to this Test Framework.
+#include "../metis_TlvHash.c"
+#include <LongBow/unit-test.h>
+#include <parc/algol/parc_SafeMemory.h>
+#include <parc/security/parc_CryptoHasher.h>
+
+typedef struct test_vector {
+    const char *message;
+    uint8_t digest[METIS_TLV_HASH_DIGEST_LENGTH];
+} TestVector;
+
+// From FIPS 180-2, Appendix B
+static const TestVector _vectors[] = {
+    { "",
+      { 0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+        0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55 } },
+    { "abc",
+      { 0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad } },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+      { 0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+        0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1 } },
+};
+
+#define VECTOR_COUNT (sizeof(_vectors) / sizeof(_vectors[0]))
+
+// Lengths either side of the one and two block padding boundaries
+static const size_t _lengths[] = { 0, 1, 55, 56, 63, 64, 65, 119, 120, 127, 128, 1000, 1500 };
+
+#define LENGTH_COUNT (sizeof(_lengths) / sizeof(_lengths[0]))
+
+static uint8_t _buffers[LENGTH_COUNT][1500];
+
+LONGBOW_TEST_RUNNER(metis_TlvHash)
+{
+    // The following Test Fixtures will run their corresponding Test Cases.
+    // Test Fixtures are run in the order specified, but all tests should be idempotent.
+    // Never rely on the execution order of tests or share state between them.
+    LONGBOW_RUN_TEST_FIXTURE(Global);
+}
+
+// The Test Runner calls this function once before any Test Fixtures are run.
+LONGBOW_TEST_RUNNER_SETUP(metis_TlvHash)
+{
+    for (size_t i = 0; i < LENGTH_COUNT; i++) {
+        for (size_t j = 0; j < sizeof(_buffers[i]); j++) {
+            _buffers[i][j] = (uint8_t) (i * 31 + j * 7);
+        }
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+// The Test Runner calls this function once after all the Test Fixtures are run.
+LONGBOW_TEST_RUNNER_TEARDOWN(metis_TlvHash)
+{
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE(Global)
+{
+    LONGBOW_RUN_TEST_CASE(Global, metisTlvHash_Sha256_Vectors);
+    LONGBOW_RUN_TEST_CASE(Global, metisTlvHash_Sha256_MatchesCryptoHasher);
+    LONGBOW_RUN_TEST_CASE(Global, metisTlvHash_Sha256Batch);
+    LONGBOW_RUN_TEST_CASE(Global, metisTlvHash_CreateCryptoHash);
+    LONGBOW_RUN_TEST_CASE(Global, metisTlvHash_SetBackend);
+    LONGBOW_RUN_TEST_CASE(Global, metisTlvHash_BackendName);
+}
+
+static MetisTlvHashBackend _savedBackend;
+
+LONGBOW_TEST_FIXTURE_SETUP(Global)
+{
+    _savedBackend = metisTlvHash_GetBackend();
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_FIXTURE_TEARDOWN(Global)
+{
+    metisTlvHash_SetBackend(_savedBackend);
+
+    uint32_t outstandingAllocations = parcSafeMemory_ReportAllocation(STDERR_FILENO);
+    if (outstandingAllocations != 0) {
+        printf("%s leaks memory by %d allocations\n", longBowTestCase_GetName(testCase), outstandingAllocations);
+        return LONGBOW_STATUS_MEMORYLEAK;
+    }
+    return LONGBOW_STATUS_SUCCEEDED;
+}
+
+LONGBOW_TEST_CASE(Global, metisTlvHash_Sha256_Vectors)
+{
+    for (MetisTlvHashBackend backend = 0; backend < MetisTlvHashBackend_END; backend++) {
+        if (!metisTlvHash_SetBackend(backend)) {
+            continue;
+        }
+
+        for (size_t i = 0; i < VECTOR_COUNT; i++) {
+            uint8_t digest[METIS_TLV_HASH_DIGEST_LENGTH];
+            metisTlvHash_Sha256((const uint8_t *) _vectors[i].message, strlen(_vectors[i].message), digest);
+            assertTrue(memcmp(digest, _vectors[i].digest, sizeof(digest)) == 0,
+                       "Backend %s wrong digest for vector %zu", metisTlvHash_BackendName(backend), i);
+        }
+    }
+}
+
+LONGBOW_TEST_CASE(Global, metisTlvHash_Sha256_MatchesCryptoHasher)
+{
+    for (size_t i = 0; i < LENGTH_COUNT; i++) {
+        PARCCryptoHasher *hasher = parcCryptoHasher_Create(PARCCryptoHashType_SHA256);
+        parcCryptoHasher_Init(hasher);
+        parcCryptoHasher_UpdateBytes(hasher, _buffers[i], _lengths[i]);
+        PARCCryptoHash *truth = parcCryptoHasher_Finalize(hasher);
+        parcCryptoHasher_Release(&hasher);
+
+        for (MetisTlvHashBackend backend = 0; backend < MetisTlvHashBackend_END; backend++) {
+            if (metisTlvHash_SetBackend(backend)) {
+                uint8_t digest[METIS_TLV_HASH_DIGEST_LENGTH];
+                metisTlvHash_Sha256(_buffers[i], _lengths[i], digest);
+                assertTrue(memcmp(digest, parcBuffer_Overlay(parcCryptoHash_GetDigest(truth), 0), sizeof(digest)) == 0,
+                           "Backend %s wrong digest for length %zu", metisTlvHash_BackendName(backend), _lengths[i]);
+            }
+        }
+
+        parcCryptoHash_Release(&truth);
+    }
+}
+
+LONGBOW_TEST_CASE(Global, metisTlvHash_Sha256Batch)
+{
+    const uint8_t *data[LENGTH_COUNT];
+    uint8_t expected[LENGTH_COUNT][METIS_TLV_HASH_DIGEST_LENGTH];
+    for (size_t i = 0; i < LENGTH_COUNT; i++) {
+        data[i] = _buffers[i];
+        _sha256(_compressGeneric, data[i], _lengths[i], expected[i]);
+    }
+
+    // Every batch size from 1 to more than one full batch, so partial batches are covered
+    for (MetisTlvHashBackend backend = 0; backend < MetisTlvHashBackend_END; backend++) {
+        if (!metisTlvHash_SetBackend(backend)) {
+            continue;
+        }
+
+        for (size_t count = 1; count <= LENGTH_COUNT; count++) {
+            uint8_t digests[LENGTH_COUNT][METIS_TLV_HASH_DIGEST_LENGTH];
+            memset(digests, 0, sizeof(digests));
+            metisTlvHash_Sha256Batch(count, data, _lengths, digests);
+
+            for (size_t i = 0; i < count; i++) {
+                assertTrue(memcmp(digests[i], expected[i], METIS_TLV_HASH_DIGEST_LENGTH) == 0,
+                           "Backend %s batch of %zu wrong digest for length %zu",
+                           metisTlvHash_BackendName(backend), count, _lengths[i]);
+            }
+        }
+    }
+}
+
+LONGBOW_TEST_CASE(Global, metisTlvHash_CreateCryptoHash)
+{
+    PARCCryptoHash *hash = metisTlvHash_CreateCryptoHash((const uint8_t *) _vectors[1].message, strlen(_vectors[1].message));
+
+    assertTrue(parcCryptoHash_GetDigestType(hash) == PARCCryptoHashType_SHA256, "Wrong hash type");
+    PARCBuffer *digest = parcCryptoHash_GetDigest(hash);
+    assertTrue(parcBuffer_Remaining(digest) == METIS_TLV_HASH_DIGEST_LENGTH, "Wrong digest length %zu", parcBuffer_Remaining(digest));
+    assertTrue(memcmp(parcBuffer_Overlay(digest, 0), _vectors[1].digest, METIS_TLV_HASH_DIGEST_LENGTH) == 0, "Wrong digest");
+
+    parcCryptoHash_Release(&hash);
+}
+
+LONGBOW_TEST_CASE(Global, metisTlvHash_SetBackend)
+{
+    assertTrue(metisTlvHash_IsBackendSupported(MetisTlvHashBackend_Generic), "Generic backend must always be supported");
+    assertFalse(metisTlvHash_IsBackendSupported(MetisTlvHashBackend_END), "Sentinel should not be supported");
+    assertFalse(metisTlvHash_SetBackend(MetisTlvHashBackend_END), "Sentinel should not be settable");
+
+    assertTrue(metisTlvHash_SetBackend(MetisTlvHashBackend_Generic), "Could not set generic backend");
+    assertTrue(metisTlvHash_GetBackend() == MetisTlvHashBackend_Generic, "Wrong backend %d", metisTlvHash_GetBackend());
+}
+
+LONGBOW_TEST_CASE(Global, metisTlvHash_BackendName)
+{
+    assertTrue(strcmp(metisTlvHash_BackendName(MetisTlvHashBackend_Generic), "generic") == 0, "Wrong name");
+    assertTrue(strcmp(metisTlvHash_BackendName(MetisTlvHashBackend_Avx2), "avx2") == 0, "Wrong name");
+    assertTrue(strcmp(metisTlvHash_BackendName(MetisTlvHashBackend_ShaNi), "sha-ni") == 0, "Wrong name");
+}
+
+int
+main(int argc, char *argv[])
+{
+    LongBowRunner *testRunner = LONGBOW_TEST_RUNNER_CREATE(metis_TlvHash);
+    int exitStatus = longBowMain(argc, argv, testRunner, NULL);
+    longBowTestRunner_Destroy(&testRunner);
+    exit(exitStatus);
+}
@@ -119,6 +119,7 @@ LONGBOW_TEST_FIXTURE(Global)
 {
     LONGBOW_RUN_TEST_CASE(Global, metisTlvName_Acquire);
     LONGBOW_RUN_TEST_CASE(Global, metisTlvName_Acquire_CopyAtMost0);
+    LONGBOW_RUN_TEST_CASE(Global, metisTlvName_Release_OriginalBeforeSlice);
     LONGBOW_RUN_TEST_CASE(Global, metisTlvName_Acquire_CopyAtMost1);
     LONGBOW_RUN_TEST_CASE(Global, metisTlvName_Acquire_CopyAtMost2);
     LONGBOW_RUN_TEST_CASE(Global, metisTlvName_Acquire_CopyAtMostAll);
@@ -134,8 +135,12 @@ LONGBOW_TEST_FIXTURE(Global)
     LONGBOW_RUN_TEST_CASE(Global, metisTlvName_Compare);
     LONGBOW_RUN_TEST_CASE(Global, metisTlvName_Compare_DefaultRoute);
     LONGBOW_RUN_TEST_CASE(Global, metisTlvName_Compare_DefaultRoute_Binary);
+    LONGBOW_RUN_TEST_CASE(Global, metisTlvName_SegmentCompare);
 
     LONGBOW_RUN_TEST_CASE(Global, metisTlvName_HashCode);
+    LONGBOW_RUN_TEST_CASE(Global, metisTlvName_PrefixHashCode);
+    LONGBOW_RUN_TEST_CASE(Global, metisTlvName_PrefixEquals);
+    LONGBOW_RUN_TEST_CASE(Global, metisTlvName_PrefixEquals_TooLong);
 
     LONGBOW_RUN_TEST_CASE(Global, metisTlvName_SegmentCount);
     LONGBOW_RUN_TEST_CASE(Global, metisTlvName_StartsWith_SelfPrefix);
@@ -354,6 +359,20 @@ LONGBOW_TEST_CASE(Global, metisTlvName_Compare_DefaultRoute_Binary)
     metisTlvName_Release(&metisDefaultRoute);
 }
 
+LONGBOW_TEST_CASE(Global, metisTlvName_SegmentCompare)
+{
+    MetisTlvName *name = metisTlvName_Create(encoded_name, sizeof(encoded_name));
+    MetisTlvName *copy = metisTlvName_Create(encoded_name, sizeof(encoded_name));
+
+    // segment 0 has length 9, segment 1 has length 8, segment 2 has length 6
+    assertTrue(metisTlvName_SegmentCompare(name, 1, copy, 1) == 0, "Same segment should compare equal");
+    assertTrue(metisTlvName_SegmentCompare(name, 0, copy, 1) > 0, "Longer segment should sort after");
+    assertTrue(metisTlvName_SegmentCompare(name, 2, copy, 1) < 0, "Shorter segment should sort before");
+
+    metisTlvName_Release(&copy);
+    metisTlvName_Release(&name);
+}
+
 LONGBOW_TEST_CASE(Global, metisTlvName_HashCode)
 {
     // first, compute the hashes of the name
@@ -370,6 +389,45 @@ LONGBOW_TEST_CASE(Global, metisTlvName_HashCode)
     metisTlvName_Release(&name);
 }
 
+LONGBOW_TEST_CASE(Global, metisTlvName_PrefixHashCode)
+{
+    MetisTlvName *name = metisTlvName_Create(encoded_name, sizeof(encoded_name));
+
+    for (size_t i = 1; i <= metisTlvName_SegmentCount(name); i++) {
+        MetisTlvName *slice = metisTlvName_Slice(name, i);
+        uint32_t truth = metisTlvName_HashCode(slice);
+        uint32_t test_hash = metisTlvName_PrefixHashCode(name, i);
+        assertTrue(test_hash == truth, "Incorrect hash for prefix %zu, expected %08X got %08X", i, truth, test_hash);
+        metisTlvName_Release(&slice);
+    }
+
+    metisTlvName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, metisTlvName_PrefixEquals)
+{
+    MetisTlvName *name = metisTlvName_Create(encoded_name, sizeof(encoded_name));
+    MetisTlvName *prefix = metisTlvName_Create(encoded_name, 17);
+
+    assertTrue(metisTlvName_PrefixEquals(name, prefix, 1), "First segment should be equal");
+    assertTrue(metisTlvName_PrefixEquals(name, prefix, 2), "First two segments should be equal");
+
+    metisTlvName_Release(&prefix);
+    metisTlvName_Release(&name);
+}
+
+LONGBOW_TEST_CASE(Global, metisTlvName_PrefixEquals_TooLong)
+{
+    MetisTlvName *name = metisTlvName_Create(encoded_name, sizeof(encoded_name));
+    MetisTlvName *prefix = metisTlvName_Create(encoded_name, 17);
+
+    // prefix only has 2 segments
+    assertFalse(metisTlvName_PrefixEquals(name, prefix, 3), "Prefix of 3 segments should not be equal");
+
+    metisTlvName_Release(&prefix);
+    metisTlvName_Release(&name);
+}
+
 LONGBOW_TEST_CASE(Global, metisTlvName_Acquire_CopyAtMost0)
 {
     unsigned copyLength = 0;
@@ -390,6 +448,26 @@ LONGBOW_TEST_CASE(Global, metisTlvName_Acquire_CopyAtMost0)
     metisTlvName_Release(&name);
 }
 
+LONGBOW_TEST_CASE(Global, metisTlvName_Release_OriginalBeforeSlice)
+{
+    MetisTlvName *name = metisTlvName_Create(encoded_name, sizeof(encoded_name));
+    MetisTlvName *copy = metisTlvName_Slice(name, 1);
+    uint32_t hashBefore = metisTlvName_HashCode(copy);
+
+    // the first shell is part of the name's single allocation, which the copy keeps alive
+    metisTlvName_Release(&name);
+    assertTrue(_getRefCount(copy) == 1, "Wrong refcount in copy, expected %u got %u", 1, _getRefCount(copy));
+
+    MetisTlvName *prefix = metisTlvName_Create(prefixOf_name, 9);
+    bool equals = metisTlvName_Equals(copy, prefix);
+    uint32_t hashAfter = metisTlvName_HashCode(copy);
+    metisTlvName_Release(&prefix);
+    metisTlvName_Release(&copy);
+
+    assertTrue(equals, "Copy should still equal the first segment of the original");
+    assertTrue(hashBefore == hashAfter, "Hash changed, expected %08X got %08X", hashBefore, hashAfter);
+}
+
 LONGBOW_TEST_CASE(Global, metisTlvName_Acquire_CopyAtMost1)
 {
     unsigned copyLength = 1;
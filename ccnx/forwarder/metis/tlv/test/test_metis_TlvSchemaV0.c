@@ -62,6 +62,7 @@
 #include "../metis_TlvSkeleton.c"
 #include <LongBow/unit-test.h>
 #include <parc/algol/parc_SafeMemory.h>
+#include <parc/security/parc_CryptoHasher.h>
 #include <parc/logging/parc_LogReporterTextStdout.h>
 
 #include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
@@ -64,6 +64,7 @@
 
 #include <LongBow/unit-test.h>
 #include <parc/algol/parc_SafeMemory.h>
+#include <parc/security/parc_CryptoHasher.h>
 #include <parc/logging/parc_LogReporterTextStdout.h>
 
 #include <ccnx/forwarder/metis/testdata/metis_TestDataV0.h>
@@ -98,6 +99,7 @@ LONGBOW_TEST_RUNNER_TEARDOWN(metis_TlvSkeleton)
 LONGBOW_TEST_FIXTURE(SchemaV1)
 {
     LONGBOW_RUN_TEST_CASE(SchemaV1, metisTlvSkeleton_ComputeContentObjectHash);
+    LONGBOW_RUN_TEST_CASE(SchemaV1, metisTlvSkeleton_ComputeContentObjectHashBatch);
     LONGBOW_RUN_TEST_CASE(SchemaV1, metisTlvSkeleton_Skeleton_Interest);
     LONGBOW_RUN_TEST_CASE(SchemaV1, metisTlvSkeleton_Skeleton_Object);
     LONGBOW_RUN_TEST_CASE(SchemaV1, metisTlvSkeleton_IsPacketTypeInterest);
@@ -197,6 +199,32 @@ LONGBOW_TEST_CASE(SchemaV1, metisTlvSkeleton_ComputeContentObjectHash)
     parcCryptoHasher_Release(&hasher);
 }
 
+LONGBOW_TEST_CASE(SchemaV1, metisTlvSkeleton_ComputeContentObjectHashBatch)
+{
+    PARCLogReporter *reporter = parcLogReporterTextStdout_Create();
+    MetisLogger *logger = metisLogger_Create(reporter, parcClock_Wallclock());
+    parcLogReporter_Release(&reporter);
+
+    MetisTlvSkeleton objectV1, interestV1, objectV0;
+    metisTlvSkeleton_Parse(&objectV1, metisTestDataV1_ContentObject_NameA_KeyId1_RsaSha256, logger);
+    metisTlvSkeleton_Parse(&interestV1, metisTestDataV1_Interest_AllFields, logger);
+    metisTlvSkeleton_Parse(&objectV0, metisTestDataV0_EncodedObject, logger);
+    metisLogger_Release(&logger);
+
+    const MetisTlvSkeleton *skeletons[] = { &objectV1, &interestV1, &objectV0 };
+    PARCCryptoHash *hashes[3];
+    size_t hashed = metisTlvSkeleton_ComputeContentObjectHashBatch(3, skeletons, hashes);
+    assertTrue(hashed == 2, "Wrong number of hashes, expected 2 got %zu", hashed);
+    assertNull(hashes[1], "An interest should not get a hash");
+
+    for (int i = 0; i < 3; i += 2) {
+        PARCCryptoHash *truth = metisTlvSkeleton_ComputeContentObjectHash(skeletons[i]);
+        assertTrue(parcCryptoHash_Equals(truth, hashes[i]), "Batch hash %d does not equal the single hash", i);
+        parcCryptoHash_Release(&truth);
+        parcCryptoHash_Release(&hashes[i]);
+    }
+}
+
 LONGBOW_TEST_CASE(SchemaV1, metisTlvSkeleton_Skeleton_Interest)
 {
     MetisTlvSkeleton skeleton;